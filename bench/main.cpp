@@ -0,0 +1,183 @@
+/**
+ * @file bench/main.cpp
+ * @brief Entry point for DownPourBench, the headless rendering benchmark
+ *
+ * Renders the scene offscreen along a scripted drive with rain off and on,
+ * then prints per-run CPU/GPU frame time percentiles and draw/triangle
+ * counts as JSON. Logger output and anything the engine prints to std::cout
+ * go to stderr, so stdout holds only the report unless --output is given.
+ * Run from the project root, like the app, so assets and shaders resolve.
+ *
+ * Usage: DownPourBench [--frames N] [--warmup N] [--width W] [--height H]
+ *                      [--frames-in-flight N] [--rain on|off|both] [--replay path] [--output path]
+ *
+ * --replay drives a recording made with `DownPour --record path` instead of
+ * the scripted loop, so two builds benchmarked on it render identical frames.
+ */
+
+#include "DownPour.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Percentiles {
+    double min = 0.0, p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0, mean = 0.0;
+};
+
+Percentiles percentiles(std::vector<double> values) {
+    Percentiles result;
+    if (values.empty())
+        return result;
+
+    std::sort(values.begin(), values.end());
+    auto at = [&](double q) { return values[static_cast<size_t>(q * static_cast<double>(values.size() - 1) + 0.5)]; };
+
+    double sum = 0.0;
+    for (double v : values)
+        sum += v;
+
+    result.min  = values.front();
+    result.p50  = at(0.50);
+    result.p90  = at(0.90);
+    result.p99  = at(0.99);
+    result.max  = values.back();
+    result.mean = sum / static_cast<double>(values.size());
+    return result;
+}
+
+void writePercentiles(std::ostream& out, const char* name, const Percentiles& p) {
+    out << "      \"" << name << "\": {\"min\": " << p.min << ", \"p50\": " << p.p50 << ", \"p90\": " << p.p90
+        << ", \"p99\": " << p.p99 << ", \"max\": " << p.max << ", \"mean\": " << p.mean << "}";
+}
+
+// A JSON string's contents: quotes, backslashes (e.g. Windows paths) and control characters escaped
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        const unsigned char code = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (code < 0x20) {
+            char sequence[8];
+            std::snprintf(sequence, sizeof(sequence), "\\u%04x", static_cast<unsigned>(code));
+            escaped += sequence;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeReport(std::ostream& out, const DownPour::BenchmarkConfig& config,
+                 const std::vector<DownPour::BenchmarkRun>& runs) {
+    out << "{\n";
+    out << "  \"width\": " << config.width << ",\n";
+    out << "  \"height\": " << config.height << ",\n";
+    out << "  \"frames\": " << config.frames << ",\n";
+    out << "  \"replay\": \"" << jsonEscape(config.replayPath) << "\",\n";
+    out << "  \"runs\": [\n";
+
+    for (size_t r = 0; r < runs.size(); r++) {
+        const DownPour::BenchmarkRun& run = runs[r];
+
+        std::vector<double> cpu, gpu(run.gpuMs.begin(), run.gpuMs.end()), draws, triangles;
+        for (const DownPour::BenchmarkFrame& frame : run.frames) {
+            cpu.push_back(frame.cpuMs);
+            draws.push_back(frame.drawCalls);
+            triangles.push_back(static_cast<double>(frame.triangles));
+        }
+
+        out << "    {\n";
+        out << "      \"rain\": " << (run.raining ? "true" : "false") << ",\n";
+        out << "      \"gpuSamples\": " << gpu.size() << ",\n";
+        writePercentiles(out, "cpuMs", percentiles(cpu));
+        out << ",\n";
+        writePercentiles(out, "gpuMs", percentiles(gpu));
+        out << ",\n";
+        writePercentiles(out, "drawCalls", percentiles(draws));
+        out << ",\n";
+        writePercentiles(out, "triangles", percentiles(triangles));
+        out << "\n    }" << (r + 1 < runs.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    DownPour::Application     app;
+    DownPour::BenchmarkConfig config;
+    std::string               outputPath;
+
+    // Keep the logger and the engine's std::cout prints off stdout, where the report goes by default
+    LogBackend::get().setSink(std::make_unique<ConsoleLogger>(stderr));
+    std::ostream report(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for option: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::string value = argv[++i];
+            if (arg == "--frames") {
+                config.frames = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--warmup") {
+                config.warmupFrames = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--width") {
+                config.width = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--height") {
+                config.height = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--frames-in-flight") {
+                app.setFramesInFlight(static_cast<uint32_t>(std::stoul(value)));
+            } else if (arg == "--rain") {
+                if (value != "on" && value != "off" && value != "both") {
+                    std::cerr << "Invalid --rain value: " << value << " (expected on, off or both)" << std::endl;
+                    return EXIT_FAILURE;
+                }
+                config.rainOff = value != "on";
+                config.rainOn  = value != "off";
+            } else if (arg == "--replay") {
+                config.replayPath = value;
+            } else if (arg == "--output") {
+                outputPath = value;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        std::vector<DownPour::BenchmarkRun> runs = app.runBenchmark(config);
+        LogBackend::get().flush();
+
+        if (outputPath.empty()) {
+            writeReport(report, config, runs);
+        } else {
+            std::ofstream file(outputPath);
+            if (!file)
+                throw std::runtime_error("Failed to open benchmark output: " + outputPath);
+            writeReport(file, config, runs);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
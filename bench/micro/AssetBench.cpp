@@ -0,0 +1,64 @@
+/**
+ * @file bench/micro/AssetBench.cpp
+ * @brief Asset microbenchmarks: glTF parsing and scene building from the bundled models
+ *
+ * GLTFLoader::load() is the CPU part of Model::loadFromFile(), before any mesh
+ * processing or upload, so neither the mesh cache nor a device is involved.
+ * SceneBuilder::buildFromModel() is timed into a fresh scene each iteration,
+ * from a model parsed once up front.
+ */
+
+#include "renderer/GLTFLoader.h"
+#include "renderer/Model.h"
+#include "scene/Scene.h"
+#include "scene/SceneBuilder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace DownPour;
+
+void BM_GLTFLoad(benchmark::State& state, const std::string& path) {
+    for (auto _ : state) {
+        Model model;
+        if (!GLTFLoader::load(path, model)) {
+            state.SkipWithError(("Failed to load " + path + " (run from the project root)").c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(model.getMaterialCount());
+    }
+}
+BENCHMARK_CAPTURE(BM_GLTFLoad, bmw, std::string("assets/models/bmw/bmw.gltf"))->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_GLTFLoad, road, std::string("assets/models/road.glb"))->Unit(benchmark::kMillisecond);
+
+void BM_SceneBuilderBuild(benchmark::State& state, const std::string& path) {
+    Model model;
+    if (!GLTFLoader::load(path, model)) {
+        state.SkipWithError(("Failed to load " + path + " (run from the project root)").c_str());
+        return;
+    }
+
+    // Material i maps to MaterialManager ID i; only the lookup matters here
+    std::unordered_map<size_t, uint32_t> materialIds;
+    for (size_t i = 0; i < model.getMaterialCount(); i++)
+        materialIds[i] = static_cast<uint32_t>(i);
+
+    size_t nodeCount = 0;
+    for (auto _ : state) {
+        Scene                   scene("bench");
+        std::vector<NodeHandle> roots = SceneBuilder::buildFromModel(&scene, &model, materialIds);
+        benchmark::DoNotOptimize(roots.data());
+        nodeCount = scene.getNodeCount();
+    }
+    state.counters["nodes"] = static_cast<double>(nodeCount);
+}
+BENCHMARK_CAPTURE(BM_SceneBuilderBuild, bmw, std::string("assets/models/bmw/bmw.gltf"))
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SceneBuilderBuild, road, std::string("assets/models/road.glb"))->Unit(benchmark::kMicrosecond);
+
+}  // namespace
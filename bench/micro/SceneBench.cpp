@@ -0,0 +1,172 @@
+/**
+ * @file bench/micro/SceneBench.cpp
+ * @brief Scene graph microbenchmarks: transform updates, render batching and frustum queries
+ *
+ * Scenes are synthetic: groups of GROUP_SIZE nodes (a root and its parts, as
+ * a prop or vehicle imported from glTF would be) laid out on a 10 m grid.
+ * Renderable fixtures give every part a unit box and one of MODEL_COUNT models,
+ * a tenth of them transparent. Dirty nodes are picked by a fixed hash, so
+ * every run of a benchmark updates the same ones.
+ */
+
+#include "renderer/Model.h"
+#include "scene/Scene.h"
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace DownPour;
+
+constexpr uint32_t GROUP_SIZE   = 16;     // A root and its parts
+constexpr uint32_t MODEL_COUNT  = 16;     // Distinct models the parts are spread over
+constexpr float    GRID_SPACING = 10.0f;  // Metres between group roots
+
+uint32_t hashIndex(uint32_t i) {
+    i ^= i >> 16;
+    i *= 0x7feb352du;
+    i ^= i >> 15;
+    i *= 0x846ca68bu;
+    i ^= i >> 16;
+    return i;
+}
+
+struct SceneFixture {
+    Scene                          scene{"bench"};
+    std::vector<NodeHandle>        handles;
+    std::array<Model, MODEL_COUNT> models;  // Only their addresses are used, as batch keys
+    uint32_t                       gridSide = 1;
+
+    SceneFixture(uint32_t nodeCount, bool renderable) {
+        const uint32_t groupCount = (nodeCount + GROUP_SIZE - 1) / GROUP_SIZE;
+        gridSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(groupCount))));
+
+        handles.reserve(nodeCount);
+        NodeHandle root;
+        for (uint32_t i = 0; i < nodeCount; i++) {
+            const uint32_t part = i % GROUP_SIZE;
+            if (part == 0) {
+                const uint32_t group = i / GROUP_SIZE;
+                root                 = scene.createNode("group" + std::to_string(group));
+                scene.getNode(root)->setLocalPosition(
+                    Vec3(static_cast<float>(group % gridSide), 0.0f, static_cast<float>(group / gridSide)) *
+                    GRID_SPACING);
+                handles.push_back(root);
+                continue;
+            }
+
+            const NodeHandle handle = scene.createNode("part" + std::to_string(i), root);
+            SceneNode*       node   = scene.getNode(handle);
+            const float      column = static_cast<float>(part % 4) - 1.5f;
+            const float      row    = 0.5f * static_cast<float>(part / 4);
+            node->setLocalPosition(Vec3(column, row, 0.0f));
+            node->setLocalRotation(glm::angleAxis(0.1f * static_cast<float>(part), Vec3(0.0f, 1.0f, 0.0f)));
+
+            if (renderable) {
+                node->boundsMin = Vec3(-0.5f);
+                node->boundsMax = Vec3(0.5f);
+
+                SceneNode::RenderData renderData;
+                renderData.model          = &models[i % MODEL_COUNT];
+                renderData.meshIndex      = 0;
+                renderData.primitiveIndex = 0;
+                renderData.materialId     = i % 32;
+                renderData.isTransparent  = i % 10 == 0;
+                renderData.indexCount     = 36;
+                scene.setRenderData(handle, renderData);
+            }
+            handles.push_back(handle);
+        }
+
+        // Builds the hierarchy and spatial index, so the benchmarks time only the steady state
+        scene.updateTransforms();
+    }
+
+    // Nudge `count` hashed nodes, as animation systems do each frame
+    void moveNodes(uint32_t count, uint32_t frame) {
+        for (uint32_t j = 0; j < count; j++) {
+            const NodeHandle handle = handles[hashIndex(frame * count + j) % handles.size()];
+            SceneNode*       node   = scene.getNode(handle);
+            node->setLocalPosition(node->localPosition + Vec3(0.0f, (frame & 1) ? -0.01f : 0.01f, 0.0f));
+            scene.markDirty(handle);
+        }
+    }
+
+    // From above one corner of the grid towards its centre; sees roughly a quarter of it
+    glm::mat4 cornerViewProj() const {
+        const float     extent = static_cast<float>(gridSide) * GRID_SPACING;
+        const glm::mat4 view   = glm::lookAt(Vec3(-20.0f, 30.0f, -20.0f), Vec3(0.5f * extent, 0.0f, 0.5f * extent),
+                                             Vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+        proj[1][1] *= -1;
+        return proj * view;
+    }
+};
+
+// One frame's transform work: capture last frame's transforms, move nodes, update, as SceneManager::update() does
+void BM_SceneUpdateTransforms(benchmark::State& state) {
+    const uint32_t nodeCount  = static_cast<uint32_t>(state.range(0));
+    const uint32_t dirtyCount = std::max(1u, nodeCount * static_cast<uint32_t>(state.range(1)) / 100);
+    SceneFixture   fixture(nodeCount, false);
+
+    uint32_t frame = 0;
+    for (auto _ : state) {
+        fixture.scene.capturePreviousTransforms();
+        fixture.moveNodes(dirtyCount, frame++);
+        fixture.scene.updateTransforms();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * dirtyCount);
+}
+BENCHMARK(BM_SceneUpdateTransforms)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 10, 100}})
+    ->ArgNames({"nodes", "dirtyPercent"})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SceneGetRenderBatches(benchmark::State& state) {
+    const uint32_t nodeCount = static_cast<uint32_t>(state.range(0));
+    SceneFixture   fixture(nodeCount, true);
+    FrameArena     arena;
+
+    for (auto _ : state) {
+        arena.reset();
+        ArenaVector<Scene::RenderBatch> batches = fixture.scene.getRenderBatches(arena);
+        benchmark::DoNotOptimize(batches.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nodeCount);
+}
+BENCHMARK(BM_SceneGetRenderBatches)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->ArgName("nodes")
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SceneCollectVisibleNodes(benchmark::State& state) {
+    const uint32_t          nodeCount = static_cast<uint32_t>(state.range(0));
+    SceneFixture            fixture(nodeCount, true);
+    const glm::mat4         viewProj = fixture.cornerViewProj();
+    std::vector<SceneNode*> visible;
+
+    for (auto _ : state) {
+        visible.clear();
+        fixture.scene.collectVisibleNodes(viewProj, visible);
+        benchmark::DoNotOptimize(visible.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nodeCount);
+    state.counters["visible"] = static_cast<double>(visible.size());
+}
+BENCHMARK(BM_SceneCollectVisibleNodes)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->ArgName("nodes")
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,58 @@
+/**
+ * @file bench/micro/WeatherBench.cpp
+ * @brief CPU rain microbenchmarks
+ *
+ * WeatherSystem's CPU field holds a fixed 5k drops, so it is timed at that
+ * size; larger counts time its RaindropField directly, full, the way the
+ * weather system steps it. Only the CPU fallback is covered: the GPU rain
+ * needs a device and is measured by DownPourBench.
+ */
+
+#include "simulation/RaindropField.h"
+#include "simulation/WeatherSystem.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace {
+
+using namespace DownPour::Simulation;
+
+constexpr float FRAME_SECONDS = 1.0f / 60.0f;
+
+void BM_WeatherSystemUpdate(benchmark::State& state) {
+    WeatherSystem weather;
+    weather.setWeatherState(WeatherSystem::WeatherState::Rainy);
+    weather.reseed(1);
+    weather.update(60.0f);  // A minute of rain fills the ring; drops are recycled in place from then on
+
+    for (auto _ : state) {
+        weather.update(FRAME_SECONDS);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * weather.getActiveDrops().size()));
+}
+BENCHMARK(BM_WeatherSystemUpdate)->Unit(benchmark::kMicrosecond);
+
+void BM_RaindropFieldUpdate(benchmark::State& state) {
+    const size_t  dropCount = static_cast<size_t>(state.range(0));
+    RaindropField field(dropCount);
+    field.reseed(1);
+    for (size_t i = 0; i < dropCount; i++)
+        field.spawn();
+
+    for (auto _ : state) {
+        field.update(FRAME_SECONDS);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * dropCount));
+}
+BENCHMARK(BM_RaindropFieldUpdate)
+    ->Arg(5000)
+    ->Arg(50000)
+    ->Arg(500000)
+    ->ArgName("drops")
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,37 @@
+/**
+ * @file bench/micro/main.cpp
+ * @brief Entry point for DownPourMicroBench, microbenchmarks of CPU hot paths (Google Benchmark)
+ *
+ * Covers scene transform updates, render batching and frustum queries on
+ * synthetic scenes (SceneBench.cpp), CPU rain from 5k to 500k drops
+ * (WeatherBench.cpp), and glTF loading and scene building from the bundled
+ * models (AssetBench.cpp). No window or Vulkan device is created. Run from the
+ * project root, like the app, so the models resolve; a benchmark whose model is
+ * missing reports an error and the others still run.
+ *
+ * Takes Google Benchmark's flags; to keep a report per commit:
+ *   DownPourMicroBench --benchmark_out=microbench_results.json --benchmark_out_format=json
+ * and to run one group: --benchmark_filter=Scene
+ */
+
+#include "logger/Logger.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+int main(int argc, char** argv) {
+    // Keep the logger off stdout, where the console report goes
+    LogBackend::get().setSink(std::make_unique<ConsoleLogger>(stderr));
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return EXIT_FAILURE;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    LogBackend::get().flush();
+    return EXIT_SUCCESS;
+}
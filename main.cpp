@@ -7,14 +7,52 @@
  */
 
 #include "src/DownPour.h"
+#include "src/logger/Logger.h"
 
 #include <iostream>
 #include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
-int main() {
+int main(int argc, char** argv) {
     DownPour::Application app;
 
     try {
+        // --frames-in-flight <1-3>: 1 for the lowest input latency, 3 for the most throughput (default 2)
+        for (int i = 1; i + 1 < argc; i++) {
+            if (std::string(argv[i]) == "--frames-in-flight") {
+                app.setFramesInFlight(static_cast<uint32_t>(std::stoul(argv[++i])));
+            }
+            // --target-frame-ms <ms>: GPU frame time the render scale holds, 0 for a fixed full resolution
+            else if (std::string(argv[i]) == "--target-frame-ms") {
+                app.setTargetFrameTime(std::stof(argv[++i]));
+            }
+            // --stream-textures <on|off>: load material textures progressively instead of all before the first frame
+            else if (std::string(argv[i]) == "--stream-textures") {
+                app.setTextureStreaming(std::string(argv[++i]) == "on");
+            }
+            // --telemetry <on|off>: publish per-frame telemetry to shared memory for SystemMonitor (default on)
+            else if (std::string(argv[i]) == "--telemetry") {
+                app.setTelemetry(std::string(argv[++i]) == "on");
+            }
+            // --log-file <path>: write the log to a file instead of the console
+            else if (std::string(argv[i]) == "--log-file") {
+                auto file = std::make_unique<FileLogger>(argv[++i]);
+                if (!file->isOpen())
+                    throw std::runtime_error(std::string("Failed to open log file: ") + argv[i]);
+                LogBackend::get().setSink(std::move(file));
+            }
+            // --record <path>: save every simulation step's input on exit, for --replay and DownPourBench
+            else if (std::string(argv[i]) == "--record") {
+                app.recordInput(argv[++i]);
+            }
+            // --replay <path>: drive from a recording instead of the keyboard
+            else if (std::string(argv[i]) == "--replay") {
+                app.replayInput(argv[++i]);
+            }
+        }
+
         app.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
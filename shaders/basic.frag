@@ -1,8 +1,15 @@
 #version 450
 
 layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec4 fragClipPosition;  // Without jitter
+layout(location = 2) in vec4 fragPreviousClipPosition;
+
 layout(location = 0) out vec4 outColor;
+layout(location = 2) out vec2 outMotion;  // Screen UV moved since last frame
 
 void main() {
     outColor = vec4(fragColor, 1.0);
+    outMotion = fragPreviousClipPosition.w > 0.0
+        ? (fragClipPosition.xy / fragClipPosition.w - fragPreviousClipPosition.xy / fragPreviousClipPosition.w) * 0.5
+        : vec2(0.0);
 }
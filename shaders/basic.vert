@@ -1,9 +1,20 @@
 #version 450
 
+  // The whole CameraUBO (DownPour.h): the motion vectors' views follow the shadows and reflections
   layout(set = 0, binding = 0) uniform CameraUBO {
       mat4 view;
       mat4 projection;
       mat4 viewProjection;
+      mat4 cascadeViewProj[3];
+      vec4 cascadeRadii;
+      vec4 cascadeTexels;
+      vec4 sunDirection;
+      vec4 cameraPosition;
+      mat4 reflectionViewProj;
+      vec4 reflectionRegion;
+      vec4 reflectionParams;
+      mat4 motionViewProj;    // MotionUBO: this frame's view without the upscaler's jitter
+      mat4 previousViewProj;  // Last frame's, likewise
   } camera;
 
   // Hardcoded cube vertices (36 vertices for 6 faces)
@@ -30,6 +41,10 @@
 
   layout(location = 0) out vec3 fragColor;
 
+  // Motion vectors: the sky box holds still, so only the camera moves it
+  layout(location = 1) out vec4 fragClipPosition;
+  layout(location = 2) out vec4 fragPreviousClipPosition;
+
   void main() {
       vec3 pos = positions[gl_VertexIndex] * 100.0;  // Large skybox
       gl_Position = camera.viewProjection * vec4(pos, 1.0);
@@ -39,4 +54,7 @@
       vec3 skyBottom = vec3(0.3, 0.4, 0.6);  // Blue-grey
       vec3 skyTop = vec3(0.5, 0.7, 1.0);     // Light blue
       fragColor = mix(skyBottom, skyTop, t);
+
+      fragClipPosition = camera.motionViewProj * vec4(pos, 1.0);
+      fragPreviousClipPosition = camera.previousViewProj * vec4(pos, 1.0);
   }
\ No newline at end of file
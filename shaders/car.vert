@@ -1,15 +1,36 @@
 #version 450
 
+// The whole CameraUBO (DownPour.h): the motion vectors' views follow the shadows and reflections
 layout(set = 0, binding = 0) uniform CameraUBO {
     mat4 view;
     mat4 projection;
     mat4 viewProjection;
+    mat4 cascadeViewProj[3];
+    vec4 cascadeRadii;
+    vec4 cascadeTexels;
+    vec4 sunDirection;
+    vec4 cameraPosition;
+    mat4 reflectionViewProj;
+    vec4 reflectionRegion;
+    vec4 reflectionParams;
+    mat4 motionViewProj;    // MotionUBO: this frame's view without the upscaler's jitter
+    mat4 previousViewProj;  // Last frame's, likewise
 } camera;
 
-layout(push_constant) uniform PushConstants {
+// Per-draw object data; the indirect command's firstInstance selects the entry
+struct ObjectData {
     mat4 model;
-} push;
+    vec4 dequantOffset;  // xyz: position offset, w: 1 = octahedral normals
+    vec4 dequantScale;   // xyz: position scale
+    uint materialIndex;
+    mat4 previousModel;  // Last frame's transform, for the motion vectors
+};
 
+layout(std430, set = 0, binding = 1) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+} objectBuffer;
+
+// Float models: vec3/vec3/vec2. Packed models: UNORM16 position, SNORM16 octahedral normal in .xy, half UV
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
@@ -17,12 +38,34 @@ layout(location = 2) in vec2 inTexCoord;
 layout(location = 0) out vec3 fragPosition;
 layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec2 fragTexCoord;
+layout(location = 3) flat out uint fragMaterialIndex;
+
+// Motion vectors: where the point is and was, both without jitter
+layout(location = 4) out vec4 fragClipPosition;
+layout(location = 5) out vec4 fragPreviousClipPosition;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
 
 void main() {
-    vec4 worldPos = push.model * vec4(inPosition, 1.0);
+    ObjectData object = objectBuffer.objects[gl_InstanceIndex];
+    mat4 model = object.model;
+
+    // Identity (offset 0, scale 1) for float models
+    vec3 position = object.dequantOffset.xyz + inPosition * object.dequantScale.xyz;
+    vec3 normal = object.dequantOffset.w > 0.5 ? decodeOctahedral(inNormal.xy) : inNormal;
+
+    vec4 worldPos = model * vec4(position, 1.0);
     gl_Position = camera.viewProjection * worldPos;
 
     fragPosition = worldPos.xyz;
-    fragNormal = mat3(transpose(inverse(push.model))) * inNormal;
+    fragNormal = mat3(transpose(inverse(model))) * normal;
     fragTexCoord = inTexCoord;
+    fragMaterialIndex = object.materialIndex;
+    fragClipPosition = camera.motionViewProj * worldPos;
+    fragPreviousClipPosition = camera.previousViewProj * (object.previousModel * vec4(position, 1.0));
 }
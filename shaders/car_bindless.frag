@@ -0,0 +1,214 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_GOOGLE_include_directive : require
+
+// Bindless variant of car.frag: one descriptor set holds every material
+struct MaterialData {
+    uint baseColorIndex;
+    uint normalMapIndex;
+    uint metallicRoughnessIndex;
+    uint emissiveIndex;
+    float alphaValue;
+    uint flags;
+};
+
+// Material features (MaterialFeature in Material.h), fixed per pipeline variant so unused
+// maps are never sampled and the branches below compile away
+layout(constant_id = 0) const bool HAS_NORMAL_MAP = false;
+layout(constant_id = 1) const bool HAS_METALLIC_ROUGHNESS = false;
+layout(constant_id = 2) const bool HAS_EMISSIVE = false;
+layout(constant_id = 3) const bool IS_TRANSPARENT = false;
+
+// Not a material feature: set for the road's pipelines, which shade in the wet road's reflections
+layout(constant_id = 4) const bool IS_ROAD = false;
+
+// Sun shadows follow the view matrices (ShadowUBO in DownPour.h); a MirrorUBO keeps them at the same offset
+layout(set = 0, binding = 0) uniform CameraUBO {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 cascadeViewProj[3];
+    vec4 cascadeRadii;    // xyz: distance from the camera each cascade covers
+    vec4 cascadeTexels;   // xyz: world size of a texel per cascade
+    vec4 sunDirection;    // xyz: toward the sun
+    vec4 cameraPosition;
+    mat4 reflectionViewProj;  // Wet road reflections (ReflectionUBO in DownPour.h): the view they were traced from
+    vec4 reflectionRegion;    // xy: texels traced
+    vec4 reflectionParams;    // x: wetness (0: nothing to read), y: image, view distance = w / (depth + z)
+} camera;
+
+layout(set = 0, binding = 2) uniform sampler2DArrayShadow shadowMap;
+
+layout(std430, set = 1, binding = 0) readonly buffer MaterialBuffer {
+    MaterialData materials[];
+} materialBuffer;
+
+layout(set = 1, binding = 1) uniform sampler2D textures[];
+
+layout(location = 0) in vec3 fragPosition;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec2 fragTexCoord;
+layout(location = 3) flat in uint fragMaterialIndex;
+layout(location = 4) in vec4 fragClipPosition;  // Without jitter
+layout(location = 5) in vec4 fragPreviousClipPosition;
+
+// Transparent variants draw in the OIT subpass: location 0 accumulates, location 1 is revealage.
+// Opaque ones write color and, in the main pass, motion vectors (SwapChainManager::OPAQUE_COLOR_TARGETS)
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out float outRevealage;
+layout(location = 2) out vec2 outMotion;
+
+// Screen UV this point moved by since last frame, into the motion target
+vec2 motionVector() {
+    if (fragPreviousClipPosition.w <= 0.0)
+        return vec2(0.0);  // Behind the eye last frame: no history to point at
+    vec2 current = fragClipPosition.xy / fragClipPosition.w;
+    vec2 previous = fragPreviousClipPosition.xy / fragPreviousClipPosition.w;
+    return (current - previous) * 0.5;
+}
+
+#include "oit.glsl"
+
+// Perturb the vertex normal by a tangent-space normal map, building the tangent
+// frame from screen-space derivatives since vertices carry no tangents
+vec3 perturbNormal(vec3 normal, vec3 mapped) {
+    vec3 dp1 = dFdx(fragPosition);
+    vec3 dp2 = dFdy(fragPosition);
+    vec2 duv1 = dFdx(fragTexCoord);
+    vec2 duv2 = dFdy(fragTexCoord);
+
+    vec3 dp2perp = cross(dp2, normal);
+    vec3 dp1perp = cross(normal, dp1);
+    vec3 tangent = dp2perp * duv1.x + dp1perp * duv2.x;
+    vec3 bitangent = dp2perp * duv1.y + dp1perp * duv2.y;
+    float invmax = inversesqrt(max(dot(tangent, tangent), dot(bitangent, bitangent)));
+
+    return normalize(mat3(tangent * invmax, bitangent * invmax, normal) * (mapped * 2.0 - 1.0));
+}
+
+// Fraction of sunlight reaching this point, from the nearest cascade that covers it. Offset along the normal
+// by a texel or so, so surfaces don't shadow themselves; the compare sampler filters 2x2 where it can
+float sunVisibility(vec3 normal) {
+    float dist = length(fragPosition - camera.cameraPosition.xyz);
+    for (int i = 0; i < 3; i++) {
+        if (dist < camera.cascadeRadii[i]) {
+            vec3 position = fragPosition + normal * camera.cascadeTexels[i] * 1.5;
+            vec4 clip = camera.cascadeViewProj[i] * vec4(position, 1.0);
+            return texture(shadowMap, vec4(clip.xy * 0.5 + 0.5, float(i), clip.z));
+        }
+    }
+    return 1.0;
+}
+
+#include "local_lighting.glsl"
+
+// Wet road reflections (WetRoadReflections.h), traced last frame at half resolution. Upsampled bilaterally:
+// of the four texels around a point, those whose depth is far from its own are left out, so reflections
+// stop at silhouettes. rgb is premultiplied by a, the share of rays that hit anything on screen
+layout(set = 0, binding = 5) uniform sampler2D reflections[2];
+layout(set = 0, binding = 6) uniform sampler2D reflectionDepth;
+
+vec4 wetReflection(vec3 position) {
+    // A perspective clip w is the view distance the traced depths are compared in
+    vec4 clip = camera.reflectionViewProj * vec4(position, 1.0);
+    if (clip.w <= 0.0)
+        return vec4(0.0);
+    vec2 uv = clip.xy / clip.w * 0.5 + 0.5;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))))
+        return vec4(0.0);
+
+    vec2 texel = uv * camera.reflectionRegion.xy - 0.5;
+    ivec2 base = ivec2(floor(texel));
+    vec2 blend = texel - vec2(base);
+    ivec2 last = ivec2(camera.reflectionRegion.xy) - 1;
+    bool first = camera.reflectionParams.y < 0.5;
+
+    vec4 sum = vec4(0.0);
+    float total = 0.0;
+    for (int i = 0; i < 4; i++) {
+        ivec2 corner = ivec2(i & 1, i >> 1);
+        ivec2 tap = clamp(base + corner, ivec2(0), last);
+        float depth = texelFetch(reflectionDepth, tap, 0).r;
+        float tapDistance = camera.reflectionParams.w / (depth + camera.reflectionParams.z);
+        vec2 bilinear = mix(1.0 - blend, blend, vec2(corner));
+        float weight = bilinear.x * bilinear.y * clamp(1.0 - abs(tapDistance - clip.w) / (0.05 * clip.w), 0.0, 1.0);
+        sum += weight * (first ? texelFetch(reflections[0], tap, 0) : texelFetch(reflections[1], tap, 0));
+        total += weight;
+    }
+    return total < 1e-3 ? vec4(0.0) : sum / total;
+}
+
+// Blend the reflections in by a Schlick fresnel (f0 of water), scaled by how wet the road is. Rays that
+// found nothing on screen reflect the overcast sky
+vec3 applyWetReflection(vec3 color, vec3 position, vec3 normal, vec3 eyeDir) {
+    float wetness = camera.reflectionParams.x;
+    if (wetness <= 0.0)
+        return color;
+    vec4 reflection = wetReflection(position);
+    float fresnel = 0.02 + 0.98 * pow(1.0 - max(dot(normal, eyeDir), 0.0), 5.0);
+    vec3 sky = vec3(0.45, 0.5, 0.55);
+    return mix(color, reflection.rgb + (1.0 - reflection.a) * sky, wetness * fresnel);
+}
+
+void main() {
+    MaterialData material = materialBuffer.materials[fragMaterialIndex];
+
+    // Sample the texture
+    vec4 texColor = texture(textures[nonuniformEXT(material.baseColorIndex)], fragTexCoord);
+
+    vec3 lightDir = camera.sunDirection.xyz;
+    vec3 normal = normalize(fragNormal);
+    if (HAS_NORMAL_MAP) {
+        vec3 mapped = texture(textures[nonuniformEXT(material.normalMapIndex)], fragTexCoord).rgb;
+        normal = perturbNormal(normal, mapped);
+    }
+
+    // Diffuse lighting, only where the sun reaches
+    float diff = max(dot(normal, lightDir), 0.0) * sunVisibility(normalize(fragNormal));
+
+    // Brighter ambient for daylight scene
+    vec3 ambient = 0.5 * texColor.rgb;
+    vec3 diffuse = 0.8 * diff * texColor.rgb;
+
+    // Add subtle rim light for depth (simulates sky light)
+    vec3 viewDir = normalize(vec3(0.0, 1.0, 0.0) - fragPosition);
+    float rim = 1.0 - max(dot(normal, viewDir), 0.0);
+    vec3 rimLight = 0.15 * rim * vec3(0.7, 0.8, 1.0); // Blue-ish sky color
+
+    vec3 finalColor = ambient + diffuse + rimLight;
+
+    // Headlights, taillights and street lamps near this point
+    vec3 eyeDir = normalize(camera.cameraPosition.xyz - fragPosition);
+    finalColor += localLighting(fragPosition, normal, eyeDir, texColor.rgb, 0.5);
+
+    if (HAS_METALLIC_ROUGHNESS) {
+        // glTF packs roughness in G and metallic in B
+        vec2 metallicRoughness = texture(textures[nonuniformEXT(material.metallicRoughnessIndex)], fragTexCoord).bg;
+        float metallic = metallicRoughness.x;
+        float roughness = max(metallicRoughness.y, 0.05);
+
+        vec3 halfDir = normalize(lightDir + viewDir);
+        float shininess = 2.0 / (roughness * roughness) - 2.0;
+        vec3 f0 = mix(vec3(0.04), texColor.rgb, metallic);
+        finalColor = finalColor * (1.0 - 0.5 * metallic) + f0 * pow(max(dot(normal, halfDir), 0.0), shininess) * diff;
+    }
+
+    if (IS_ROAD) {
+        finalColor = applyWetReflection(finalColor, fragPosition, normal, eyeDir);
+    }
+
+    if (HAS_EMISSIVE) {
+        finalColor += texture(textures[nonuniformEXT(material.emissiveIndex)], fragTexCoord).rgb;
+    }
+
+    // Per-material alpha is available here, unlike the per-set path
+    float alpha = IS_TRANSPARENT ? material.alphaValue : 1.0;
+
+    if (IS_TRANSPARENT) {
+        outColor = vec4(finalColor * alpha, alpha) * oitWeight(alpha);
+        outRevealage = alpha;
+    } else {
+        outColor = vec4(finalColor, alpha);
+        outMotion = motionVector();
+    }
+}
@@ -0,0 +1,6 @@
+#version 450
+
+// Fragment stage for depth-only passes (the rain occlusion map, shadow cascades); the depth test does the work.
+
+void main() {
+}
@@ -0,0 +1,18 @@
+#ifndef LIGHT_GRID_GLSL
+#define LIGHT_GRID_GLSL
+
+// The main view's froxel grid and light records (ClusteredLights.h); the
+// constants must match ClusteredLights' GRID_X/Y/Z and LIGHTS_PER_CLUSTER
+const uint GRID_X             = 16;
+const uint GRID_Y             = 9;
+const uint GRID_Z             = 24;
+const uint LIGHTS_PER_CLUSTER = 32;
+
+struct Light {
+    vec4 positionRange;  // xyz: world position, w: range
+    vec4 color;          // rgb: color * intensity
+    vec4 spotDirection;  // xyz: cone axis, w: cosine of the half-angle; -1 lights every direction
+    vec4 bounds;         // World sphere the light reaches
+};
+
+#endif
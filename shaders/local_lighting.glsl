@@ -0,0 +1,58 @@
+#ifndef LOCAL_LIGHTING_GLSL
+#define LOCAL_LIGHTING_GLSL
+
+#include "light_grid.glsl"
+
+// Local lights (ClusteredLights.h): the froxel of the main view a point falls in lists the lights reaching it.
+// Points outside the main view's grid, e.g. seen only in a mirror, get none
+layout(std430, set = 0, binding = 3) readonly buffer LocalLights {
+    mat4  view;
+    mat4  viewProj;
+    mat4  inverseProj;
+    vec4  depthParams;  // z/w: slice = log(view depth) * z + w
+    uvec4 counts;
+    Light lights[];
+} local;
+
+layout(std430, set = 0, binding = 4) readonly buffer LightClusters {
+    uint clusters[];
+};
+
+// Diffuse and Blinn-Phong specular from the lights of this point's froxel. Falloff is smooth and reaches
+// zero at each light's range; spots fade in over the outer fifth of their cone
+vec3 localLighting(vec3 position, vec3 normal, vec3 viewDir, vec3 albedo, float specular) {
+    // A perspective clip w is the view depth the grid is sliced by
+    vec4 clip = local.viewProj * vec4(position, 1.0);
+    if (clip.w <= 0.0)
+        return vec3(0.0);
+    vec2 ndc = clip.xy / clip.w;
+    int slice = int(max(log(clip.w) * local.depthParams.z + local.depthParams.w, 0.0));
+    if (any(greaterThanEqual(abs(ndc), vec2(1.0))) || slice >= int(GRID_Z))
+        return vec3(0.0);
+
+    uvec2 tile = min(uvec2((ndc * 0.5 + 0.5) * vec2(GRID_X, GRID_Y)), uvec2(GRID_X - 1, GRID_Y - 1));
+    uint base = (tile.x + GRID_X * (tile.y + GRID_Y * uint(slice))) * (LIGHTS_PER_CLUSTER + 1);
+
+    vec3 result = vec3(0.0);
+    uint count = clusters[base];
+    for (uint i = 0; i < count; i++) {
+        Light light = local.lights[clusters[base + 1 + i]];
+        vec3 toLight = light.positionRange.xyz - position;
+        float dist = length(toLight);
+        vec3 dir = toLight / max(dist, 1e-4);
+
+        float window = clamp(1.0 - (dist * dist) / (light.positionRange.w * light.positionRange.w), 0.0, 1.0);
+        float attenuation = window * window;
+        if (light.spotDirection.w > -1.0) {
+            float edge = light.spotDirection.w;
+            attenuation *= smoothstep(edge, mix(edge, 1.0, 0.2), dot(-dir, light.spotDirection.xyz));
+        }
+
+        float diffuse = max(dot(normal, dir), 0.0);
+        float highlight = diffuse > 0.0 ? specular * pow(max(dot(normal, normalize(dir + viewDir)), 0.0), 32.0) : 0.0;
+        result += light.color.rgb * attenuation * (albedo * diffuse + highlight);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#version 450
+#extension GL_EXT_multiview : require
+
+// car.vert for the mirror pass: one view-projection per mirror, picked by the
+// multiview layer being rendered (see MirrorRenderer).
+
+// Bound in place of CameraUBO, which is the same size; length is MirrorRenderer::MAX_VIEWS
+layout(set = 0, binding = 0) uniform MirrorUBO {
+    mat4 viewProjection[3];
+} mirrors;
+
+// Per-draw object data; the indirect command's firstInstance selects the entry
+struct ObjectData {
+    mat4 model;
+    vec4 dequantOffset;  // xyz: position offset, w: 1 = octahedral normals
+    vec4 dequantScale;   // xyz: position scale
+    uint materialIndex;
+    mat4 previousModel;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+} objectBuffer;
+
+// Float models: vec3/vec3/vec2. Packed models: UNORM16 position, SNORM16 octahedral normal in .xy, half UV
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+
+layout(location = 0) out vec3 fragPosition;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+layout(location = 3) flat out uint fragMaterialIndex;
+
+// The mirror pass has no motion target; these only complete car.frag's inputs
+layout(location = 4) out vec4 fragClipPosition;
+layout(location = 5) out vec4 fragPreviousClipPosition;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+void main() {
+    ObjectData object = objectBuffer.objects[gl_InstanceIndex];
+    mat4 model = object.model;
+
+    // Identity (offset 0, scale 1) for float models
+    vec3 position = object.dequantOffset.xyz + inPosition * object.dequantScale.xyz;
+    vec3 normal = object.dequantOffset.w > 0.5 ? decodeOctahedral(inNormal.xy) : inNormal;
+
+    vec4 worldPos = model * vec4(position, 1.0);
+    gl_Position = mirrors.viewProjection[gl_ViewIndex] * worldPos;
+
+    fragPosition = worldPos.xyz;
+    fragNormal = mat3(transpose(inverse(model))) * normal;
+    fragTexCoord = inTexCoord;
+    fragMaterialIndex = object.materialIndex;
+    fragClipPosition = gl_Position;
+    fragPreviousClipPosition = gl_Position;
+}
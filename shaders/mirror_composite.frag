@@ -0,0 +1,14 @@
+#version 450
+
+// Copies one mirror layer into its screen rect; the mirror pass already reflected it.
+
+layout(set = 0, binding = 0) uniform sampler2DArray mirrorLayers;
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragLayer;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(texture(mirrorLayers, vec3(fragTexCoord, float(fragLayer))).rgb, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 450
+
+// One quad per mirror for the composite subpass.
+// Drawn as vkCmdDraw(4, mirrorCount) as a triangle strip with no vertex buffer bound;
+// the instance selects the mirror and its layer.
+
+layout(push_constant) uniform Params {
+    vec4 rects[3];  // x, y, width, height as fractions of the render area; MirrorRenderer::MAX_VIEWS
+} params;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragLayer;
+
+void main() {
+    vec2 corner = vec2(gl_VertexIndex & 1, (gl_VertexIndex >> 1) & 1);
+    vec4 rect = params.rects[gl_InstanceIndex];
+
+    gl_Position = vec4((rect.xy + corner * rect.zw) * 2.0 - 1.0, 0.0, 1.0);
+    fragTexCoord = corner;
+    fragLayer = gl_InstanceIndex;
+}
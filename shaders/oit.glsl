@@ -0,0 +1,12 @@
+#ifndef OIT_GLSL
+#define OIT_GLSL
+
+// Weighted blended OIT weight (McGuire and Bavoil 2013): nearer, more opaque layers dominate.
+// Every shader drawing into the OIT subpass (OITCompositor.h) weights its layers with this
+float oitWeight(float alpha) {
+    float a = min(1.0, alpha * 10.0) + 0.01;
+    float d = 1.0 - gl_FragCoord.z * 0.9;
+    return clamp(a * a * a * 1e8 * d * d * d, 1e-2, 3e3);
+}
+
+#endif
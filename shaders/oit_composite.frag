@@ -0,0 +1,24 @@
+#version 450
+
+// Resolves weighted blended OIT over the opaque color. The accumulation target
+// holds sum(weight * premultiplied color) and sum(weight * alpha), so their ratio
+// is the weighted average color of every transparent layer at this pixel; the
+// revealage target holds prod(1 - alpha), how much of the background shows through.
+// Blended with SRC_ALPHA / ONE_MINUS_SRC_ALPHA, so alpha = 1 - revealage.
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput accumTarget;
+layout(input_attachment_index = 1, set = 0, binding = 1) uniform subpassInput revealageTarget;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    float revealage = subpassLoad(revealageTarget).r;
+    if (revealage >= 0.999) {
+        discard;  // Nothing transparent covers this pixel
+    }
+
+    vec4 accum = subpassLoad(accumTarget);
+    vec3 average = accum.rgb / max(accum.a, 1e-5);
+
+    outColor = vec4(average, 1.0 - revealage);
+}
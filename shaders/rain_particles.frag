@@ -1,21 +1,28 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
-// TODO: Implement rain particle fragment shader
-// This shader will render rain droplets falling through the air
-// Effects to implement:
-// - Semi-transparent elongated droplets
-// - Motion blur for fast-moving rain
-// - Lighting/reflection on droplets
+// Semi-transparent rain streak; brightest along the centre line and
+// fading towards the tail and with distance from the camera. Drawn in the
+// OIT subpass (see car.frag), so overlapping streaks need no sorting.
 
 layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in float fragFade;
 
-layout(location = 0) out vec4 outColor;
+layout(location = 0) out vec4 outAccum;
+layout(location = 1) out float outRevealage;
+
+#include "oit.glsl"
 
 void main() {
-    // Placeholder: render as light blue semi-transparent particles
-    // TODO: Add proper droplet texture/shape
-    // TODO: Add atmospheric scattering for distant rain
-    // TODO: Add variation in droplet size and intensity
-    
-    outColor = vec4(0.7, 0.8, 0.9, 0.3); // Light blue, semi-transparent
+    float across = 1.0 - abs(fragTexCoord.x * 2.0 - 1.0);
+    float along  = 1.0 - fragTexCoord.y;
+    float alpha  = 0.35 * across * mix(0.4, 1.0, along) * fragFade;
+
+    if (alpha < 0.01) {
+        discard;
+    }
+
+    vec3 color = vec3(0.7, 0.8, 0.9);  // Light blue, semi-transparent
+    outAccum = vec4(color * alpha, alpha) * oitWeight(alpha);
+    outRevealage = alpha;
 }
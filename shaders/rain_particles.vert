@@ -1,29 +1,84 @@
 #version 450
 
-// TODO: Implement rain particle vertex shader
-// This shader will handle the transformation of rain droplet particles
-// Inputs will include:
-// - Particle position (world space)
-// - Particle velocity
-// - Particle lifetime/size
+// Expands each GPU raindrop into a camera-facing streak.
+// Drawn as vkCmdDraw(6, dropCount): gl_InstanceIndex selects the drop,
+// gl_VertexIndex selects the quad corner, so no vertex buffer is bound.
+// The step recycles drops against an occlusion map a few frames old; drops
+// below a surface in this frame's map collapse to nothing instead.
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec2 inTexCoord;
+struct RainDrop {
+    vec4 positionLife;  // xyz = world position, w = remaining lifetime (s)
+    vec4 velocitySize;  // xyz = velocity (m/s), w = streak width (m)
+};
 
-layout(location = 0) out vec2 fragTexCoord;
-
-layout(binding = 0) uniform CameraUBO {
+layout(set = 0, binding = 0) uniform CameraUBO {
     mat4 view;
     mat4 proj;
     mat4 viewProj;
 } camera;
 
+// Depth from the top of the occlusion volume down to the highest surface
+layout(set = 1, binding = 1) uniform sampler2D occlusionDepth;
+
+layout(std430, set = 1, binding = 2) readonly buffer RainDrops {
+    RainDrop drops[];
+};
+
+layout(push_constant) uniform RainParams {
+    vec4  occlusionArea;        // xy = map min corner (world xz), z = map size (0: no map), w = height of depth 0
+    float occlusionDepthRange;  // Metres from depth 0 to depth 1
+} params;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out float fragFade;
+
+// Streak length is the distance travelled during a typical camera exposure
+const float STREAK_TIME   = 1.0 / 60.0;
+const float FADE_DISTANCE = 25.0;
+
+const vec2 CORNERS[6] = vec2[](vec2(-1.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+                               vec2(-1.0, 0.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+// Height of the highest surface at a drop's position; below everything outside the map
+float surfaceHeight(vec3 position) {
+    if (params.occlusionArea.z <= 0.0) {
+        return -1e30;
+    }
+    vec2 uv = (position.xz - params.occlusionArea.xy) / params.occlusionArea.z;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) {
+        return -1e30;
+    }
+    return params.occlusionArea.w - textureLod(occlusionDepth, uv, 0.0).r * params.occlusionDepthRange;
+}
+
 void main() {
-    // Placeholder: simple passthrough
-    // TODO: Add particle billboard rotation to face camera
-    // TODO: Add particle size scaling based on lifetime
-    // TODO: Add wind effect displacement
-    
-    gl_Position = camera.viewProj * vec4(inPosition, 1.0);
-    fragTexCoord = inTexCoord;
+    RainDrop drop   = drops[gl_InstanceIndex];
+    vec2     corner = CORNERS[gl_VertexIndex];
+
+    // Camera position from the rigid view matrix
+    vec3 cameraPos = -transpose(mat3(camera.view)) * camera.view[3].xyz;
+
+    vec3 head     = drop.positionLife.xyz;
+    vec3 velocity = drop.velocitySize.xyz;
+
+    // Every corner at the same point outside the clip volume: no triangles
+    if (head.y < surfaceHeight(head)) {
+        gl_Position  = vec4(2.0, 2.0, 2.0, 1.0);
+        fragTexCoord = vec2(0.0);
+        fragFade     = 0.0;
+        return;
+    }
+    vec3 toCamera = normalize(cameraPos - head);
+
+    // Stretch along the velocity, widen perpendicular to it and the view direction
+    vec3  axis  = velocity * STREAK_TIME;
+    vec3  side  = cross(normalize(velocity), toCamera);
+    float width = drop.velocitySize.w;
+    side        = length(side) > 1e-4 ? normalize(side) * width : vec3(width, 0.0, 0.0);
+
+    vec3 worldPos = head - axis * corner.y + side * corner.x;
+
+    gl_Position  = camera.viewProj * vec4(worldPos, 1.0);
+    fragTexCoord = vec2(corner.x * 0.5 + 0.5, corner.y);
+    fragFade     = clamp(1.0 - distance(cameraPos, head) / FADE_DISTANCE, 0.0, 1.0);
 }
@@ -1,15 +1,115 @@
   #version 450
+  #extension GL_GOOGLE_include_directive : require
+
+  // Sun shadows follow the view matrices (ShadowUBO in DownPour.h)
+  layout(set = 0, binding = 0) uniform CameraUBO {
+      mat4 view;
+      mat4 projection;
+      mat4 viewProjection;
+      mat4 cascadeViewProj[3];
+      vec4 cascadeRadii;    // xyz: distance from the camera each cascade covers
+      vec4 cascadeTexels;   // xyz: world size of a texel per cascade
+      vec4 sunDirection;    // xyz: toward the sun
+      vec4 cameraPosition;
+      mat4 reflectionViewProj;  // Wet road reflections (ReflectionUBO in DownPour.h): the view they were traced from
+      vec4 reflectionRegion;    // xy: texels traced
+      vec4 reflectionParams;    // x: wetness (0: nothing to read), y: image, view distance = w / (depth + z)
+  } camera;
+
+  layout(set = 0, binding = 2) uniform sampler2DArrayShadow shadowMap;
 
   layout(location = 0) in vec3 fragNormal;
   layout(location = 1) in vec2 fragTexCoord;
+  layout(location = 2) in vec3 fragPosition;
+  layout(location = 3) in vec4 fragClipPosition;  // Without jitter
+  layout(location = 4) in vec4 fragPreviousClipPosition;
 
+  // Location 1 is the transparent variants' revealage in car.frag; nothing here
   layout(location = 0) out vec4 outColor;
+  layout(location = 2) out vec2 outMotion;
+
+  // Screen UV this point moved by since last frame, as in car.frag
+  vec2 motionVector() {
+      if (fragPreviousClipPosition.w <= 0.0)
+          return vec2(0.0);
+      vec2 current = fragClipPosition.xy / fragClipPosition.w;
+      vec2 previous = fragPreviousClipPosition.xy / fragPreviousClipPosition.w;
+      return (current - previous) * 0.5;
+  }
+
+  // Fraction of sunlight reaching this point, as in car.frag
+  float sunVisibility(vec3 normal) {
+      float dist = length(fragPosition - camera.cameraPosition.xyz);
+      for (int i = 0; i < 3; i++) {
+          if (dist < camera.cascadeRadii[i]) {
+              vec3 position = fragPosition + normal * camera.cascadeTexels[i] * 1.5;
+              vec4 clip = camera.cascadeViewProj[i] * vec4(position, 1.0);
+              return texture(shadowMap, vec4(clip.xy * 0.5 + 0.5, float(i), clip.z));
+          }
+      }
+      return 1.0;
+  }
+
+  #include "local_lighting.glsl"
+
+  // Wet road reflections (WetRoadReflections.h), traced last frame at half resolution. Upsampled bilaterally:
+  // of the four texels around a point, those whose depth is far from its own are left out, so reflections
+  // stop at silhouettes. rgb is premultiplied by a, the share of rays that hit anything on screen
+  layout(set = 0, binding = 5) uniform sampler2D reflections[2];
+  layout(set = 0, binding = 6) uniform sampler2D reflectionDepth;
+
+  vec4 wetReflection(vec3 position) {
+      // A perspective clip w is the view distance the traced depths are compared in
+      vec4 clip = camera.reflectionViewProj * vec4(position, 1.0);
+      if (clip.w <= 0.0)
+          return vec4(0.0);
+      vec2 uv = clip.xy / clip.w * 0.5 + 0.5;
+      if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))))
+          return vec4(0.0);
+
+      vec2 texel = uv * camera.reflectionRegion.xy - 0.5;
+      ivec2 base = ivec2(floor(texel));
+      vec2 blend = texel - vec2(base);
+      ivec2 last = ivec2(camera.reflectionRegion.xy) - 1;
+      bool first = camera.reflectionParams.y < 0.5;
+
+      vec4 sum = vec4(0.0);
+      float total = 0.0;
+      for (int i = 0; i < 4; i++) {
+          ivec2 corner = ivec2(i & 1, i >> 1);
+          ivec2 tap = clamp(base + corner, ivec2(0), last);
+          float depth = texelFetch(reflectionDepth, tap, 0).r;
+          float tapDistance = camera.reflectionParams.w / (depth + camera.reflectionParams.z);
+          vec2 bilinear = mix(1.0 - blend, blend, vec2(corner));
+          float weight = bilinear.x * bilinear.y * clamp(1.0 - abs(tapDistance - clip.w) / (0.05 * clip.w), 0.0, 1.0);
+          sum += weight * (first ? texelFetch(reflections[0], tap, 0) : texelFetch(reflections[1], tap, 0));
+          total += weight;
+      }
+      return total < 1e-3 ? vec4(0.0) : sum / total;
+  }
+
+  // Blend the reflections in by a Schlick fresnel (f0 of water), scaled by how wet the road is. Rays that
+  // found nothing on screen reflect the overcast sky
+  vec3 applyWetReflection(vec3 color, vec3 position, vec3 normal, vec3 eyeDir) {
+      float wetness = camera.reflectionParams.x;
+      if (wetness <= 0.0)
+          return color;
+      vec4 reflection = wetReflection(position);
+      float fresnel = 0.02 + 0.98 * pow(1.0 - max(dot(normal, eyeDir), 0.0), 5.0);
+      vec3 sky = vec3(0.45, 0.5, 0.55);
+      return mix(color, reflection.rgb + (1.0 - reflection.a) * sky, wetness * fresnel);
+  }
 
   void main() {
-      // Simple lighting based on normal
-      vec3 lightDir = normalize(vec3(0.5, 1.0, 0.3));
-      float diff = max(dot(fragNormal, lightDir), 0.0);
+      // Simple lighting based on normal, from the sun the shadows are cast by
+      vec3 normal = normalize(fragNormal);
+      float diff = max(dot(normal, camera.sunDirection.xyz), 0.0) * sunVisibility(normal);
       vec3 roadColor = vec3(0.3, 0.3, 0.3);  // Dark grey road
       vec3 color = roadColor * (0.3 + 0.7 * diff);  // Ambient + diffuse
+      // Wet asphalt: local lights leave bright streaks on it
+      vec3 eyeDir = normalize(camera.cameraPosition.xyz - fragPosition);
+      color += localLighting(fragPosition, normal, eyeDir, roadColor, 0.8);
+      color = applyWetReflection(color, fragPosition, normal, eyeDir);
       outColor = vec4(color, 1.0);
+      outMotion = motionVector();
   }
@@ -1,20 +1,62 @@
 #version 450
 
+  // The whole CameraUBO (DownPour.h): the motion vectors' views follow the shadows and reflections
   layout(set = 0, binding = 0) uniform CameraUBO {
       mat4 view;
       mat4 projection;
       mat4 viewProjection;
+      mat4 cascadeViewProj[3];
+      vec4 cascadeRadii;
+      vec4 cascadeTexels;
+      vec4 sunDirection;
+      vec4 cameraPosition;
+      mat4 reflectionViewProj;
+      vec4 reflectionRegion;
+      vec4 reflectionParams;
+      mat4 motionViewProj;    // MotionUBO: this frame's view without the upscaler's jitter
+      mat4 previousViewProj;  // Last frame's, likewise
   } camera;
 
+  // Only the dequantization is read; the road is drawn untransformed
+  struct ObjectData {
+      mat4 model;
+      vec4 dequantOffset;  // xyz: position offset, w: 1 = octahedral normals
+      vec4 dequantScale;   // xyz: position scale
+      uint materialIndex;
+      mat4 previousModel;
+  };
+
+  layout(std430, set = 0, binding = 1) readonly buffer ObjectBuffer {
+      ObjectData objects[];
+  } objectBuffer;
+
   layout(location = 0) in vec3 inPosition;
   layout(location = 1) in vec3 inNormal;
   layout(location = 2) in vec2 inTexCoord;
 
   layout(location = 0) out vec3 fragNormal;
   layout(location = 1) out vec2 fragTexCoord;
+  layout(location = 2) out vec3 fragPosition;  // World space, for the sun shadows
+
+  // Motion vectors: the road holds still, so only the camera moves it
+  layout(location = 3) out vec4 fragClipPosition;
+  layout(location = 4) out vec4 fragPreviousClipPosition;
+
+  vec3 decodeOctahedral(vec2 e) {
+      vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+      float t = max(-n.z, 0.0);
+      n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+      return normalize(n);
+  }
 
   void main() {
-      gl_Position = camera.viewProjection * vec4(inPosition, 1.0);
-      fragNormal = inNormal;
+      ObjectData object = objectBuffer.objects[gl_InstanceIndex];
+      vec3 position = object.dequantOffset.xyz + inPosition * object.dequantScale.xyz;
+
+      gl_Position = camera.viewProjection * vec4(position, 1.0);
+      fragNormal = object.dequantOffset.w > 0.5 ? decodeOctahedral(inNormal.xy) : inNormal;
       fragTexCoord = inTexCoord;
-  }
\ No newline at end of file
+      fragPosition = position;
+      fragClipPosition = camera.motionViewProj * vec4(position, 1.0);
+      fragPreviousClipPosition = camera.previousViewProj * vec4(position, 1.0);
+  }
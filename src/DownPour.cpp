@@ -1,19 +1,56 @@
 #include "DownPour.h"
 
+#include "core/AllocationCounter.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
 #include "logger/Logger.h"
 #include "vulkan/VulkanTypes.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 #include <vector>
 
 namespace DownPour {
 
+void Application::setFramesInFlight(uint32_t count) {
+    framesInFlight = std::clamp(count, 1u, FramePacer::MAX_FRAMES_IN_FLIGHT);
+}
+
+void Application::setTargetFrameTime(float ms) {
+    targetFrameMs = std::max(ms, 0.0f);
+}
+
+void Application::setTextureStreaming(bool enabled) {
+    streamTextures = enabled;
+}
+
+void Application::setTelemetry(bool enabled) {
+    telemetryEnabled = enabled;
+}
+
+void Application::recordInput(const std::string& path) {
+    recordPath     = path;
+    replaying      = false;
+    inputRecording = Simulation::InputRecording();
+}
+
+void Application::replayInput(const std::string& path) {
+    inputRecording = Simulation::InputRecording::load(path);
+    replaying      = true;
+    recordPath.clear();
+    DP_LOG(Info, "Replaying %zu steps at %.0f Hz from %s", inputRecording.size(), inputRecording.getRate(),
+           path.c_str());
+}
+
 void Application::run() {
     initWindow();
     initVulkan();
@@ -39,39 +76,119 @@ void Application::initVulkan() {
     // Initialize Vulkan core (instance, device, surface, queues)
     vulkanContext.initialize(window);
 
-    // Find depth format and initialize swap chain
+    // Find depth format and initialize swap chain (or its offscreen stand-in)
     VkFormat depthFormat = ResourceManager::findDepthFormat(vulkanContext.getPhysicalDevice());
-    swapChainManager.initialize(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
-                                vulkanContext.getSurface(), window, depthFormat);
+    if (headless) {
+        swapChainManager.initializeOffscreen(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                                             offscreenExtent, depthFormat, framesInFlight);
+    } else {
+        swapChainManager.initialize(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                                    vulkanContext.getSurface(), window, depthFormat, framesInFlight);
+    }
+    framePacer.init(vulkanContext.getDevice(), framesInFlight, vulkanContext.hasPresentWait());
+    gpuProfiler.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                     vulkanContext.getGraphicsQueueFamily(), framesInFlight,
+                     std::vector<std::string>(GPU_SECTION_NAMES.begin(), GPU_SECTION_NAMES.end()),
+                     GPU_TIMINGS_CSV_PATH);
+    if (telemetryEnabled) {
+        telemetry.open(std::vector<std::string>(TELEMETRY_ZONE_NAMES.begin(), TELEMETRY_ZONE_NAMES.end()),
+                       std::vector<std::string>(GPU_SECTION_NAMES.begin(), GPU_SECTION_NAMES.end()));
+    }
 
-    createDepthResources();
-    swapChainManager.createFramebuffers(vulkanContext.getDevice(), depthImageView);
+    // The depth, OIT and shadow targets are graph transients, created when the graph compiles
+    renderGraph.init(vulkanContext.getDevice(), vulkanContext.getAsyncComputeQueue(),
+                     vulkanContext.getAsyncComputeQueueFamily(), framesInFlight, vulkanContext.hasTimelineSemaphores());
+    setupRenderGraph();
+    oitCompositor.setTargets(renderGraph.getImageView(graphOitAccum), renderGraph.getImageView(graphOitRevealage));
+    dynamicResolution.createTarget(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                                   swapChainManager.getExtent(), swapChainManager.getImageFormat());
+    dynamicResolution.setTargetFrameTime(targetFrameMs);
+    if (vulkanContext.hasMultiview()) {
+        mirrorRenderer.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), MIRROR_LAYER_EXTENT,
+                            MirrorRenderer::MAX_VIEWS, swapChainManager.getImageFormat(), depthFormat);
+    } else {
+        DP_LOG(Info, "Mirrors disabled (needs multiview)");
+    }
+    swapChainManager.createFramebuffer(vulkanContext.getDevice(), dynamicResolution.getColorView(), depthImageView,
+                                       oitCompositor.getAccumView(), oitCompositor.getRevealageView(),
+                                       renderGraph.getImageView(graphMotion));
 
     createDescriptorSetLayout();
-    createGraphicsPipeline();
-    createWorldPipeline();
+    pipelineCache.load(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), PIPELINE_CACHE_PATH);
+    std::vector<PipelineRequest> startupPipelines;
+    createGraphicsPipeline(startupPipelines);
+    createWorldPipeline(startupPipelines);
+    oitCompositor.createPipeline(vulkanContext.getDevice(), swapChainManager.getRenderPass(), pipelineCache.get());
+    if (mirrorRenderer.isEnabled()) {
+        mirrorRenderer.createCompositePipeline(vulkanContext.getDevice(), swapChainManager.getRenderPass(),
+                                               pipelineCache.get());
+    }
     createCommandPool();
 
     // Initialize material manager
-    materialManager = new MaterialManager(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), commandPool,
-                                          vulkanContext.getGraphicsQueue());
+    materialManager = new MaterialManager(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice());
+    if (vulkanContext.hasDescriptorIndexing()) {
+        // All material textures live in one descriptor array, bound once per frame
+        materialManager->initBindless();
+    }
+    if (streamTextures) {
+        materialManager->enableTextureStreaming(TextureStreamingConfig{}, framesInFlight);
+    }
 
-    createUniformBuffers();
+    // The startup pipelines compile on the job system while the assets load, sharing the pipeline cache
+    createCarPipeline(startupPipelines);
+    JobHandle pipelinesReady = JobSystem::get().schedule([this, batch = std::move(startupPipelines)] {
+        PipelineFactory::createPipelines(vulkanContext.getDevice(), batch, pipelineCache.get());
+    });
+
+    createFrameAllocator();
+    createOcclusionCuller();
+    // All before the descriptor sets, which read the froxel lists, sample the shadow map through its
+    // comparison sampler and sample the road's reflections
+    clusteredLights.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), frameAllocator.getBuffer(),
+                         pipelineCache.get());
+    shadowCascades.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                        renderGraph.getImage(graphShadowMap), descriptorSetLayout, pipelineCache.get());
+    wetReflections.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), swapChainManager.getExtent(),
+                        depthSampleable ? depthImageView : VK_NULL_HANDLE, dynamicResolution.getColorView(),
+                        frameAllocator.getBuffer(), pipelineCache.get());
+    temporalUpscaler.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), swapChainManager.getExtent(),
+                          swapChainManager.getImageFormat(), dynamicResolution.getColorView(),
+                          renderGraph.getImageView(graphMotion), pipelineCache.get());
     createDescriptorPool();
     createDescriptorSets();
     createCommandBuffers();
-    loadRoadModel();
+    createPassCommandBuffers();
 
-    // Load and setup car model
-    loadCarModel();
-    createCarPipeline();
-    createCarTransparentPipeline();
+    // Load the road and car models and build the scene
+    loadAssets();
+    JobSystem::get().wait(pipelinesReady);
+    // Scene draws use per-material variants of the car pipeline; build them now so none compile mid-frame
+    materialManager->createPipelineVariants(carModelPtr->getVertexFormat());
     createCarDescriptorSets();
 
+    // GPU rain particles share the camera descriptor set layout, and stop at the surfaces in the occlusion maps.
+    // Each frame slot has its own map and drops, shared with the async compute queue
+    const std::vector<uint32_t> rainQueueFamilies = vulkanContext.getComputeSharingFamilies();
+    rainOcclusion.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), framesInFlight,
+                       rainQueueFamilies, descriptorSetLayout, pipelineCache.get());
+    std::vector<VkImageView> rainMapViews(framesInFlight);
+    for (uint32_t slot = 0; slot < framesInFlight; slot++)
+        rainMapViews[slot] = rainOcclusion.getView(slot);
+    weatherSystem.initGPU(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
+                          swapChainManager.getRenderPass(), descriptorSetLayout, pipelineCache.get(), rainMapViews,
+                          rainOcclusion.getSampler(), rainQueueFamilies);
+
     // Initialize windshield surface
-    windshield.initialize(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), commandPool,
-                          vulkanContext.getGraphicsQueue());
+    windshield.initialize(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), framesInFlight,
+                          pipelineCache.get(),
+                          Simulation::WindshieldSurface::selectResolution(vulkanContext.getPhysicalDevice()),
+                          Simulation::WindshieldDroplets::selectGpuSimulation(vulkanContext.getPhysicalDevice()));
     createWindshieldPipeline();
+    bindRenderGraphResources();
+
+    // Startup assets were queued as one batch; finish it before the first frame samples them
+    UploadManager::get().waitIdle();
 
     createSyncObjects();
 
@@ -88,28 +205,50 @@ void Application::initVulkan() {
     camera.setMode(CameraMode::Cockpit);
     camera.setCockpitOffset(cockpitOffset);
 
-    lastFrameTime = glfwGetTime();
+    // Rear-view mirror above the windshield's center, door mirrors low at either side. Each projects
+    // at its screen rect's aspect, so the layer's own size only sets the mirror's resolution
+    std::vector<MirrorView> mirrors(MirrorRenderer::MAX_VIEWS);
+    mirrors[0].offset     = glm::vec3(0.0f, 0.08f, 0.35f);
+    mirrors[0].screenRect = glm::vec4(0.35f, 0.02f, 0.30f, 0.133f);
+    mirrors[1].offset     = glm::vec3(0.9f, -0.05f, 0.6f);
+    mirrors[1].yaw        = -15.0f;
+    mirrors[1].screenRect = glm::vec4(0.02f, 0.55f, 0.15f, 0.133f);
+    mirrors[2].offset     = glm::vec3(-0.9f, -0.05f, 0.6f);
+    mirrors[2].yaw        = 15.0f;
+    mirrors[2].screenRect = glm::vec4(0.83f, 0.55f, 0.15f, 0.133f);
+    for (MirrorView& mirror : mirrors) {
+        mirror.aspect = aspect * mirror.screenRect.z / mirror.screenRect.w;
+    }
+    camera.setMirrorViews(mirrors);
+
+    lastFrameTime = headless ? 0.0f : static_cast<float>(glfwGetTime());
 }
 
 void Application::cleanup() {
-    // Clean up windshield resources
+    // Clean up weather and windshield resources
+    weatherSystem.cleanupGPU(vulkanContext.getDevice());
+    rainOcclusion.destroy(vulkanContext.getDevice());
+    shadowCascades.destroy(vulkanContext.getDevice());
+    clusteredLights.destroy(vulkanContext.getDevice());
+    wetReflections.destroy(vulkanContext.getDevice());
+    temporalUpscaler.destroy(vulkanContext.getDevice());
     windshield.cleanup(vulkanContext.getDevice());
     safeDestroy(windshieldPipeline, vkDestroyPipeline);
     safeDestroy(windshieldPipelineLayout, vkDestroyPipelineLayout);
     safeDestroy(windshieldDescriptorLayout, vkDestroyDescriptorSetLayout);
 
-    safeDestroy(depthImageView, vkDestroyImageView);
-    safeDestroy(depthImage, vkDestroyImage);
-    if (depthImageMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(vulkanContext.getDevice(), depthImageMemory, nullptr);
-        depthImageMemory = VK_NULL_HANDLE;
-    }
+    occlusionCuller.destroy(vulkanContext.getDevice());
+    oitCompositor.destroy(vulkanContext.getDevice());
+    dynamicResolution.destroy(vulkanContext.getDevice());
+    mirrorRenderer.destroy(vulkanContext.getDevice());
+    renderGraph.destroy();
+    depthImageView = VK_NULL_HANDLE;
 
     // Clean up swap chain resources
     swapChainManager.cleanup(vulkanContext.getDevice());
 
     // Clean up sync objects
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         vkDestroySemaphore(vulkanContext.getDevice(), imageAvailableSemaphores[i], nullptr);
         vkDestroySemaphore(vulkanContext.getDevice(), renderFinishedSemaphores[i], nullptr);
         vkDestroyFence(vulkanContext.getDevice(), inFlightFences[i], nullptr);
@@ -136,51 +275,97 @@ void Application::cleanup() {
         carModelPtr = nullptr;
     }
     safeDestroy(carPipeline, vkDestroyPipeline);
-    safeDestroy(carTransparentPipeline, vkDestroyPipeline);
+    safeDestroy(carPackedPipeline, vkDestroyPipeline);
     safeDestroy(carPipelineLayout, vkDestroyPipelineLayout);
     safeDestroy(carDescriptorSetLayout, vkDestroyDescriptorSetLayout);
     safeDestroy(carDescriptorPool, vkDestroyDescriptorPool);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        vkDestroyBuffer(vulkanContext.getDevice(), uniformBuffers[i], nullptr);
-        vkFreeMemory(vulkanContext.getDevice(), uniformBuffersMemory[i], nullptr);
+    if (frameAllocator.getBuffer() != VK_NULL_HANDLE)
+        DP_LOG(Info, "Frame allocator peak: %llu of %llu bytes per frame",
+               static_cast<unsigned long long>(frameAllocator.getPeakUsage()),
+               static_cast<unsigned long long>(frameAllocator.getFrameCapacity()));
+    frameAllocator.destroy(vulkanContext.getDevice());
+
+    // Destroying a pool frees its secondary buffers
+    for (PassCommands& frame : passCommands) {
+        for (VkCommandPool& pool : frame.pools) {
+            safeDestroy(pool, vkDestroyCommandPool);
+        }
     }
+    passCommands.clear();
 
     safeDestroy(commandPool, vkDestroyCommandPool);
     safeDestroy(graphicsPipeline, vkDestroyPipeline);
     safeDestroy(pipelineLayout, vkDestroyPipelineLayout);
 
     // Clean up road model BEFORE destroying device
+    roadStreamer.cleanup();
     if (roadModelPtr) {
         roadModelPtr->cleanup(vulkanContext.getDevice());
         delete roadModelPtr;
         roadModelPtr = nullptr;
     }
     safeDestroy(worldPipeline, vkDestroyPipeline);
+    safeDestroy(worldPackedPipeline, vkDestroyPipeline);
     safeDestroy(worldPipelineLayout, vkDestroyPipelineLayout);
 
+    // Final CPU trace and GPU timings summary (the CSV already holds every frame)
+    DP_PROFILE_EXPORT(CPU_TRACE_PATH);
+    gpuProfiler.logSummary();
+    gpuProfiler.destroy();
+    telemetry.close();
+
+    // Persist compiled pipelines so the next launch skips shader compilation
+    pipelineCache.save();
+    pipelineCache.destroy();
+
     // VulkanContext handles cleanup of instance, device, surface
     vulkanContext.cleanup();
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    if (window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
 }
 
-void Application::createUniformBuffers() {
-    VkDeviceSize bufferSize = sizeof(CameraUBO);
+void Application::createFrameAllocator() {
+    // Persistently mapped; each frame slot's region is rewritten by the CPU after the slot's fence has signalled
+    frameAllocator.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), framesInFlight,
+                        FRAME_ALLOCATOR_CAPACITY);
+}
 
-    uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    uniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-    uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+void Application::createOcclusionCuller() {
+    // setupRenderGraph() decided whether to cull, as it declares the cull and pyramid passes
+    if (!occlusionCulling)
+        return;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        ResourceManager::createBuffer(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), bufferSize,
-                                      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                      uniformBuffers[i], uniformBuffersMemory[i]);
+    occlusionCuller.init(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(), depthImageView,
+                         swapChainManager.getExtent(), frameAllocator.getBuffer(), MAX_SCENE_OBJECTS,
+                         pipelineCache.get());
+}
 
-        // Persistent mapping
-        vkMapMemory(vulkanContext.getDevice(), uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]);
+void Application::beginFrameAllocations() {
+    frameAllocator.beginFrame(static_cast<uint32_t>(currentFrame));
+
+    // Fixed-size ranges first, so they always fit; features sub-allocate the rest as they record
+    frameCamera   = frameAllocator.allocateUniform(sizeof(CameraUBO));
+    frameObjects  = frameAllocator.allocateStorage(sizeof(ObjectData) * MAX_SCENE_OBJECTS);
+    // Storage-aligned: the occlusion cull shader rewrites the commands through a dynamic storage offset
+    frameCommands   = frameAllocator.allocateStorage(sizeof(VkDrawIndexedIndirectCommand) * MAX_SCENE_OBJECTS);
+    frameCullBounds = frameAllocator.allocateStorage(sizeof(OcclusionBounds) * MAX_SCENE_OBJECTS);
+    // Full CameraUBO size: it is read through the camera binding, whose range is fixed
+    frameMirrorCamera    = frameAllocator.allocateUniform(sizeof(CameraUBO));
+    frameRainCamera      = frameAllocator.allocateUniform(sizeof(CameraUBO));
+    frameLights          = frameAllocator.allocateStorage(ClusteredLights::LIGHT_BUFFER_SIZE);
+    frameReflectionTrace = frameAllocator.allocateUniform(sizeof(ReflectionTraceParams));
+    bool shadowCamerasValid = true;
+    for (FrameAllocation& shadowCamera : frameShadowCameras) {
+        shadowCamera = frameAllocator.allocateUniform(sizeof(CameraUBO));
+        shadowCamerasValid &= shadowCamera.isValid();
     }
+    if (!frameCamera.isValid() || !frameObjects.isValid() || !frameCommands.isValid() || !frameCullBounds.isValid() ||
+        !frameMirrorCamera.isValid() || !frameRainCamera.isValid() || !frameLights.isValid() ||
+        !frameReflectionTrace.isValid() || !shadowCamerasValid)
+        throw std::runtime_error("FRAME_ALLOCATOR_CAPACITY is too small for the per-frame scene data");
 }
 
 void Application::updateUniformBuffer(uint32_t currentImage) {
@@ -188,24 +373,158 @@ void Application::updateUniformBuffer(uint32_t currentImage) {
     ubo.view = camera.getViewMatrix();
     ubo.proj = camera.getProjectionMatrix();
     ubo.proj[1][1] *= -1;  // GLM for OpenGL, flip Y for Vulkan
-    ubo.viewProj = ubo.proj * ubo.view;
+    ubo.viewProj  = ubo.proj * ubo.view;
+    frameViewProj = ubo.viewProj;  // Kept for CPU-side frustum culling
+
+    // proj[1][1] is 1 / tan(fovY / 2); LOD follows the scaled resolution the scene renders at
+    framePixelsPerUnit =
+        0.5f * static_cast<float>(dynamicResolution.getRenderExtent().height) * std::abs(ubo.proj[1][1]);
+
+    // Cascades follow the camera; streamed tiles arriving change the static world without it moving
+    const uint64_t staticVersion = roadStreamer.isActive() ? roadStreamer.getStats().residentTiles : 0;
+    shadowCascadesMoved          = shadowCascades.beginFrame(camera.getPosition(), staticVersion);
+
+    ubo.shadows.sunDirection   = glm::vec4(ShadowCascades::getSunDirection(), 0.0f);
+    ubo.shadows.cameraPosition = glm::vec4(camera.getPosition(), 1.0f);
+    for (uint32_t i = 0; i < ShadowCascades::CASCADE_COUNT; i++) {
+        ubo.shadows.cascadeViewProj[i]            = shadowCascades.getViewProj(i);
+        ubo.shadows.cascadeRadii[i]               = ShadowCascades::CASCADE_RADII[i];
+        ubo.shadows.cascadeTexels[i]              = ShadowCascades::getTexelSize(i);
+        frameExtraViewProj[EXTRA_VIEW_SHADOW + i] = shadowCascades.getViewProj(i);
+
+        // Depth only: car.vert reads viewProj and nothing else
+        CameraUBO shadowUbo{};
+        shadowUbo.viewProj = shadowCascades.getViewProj(i);
+        memcpy(frameShadowCameras[i].data, &shadowUbo, sizeof(shadowUbo));
+    }
+
+    // The road shades with what the last trace left, through the view it was traced from; this frame's
+    // trace runs after the main pass. Dry roads neither trace nor read
+    {
+        std::lock_guard<std::mutex> lock(simulation.worldMutex());
+        frameWetness = weatherSystem.getWetness();
+    }
+    const VkExtent2D traced      = wetReflections.getTracedExtent();
+    const float      readWetness = wetReflections.isReady() ? frameWetness : 0.0f;
+    const float      readIndex   = static_cast<float>(wetReflections.getReadIndex());
+    ubo.reflections.viewProj     = wetReflections.getViewProj();
+    ubo.reflections.region = glm::vec4(static_cast<float>(traced.width), static_cast<float>(traced.height), 0.0f, 0.0f);
+    ubo.reflections.params = glm::vec4(readWetness, readIndex, ubo.proj[2][2], ubo.proj[3][2]);
+    if (frameWetness > 0.0f) {
+        wetReflections.upload(frameReflectionTrace, ubo.view, ubo.proj, camera.getPosition(), frameWetness,
+                              dynamicResolution.getRenderExtent());
+    }
 
-    memcpy(uniformBuffersMapped[currentImage], &ubo, sizeof(ubo));
+    // Motion is measured between unjittered views, so the jitter itself never reads as movement
+    if (!previousViewProjValid) {
+        previousViewProj      = ubo.viewProj;
+        previousViewProjValid = true;
+    }
+    ubo.motion.viewProj         = ubo.viewProj;
+    ubo.motion.previousViewProj = previousViewProj;
+    previousViewProj            = ubo.viewProj;
+
+    // Only the scene draws see the jitter; culling, reflections and the lights use the unjittered view
+    const glm::mat4 proj = ubo.proj;
+    ubo.proj             = temporalUpscaler.jitterProjection(ubo.proj, dynamicResolution.getRenderExtent());
+    ubo.viewProj         = ubo.proj * ubo.view;
+    memcpy(frameCamera.data, &ubo, sizeof(ubo));
+
+    if (mirrorsThisFrame) {
+        MirrorUBO mirrorUbo{};
+        for (uint32_t i = 0; i < mirrorRenderer.getViewCount(); i++) {
+            glm::mat4 proj = camera.getMirrorProjectionMatrix(i);
+            proj[1][1] *= -1;
+            frameExtraViewProj[EXTRA_VIEW_MIRROR + i] = proj * camera.getMirrorViewMatrix(i);
+            mirrorUbo.viewProj[i]                     = frameExtraViewProj[EXTRA_VIEW_MIRROR + i];
+        }
+        mirrorUbo.shadows = ubo.shadows;  // Mirrored surfaces shade with the same sun
+        memcpy(frameMirrorCamera.data, &mirrorUbo, sizeof(mirrorUbo));
+    }
+
+    updateLocalLights(ubo.view, proj);
 }
 
-void Application::createGraphicsPipeline() {
+void Application::updateLocalLights(const glm::mat4& view, const glm::mat4& proj) {
+    clusteredLights.clear();
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+    // The player's lamps sit at the model's tagged light groups, split across the car's width; without
+    // the tags, at the car's nose and tail
+    if (playerCar && carAdapter && playerCar->areLightsOn()) {
+        const ModelAdapter::LightsConfig& config = carAdapter->getLightsConfig();
+
+        const glm::vec3 forward  = vehicle.forward();
+        const glm::vec3 side     = glm::normalize(glm::cross(forward, up));
+        const glm::vec3 body     = vehicle.position - up * carBottomOffset;
+        const float     halfBody = 0.5f * playerCar->getLength();
+        const float     spread   = 0.35f * playerCar->getTrackWidth();
+
+        auto lampCenter = [&](NodeHandle node, float along) {
+            if (node.isValid())
+                return glm::vec3(playerCar->getScene()->getWorldTransform(node)[3]);
+            return body + forward * along + up * 0.7f;
+        };
+
+        // Aimed a little down the road, as dipped beams are
+        const glm::vec3 beam      = glm::normalize(forward - up * 0.05f);
+        const glm::vec3 headlight = lampCenter(playerCar->getHeadlightsNode(), halfBody);
+        const glm::vec3 taillight = lampCenter(playerCar->getTaillightsNode(), -halfBody);
+        for (float offset : {-spread, spread}) {
+            clusteredLights.addSpotLight(headlight + side * offset, beam,
+                                         config.headlights.color * config.headlights.intensity,
+                                         config.headlights.range, config.headlights.spotAngle);
+            clusteredLights.addPointLight(taillight + side * offset,
+                                          config.taillights.color * config.taillights.intensity,
+                                          config.taillights.range);
+        }
+    }
+
+    // Street lamps along the road's long axis, alternating sides, nearest the camera first, as far
+    // as the light grid reaches
+    if (roadModelPtr) {
+        const glm::vec3 roadMin = roadModelPtr->getMinBounds();
+        const glm::vec3 roadMax = roadModelPtr->getMaxBounds();
+        const int       along   = (roadMax.x - roadMin.x) >= (roadMax.z - roadMin.z) ? 0 : 2;
+        const int       across  = 2 - along;
+        const float     center  = 0.5f * (roadMin[across] + roadMax[across]);
+        const float     edge    = std::max(0.5f * (roadMax[across] - roadMin[across]) - STREET_LAMP_INSET, 0.0f);
+        const float     ground  = vehicle.position.y - carBottomOffset;
+        const glm::vec3 sodium(1.5f, 1.1f, 0.65f);
+
+        const int nearest = static_cast<int>(std::lround(camera.getPosition()[along] / STREET_LAMP_SPACING));
+        const int reach   = static_cast<int>(ClusteredLights::GRID_FAR / STREET_LAMP_SPACING);
+        for (int step = 0; step <= 2 * reach; step++) {
+            // nearest, +1, -1, +2, -2, ...
+            const int   index = nearest + ((step & 1) != 0 ? (step + 1) / 2 : -(step / 2));
+            const float coord = static_cast<float>(index) * STREET_LAMP_SPACING;
+            if (coord < roadMin[along] || coord > roadMax[along])
+                continue;
+
+            glm::vec3 lamp(0.0f, ground + STREET_LAMP_HEIGHT, 0.0f);
+            lamp[along]  = coord;
+            lamp[across] = center + ((index & 1) != 0 ? edge : -edge);
+            if (!clusteredLights.addSpotLight(lamp, -up, sodium, STREET_LAMP_RANGE, 60.0f))
+                break;
+        }
+    }
+
+    clusteredLights.upload(frameLights, view, proj);
+}
+
+void Application::createGraphicsPipeline(std::vector<PipelineRequest>& batch) {
     // Create pipeline layout
     pipelineLayout = PipelineFactory::createPipelineLayout(vulkanContext.getDevice(), {descriptorSetLayout});
 
-    // Create pipeline
+    // Queue pipeline
     PipelineConfig config;
-    config.vertShader = "basic.vert.spv";
-    config.fragShader = "basic.frag.spv";
-    config.layout     = pipelineLayout;
-    config.cullMode   = VK_CULL_MODE_NONE;
+    config.vertShader   = "basic.vert.spv";
+    config.fragShader   = "basic.frag.spv";
+    config.layout       = pipelineLayout;
+    config.cullMode     = VK_CULL_MODE_NONE;
+    config.motionTarget = true;
 
-    graphicsPipeline = PipelineFactory::createPipeline(vulkanContext.getDevice(), config,
-                                                       swapChainManager.getRenderPass(), swapChainManager.getExtent());
+    batch.push_back({config, swapChainManager.getRenderPass(), &graphicsPipeline});
 }
 
 Vulkan::QueueFamilyIndices Application::findQueueFamilies(VkPhysicalDevice device) {
@@ -225,7 +544,7 @@ void Application::createCommandPool() {
 }
 
 void Application::createCommandBuffers() {
-    commandBuffers.resize(swapChainManager.getFramebuffers().size());
+    commandBuffers.resize(swapChainManager.getImages().size());
 
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -237,16 +556,42 @@ void Application::createCommandBuffers() {
         throw std::runtime_error("Failed to allocate command buffers!");
 }
 
+void Application::createPassCommandBuffers() {
+    auto indices = vulkanContext.findQueueFamilies(vulkanContext.getPhysicalDevice());
+
+    passCommands.resize(framesInFlight);
+    for (PassCommands& frame : passCommands) {
+        for (uint32_t pass = 0; pass < PASS_COUNT; pass++) {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = indices.graphicsFamily.value();
+            poolInfo.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;  // Reset wholesale every frame
+
+            if (vkCreateCommandPool(vulkanContext.getDevice(), &poolInfo, nullptr, &frame.pools[pass]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create pass command pool!");
+
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool        = frame.pools[pass];
+            allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(vulkanContext.getDevice(), &allocInfo, &frame.buffers[pass]) != VK_SUCCESS)
+                throw std::runtime_error("Failed to allocate secondary command buffer!");
+        }
+    }
+}
+
 void Application::createSyncObjects() {
-    imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    imageAvailableSemaphores.resize(framesInFlight);
+    renderFinishedSemaphores.resize(framesInFlight);
+    inFlightFences.resize(framesInFlight);
 
     VkSemaphoreCreateInfo semInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
     VkFenceCreateInfo     fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         if (vkCreateSemaphore(vulkanContext.getDevice(), &semInfo, nullptr, &imageAvailableSemaphores[i]) !=
                 VK_SUCCESS ||
             vkCreateSemaphore(vulkanContext.getDevice(), &semInfo, nullptr, &renderFinishedSemaphores[i]) !=
@@ -258,64 +603,201 @@ void Application::createSyncObjects() {
 }
 
 void Application::createDescriptorPool() {
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSize.descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    std::array<VkDescriptorPoolSize, 4> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 2;
+    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[2].descriptorCount = 4;  // Shadow map, both reflection images, reflection depth
+    poolSizes[3].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[3].descriptorCount = 1;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes    = &poolSize;
-    poolInfo.maxSets       = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = 1;
     if (vkCreateDescriptorPool(vulkanContext.getDevice(), &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
         throw std::runtime_error("Failed to create descriptor pool");
 }
 
 void Application::createDescriptorSets() {
-    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
-
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool     = descriptorPool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-    allocInfo.pSetLayouts        = layouts.data();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &descriptorSetLayout;
 
-    descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-    if (vkAllocateDescriptorSets(vulkanContext.getDevice(), &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+    if (vkAllocateDescriptorSets(vulkanContext.getDevice(), &allocInfo, &frameDescriptorSet) != VK_SUCCESS)
         throw std::runtime_error("Failed to allocate descriptor sets!");
 
-    // Bind each descriptor set to its uniform buffer
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = uniformBuffers[i];
-        bufferInfo.offset = 0;
-        bufferInfo.range  = sizeof(CameraUBO);
-
-        VkWriteDescriptorSet descriptorWrite{};
-        descriptorWrite.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet          = descriptorSets[i];
-        descriptorWrite.dstBinding      = 0;
-        descriptorWrite.dstArrayElement = 0;
-        descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrite.descriptorCount = 1;
-        descriptorWrite.pBufferInfo     = &bufferInfo;
-
-        vkUpdateDescriptorSets(vulkanContext.getDevice(), 1, &descriptorWrite, 0, nullptr);
+    // One set for every frame: the dynamic buffer bindings cover the frame allocator's buffer, and each bind
+    // selects the frame's camera UBO, object SSBO and lights through dynamic offsets
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = frameAllocator.getBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range  = sizeof(CameraUBO);
+
+    VkDescriptorBufferInfo objectInfo{};
+    objectInfo.buffer = frameAllocator.getBuffer();
+    objectInfo.offset = 0;
+    objectInfo.range  = sizeof(ObjectData) * MAX_SCENE_OBJECTS;
+
+    // The graph's shadow map view is stable; its memory is only aliased outside the passes that sample it
+    VkDescriptorImageInfo shadowInfo{};
+    shadowInfo.sampler     = shadowCascades.getSampler();
+    shadowInfo.imageView   = renderGraph.getImageView(graphShadowMap);
+    shadowInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorBufferInfo lightInfo{};
+    lightInfo.buffer = frameAllocator.getBuffer();
+    lightInfo.offset = 0;
+    lightInfo.range  = ClusteredLights::LIGHT_BUFFER_SIZE;
+
+    // Rewritten by the light cull pass every frame, before any pass that shades with it
+    VkDescriptorBufferInfo clusterInfo{};
+    clusterInfo.buffer = clusteredLights.getClusterBuffer();
+    clusterInfo.offset = 0;
+    clusterInfo.range  = ClusteredLights::CLUSTER_BUFFER_SIZE;
+
+    // Both reflection images, indexed by the camera UBO's reflection params; the graph leaves them and the
+    // pyramid sampleable for the main pass
+    std::array<VkDescriptorImageInfo, 2> reflectionInfos{};
+    for (uint32_t i = 0; i < reflectionInfos.size(); i++) {
+        reflectionInfos[i].sampler     = wetReflections.getSampler();
+        reflectionInfos[i].imageView   = wetReflections.getColorView(i);
+        reflectionInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     }
+
+    VkDescriptorImageInfo reflectionDepthInfo{};
+    reflectionDepthInfo.sampler     = wetReflections.getDepthSampler();
+    reflectionDepthInfo.imageView   = wetReflections.getDepthView();
+    reflectionDepthInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    std::array<VkWriteDescriptorSet, 7> descriptorWrites{};
+    descriptorWrites[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[0].dstSet          = frameDescriptorSet;
+    descriptorWrites[0].dstBinding      = 0;
+    descriptorWrites[0].dstArrayElement = 0;
+    descriptorWrites[0].descriptorType  = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorWrites[0].descriptorCount = 1;
+    descriptorWrites[0].pBufferInfo     = &bufferInfo;
+
+    descriptorWrites[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[1].dstSet          = frameDescriptorSet;
+    descriptorWrites[1].dstBinding      = 1;
+    descriptorWrites[1].dstArrayElement = 0;
+    descriptorWrites[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptorWrites[1].descriptorCount = 1;
+    descriptorWrites[1].pBufferInfo     = &objectInfo;
+
+    descriptorWrites[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[2].dstSet          = frameDescriptorSet;
+    descriptorWrites[2].dstBinding      = 2;
+    descriptorWrites[2].dstArrayElement = 0;
+    descriptorWrites[2].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrites[2].descriptorCount = 1;
+    descriptorWrites[2].pImageInfo      = &shadowInfo;
+
+    descriptorWrites[3].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[3].dstSet          = frameDescriptorSet;
+    descriptorWrites[3].dstBinding      = 3;
+    descriptorWrites[3].dstArrayElement = 0;
+    descriptorWrites[3].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptorWrites[3].descriptorCount = 1;
+    descriptorWrites[3].pBufferInfo     = &lightInfo;
+
+    descriptorWrites[4].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[4].dstSet          = frameDescriptorSet;
+    descriptorWrites[4].dstBinding      = 4;
+    descriptorWrites[4].dstArrayElement = 0;
+    descriptorWrites[4].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrites[4].descriptorCount = 1;
+    descriptorWrites[4].pBufferInfo     = &clusterInfo;
+
+    descriptorWrites[5].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[5].dstSet          = frameDescriptorSet;
+    descriptorWrites[5].dstBinding      = 5;
+    descriptorWrites[5].dstArrayElement = 0;
+    descriptorWrites[5].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrites[5].descriptorCount = static_cast<uint32_t>(reflectionInfos.size());
+    descriptorWrites[5].pImageInfo      = reflectionInfos.data();
+
+    descriptorWrites[6].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrites[6].dstSet          = frameDescriptorSet;
+    descriptorWrites[6].dstBinding      = 6;
+    descriptorWrites[6].dstArrayElement = 0;
+    descriptorWrites[6].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrites[6].descriptorCount = 1;
+    descriptorWrites[6].pImageInfo      = &reflectionDepthInfo;
+
+    vkUpdateDescriptorSets(vulkanContext.getDevice(), static_cast<uint32_t>(descriptorWrites.size()),
+                           descriptorWrites.data(), 0, nullptr);
 }
 
 void Application::createDescriptorSetLayout() {
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding            = 0;
-    uboLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount    = 1;
-    uboLayoutBinding.stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
+    uboLayoutBinding.stageFlags         = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;  // Sun shadows
     uboLayoutBinding.pImmutableSamplers = nullptr;
 
+    // Scene object data (model matrix + material index), indexed by gl_InstanceIndex
+    VkDescriptorSetLayoutBinding objectLayoutBinding{};
+    objectLayoutBinding.binding            = 1;
+    objectLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    objectLayoutBinding.descriptorCount    = 1;
+    objectLayoutBinding.stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
+    objectLayoutBinding.pImmutableSamplers = nullptr;
+
+    // Shadow cascades, through their depth comparison sampler
+    VkDescriptorSetLayoutBinding shadowLayoutBinding{};
+    shadowLayoutBinding.binding            = 2;
+    shadowLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    shadowLayoutBinding.descriptorCount    = 1;
+    shadowLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shadowLayoutBinding.pImmutableSamplers = nullptr;
+
+    // Local lights (grid header + lights, at the frame's dynamic offset) and each froxel's list of them
+    VkDescriptorSetLayoutBinding lightLayoutBinding{};
+    lightLayoutBinding.binding            = 3;
+    lightLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    lightLayoutBinding.descriptorCount    = 1;
+    lightLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+    lightLayoutBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding clusterLayoutBinding{};
+    clusterLayoutBinding.binding            = 4;
+    clusterLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    clusterLayoutBinding.descriptorCount    = 1;
+    clusterLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+    clusterLayoutBinding.pImmutableSamplers = nullptr;
+
+    // The wet road's two reflection images, then the depth they were traced against, for the upsample
+    VkDescriptorSetLayoutBinding reflectionLayoutBinding{};
+    reflectionLayoutBinding.binding            = 5;
+    reflectionLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    reflectionLayoutBinding.descriptorCount    = 2;
+    reflectionLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+    reflectionLayoutBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutBinding reflectionDepthLayoutBinding{};
+    reflectionDepthLayoutBinding.binding            = 6;
+    reflectionDepthLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    reflectionDepthLayoutBinding.descriptorCount    = 1;
+    reflectionDepthLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+    reflectionDepthLayoutBinding.pImmutableSamplers = nullptr;
+
+    std::array<VkDescriptorSetLayoutBinding, 7> bindings = {
+        uboLayoutBinding,     objectLayoutBinding,     shadowLayoutBinding,         lightLayoutBinding,
+        clusterLayoutBinding, reflectionLayoutBinding, reflectionDepthLayoutBinding};
+
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 1;
-    layoutInfo.pBindings    = &uboLayoutBinding;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
 
     if (vkCreateDescriptorSetLayout(vulkanContext.getDevice(), &layoutInfo, nullptr, &descriptorSetLayout) !=
         VK_SUCCESS)
@@ -323,37 +805,191 @@ void Application::createDescriptorSetLayout() {
 }
 
 void Application::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex, uint32_t frameIndex) {
+    DP_PROFILE_SCOPE("Application::recordCommandBuffer");
+
+    // Culling and batching touch the scene graph, so they stay on this thread
+    prepareSceneDraws();
+
+    // The weather decides which simulation passes run; particle counts for telemetry are read while it is locked
+    bool raining = false;
+    {
+        std::lock_guard<std::mutex> lock(simulation.worldMutex());
+        raining                     = weatherSystem.isRaining();
+        telemetryFrame.rainDrops    = weatherSystem.getRenderedDropCount();
+        telemetryFrame.cpuRaindrops = static_cast<uint32_t>(weatherSystem.getActiveDrops().size());
+    }
+
+    // Place this frame's rain map before the rain draw, recorded below, hides drops against it. Streamed tiles
+    // arriving change the static world without the camera moving
+    rainOcclusionStatic = false;
+    if (raining) {
+        const uint64_t staticVersion = roadStreamer.isActive() ? roadStreamer.getStats().residentTiles : 0;
+        rainOcclusionStatic          = rainOcclusion.beginFrame(frameIndex, camera.getPosition(), staticVersion);
+    }
+
+    // Record each pass into its own secondary buffer. The frame's fence has signalled,
+    // so its per-pass pools can be reset. Each worker only touches its own pool.
+    PassCommands& frame = passCommands[frameIndex];
+    for (VkCommandPool pool : frame.pools) {
+        vkResetCommandPool(vulkanContext.getDevice(), pool, 0);
+    }
+
+    // Every pass buffer is begun here, in the subpass it executes in, so a recorder may
+    // fill more than one of them (the scene splits its opaque and transparent draws)
+    VkCommandBufferInheritanceInfo inheritance{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inheritance.renderPass  = swapChainManager.getRenderPass();
+    inheritance.framebuffer = swapChainManager.getFramebuffer();
+
+    // Every pass draws into the top-left region the dynamic resolution picked for this frame
+    VkExtent2D extent = dynamicResolution.getRenderExtent();
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+    VkRect2D   scissor{{0, 0}, extent};
+
+    for (uint32_t pass = 0; pass < PASS_COUNT; pass++) {
+        inheritance.subpass = pass < FIRST_TRANSPARENT_PASS ? SwapChainManager::SUBPASS_OPAQUE
+                                                            : SwapChainManager::SUBPASS_TRANSPARENT;
+        passStats[pass]     = PassStats{};
+
+        VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        beginInfo.flags =
+            VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+        vkBeginCommandBuffer(frame.buffers[pass], &beginInfo);
+
+        // Dynamic state is not inherited by secondary command buffers
+        vkCmdSetViewport(frame.buffers[pass], 0, 1, &viewport);
+        vkCmdSetScissor(frame.buffers[pass], 0, 1, &scissor);
+    }
+
+    // Opaque subpass: Skybox → Road → Scene (opaque). Transparent subpass, in any order: Scene
+    // (transparent) and Rain. Passes record on the job workers (the scene, the heaviest, on this
+    // thread) rather than on threads started every frame; parallelFor rethrows any recording failure
+    struct PassRecorder {
+        uint32_t pass;
+        void (Application::*record)(VkCommandBuffer, uint32_t);
+    };
+    static const std::array<PassRecorder, 4> recorders = {{
+        {PASS_SCENE, &Application::recordSceneBatches},
+        {PASS_ROAD, &Application::recordRoadPass},
+        {PASS_SKYBOX, &Application::recordSkyboxPass},
+        {PASS_RAIN, &Application::recordRainPass},
+    }};
+    JobSystem::get().parallelFor(static_cast<uint32_t>(recorders.size()), 1, [&](uint32_t i) {
+        DP_PROFILE_SCOPE("Application::recordPass");
+        (this->*recorders[i].record)(frame.buffers[recorders[i].pass], frameIndex);
+    });
+
+    for (VkCommandBuffer secondary : frame.buffers) {
+        if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record secondary command buffer");
+    }
+
     VkCommandBufferBeginInfo begin{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     vkBeginCommandBuffer(cmd, &begin);
 
-    std::array<VkClearValue, 2> clearValues{};
+    // Read back this slot's timings from its last use and reset its queries
+    gpuProfiler.beginFrame(cmd, frameIndex);
+
+    // Take ownership of anything the transfer queue finished since the last frame
+    UploadManager::get().recordAcquireBarriers(cmd);
+
+    primaryStats = PassStats{};
+
+    // A newly acquired image's contents are discarded by the upscale anyway
+    renderGraph.setImage(graphBackbuffer, swapChainManager.getImages()[imageIndex], true);
+    renderGraph.setBuffer(graphDrawCommands, frameCommands.buffer, frameCommands.offset, frameCommands.size);
+    renderGraph.setPassEnabled(rainComputePass, raining);
+    renderGraph.setPassEnabled(rainOcclusionPass, raining);
+    renderGraph.setPassEnabled(mirrorPass, mirrorsThisFrame);
+    if (depthSampleable)
+        renderGraph.setPassEnabled(reflectionPass, frameWetness > 0.0f);
+    if (frameWetness <= 0.0f)
+        wetReflections.invalidate();  // The next shower starts from a fresh history
+    renderGraph.execute(cmd, frameIndex);
+
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
+        throw std::runtime_error("Failed to record command buffer");
+}
+
+void Application::recordMainPass(VkCommandBuffer cmd, uint32_t frameIndex) {
+    const PassCommands& frame  = passCommands[frameIndex];
+    const VkExtent2D    extent = dynamicResolution.getRenderExtent();
+
+    // OIT targets start with nothing accumulated and everything revealed, motion with nothing moved
+    std::array<VkClearValue, SwapChainManager::ATTACHMENT_COUNT> clearValues{};
     clearValues[0].color        = {{0.05f, 0.05f, 0.07f, 1.0f}};
     clearValues[1].depthStencil = {1.0f, 0};
+    clearValues[2].color        = {{0.0f, 0.0f, 0.0f, 0.0f}};
+    clearValues[3].color        = {{1.0f, 0.0f, 0.0f, 0.0f}};
+    clearValues[4].color        = {{0.0f, 0.0f, 0.0f, 0.0f}};
 
     VkRenderPassBeginInfo rp{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
     rp.renderPass        = swapChainManager.getRenderPass();
-    rp.framebuffer       = swapChainManager.getFramebuffers()[imageIndex];
+    rp.framebuffer       = swapChainManager.getFramebuffer();
     rp.renderArea.offset = {0, 0};
-    rp.renderArea.extent = swapChainManager.getExtent();
-    rp.clearValueCount   = 2;
+    rp.renderArea.extent = extent;
+    rp.clearValueCount   = static_cast<uint32_t>(clearValues.size());
     rp.pClearValues      = clearValues.data();
 
-    vkCmdBeginRenderPass(cmd, &rp, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(cmd, &rp, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cmd, FIRST_TRANSPARENT_PASS, frame.buffers.data());
+
+    vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cmd, PASS_COUNT - FIRST_TRANSPARENT_PASS, frame.buffers.data() + FIRST_TRANSPARENT_PASS);
+
+    // One fullscreen draw, so recorded inline
+    vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+    gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_OIT);
+    oitCompositor.recordComposite(cmd, extent);
+    gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_OIT);
+    if (camera.getMode() == CameraMode::Cockpit && mirrorRenderer.isEnabled()) {
+        std::array<glm::vec4, MirrorRenderer::MAX_VIEWS> rects{};
+        for (uint32_t i = 0; i < mirrorRenderer.getViewCount(); i++) {
+            rects[i] = camera.getMirrorViews()[i].screenRect;
+        }
+        mirrorRenderer.recordComposite(cmd, extent, rects.data());
+    }
+    vkCmdEndRenderPass(cmd);
+}
 
-    // 1. Draw skybox
+void Application::recordSkyboxPass(VkCommandBuffer cmd, uint32_t frameIndex) {
+    gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_SKYBOX);
+    const std::array<uint32_t, 3> offsets = frameDynamicOffsets();
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[frameIndex], 0,
-                            nullptr);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &frameDescriptorSet,
+                            static_cast<uint32_t>(offsets.size()), offsets.data());
     vkCmdDraw(cmd, 36, 1, 0, 0);
+    passStats[PASS_SKYBOX] = {1, 12};
+    gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_SKYBOX);
+}
+
+void Application::recordRainPass(VkCommandBuffer cmd, uint32_t frameIndex) {
+    std::lock_guard<std::mutex> lock(simulation.worldMutex());
+    gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_RAIN);
+    const std::array<uint32_t, 3> offsets = frameDynamicOffsets();
+    weatherSystem.render(cmd, frameIndex, frameDescriptorSet, static_cast<uint32_t>(offsets.size()), offsets.data(),
+                         rainOcclusion.getArea(frameIndex), RainOcclusionMap::DEPTH_RANGE);
+    if (uint32_t drops = weatherSystem.getRenderedDropCount())
+        passStats[PASS_RAIN] = {1, drops * 2ull};  // One instanced draw, a two-triangle streak per drop
+    gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_RAIN);
+}
 
-    // ========================================================================
-    // 2. Draw Road (glTF Model with PBR Materials)
-    // ========================================================================
+void Application::recordRoadPass(VkCommandBuffer cmd, uint32_t frameIndex) {
     // The road model (~50km long) is rendered with asphalt textures using
     // the same PBR pipeline as the car. This ensures consistent material
     // rendering and lighting across the scene.
-    // Rendering Order: Skybox → Road (opaque) → Car (opaque) → Car (transparent)
-    if (roadModelPtr->getIndexCount() > 0) {
+    gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_ROAD);
+
+    if (roadStreamer.isActive()) {
+        recordStreamedRoad(cmd, frameIndex);
+        gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_ROAD);
+        return;
+    }
+
+    glm::vec3 roadMin, roadMax;
+    transformAABB(roadModelPtr->getModelMatrix(), roadModelPtr->getMinBounds(), roadModelPtr->getMaxBounds(), roadMin,
+                  roadMax);
+    if (roadModelPtr->getIndexCount() > 0 && Frustum(frameViewProj).intersectsAABB(roadMin, roadMax)) {
         const auto&  roadMaterials       = roadModelPtr->getMaterials();
         VkBuffer     roadVertexBuffers[] = {roadModelPtr->getVertexBuffer()};
         VkDeviceSize roadOffsets[]       = {0};
@@ -361,15 +997,15 @@ void Application::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex,
         if (!roadMaterials.empty()) {
             // Road has PBR materials - use car pipeline (car.vert/frag shaders)
             // Materials include: base color (asphalt_01_diff_2k.jpg), roughness map
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipeline);
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, selectCarPipeline(*roadModelPtr));
 
-            // Push road model matrix (identity at ground level Y=0)
-            glm::mat4 roadMatrix = roadModelPtr->getModelMatrix();
-            vkCmdPushConstants(cmd, carPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &roadMatrix);
+            // Road model matrix (identity at ground level Y=0) lives in the reserved object slots
+            auto* objects  = frameObjects.as<ObjectData>();
+            bool  bindless = materialManager->isBindless();
 
             // Bind road geometry buffers
             vkCmdBindVertexBuffers(cmd, 0, 1, roadVertexBuffers, roadOffsets);
-            vkCmdBindIndexBuffer(cmd, roadModelPtr->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(cmd, roadModelPtr->getIndexBuffer(), 0, roadModelPtr->getIndexType());
 
             // Render each material primitive (typically 1 material for roads)
             for (size_t i = 0; i < roadMaterials.size(); i++) {
@@ -379,150 +1015,779 @@ void Application::recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex,
                 uint32_t        gpuId         = roadMaterialIds[i];
                 VkDescriptorSet matDescriptor = materialManager->getDescriptorSet(gpuId, frameIndex);
 
-                // Bind descriptor sets: [0] = Camera UBO, [1] = Material textures
-                std::vector<VkDescriptorSet> sets = {descriptorSets[frameIndex], matDescriptor};
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
-                                        static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+                uint32_t slot = ROAD_OBJECT_INDEX + static_cast<uint32_t>(i);
+                writeObject(objects[slot], roadModelPtr->getModelMatrix(), gpuId, *roadModelPtr);
+
+                // Bind descriptor sets: [0] = Camera UBO, [1] = Material textures (shared set when bindless)
+                if (!bindless || i == 0) {
+                    std::array<VkDescriptorSet, 2> sets    = {frameDescriptorSet, matDescriptor};
+                    std::array<uint32_t, 3>        offsets = frameDynamicOffsets();
+                    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
+                                            static_cast<uint32_t>(sets.size()), sets.data(),
+                                            static_cast<uint32_t>(offsets.size()), offsets.data());
+                }
 
                 // Draw this material's index range
-                vkCmdDrawIndexed(cmd, material.indexCount, 1, material.indexStart, 0, 0);
+                vkCmdDrawIndexed(cmd, material.indexCount, 1, material.indexStart, material.vertexOffset, slot);
+                passStats[PASS_ROAD].drawCalls++;
+                passStats[PASS_ROAD].triangles += material.indexCount / 3;
             }
         } else {
             // Fallback: Road has no materials - use simple world pipeline (untextured)
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, worldPipeline);
+            const bool packed = roadModelPtr->getVertexFormat() == VertexFormat::Packed;
+            const std::array<uint32_t, 3> offsets = frameDynamicOffsets();
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, packed ? worldPackedPipeline : worldPipeline);
             vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, worldPipelineLayout, 0, 1,
-                                    &descriptorSets[frameIndex], 0, nullptr);
+                                    &frameDescriptorSet, static_cast<uint32_t>(offsets.size()), offsets.data());
+
+            // world.vert only reads the slot's dequantization
+            auto* objects = frameObjects.as<ObjectData>();
+            writeObject(objects[ROAD_OBJECT_INDEX], roadModelPtr->getModelMatrix(), 0, *roadModelPtr);
+
             vkCmdBindVertexBuffers(cmd, 0, 1, roadVertexBuffers, roadOffsets);
-            vkCmdBindIndexBuffer(cmd, roadModelPtr->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
-            vkCmdDrawIndexed(cmd, roadModelPtr->getIndexCount(), 1, 0, 0, 0);
+            vkCmdBindIndexBuffer(cmd, roadModelPtr->getIndexBuffer(), 0, roadModelPtr->getIndexType());
+
+            // One draw per primitive: optimized ranges each index from their own base vertex
+            for (const NamedMesh& mesh : roadModelPtr->getNamedMeshes()) {
+                if (mesh.indexCount == 0)
+                    continue;
+                vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.indexStart, mesh.vertexOffset, ROAD_OBJECT_INDEX);
+                passStats[PASS_ROAD].drawCalls++;
+                passStats[PASS_ROAD].triangles += mesh.indexCount / 3;
+            }
         }
     }
 
-    // 3. Draw car using scene graph (hierarchical rendering)
-    Scene* activeScene = sceneManager.getActiveScene();
+    gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_ROAD);
+}
+
+void Application::recordStreamedRoad(VkCommandBuffer cmd, uint32_t frameIndex) {
+    // Resident tiles in view, grouped by material; each tile has its own buffers
+    roadStreamer.collectDraws(frameViewProj, camera.getPosition(), framePixelsPerUnit, roadDraws);
+    if (roadDraws.empty()) {
+        return;
+    }
 
-    if (activeScene) {
-        // Update all transforms in the scene
-        activeScene->updateTransforms();
+    auto*                         objects  = frameObjects.as<ObjectData>();
+    const bool                    textured = !roadModelPtr->getMaterials().empty();
+    const bool                    bindless = materialManager->isBindless();
+    const std::array<uint32_t, 3> offsets  = frameDynamicOffsets();
+
+    if (textured) {
+        // Bind the first road material up front so draws without a material still have set 1 and an object slot
+        uint32_t                       gpuId = roadMaterialIds[0];
+        std::array<VkDescriptorSet, 2> sets  = {frameDescriptorSet,
+                                                materialManager->getDescriptorSet(gpuId, frameIndex)};
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, selectCarPipeline(*roadModelPtr));
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
+                                static_cast<uint32_t>(sets.size()), sets.data(), static_cast<uint32_t>(offsets.size()),
+                                offsets.data());
+        writeObject(objects[ROAD_OBJECT_INDEX], roadModelPtr->getModelMatrix(), gpuId, *roadModelPtr);
+    } else {
+        const bool packed = roadModelPtr->getVertexFormat() == VertexFormat::Packed;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, packed ? worldPackedPipeline : worldPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, worldPipelineLayout, 0, 1, &frameDescriptorSet,
+                                static_cast<uint32_t>(offsets.size()), offsets.data());
+        writeObject(objects[ROAD_OBJECT_INDEX], roadModelPtr->getModelMatrix(), 0, *roadModelPtr);
+    }
 
-        // Get render batches (grouped by model and transparency)
-        auto batches = activeScene->getRenderBatches();
+    VkBuffer boundVertices = VK_NULL_HANDLE;
+    VkBuffer boundIndices  = VK_NULL_HANDLE;
+    uint32_t boundMaterial = 0;
+    uint32_t slot          = ROAD_OBJECT_INDEX;
+    for (const WorldStreamer::Draw& draw : roadDraws) {
+        if (draw.vertexBuffer != boundVertices) {
+            VkDeviceSize offset = 0;
+            vkCmdBindVertexBuffers(cmd, 0, 1, &draw.vertexBuffer, &offset);
+            boundVertices = draw.vertexBuffer;
+        }
+        if (draw.indexBuffer != boundIndices) {
+            vkCmdBindIndexBuffer(cmd, draw.indexBuffer, 0, draw.indexType);
+            boundIndices = draw.indexBuffer;
+        }
 
-        // DEBUG: Track rendering statistics
-        static bool debugPrinted        = false;
-        int         totalNodes          = 0;
-        int         skippedNoDescriptor = 0;
-        int         drawnNodes          = 0;
+        // Draws arrive sorted by material: one object slot and descriptor bind each, as in the whole-model path
+        if (textured && draw.material != WORLD_TILE_NO_MATERIAL && draw.material != boundMaterial) {
+            uint32_t gpuId = roadMaterialIds[draw.material];
+            slot           = ROAD_OBJECT_INDEX + draw.material;
+            writeObject(objects[slot], roadModelPtr->getModelMatrix(), gpuId, *roadModelPtr);
 
-        for (const auto& batch : batches) {
-            if (!batch.model || batch.nodes.empty())
-                continue;
+            if (!bindless) {
+                std::array<VkDescriptorSet, 2> sets = {frameDescriptorSet,
+                                                       materialManager->getDescriptorSet(gpuId, frameIndex)};
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
+                                        static_cast<uint32_t>(sets.size()), sets.data(),
+                                        static_cast<uint32_t>(offsets.size()), offsets.data());
+            }
+            boundMaterial = draw.material;
+        }
 
-            // Bind appropriate pipeline based on transparency
-            VkPipeline pipeline = batch.isTransparent ? carTransparentPipeline : carPipeline;
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        // Tile indices are local to the tile's vertex buffer
+        vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.indexStart, 0, slot);
+        passStats[PASS_ROAD].drawCalls++;
+        passStats[PASS_ROAD].triangles += draw.indexCount / 3;
+    }
+}
 
-            static bool loggedTransparency = false;
-            if (!loggedTransparency && batch.isTransparent) {
-                loggedTransparency = true;
+void Application::prepareSceneDraws() {
+    drawScene = sceneManager.getActiveScene();
+    if (!drawScene) {
+        return;
+    }
+
+    // Update all transforms in the scene (also refits the culling BVH)
+    drawScene->updateTransforms();
+
+    // Frustum-cull the cached draw list against the same view-projection the camera UBO uses,
+    // the shadow cascades', and the mirrors' on frames that redraw them
+    drawScene->cullDrawList(frameViewProj, frameExtraViewProj.data(),
+                            EXTRA_VIEW_MIRROR + (mirrorsThisFrame ? mirrorRenderer.getViewCount() : 0));
+
+    // Distant nodes draw a simplified index range of the same vertices
+    drawScene->selectLods(camera.getPosition(), framePixelsPerUnit);
+
+    // Next frame's texture streaming works from these distances; the road is always under the car
+    if (materialManager->isStreamingTextures()) {
+        for (const Scene::DrawItem& item : drawScene->getDrawList())
+            materialManager->noteMaterialDistance(item.materialId, item.distance);
+        for (uint32_t gpuId : roadMaterialIds)
+            materialManager->noteMaterialDistance(gpuId, 0.0f);
+    }
+}
+
+void Application::recordSceneBatches(VkCommandBuffer cmd, uint32_t frameIndex) {
+    sceneDrawCount = 0;
+    if (!drawScene) {
+        return;
+    }
+
+    // Already sorted by (pipeline, material, model); rebuilt only when render state changes
+    const std::vector<Scene::DrawItem>& drawList = drawScene->getDrawList();
+
+    auto*    objects     = frameObjects.as<ObjectData>();
+    auto*    commands    = frameCommands.as<VkDrawIndexedIndirectCommand>();
+    auto*    bounds      = frameCullBounds.as<OcclusionBounds>();
+    uint32_t objectCount = ROAD_OBJECT_INDEX + roadObjectCount;  // Leading slots belong to the road
+    uint32_t drawCount   = 0;
+
+    const VkPhysicalDeviceFeatures& features  = vulkanContext.getEnabledFeatures();
+    const bool                      multiDraw = features.multiDrawIndirect == VK_TRUE;
+    const bool                      indirect  = features.drawIndirectFirstInstance == VK_TRUE;
+    constexpr uint32_t              stride    = sizeof(VkDrawIndexedIndirectCommand);
+
+    // Bindless materials are selected per draw through the object's materialIndex, so
+    // draws that differ only in material can share one multi-draw. Feature bits stay in
+    // the key: each pipeline variant is its own run, bound once
+    const uint64_t runMask = materialManager->isBindless() ? ~Scene::SORT_KEY_MATERIAL_MASK : ~0ull;
+
+    // Currently bound state, so only key changes cost a bind
+    VkPipeline      boundPipeline = VK_NULL_HANDLE;
+    const Model*    boundModel    = nullptr;
+    VkDescriptorSet boundMaterial = VK_NULL_HANDLE;
+
+    // Transparent draws sort after opaque ones, so one switch splits the two timings (and buffers)
+    uint32_t timedSection = GPU_SECTION_OPAQUE;
+    gpuProfiler.beginSection(cmd, frameIndex, timedSection);
+
+    size_t i = 0;
+    while (i < drawList.size()) {
+        const Scene::DrawItem& first         = drawList[i];
+        uint64_t               key           = first.sortKey & runMask;
+        VkDescriptorSet        matDescriptor = materialManager->getDescriptorSet(first.materialId, frameIndex);
+
+        // Write one object slot per in-view draw sharing this key. Draws of the same index range
+        // land in consecutive slots and share one command, instanced over those slots
+        uint32_t firstDraw = drawCount;
+
+        auto emit = [&](const Scene::DrawItem& item) {
+            // Skip draws with no descriptor set (materials without textures)
+            if (!item.inFrustum || matDescriptor == VK_NULL_HANDLE || objectCount >= MAX_SCENE_OBJECTS)
+                return;
+
+            if (!drawScene->getNode(item.handle))
+                return;
+
+            writeObject(objects[objectCount], drawScene->getWorldTransform(item.handle),
+                        drawScene->getPreviousWorldTransform(item.handle), item.materialId, *item.model);
+            passStats[PASS_SCENE].triangles += item.indexCount / 3;
+
+            // Occlusion bounds: w = 0 keeps draws without a box from ever being culled
+            glm::vec3  boxMin(0.0f), boxMax(0.0f);
+            const bool hasBox = drawScene->getWorldBounds(item.handle, boxMin, boxMax);
+
+            if (drawCount > firstDraw) {
+                VkDrawIndexedIndirectCommand& last = commands[drawCount - 1];
+                if (last.firstIndex == item.indexStart && last.indexCount == item.indexCount &&
+                    last.vertexOffset == item.vertexOffset && last.firstInstance + last.instanceCount == objectCount) {
+                    // The command's box covers every instance
+                    OcclusionBounds& merged = bounds[drawCount - 1];
+                    if (!hasBox) {
+                        merged.min.w = 0.0f;
+                    } else if (merged.min.w != 0.0f) {
+                        merged.min = glm::vec4(glm::min(glm::vec3(merged.min), boxMin), 1.0f);
+                        merged.max = glm::vec4(glm::max(glm::vec3(merged.max), boxMax), 0.0f);
+                    }
+
+                    last.instanceCount++;
+                    objectCount++;
+                    return;
+                }
+            }
+
+            bounds[drawCount].min = glm::vec4(boxMin, hasBox ? 1.0f : 0.0f);
+            bounds[drawCount].max = glm::vec4(boxMax, 0.0f);
+
+            VkDrawIndexedIndirectCommand& command = commands[drawCount];
+            command.indexCount                    = item.indexCount;
+            command.instanceCount                 = 1;
+            command.firstIndex                    = item.indexStart;
+            command.vertexOffset                  = item.vertexOffset;
+            command.firstInstance                 = objectCount;
+
+            objectCount++;
+            drawCount++;
+        };
+
+        while (i < drawList.size() && (drawList[i].sortKey & runMask) == key) {
+            // Copies of one primitive are adjacent in the list; emit them level by level so
+            // copies at the same LOD become one instanced command
+            size_t  groupEnd = i + 1;
+            uint8_t maxLod   = drawList[i].lod;
+            while (groupEnd < drawList.size() && (drawList[groupEnd].sortKey & runMask) == key &&
+                   drawList[groupEnd].baseIndexStart == drawList[i].baseIndexStart &&
+                   drawList[groupEnd].vertexOffset == drawList[i].vertexOffset) {
+                maxLod = std::max(maxLod, drawList[groupEnd].lod);
+                groupEnd++;
+            }
+
+            for (uint32_t lod = 0; lod <= maxLod; lod++) {
+                for (size_t d = i; d < groupEnd; d++) {
+                    if (drawList[d].lod == lod)
+                        emit(drawList[d]);
+                }
             }
+            i = groupEnd;
+        }
+
+        uint32_t runLength = drawCount - firstDraw;
+        if (runLength == 0)
+            continue;
+
+        // Transparent runs draw in the OIT subpass, from their own buffer with nothing bound yet
+        if (first.isTransparent && timedSection == GPU_SECTION_OPAQUE) {
+            gpuProfiler.endSection(cmd, frameIndex, timedSection);
+            cmd           = passCommands[frameIndex].buffers[PASS_SCENE_TRANSPARENT];
+            boundPipeline = VK_NULL_HANDLE;
+            boundModel    = nullptr;
+            boundMaterial = VK_NULL_HANDLE;
+            timedSection  = GPU_SECTION_TRANSPARENT;
+            gpuProfiler.beginSection(cmd, frameIndex, timedSection);
+        }
+
+        // Variant compiled for the run's material features, transparency and vertex format
+        const uint32_t features = first.materialFeatures | (first.isTransparent ? MATERIAL_FEATURE_TRANSPARENT : 0u);
+        VkPipeline     pipeline = materialManager->getPipelineVariant(features, first.model->getVertexFormat());
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            boundPipeline = pipeline;
+        }
 
-            // Bind model's vertex and index buffers ONCE per batch
-            VkBuffer     vertexBuffers[] = {batch.model->getVertexBuffer()};
+        if (first.model != boundModel) {
+            VkBuffer     vertexBuffers[] = {first.model->getVertexBuffer()};
             VkDeviceSize offsets[]       = {0};
             vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
-            vkCmdBindIndexBuffer(cmd, batch.model->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(cmd, first.model->getIndexBuffer(), 0, first.model->getIndexType());
+            boundModel = first.model;
+        }
 
-            // Draw each node instance with its own world transform
-            for (SceneNode* node : batch.nodes) {
-                totalNodes++;
-                if (!node || !node->renderData || !node->renderData->isVisible)
-                    continue;
+        if (matDescriptor != boundMaterial) {
+            // Bind descriptor sets: [0] = Camera UBO + objects, [1] = Material textures
+            std::array<VkDescriptorSet, 2> sets       = {frameDescriptorSet, matDescriptor};
+            std::array<uint32_t, 3>        setOffsets = frameDynamicOffsets();
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
+                                    static_cast<uint32_t>(sets.size()), sets.data(),
+                                    static_cast<uint32_t>(setOffsets.size()), setOffsets.data());
+            boundMaterial = matDescriptor;
+        }
+
+        if (indirect && multiDraw) {
+            vkCmdDrawIndexedIndirect(cmd, frameCommands.buffer, frameCommands.offset + firstDraw * stride, runLength,
+                                     stride);
+            passStats[PASS_SCENE].drawCalls++;
+        } else if (indirect) {
+            passStats[PASS_SCENE].drawCalls += runLength;
+            for (uint32_t d = firstDraw; d < drawCount; d++) {
+                vkCmdDrawIndexedIndirect(cmd, frameCommands.buffer, frameCommands.offset + d * stride, 1, stride);
+            }
+        } else {
+            // Without drawIndirectFirstInstance the object index can only reach the shader via direct draws
+            passStats[PASS_SCENE].drawCalls += runLength;
+            for (uint32_t d = firstDraw; d < drawCount; d++) {
+                const VkDrawIndexedIndirectCommand& command = commands[d];
+                vkCmdDrawIndexed(cmd, command.indexCount, command.instanceCount, command.firstIndex,
+                                 command.vertexOffset, command.firstInstance);
+            }
+        }
+    }
 
-                // Push THIS NODE's world transform (includes parent transforms)
-                vkCmdPushConstants(cmd, carPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
-                                   &node->worldTransform);
+    gpuProfiler.endSection(cmd, frameIndex, timedSection);
+    sceneDrawCount   = drawCount;
+    sceneObjectCount = objectCount;
+}
 
-                // Bind material descriptor set
-                uint32_t        matId         = node->renderData->materialId;
-                VkDescriptorSet matDescriptor = materialManager->getDescriptorSet(matId, frameIndex);
+void Application::recordMirrorPass(VkCommandBuffer cmd, uint32_t frameIndex) {
+    auto*    objects     = frameObjects.as<ObjectData>();
+    uint32_t objectCount = sceneObjectCount;  // After the main view's slots
 
-                // Skip nodes with no descriptor set (materials without textures)
-                if (matDescriptor == VK_NULL_HANDLE) {
-                    skippedNoDescriptor++;
-                    continue;
+    // Set 0 reads the mirror view-projections in place of the camera UBO
+    const std::array<uint32_t, 3> offsets  = frameDynamicOffsets(frameMirrorCamera);
+    const bool                    bindless = materialManager->isBindless();
+
+    mirrorRenderer.beginPass(cmd);
+
+    VkPipeline      boundPipeline = VK_NULL_HANDLE;
+    const Model*    boundModel    = nullptr;
+    VkDescriptorSet boundMaterial = VK_NULL_HANDLE;
+
+    // Binds what a draw of `model` with `matDescriptor` needs; the set is rebound only per material
+    // (once when bindless, where the object's materialIndex picks the textures)
+    auto bind = [&](const Model& model, VkDescriptorSet matDescriptor) {
+        VkPipeline pipeline = mirrorRenderer.getScenePipeline(model.getVertexFormat());
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            boundPipeline = pipeline;
+        }
+        if (&model != boundModel) {
+            VkBuffer     vertexBuffers[] = {model.getVertexBuffer()};
+            VkDeviceSize vertexOffsets[] = {0};
+            vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, vertexOffsets);
+            vkCmdBindIndexBuffer(cmd, model.getIndexBuffer(), 0, model.getIndexType());
+            boundModel = &model;
+        }
+        if (boundMaterial == VK_NULL_HANDLE || (!bindless && matDescriptor != boundMaterial)) {
+            std::array<VkDescriptorSet, 2> sets = {frameDescriptorSet, matDescriptor};
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
+                                    static_cast<uint32_t>(sets.size()), sets.data(),
+                                    static_cast<uint32_t>(offsets.size()), offsets.data());
+            boundMaterial = matDescriptor;
+        }
+    };
+
+    // Whole road model; streamed tiles are culled per view by the streamer and stay main-view only
+    if (!roadStreamer.isActive() && roadModelPtr && roadModelPtr->getIndexCount() > 0) {
+        const auto& roadMaterials = roadModelPtr->getMaterials();
+        for (size_t i = 0; i < roadMaterials.size() && objectCount < MAX_SCENE_OBJECTS; i++) {
+            uint32_t        gpuId         = roadMaterialIds[i];
+            VkDescriptorSet matDescriptor = materialManager->getDescriptorSet(gpuId, frameIndex);
+            if (matDescriptor == VK_NULL_HANDLE)
+                continue;
+
+            writeObject(objects[objectCount], roadModelPtr->getModelMatrix(), gpuId, *roadModelPtr);
+            bind(*roadModelPtr, matDescriptor);
+            vkCmdDrawIndexed(cmd, roadMaterials[i].indexCount, 1, roadMaterials[i].indexStart,
+                             roadMaterials[i].vertexOffset, objectCount);
+            primaryStats.drawCalls++;
+            primaryStats.triangles += roadMaterials[i].indexCount / 3;
+            objectCount++;
+        }
+    }
+
+    // Opaque scene draws any mirror sees, from the list the main view was culled with. Transparent
+    // draws need the OIT targets, which the mirrors do not have. Copies of one index range are
+    // adjacent in the sorted list, so consecutive matches become one instanced draw
+    if (drawScene) {
+        const std::vector<Scene::DrawItem>& drawList = drawScene->getDrawList();
+        for (size_t i = 0; i < drawList.size() && objectCount < MAX_SCENE_OBJECTS;) {
+            const Scene::DrawItem& first = drawList[i++];
+            if (first.isTransparent || (first.extraViewMask & MIRROR_VIEW_MASK) == 0 ||
+                !drawScene->getNode(first.handle))
+                continue;
+            VkDescriptorSet matDescriptor = materialManager->getDescriptorSet(first.materialId, frameIndex);
+            if (matDescriptor == VK_NULL_HANDLE)
+                continue;
+
+            const uint32_t firstInstance = objectCount;
+            writeObject(objects[objectCount++], drawScene->getWorldTransform(first.handle),
+                        drawScene->getPreviousWorldTransform(first.handle), first.materialId, *first.model);
+            while (i < drawList.size() && objectCount < MAX_SCENE_OBJECTS) {
+                const Scene::DrawItem& item = drawList[i];
+                if (item.model != first.model || item.materialId != first.materialId ||
+                    item.indexStart != first.indexStart || item.indexCount != first.indexCount ||
+                    item.vertexOffset != first.vertexOffset || item.isTransparent ||
+                    (item.extraViewMask & MIRROR_VIEW_MASK) == 0 || !drawScene->getNode(item.handle))
+                    break;
+                writeObject(objects[objectCount++], drawScene->getWorldTransform(item.handle),
+                            drawScene->getPreviousWorldTransform(item.handle), item.materialId, *item.model);
+                i++;
+            }
+
+            const uint32_t instances = objectCount - firstInstance;
+            bind(*first.model, matDescriptor);
+            vkCmdDrawIndexed(cmd, first.indexCount, instances, first.indexStart, first.vertexOffset, firstInstance);
+            primaryStats.drawCalls++;
+            primaryStats.triangles += static_cast<uint64_t>(first.indexCount / 3) * instances;
+        }
+    }
+
+    mirrorRenderer.endPass(cmd);
+    sceneObjectCount = objectCount;
+}
+
+void Application::recordRainOcclusion(VkCommandBuffer cmd) {
+    CameraUBO ubo{};
+    ubo.view     = glm::mat4(1.0f);
+    ubo.proj     = rainOcclusion.getViewProj();
+    ubo.viewProj = rainOcclusion.getViewProj();
+    memcpy(frameRainCamera.data, &ubo, sizeof(ubo));
+
+    auto*                         objects     = frameObjects.as<ObjectData>();
+    uint32_t                      objectCount = sceneObjectCount;
+    const std::array<uint32_t, 3> offsets     = frameDynamicOffsets(frameRainCamera);
+
+    // Depth only, so no materials are bound
+    VkPipeline   boundPipeline = VK_NULL_HANDLE;
+    const Model* boundModel    = nullptr;
+    auto         bindPipeline  = [&](VertexFormat format) {
+        VkPipeline pipeline = rainOcclusion.getPipeline(format);
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, rainOcclusion.getPipelineLayout(), 0, 1,
+                                    &frameDescriptorSet, static_cast<uint32_t>(offsets.size()), offsets.data());
+            boundPipeline = pipeline;
+        }
+    };
+    auto bind = [&](const Model& model) {
+        bindPipeline(model.getVertexFormat());
+        if (&model != boundModel) {
+            VkBuffer     vertexBuffers[] = {model.getVertexBuffer()};
+            VkDeviceSize vertexOffsets[] = {0};
+            vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, vertexOffsets);
+            vkCmdBindIndexBuffer(cmd, model.getIndexBuffer(), 0, model.getIndexType());
+            boundModel = &model;
+        }
+    };
+
+    // Static: the road and anything built into it (bridges), from one object slot
+    if (rainOcclusionStatic) {
+        rainOcclusion.beginStaticPass(cmd);
+        if (roadModelPtr && roadModelPtr->getIndexCount() > 0 && objectCount < MAX_SCENE_OBJECTS) {
+            const uint32_t slot = objectCount++;
+            writeObject(objects[slot], roadModelPtr->getModelMatrix(), 0, *roadModelPtr);
+
+            if (roadStreamer.isActive()) {
+                // Tiles keep their own buffers; their indices are local to them
+                roadStreamer.collectDraws(rainOcclusion.getViewProj(), camera.getPosition(), framePixelsPerUnit,
+                                          rainOcclusionDraws);
+                bindPipeline(roadModelPtr->getVertexFormat());
+                for (const WorldStreamer::Draw& draw : rainOcclusionDraws) {
+                    VkDeviceSize offset = 0;
+                    vkCmdBindVertexBuffers(cmd, 0, 1, &draw.vertexBuffer, &offset);
+                    vkCmdBindIndexBuffer(cmd, draw.indexBuffer, 0, draw.indexType);
+                    vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.indexStart, 0, slot);
+                    primaryStats.drawCalls++;
+                    primaryStats.triangles += draw.indexCount / 3;
                 }
+            } else {
+                bind(*roadModelPtr);
+                for (const NamedMesh& mesh : roadModelPtr->getNamedMeshes()) {
+                    if (mesh.indexCount == 0)
+                        continue;
+                    vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.indexStart, mesh.vertexOffset, slot);
+                    primaryStats.drawCalls++;
+                    primaryStats.triangles += mesh.indexCount / 3;
+                }
+            }
+        }
+        rainOcclusion.endStaticPass(cmd);
+    }
 
-                // Bind descriptor sets: [0] = Camera UBO, [1] = Material textures
-                std::vector<VkDescriptorSet> sets = {descriptorSets[frameIndex], matDescriptor};
-                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, carPipelineLayout, 0,
-                                        static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+    // Dynamic: every scene draw over the map, transparent ones too (glass stops rain)
+    rainOcclusion.beginDynamicPass(cmd);
+    if (drawScene) {
+        const glm::vec4 area = rainOcclusion.getArea();
+        for (const Scene::DrawItem& item : drawScene->getDrawList()) {
+            if (objectCount >= MAX_SCENE_OBJECTS)
+                break;
+
+            glm::vec3 boxMin, boxMax;
+            if (!drawScene->getNode(item.handle) ||
+                (drawScene->getWorldBounds(item.handle, boxMin, boxMax) &&
+                 (boxMax.x < area.x || boxMin.x > area.x + area.z || boxMax.z < area.y || boxMin.z > area.y + area.z)))
+                continue;
+
+            writeObject(objects[objectCount], drawScene->getWorldTransform(item.handle),
+                        drawScene->getPreviousWorldTransform(item.handle), item.materialId, *item.model);
+            bind(*item.model);
+            vkCmdDrawIndexed(cmd, item.indexCount, 1, item.indexStart, item.vertexOffset, objectCount);
+            primaryStats.drawCalls++;
+            primaryStats.triangles += item.indexCount / 3;
+            objectCount++;
+        }
+    }
+    rainOcclusion.endDynamicPass(cmd);
+
+    sceneObjectCount = objectCount;
+}
+
+void Application::recordShadowPass(VkCommandBuffer cmd) {
+    auto*    objects     = frameObjects.as<ObjectData>();
+    uint32_t objectCount = sceneObjectCount;
+
+    // Depth only, so no materials are bound; each cascade reads its own camera
+    VkPipeline   boundPipeline = VK_NULL_HANDLE;
+    uint32_t     boundCascade  = UINT32_MAX;
+    const Model* boundModel    = nullptr;
+    auto         bindPipeline  = [&](VertexFormat format, uint32_t cascade) {
+        VkPipeline pipeline = shadowCascades.getPipeline(format);
+        if (pipeline != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            boundPipeline = pipeline;
+        }
+        if (cascade != boundCascade) {
+            const std::array<uint32_t, 3> offsets = frameDynamicOffsets(frameShadowCameras[cascade]);
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowCascades.getPipelineLayout(), 0, 1,
+                                    &frameDescriptorSet, static_cast<uint32_t>(offsets.size()), offsets.data());
+            boundCascade = cascade;
+        }
+    };
+    auto bind = [&](const Model& model, uint32_t cascade) {
+        bindPipeline(model.getVertexFormat(), cascade);
+        if (&model != boundModel) {
+            VkBuffer     vertexBuffers[] = {model.getVertexBuffer()};
+            VkDeviceSize vertexOffsets[] = {0};
+            vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, vertexOffsets);
+            vkCmdBindIndexBuffer(cmd, model.getIndexBuffer(), 0, model.getIndexType());
+            boundModel = &model;
+        }
+    };
 
-                // Draw this node's geometry
-                vkCmdDrawIndexed(cmd, node->renderData->indexCount, 1, node->renderData->indexStart, 0, 0);
-                drawnNodes++;
+    // Static: the road and anything built into it, into the layers of cascades that moved, from one object slot
+    if (shadowCascadesMoved != 0) {
+        const bool     hasRoad  = roadModelPtr && roadModelPtr->getIndexCount() > 0 && objectCount < MAX_SCENE_OBJECTS;
+        const uint32_t roadSlot = objectCount;
+        if (hasRoad)
+            writeObject(objects[objectCount++], roadModelPtr->getModelMatrix(), 0, *roadModelPtr);
+
+        for (uint32_t cascade = 0; cascade < ShadowCascades::CASCADE_COUNT; cascade++) {
+            if ((shadowCascadesMoved & (1u << cascade)) == 0)
+                continue;
+
+            shadowCascades.beginStaticPass(cmd, cascade);
+            if (hasRoad && roadStreamer.isActive()) {
+                // Tiles keep their own buffers; their indices are local to them
+                roadStreamer.collectDraws(shadowCascades.getViewProj(cascade), camera.getPosition(),
+                                          framePixelsPerUnit, shadowDraws);
+                bindPipeline(roadModelPtr->getVertexFormat(), cascade);
+                boundModel = nullptr;
+                for (const WorldStreamer::Draw& draw : shadowDraws) {
+                    VkDeviceSize offset = 0;
+                    vkCmdBindVertexBuffers(cmd, 0, 1, &draw.vertexBuffer, &offset);
+                    vkCmdBindIndexBuffer(cmd, draw.indexBuffer, 0, draw.indexType);
+                    vkCmdDrawIndexed(cmd, draw.indexCount, 1, draw.indexStart, 0, roadSlot);
+                    primaryStats.drawCalls++;
+                    primaryStats.triangles += draw.indexCount / 3;
+                }
+            } else if (hasRoad) {
+                bind(*roadModelPtr, cascade);
+                for (const NamedMesh& mesh : roadModelPtr->getNamedMeshes()) {
+                    if (mesh.indexCount == 0)
+                        continue;
+                    vkCmdDrawIndexed(cmd, mesh.indexCount, 1, mesh.indexStart, mesh.vertexOffset, roadSlot);
+                    primaryStats.drawCalls++;
+                    primaryStats.triangles += mesh.indexCount / 3;
+                }
             }
+            shadowCascades.endStaticPass(cmd);
         }
     }
 
-    // 4. Draw debug markers (if enabled)
+    shadowCascades.copyStaticLayers(cmd);
 
-    vkCmdEndRenderPass(cmd);
+    // Dynamic: opaque scene draws in a cascade's frustum, as culled with the main view. Each draw takes one
+    // object slot however many cascades it falls in; copies of one index range with consecutive slots become
+    // one instanced draw per cascade
+    const std::vector<Scene::DrawItem>* drawList = drawScene ? &drawScene->getDrawList() : nullptr;
+    constexpr uint8_t shadowViews = ((1u << ShadowCascades::CASCADE_COUNT) - 1) << EXTRA_VIEW_SHADOW;
 
-    if (vkEndCommandBuffer(cmd) != VK_SUCCESS)
-        throw std::runtime_error("Failed to record command buffer");
+    ArenaVector<uint32_t> slots{ArenaAllocator<uint32_t>(frameArena)};
+    if (drawList) {
+        slots.assign(drawList->size(), UINT32_MAX);
+        for (size_t i = 0; i < drawList->size() && objectCount < MAX_SCENE_OBJECTS; i++) {
+            const Scene::DrawItem& item = (*drawList)[i];
+            if (item.isTransparent || (item.extraViewMask & shadowViews) == 0 || !drawScene->getNode(item.handle))
+                continue;
+            writeObject(objects[objectCount], drawScene->getWorldTransform(item.handle),
+                        drawScene->getPreviousWorldTransform(item.handle), item.materialId, *item.model);
+            slots[i] = objectCount++;
+        }
+    }
+
+    for (uint32_t cascade = 0; cascade < ShadowCascades::CASCADE_COUNT; cascade++) {
+        shadowCascades.beginDynamicPass(cmd, cascade);
+        const uint8_t view = static_cast<uint8_t>(1u << (EXTRA_VIEW_SHADOW + cascade));
+        for (size_t i = 0; drawList && i < drawList->size();) {
+            const Scene::DrawItem& first = (*drawList)[i];
+            const uint32_t         slot  = slots[i++];
+            if (slot == UINT32_MAX || (first.extraViewMask & view) == 0)
+                continue;
+
+            uint32_t instances = 1;
+            while (i < drawList->size()) {
+                const Scene::DrawItem& item = (*drawList)[i];
+                if (slots[i] != slot + instances || (item.extraViewMask & view) == 0 || item.model != first.model ||
+                    item.indexStart != first.indexStart || item.indexCount != first.indexCount ||
+                    item.vertexOffset != first.vertexOffset)
+                    break;
+                instances++;
+                i++;
+            }
+
+            bind(*first.model, cascade);
+            vkCmdDrawIndexed(cmd, first.indexCount, instances, first.indexStart, first.vertexOffset, slot);
+            primaryStats.drawCalls++;
+            primaryStats.triangles += static_cast<uint64_t>(first.indexCount / 3) * instances;
+        }
+        shadowCascades.endDynamicPass(cmd);
+    }
+
+    sceneObjectCount = objectCount;
 }
-// ==== Buffer Helper Methods (TODO) ====
 
 void Application::drawFrame() {
-    // Wait for previous frame
-    vkWaitForFences(vulkanContext.getDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    DP_PROFILE_SCOPE("Application::drawFrame");
+    const uint64_t allocationsBefore = AllocationCounter::getCount();
+    const uint64_t recordStartNs     = Profiler::now();
+
+    // Scratch from the previous frame is dead once its commands were recorded
+    frameArena.reset();
+
+    // mainLoop already waited on this slot through the frame pacer
     vkResetFences(vulkanContext.getDevice(), 1, &inFlightFences[currentFrame]);
 
-    // Acquire image
-    uint32_t imageIndex;
-    vkAcquireNextImageKHR(vulkanContext.getDevice(), swapChainManager.getSwapChain(), UINT64_MAX,
-                          imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+    // Acquire image; offscreen targets are one per frame slot, so there is nothing to acquire
+    const bool offscreen  = swapChainManager.isOffscreen();
+    uint32_t   imageIndex = static_cast<uint32_t>(currentFrame);
+    if (!offscreen) {
+        vkAcquireNextImageKHR(vulkanContext.getDevice(), swapChainManager.getSwapChain(), UINT64_MAX,
+                              imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+    }
+
+    // Pick this frame's render scale from the latest GPU timings before anything depends on it
+    dynamicResolution.update(gpuProfiler);
+
+    // Mirrors show in cockpit view only, and redraw every few frames
+    mirrorsThisFrame = mirrorRenderer.beginFrame(camera.getMode() == CameraMode::Cockpit &&
+                                                 camera.getMirrorViews().size() >= mirrorRenderer.getViewCount());
 
-    // Update uniforms
+    // Swap in streamed textures that finished uploading and queue the next ones; this slot's fence has signalled.
+    // Both streamers size their budgets from the device's current headroom
+    MemoryAllocator::get().updateBudget();
+    materialManager->updateStreaming(static_cast<uint32_t>(currentFrame));
+
+    // Carve this slot's transient GPU data, then fill the camera UBO
+    beginFrameAllocations();
     updateUniformBuffer(currentFrame);
 
     // Record commands
     vkResetCommandBuffer(commandBuffers[imageIndex], 0);
     recordCommandBuffer(commandBuffers[imageIndex], imageIndex, currentFrame);
+    const uint64_t submitStartNs = Profiler::now();
 
     // Submit
-    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    VkSubmitInfo         submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-    submit.waitSemaphoreCount   = 1;
-    submit.pWaitSemaphores      = &imageAvailableSemaphores[currentFrame];
-    submit.pWaitDstStageMask    = &waitStage;
-    submit.commandBufferCount   = 1;
-    submit.pCommandBuffers      = &commandBuffers[imageIndex];
-    submit.signalSemaphoreCount = 1;
-    submit.pSignalSemaphores    = &renderFinishedSemaphores[currentFrame];
+    // The upscale blit is the first write to the acquired image; the graph adds its waits on async compute
+    SubmitSemaphores sync;
+    if (!offscreen)
+        sync.wait(imageAvailableSemaphores[currentFrame], VK_PIPELINE_STAGE_TRANSFER_BIT);
+    renderGraph.addGraphicsSync(sync);
+    if (!offscreen)
+        sync.signal(renderFinishedSemaphores[currentFrame]);
+
+    VkSubmitInfo submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers    = &commandBuffers[imageIndex];
+    sync.apply(submit);
 
     if (vkQueueSubmit(vulkanContext.getGraphicsQueue(), 1, &submit, inFlightFences[currentFrame]) != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer");
     }
 
     // Present
-    VkPresentInfoKHR present{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
-    present.waitSemaphoreCount = 1;
-    present.pWaitSemaphores    = &renderFinishedSemaphores[currentFrame];
-    present.swapchainCount     = 1;
-    VkSwapchainKHR swapChain   = swapChainManager.getSwapChain();
-    present.pSwapchains        = &swapChain;
-    present.pImageIndices      = &imageIndex;
+    if (!offscreen) {
+        VkPresentInfoKHR present{VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+        present.waitSemaphoreCount = 1;
+        present.pWaitSemaphores    = &renderFinishedSemaphores[currentFrame];
+        present.swapchainCount     = 1;
+        VkSwapchainKHR swapChain   = swapChainManager.getSwapChain();
+        present.pSwapchains        = &swapChain;
+        present.pImageIndices      = &imageIndex;
+        framePacer.attachPresentId(present);
+
+        vkQueuePresentKHR(vulkanContext.getPresentQueue(), &present);
+    }
 
-    vkQueuePresentKHR(vulkanContext.getPresentQueue(), &present);
+    if (telemetry.isOpen()) {
+        telemetryFrame.cpuZoneMs[TELEMETRY_ZONE_RECORD] = static_cast<float>(submitStartNs - recordStartNs) * 1e-6f;
+        telemetryFrame.cpuZoneMs[TELEMETRY_ZONE_SUBMIT] = static_cast<float>(Profiler::now() - submitStartNs) * 1e-6f;
+        publishTelemetry();
+    }
 
     // Advance frame
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    framePacer.endFrame();
+    currentFrame = (currentFrame + 1) % framesInFlight;
+
+    // With DOWNPOUR_COUNT_ALLOCATIONS, report steady-state frames that reached the heap (on any thread)
+    if (AllocationCounter::isEnabled() && ++countedFrames > ALLOCATION_WARMUP_FRAMES) {
+        const uint64_t allocations = AllocationCounter::getCount() - allocationsBefore;
+        if (allocations > 0 && countedFrames - lastAllocationReport >= ALLOCATION_REPORT_FRAMES) {
+            DP_LOG(Warning, "Frame %llu made %llu heap allocations", static_cast<unsigned long long>(countedFrames),
+                   static_cast<unsigned long long>(allocations));
+            lastAllocationReport = countedFrames;
+        }
+    }
+}
+
+void Application::publishTelemetry() {
+    const uint64_t now     = Profiler::now();
+    telemetryFrame.frameMs = lastTelemetryNs != 0 ? static_cast<float>(now - lastTelemetryNs) * 1e-6f : 0.0f;
+    lastTelemetryNs        = now;
+
+    telemetryFrame.gpuMs = gpuProfiler.getLastFrameMs();
+    for (uint32_t section = 0; section < GPU_SECTION_COUNT && section < DP_TELEMETRY_MAX_SECTIONS; section++)
+        telemetryFrame.gpuSectionMs[section] = gpuProfiler.isEnabled() ? gpuProfiler.getLastSectionMs(section) : 0.0f;
+
+    telemetryFrame.drawCalls = primaryStats.drawCalls;
+    telemetryFrame.triangles = primaryStats.triangles;
+    for (const PassStats& pass : passStats) {
+        telemetryFrame.drawCalls += pass.drawCalls;
+        telemetryFrame.triangles += pass.triangles;
+    }
+
+    const MemoryAllocator& allocator  = MemoryAllocator::get();
+    telemetryFrame.deviceAllocations   = allocator.getDeviceAllocationCount();
+    telemetryFrame.deviceReservedBytes = allocator.getReservedBytes();
+    telemetryFrame.deviceUsedBytes     = allocator.getUsedBytes();
+    telemetryFrame.renderScale         = dynamicResolution.getScale();
+
+    telemetry.publish(telemetryFrame);
 }
 
 void Application::mainLoop() {
+    DP_PROFILE_THREAD_NAME("Main");
+    startSimulation();
+
     while (!glfwWindowShouldClose(window)) {
+        DP_PROFILE_SCOPE("Application::mainLoop");
+
+        // Pace first, then poll: everything below sees input that is as fresh as the latency mode allows
+        {
+            DP_PROFILE_SCOPE("FramePacer::waitForFrame");
+            const uint64_t waitStartNs = Profiler::now();
+            framePacer.waitForFrame(swapChainManager.getSwapChain(), inFlightFences[currentFrame]);
+            telemetryFrame.cpuZoneMs[TELEMETRY_ZONE_WAIT] = static_cast<float>(Profiler::now() - waitStartNs) * 1e-6f;
+        }
+        glfwPollEvents();
+        framePacer.markInputSampled();
+
         float currentTime = glfwGetTime();
         float deltaTime   = currentTime - lastFrameTime;
         lastFrameTime     = currentTime;
@@ -542,35 +1807,22 @@ void Application::mainLoop() {
             }
         }
 
-        // Toggle weather with R key
+        // Toggle weather with R key; the simulation switches on its next step
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-            weatherSystem.toggleWeather();
+            rainRequested = !rainRequested;
             // Small delay to prevent multiple toggles
             while (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
                 glfwPollEvents();
             }
         }
 
-        // Update car physics
-        updateCarPhysics(deltaTime);
-
-        // Update camera based on car position and rotation
-        if (camera.getMode() == CameraMode::Cockpit) {
-            updateCameraForCockpit();
-        }
-        camera.updateCameraMode(deltaTime);
-
-        // Update weather system
-        weatherSystem.update(deltaTime);
-
-        // Update windshield with rain data
-        windshield.update(deltaTime, weatherSystem.getActiveDrops());
-
-        // Handle wiper control with I key
-        if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) {
-            windshield.setWiperActive(true);
-        } else {
-            windshield.setWiperActive(false);
+        // Switch the car's headlights and taillights with H
+        if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
+            if (playerCar)
+                playerCar->setLights(!playerCar->areLightsOn());
+            while (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
+                glfwPollEvents();
+            }
         }
 
         // Toggle debug visualization with V key
@@ -585,6 +1837,7 @@ void Application::mainLoop() {
         // Cycle camera mode with C key
         if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
             camera.cycleMode();
+            occlusionCuller.invalidate();  // Last frame's depth says nothing about the new view
             // Small delay to prevent multiple toggles
             while (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
                 glfwPollEvents();
@@ -628,31 +1881,187 @@ void Application::mainLoop() {
         // Print updated offset when changed
         if (offsetChanged) {
             camera.setCockpitOffset(cockpitOffset);
-            Log logger;
-            logger.log("info", "Cockpit Offset: (" + std::to_string(cockpitOffset.x) + ", " +
-                                   std::to_string(cockpitOffset.y) + ", " + std::to_string(cockpitOffset.z) + ")");
+            DP_LOG(Info, "Cockpit Offset: (%.3f, %.3f, %.3f)", cockpitOffset.x, cockpitOffset.y, cockpitOffset.z);
         }
 
         // Log camera and car position on L key press
         if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
             glm::vec3 camPos = camera.getPosition();
-            Log       logger;
-            logger.log("position", "Camera: (" + std::to_string(camPos.x) + ", " + std::to_string(camPos.y) + ", " +
-                                       std::to_string(camPos.z) + ") | Car: (" + std::to_string(carPosition.x) + ", " +
-                                       std::to_string(carPosition.y) + ", " + std::to_string(carPosition.z) +
-                                       ") | Angle: " + std::to_string(carRotation));
+            DP_LOG(Position, "Camera: (%.3f, %.3f, %.3f) | Car: (%.3f, %.3f, %.3f) | Angle: %.3f", camPos.x, camPos.y,
+                   camPos.z, vehicle.position.x, vehicle.position.y, vehicle.position.z, vehicle.rotation);
             // Small delay to prevent multiple logs
             while (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
                 glfwPollEvents();
             }
         }
 
-        // Update debug markers every frame (car position changes)
+        // Report GPU memory against the budget, per subsystem, with M
+        if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+            MemoryAllocator::get().logReport();
+            while (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS) {
+                glfwPollEvents();
+            }
+        }
+
+#if defined(DOWNPOUR_PROFILING)
+        // Dump the CPU profiler trace with F9
+        if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS) {
+            DP_PROFILE_EXPORT(CPU_TRACE_PATH);
+            while (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS) {
+                glfwPollEvents();
+            }
+        }
+#endif
+
+        // GLFW input is main-thread only; the simulation picks these up on its next step
+        auto held = [this](int key, int alternate) {
+            return glfwGetKey(window, key) == GLFW_PRESS || glfwGetKey(window, alternate) == GLFW_PRESS;
+        };
+        Simulation::VehicleInput input;
+        input.accelerate = held(GLFW_KEY_UP, GLFW_KEY_W);
+        input.brake      = held(GLFW_KEY_DOWN, GLFW_KEY_S);
+        input.steerLeft  = held(GLFW_KEY_LEFT, GLFW_KEY_A);
+        input.steerRight = held(GLFW_KEY_RIGHT, GLFW_KEY_D);
+        input.raining    = rainRequested;
+        input.wipers     = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+        simulation.setInput(input);
+
+        // Place the car between the simulation's last two steps
+        vehicle = simulation.sample().vehicle;
+        applyVehicleState(deltaTime);
+
+        // Update camera based on car position and rotation
+        if (camera.getMode() == CameraMode::Cockpit) {
+            updateCameraForCockpit();
+        }
+        camera.updateCameraMode(deltaTime);
 
-        glfwPollEvents();
         drawFrame();
     }
+    simulation.stop();
+    vkDeviceWaitIdle(vulkanContext.getDevice());
+
+    if (!recordPath.empty()) {
+        inputRecording.save(recordPath);
+        DP_LOG(Info, "Recorded %zu steps to %s", inputRecording.size(), recordPath.c_str());
+    }
+}
+
+namespace {
+
+/**
+ * @brief Benchmark drive: a repeating 12 s loop of throttle, a left and a right bend, and a stop
+ */
+Simulation::VehicleInput scriptedBenchmarkInput(float time) {
+    const float phase = std::fmod(time, 12.0f);
+
+    Simulation::VehicleInput input;
+    input.accelerate = phase < 9.0f;
+    input.brake      = phase >= 10.0f;
+    input.steerLeft  = phase >= 2.0f && phase < 3.5f;
+    input.steerRight = phase >= 5.0f && phase < 6.5f;
+    return input;
+}
+
+}  // namespace
+
+std::vector<BenchmarkRun> Application::runBenchmark(const BenchmarkConfig& config) {
+    headless        = true;
+    offscreenExtent = {std::max(config.width, 1u), std::max(config.height, 1u)};
+    targetFrameMs   = 0.0f;  // Timings are compared across runs, so always render at the requested size
+
+    replaying = !config.replayPath.empty();
+    if (replaying)
+        inputRecording = Simulation::InputRecording::load(config.replayPath);
+
+    initVulkan();
+    const Simulation::VehicleState start = vehicle;  // As placed by loadCarModel()
+
+    std::vector<BenchmarkRun> runs;
+    if (config.rainOff)
+        runs.push_back(runBenchmarkPass(config, false, start));
+    if (config.rainOn)
+        runs.push_back(runBenchmarkPass(config, true, start));
+
     vkDeviceWaitIdle(vulkanContext.getDevice());
+    cleanup();
+    return runs;
+}
+
+BenchmarkRun Application::runBenchmarkPass(const BenchmarkConfig& config, bool raining,
+                                           const Simulation::VehicleState& start) {
+    using Clock                 = std::chrono::steady_clock;
+    constexpr float FRAME_RATE  = 60.0f;
+    const uint32_t  totalFrames = config.warmupFrames + config.frames;
+
+    // The script steps once per frame; a replay keeps its own step so the drive matches the recording
+    const uint32_t stepsPerFrame =
+        replaying ? std::max(1u, static_cast<uint32_t>(std::lround(inputRecording.getRate() / FRAME_RATE))) : 1u;
+    const float step      = replaying ? static_cast<float>(1.0 / inputRecording.getRate()) : 1.0f / FRAME_RATE;
+    const float frameTime = step * static_cast<float>(stepsPerFrame);
+    uint64_t    tick      = 0;
+
+    BenchmarkRun run;
+    run.raining = raining;
+    run.frames.reserve(config.frames);
+
+    // Every pass starts from the same state and seed so rain on/off drive an identical path
+    weatherSystem.setWeatherState(raining ? Simulation::WeatherSystem::WeatherState::Rainy
+                                          : Simulation::WeatherSystem::WeatherState::Sunny);
+    weatherSystem.reseed(replaying ? inputRecording.getSeed() : Simulation::InputRecording::DEFAULT_SEED);
+    Simulation::SimulationSnapshot state;
+    state.vehicle = start;
+
+    // A frame slot's GPU timings resolve when the slot is recorded again, framesInFlight frames
+    // later, so results seen before then belong to warm-up frames or the previous pass
+    const uint32_t firstGpuFrame = config.warmupFrames + framesInFlight;
+    uint64_t       gpuResolved   = gpuProfiler.getResolvedFrameCount();
+
+    for (uint32_t frame = 0; frame < totalFrames; frame++) {
+        const bool measured = frame >= config.warmupFrames;
+
+        framePacer.waitForFrame(VK_NULL_HANDLE, inFlightFences[currentFrame]);
+        Clock::time_point start = Clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(simulation.worldMutex());
+            for (uint32_t s = 0; s < stepsPerFrame; s++, tick++) {
+                Simulation::VehicleInput input =
+                    replaying ? inputRecording.at(tick) : scriptedBenchmarkInput(static_cast<float>(tick) * step);
+                input.raining = raining;  // The pass, not the recording, picks the weather
+                stepWorld(step, input, state);
+            }
+        }
+        vehicle = state.vehicle;
+        applyVehicleState(frameTime);
+        if (camera.getMode() == CameraMode::Cockpit) {
+            updateCameraForCockpit();
+        }
+        camera.updateCameraMode(frameTime);
+
+        drawFrame();
+
+        float    cpuMs    = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+        uint64_t resolved = gpuProfiler.getResolvedFrameCount();
+        if (resolved != gpuResolved && frame >= firstGpuFrame)
+            run.gpuMs.push_back(gpuProfiler.getLastFrameMs());
+        gpuResolved = resolved;
+
+        if (!measured)
+            continue;
+
+        BenchmarkFrame result;
+        result.cpuMs = cpuMs;
+        for (const PassStats& pass : passStats) {
+            result.drawCalls += pass.drawCalls;
+            result.triangles += pass.triangles;
+        }
+        result.drawCalls += primaryStats.drawCalls;
+        result.triangles += primaryStats.triangles;
+        run.frames.push_back(result);
+    }
+
+    return run;
 }
 
 void Application::mouseCallback(GLFWwindow* window, double xpos, double ypos) {
@@ -678,53 +2087,334 @@ void Application::mouseCallback(GLFWwindow* window, double xpos, double ypos) {
     app->camera.processMouseMovement(xoffset, yoffset);
 }
 
-void Application::createDepthResources() {
-    VkFormat depthFormat = ResourceManager::findDepthFormat(vulkanContext.getPhysicalDevice());
+void Application::setupRenderGraph() {
+    const VkPhysicalDevice physicalDevice = vulkanContext.getPhysicalDevice();
+    const VkFormat         depthFormat    = ResourceManager::findDepthFormat(physicalDevice);
+
+    // Occlusion culling samples the depth after the render pass; not every depth format allows it
+    VkFormatProperties formatProps;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, depthFormat, &formatProps);
+    depthSampleable = (formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+
+    // Culled commands are only skipped when the GPU reads them, i.e. with indirect draws
+    occlusionCulling = depthSampleable && vulkanContext.getEnabledFeatures().drawIndirectFirstInstance == VK_TRUE;
+    if (!occlusionCulling)
+        DP_LOG(Info, "Occlusion culling disabled (needs drawIndirectFirstInstance and a sampleable depth format)");
+
+    const bool hasStencil = depthFormat == VK_FORMAT_D32_SFLOAT_S8_UINT || depthFormat == VK_FORMAT_D24_UNORM_S8_UINT ||
+                            depthFormat == VK_FORMAT_D16_UNORM_S8_UINT;
+
+    TransientImageDesc depthDesc;
+    depthDesc.format = depthFormat;
+    depthDesc.extent = swapChainManager.getExtent();
+    depthDesc.usage  = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (depthSampleable ? VK_IMAGE_USAGE_SAMPLED_BIT : 0);
+    depthDesc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT | (hasStencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+
+    // Written and read only inside the render pass, so tilers can keep them on chip
+    TransientImageDesc oitDesc;
+    oitDesc.format = SwapChainManager::OIT_ACCUM_FORMAT;
+    oitDesc.extent = swapChainManager.getExtent();
+    oitDesc.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                    VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    TransientImageDesc revealageDesc = oitDesc;
+    revealageDesc.format             = SwapChainManager::OIT_REVEALAGE_FORMAT;
+
+    // Written by the opaque subpass, read by the temporal upscaler right after the render pass
+    TransientImageDesc motionDesc;
+    motionDesc.format = SwapChainManager::MOTION_FORMAT;
+    motionDesc.extent = swapChainManager.getExtent();
+    motionDesc.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+    // Rebuilt every frame from ShadowCascades' cached static layers, so nothing needs to survive the frame
+    TransientImageDesc shadowMapDesc;
+    shadowMapDesc.format = ShadowCascades::MAP_FORMAT;
+    shadowMapDesc.extent = {ShadowCascades::RESOLUTION, ShadowCascades::RESOLUTION};
+    shadowMapDesc.usage  = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                          VK_IMAGE_USAGE_SAMPLED_BIT;
+    shadowMapDesc.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    shadowMapDesc.layers = ShadowCascades::CASCADE_COUNT;
+
+    graphBackbuffer         = renderGraph.importImage("backbuffer");
+    graphSceneColor         = renderGraph.importImage("scene color");
+    graphSceneDepth         = renderGraph.createImage("scene depth", depthDesc);
+    graphOitAccum           = renderGraph.createImage("oit accum", oitDesc);
+    graphOitRevealage       = renderGraph.createImage("oit revealage", revealageDesc);
+    graphMotion             = renderGraph.createImage("motion", motionDesc);
+    graphRainMap            = renderGraph.importImage("rain map", VK_IMAGE_ASPECT_DEPTH_BIT, true);
+    graphRainDrops          = renderGraph.importBuffer("rain drops", true);
+    graphRainState          = renderGraph.importBuffer("rain state");
+    graphShadowMap          = renderGraph.createImage("shadow map", shadowMapDesc);
+    graphLightClusters      = renderGraph.importBuffer("light clusters");
+    graphMirrorColor        = renderGraph.importImage("mirror color");
+    graphDrawCommands       = renderGraph.importBuffer("draw commands");
+    graphDepthPyramid       = renderGraph.importImage("depth pyramid");
+    graphWindshieldState[0] = renderGraph.importImage("windshield state 0");
+    graphWindshieldState[1] = renderGraph.importImage("windshield state 1");
+    graphWindshieldDroplets = renderGraph.importBuffer("windshield droplets");
+    graphReflectionDepth    = renderGraph.importImage("reflection depth");
+    graphReflections[0]     = renderGraph.importImage("reflections 0");
+    graphReflections[1]     = renderGraph.importImage("reflections 1");
+    graphUpscaleHistory[0]  = renderGraph.importImage("upscale history 0");
+    graphUpscaleHistory[1]  = renderGraph.importImage("upscale history 1");
+
+    // The rain step recycles drops against the slot's map from framesInFlight frames ago, so it is declared
+    // before this frame redraws the map and needs nothing from this frame's graphics work: on the async queue
+    // it overlaps the previous frames. The main pass waits for its drops
+    rainComputePass =
+        renderGraph
+            .addPass("rain compute", RenderQueue::AsyncCompute,
+                     [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                         std::lock_guard<std::mutex> lock(simulation.worldMutex());
+                         const bool timed = !renderGraph.isAsync(rainComputePass);
+                         if (timed)
+                             gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_RAIN_COMPUTE);
+                         weatherSystem.recordCompute(cmd, frameIndex, camera.getPosition(),
+                                                     rainOcclusion.getArea(frameIndex), RainOcclusionMap::DEPTH_RANGE);
+                         if (timed)
+                             gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_RAIN_COMPUTE);
+                     })
+            .read(graphRainMap, RenderAccess::ComputeSampled)
+            .write(graphRainState, RenderAccess::ComputeStorage)
+            .write(graphRainDrops, RenderAccess::ComputeStorage)
+            .id();
+
+    // The rain stops at the surfaces in the occlusion map, drawn while the weather cannot change. Both rain
+    // passes run only while it is raining
+    rainOcclusionPass = renderGraph
+                            .addPass("rain occlusion", RenderQueue::Graphics,
+                                     [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                                         std::lock_guard<std::mutex> lock(simulation.worldMutex());
+                                         gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_RAIN_OCCLUSION);
+                                         recordRainOcclusion(cmd);
+                                         gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_RAIN_OCCLUSION);
+                                     })
+                            .write(graphRainMap, RenderAccess::TransferDst, RenderAccess::DepthAttachment)
+                            .id();
+
+    // Shares nothing with the graphics passes, so it overlaps them on a compute-only queue when there is one.
+    // The GPU profiler's queries live on the graphics queue
+    windshieldPass =
+        renderGraph
+            .addPass("windshield", RenderQueue::AsyncCompute,
+                     [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                         std::lock_guard<std::mutex> lock(simulation.worldMutex());
+                         const bool timed = !renderGraph.isAsync(windshieldPass);
+                         if (timed)
+                             gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_WINDSHIELD);
+                         windshield.recordCompute(cmd, frameIndex);
+                         if (timed)
+                             gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_WINDSHIELD);
+                     })
+            .write(graphWindshieldState[0], RenderAccess::ComputeStorage)
+            .write(graphWindshieldState[1], RenderAccess::ComputeStorage)
+            .write(graphWindshieldDroplets, RenderAccess::ComputeStorage)
+            .id();
+
+    // Sun shadows; both the mirrors and the main pass shade with them
+    renderGraph
+        .addPass("shadows", RenderQueue::Graphics,
+                 [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                     gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_SHADOWS);
+                     recordShadowPass(cmd);
+                     gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_SHADOWS);
+                 })
+        .write(graphShadowMap, RenderAccess::TransferDst, RenderAccess::DepthAttachment);
+
+    // Local lights into the main view's froxels, for every pass that shades the scene
+    renderGraph
+        .addPass("light cull", RenderQueue::Graphics,
+                 [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                     gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_LIGHT_CULL);
+                     clusteredLights.recordCull(cmd);
+                     gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_LIGHT_CULL);
+                 })
+        .write(graphLightClusters, RenderAccess::ComputeStorage);
+
+    // Mirrors render before the main pass, which samples them in its composite subpass
+    mirrorPass = renderGraph
+                     .addPass("mirrors", RenderQueue::Graphics,
+                              [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                                  gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_MIRRORS);
+                                  recordMirrorPass(cmd, frameIndex);
+                                  gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_MIRRORS);
+                              })
+                     .read(graphShadowMap, RenderAccess::FragmentSampled)
+                     .read(graphLightClusters, RenderAccess::FragmentStorageRead)
+                     .write(graphMirrorColor, RenderAccess::ColorAttachment)
+                     .id();
+
+    // Scene commands are final once recordSceneBatches has returned; hide those behind last frame's depth
+    if (occlusionCulling) {
+        renderGraph
+            .addPass("occlusion cull", RenderQueue::Graphics,
+                     [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                         gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_OCCLUSION);
+                         occlusionCuller.cull(cmd, frameCommands, frameCullBounds, sceneDrawCount);
+                         gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_OCCLUSION);
+                     })
+            .read(graphDepthPyramid, RenderAccess::ComputeStorageRead)
+            .write(graphDrawCommands, RenderAccess::ComputeStorage);
+    }
+
+    renderGraph
+        .addPass("main", RenderQueue::Graphics,
+                 [this](VkCommandBuffer cmd, uint32_t frameIndex) { recordMainPass(cmd, frameIndex); })
+        .write(graphSceneColor, RenderAccess::ColorAttachment)
+        .write(graphSceneDepth, RenderAccess::DepthAttachment)
+        .write(graphOitAccum, RenderAccess::ColorAttachment)
+        .write(graphOitRevealage, RenderAccess::ColorAttachment)
+        .write(graphMotion, RenderAccess::ColorAttachment)
+        .read(graphDrawCommands, RenderAccess::IndirectRead)
+        .read(graphRainDrops, RenderAccess::VertexStorageRead)
+        .read(graphRainMap, RenderAccess::VertexSampled)
+        .read(graphMirrorColor, RenderAccess::FragmentSampled)
+        .read(graphShadowMap, RenderAccess::FragmentSampled)
+        .read(graphLightClusters, RenderAccess::FragmentStorageRead)
+        .read(graphReflections[0], RenderAccess::FragmentSampled)
+        .read(graphReflections[1], RenderAccess::FragmentSampled)
+        .read(graphReflectionDepth, RenderAccess::FragmentSampled);
+
+    // Both history images are written: the resolve reads one as history in GENERAL, and blits the other
+    renderGraph
+        .addPass("upscale", RenderQueue::Graphics,
+                 [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                     gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_UPSCALE);
+                     temporalUpscaler.record(cmd, renderGraph.getImage(graphBackbuffer));
+                     gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_UPSCALE);
+                 })
+        .read(graphSceneColor, RenderAccess::ComputeSampled)
+        .read(graphMotion, RenderAccess::ComputeSampled)
+        .write(graphUpscaleHistory[0], RenderAccess::ComputeStorage)
+        .write(graphUpscaleHistory[1], RenderAccess::ComputeStorage)
+        .write(graphBackbuffer, RenderAccess::TransferDst);
+
+    if (occlusionCulling) {
+        renderGraph
+            .addPass("hi-z", RenderQueue::Graphics,
+                     [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                         gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_HIZ);
+                         occlusionCuller.buildPyramid(cmd, dynamicResolution.getRenderExtent(), frameViewProj);
+                         gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_HIZ);
+                     })
+            .read(graphSceneDepth, RenderAccess::ComputeSampled)
+            .write(graphDepthPyramid, RenderAccess::ComputeStorage);
+    }
+
+    // Reflections on the wet road, traced from the finished frame for the next one to read; the pass is
+    // enabled while the road is wet. Both images are written: the trace reads one as history in GENERAL
+    if (depthSampleable) {
+        reflectionPass = renderGraph
+                             .addPass("reflections", RenderQueue::Graphics,
+                                      [this](VkCommandBuffer cmd, uint32_t frameIndex) {
+                                          gpuProfiler.beginSection(cmd, frameIndex, GPU_SECTION_REFLECTIONS);
+                                          wetReflections.record(cmd);
+                                          gpuProfiler.endSection(cmd, frameIndex, GPU_SECTION_REFLECTIONS);
+                                      })
+                             .read(graphSceneDepth, RenderAccess::ComputeSampled)
+                             .read(graphSceneColor, RenderAccess::ComputeSampled)
+                             .write(graphReflectionDepth, RenderAccess::ComputeStorage)
+                             .write(graphReflections[0], RenderAccess::ComputeStorage)
+                             .write(graphReflections[1], RenderAccess::ComputeStorage)
+                             .id();
+    } else {
+        DP_LOG(Info, "Wet road reflections disabled (needs a sampleable depth format)");
+    }
+
+    // The offscreen stand-in stays readable as a copy source, as the render pass used to leave it
+    renderGraph.setFinalAccess(graphBackbuffer,
+                               swapChainManager.isOffscreen() ? RenderAccess::TransferSrc : RenderAccess::Present);
 
-    ResourceManager::createImage(vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
-                                 swapChainManager.getExtent().width, swapChainManager.getExtent().height, depthFormat,
-                                 VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory);
-
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image                           = depthImage;
-    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format                          = depthFormat;
-    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT;
-    viewInfo.subresourceRange.baseMipLevel   = 0;
-    viewInfo.subresourceRange.levelCount     = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount     = 1;
-
-    if (vkCreateImageView(vulkanContext.getDevice(), &viewInfo, nullptr, &depthImageView) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create depth image view!");
+    renderGraph.compile();
+    depthImageView = renderGraph.getImageView(graphSceneDepth);
+}
+
+void Application::bindRenderGraphResources() {
+    renderGraph.setImage(graphSceneColor, dynamicResolution.getColorImage());
+    renderGraph.setImage(graphMirrorColor, mirrorRenderer.getColorImage());
+    for (uint32_t slot = 0; slot < framesInFlight; slot++) {
+        renderGraph.setImage(renderGraph.frameResource(graphRainMap, slot), rainOcclusion.getImage(slot));
+        renderGraph.setBuffer(renderGraph.frameResource(graphRainDrops, slot), weatherSystem.getDropBuffer(slot));
     }
+    renderGraph.setBuffer(graphRainState, weatherSystem.getStateBuffer());
+    renderGraph.setBuffer(graphLightClusters, clusteredLights.getClusterBuffer());
+    renderGraph.setImage(graphDepthPyramid, occlusionCuller.getPyramidImage());
+    renderGraph.setImage(graphWindshieldState[0], windshield.getStateImage(0));
+    renderGraph.setImage(graphWindshieldState[1], windshield.getStateImage(1));
+    renderGraph.setBuffer(graphWindshieldDroplets, windshield.getDropletBuffer());
+    renderGraph.setImage(graphReflectionDepth, wetReflections.getDepthImage());
+    renderGraph.setImage(graphReflections[0], wetReflections.getColorImage(0));
+    renderGraph.setImage(graphReflections[1], wetReflections.getColorImage(1));
+    renderGraph.setImage(graphUpscaleHistory[0], temporalUpscaler.getHistoryImage(0));
+    renderGraph.setImage(graphUpscaleHistory[1], temporalUpscaler.getHistoryImage(1));
 }
 
-void Application::createWorldPipeline() {
+void Application::createWorldPipeline(std::vector<PipelineRequest>& batch) {
     // Create pipeline layout
     worldPipelineLayout = PipelineFactory::createPipelineLayout(vulkanContext.getDevice(), {descriptorSetLayout});
 
-    // Create pipeline
+    // Queue pipelines; both formats share the world shaders
     PipelineConfig config;
-    config.vertShader = "world.vert.spv";
-    config.fragShader = "world.frag.spv";
-    config.layout     = worldPipelineLayout;
-    config.cullMode   = VK_CULL_MODE_NONE;
+    config.vertShader   = "world.vert.spv";
+    config.fragShader   = "world.frag.spv";
+    config.layout       = worldPipelineLayout;
+    config.cullMode     = VK_CULL_MODE_NONE;
+    config.motionTarget = true;
+
+    batch.push_back({config, swapChainManager.getRenderPass(), &worldPipeline});
 
-    worldPipeline = PipelineFactory::createPipeline(vulkanContext.getDevice(), config, swapChainManager.getRenderPass(),
-                                                    swapChainManager.getExtent());
+    config.vertexFormat = VertexFormat::Packed;
+    batch.push_back({config, swapChainManager.getRenderPass(), &worldPackedPipeline});
+}
+
+void Application::loadAssets() {
+    DP_PROFILE_SCOPE("Application::loadAssets");
+
+    // parse -> materials (decode + upload, one job per material) -> build scene, per model.
+    // The car and road chains overlap; only the scene builds are ordered, since
+    // SceneManager is single-threaded and the road entity joins the car's scene.
+    JobSystem& jobs = JobSystem::get();
+
+    JobHandle roadParsed = jobs.schedule([this] { loadRoadModel(); });
+    JobHandle carParsed  = jobs.schedule([this] { loadCarModel(); });
+
+    JobHandle roadMaterials =
+        jobs.schedule([this] { createModelMaterials(*roadModelPtr, roadMaterialIds); }, {roadParsed});
+    JobHandle carMaterials = jobs.schedule([this] { createModelMaterials(*carModelPtr, carMaterialIds); }, {carParsed});
+
+    JobHandle carScene  = jobs.schedule([this] { buildCarScene(); }, {carMaterials});
+    JobHandle roadScene = jobs.schedule([this] { buildRoadScene(); }, {roadMaterials, carScene});
+
+    // Rethrows the first loading failure; the main thread runs jobs while it waits
+    jobs.waitAll({carScene, roadScene});
+}
+
+void Application::createModelMaterials(const Model& model, std::unordered_map<size_t, uint32_t>& outIds) {
+    const auto& materials = model.getMaterials();
+
+    // Slots per material, since the ID map itself is not safe to fill concurrently
+    std::vector<uint32_t> ids(materials.size());
+    JobSystem::get().parallelFor(static_cast<uint32_t>(materials.size()), 1, [&](uint32_t i) {
+        ids[i] = materialManager->createMaterial(materials[i], materialManager->decodeTextures(materials[i]));
+    });
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        outIds[i] = ids[i];
+    }
 }
 
 void Application::loadCarModel() {
+    DP_PROFILE_SCOPE("Application::loadCarModel");
+
     // NEW: Use ModelAdapter for data-driven loading
     carAdapter = new ModelAdapter();
-    if (!carAdapter->load("assets/models/bmw/bmw.gltf", vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
-                          commandPool, vulkanContext.getGraphicsQueue())) {
+    if (!carAdapter->load("assets/models/bmw/bmw.gltf", vulkanContext.getDevice(), vulkanContext.getPhysicalDevice())) {
         throw std::runtime_error("Failed to load car model via adapter");
     }
     carModelPtr = carAdapter->getModel();
+}
+
+void Application::buildCarScene() {
+    DP_PROFILE_SCOPE("Application::buildCarScene");
 
     // Get hierarchy-aware dimensions for accurate scaling
     glm::vec3 hMin, hMax;
@@ -755,17 +2445,11 @@ void Application::loadCarModel() {
         cockpitOffset    = glm::vec3(suggestedX, suggestedY, suggestedZ);
     }
 
-    // Load GPU resources for car materials
-    const auto& carMaterials = carModelPtr->getMaterials();
-    for (size_t i = 0; i < carMaterials.size(); i++) {
-        uint32_t gpuId    = materialManager->createMaterial(carMaterials[i]);
-        carMaterialIds[i] = gpuId;
-    }
-
     // NEW: Build scene from hierarchy
     Scene* drivingScene = sceneManager.createScene("driving");
 
-    std::vector<NodeHandle> carRootNodes = SceneBuilder::buildFromModel(drivingScene, carModelPtr, carMaterialIds);
+    // Restored from the adapter's scene snapshot when the car and its sidecar are unchanged
+    std::vector<NodeHandle> carRootNodes = carAdapter->buildScene(drivingScene, carMaterialIds);
 
     // NEW: Create entity for player car with a WRAPPER ROOT
     // This ensures all glTF roots get the same transform when we move/scale the car
@@ -788,12 +2472,9 @@ void Application::loadCarModel() {
     // NEW: Find and tag specific parts for animation using ADAPTER ROLES
 
     auto tagRole = [&](const std::string& role) {
-        std::string nodeName = carAdapter->getNodeNameForRole(role);
-        if (!nodeName.empty()) {
-            if (auto node = drivingScene->findNode(nodeName); node.isValid()) {
-                playerCar->addNode(node, role);
-                return true;
-            }
+        if (NodeHandle node = carAdapter->getRoleNode(role); node.isValid()) {
+            playerCar->addNode(node, role);
+            return true;
         }
         return false;
     };
@@ -823,6 +2504,18 @@ void Application::loadCarModel() {
     tagRole(CarEntity::ROLE_HEADLIGHTS);
     tagRole(CarEntity::ROLE_TAILLIGHTS);
 
+    // Wheels and steering are posed by CarAnimationSystem, like any other car
+    CarAnimation animation;
+    animation.wheels = {playerCar->getPartNode(CarEntity::Part::WheelFL),
+                        playerCar->getPartNode(CarEntity::Part::WheelFR),
+                        playerCar->getPartNode(CarEntity::Part::WheelRL),
+                        playerCar->getPartNode(CarEntity::Part::WheelRR)};
+    if (carParts.hasSteeringWheelFront && carParts.hasSteeringWheelBack) {
+        animation.steering = {playerCar->getSteeringWheelFrontNode(), playerCar->getSteeringWheelBackNode()};
+    }
+    playerCarId = drivingScene->getRegistry().create();
+    drivingScene->getRegistry().add(playerCarId, animation);
+
     // Apply physics configuration from adapter if available
     const auto& phys = carAdapter->getPhysicsConfig();
     if (phys.wheelBase > 0.0f) {
@@ -842,11 +2535,25 @@ void Application::loadCarModel() {
     // Apply spawn configuration
     const auto& spawn = carAdapter->getSpawnConfig();
     if (spawn.hasData) {
-        carPosition = glm::vec3(spawn.position.x, spawn.position.y, spawn.position.z);
+        vehicle.position = glm::vec3(spawn.position.x, spawn.position.y, spawn.position.z);
         // Map Y rotation (assuming Y-up world)
-        carRotation = spawn.rotation.y;
+        vehicle.rotation = spawn.rotation.y;
     }
 
+    // The player drives one lane of the vehicle batch, with the car's physical parameters
+    const CarEntity::Config& carPhysics = playerCar->getConfig();
+    Simulation::VehicleParams playerParams;
+    playerParams.wheelBase         = carPhysics.wheelBase;
+    playerParams.wheelRadius       = carPhysics.wheelRadius;
+    playerParams.maxSteerAngle     = carPhysics.maxSteerAngle;
+    playerParams.maxAcceleration   = carPhysics.maxAcceleration;
+    playerParams.maxBraking        = carPhysics.maxBraking;
+    playerParams.mass              = carPhysics.mass;
+    playerParams.dragCoefficient   = carPhysics.dragCoefficient;
+    playerParams.rollingResistance = carPhysics.rollingResistance;
+    vehicles.clear();
+    playerLane = vehicles.add(playerParams, vehicle.position, vehicle.rotation);
+
     // Apply debug configuration
     const auto& dbg = carAdapter->getDebugConfig();
     if (dbg.hasData) {
@@ -899,9 +2606,10 @@ void Application::loadCarModel() {
 }
 
 void Application::loadRoadModel() {
+    DP_PROFILE_SCOPE("Application::loadRoadModel");
+
     roadAdapter = new ModelAdapter();
-    if (!roadAdapter->load("assets/models/road.glb", vulkanContext.getDevice(), vulkanContext.getPhysicalDevice(),
-                           commandPool, vulkanContext.getGraphicsQueue())) {
+    if (!roadAdapter->load("assets/models/road.glb", vulkanContext.getDevice(), vulkanContext.getPhysicalDevice())) {
         throw std::runtime_error("Failed to load road model via adapter");
     }
     roadModelPtr = roadAdapter->getModel();
@@ -919,16 +2627,20 @@ void Application::loadRoadModel() {
     // For now, assume road.glb is already at correct scale
     roadModelPtr->setModelMatrix(roadTransform);
 
-    // Load GPU resources for road materials
-    const auto& roadMaterials = roadModelPtr->getMaterials();
-    for (size_t i = 0; i < roadMaterials.size(); i++) {
-        uint32_t gpuId     = materialManager->createMaterial(roadMaterials[i]);
-        roadMaterialIds[i] = gpuId;
+    // A tiled road uploads nothing up front; tiles stream in around the car
+    if (roadModelPtr->isTiled()) {
+        roadStreamer.init(*roadModelPtr, roadAdapter->getStreamingConfig(), framesInFlight, vulkanContext.getDevice(),
+                          vulkanContext.getPhysicalDevice());
     }
+}
+
+void Application::buildRoadScene() {
+    // One object slot per road material; scene objects start after them
+    roadObjectCount = std::max<uint32_t>(1, static_cast<uint32_t>(roadModelPtr->getMaterialCount()));
 
     // Create RoadEntity
     // Note: We don't store a pointer in Application class yet, but it's managed by SceneManager
-    // We assume 'driving' scene exists since loadCarModel usually runs first or around same time
+    // The 'driving' scene exists: loadAssets() orders this after buildCarScene()
     if (sceneManager.getScene("driving")) {
         RoadEntity* roadEntity = sceneManager.createEntity<RoadEntity>("road", "driving");
         // We could attach the road model nodes here if we had them as SceneNodes
@@ -936,7 +2648,53 @@ void Application::loadRoadModel() {
     }
 }
 
-void Application::createCarPipeline() {
+void Application::createCarPipeline(std::vector<PipelineRequest>& batch) {
+    const bool bindless = materialManager->isBindless();
+
+    // Pipeline layout with both descriptor sets; the model matrix comes from the object SSBO in set 0
+    std::vector<VkDescriptorSetLayout> layouts = {descriptorSetLayout, createCarMaterialLayout()};
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+    pipelineLayoutInfo.pSetLayouts    = layouts.data();
+
+    if (vkCreatePipelineLayout(vulkanContext.getDevice(), &pipelineLayoutInfo, nullptr, &carPipelineLayout) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("Failed to create car pipeline layout");
+    }
+
+    PipelineConfig config;
+    config.vertShader   = "car.vert.spv";
+    config.fragShader   = bindless ? "car_bindless.frag.spv" : "car.frag.spv";
+    config.layout       = carPipelineLayout;
+    config.cullMode     = VK_CULL_MODE_NONE;
+    config.motionTarget = true;
+
+    // Per-material variants derive from the same config
+    materialManager->initPipelineVariants(config, swapChainManager.getRenderPass(), pipelineCache.get());
+
+    // Same shading for the mirrors, through the multiview pass
+    if (mirrorRenderer.isEnabled()) {
+        mirrorRenderer.queueScenePipelines(config, batch);
+    }
+
+    // These two draw only the road, which blends in its wet reflections (IS_ROAD, constant_id 4)
+    PipelineConfig roadConfig          = config;
+    roadConfig.specializationConstants = {VK_FALSE, VK_FALSE, VK_FALSE, VK_FALSE, VK_TRUE};
+    static_assert(MATERIAL_FEATURE_COUNT == 4, "IS_ROAD follows the material feature constants");
+
+    batch.push_back({roadConfig, swapChainManager.getRenderPass(), &carPipeline});
+    roadConfig.vertexFormat = VertexFormat::Packed;
+    batch.push_back({roadConfig, swapChainManager.getRenderPass(), &carPackedPipeline});
+}
+
+VkDescriptorSetLayout Application::createCarMaterialLayout() {
+    // Bindless mode: MaterialManager owns the layout (material buffer + texture array)
+    if (materialManager->isBindless()) {
+        return materialManager->getBindlessLayout();
+    }
+
     // Create descriptor set layout for texture
     VkDescriptorSetLayoutBinding samplerLayoutBinding{};
     samplerLayoutBinding.binding         = 0;
@@ -953,55 +2711,30 @@ void Application::createCarPipeline() {
         VK_SUCCESS) {
         throw std::runtime_error("Failed to create car descriptor set layout");
     }
+    return carDescriptorSetLayout;
+}
 
-    // Push constants for model matrix
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    pushConstantRange.offset     = 0;
-    pushConstantRange.size       = sizeof(glm::mat4);
-
-    // Pipeline layout with both descriptor sets
-    std::vector<VkDescriptorSetLayout> layouts = {descriptorSetLayout, carDescriptorSetLayout};
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount         = static_cast<uint32_t>(layouts.size());
-    pipelineLayoutInfo.pSetLayouts            = layouts.data();
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges    = &pushConstantRange;
-
-    if (vkCreatePipelineLayout(vulkanContext.getDevice(), &pipelineLayoutInfo, nullptr, &carPipelineLayout) !=
-        VK_SUCCESS) {
-        throw std::runtime_error("Failed to create car pipeline layout");
-    }
-
-    PipelineConfig config;
-    config.vertShader = "car.vert.spv";
-    config.fragShader = "car.frag.spv";
-    config.layout     = carPipelineLayout;
-    config.cullMode   = VK_CULL_MODE_NONE;
+VkPipeline Application::selectCarPipeline(const Model& model) const {
+    return model.getVertexFormat() == VertexFormat::Packed ? carPackedPipeline : carPipeline;
+}
 
-    carPipeline = PipelineFactory::createPipeline(vulkanContext.getDevice(), config, swapChainManager.getRenderPass(),
-                                                  swapChainManager.getExtent());
+void Application::writeObject(ObjectData& object, const glm::mat4& transform, uint32_t materialIndex,
+                              const Model& model) {
+    writeObject(object, transform, transform, materialIndex, model);
 }
 
-void Application::createCarTransparentPipeline() {
-    PipelineConfig config;
-    config.vertShader       = "car.vert.spv";
-    config.fragShader       = "car.frag.spv";
-    config.layout           = carPipelineLayout;  // Reuse existing layout
-    config.cullMode         = VK_CULL_MODE_NONE;
-    config.enableBlending   = true;
-    config.enableDepthWrite = false;
-
-    carTransparentPipeline = PipelineFactory::createPipeline(
-        vulkanContext.getDevice(), config, swapChainManager.getRenderPass(), swapChainManager.getExtent());
+void Application::writeObject(ObjectData& object, const glm::mat4& transform, const glm::mat4& previousTransform,
+                              uint32_t materialIndex, const Model& model) {
+    object.model         = transform;
+    object.previousModel = previousTransform;
+    object.materialIndex = materialIndex;
+    model.getDequantization(object.dequantOffset, object.dequantScale);
 }
 
 void Application::createCarDescriptorSets() {
     const auto& materials = carModelPtr->getMaterials();
-    if (materials.empty()) {
-        return;
+    if (materials.empty() || materialManager->isBindless()) {
+        return;  // Bindless materials share MaterialManager's single set
     }
 
     // Create descriptor pool for ALL materials (road + car) * frames
@@ -1011,13 +2744,13 @@ void Application::createCarDescriptorSets() {
 
     VkDescriptorPoolSize poolSize{};
     poolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = totalMaterials * MAX_FRAMES_IN_FLIGHT;
+    poolSize.descriptorCount = totalMaterials * framesInFlight;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = 1;
     poolInfo.pPoolSizes    = &poolSize;
-    poolInfo.maxSets       = totalMaterials * MAX_FRAMES_IN_FLIGHT;
+    poolInfo.maxSets       = totalMaterials * framesInFlight;
 
     if (vkCreateDescriptorPool(vulkanContext.getDevice(), &poolInfo, nullptr, &carDescriptorPool) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create car descriptor pool");
@@ -1025,52 +2758,60 @@ void Application::createCarDescriptorSets() {
 
     // Initialize MaterialManager descriptor support
     // MaterialManager will use these to create descriptor sets for materials
-    materialManager->initDescriptorSupport(carDescriptorSetLayout, carDescriptorPool, MAX_FRAMES_IN_FLIGHT);
+    materialManager->initDescriptorSupport(carDescriptorSetLayout, carDescriptorPool, framesInFlight);
 
     // Create descriptor sets for materials that were loaded before descriptor support was initialized
     materialManager->createDescriptorSetsForExistingMaterials();
 }
 
-void Application::updateCarPhysics(float deltaTime) {
-    // Simple driving controls
-    const float acceleration = 5.0f;   // m/s^2
-    const float deceleration = 8.0f;   // m/s^2 (braking)
-    const float maxSpeed     = 15.0f;  // m/s (about 54 km/h)
-    const float friction     = 2.0f;   // m/s^2
-
-    // Forward/backward controls
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
-        carVelocity += acceleration * deltaTime;
-    }
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
-        carVelocity -= deceleration * deltaTime;
-    }
-
-    // Apply friction when no input
-    if (glfwGetKey(window, GLFW_KEY_UP) != GLFW_PRESS && glfwGetKey(window, GLFW_KEY_W) != GLFW_PRESS &&
-        glfwGetKey(window, GLFW_KEY_DOWN) != GLFW_PRESS && glfwGetKey(window, GLFW_KEY_S) != GLFW_PRESS) {
-        if (carVelocity > 0) {
-            carVelocity -= friction * deltaTime;
-            if (carVelocity < 0)
-                carVelocity = 0;
-        } else if (carVelocity < 0) {
-            carVelocity += friction * deltaTime;
-            if (carVelocity > 0)
-                carVelocity = 0;
-        }
-    }
-
-    // Clamp velocity
-    carVelocity = glm::clamp(carVelocity, -maxSpeed * 0.5f, maxSpeed);
+void Application::startSimulation() {
+    Simulation::SimulationSnapshot initial;
+    initial.vehicle = vehicle;
+
+    // Recordings start from a known weather seed; replays step at their recorded rate from theirs
+    weatherSystem.reseed(inputRecording.getSeed());
+    const double rate = replaying ? inputRecording.getRate() : Simulation::SimulationThread::DEFAULT_RATE;
+
+    // Runs on the simulation thread with worldMutex() held
+    simulation.start(
+        initial,
+        [this](float deltaTime, const Simulation::VehicleInput& input, Simulation::SimulationSnapshot& state) {
+            if (replaying) {
+                if (state.step == inputRecording.size())
+                    DP_LOG(Info, "Replay finished after %zu steps", inputRecording.size());
+                stepWorld(deltaTime, inputRecording.at(state.step), state);
+                return;
+            }
+            if (!recordPath.empty())
+                inputRecording.append(input);
+            stepWorld(deltaTime, input, state);
+        },
+        rate);
+}
 
-    // Update car position (move along Z axis, which is forward)
-    carPosition.z += carVelocity * deltaTime;
+void Application::stepWorld(float deltaTime, const Simulation::VehicleInput& input,
+                            Simulation::SimulationSnapshot& state) {
+    // Player input goes into its lane; any other vehicles in the batch step with it
+    state.vehicle.writeLane(input, deltaTime, vehicles, playerLane);
+    vehicles.step(deltaTime);
+    state.vehicle.readLane(vehicles, playerLane);
+
+    if (input.raining != weatherSystem.isRaining())
+        weatherSystem.toggleWeather();
+    weatherSystem.update(deltaTime);
+
+    // Update windshield with rain data
+    windshield.setWiperActive(input.wipers);
+    windshield.setVehicleSpeed(state.vehicle.velocity);
+    windshield.update(deltaTime, weatherSystem.getActiveDrops());
+}
 
+void Application::applyVehicleState(float deltaTime) {
     // NEW: Update scene entity transform
     if (playerCar) {
         // Apply vertical offset relative to the rotation correction
         // The car model has an internal offset that we dynamically calculated
-        glm::vec3 visualPosition = carPosition;
+        glm::vec3 visualPosition = vehicle.position;
         visualPosition.y -= carBottomOffset;
 
         playerCar->setPosition(visualPosition);
@@ -1078,70 +2819,32 @@ void Application::updateCarPhysics(float deltaTime) {
         // Combine rotations: Model orientation fix + Y-axis (steering)
         glm::vec3 modelRot = carAdapter ? carAdapter->getModelRotation() : glm::vec3(glm::radians(90.0f), 0.0f, 0.0f);
         glm::quat fixRotation      = glm::quat(glm::vec3(modelRot.x, modelRot.y, modelRot.z));
-        glm::quat yRotation        = glm::angleAxis(glm::radians(carRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::quat yRotation        = glm::angleAxis(glm::radians(vehicle.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
         glm::quat combinedRotation = yRotation * fixRotation;  // Apply fix rotation first, then steering
 
         playerCar->setRotation(combinedRotation);
         playerCar->setScale(glm::vec3(1));
 
-        // Animate wheels based on velocity
-        static float wheelRotationAccum = 0.0f;
-        wheelRotationAccum += carVelocity * deltaTime * 10.0f;  // Adjust multiplier for visual appearance
-        glm::quat wheelRot = glm::angleAxis(wheelRotationAccum, glm::vec3(1.0f, 0.0f, 0.0f));
-
-        playerCar->animateRotation("wheel_FL", wheelRot);
-        playerCar->animateRotation("wheel_FR", wheelRot);
-        playerCar->animateRotation("wheel_RL", wheelRot);
-        playerCar->animateRotation("wheel_RR", wheelRot);
-    }
-
-    // Update steering wheel rotation based on A/D keys
-    if (carParts.hasSteeringWheelFront && carParts.hasSteeringWheelBack) {
-        const float maxSteeringAngle = 450.0f;  // degrees (1.25 full rotations)
-        const float steeringSpeed    = 180.0f;  // degrees per second
-        const float returnSpeed      = 360.0f;  // degrees per second
-
-        bool turningLeft =
-            (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS);
-        bool turningRight =
-            (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS);
-
-        if (turningLeft && !turningRight) {
-            steeringWheelRotation += steeringSpeed * deltaTime;
-            steeringWheelRotation = glm::min(steeringWheelRotation, maxSteeringAngle);
-        } else if (turningRight && !turningLeft) {
-            steeringWheelRotation -= steeringSpeed * deltaTime;
-            steeringWheelRotation = glm::max(steeringWheelRotation, -maxSteeringAngle);
-        } else {
-            // Return to center when no input
-            if (steeringWheelRotation > 0.0f) {
-                steeringWheelRotation -= returnSpeed * deltaTime;
-                if (steeringWheelRotation < 0.0f)
-                    steeringWheelRotation = 0.0f;
-            } else if (steeringWheelRotation < 0.0f) {
-                steeringWheelRotation += returnSpeed * deltaTime;
-                if (steeringWheelRotation > 0.0f)
-                    steeringWheelRotation = 0.0f;
-            }
-        }
-
-        // NEW: Animate steering wheel in scene entity
-        if (playerCar) {
-            // Steering wheel rotates around Z axis
-            glm::quat steeringRot = glm::angleAxis(glm::radians(steeringWheelRotation), glm::vec3(0.0f, 0.0f, 1.0f));
-            playerCar->animateRotation("steering_wheel_front", steeringRot);
-            playerCar->animateRotation("steering_wheel_back", steeringRot);
+        // Wheels turn with distance travelled, the steering wheel around Z; posed in sceneManager.update()
+        Scene* drivingScene = playerCar->getScene();
+        if (CarAnimation* animation = drivingScene->getRegistry().get<CarAnimation>(playerCarId)) {
+            animation->wheelRotation = vehicle.wheelRotation;
+            animation->steeringAngle = vehicle.steeringWheelRotation;
         }
     }
 
     // Update scene manager
     sceneManager.update(deltaTime);
 
+    // Prefetch the road ahead of the car
+    if (roadStreamer.isActive()) {
+        roadStreamer.update(vehicle.position, vehicle.forward() * vehicle.velocity);
+    }
+
     // DEBUG: Log car internal state
-    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
-        Log logger;
-        logger.log("debug", "CarPos: (" + std::to_string(carPosition.x) + ", " + std::to_string(carPosition.y) + ", " +
-                                std::to_string(carPosition.z) + ") | BottomOffset: " + std::to_string(carBottomOffset));
+    if (window && glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+        DP_LOG(Debug, "CarPos: (%.3f, %.3f, %.3f) | BottomOffset: %.3f", vehicle.position.x, vehicle.position.y,
+               vehicle.position.z, carBottomOffset);
     }
 }
 
@@ -1150,7 +2853,7 @@ void Application::updateCameraForCockpit() {
     // The CameraEntity automatically follows the car through the scene graph
     if (!cameraEntity || !playerCar) {
         // Fallback to old system if camera entity not initialized
-        glm::quat yRotation = glm::angleAxis(glm::radians(carRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::quat yRotation = glm::angleAxis(glm::radians(vehicle.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
 
         glm::vec3 finalOffset;
         glm::quat finalCamRot;
@@ -1164,14 +2867,14 @@ void Application::updateCameraForCockpit() {
             } else {
                 finalCamRot = yRotation * glm::quat(glm::radians(cockpit.eulerRotation));
             }
-            camera.setCameraTarget(carPosition + finalOffset, finalCamRot);
+            camera.setCameraTarget(vehicle.position + finalOffset, finalCamRot);
         } else {
             glm::mat4 rotationMatrix = glm::mat4(1.0f);
-            rotationMatrix = glm::rotate(rotationMatrix, glm::radians(carRotation), glm::vec3(0.0f, 1.0f, 0.0f));
+            rotationMatrix = glm::rotate(rotationMatrix, glm::radians(vehicle.rotation), glm::vec3(0.0f, 1.0f, 0.0f));
             rotationMatrix = glm::rotate(rotationMatrix, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 
             glm::vec3 rotatedOffset = glm::vec3(rotationMatrix * glm::vec4(cockpitOffset, 0.0f));
-            camera.setPosition(carPosition + rotatedOffset);
+            camera.setPosition(vehicle.position + rotatedOffset);
             camera.setYaw(0.0f);
             camera.setPitch(0.0f);
         }
@@ -1184,10 +2887,8 @@ void Application::updateCameraForCockpit() {
     glm::quat worldRot = cameraEntity->getWorldRotation();
 
     // DEBUG: Log camera entity world position
-    if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
-        Log logger;
-        logger.log("debug", "CameraEntity WorldPos: (" + std::to_string(worldPos.x) + ", " +
-                                std::to_string(worldPos.y) + ", " + std::to_string(worldPos.z) + ")");
+    if (window && glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) {
+        DP_LOG(Debug, "CameraEntity WorldPos: (%.3f, %.3f, %.3f)", worldPos.x, worldPos.y, worldPos.z);
     }
 
     // Ensure the Camera class's internal cockpitOffset doesn't double-offset
@@ -1,44 +1,172 @@
 #pragma once
 
 #define GLFW_INCLUDE_VULKAN
+#include "core/FrameAllocator.h"
+#include "core/FrameArena.h"
+#include "core/FramePacer.h"
+#include "core/GpuProfiler.h"
+#include "core/PipelineCache.h"
 #include "core/PipelineFactory.h"
+#include "core/RenderGraph.h"
 #include "core/ResourceManager.h"
 #include "core/SwapChainManager.h"
+#include "core/TelemetryPublisher.h"
+#include "core/UploadManager.h"
 #include "core/VulkanContext.h"
 #include "renderer/Camera.h"
+#include "renderer/ClusteredLights.h"
+#include "renderer/DynamicResolution.h"
 #include "renderer/Material.h"
+#include "renderer/MirrorRenderer.h"
 #include "renderer/ModelAdapter.h"
+#include "renderer/OITCompositor.h"
+#include "renderer/OcclusionCuller.h"
+#include "renderer/RainOcclusionMap.h"
+#include "renderer/ShadowCascades.h"
+#include "renderer/TemporalUpscaler.h"
+#include "renderer/WorldStreamer.h"
 #include "renderer/Vertex.h"
+#include "renderer/WetRoadReflections.h"
 #include "scene/CameraEntity.h"
+#include "scene/CarAnimationSystem.h"
 #include "scene/CarEntity.h"
 #include "scene/Entity.h"
+#include "scene/Frustum.h"
 #include "scene/RoadEntity.h"
 #include "scene/Scene.h"
 #include "scene/SceneBuilder.h"
 #include "scene/SceneManager.h"
+#include "simulation/InputRecording.h"
+#include "simulation/SimulationThread.h"
+#include "simulation/VehicleDynamics.h"
 #include "simulation/WeatherSystem.h"
 #include "simulation/WindshieldSurface.h"
 #include "vulkan/VulkanTypes.h"
 
 #include <GLFW/glfw3.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace DownPour {
 
+/**
+ * @brief Sun and shadow cascade data the scene fragment shaders read after the view matrices
+ *
+ * Layout matches the tail of the CameraUBO block in car.frag, car_bindless.frag and world.frag.
+ */
+struct ShadowUBO {
+    alignas(16) glm::mat4 cascadeViewProj[ShadowCascades::CASCADE_COUNT];
+    alignas(16) glm::vec4 cascadeRadii;    // xyz: ShadowCascades::CASCADE_RADII
+    alignas(16) glm::vec4 cascadeTexels;   // xyz: world size of a texel per cascade, for the normal offset
+    alignas(16) glm::vec4 sunDirection;    // xyz: toward the sun
+    alignas(16) glm::vec4 cameraPosition;  // xyz: the cascades are centered here
+};
+static_assert(ShadowCascades::CASCADE_COUNT <= 4, "Cascade radii and texel sizes are packed into vec4s");
+
+/**
+ * @brief Where the scene fragment shaders find the wet road's reflections (WetRoadReflections), after the shadows
+ */
+struct ReflectionUBO {
+    alignas(16) glm::mat4 viewProj;  // The view the reflections were traced from
+    alignas(16) glm::vec4 region;    // xy: texels of the reflection images the trace covered
+    alignas(16) glm::vec4 params;    // x: wetness, 0 when there is nothing to read; y: image index; zw: depth params
+};
+
+/**
+ * @brief The views motion vectors are measured between (car.vert, world.vert, basic.vert), after the reflections
+ *
+ * Neither carries the temporal upscaler's jitter, so a surface that held still
+ * has no motion even though it is rasterized at a new sub-pixel offset.
+ */
+struct MotionUBO {
+    alignas(16) glm::mat4 viewProj;          // This frame's
+    alignas(16) glm::mat4 previousViewProj;  // Last frame's
+};
+
 /**
  * @brief Uniform Buffer Object structure for camera matrices
  *
  * This structure holds the view, projection, and combined
- * view-projection matrices for use in shaders.
+ * view-projection matrices for use in shaders, then the sun shadows,
+ * the wet road's reflections and the motion vectors' views.
  */
 
 struct CameraUBO {
     alignas(16) glm::mat4 view;
     alignas(16) glm::mat4 proj;
     alignas(16) glm::mat4 viewProj;
+    ShadowUBO             shadows;
+    ReflectionUBO         reflections;
+    MotionUBO             motion;
+};
+
+/**
+ * @brief Mirror view-projections for mirror.vert, indexed by gl_ViewIndex
+ *
+ * Bound through the camera UBO binding, so it must fit that binding's range. The
+ * scene fragment shaders read the shadows at the same offset as in a CameraUBO.
+ */
+struct MirrorUBO {
+    alignas(16) glm::mat4 viewProj[MirrorRenderer::MAX_VIEWS];
+    ShadowUBO             shadows;
+};
+static_assert(sizeof(MirrorUBO) <= sizeof(CameraUBO), "MirrorUBO must fit the camera UBO binding");
+static_assert(offsetof(MirrorUBO, shadows) == offsetof(CameraUBO, shadows), "Mirror shadows must match the camera's");
+
+/**
+ * @brief Per-draw object data stored in the scene object SSBO
+ *
+ * Indexed in car.vert and world.vert by gl_InstanceIndex (the indirect command's
+ * firstInstance). Layout matches the std430 ObjectData struct in the shaders.
+ * The dequantization pair comes from Model::getDequantization().
+ */
+struct ObjectData {
+    alignas(16) glm::mat4 model;
+    glm::vec4             dequantOffset;  // xyz: position offset, w: 1 = octahedral normals
+    glm::vec4             dequantScale;   // xyz: position scale
+    uint32_t              materialIndex;
+    uint32_t              padding[3];
+    alignas(16) glm::mat4 previousModel;  // Last frame's transform, for motion vectors
+};
+
+/**
+ * @brief Settings for a headless benchmark (Application::runBenchmark)
+ */
+struct BenchmarkConfig {
+    uint32_t frames       = 600;  // Measured frames per weather mode
+    uint32_t warmupFrames = 60;   // Rendered before measuring and discarded
+    uint32_t width        = 1280;
+    uint32_t height       = 720;
+    bool     rainOff      = true;
+    bool     rainOn       = true;
+
+    std::string replayPath;  // InputRecording to drive instead of the scripted loop; empty for the script
+};
+
+/**
+ * @brief CPU cost and submitted work of one benchmark frame
+ */
+struct BenchmarkFrame {
+    float    cpuMs     = 0.0f;  // Simulation step through submit, excluding the wait for a free frame slot
+    uint32_t drawCalls = 0;     // vkCmdDraw* calls; a multi-draw counts once
+    uint64_t triangles = 0;
+};
+
+/**
+ * @brief Results for one weather mode
+ *
+ * GPU times resolve a few frames late, so gpuMs holds fewer entries than
+ * frames; each is the sum of the GPU profiler's sections for one frame.
+ */
+struct BenchmarkRun {
+    bool                        raining = false;
+    std::vector<BenchmarkFrame> frames;
+    std::vector<float>          gpuMs;
 };
 
 /**
@@ -60,6 +188,50 @@ public:
      */
     void run();
 
+    /**
+     * @brief Choose how many frames the CPU may run ahead of the display; call before run()
+     * @param count 1 (lowest latency) to FramePacer::MAX_FRAMES_IN_FLIGHT (most throughput)
+     */
+    void setFramesInFlight(uint32_t count);
+
+    /**
+     * @brief GPU frame time (ms) the render scale is adjusted to hold; 0 always renders at the window size
+     */
+    void setTargetFrameTime(float ms);
+
+    /**
+     * @brief Stream material textures in behind placeholders, finest levels for the nearest draws; call before run()
+     */
+    void setTextureStreaming(bool enabled);
+
+    /**
+     * @brief Publish per-frame telemetry to shared memory for SystemMonitor (on by default); call before run()
+     */
+    void setTelemetry(bool enabled);
+
+    /**
+     * @brief Record every simulation step's input and save it to @p path when run() returns
+     */
+    void recordInput(const std::string& path);
+
+    /**
+     * @brief Drive run() from a file written by recordInput() instead of the keyboard; call before run()
+     *
+     * Steps at the recorded rate from the recorded weather seed, so the car and
+     * CPU rain follow the recorded run exactly. Throws if the file can't be read.
+     */
+    void replayInput(const std::string& path);
+
+    /**
+     * @brief Render offscreen along a scripted drive and return per-frame results; use instead of run()
+     *
+     * No window or swap chain is created. The simulation is stepped on the calling
+     * thread at a fixed 60 Hz, so every run drives the same path and sees the same rain.
+     * With config.replayPath set, frames advance 60 Hz worth of the recording's steps,
+     * so results before and after a change are rendered from identical frames.
+     */
+    std::vector<BenchmarkRun> runBenchmark(const BenchmarkConfig& config);
+
 private:
     // Window properties
     static constexpr uint32_t WIDTH  = 800;
@@ -74,12 +246,10 @@ private:
     bool   cursorCaptured = true;
     float  cameraRotation = 0.0f;
 
-    // Car driving state
-    glm::vec3 carPosition     = glm::vec3(0.0f, 2.0f, 2.0f);
-    float     carVelocity     = 0.0f;
-    float     carRotation     = -90.0f;
-    float     carScaleFactor  = 1.0f;
-    float     carBottomOffset = 0.0f;  // Dynamically calculated vertical offset
+    // Car driving state, interpolated from the simulation thread each frame
+    Simulation::VehicleState vehicle;
+    float                    carScaleFactor  = 1.0f;
+    float                    carBottomOffset = 0.0f;  // Dynamically calculated vertical offset
 
     /**
      * @brief Index ranges for specific car parts that need animation
@@ -94,31 +264,44 @@ private:
     };
 
     CarParts carParts;
-    float    steeringWheelRotation = 0.0f;  // Current steering wheel rotation in degrees
 
     // Simplified cockpit camera - hard-coded offset for initial implementation
     // Note: These values are in the MODEL'S local space BEFORE the 90° X rotation
     glm::vec3 cockpitOffset = glm::vec3(0.0f, -0.21f, -0.18f);  // X=0(center), Y=forward(neg), Z=up
 
     // Debug visualization (simplified)
-    bool           debugVisualizationEnabled = true;  // Toggle with 'V' key
-    VkBuffer       debugVertexBuffer         = VK_NULL_HANDLE;
-    VkDeviceMemory debugVertexBufferMemory   = VK_NULL_HANDLE;
-    uint32_t       debugVertexCount          = 0;
+    bool debugVisualizationEnabled = true;  // Toggle with 'V' key
 
     // Weather simulation system
     Simulation::WeatherSystem     weatherSystem;
     Simulation::WindshieldSurface windshield;
 
+    // Fixed-step car, weather and windshield simulation; weather and windshield are guarded by its worldMutex()
+    Simulation::SimulationThread simulation;
+
+    // Every simulated vehicle, stepped together; the player is `playerLane`. Simulation thread only once started
+    Simulation::VehicleBatch vehicles;
+    uint32_t                 playerLane = 0;
+
+    // Step inputs being recorded (recordPath) or replayed (replaying); simulation thread only once started
+    Simulation::InputRecording inputRecording;
+    std::string                recordPath;
+    bool                       replaying     = false;
+    bool                       rainRequested = false;  // Toggled with 'R'; the simulation follows it
+
     // Vulkan context (manages instance, device, surface, queues)
     VulkanContext vulkanContext;
 
     // Swap chain manager (manages swap chain, render pass, framebuffers)
     SwapChainManager swapChainManager;
 
-    // GLFW window
+    // GLFW window (nullptr when rendering headless)
     GLFWwindow* window = nullptr;
 
+    // Headless benchmark: offscreen targets replace the swap chain
+    bool       headless = false;
+    VkExtent2D offscreenExtent{WIDTH, HEIGHT};
+
     // Vulkan handles still managed by Application
     VkCommandPool                commandPool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> commandBuffers;
@@ -126,19 +309,69 @@ private:
     VkPipeline                   graphicsPipeline    = VK_NULL_HANDLE;
     VkDescriptorSetLayout        descriptorSetLayout = VK_NULL_HANDLE;
 
-    // Depth resources
-    VkImage        depthImage       = VK_NULL_HANDLE;
-    VkDeviceMemory depthImageMemory = VK_NULL_HANDLE;
-    VkImageView    depthImageView   = VK_NULL_HANDLE;
+    // Depth resources; the image is a render graph transient
+    VkImageView depthImageView  = VK_NULL_HANDLE;
+    bool        depthSampleable = false;  // Depth format supports sampling, so it can feed the Hi-Z pyramid
+
+    // Every GPU pass of a frame, in order, with the barriers between them derived from declared accesses.
+    // Imported resources are owned by their subsystems; the depth, OIT and shadow targets are transients
+    RenderGraph                   renderGraph;
+    RenderResource                graphBackbuffer    = 0;
+    RenderResource                graphSceneColor    = 0;
+    RenderResource                graphSceneDepth    = 0;
+    RenderResource                graphOitAccum      = 0;
+    RenderResource                graphOitRevealage  = 0;
+    RenderResource                graphMotion        = 0;
+    RenderResource                graphRainMap       = 0;  // Per frame slot
+    RenderResource                graphRainDrops     = 0;  // Per frame slot
+    RenderResource                graphRainState     = 0;
+    RenderResource                graphShadowMap     = 0;
+    RenderResource                graphLightClusters = 0;
+    RenderResource                graphMirrorColor   = 0;
+    RenderResource                graphDrawCommands  = 0;
+    RenderResource                graphDepthPyramid  = 0;
+    std::array<RenderResource, 2> graphWindshieldState{};
+    RenderResource                graphWindshieldDroplets = 0;
+    RenderResource                graphReflectionDepth    = 0;
+    std::array<RenderResource, 2> graphReflections{};
+    std::array<RenderResource, 2> graphUpscaleHistory{};
+    RenderPassId                  rainComputePass   = 0;
+    RenderPassId                  rainOcclusionPass = 0;
+    RenderPassId                  mirrorPass        = 0;
+    RenderPassId                  windshieldPass    = 0;
+    RenderPassId                  reflectionPass    = 0;
+
+    // Weighted blended OIT targets and their composite (transparent and composite subpasses)
+    OITCompositor oitCompositor;
+
+    // Scene color at a GPU-time-driven scale, reconstructed into the swap chain image after the render pass
+    static constexpr float DEFAULT_TARGET_FRAME_MS = 1000.0f / 60.0f;
+    DynamicResolution      dynamicResolution;
+    float                  targetFrameMs = DEFAULT_TARGET_FRAME_MS;
+    TemporalUpscaler       temporalUpscaler;
+
+    // Material textures load progressively, driven by last frame's draw distances (MaterialManager)
+    bool streamTextures = false;
+
+    // Rear-view and side mirrors in cockpit view; only created when the device supports multiview
+    static constexpr VkExtent2D MIRROR_LAYER_EXTENT = {384, 128};
+    MirrorRenderer              mirrorRenderer;
 
     // Pipelines
     VkPipeline       worldPipeline       = VK_NULL_HANDLE;
+    VkPipeline       worldPackedPipeline = VK_NULL_HANDLE;  // Same shaders, PackedVertex input
     VkPipelineLayout worldPipelineLayout = VK_NULL_HANDLE;
 
+    // Compiled pipeline state shared by every createPipeline call, kept across launches.
+    // Qualified: Types::PipelineCache (the raw VkPipelineCache alias) is visible here too.
+    static constexpr const char* PIPELINE_CACHE_PATH = "pipeline_cache.bin";
+    DownPour::PipelineCache      pipelineCache;
+
     // Scene system (NEW)
     SceneManager  sceneManager;
     CarEntity*    playerCar    = nullptr;
     CameraEntity* cameraEntity = nullptr;
+    EntityId      playerCarId;  // The player car's CarAnimation in the driving scene's registry
 
     // Models (Managed by Adapters)
     ModelAdapter* carAdapter  = nullptr;
@@ -148,6 +381,10 @@ private:
     Model* carModelPtr  = nullptr;
     Model* roadModelPtr = nullptr;
 
+    // Tiles of a tiled road (sidecar "streaming" block) resident around the car
+    WorldStreamer                    roadStreamer;
+    std::vector<WorldStreamer::Draw> roadDraws;  // Scratch for recordRoadPass()
+
     // Material management
     MaterialManager*                     materialManager = nullptr;
     std::unordered_map<size_t, uint32_t> carMaterialIds;
@@ -158,8 +395,9 @@ private:
     VkDescriptorSetLayout carDescriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorPool      carDescriptorPool      = VK_NULL_HANDLE;
 
-    // Transparent car pipeline (same layout as carPipeline)
-    VkPipeline carTransparentPipeline = VK_NULL_HANDLE;
+    // PackedVertex variant of carPipeline, for models loaded with VertexFormat::Packed. Scene draws
+    // use MaterialManager's per-feature variants instead; these draw the road
+    VkPipeline carPackedPipeline = VK_NULL_HANDLE;
 
     // Windshield rendering
     VkPipeline            windshieldPipeline         = VK_NULL_HANDLE;
@@ -169,15 +407,20 @@ private:
     // Initialization methods
     void           initWindow();
     void           initVulkan();
-    void           createGraphicsPipeline();
+    void           createGraphicsPipeline(std::vector<PipelineRequest>& batch);
     VkShaderModule createShaderModule(const std::vector<char>& code);
     void           recordCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex, uint32_t frameIndex);
+    void           setupRenderGraph();
+    void           bindRenderGraphResources();
+    void           recordMainPass(VkCommandBuffer cmd, uint32_t frameIndex);
     void           createCommandBuffers();
     void           createCommandPool();
     void           createSyncObjects();
     void           drawFrame();
     void           createDescriptorSetLayout();
-    void           createUniformBuffers();
+    void           createFrameAllocator();
+    void           createOcclusionCuller();
+    void           beginFrameAllocations();
     void           updateUniformBuffer(uint32_t currentImage);
 
     // Main loop and cleanup
@@ -189,45 +432,281 @@ private:
     static void                mouseCallback(GLFWwindow* window, double xpos, double ypos);
 
     // frame management
-    static constexpr int     MAX_FRAMES_IN_FLIGHT = 2;
-    size_t                   currentFrame         = 0;
+    uint32_t                 framesInFlight = 2;
+    size_t                   currentFrame   = 0;
+    FramePacer               framePacer;
     std::vector<VkFence>     inFlightFences;  // Update from single fence
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
 
-    // Uniform buffers
-    std::vector<VkBuffer>       uniformBuffers;
-    std::vector<VkDeviceMemory> uniformBuffersMemory;
-    std::vector<void*>          uniformBuffersMapped;
+    // Transient per-frame GPU data. The camera UBO, scene object SSBO and indirect draw commands are
+    // sub-allocated at the start of drawFrame() and reach the shaders through frameDescriptorSet's dynamic offsets
+    static constexpr VkDeviceSize FRAME_ALLOCATOR_CAPACITY = 2 * 1024 * 1024;  // Per frame in flight
+    FrameAllocator                frameAllocator;
+    FrameAllocation               frameCamera;           // CameraUBO
+    FrameAllocation               frameObjects;          // MAX_SCENE_OBJECTS ObjectData
+    FrameAllocation               frameCommands;         // MAX_SCENE_OBJECTS VkDrawIndexedIndirectCommand
+    FrameAllocation               frameCullBounds;       // MAX_SCENE_OBJECTS OcclusionBounds, one per command
+    FrameAllocation               frameMirrorCamera;     // MirrorUBO, padded to a CameraUBO
+    FrameAllocation               frameRainCamera;       // CameraUBO for the rain occlusion map
+    FrameAllocation               frameLights;           // ClusteredLights::LIGHT_BUFFER_SIZE: grid header and lights
+    FrameAllocation               frameReflectionTrace;  // ReflectionTraceParams
+
+    // CameraUBO per shadow cascade
+    std::array<FrameAllocation, ShadowCascades::CASCADE_COUNT> frameShadowCameras;
+
+    static constexpr uint32_t MAX_SCENE_OBJECTS = 4096;
+    static constexpr uint32_t ROAD_OBJECT_INDEX = 0;  // First slot reserved for the road (one per road material)
+    uint32_t                  roadObjectCount   = 1;
+
+    // CPU scratch for the frame being built on the main thread; reset at the start of drawFrame()
+    FrameArena frameArena;
+
+    // Allocation checks (DOWNPOUR_COUNT_ALLOCATIONS builds): frames after warm-up should not allocate
+    static constexpr uint64_t ALLOCATION_WARMUP_FRAMES = 120;
+    static constexpr uint64_t ALLOCATION_REPORT_FRAMES = 240;  // At most one warning per this many frames
+    uint64_t                  countedFrames            = 0;
+    uint64_t                  lastAllocationReport     = 0;
+
+    // Culling inputs for the frame being recorded
+    glm::mat4 frameViewProj      = glm::mat4(1.0f);
+    float     framePixelsPerUnit = 1.0f;     // For LOD selection: pixels per world unit at distance 1
+    Scene*    drawScene          = nullptr;  // Scene whose draw list was prepared for this frame
+    uint32_t  sceneDrawCount     = 0;        // Indirect commands recordSceneBatches wrote
+    uint32_t  sceneObjectCount   = 0;        // Object slots in use; passes after recordSceneBatches append to it
+
+    // Last frame's unjittered camera view, for the motion vectors
+    glm::mat4 previousViewProj      = glm::mat4(1.0f);
+    bool      previousViewProjValid = false;
+
+    // Views culled with the main one, as Scene::DrawItem::extraViewMask bits: the shadow cascades, then the
+    // mirrors. Mirrors are culled and drawn only on frames that update them
+    static constexpr uint32_t EXTRA_VIEW_SHADOW = 0;
+    static constexpr uint32_t EXTRA_VIEW_MIRROR = EXTRA_VIEW_SHADOW + ShadowCascades::CASCADE_COUNT;
+    static constexpr uint32_t EXTRA_VIEW_COUNT  = EXTRA_VIEW_MIRROR + MirrorRenderer::MAX_VIEWS;
+    static constexpr uint8_t  MIRROR_VIEW_MASK  = ((1u << MirrorRenderer::MAX_VIEWS) - 1) << EXTRA_VIEW_MIRROR;
+    static_assert(EXTRA_VIEW_COUNT <= Scene::MAX_EXTRA_VIEWS, "Shadow cascades and mirrors exceed the cull views");
+
+    std::array<glm::mat4, EXTRA_VIEW_COUNT> frameExtraViewProj{};
+    bool                                    mirrorsThisFrame = false;
+
+    // Hides scene draws behind last frame's depth; only initialized when draws are GPU-indirect
+    OcclusionCuller occlusionCuller;
+    bool            occlusionCulling = false;
+
+    void prepareSceneDraws();
+
+    // Per-pass secondary command buffers, recorded in parallel and executed from the primary. Passes
+    // from FIRST_TRANSPARENT_PASS on record into the OIT subpass; the scene pass fills both of its buffers
+    static constexpr uint32_t PASS_SKYBOX            = 0;
+    static constexpr uint32_t PASS_ROAD              = 1;
+    static constexpr uint32_t PASS_SCENE             = 2;
+    static constexpr uint32_t PASS_SCENE_TRANSPARENT = 3;
+    static constexpr uint32_t PASS_RAIN              = 4;
+    static constexpr uint32_t PASS_COUNT             = 5;
+    static constexpr uint32_t FIRST_TRANSPARENT_PASS = PASS_SCENE_TRANSPARENT;
+
+    /**
+     * @brief Secondary command recording state for one frame in flight
+     *
+     * Each pass gets its own pool so worker threads never share a pool
+     * (command pools are externally synchronized).
+     */
+    struct PassCommands {
+        std::array<VkCommandPool, PASS_COUNT>   pools{};
+        std::array<VkCommandBuffer, PASS_COUNT> buffers{};
+    };
+    std::vector<PassCommands> passCommands;
+
+    // Work recorded by each pass in the current frame; each entry is written only by its pass's thread
+    struct PassStats {
+        uint32_t drawCalls = 0;
+        uint64_t triangles = 0;
+    };
+    std::array<PassStats, PASS_COUNT> passStats{};
+    PassStats                         primaryStats;  // Mirrors, shadows and rain occlusion, in the primary buffer
+
+    // GPU timestamp sections; names index GPU_SECTION_NAMES
+    static constexpr uint32_t GPU_SECTION_SKYBOX         = 0;
+    static constexpr uint32_t GPU_SECTION_ROAD           = 1;
+    static constexpr uint32_t GPU_SECTION_OPAQUE         = 2;
+    static constexpr uint32_t GPU_SECTION_TRANSPARENT    = 3;
+    static constexpr uint32_t GPU_SECTION_RAIN           = 4;
+    static constexpr uint32_t GPU_SECTION_RAIN_COMPUTE   = 5;
+    static constexpr uint32_t GPU_SECTION_WINDSHIELD     = 6;
+    static constexpr uint32_t GPU_SECTION_OCCLUSION      = 7;
+    static constexpr uint32_t GPU_SECTION_HIZ            = 8;
+    static constexpr uint32_t GPU_SECTION_OIT            = 9;
+    static constexpr uint32_t GPU_SECTION_UPSCALE        = 10;
+    static constexpr uint32_t GPU_SECTION_MIRRORS        = 11;
+    static constexpr uint32_t GPU_SECTION_RAIN_OCCLUSION = 12;
+    static constexpr uint32_t GPU_SECTION_SHADOWS        = 13;
+    static constexpr uint32_t GPU_SECTION_LIGHT_CULL     = 14;
+    static constexpr uint32_t GPU_SECTION_REFLECTIONS    = 15;
+    static constexpr uint32_t GPU_SECTION_COUNT          = 16;
+
+    static constexpr std::array<const char*, GPU_SECTION_COUNT> GPU_SECTION_NAMES = {
+        "skybox", "road", "opaque", "transparent", "rain", "rain_compute", "windshield", "occlusion_cull",
+        "depth_pyramid", "oit_composite", "upscale", "mirrors", "rain_occlusion", "shadows", "light_cull",
+        "reflections"};
+    static constexpr const char* GPU_TIMINGS_CSV_PATH = "gpu_timings.csv";
+    static constexpr const char* CPU_TRACE_PATH       = "cpu_trace.json";  // Written with -DDOWNPOUR_PROFILING=ON
+
+    GpuProfiler gpuProfiler;
+
+    // Per-frame records for SystemMonitor in a shared-memory ring; zone ids index TELEMETRY_ZONE_NAMES
+    static constexpr uint32_t TELEMETRY_ZONE_WAIT   = 0;  // Frame pacer wait for a free frame slot
+    static constexpr uint32_t TELEMETRY_ZONE_RECORD = 1;  // Acquire, allocations and command recording
+    static constexpr uint32_t TELEMETRY_ZONE_SUBMIT = 2;  // Submit and present
+    static constexpr uint32_t TELEMETRY_ZONE_COUNT  = 3;
+
+    static constexpr std::array<const char*, TELEMETRY_ZONE_COUNT> TELEMETRY_ZONE_NAMES = {"wait", "record",
+                                                                                          "submit"};
+
+    TelemetryPublisher telemetry;
+    bool               telemetryEnabled = true;
+    DpTelemetryFrame   telemetryFrame{};      // Filled over the frame, published at the end of drawFrame()
+    uint64_t           lastTelemetryNs  = 0;  // Publish time of the previous frame
+
+    /**
+     * @brief Publish this frame's timings, draw counts, particle counts and memory usage
+     */
+    void publishTelemetry();
+
+    void createPassCommandBuffers();
+    void recordSkyboxPass(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordRoadPass(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordStreamedRoad(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordSceneBatches(VkCommandBuffer cmd, uint32_t frameIndex);
+    void recordRainPass(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    /**
+     * @brief Record the multiview mirror pass into the primary buffer, before the main render pass
+     *
+     * Draws the opaque scene draws Scene::cullDrawList marked for a mirror, in object slots
+     * after the main view's, and the whole road model. Call after recordSceneBatches.
+     */
+    void recordMirrorPass(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    // Top-down depth the rain compute step kills drops against and the rain draw hides them behind; one map per
+    // frame slot, updated only while raining
+    RainOcclusionMap                 rainOcclusion;
+    bool                             rainOcclusionStatic = false;  // beginFrame() asked for the static pass
+    std::vector<WorldStreamer::Draw> rainOcclusionDraws;           // Scratch for recordRainOcclusion()
+
+    /**
+     * @brief Record the rain occlusion map's passes into the primary buffer
+     *
+     * The road, when the map recenters; every scene draw over the map, each frame. Object slots
+     * are appended after sceneObjectCount. recordCommandBuffer() places the map first.
+     */
+    void recordRainOcclusion(VkCommandBuffer cmd);
+
+    // Sun shadows the scene shades with; static layers are redrawn only for cascades that moved
+    ShadowCascades                   shadowCascades;
+    uint32_t                         shadowCascadesMoved = 0;  // ShadowCascades::beginFrame() this frame
+    std::vector<WorldStreamer::Draw> shadowDraws;              // Scratch for recordShadowPass()
+
+    /**
+     * @brief Record the shadow cascades into the primary buffer, before the mirrors and the main pass
+     *
+     * The road into each cascade that moved; then, every frame, the opaque scene draws
+     * Scene::cullDrawList marked for a cascade. Object slots are appended after sceneObjectCount.
+     */
+    void recordShadowPass(VkCommandBuffer cmd);
+
+    // Headlights, taillights and street lamps, culled into the main view's froxels before the scene shades
+    ClusteredLights clusteredLights;
 
-    // Descriptor sets
-    VkDescriptorPool             descriptorPool = VK_NULL_HANDLE;
-    std::vector<VkDescriptorSet> descriptorSets;
+    // Street lamps along the road's long axis, alternating sides, as far as the light grid reaches
+    static constexpr float STREET_LAMP_SPACING = 30.0f;  // Metres along the road from one lamp to the next
+    static constexpr float STREET_LAMP_HEIGHT  = 8.0f;
+    static constexpr float STREET_LAMP_RANGE   = 20.0f;
+    static constexpr float STREET_LAMP_INSET   = 1.0f;  // From the road's edge toward its center
+
+    /**
+     * @brief Gather this frame's local lights and write them with the main view into frameLights
+     *
+     * The player's lamps first, while CarEntity::areLightsOn(), then street lamps nearest the
+     * camera first, so crowded froxels keep the ones that matter.
+     * @param proj The main view's projection, Y already flipped for Vulkan
+     */
+    void updateLocalLights(const glm::mat4& view, const glm::mat4& proj);
+
+    // Screen-space reflections on the road while it is wet; traced after the main pass, read the next frame
+    WetRoadReflections wetReflections;
+    float              frameWetness = 0.0f;  // WeatherSystem::getWetness() for the frame being recorded
+
+    // Set 0 (camera UBO + object SSBO over the frame allocator buffer, shadow map, local lights and their
+    // froxel lists, the wet road's reflections and their depth); bind with frameDynamicOffsets()
+    VkDescriptorPool descriptorPool     = VK_NULL_HANDLE;
+    VkDescriptorSet  frameDescriptorSet = VK_NULL_HANDLE;
 
     void createDescriptorPool();
     void createDescriptorSets();
 
-    // Depth resources
-    void createDepthResources();
+    /**
+     * @param cameraUbo The view's camera (or mirror) UBO, by default the main view's
+     */
+    std::array<uint32_t, 3> frameDynamicOffsets(const FrameAllocation& cameraUbo) const {
+        return {cameraUbo.dynamicOffset(), frameObjects.dynamicOffset(), frameLights.dynamicOffset()};
+    }
+    std::array<uint32_t, 3> frameDynamicOffsets() const { return frameDynamicOffsets(frameCamera); }
+
     void createRoadBuffers();
 
-    void createWorldPipeline();
+    void createWorldPipeline(std::vector<PipelineRequest>& batch);
+
+    /**
+     * @brief Load the car and road as a job graph, ending with the driving scene built
+     */
+    void loadAssets();
+
+    /** @brief Decode and create every material of a model in parallel (one job each) */
+    void createModelMaterials(const Model& model, std::unordered_map<size_t, uint32_t>& outIds);
 
     // Car rendering methods
     void loadCarModel();
-    void createCarPipeline();
-    void createCarTransparentPipeline();
+    void buildCarScene();
+    /**
+     * @brief Create the car pipeline layout and queue its pipelines into @p batch
+     *
+     * Material variants are built after the assets load, once their feature masks are known.
+     */
+    void createCarPipeline(std::vector<PipelineRequest>& batch);
+
+    /**
+     * @brief Opaque car pipeline with no material features, matching the model's vertex format
+     */
+    VkPipeline selectCarPipeline(const Model& model) const;
+
+    /**
+     * @brief Fill an object slot: transform, material and the model's vertex dequantization
+     *
+     * Without a previous transform the object is taken to have held still since last frame.
+     */
+    static void writeObject(ObjectData& object, const glm::mat4& transform, uint32_t materialIndex,
+                            const Model& model);
+    static void writeObject(ObjectData& object, const glm::mat4& transform, const glm::mat4& previousTransform,
+                            uint32_t materialIndex, const Model& model);
     void createCarDescriptorSets();
 
+    /** @brief Set 1 layout for car/road materials (per-material sampler, or the bindless layout) */
+    VkDescriptorSetLayout createCarMaterialLayout();
+
     // Road rendering methods
     void loadRoadModel();
+    void buildRoadScene();
 
     // Windshield rendering methods
     void createWindshieldPipeline();
     void renderWindshield(VkCommandBuffer cmd, uint32_t frameIndex);
 
     // Car simulation methods
-    void updateCarPhysics(float deltaTime);
+    void startSimulation();
+    void stepWorld(float deltaTime, const Simulation::VehicleInput& input, Simulation::SimulationSnapshot& state);
+    BenchmarkRun runBenchmarkPass(const BenchmarkConfig& config, bool raining, const Simulation::VehicleState& start);
+    void applyVehicleState(float deltaTime);
     void updateCameraForCockpit();
 
     /**
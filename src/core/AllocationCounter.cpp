@@ -0,0 +1,82 @@
+#include "AllocationCounter.h"
+
+#if defined(DOWNPOUR_COUNT_ALLOCATIONS)
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+
+void* countedAllocate(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* countedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return memory;
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+// Sized and nothrow forms forward to these in the standard library
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return countedAllocateAligned(size, alignment);
+}
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+namespace DownPour {
+
+bool AllocationCounter::isEnabled() {
+    return true;
+}
+
+uint64_t AllocationCounter::getCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+}  // namespace DownPour
+
+#else
+
+namespace DownPour {
+
+bool AllocationCounter::isEnabled() {
+    return false;
+}
+
+uint64_t AllocationCounter::getCount() {
+    return 0;
+}
+
+}  // namespace DownPour
+
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Process-wide count of heap allocations, for checking that frames stay allocation-free
+ *
+ * Built with -DDOWNPOUR_COUNT_ALLOCATIONS=ON, which replaces the global
+ * operator new to count every call on every thread. Otherwise nothing is
+ * replaced, isEnabled() is false and getCount() stays 0.
+ */
+class AllocationCounter {
+public:
+    static bool     isEnabled();
+    static uint64_t getCount();
+};
+
+}  // namespace DownPour
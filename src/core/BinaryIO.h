@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "Hash.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return;
+
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                ::madvise(mapping, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                bytes  = static_cast<const unsigned char*>(mapping);
+                length = static_cast<size_t>(info.st_size);
+            }
+        }
+        ::close(fd);  // The mapping stays valid without the descriptor
+    }
+
+    ~MappedFile() {
+        if (bytes)
+            ::munmap(const_cast<unsigned char*>(bytes), length);
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool                 isOpen() const { return bytes != nullptr; }
+    const unsigned char* data() const { return bytes; }
+    size_t               size() const { return length; }
+
+private:
+    const unsigned char* bytes  = nullptr;
+    size_t               length = 0;
+};
+
+/**
+ * @brief hashBytes() of a whole file
+ * @return false if the file cannot be read
+ */
+inline bool hashFile(const std::string& path, uint64_t seed, uint64_t& outHash) {
+    MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+    outHash = hashBytes(file.data(), file.size(), seed);
+    return true;
+}
+
+/**
+ * @brief Append-only serializer for cache files
+ *
+ * Values are stored in native byte order and layout; the caches are local
+ * build artefacts, so a format version in their header is enough.
+ */
+class BlobWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "BlobWriter::put needs a trivially copyable type");
+        append(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void putArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "BlobWriter::putArray needs a trivially copyable type");
+        put(static_cast<uint32_t>(values.size()));
+        append(values.data(), values.size() * sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        append(value.data(), value.size());
+    }
+
+    const std::vector<char>& getData() const { return data; }
+
+private:
+    std::vector<char> data;
+
+    void append(const void* bytes, size_t size) {
+        const char* begin = static_cast<const char*>(bytes);
+        data.insert(data.end(), begin, begin + size);
+    }
+};
+
+/**
+ * @brief Bounds-checked reader over mapped cache data
+ *
+ * Reading past the end sets a sticky failure flag and yields zeroed values,
+ * so callers read a whole record and check ok() once.
+ */
+class BlobReader {
+public:
+    BlobReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "BlobReader::get needs a trivially copyable type");
+        T value{};
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Read an element count, failing if the rest cannot hold that many `minElementSize` records
+     */
+    uint32_t getCount(size_t minElementSize) {
+        const uint32_t count = get<uint32_t>();
+        return fits(count, minElementSize) ? count : 0;
+    }
+
+    template <typename T>
+    std::vector<T> getArray() {
+        std::vector<T> values(getCount(sizeof(T)));
+        read(values.data(), values.size() * sizeof(T));
+        return values;
+    }
+
+    std::string getString() {
+        const uint32_t count = getCount(1);
+        std::string    value(reinterpret_cast<const char*>(data + cursor), count);
+        cursor += count;
+        return value;
+    }
+
+    bool ok() const { return !failed; }
+
+    /** @brief True once every byte was read without failing */
+    bool atEnd() const { return !failed && cursor == size; }
+
+private:
+    const unsigned char* data;
+    size_t               size;
+    size_t               cursor = 0;
+    bool                 failed = false;
+
+    bool fits(uint64_t count, size_t elementSize) {
+        if (failed || count > (size - cursor) / elementSize)
+            failed = true;
+        return !failed;
+    }
+
+    void read(void* out, size_t bytes) {
+        if (bytes == 0 || !fits(bytes, 1))
+            return;
+        memcpy(out, data + cursor, bytes);
+        cursor += bytes;
+    }
+};
+
+}  // namespace DownPour
@@ -0,0 +1,68 @@
+#include "FrameAllocator.h"
+
+#include "ResourceManager.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+
+namespace DownPour {
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+void FrameAllocator::init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t frameCount,
+                          VkDeviceSize bytesPerFrame) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    uniformAlignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 16);
+    storageAlignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 16);
+
+    // Regions start on an alignment every kind of allocation accepts
+    frameCapacity = alignUp(bytesPerFrame, std::max(uniformAlignment, storageAlignment));
+    ResourceManager::createBuffer(device, physicalDevice, frameCapacity * frameCount, USAGE,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer,
+                                  memory);
+
+    regionStart = 0;
+    cursor.store(0, std::memory_order_relaxed);
+    peakUsage = 0;
+}
+
+void FrameAllocator::destroy(VkDevice device) {
+    ResourceManager::destroyBuffer(device, buffer, memory);
+    frameCapacity = 0;
+}
+
+void FrameAllocator::beginFrame(uint32_t frameIndex) {
+    peakUsage   = std::max(peakUsage, std::min(cursor.load(std::memory_order_relaxed), frameCapacity));
+    regionStart = frameCapacity * frameIndex;
+    cursor.store(0, std::memory_order_relaxed);
+}
+
+FrameAllocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    VkDeviceSize offset = cursor.load(std::memory_order_relaxed);
+    VkDeviceSize aligned;
+    do {
+        aligned = alignUp(offset, alignment);
+        if (aligned + size > frameCapacity) {
+            if (!overflowReported.exchange(true))
+                DP_LOG(Warning, "FrameAllocator: frame region of %llu bytes is full",
+                       static_cast<unsigned long long>(frameCapacity));
+            return FrameAllocation();
+        }
+    } while (!cursor.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed));
+
+    FrameAllocation allocation;
+    allocation.buffer = buffer;
+    allocation.offset = regionStart + aligned;
+    allocation.size   = size;
+    allocation.data   = static_cast<char*>(memory.mapped) + allocation.offset;
+    return allocation;
+}
+
+}  // namespace DownPour
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief A range of the current frame's transient memory
+ *
+ * Valid until the same frame slot is begun again. `offset` is from the start
+ * of the allocator's buffer, so it is both the bind offset and the dynamic
+ * offset for descriptors written against the whole buffer.
+ */
+struct FrameAllocation {
+    VkBuffer     buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size   = 0;
+    void*        data   = nullptr;  // Persistently mapped, host-coherent
+
+    bool     isValid() const { return data != nullptr; }
+    uint32_t dynamicOffset() const { return static_cast<uint32_t>(offset); }
+
+    template <typename T>
+    T* as() const {
+        return static_cast<T*>(data);
+    }
+};
+
+/**
+ * @brief Linear allocator for per-frame GPU data (uniforms, SSBOs, indirect commands, vertices)
+ *
+ * One persistently mapped buffer is split into a region per frame in flight.
+ * beginFrame() rewinds a slot's region once its fence has signalled, and
+ * allocations bump a cursor through it at the device's offset alignment for
+ * the kind of data. Descriptors are written once against the whole buffer
+ * with *_DYNAMIC types and draws pass their allocation's offset, so features
+ * need no buffers or descriptor updates of their own. allocate() is lock-free,
+ * so pass recording threads can share the frame; beginFrame() must not race it.
+ */
+class FrameAllocator {
+public:
+    FrameAllocator()  = default;
+    ~FrameAllocator() = default;
+
+    FrameAllocator(const FrameAllocator&)            = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @brief Create the buffer
+     * @param frameCount Frames in flight, one region each
+     * @param bytesPerFrame Capacity of each region
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t frameCount, VkDeviceSize bytesPerFrame);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Start allocating from @p frameIndex's region, discarding what it held
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief Sub-allocate from the current frame
+     * @return An invalid allocation when the region is full
+     */
+    FrameAllocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+    /** @brief Allocation usable as a (dynamic) uniform buffer */
+    FrameAllocation allocateUniform(VkDeviceSize size) { return allocate(size, uniformAlignment); }
+
+    /** @brief Allocation usable as a (dynamic) storage buffer */
+    FrameAllocation allocateStorage(VkDeviceSize size) { return allocate(size, storageAlignment); }
+
+    VkBuffer     getBuffer() const { return buffer; }
+    VkDeviceSize getFrameCapacity() const { return frameCapacity; }
+    VkDeviceSize getPeakUsage() const { return peakUsage; }  // Most any frame has used
+
+    static constexpr VkBufferUsageFlags USAGE =
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+
+private:
+    VkBuffer     buffer = VK_NULL_HANDLE;
+    Allocation   memory;
+    VkDeviceSize frameCapacity    = 0;
+    VkDeviceSize uniformAlignment = 256;
+    VkDeviceSize storageAlignment = 256;
+    VkDeviceSize peakUsage        = 0;
+
+    // Current region [regionStart, regionStart + frameCapacity); `cursor` is relative to it
+    VkDeviceSize              regionStart = 0;
+    std::atomic<VkDeviceSize> cursor{0};
+    std::atomic<bool>         overflowReported{false};
+};
+
+}  // namespace DownPour
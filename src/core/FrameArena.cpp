@@ -0,0 +1,60 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+
+namespace DownPour {
+
+FrameArena::FrameArena(size_t initialCapacity) {
+    addBlock(std::max<size_t>(initialCapacity, 64));
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    for (;;) {
+        Block&          block   = blocks[current];
+        const uintptr_t base    = reinterpret_cast<uintptr_t>(block.memory.get());
+        const uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        const size_t    start   = static_cast<size_t>(aligned - base);
+        if (start + size <= block.size) {
+            offset = start + size;
+            return block.memory.get() + start;
+        }
+
+        // Move on to the next block, adding one when this frame needs more than ever before
+        usedBefore += offset;
+        offset = 0;
+        current++;
+        if (current == blocks.size())
+            addBlock(std::max(blocks.back().size * 2, size + alignment));
+    }
+}
+
+void FrameArena::reset() {
+    peakUsage = std::max(peakUsage, getUsed());
+
+    // Overflowed: replace all blocks with one that holds the whole peak, so later frames stay in one block
+    if (blocks.size() > 1) {
+        const size_t total = getCapacity();
+        blocks.clear();
+        addBlock(total);
+    }
+
+    current    = 0;
+    offset     = 0;
+    usedBefore = 0;
+}
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks)
+        total += block.size;
+    return total;
+}
+
+void FrameArena::addBlock(size_t size) {
+    Block block;
+    block.memory = std::make_unique<std::byte[]>(size);
+    block.size   = size;
+    blocks.push_back(std::move(block));
+}
+
+}  // namespace DownPour
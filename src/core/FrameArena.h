@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Monotonic scratch memory for one frame of CPU work
+ *
+ * Allocations bump an offset through large blocks and are never freed one by
+ * one; reset() rewinds everything at the start of the next frame. Blocks are
+ * kept across resets, and a frame that overflowed into extra blocks has them
+ * merged into one big enough for it, so once a few frames have run nothing
+ * reaches the heap. Objects are not destroyed: only store trivially
+ * destructible data, or containers using ArenaAllocator that the frame drops.
+ * Not thread-safe; give each allocating thread its own arena.
+ */
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1024 * 1024;
+
+    explicit FrameArena(size_t initialCapacity = DEFAULT_CAPACITY);
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * @brief Discard every allocation made since the last reset
+     */
+    void reset();
+
+    size_t getUsed() const { return usedBefore + offset; }
+    size_t getCapacity() const;
+    size_t getPeakUsage() const { return peakUsage; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t                       size = 0;
+    };
+
+    std::vector<Block> blocks;
+    size_t             current    = 0;  // Block being bumped through
+    size_t             offset     = 0;  // Into blocks[current]
+    size_t             usedBefore = 0;  // Bytes in blocks before `current`
+    size_t             peakUsage  = 0;
+
+    void addBlock(size_t size);
+};
+
+/**
+ * @brief STL allocator over a FrameArena; deallocate() is a no-op
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) noexcept : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T*   allocate(size_t count) { return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena == other.arena;
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+        return arena != other.arena;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}  // namespace DownPour
@@ -0,0 +1,86 @@
+#include "FramePacer.h"
+
+#include "logger/Logger.h"
+
+#include <algorithm>
+
+namespace DownPour {
+
+void FramePacer::init(VkDevice device, uint32_t framesInFlight, bool presentWaitSupported) {
+    this->device         = device;
+    this->framesInFlight = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+
+    waitForPresent = nullptr;
+    if (presentWaitSupported) {
+        waitForPresent =
+            reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device, "vkWaitForPresentKHR"));
+    }
+    presentWait = waitForPresent != nullptr;
+
+    frameId        = 1;
+    latencySum     = 0.0;
+    latencySamples = 0;
+    lastReport     = Clock::now();
+
+    DP_LOG(Info, "FramePacer: %u frame(s) in flight, latency measured to %s", this->framesInFlight,
+           presentWait ? "display (present wait)" : "GPU completion");
+}
+
+void FramePacer::waitForFrame(VkSwapchainKHR swapchain, VkFence frameFence) {
+    // The slot being reused last held frame (frameId - framesInFlight)
+    uint64_t previous = frameId > framesInFlight ? frameId - framesInFlight : 0;
+
+    if (presentWait && previous != 0) {
+        VkResult result = waitForPresent(device, swapchain, previous, PRESENT_WAIT_TIMEOUT);
+        if (result == VK_SUCCESS)
+            recordLatency(previous);
+        // VK_TIMEOUT (hidden window) or an out-of-date swapchain: fall through to the fence
+    }
+
+    vkWaitForFences(device, 1, &frameFence, VK_TRUE, UINT64_MAX);
+    if (!presentWait && previous != 0)
+        recordLatency(previous);
+}
+
+void FramePacer::markInputSampled() {
+    inputTimes[frameId % inputTimes.size()] = Clock::now();
+}
+
+void FramePacer::attachPresentId(VkPresentInfoKHR& present) {
+    if (!presentWait)
+        return;
+
+    presentIdValue = frameId;
+
+    presentIdInfo                = {};
+    presentIdInfo.sType          = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.pNext          = present.pNext;
+    presentIdInfo.swapchainCount = present.swapchainCount;
+    presentIdInfo.pPresentIds    = &presentIdValue;
+    present.pNext                = &presentIdInfo;
+}
+
+void FramePacer::endFrame() {
+    frameId++;
+
+    std::chrono::duration<double> sinceReport = Clock::now() - lastReport;
+    if (sinceReport.count() < REPORT_INTERVAL)
+        return;
+
+    if (latencySamples > 0) {
+        averageLatencyMs = latencySum / latencySamples;
+        DP_LOG(Info, "Latency: %.2f ms input-to-%s (%u frame(s) in flight)", averageLatencyMs,
+               presentWait ? "display" : "GPU", framesInFlight);
+    }
+    latencySum     = 0.0;
+    latencySamples = 0;
+    lastReport     = Clock::now();
+}
+
+void FramePacer::recordLatency(uint64_t completedFrame) {
+    std::chrono::duration<double, std::milli> latency = Clock::now() - inputTimes[completedFrame % inputTimes.size()];
+    latencySum += latency.count();
+    latencySamples++;
+}
+
+}  // namespace DownPour
@@ -0,0 +1,95 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Frame pacing and input-to-photon latency measurement
+ *
+ * Before each frame the pacer waits for the frame issued framesInFlight frames
+ * earlier. With VK_KHR_present_wait that means waiting until its image is on
+ * screen, so input sampled afterwards is displayed at most framesInFlight
+ * presents later. Without present wait the in-flight fence is the only
+ * throttle and latency is measured to GPU completion instead of to display.
+ */
+class FramePacer {
+public:
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    FramePacer()  = default;
+    ~FramePacer() = default;
+
+    /**
+     * @brief Set up pacing for a device
+     * @param device Vulkan logical device
+     * @param framesInFlight Frames the CPU may run ahead of the display (1 - MAX_FRAMES_IN_FLIGHT)
+     * @param presentWaitSupported Whether VK_KHR_present_id and VK_KHR_present_wait were enabled
+     */
+    void init(VkDevice device, uint32_t framesInFlight, bool presentWaitSupported);
+
+    /**
+     * @brief Block until the next frame may start
+     * @param swapchain Swapchain presented to
+     * @param frameFence In-flight fence of the slot about to be reused (waited on, not reset)
+     */
+    void waitForFrame(VkSwapchainKHR swapchain, VkFence frameFence);
+
+    /**
+     * @brief Record that the input for the frame about to be recorded was sampled now
+     */
+    void markInputSampled();
+
+    /**
+     * @brief Tag a present with this frame's id (no-op without present wait)
+     *
+     * The chained VkPresentIdKHR is owned by the pacer and stays valid until endFrame().
+     */
+    void attachPresentId(VkPresentInfoKHR& present);
+
+    /**
+     * @brief Advance to the next frame; call after present
+     */
+    void endFrame();
+
+    /**
+     * @brief Mean latency over the last report interval in milliseconds
+     */
+    double getAverageLatencyMs() const { return averageLatencyMs; }
+
+    /**
+     * @brief Whether latency is measured to display (present wait) rather than to GPU completion
+     */
+    bool measuresDisplay() const { return presentWait; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double   REPORT_INTERVAL      = 2.0;          // Seconds between latency reports
+    static constexpr uint64_t PRESENT_WAIT_TIMEOUT = 100000000ull;  // 100 ms; a minimised window never presents
+
+    VkDevice                device         = VK_NULL_HANDLE;
+    uint32_t                framesInFlight = 2;
+    bool                    presentWait    = false;
+    PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+
+    // Present ids must be non-zero and increase per swapchain; frame N is presented with id N
+    uint64_t                                                frameId = 1;
+    std::array<Clock::time_point, MAX_FRAMES_IN_FLIGHT + 1> inputTimes{};  // Indexed by frame id
+    VkPresentIdKHR                                          presentIdInfo{};
+    uint64_t                                                presentIdValue = 0;
+
+    double            latencySum       = 0.0;
+    uint32_t          latencySamples   = 0;
+    double            averageLatencyMs = 0.0;
+    Clock::time_point lastReport       = Clock::now();
+
+    void recordLatency(uint64_t completedFrame);
+};
+
+}  // namespace DownPour
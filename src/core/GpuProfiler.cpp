@@ -0,0 +1,203 @@
+#include "GpuProfiler.h"
+
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace DownPour {
+
+void GpuProfiler::init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamily,
+                       uint32_t framesInFlight, const std::vector<std::string>& sectionNames,
+                       const std::string& csvPath) {
+    this->device         = device;
+    this->framesInFlight = framesInFlight;
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+    uint32_t validBits = queueFamily < familyCount ? families[queueFamily].timestampValidBits : 0;
+    if (validBits == 0 || sectionNames.empty()) {
+        DP_LOG(Warning, "GpuProfiler: queue has no timestamp support, GPU timings disabled");
+        return;
+    }
+    timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    timestampPeriod = properties.limits.timestampPeriod;
+
+    sections.clear();
+    sections.resize(sectionNames.size());
+    for (size_t i = 0; i < sectionNames.size(); i++)
+        sections[i].name = sectionNames[i];
+    slotPending.assign(framesInFlight, false);
+    resolveResults.assign(queriesPerFrame() * 2, 0);
+
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = queriesPerFrame() * framesInFlight;
+
+    if (vkCreateQueryPool(device, &poolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool");
+    }
+
+    if (!csvPath.empty()) {
+        csv.open(csvPath, std::ios::trunc);
+        if (csv.is_open()) {
+            csv << "frame";
+            for (const Section& section : sections)
+                csv << "," << section.name << "_ms";
+            csv << "\n";
+        }
+    }
+}
+
+void GpuProfiler::destroy() {
+    if (queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device, queryPool, nullptr);
+        queryPool = VK_NULL_HANDLE;
+    }
+    if (csv.is_open())
+        csv.close();
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer cmd, uint32_t frameIndex) {
+    if (!isEnabled())
+        return;
+
+    if (slotPending[frameIndex])
+        resolve(frameIndex);
+
+    vkCmdResetQueryPool(cmd, queryPool, frameIndex * queriesPerFrame(), queriesPerFrame());
+    slotPending[frameIndex] = true;
+
+    if (++framesSinceReport >= REPORT_FRAMES) {
+        logSummary();
+        framesSinceReport = 0;
+    }
+}
+
+void GpuProfiler::beginSection(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t section) const {
+    if (isEnabled())
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, queryIndex(frameIndex, section, false));
+}
+
+void GpuProfiler::endSection(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t section) const {
+    if (isEnabled()) {
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool,
+                            queryIndex(frameIndex, section, true));
+    }
+}
+
+void GpuProfiler::resolve(uint32_t frameIndex) {
+    // Value + availability per query; no WAIT flag, the slot's fence has already signalled
+    std::vector<uint64_t>& results = resolveResults;
+    VkResult result = vkGetQueryPoolResults(device, queryPool, frameIndex * queriesPerFrame(), queriesPerFrame(),
+                                            results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY)
+        return;
+
+    if (csv.is_open())
+        csv << resolvedFrames;
+
+    float frameMs = 0.0f;
+    for (size_t s = 0; s < sections.size(); s++) {
+        const uint64_t* begin = &results[s * 4];
+        const uint64_t* end   = &results[s * 4 + 2];
+
+        // Sections that did not run this frame (e.g. rain while sunny) were never written
+        bool available     = begin[1] != 0 && end[1] != 0;
+        sections[s].lastMs = 0.0f;
+        if (available) {
+            uint64_t ticks = ((end[0] & timestampMask) - (begin[0] & timestampMask)) & timestampMask;
+            float    ms    = static_cast<float>(static_cast<double>(ticks) * timestampPeriod * 1e-6);
+
+            Section& section              = sections[s];
+            section.history[section.head] = ms;
+            section.head                  = (section.head + 1) % HISTORY_SIZE;
+            section.count                 = std::min(section.count + 1, HISTORY_SIZE);
+            section.lastMs                = ms;
+            frameMs += ms;
+
+            if (csv.is_open())
+                csv << "," << ms;
+        } else if (csv.is_open()) {
+            csv << ",";
+        }
+    }
+
+    if (csv.is_open())
+        csv << "\n";
+    lastFrameMs = frameMs;
+    resolvedFrames++;
+}
+
+GpuProfiler::SectionStats GpuProfiler::getStats(uint32_t section) const {
+    SectionStats stats;
+    const Section& s = sections[section];
+    if (s.count == 0)
+        return stats;
+
+    // A copy on the stack: nth_element reorders it
+    std::array<float, HISTORY_SIZE> samples = s.history;
+    float* const                    first   = samples.data();
+    float* const                    last    = first + s.count;
+
+    float sum = 0.0f;
+    for (const float* ms = first; ms != last; ms++)
+        sum += *ms;
+
+    stats.samples = s.count;
+    stats.avgMs   = sum / static_cast<float>(s.count);
+    stats.minMs   = *std::min_element(first, last);
+
+    size_t p99 = std::min(s.count - 1, s.count * 99 / 100);
+    std::nth_element(first, first + p99, last);
+    stats.p99Ms = first[p99];
+    return stats;
+}
+
+void GpuProfiler::logSummary() const {
+    if (!isEnabled())
+        return;
+
+    // As many sections per record as fit in a log message, so none is truncated
+    constexpr char prefix[] = "GPU ms (min/avg/p99):";
+    char           line[LogBackend::MAX_MESSAGE];
+    size_t         length = 0;
+    for (uint32_t i = 0; i < sections.size(); i++) {
+        SectionStats stats = getStats(i);
+        if (stats.samples == 0)
+            continue;
+
+        char entry[96];
+        int  written = std::snprintf(entry, sizeof(entry), " %s %.3f/%.3f/%.3f", sections[i].name.c_str(),
+                                     stats.minMs, stats.avgMs, stats.p99Ms);
+        if (written < 0)
+            continue;
+        const size_t entryLength = std::min(static_cast<size_t>(written), sizeof(entry) - 1);
+
+        if (length > 0 && length + entryLength >= sizeof(line)) {
+            DP_LOG(Info, "%s", line);
+            length = 0;
+        }
+        if (length == 0) {
+            std::memcpy(line, prefix, sizeof(prefix));
+            length = sizeof(prefix) - 1;
+        }
+        std::memcpy(line + length, entry, entryLength + 1);
+        length += entryLength;
+    }
+
+    if (length > 0)
+        DP_LOG(Info, "%s", line);
+}
+
+}  // namespace DownPour
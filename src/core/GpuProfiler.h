@@ -0,0 +1,118 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Rolling GPU timings per named section, from timestamp queries
+ *
+ * Each frame in flight owns a begin/end query pair per section. A slot's
+ * results are read back when the slot comes round again, after its fence has
+ * signalled, so reading never stalls; sections not written that frame are
+ * skipped through the availability bit. Timestamps may be written from
+ * secondary command buffers on any thread, as each section writes only its
+ * own queries. Stats go to the Logger periodically and every resolved frame
+ * can be streamed to a CSV file.
+ */
+class GpuProfiler {
+public:
+    struct SectionStats {
+        float  minMs   = 0.0f;
+        float  avgMs   = 0.0f;
+        float  p99Ms   = 0.0f;
+        size_t samples = 0;
+    };
+
+    static constexpr size_t   HISTORY_SIZE  = 256;  // Rolling window per section
+    static constexpr uint32_t REPORT_FRAMES = 240;  // Frames between Logger summaries
+
+    GpuProfiler()  = default;
+    ~GpuProfiler() = default;
+
+    /**
+     * @brief Create the query pool; profiling is disabled when the queue has no timestamp support
+     * @param device Vulkan logical device
+     * @param physicalDevice Vulkan physical device
+     * @param queueFamily Family of the queue the timed commands are submitted to
+     * @param framesInFlight Number of frame slots
+     * @param sectionNames One name per section; section ids index this list
+     * @param csvPath File that receives one row per resolved frame (empty: no CSV)
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamily, uint32_t framesInFlight,
+              const std::vector<std::string>& sectionNames, const std::string& csvPath = "");
+
+    void destroy();
+
+    bool isEnabled() const { return queryPool != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Resolve the slot's previous results and reset its queries
+     *
+     * Record on the primary command buffer outside any render pass, after the slot's fence has signalled.
+     */
+    void beginFrame(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    void beginSection(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t section) const;
+    void endSection(VkCommandBuffer cmd, uint32_t frameIndex, uint32_t section) const;
+
+    SectionStats getStats(uint32_t section) const;
+
+    /**
+     * @brief Summed section time of the most recently resolved frame (ms)
+     *
+     * Frames resolve framesInFlight frames late; getResolvedFrameCount() tells when a new one arrived.
+     */
+    float    getLastFrameMs() const { return lastFrameMs; }
+    uint64_t getResolvedFrameCount() const { return resolvedFrames; }
+
+    /**
+     * @brief One section's time in the most recently resolved frame (ms); 0 if it did not run
+     */
+    float getLastSectionMs(uint32_t section) const { return sections[section].lastMs; }
+
+    const std::string& getSectionName(uint32_t section) const { return sections[section].name; }
+
+    /**
+     * @brief Log min/avg/p99 for every section through the Logger
+     */
+    void logSummary() const;
+
+private:
+    struct Section {
+        std::string                     name;
+        std::array<float, HISTORY_SIZE> history{};  // Ring of recent timings (ms)
+        size_t                          head   = 0;
+        size_t                          count  = 0;
+        float                           lastMs = 0.0f;
+    };
+
+    VkDevice              device            = VK_NULL_HANDLE;
+    VkQueryPool           queryPool         = VK_NULL_HANDLE;
+    uint32_t              framesInFlight    = 0;
+    float                 timestampPeriod   = 1.0f;   // Nanoseconds per tick
+    uint64_t              timestampMask     = ~0ull;  // Valid bits of the queue's timestamps
+    std::vector<Section>  sections;
+    std::vector<bool>     slotPending;     // Slot has queries written since its last resolve
+    std::vector<uint64_t> resolveResults;  // Scratch for resolve(), sized once so frames don't allocate
+    uint32_t              framesSinceReport = 0;
+    uint64_t              resolvedFrames    = 0;
+    float                 lastFrameMs       = 0.0f;
+    std::ofstream         csv;
+
+    uint32_t queriesPerFrame() const { return static_cast<uint32_t>(sections.size()) * 2; }
+    uint32_t queryIndex(uint32_t frameIndex, uint32_t section, bool end) const {
+        return frameIndex * queriesPerFrame() + section * 2 + (end ? 1 : 0);
+    }
+
+    void resolve(uint32_t frameIndex);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace DownPour {
+
+/**
+ * @brief 64-bit content hash, eight bytes per step
+ *
+ * Used to detect edited mesh sources and to deduplicate texture contents;
+ * not for security. A multiply-rotate round per word keeps hashing a large
+ * .glb well under the cost of parsing it.
+ */
+inline uint64_t hashBytes(const unsigned char* data, size_t size, uint64_t seed) {
+    constexpr uint64_t K = 0x9E3779B97F4A7C15ull;
+
+    uint64_t h = seed ^ (static_cast<uint64_t>(size) * K);
+    size_t   i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        h = (((h << 5) | (h >> 59)) ^ word) * K;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    h = (((h << 5) | (h >> 59)) ^ tail) * K;
+
+    // Final avalanche (splitmix64)
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+}  // namespace DownPour
@@ -0,0 +1,259 @@
+#include "JobSystem.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace DownPour {
+
+namespace {
+
+constexpr uint32_t NOT_A_WORKER = ~0u;
+
+thread_local uint32_t workerIndex = NOT_A_WORKER;
+
+}  // namespace
+
+JobSystem& JobSystem::get() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+JobSystem::JobSystem() {
+    // The main thread helps through wait(), so leave it a core
+    const uint32_t cores       = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t workerCount = std::max(1u, cores - 1);
+
+    queues = std::make_unique<Queue[]>(workerCount + 1);
+    workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        running.store(false, std::memory_order_release);
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+JobHandle JobSystem::schedule(std::function<void()> function, std::initializer_list<JobHandle> dependencies) {
+    return scheduleJob(std::move(function), dependencies.begin(), dependencies.size());
+}
+
+JobHandle JobSystem::schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies) {
+    return scheduleJob(std::move(function), dependencies.data(), dependencies.size());
+}
+
+JobHandle JobSystem::scheduleJob(std::function<void()> function, const JobHandle* dependencies, size_t count) {
+    auto job      = std::make_shared<Job>();
+    job->function = std::move(function);
+
+    for (size_t i = 0; i < count; i++) {
+        const std::shared_ptr<Job>& dependency = dependencies[i].job;
+        if (!dependency)
+            continue;
+
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->done.load(std::memory_order_acquire)) {
+            if (dependency->error) {
+                std::lock_guard<std::mutex> jobLock(job->mutex);
+                if (!job->error)
+                    job->error = dependency->error;
+            }
+            continue;
+        }
+        job->pending.fetch_add(1, std::memory_order_relaxed);
+        dependency->continuations.push_back(job);
+    }
+
+    // Drop the scheduling guard; runs now unless a dependency is still pending
+    release(job);
+    return JobHandle(job);
+}
+
+void JobSystem::wait(const JobHandle& handle) {
+    const std::shared_ptr<Job>& job = handle.job;
+    if (!job)
+        return;
+
+    while (!job->done.load(std::memory_order_acquire)) {
+        if (runOne())
+            continue;
+
+        // Nothing to help with: sleep until a job finishes or new work arrives. Sequentially
+        // consistent with execute(): either it sees this waiter or this waiter sees `done`.
+        waiting.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, IDLE_TIMEOUT,
+                          [&] { return job->done.load() || queued.load(std::memory_order_acquire) > 0; });
+        }
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (job->error)
+        std::rethrow_exception(job->error);
+}
+
+void JobSystem::waitAll(const std::vector<JobHandle>& handles) {
+    // Wait for every job before rethrowing, so none still runs against the caller's state
+    std::exception_ptr error;
+    for (const JobHandle& handle : handles) {
+        try {
+            wait(handle);
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t)>& function) {
+    grain = std::max(1u, grain);
+
+    std::vector<JobHandle> chunks;
+    chunks.reserve(count / grain + 1);
+    for (uint32_t begin = grain; begin < count; begin += grain) {
+        const uint32_t end = std::min(count, begin + grain);
+        chunks.push_back(schedule([&function, begin, end] {
+            for (uint32_t i = begin; i < end; i++)
+                function(i);
+        }));
+    }
+
+    // First chunk on the calling thread
+    std::exception_ptr error;
+    try {
+        for (uint32_t i = 0, end = std::min(count, grain); i < end; i++)
+            function(i);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Always drain the chunks: they capture `function` by reference
+    try {
+        waitAll(chunks);
+    } catch (...) {
+        if (!error)
+            error = std::current_exception();
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void JobSystem::release(const std::shared_ptr<Job>& job) {
+    if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        enqueue(job);
+}
+
+void JobSystem::enqueue(const std::shared_ptr<Job>& job) {
+    Queue& queue = queues[workerIndex == NOT_A_WORKER ? workers.size() : workerIndex];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock orders this with a sleeper's predicate check, so the wake-up cannot be missed
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    wake.notify_one();
+}
+
+std::shared_ptr<JobSystem::Job> JobSystem::pop() {
+    if (queued.load(std::memory_order_acquire) == 0)
+        return nullptr;
+
+    const uint32_t queueCount = static_cast<uint32_t>(workers.size()) + 1;
+    const uint32_t self       = workerIndex == NOT_A_WORKER ? queueCount - 1 : workerIndex;
+
+    // Own deque from the back (most recent, still warm in cache), everyone else's from the front
+    for (uint32_t offset = 0; offset < queueCount; offset++) {
+        Queue&                      queue = queues[(self + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        std::shared_ptr<Job> job;
+        if (offset == 0 && workerIndex != NOT_A_WORKER) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+    return nullptr;
+}
+
+bool JobSystem::runOne() {
+    std::shared_ptr<Job> job = pop();
+    if (!job)
+        return false;
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(const std::shared_ptr<Job>& job) {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        error = job->error;  // Inherited from a failed dependency: skip the work
+    }
+
+    if (!error) {
+        try {
+            job->function();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    job->function = nullptr;  // Free captures now; handles may outlive the job by a lot
+
+    std::vector<std::shared_ptr<Job>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->error = error;
+        job->done.store(true);
+        continuations.swap(job->continuations);
+    }
+
+    for (const std::shared_ptr<Job>& next : continuations) {
+        if (error) {
+            std::lock_guard<std::mutex> lock(next->mutex);
+            if (!next->error)
+                next->error = error;
+        }
+        release(next);
+    }
+
+    if (waiting.load() > 0) {
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        wake.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    workerIndex = index;
+    DP_PROFILE_THREAD_NAME("Job Worker");
+
+    while (running.load(std::memory_order_acquire)) {
+        if (runOne())
+            continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_for(lock, IDLE_TIMEOUT, [this] {
+            return queued.load(std::memory_order_acquire) > 0 || !running.load(std::memory_order_acquire);
+        });
+    }
+}
+
+}  // namespace DownPour
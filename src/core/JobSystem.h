@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DownPour {
+
+class JobHandle;
+
+/**
+ * @brief Small work-stealing job system
+ *
+ * One worker per core minus the main thread. Each worker pushes and pops its
+ * own deque from the back and steals from the front of the others when idle;
+ * jobs scheduled from outside the pool go to a shared queue. A job may list
+ * other jobs it depends on and only becomes runnable once they have finished,
+ * so loading work can be expressed as a graph (parse -> decode -> upload ->
+ * build scene) instead of a fixed sequence.
+ *
+ * wait() runs other jobs while the awaited one is pending, so jobs may wait on
+ * jobs (or call parallelFor) without tying up a worker. An exception thrown by a
+ * job is rethrown from wait(); jobs depending on a failed job are skipped and
+ * carry the same exception.
+ *
+ * Process-wide like LogBackend: workers start on first use and are joined at exit.
+ */
+class JobSystem {
+public:
+    static JobSystem& get();
+
+    /**
+     * @brief Queue a job that runs once every dependency has finished
+     */
+    JobHandle schedule(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {});
+    JobHandle schedule(std::function<void()> function, const std::vector<JobHandle>& dependencies);
+
+    /**
+     * @brief Block until the job finished, running queued jobs meanwhile
+     *
+     * Rethrows the job's exception, if any.
+     */
+    void wait(const JobHandle& handle);
+    void waitAll(const std::vector<JobHandle>& handles);
+
+    /**
+     * @brief Call function(i) for i in [0, count), in chunks of `grain`, and wait for all of them
+     *
+     * The calling thread takes part, so this may be used from inside a job.
+     */
+    void parallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t)>& function);
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+private:
+    friend class JobHandle;
+
+    struct Job {
+        std::function<void()>             function;
+        std::atomic<uint32_t>             pending{1};  // Unfinished dependencies, plus one until scheduled
+        std::atomic<bool>                 done{false};
+        std::mutex                        mutex;  // Guards error and continuations
+        std::exception_ptr                error;
+        std::vector<std::shared_ptr<Job>> continuations;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex                       mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+
+    static constexpr auto IDLE_TIMEOUT = std::chrono::milliseconds(2);  // Backstop; enqueues wake sleepers early
+
+    JobSystem();
+    ~JobSystem();
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues;  // One per worker, then the shared queue
+    std::atomic<uint32_t>    queued{0};
+    std::atomic<uint32_t>    waiting{0};  // Threads blocked in wait()
+    std::atomic<bool>        running{true};
+    std::mutex               wakeMutex;
+    std::condition_variable  wake;
+
+    JobHandle            scheduleJob(std::function<void()> function, const JobHandle* dependencies, size_t count);
+    void                 release(const std::shared_ptr<Job>& job);
+    void                 enqueue(const std::shared_ptr<Job>& job);
+    std::shared_ptr<Job> pop();
+    bool                 runOne();
+    void                 execute(const std::shared_ptr<Job>& job);
+    void                 workerLoop(uint32_t index);
+};
+
+/**
+ * @brief Handle to a scheduled job
+ *
+ * Cheap to copy. A default-constructed handle counts as finished.
+ */
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    bool isDone() const { return !job || job->done.load(std::memory_order_acquire); }
+
+    void wait() const { JobSystem::get().wait(*this); }
+
+private:
+    friend class JobSystem;
+    explicit JobHandle(std::shared_ptr<JobSystem::Job> job) : job(std::move(job)) {}
+
+    std::shared_ptr<JobSystem::Job> job;
+};
+
+}  // namespace DownPour
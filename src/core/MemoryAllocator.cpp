@@ -0,0 +1,326 @@
+#include "MemoryAllocator.h"
+
+#include "ResourceManager.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace DownPour {
+
+const char* memoryTagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::General:
+            return "General";
+        case MemoryTag::Geometry:
+            return "Geometry";
+        case MemoryTag::Textures:
+            return "Textures";
+        case MemoryTag::Road:
+            return "Road";
+        case MemoryTag::Windshield:
+            return "Windshield";
+        case MemoryTag::Staging:
+            return "Staging";
+        default:
+            return "Unknown";
+    }
+}
+
+MemoryAllocator& MemoryAllocator::get() {
+    static MemoryAllocator allocator;
+    return allocator;
+}
+
+void MemoryAllocator::init(VkDevice device, VkPhysicalDevice physicalDevice, bool memoryBudget) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->device          = device;
+    this->physicalDevice  = physicalDevice;
+    memoryBudgetSupported = memoryBudget;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    pools.assign(memoryProperties.memoryTypeCount * 2, Pool{});
+    for (uint32_t i = 0; i < pools.size(); i++) {
+        pools[i].memoryType = i / 2;
+    }
+}
+
+void MemoryAllocator::shutdown() {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t                    leaked = 0;
+    for (Pool& pool : pools) {
+        for (Block& block : pool.blocks) {
+            leaked += block.liveCount;
+            if (block.memory != VK_NULL_HANDLE) {
+                // vkFreeMemory implicitly unmaps
+                vkFreeMemory(device, block.memory, nullptr);
+            }
+        }
+    }
+    pools.clear();
+
+    if (leaked > 0) {
+        DP_LOG(Warning, "MemoryAllocator: %u sub-allocation(s) were not freed before shutdown", leaked);
+    }
+    deviceAllocationCount = 0;
+    reservedBytes         = 0;
+    usedBytes             = 0;
+    for (auto& bytes : taggedBytes)
+        bytes = 0;
+    std::fill(std::begin(heapReservedBytes), std::end(heapReservedBytes), 0);
+    deviceBudget = 0;
+    deviceUsage  = 0;
+    device       = VK_NULL_HANDLE;
+}
+
+Allocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+                                     bool linear, MemoryTag tag) {
+    if (device == VK_NULL_HANDLE) {
+        throw std::runtime_error("Failed to allocate memory: allocator not initialized");
+    }
+
+    uint32_t     memoryType = ResourceManager::findMemoryType(physicalDevice, requirements.memoryTypeBits, properties);
+    VkDeviceSize blockSize  = isHostVisible(memoryType) ? HOST_BLOCK_SIZE : DEVICE_BLOCK_SIZE;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Allocation allocation;
+    allocation.size      = requirements.size;
+    allocation.poolIndex = memoryType * 2 + (linear ? 0 : 1);
+    allocation.tag       = tag;
+
+    // Counted once the memory is in hand, so an allocation that throws leaves the totals as they were
+    auto account = [&]() {
+        usedBytes.fetch_add(requirements.size, std::memory_order_relaxed);
+        taggedBytes[static_cast<size_t>(tag)].fetch_add(requirements.size, std::memory_order_relaxed);
+    };
+
+    // Oversized resources would waste most of a block; give them their own memory
+    if (requirements.size > blockSize / 2) {
+        allocation.memory    = allocateDeviceMemory(requirements.size, memoryType, &allocation.mapped);
+        allocation.dedicated = true;
+        account();
+        return allocation;
+    }
+
+    Pool& pool = pools[allocation.poolIndex];
+    for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+        Block& block = pool.blocks[i];
+        if (block.memory == VK_NULL_HANDLE)
+            continue;
+        if (allocateFromBlock(block, requirements.size, requirements.alignment, allocation.offset)) {
+            allocation.memory     = block.memory;
+            allocation.blockIndex = i;
+            allocation.mapped     = block.mapped ? static_cast<char*>(block.mapped) + allocation.offset : nullptr;
+            account();
+            return allocation;
+        }
+    }
+
+    // No room in existing blocks: reuse an empty slot or append a new block
+    uint32_t blockIndex = static_cast<uint32_t>(pool.blocks.size());
+    for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+        if (pool.blocks[i].memory == VK_NULL_HANDLE) {
+            blockIndex = i;
+            break;
+        }
+    }
+    if (blockIndex == pool.blocks.size()) {
+        pool.blocks.emplace_back();
+    }
+
+    Block& block = pool.blocks[blockIndex];
+    block.memory = allocateDeviceMemory(blockSize, memoryType, &block.mapped);
+    block.size   = blockSize;
+    block.freeRanges.assign(1, FreeRange{0, blockSize});
+    block.liveCount = 0;
+
+    allocateFromBlock(block, requirements.size, requirements.alignment, allocation.offset);
+    allocation.memory     = block.memory;
+    allocation.blockIndex = blockIndex;
+    allocation.mapped     = block.mapped ? static_cast<char*>(block.mapped) + allocation.offset : nullptr;
+    account();
+    return allocation;
+}
+
+void MemoryAllocator::free(Allocation& allocation) {
+    if (!allocation.isValid())
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    usedBytes.fetch_sub(allocation.size, std::memory_order_relaxed);
+    taggedBytes[static_cast<size_t>(allocation.tag)].fetch_sub(allocation.size, std::memory_order_relaxed);
+    if (allocation.dedicated) {
+        freeDeviceMemory(allocation.memory, allocation.size, allocation.poolIndex / 2);
+    } else if (allocation.poolIndex < pools.size() &&
+               allocation.blockIndex < pools[allocation.poolIndex].blocks.size()) {
+        Block& block = pools[allocation.poolIndex].blocks[allocation.blockIndex];
+        releaseRange(block, allocation.offset, allocation.size);
+
+        // Empty blocks go back to the driver so a level change doesn't pin peak usage forever
+        if (--block.liveCount == 0) {
+            freeDeviceMemory(block.memory, block.size, pools[allocation.poolIndex].memoryType);
+            block = Block{};
+        }
+    }
+
+    allocation = Allocation{};
+}
+
+Allocation MemoryAllocator::allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryTag tag) {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+
+    Allocation allocation = allocate(requirements, properties, true, tag);
+    vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+    return allocation;
+}
+
+VkDeviceMemory MemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, void** outMapped) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize  = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate device memory block");
+    }
+    deviceAllocationCount++;
+    reservedBytes.fetch_add(size, std::memory_order_relaxed);
+    heapReservedBytes[memoryProperties.memoryTypes[memoryType].heapIndex] += size;
+
+    *outMapped = nullptr;
+    if (isHostVisible(memoryType)) {
+        // Whole-block persistent mapping; a VkDeviceMemory can only be mapped once
+        vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, outMapped);
+    }
+    return memory;
+}
+
+void MemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType) {
+    vkFreeMemory(device, memory, nullptr);
+    deviceAllocationCount--;
+    reservedBytes.fetch_sub(size, std::memory_order_relaxed);
+    heapReservedBytes[memoryProperties.memoryTypes[memoryType].heapIndex] -= size;
+}
+
+void MemoryAllocator::updateBudget() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (device == VK_NULL_HANDLE)
+        return;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    if (memoryBudgetSupported) {
+        VkPhysicalDeviceMemoryProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &properties);
+    }
+
+    VkDeviceSize budget = 0;
+    VkDeviceSize usage  = 0;
+    for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; heap++) {
+        if ((memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0)
+            continue;
+        if (memoryBudgetSupported) {
+            budget += budgetProperties.heapBudget[heap];
+            usage += budgetProperties.heapUsage[heap];
+        } else {
+            budget += memoryProperties.memoryHeaps[heap].size / 10 * 8;
+            usage += heapReservedBytes[heap];
+        }
+    }
+    deviceBudget.store(budget, std::memory_order_relaxed);
+    deviceUsage.store(usage, std::memory_order_relaxed);
+}
+
+VkDeviceSize MemoryAllocator::getDeviceHeadroom() const {
+    const VkDeviceSize budget = getDeviceBudget();
+    if (budget == 0)
+        return UINT64_MAX;
+    const VkDeviceSize limit = budget - budget / 100 * BUDGET_RESERVE;
+    const VkDeviceSize usage = getDeviceUsage();
+    return usage < limit ? limit - usage : 0;
+}
+
+void MemoryAllocator::logReport() const {
+    constexpr double MB = 1024.0 * 1024.0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const VkDeviceSize          budget = getDeviceBudget();
+    const VkDeviceSize          usage  = getDeviceUsage();
+    DP_LOG(Info, "GPU memory: %.1f / %.1f MB device-local (%s), %.1f MB reserved in %u allocations, %.1f MB used",
+           usage / MB, budget / MB, memoryBudgetSupported ? "VK_EXT_memory_budget" : "estimated",
+           getReservedBytes() / MB, deviceAllocationCount, getUsedBytes() / MB);
+    for (size_t tag = 0; tag < static_cast<size_t>(MemoryTag::Count); tag++) {
+        DP_LOG(Info, "  %-10s %9.1f MB", memoryTagName(static_cast<MemoryTag>(tag)),
+               taggedBytes[tag].load(std::memory_order_relaxed) / MB);
+    }
+}
+
+bool MemoryAllocator::isHostVisible(uint32_t memoryType) const {
+    return (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+bool MemoryAllocator::allocateFromBlock(Block& block, VkDeviceSize size, VkDeviceSize alignment,
+                                        VkDeviceSize& outOffset) {
+    // Keep host-visible sub-allocations on nonCoherentAtomSize boundaries (at most 256) so
+    // ranges can be flushed without touching a neighbour
+    if (block.mapped && alignment < 256)
+        alignment = 256;
+
+    for (size_t i = 0; i < block.freeRanges.size(); i++) {
+        FreeRange&   range   = block.freeRanges[i];
+        VkDeviceSize aligned = (range.offset + alignment - 1) / alignment * alignment;
+        VkDeviceSize padding = aligned - range.offset;
+        if (range.size < size + padding)
+            continue;
+
+        VkDeviceSize end = range.offset + range.size;
+        outOffset        = aligned;
+
+        // Split the range around the allocation; alignment padding stays free
+        FreeRange tail{aligned + size, end - (aligned + size)};
+        if (padding > 0) {
+            range.size = padding;
+            if (tail.size > 0)
+                block.freeRanges.insert(block.freeRanges.begin() + i + 1, tail);
+        } else if (tail.size > 0) {
+            range = tail;
+        } else {
+            block.freeRanges.erase(block.freeRanges.begin() + i);
+        }
+
+        block.liveCount++;
+        return true;
+    }
+    return false;
+}
+
+void MemoryAllocator::releaseRange(Block& block, VkDeviceSize offset, VkDeviceSize size) {
+    auto it = block.freeRanges.begin();
+    while (it != block.freeRanges.end() && it->offset < offset)
+        ++it;
+    it = block.freeRanges.insert(it, FreeRange{offset, size});
+
+    // Coalesce with the following range
+    auto next = it + 1;
+    if (next != block.freeRanges.end() && it->offset + it->size == next->offset) {
+        it->size += next->size;
+        block.freeRanges.erase(next);
+    }
+
+    // Coalesce with the preceding range
+    if (it != block.freeRanges.begin()) {
+        auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset) {
+            prev->size += it->size;
+            block.freeRanges.erase(it);
+        }
+    }
+}
+
+}  // namespace DownPour
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Subsystem an allocation is accounted to (MemoryAllocator::getTaggedBytes)
+ */
+enum class MemoryTag : uint8_t {
+    General,     // Render targets, per-frame data and anything untagged
+    Geometry,    // Model vertex and index buffers
+    Textures,    // Material textures and the material buffer
+    Road,        // Streamed road tiles
+    Windshield,  // Windshield wetness, droplets and impacts
+    Staging,     // Upload staging
+    Count
+};
+
+const char* memoryTagName(MemoryTag tag);
+
+/**
+ * @brief A sub-range of a device memory block
+ *
+ * Resources bind at (memory, offset). Host-visible blocks are persistently
+ * mapped, so `mapped` is valid for the allocation's lifetime and callers must
+ * not vkMapMemory the shared block themselves.
+ */
+struct Allocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize   offset = 0;
+    VkDeviceSize   size   = 0;
+    void*          mapped = nullptr;
+
+    // Bookkeeping for free()
+    uint32_t  poolIndex  = 0;
+    uint32_t  blockIndex = 0;
+    bool      dedicated  = false;
+    MemoryTag tag        = MemoryTag::General;
+
+    bool isValid() const { return memory != VK_NULL_HANDLE; }
+};
+
+/**
+ * @brief Pooled device memory allocator
+ *
+ * Sub-allocates buffers and images from large blocks so the number of
+ * vkAllocateMemory calls stays far below maxMemoryAllocationCount. Each memory
+ * type has two pools: one for buffers / linear images and one for optimal
+ * images. Keeping them apart satisfies bufferImageGranularity without padding
+ * every allocation. Requests larger than half a block get a dedicated
+ * allocation.
+ *
+ * Blocks use a first-fit free list with coalescing on free. The allocator is
+ * process-wide: VulkanContext initializes it after device creation and shuts
+ * it down before destroying the device.
+ *
+ * Every allocation carries a MemoryTag, so usage can be reported per
+ * subsystem. updateBudget() refreshes the device-local budget and usage from
+ * VK_EXT_memory_budget (or estimates them without it); the texture and road
+ * streamers shrink their own budgets to fit getDeviceHeadroom().
+ */
+class MemoryAllocator {
+public:
+    static MemoryAllocator& get();
+
+    /**
+     * @param memoryBudget Whether VK_EXT_memory_budget is enabled on the device
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, bool memoryBudget);
+
+    /**
+     * @brief Free all blocks (reports allocations that were never freed)
+     */
+    void shutdown();
+
+    /**
+     * @brief Allocate memory for the given requirements
+     * @param linear true for buffers and linear-tiling images, false for optimal images
+     */
+    Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear,
+                        MemoryTag tag = MemoryTag::General);
+
+    /**
+     * @brief Return an allocation to its block and reset it
+     */
+    void free(Allocation& allocation);
+
+    /**
+     * @brief Allocate and bind memory for a buffer
+     */
+    Allocation allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties,
+                                 MemoryTag tag = MemoryTag::General);
+
+    /** @brief Number of live VkDeviceMemory objects owned by the allocator */
+    uint32_t getDeviceAllocationCount() const { return deviceAllocationCount; }
+
+    /** @brief Bytes of VkDeviceMemory held from the driver (blocks and dedicated allocations) */
+    VkDeviceSize getReservedBytes() const { return reservedBytes.load(std::memory_order_relaxed); }
+
+    /** @brief Bytes handed out in live allocations */
+    VkDeviceSize getUsedBytes() const { return usedBytes.load(std::memory_order_relaxed); }
+
+    /** @brief Bytes handed out in live allocations of one subsystem */
+    VkDeviceSize getTaggedBytes(MemoryTag tag) const {
+        return taggedBytes[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Re-read the device-local heaps' budget and usage; call once per frame
+     *
+     * With VK_EXT_memory_budget these are the driver's figures for this process.
+     * Without it the budget is 80% of the heap sizes and the usage is what this
+     * allocator holds.
+     */
+    void updateBudget();
+
+    /** @brief Device-local bytes this process may use, as of the last updateBudget(); 0 before it */
+    VkDeviceSize getDeviceBudget() const { return deviceBudget.load(std::memory_order_relaxed); }
+
+    /** @brief Device-local bytes this process uses, as of the last updateBudget() */
+    VkDeviceSize getDeviceUsage() const { return deviceUsage.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Device-local bytes that may still be allocated while keeping a reserve of the budget free
+     *
+     * Unlimited until the first updateBudget().
+     */
+    VkDeviceSize getDeviceHeadroom() const;
+
+    /**
+     * @brief Log usage against budget and the bytes held by each subsystem
+     */
+    void logReport() const;
+
+    static constexpr VkDeviceSize DEVICE_BLOCK_SIZE = 64ull * 1024 * 1024;
+    static constexpr VkDeviceSize HOST_BLOCK_SIZE   = 16ull * 1024 * 1024;
+    static constexpr uint32_t     BUDGET_RESERVE    = 10;  // Percent of the budget headroom leaves free
+
+private:
+    struct FreeRange {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    struct Block {
+        VkDeviceMemory         memory = VK_NULL_HANDLE;
+        VkDeviceSize           size   = 0;
+        void*                  mapped = nullptr;
+        std::vector<FreeRange> freeRanges;  // Sorted by offset
+        uint32_t               liveCount = 0;
+    };
+
+    struct Pool {
+        uint32_t           memoryType = 0;
+        std::vector<Block> blocks;
+    };
+
+    VkDevice                         device         = VK_NULL_HANDLE;
+    VkPhysicalDevice                 physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    std::vector<Pool>                pools;  // Two per memory type: [type * 2 + (linear ? 0 : 1)]
+    uint32_t                         deviceAllocationCount = 0;
+    std::atomic<VkDeviceSize>        reservedBytes{0};  // Read without the lock (telemetry)
+    std::atomic<VkDeviceSize>        usedBytes{0};
+    std::atomic<VkDeviceSize>        taggedBytes[static_cast<size_t>(MemoryTag::Count)] = {};
+    VkDeviceSize                     heapReservedBytes[VK_MAX_MEMORY_HEAPS]              = {};
+    bool                             memoryBudgetSupported                               = false;
+    std::atomic<VkDeviceSize>        deviceBudget{0};
+    std::atomic<VkDeviceSize>        deviceUsage{0};
+    mutable std::mutex               mutex;
+
+    VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryType, void** outMapped);
+    void           freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryType);
+    bool           isHostVisible(uint32_t memoryType) const;
+    bool           allocateFromBlock(Block& block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset);
+    static void    releaseRange(Block& block, VkDeviceSize offset, VkDeviceSize size);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,54 @@
+#include "NameTable.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace DownPour {
+
+namespace {
+
+struct Storage {
+    std::mutex                                   mutex;
+    std::deque<std::string>                      strings;  // Indexed by NameId; a deque so strings never move
+    std::unordered_map<std::string_view, NameId> ids;      // Views into `strings`
+};
+
+Storage& storage() {
+    static Storage instance;
+    return instance;
+}
+
+}  // namespace
+
+NameId NameTable::intern(std::string_view name) {
+    Storage&                    s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.ids.find(name);
+    if (it != s.ids.end())
+        return it->second;
+
+    NameId id = static_cast<NameId>(s.strings.size());
+    s.strings.emplace_back(name);
+    s.ids.emplace(s.strings.back(), id);
+    return id;
+}
+
+NameId NameTable::find(std::string_view name) {
+    Storage&                    s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    auto it = s.ids.find(name);
+    return it != s.ids.end() ? it->second : INVALID_NAME_ID;
+}
+
+const std::string& NameTable::name(NameId id) {
+    static const std::string empty;
+
+    Storage&                    s = storage();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return id < s.strings.size() ? s.strings[id] : empty;
+}
+
+}  // namespace DownPour
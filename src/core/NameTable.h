@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace DownPour {
+
+/** @brief Interned string; equal names get equal ids for the life of the process */
+typedef uint32_t NameId;
+
+constexpr NameId INVALID_NAME_ID = 0xFFFFFFFF;
+
+/**
+ * @brief Process-wide string interning table
+ *
+ * Node names and entity roles are interned once, when nodes are created or
+ * tagged, so lookups afterwards compare and hash 32-bit ids instead of
+ * strings. Interned strings are never freed and their storage never moves:
+ * the reference name() returns stays valid. All methods are thread-safe.
+ */
+class NameTable {
+public:
+    /**
+     * @brief Id of `name`, adding it to the table if it is new
+     */
+    static NameId intern(std::string_view name);
+
+    /**
+     * @brief Id of `name`, or INVALID_NAME_ID if it was never interned
+     *
+     * Use for lookups: a name nobody interned cannot match anything.
+     */
+    static NameId find(std::string_view name);
+
+    /**
+     * @brief The string behind an id (empty for INVALID_NAME_ID)
+     */
+    static const std::string& name(NameId id);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,87 @@
+#include "PipelineCache.h"
+
+#include "logger/Logger.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace DownPour {
+
+void PipelineCache::load(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path) {
+    this->device = device;
+    this->path   = path;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+    std::vector<char> data;
+    std::ifstream     file(path, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file || !isCompatible(data)) {
+            DP_LOG(Warning, "PipelineCache: ignoring stale or foreign cache file %s", path.c_str());
+            data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData    = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(device, &createInfo, nullptr, &cache) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache");
+    }
+}
+
+void PipelineCache::save() const {
+    if (cache == VK_NULL_HANDLE || path.empty())
+        return;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(device, cache, &size, data.data()) != VK_SUCCESS)
+        return;
+
+    // Failing to persist the cache only costs the next launch some compile time
+    std::string   tempPath = path + ".tmp";
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        DP_LOG(Warning, "PipelineCache: cannot write %s", tempPath.c_str());
+        return;
+    }
+    file.write(data.data(), static_cast<std::streamsize>(size));
+    file.close();
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        DP_LOG(Warning, "PipelineCache: cannot replace %s: %s", path.c_str(), error.message().c_str());
+    }
+}
+
+void PipelineCache::destroy() {
+    if (cache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device, cache, nullptr);
+        cache = VK_NULL_HANDLE;
+    }
+}
+
+bool PipelineCache::isCompatible(const std::vector<char>& data) const {
+    // Header layout is fixed by the spec (VkPipelineCacheHeaderVersionOne)
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+        return false;
+    memcpy(&header, data.data(), sizeof(header));
+
+    return header.headerSize >= sizeof(header) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == deviceProperties.vendorID && header.deviceID == deviceProperties.deviceID &&
+           memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+}  // namespace DownPour
@@ -0,0 +1,50 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <string>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief VkPipelineCache persisted to disk between runs
+ *
+ * The cache file is only used when its header matches the current device
+ * (vendor, device ID and pipelineCacheUUID); a driver update or GPU change
+ * silently starts from an empty cache. Data is written to a temporary file and
+ * renamed so an interrupted save never leaves a truncated cache behind.
+ */
+class PipelineCache {
+public:
+    PipelineCache()  = default;
+    ~PipelineCache() = default;
+
+    /**
+     * @brief Create the cache, seeded from `path` when the file is valid for this device
+     */
+    void load(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path);
+
+    /**
+     * @brief Write the cache contents back to the path given to load()
+     */
+    void save() const;
+
+    /**
+     * @brief Destroy the cache object (does not save)
+     */
+    void destroy();
+
+    VkPipelineCache get() const { return cache; }
+
+private:
+    VkDevice                   device = VK_NULL_HANDLE;
+    VkPipelineCache            cache  = VK_NULL_HANDLE;
+    std::string                path;
+    VkPhysicalDeviceProperties deviceProperties{};
+
+    bool isCompatible(const std::vector<char>& data) const;
+};
+
+}  // namespace DownPour
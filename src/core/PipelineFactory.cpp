@@ -1,7 +1,10 @@
 #include "PipelineFactory.h"
 
-#include "../renderer/Vertex.h"
+#include "JobSystem.h"
+#include "SwapChainManager.h"
 
+#include <algorithm>
+#include <array>
 #include <filesystem>
 #include <fstream>
 #include <stdexcept>
@@ -9,13 +12,70 @@
 namespace DownPour {
 
 VkPipeline PipelineFactory::createPipeline(VkDevice device, const PipelineConfig& config, VkRenderPass renderPass,
-                                           VkExtent2D extent) {
-    auto vertShaderCode = readFile(config.vertShader);
-    auto fragShaderCode = readFile(config.fragShader);
-
+                                           VkPipelineCache cache) {
     VkShaderModule vertShaderModule = loadShaderModule(device, config.vertShader);
-    VkShaderModule fragShaderModule = loadShaderModule(device, config.fragShader);
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    VkPipeline     pipeline         = VK_NULL_HANDLE;
+    try {
+        fragShaderModule = loadShaderModule(device, config.fragShader);
+        pipeline         = buildPipeline(device, config, renderPass, cache, vertShaderModule, fragShaderModule);
+    } catch (...) {
+        vkDestroyShaderModule(device, fragShaderModule, nullptr);
+        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        throw;
+    }
+
+    vkDestroyShaderModule(device, fragShaderModule, nullptr);
+    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+
+    return pipeline;
+}
+
+void PipelineFactory::createPipelines(VkDevice device, const std::vector<PipelineRequest>& requests,
+                                      VkPipelineCache cache) {
+    if (requests.empty())
+        return;
 
+    // Each distinct SPIR-V file is read and turned into a module once, however many requests share it
+    std::vector<std::string> shaderFiles;
+    for (const PipelineRequest& request : requests) {
+        shaderFiles.push_back(request.config.vertShader);
+        shaderFiles.push_back(request.config.fragShader);
+    }
+    std::sort(shaderFiles.begin(), shaderFiles.end());
+    shaderFiles.erase(std::unique(shaderFiles.begin(), shaderFiles.end()), shaderFiles.end());
+
+    auto moduleOf = [&](const std::string& filename, const std::vector<VkShaderModule>& modules) {
+        auto it = std::lower_bound(shaderFiles.begin(), shaderFiles.end(), filename);
+        return modules[static_cast<size_t>(it - shaderFiles.begin())];
+    };
+
+    // vkCreateShaderModule and vkCreateGraphicsPipelines are free-threaded, and the
+    // pipeline cache synchronizes internally, so every request compiles on its own job
+    std::vector<VkShaderModule> modules(shaderFiles.size(), VK_NULL_HANDLE);
+    try {
+        JobSystem& jobs = JobSystem::get();
+        jobs.parallelFor(static_cast<uint32_t>(shaderFiles.size()), 1,
+                         [&](uint32_t i) { modules[i] = loadShaderModule(device, shaderFiles[i]); });
+        jobs.parallelFor(static_cast<uint32_t>(requests.size()), 1, [&](uint32_t i) {
+            const PipelineRequest& request = requests[i];
+            *request.output = buildPipeline(device, request.config, request.renderPass, cache,
+                                            moduleOf(request.config.vertShader, modules),
+                                            moduleOf(request.config.fragShader, modules));
+        });
+    } catch (...) {
+        for (VkShaderModule module : modules)
+            vkDestroyShaderModule(device, module, nullptr);
+        throw;
+    }
+
+    for (VkShaderModule module : modules)
+        vkDestroyShaderModule(device, module, nullptr);
+}
+
+VkPipeline PipelineFactory::buildPipeline(VkDevice device, const PipelineConfig& config, VkRenderPass renderPass,
+                                          VkPipelineCache cache, VkShaderModule vertShaderModule,
+                                          VkShaderModule fragShaderModule) {
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage  = VK_SHADER_STAGE_VERTEX_BIT;
@@ -28,41 +88,55 @@ VkPipeline PipelineFactory::createPipeline(VkDevice device, const PipelineConfig
     fragShaderStageInfo.module = fragShaderModule;
     fragShaderStageInfo.pName  = "main";
 
+    // Constants are packed back to back, so entry N reads the Nth word of the array
+    std::vector<VkSpecializationMapEntry> specializationEntries(config.specializationConstants.size());
+    for (uint32_t i = 0; i < specializationEntries.size(); i++) {
+        specializationEntries[i].constantID = i;
+        specializationEntries[i].offset     = i * static_cast<uint32_t>(sizeof(uint32_t));
+        specializationEntries[i].size       = sizeof(uint32_t);
+    }
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(specializationEntries.size());
+    specializationInfo.pMapEntries   = specializationEntries.data();
+    specializationInfo.dataSize      = config.specializationConstants.size() * sizeof(uint32_t);
+    specializationInfo.pData         = config.specializationConstants.data();
+    if (!config.specializationConstants.empty())
+        fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
+
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
-    auto bindingDescription    = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    const bool packed                = config.vertexFormat == VertexFormat::Packed;
+    auto       bindingDescription    = packed ? PackedVertex::getBindingDescription() : Vertex::getBindingDescription();
+    auto       attributeDescriptions = packed ? PackedVertex::getAttributeDescriptions()
+                                              : Vertex::getAttributeDescriptions();
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount   = 1;
-    vertexInputInfo.pVertexBindingDescriptions      = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexAttributeDescriptions    = attributeDescriptions.data();
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    if (config.useVertexInput) {
+        vertexInputInfo.vertexBindingDescriptionCount   = 1;
+        vertexInputInfo.pVertexBindingDescriptions      = &bindingDescription;
+        vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+        vertexInputInfo.pVertexAttributeDescriptions    = attributeDescriptions.data();
+    }
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
     inputAssembly.topology               = config.topology;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport{};
-    viewport.x        = 0.0f;
-    viewport.y        = 0.0f;
-    viewport.width    = static_cast<float>(extent.width);
-    viewport.height   = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = extent;
-
+    // Viewport and scissor are set at record time so a resize doesn't invalidate the pipeline
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports    = &viewport;
     viewportState.scissorCount  = 1;
-    viewportState.pScissors     = &scissor;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates    = dynamicStates;
 
     VkPipelineRasterizationStateCreateInfo rasterizer{};
     rasterizer.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -72,7 +146,9 @@ VkPipeline PipelineFactory::createPipeline(VkDevice device, const PipelineConfig
     rasterizer.lineWidth               = config.lineWidth;
     rasterizer.cullMode                = config.cullMode;
     rasterizer.frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable         = VK_FALSE;
+    rasterizer.depthBiasEnable         = config.depthBiasConstant != 0.0f || config.depthBiasSlope != 0.0f;
+    rasterizer.depthBiasConstantFactor = config.depthBiasConstant;
+    rasterizer.depthBiasSlopeFactor    = config.depthBiasSlope;
 
     VkPipelineMultisampleStateCreateInfo multisampling{};
     multisampling.sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
@@ -103,12 +179,48 @@ VkPipeline PipelineFactory::createPipeline(VkDevice device, const PipelineConfig
         colorBlendAttachment.blendEnable = VK_FALSE;
     }
 
+    // Weighted blended OIT: color and alpha sum into the accumulation target, while the
+    // revealage target multiplies by (1 - alpha), so the draw order doesn't matter
+    std::array<VkPipelineColorBlendAttachmentState, 2> oitBlendAttachments{};
+    oitBlendAttachments[0].blendEnable         = VK_TRUE;
+    oitBlendAttachments[0].srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].colorBlendOp        = VK_BLEND_OP_ADD;
+    oitBlendAttachments[0].srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[0].alphaBlendOp        = VK_BLEND_OP_ADD;
+    oitBlendAttachments[0].colorWriteMask      = colorBlendAttachment.colorWriteMask;
+    oitBlendAttachments[1].blendEnable         = VK_TRUE;
+    oitBlendAttachments[1].srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+    oitBlendAttachments[1].dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_COLOR;
+    oitBlendAttachments[1].colorBlendOp        = VK_BLEND_OP_ADD;
+    oitBlendAttachments[1].srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    oitBlendAttachments[1].dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    oitBlendAttachments[1].alphaBlendOp        = VK_BLEND_OP_ADD;
+    oitBlendAttachments[1].colorWriteMask      = VK_COLOR_COMPONENT_R_BIT;
+
+    // The main pass's opaque subpass: the scene color, the slot transparent variants write revealage to,
+    // then the motion vectors' two channels
+    std::array<VkPipelineColorBlendAttachmentState, SwapChainManager::OPAQUE_COLOR_TARGETS> opaqueBlendAttachments{};
+    opaqueBlendAttachments[0]                = colorBlendAttachment;
+    opaqueBlendAttachments[2].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT;
+
     VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType           = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable   = VK_FALSE;
-    colorBlending.logicOp         = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments    = &colorBlendAttachment;
+    colorBlending.sType         = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = VK_FALSE;
+    colorBlending.logicOp       = VK_LOGIC_OP_COPY;
+    if (config.depthOnly) {
+        colorBlending.attachmentCount = 0;
+    } else if (config.oitAccumulation) {
+        colorBlending.attachmentCount = static_cast<uint32_t>(oitBlendAttachments.size());
+        colorBlending.pAttachments    = oitBlendAttachments.data();
+    } else if (config.motionTarget) {
+        colorBlending.attachmentCount = static_cast<uint32_t>(opaqueBlendAttachments.size());
+        colorBlending.pAttachments    = opaqueBlendAttachments.data();
+    } else {
+        colorBlending.attachmentCount = 1;
+        colorBlending.pAttachments    = &colorBlendAttachment;
+    }
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -121,28 +233,54 @@ VkPipeline PipelineFactory::createPipeline(VkDevice device, const PipelineConfig
     pipelineInfo.pMultisampleState   = &multisampling;
     pipelineInfo.pDepthStencilState  = &depthStencil;
     pipelineInfo.pColorBlendState    = &colorBlending;
+    pipelineInfo.pDynamicState       = &dynamicState;
     pipelineInfo.layout              = config.layout;
     pipelineInfo.renderPass          = renderPass;
-    pipelineInfo.subpass             = 0;
+    pipelineInfo.subpass             = config.subpass;
     pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
 
     VkPipeline pipeline;
-    if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(device, cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create graphics pipeline");
     }
 
-    vkDestroyShaderModule(device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    return pipeline;
+}
+
+VkPipeline PipelineFactory::createComputePipeline(VkDevice device, const std::string& compShader,
+                                                  VkPipelineLayout layout, VkPipelineCache cache) {
+    VkShaderModule compShaderModule = loadShaderModule(device, compShader);
+
+    VkPipelineShaderStageCreateInfo compShaderStageInfo{};
+    compShaderStageInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    compShaderStageInfo.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+    compShaderStageInfo.module = compShaderModule;
+    compShaderStageInfo.pName  = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage  = compShaderStageInfo;
+    pipelineInfo.layout = layout;
+
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(device, cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute pipeline");
+    }
+
+    vkDestroyShaderModule(device, compShaderModule, nullptr);
 
     return pipeline;
 }
 
 VkPipelineLayout PipelineFactory::createPipelineLayout(VkDevice device,
-                                                       const std::vector<VkDescriptorSetLayout>& descriptorLayouts) {
+                                                       const std::vector<VkDescriptorSetLayout>& descriptorLayouts,
+                                                       const std::vector<VkPushConstantRange>&   pushConstants) {
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorLayouts.size());
-    pipelineLayoutInfo.pSetLayouts    = descriptorLayouts.data();
+    pipelineLayoutInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount         = static_cast<uint32_t>(descriptorLayouts.size());
+    pipelineLayoutInfo.pSetLayouts            = descriptorLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+    pipelineLayoutInfo.pPushConstantRanges    = pushConstants.data();
 
     VkPipelineLayout pipelineLayout;
     if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
@@ -3,6 +3,8 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "../renderer/Vertex.h"
+
 #include <string>
 #include <vector>
 
@@ -14,13 +16,31 @@ namespace DownPour {
 struct PipelineConfig {
     std::string                        vertShader;
     std::string                        fragShader;
-    VkPipelineLayout                   layout           = VK_NULL_HANDLE;
-    bool                               enableBlending   = false;
-    bool                               enableDepthWrite = true;
-    VkCullModeFlags                    cullMode         = VK_CULL_MODE_BACK_BIT;
-    VkPrimitiveTopology                topology         = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    float                              lineWidth        = 1.0f;
+    VkPipelineLayout                   layout            = VK_NULL_HANDLE;
+    bool                               enableBlending    = false;
+    bool                               oitAccumulation   = false;  // Weighted blended OIT targets (see car.frag)
+    bool                               depthOnly         = false;  // Subpass has no color attachments
+    bool                               motionTarget      = false;  // Main pass's opaque subpass: also motion
+    bool                               enableDepthWrite  = true;
+    float                              depthBiasConstant = 0.0f;  // Either non-zero enables depth bias
+    float                              depthBiasSlope    = 0.0f;
+    VkCullModeFlags                    cullMode          = VK_CULL_MODE_BACK_BIT;
+    VkPrimitiveTopology                topology          = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    float                              lineWidth         = 1.0f;
+    bool                               useVertexInput    = true;  // false: vertices generated from gl_VertexIndex
+    VertexFormat                       vertexFormat      = VertexFormat::Float;  // Must match the bound models
     std::vector<VkDescriptorSetLayout> descriptorLayouts;
+    std::vector<uint32_t>              specializationConstants;  // Fragment stage: element N is constant_id N
+    uint32_t                           subpass = 0;  // SwapChainManager::SUBPASS_*
+};
+
+/**
+ * @brief One pipeline of a PipelineFactory::createPipelines() batch
+ */
+struct PipelineRequest {
+    PipelineConfig config;
+    VkRenderPass   renderPass = VK_NULL_HANDLE;
+    VkPipeline*    output     = nullptr;  // Receives the created pipeline
 };
 
 /**
@@ -36,26 +56,66 @@ public:
     /**
      * @brief Create a graphics pipeline from configuration
      *
+     * Viewport and scissor are dynamic state, so the pipeline survives a
+     * swapchain resize; set both with vkCmdSetViewport/vkCmdSetScissor before drawing.
+     * Specialization constants are 32 bits each, so bools are passed as VK_TRUE/VK_FALSE.
+     *
      * @param device Vulkan logical device
      * @param config Pipeline configuration
      * @param renderPass Render pass the pipeline will be used with
-     * @param extent Viewport/scissor extent
+     * @param cache Optional pipeline cache to reuse compiled state from
      * @return Created pipeline handle
      */
     static VkPipeline createPipeline(VkDevice device, const PipelineConfig& config, VkRenderPass renderPass,
-                                     VkExtent2D extent);
+                                     VkPipelineCache cache = VK_NULL_HANDLE);
+
+    /**
+     * @brief Create a batch of graphics pipelines across the job system
+     *
+     * Every distinct shader file in the batch is loaded into a module once, then
+     * each request calls vkCreateGraphicsPipelines on its own job, all sharing
+     * @p cache. The modules are destroyed before returning. May be called from a
+     * job, so startup pipelines can compile while assets load.
+     *
+     * @param device Vulkan logical device
+     * @param requests Pipelines to create; each writes its handle to request.output
+     * @param cache Optional pipeline cache shared by every request
+     */
+    static void createPipelines(VkDevice device, const std::vector<PipelineRequest>& requests,
+                                VkPipelineCache cache = VK_NULL_HANDLE);
+
+    /**
+     * @brief Create a compute pipeline from a single shader
+     *
+     * @param device Vulkan logical device
+     * @param compShader Path to the SPIR-V compute shader
+     * @param layout Pipeline layout
+     * @param cache Optional pipeline cache to reuse compiled state from
+     * @return Created pipeline handle
+     */
+    static VkPipeline createComputePipeline(VkDevice device, const std::string& compShader, VkPipelineLayout layout,
+                                            VkPipelineCache cache = VK_NULL_HANDLE);
 
     /**
      * @brief Create a pipeline layout from descriptor set layouts
      *
      * @param device Vulkan logical device
      * @param descriptorLayouts Descriptor set layouts
+     * @param pushConstants Push constant ranges
      * @return Created pipeline layout handle
      */
     static VkPipelineLayout createPipelineLayout(VkDevice device,
-                                                 const std::vector<VkDescriptorSetLayout>& descriptorLayouts);
+                                                 const std::vector<VkDescriptorSetLayout>& descriptorLayouts,
+                                                 const std::vector<VkPushConstantRange>&   pushConstants = {});
 
 private:
+    /**
+     * @brief Create a graphics pipeline from already loaded shader modules
+     */
+    static VkPipeline buildPipeline(VkDevice device, const PipelineConfig& config, VkRenderPass renderPass,
+                                    VkPipelineCache cache, VkShaderModule vertShaderModule,
+                                    VkShaderModule fragShaderModule);
+
     /**
      * @brief Load shader module from SPIR-V file
      *
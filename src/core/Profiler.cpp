@@ -0,0 +1,146 @@
+#include "Profiler.h"
+
+#if defined(DOWNPOUR_PROFILING)
+
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DownPour {
+
+namespace {
+
+// One per recording thread. Only the owning thread writes zones; head is
+// published with release ordering so the exporter sees completed entries.
+struct ThreadBuffer {
+    uint32_t                          threadId = 0;
+    std::string                       name;  // Guarded by registryMutex
+    std::unique_ptr<Profiler::Zone[]> zones{new Profiler::Zone[Profiler::ZONES_PER_THREAD]};
+    std::atomic<uint64_t>             head{0};  // Total zones ever written
+};
+
+// Buffers are owned here rather than by their threads so zones from threads
+// that already exited still make it into the export. Exited threads hand their
+// buffer back for reuse; std::async starts fresh threads every frame and would
+// otherwise grow the registry without bound.
+std::mutex                                 registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+std::vector<ThreadBuffer*>                 retired;
+
+struct BufferLease {
+    ThreadBuffer* buffer;
+
+    BufferLease() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!retired.empty()) {
+            buffer = retired.back();
+            retired.pop_back();
+            return;
+        }
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        buffer           = registry.back().get();
+        buffer->threadId = static_cast<uint32_t>(registry.size());
+    }
+
+    ~BufferLease() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        retired.push_back(buffer);
+    }
+};
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& localBuffer() {
+    thread_local BufferLease lease;
+    return *lease.buffer;
+}
+
+void writeEscaped(std::ofstream& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+}
+
+}  // namespace
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Profiler::record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    ThreadBuffer&  buffer = localBuffer();
+    const uint64_t index  = buffer.head.load(std::memory_order_relaxed);
+
+    buffer.zones[index % ZONES_PER_THREAD] = {name, beginNs, endNs};
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const char* name) {
+    ThreadBuffer&               buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+bool Profiler::exportTrace(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        DP_LOG(Warning, "Failed to write profiler trace: %s", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    out << "{\"traceEvents\":[\n";
+    bool   first = true;
+    size_t total = 0;
+    for (const std::unique_ptr<ThreadBuffer>& buffer : registry) {
+        if (!buffer->name.empty()) {
+            out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+                << buffer->threadId << ",\"args\":{\"name\":\"";
+            writeEscaped(out, buffer->name);
+            out << "\"}}";
+            first = false;
+        }
+
+        // The owner keeps writing while we read. Copy the window first, then drop
+        // any slot the writer may have lapped during the copy.
+        const uint64_t headBefore = buffer->head.load(std::memory_order_acquire);
+        const uint64_t begin      = headBefore > ZONES_PER_THREAD ? headBefore - ZONES_PER_THREAD : 0;
+
+        std::vector<Zone> zones;
+        zones.reserve(static_cast<size_t>(headBefore - begin));
+        for (uint64_t i = begin; i < headBefore; i++)
+            zones.push_back(buffer->zones[i % ZONES_PER_THREAD]);
+
+        const uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+        const uint64_t firstSafe = headAfter > ZONES_PER_THREAD ? headAfter - ZONES_PER_THREAD : 0;
+        const size_t   skip      = static_cast<size_t>(std::min<uint64_t>(firstSafe - begin, zones.size()));
+
+        for (size_t i = skip; i < zones.size(); i++) {
+            const Zone&    zone     = zones[i];
+            const uint64_t duration = zone.endNs - zone.beginNs;  // Chrome wants microseconds
+            out << (first ? "" : ",\n") << "{\"ph\":\"X\",\"name\":\"" << zone.name << "\",\"pid\":1,\"tid\":"
+                << buffer->threadId << ",\"ts\":" << zone.beginNs / 1000 << "." << zone.beginNs % 1000 / 100
+                << ",\"dur\":" << duration / 1000 << "." << duration % 1000 / 100 << "}";
+            first = false;
+        }
+        total += zones.size() - skip;
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    DP_LOG(Info, "Wrote %zu profiler zones to %s", total, path.c_str());
+    return static_cast<bool>(out);
+}
+
+}  // namespace DownPour
+
+#endif  // DOWNPOUR_PROFILING
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace DownPour {
+
+/**
+ * @brief Scoped CPU zone profiler with chrome://tracing export
+ *
+ * Zones are recorded with DP_PROFILE_SCOPE("name") into a fixed ring buffer
+ * owned by the calling thread, so recording never locks or allocates. Each
+ * thread registers its buffer once; export() walks every registered buffer and
+ * writes a Chrome trace (open in chrome://tracing or ui.perfetto.dev). When a
+ * ring wraps only the most recent ZONES_PER_THREAD zones of that thread are
+ * kept. Buffers of exited threads are reused by new ones, so short-lived
+ * workers share a trace row.
+ *
+ * Built only with -DDOWNPOUR_PROFILING=ON; otherwise every macro expands to
+ * nothing and no profiler code is linked into the hot paths.
+ */
+class Profiler {
+public:
+    static constexpr uint32_t ZONES_PER_THREAD = 1u << 16;  // 64K zones, ~1.5 MB per thread
+
+    struct Zone {
+        const char* name;  // Must outlive the profiler (string literals)
+        uint64_t    beginNs;
+        uint64_t    endNs;
+    };
+
+    /**
+     * @brief RAII zone; records [construction, destruction) on the calling thread
+     */
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name(name), beginNs(now()) {}
+        ~Scope() { record(name, beginNs, now()); }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        uint64_t    beginNs;
+    };
+
+    /**
+     * @brief Label the calling thread in the exported trace
+     */
+    static void setThreadName(const char* name);
+
+    /**
+     * @brief Write every recorded zone as Chrome trace JSON
+     * @return false if the file could not be written
+     *
+     * Safe to call while other threads keep recording; zones being written
+     * during the export may be missing from it.
+     */
+    static bool exportTrace(const std::string& path);
+
+    static uint64_t now();
+
+private:
+    static void record(const char* name, uint64_t beginNs, uint64_t endNs);
+};
+
+}  // namespace DownPour
+
+#if defined(DOWNPOUR_PROFILING)
+#define DP_PROFILE_CONCAT_INNER(a, b) a##b
+#define DP_PROFILE_CONCAT(a, b)       DP_PROFILE_CONCAT_INNER(a, b)
+#define DP_PROFILE_SCOPE(name)        ::DownPour::Profiler::Scope DP_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define DP_PROFILE_FUNCTION()         DP_PROFILE_SCOPE(__func__)
+#define DP_PROFILE_THREAD_NAME(name)  ::DownPour::Profiler::setThreadName(name)
+#define DP_PROFILE_EXPORT(path)       ::DownPour::Profiler::exportTrace(path)
+#else
+#define DP_PROFILE_SCOPE(name)       ((void)0)
+#define DP_PROFILE_FUNCTION()        ((void)0)
+#define DP_PROFILE_THREAD_NAME(name) ((void)0)
+#define DP_PROFILE_EXPORT(path)      ((void)0)
+#endif
@@ -0,0 +1,633 @@
+#include "RenderGraph.h"
+
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+struct AccessInfo {
+    VkPipelineStageFlags stages;
+    VkAccessFlags        access;
+    VkImageLayout        layout;        // UNDEFINED for buffer-only accesses
+    bool                 computeQueue;  // Valid on a queue without graphics
+};
+
+constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+constexpr VkPipelineStageFlags FRAGMENT_TESTS =
+    VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+// Indexed by RenderAccess
+const std::array<AccessInfo, static_cast<size_t>(RenderAccess::Count)> ACCESS_INFO = {{
+    {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+     VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, false},
+    {FRAGMENT_TESTS, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+     VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, false},
+    {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false},
+    {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false},
+    {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true},
+    {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+     VK_IMAGE_LAYOUT_GENERAL, true},
+    {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, true},
+    {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false},
+    {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false},
+    {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, false},
+    {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, true},
+    {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true},
+    {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, false},
+}};
+
+const AccessInfo& accessInfo(RenderAccess access) {
+    return ACCESS_INFO[static_cast<size_t>(access)];
+}
+
+// Sampled views of depth/stencil images must name one aspect; barriers still cover both
+VkImageAspectFlags viewAspect(VkImageAspectFlags aspect) {
+    return (aspect & VK_IMAGE_ASPECT_DEPTH_BIT) != 0 ? VK_IMAGE_ASPECT_DEPTH_BIT : aspect;
+}
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(RenderResource resource, RenderAccess access) {
+    graph.passes[pass].uses.push_back({resource, access, RenderAccess::Count, false});
+    return *this;
+}
+
+RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(RenderResource resource, RenderAccess access,
+                                                          RenderAccess exit) {
+    graph.passes[pass].uses.push_back({resource, access, exit, true});
+    return *this;
+}
+
+void RenderGraph::init(VkDevice vkDevice, VkQueue computeQueue, uint32_t computeQueueFamily, uint32_t frameCount,
+                       bool timelines) {
+    device             = vkDevice;
+    asyncQueue         = computeQueue;
+    asyncQueueFamily   = computeQueueFamily;
+    framesInFlight     = frameCount;
+    timelineSemaphores = timelines;
+}
+
+void RenderGraph::destroy() {
+    for (Resource& resource : resources) {
+        if (!resource.transient)
+            continue;
+        if (resource.view != VK_NULL_HANDLE)
+            vkDestroyImageView(device, resource.view, nullptr);
+        if (resource.image != VK_NULL_HANDLE)
+            vkDestroyImage(device, resource.image, nullptr);
+        resource.view  = VK_NULL_HANDLE;
+        resource.image = VK_NULL_HANDLE;
+    }
+    for (Heap& heap : heaps) {
+        MemoryAllocator::get().free(heap.memory);
+    }
+    heaps.clear();
+
+    for (VkFence fence : asyncFences) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+    asyncFences.clear();
+    if (asyncPool != VK_NULL_HANDLE)
+        vkDestroyCommandPool(device, asyncPool, nullptr);  // Frees asyncCommands
+    asyncPool = VK_NULL_HANDLE;
+    asyncCommands.clear();
+    graphicsTimeline.destroy();
+    asyncTimeline.destroy();
+    compiled = false;
+}
+
+RenderResource RenderGraph::importImage(const std::string& name, VkImageAspectFlags aspect, bool perFrame) {
+    return importResource(name, true, aspect, perFrame);
+}
+
+RenderResource RenderGraph::importBuffer(const std::string& name, bool perFrame) {
+    return importResource(name, false, VK_IMAGE_ASPECT_COLOR_BIT, perFrame);
+}
+
+RenderResource RenderGraph::importResource(const std::string& name, bool isImage, VkImageAspectFlags aspect,
+                                           bool perFrame) {
+    const uint32_t       copies = perFrame ? std::max(framesInFlight, 1u) : 1;
+    const RenderResource first  = static_cast<RenderResource>(resources.size());
+    for (uint32_t i = 0; i < copies; i++) {
+        Resource resource;
+        resource.name        = copies > 1 ? name + " " + std::to_string(i) : name;
+        resource.isImage     = isImage;
+        resource.aspect      = aspect;
+        resource.frameCopies = i == 0 ? copies : 1;
+        resources.push_back(std::move(resource));
+    }
+    return first;
+}
+
+RenderResource RenderGraph::createImage(const std::string& name, const TransientImageDesc& desc) {
+    Resource resource;
+    resource.name      = name;
+    resource.transient = true;
+    resource.desc      = desc;
+    resource.aspect    = desc.aspect;
+    resources.push_back(std::move(resource));
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+void RenderGraph::setImage(RenderResource resource, VkImage image, bool discard) {
+    resources[resource].image = image;
+    if (discard)
+        resources[resource].state = AccessState{};
+}
+
+void RenderGraph::setBuffer(RenderResource resource, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) {
+    resources[resource].buffer = buffer;
+    resources[resource].offset = offset;
+    resources[resource].size   = size;
+}
+
+void RenderGraph::setFinalAccess(RenderResource resource, RenderAccess access) {
+    resources[resource].finalAccess = access;
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string& name, RenderQueue queue, RecordFn record) {
+    Pass pass;
+    pass.name   = name;
+    pass.queue  = queue;
+    pass.record = std::move(record);
+    passes.push_back(std::move(pass));
+    return PassBuilder(*this, static_cast<RenderPassId>(passes.size() - 1));
+}
+
+void RenderGraph::compile() {
+    if (compiled)
+        throw std::runtime_error("Render graph compiled twice");
+
+    placeAsyncPasses();
+    createTransients();
+
+    needed.assign(resources.size(), 0);
+    imageBarriers.reserve(resources.size());
+    bufferBarriers.reserve(resources.size());
+
+    uint32_t asyncCount  = 0;
+    bool     sharedAsync = false;
+    for (const Pass& pass : passes) {
+        asyncCount += pass.async ? 1 : 0;
+        for (const Use& use : pass.uses) {
+            sharedAsync = sharedAsync || (pass.async && resources[use.resource].graphicsUse);
+        }
+    }
+    if (sharedAsync) {
+        graphicsTimeline.init(device);
+        asyncTimeline.init(device);
+    }
+    if (asyncCount > 0) {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = asyncQueueFamily;
+        poolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &asyncPool) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create async compute command pool");
+
+        asyncCommands.resize(framesInFlight);
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool        = asyncPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = framesInFlight;
+        if (vkAllocateCommandBuffers(device, &allocInfo, asyncCommands.data()) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate async compute command buffers");
+
+        // Signalled, so the first wait on each slot returns at once
+        asyncFences.resize(framesInFlight);
+        VkFenceCreateInfo fenceInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        for (VkFence& fence : asyncFences) {
+            if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create async compute fence");
+        }
+    }
+
+    DP_LOG(Info, "Render graph: %zu passes (%u async compute%s), %.1f MB of transients in %.1f MB", passes.size(),
+           asyncCount, sharedAsync ? ", timeline synced" : "", static_cast<double>(transientBytes) / (1024.0 * 1024.0),
+           static_cast<double>(aliasedBytes) / (1024.0 * 1024.0));
+    compiled = true;
+}
+
+void RenderGraph::placeAsyncPasses() {
+    for (Pass& pass : passes) {
+        pass.async = pass.queue == RenderQueue::AsyncCompute && asyncQueue != VK_NULL_HANDLE;
+    }
+
+    // Async work is submitted before the frame's graphics work, so a pass only leaves the graphics queue if no
+    // graphics pass before it touches its resources; later ones wait on its timeline. Without timelines, or for
+    // transients (whose memory every alias would have to wait for), nothing may be shared at all. Demoting a
+    // pass can disqualify another, so repeat until stable
+    auto usedByGraphicsBefore = [this](const Pass& async, RenderResource resource) {
+        for (const Pass& pass : passes) {
+            if (&pass == &async)
+                return false;
+            for (const Use& use : pass.uses) {
+                if (!pass.async && use.resource == resource)
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (Resource& resource : resources) {
+            resource.graphicsUse = resource.finalAccess != RenderAccess::Count;
+            resource.asyncUse    = false;
+        }
+        for (const Pass& pass : passes) {
+            for (const Use& use : pass.uses) {
+                (pass.async ? resources[use.resource].asyncUse : resources[use.resource].graphicsUse) = true;
+            }
+        }
+
+        for (Pass& pass : passes) {
+            if (!pass.async)
+                continue;
+            for (const Use& use : pass.uses) {
+                const Resource& resource = resources[use.resource];
+                const bool      computeOnly =
+                    accessInfo(use.access).computeQueue &&
+                    (use.exit == RenderAccess::Count || accessInfo(use.exit).computeQueue);
+                const bool shared = resource.graphicsUse &&
+                                    (!timelineSemaphores || usedByGraphicsBefore(pass, use.resource));
+                if (shared || resource.transient || !computeOnly) {
+                    DP_LOG(Info, "Render graph: '%s' shares '%s' with the graphics queue; recording it there",
+                           pass.name.c_str(), resource.name.c_str());
+                    pass.async = false;
+                    changed    = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void RenderGraph::createTransients() {
+    // Lifetimes in declared order; every pass may run, so these hold whatever is culled in a frame
+    for (uint32_t p = 0; p < passes.size(); p++) {
+        for (const Use& use : passes[p].uses) {
+            Resource& resource = resources[use.resource];
+            resource.firstPass = std::min(resource.firstPass, p);
+            resource.lastPass  = std::max(resource.lastPass, p);
+        }
+    }
+
+    std::vector<uint32_t> order;
+    for (uint32_t r = 0; r < resources.size(); r++) {
+        Resource& resource = resources[r];
+        if (!resource.transient)
+            continue;
+        if (resource.firstPass == UINT32_MAX) {
+            DP_LOG(Warning, "Render graph: transient '%s' is never used", resource.name.c_str());
+            continue;
+        }
+
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+        imageInfo.extent        = {resource.desc.extent.width, resource.desc.extent.height, 1};
+        imageInfo.mipLevels     = 1;
+        imageInfo.arrayLayers   = resource.desc.layers;
+        imageInfo.format        = resource.desc.format;
+        imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageInfo.usage         = resource.desc.usage;
+        imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateImage(device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create transient image " + resource.name);
+
+        vkGetImageMemoryRequirements(device, resource.image, &resource.requirements);
+        transientBytes += resource.requirements.size;
+        order.push_back(r);
+    }
+
+    // Largest first, each at the lowest offset clear of every placed transient alive at the same time
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return resources[a].requirements.size > resources[b].requirements.size;
+    });
+    auto livesOverlap = [](const Resource& a, const Resource& b) {
+        return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+    };
+    auto memoryOverlaps = [](const Resource& a, const Resource& b) {
+        return a.heap == b.heap && a.heapOffset < b.heapOffset + b.requirements.size &&
+               b.heapOffset < a.heapOffset + a.requirements.size;
+    };
+
+    std::vector<VkDeviceSize> heapAlignments;
+    for (size_t i = 0; i < order.size(); i++) {
+        Resource& resource = resources[order[i]];
+
+        uint32_t heap = 0;
+        while (heap < heaps.size() && (heaps[heap].memoryTypeBits & resource.requirements.memoryTypeBits) == 0)
+            heap++;
+        if (heap == heaps.size()) {
+            heaps.push_back(Heap{resource.requirements.memoryTypeBits});
+            heapAlignments.push_back(1);
+        }
+        heaps[heap].memoryTypeBits &= resource.requirements.memoryTypeBits;
+        heapAlignments[heap] = std::max(heapAlignments[heap], resource.requirements.alignment);
+        resource.heap        = heap;
+        resource.heapOffset  = 0;
+
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            for (size_t j = 0; j < i; j++) {
+                const Resource& placed = resources[order[j]];
+                if (livesOverlap(resource, placed) && memoryOverlaps(resource, placed)) {
+                    resource.heapOffset = alignUp(placed.heapOffset + placed.requirements.size,
+                                                  resource.requirements.alignment);
+                    moved = true;
+                }
+            }
+        }
+        heaps[heap].size = std::max(heaps[heap].size, resource.heapOffset + resource.requirements.size);
+    }
+
+    for (size_t h = 0; h < heaps.size(); h++) {
+        VkMemoryRequirements requirements{heaps[h].size, heapAlignments[h], heaps[h].memoryTypeBits};
+        heaps[h].memory = MemoryAllocator::get().allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false);
+        if (!heaps[h].memory.isValid())
+            throw std::runtime_error("Failed to allocate render graph transient memory");
+        aliasedBytes += heaps[h].size;
+    }
+
+    for (uint32_t r : order) {
+        Resource&   resource = resources[r];
+        const Heap& heap     = heaps[resource.heap];
+        vkBindImageMemory(device, resource.image, heap.memory.memory, heap.memory.offset + resource.heapOffset);
+
+        const bool layered = resource.desc.layers > 1;
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image                           = resource.image;
+        viewInfo.viewType                        = layered ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format                          = resource.desc.format;
+        viewInfo.subresourceRange.aspectMask     = viewAspect(resource.desc.aspect);
+        viewInfo.subresourceRange.baseMipLevel   = 0;
+        viewInfo.subresourceRange.levelCount     = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount     = resource.desc.layers;
+        if (vkCreateImageView(device, &viewInfo, nullptr, &resource.view) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create transient image view " + resource.name);
+
+        // Whoever last used these bytes must be done before this image's first use in a frame (itself included)
+        for (uint32_t other : order) {
+            if (memoryOverlaps(resource, resources[other]))
+                resource.aliases.push_back(other);
+        }
+    }
+}
+
+void RenderGraph::execute(VkCommandBuffer cmd, uint32_t frameIndex) {
+    if (!compiled)
+        throw std::runtime_error("Render graph executed before compile()");
+
+    cullPasses();
+    for (Resource& resource : resources) {
+        resource.usedThisFrame = false;
+    }
+    frameNumber++;
+    graphicsWait = QueueWait{};
+    asyncWait    = QueueWait{};
+
+    bool asyncWork = false;
+    for (const Pass& pass : passes) {
+        asyncWork = asyncWork || (pass.live && pass.async);
+    }
+    if (asyncWork) {
+        // The slot's previous async submission may still be reading what this frame's passes write on the CPU
+        VkCommandBuffer asyncCmd = asyncCommands[frameIndex];
+        vkWaitForFences(device, 1, &asyncFences[frameIndex], VK_TRUE, UINT64_MAX);
+        vkResetFences(device, 1, &asyncFences[frameIndex]);
+        vkResetCommandBuffer(asyncCmd, 0);
+
+        VkCommandBufferBeginInfo begin{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(asyncCmd, &begin);
+        recordPasses(asyncCmd, frameIndex, true);
+        if (vkEndCommandBuffer(asyncCmd) != VK_SUCCESS)
+            throw std::runtime_error("Failed to record async compute command buffer");
+
+        // Recording found what this submission waits for: earlier frames' graphics work on shared resources
+        SubmitSemaphores semaphores;
+        if (asyncWait.value != 0)
+            semaphores.wait(graphicsTimeline.get(), asyncWait.stages, asyncWait.value);
+        if (asyncTimeline.isValid())
+            semaphores.signal(asyncTimeline.get(), frameNumber);
+
+        VkSubmitInfo submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers    = &asyncCmd;
+        semaphores.apply(submit);
+        if (vkQueueSubmit(asyncQueue, 1, &submit, asyncFences[frameIndex]) != VK_SUCCESS)
+            throw std::runtime_error("Failed to submit async compute work");
+    }
+
+    recordPasses(cmd, frameIndex, false);
+
+    // Hand imported resources on in the state their owner expects (e.g. presentable)
+    for (Resource& resource : resources) {
+        if (resource.finalAccess == RenderAccess::Count)
+            continue;
+        handOver(resource, resource.finalAccess, false);
+        transition(resource, resource.finalAccess);
+    }
+    flushBarriers(cmd);
+}
+
+void RenderGraph::addGraphicsSync(SubmitSemaphores& submit) const {
+    if (!graphicsTimeline.isValid())
+        return;
+    if (graphicsWait.value != 0)
+        submit.wait(asyncTimeline.get(), graphicsWait.stages, graphicsWait.value);
+    submit.signal(graphicsTimeline.get(), frameNumber);
+}
+
+void RenderGraph::cullPasses() {
+    // Backwards: a pass lives if it writes something persistent or something a live later pass reads
+    std::fill(needed.begin(), needed.end(), 0);
+    culledPasses = 0;
+    for (size_t p = passes.size(); p-- > 0;) {
+        Pass& pass = passes[p];
+        pass.live  = false;
+        if (!pass.enabled)
+            continue;
+
+        for (const Use& use : pass.uses) {
+            if (use.write && (!resources[use.resource].transient || needed[use.resource]))
+                pass.live = true;
+        }
+        if (!pass.live) {
+            culledPasses++;
+            continue;
+        }
+        for (const Use& use : pass.uses) {
+            if (!use.write)
+                needed[use.resource] = 1;
+        }
+    }
+}
+
+void RenderGraph::handOver(Resource& resource, RenderAccess access, bool async) {
+    const uint64_t lastFrame = resource.lastAsync ? resource.asyncFrame : resource.graphicsFrame;
+    if (resource.lastAsync != async && lastFrame != 0) {
+        // The other queue signals its timeline after everything it did to the resource; waiting for that makes
+        // those accesses available and visible, so only the layout carries over and barriers chain on the wait
+        QueueWait& wait = async ? asyncWait : graphicsWait;
+        wait.value      = std::max(wait.value, lastFrame);
+        wait.stages |= accessInfo(access).stages;
+
+        const VkImageLayout layout = resource.state.layout;
+        resource.state             = AccessState{};
+        resource.state.layout      = layout;
+    }
+    (async ? resource.asyncFrame : resource.graphicsFrame) = frameNumber;
+    resource.lastAsync                                     = async;
+}
+
+void RenderGraph::transition(Resource& resource, RenderAccess access) {
+    const AccessInfo& next  = accessInfo(access);
+    AccessState&      state = resource.state;
+    const bool        write = (next.access & WRITE_ACCESS) != 0;
+
+    VkPipelineStageFlags src       = 0;
+    VkAccessFlags        srcAccess = 0;
+    VkImageLayout        oldLayout = state.layout;
+    bool                 layoutChange;
+
+    if (resource.transient && !resource.usedThisFrame) {
+        // Nothing from before is kept, but the memory's previous users must be finished with it
+        for (uint32_t alias : resource.aliases) {
+            src |= resources[alias].state.writeStages | resources[alias].state.readStages;
+            srcAccess |= resources[alias].state.writeAccess;
+        }
+        oldLayout    = VK_IMAGE_LAYOUT_UNDEFINED;
+        layoutChange = true;
+    } else {
+        layoutChange = resource.isImage && state.layout != next.layout;
+        if (write || layoutChange) {
+            // Write-after-write waits on the last write, write-after-read on the reads since
+            src       = state.writeStages | state.readStages;
+            srcAccess = state.writeAccess;
+        } else if (state.writeStages != 0 && (next.stages & ~state.visibleStages) != 0) {
+            // Read-after-write, for stages the write has not been made visible to yet
+            src       = state.writeStages;
+            srcAccess = state.writeAccess;
+        }
+    }
+    resource.usedThisFrame = true;
+
+    if (write || layoutChange) {
+        // A layout transition counts as a write the next accesses must wait on
+        state.writeStages   = next.stages;
+        state.writeAccess   = next.access & WRITE_ACCESS;
+        state.readStages    = write ? 0 : next.stages;
+        state.visibleStages = next.stages;
+    } else {
+        state.readStages |= next.stages;
+        state.visibleStages |= next.stages;
+    }
+    if (resource.isImage)
+        state.layout = next.layout;
+
+    const bool bound = resource.isImage ? resource.image != VK_NULL_HANDLE : resource.buffer != VK_NULL_HANDLE;
+    if (!bound || (src == 0 && !layoutChange))
+        return;
+
+    // No earlier access: chain on the destination stages, where a submission's semaphore wait lands
+    srcStages |= src != 0 ? src : next.stages;
+    dstStages |= next.stages;
+
+    if (resource.isImage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = srcAccess;
+        barrier.dstAccessMask                   = next.access;
+        barrier.oldLayout                       = oldLayout;
+        barrier.newLayout                       = next.layout;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = resource.image;
+        barrier.subresourceRange.aspectMask     = resource.aspect;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+        imageBarriers.push_back(barrier);
+    } else {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask       = srcAccess;
+        barrier.dstAccessMask       = next.access;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer              = resource.buffer;
+        barrier.offset              = resource.offset;
+        barrier.size                = resource.size;
+        bufferBarriers.push_back(barrier);
+    }
+}
+
+void RenderGraph::flushBarriers(VkCommandBuffer cmd) {
+    if (imageBarriers.empty() && bufferBarriers.empty())
+        return;
+
+    vkCmdPipelineBarrier(cmd, srcStages, dstStages, 0, 0, nullptr, static_cast<uint32_t>(bufferBarriers.size()),
+                         bufferBarriers.data(), static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    imageBarriers.clear();
+    bufferBarriers.clear();
+    srcStages = 0;
+    dstStages = 0;
+}
+
+void RenderGraph::recordPasses(VkCommandBuffer cmd, uint32_t frameIndex, bool async) {
+    for (Pass& pass : passes) {
+        if (!pass.live || pass.async != async)
+            continue;
+
+        for (const Use& use : pass.uses) {
+            Resource& resource = frameCopy(use.resource, frameIndex);
+            handOver(resource, use.access, async);
+            transition(resource, use.access);
+        }
+        flushBarriers(cmd);
+
+        pass.record(cmd, frameIndex);
+
+        // The pass moved these on itself (its own barriers or render pass layouts)
+        for (const Use& use : pass.uses) {
+            if (use.exit == RenderAccess::Count)
+                continue;
+            Resource&         resource = frameCopy(use.resource, frameIndex);
+            const AccessInfo& exit     = accessInfo(use.exit);
+            AccessState&      state    = resource.state;
+            state.writeStages          = exit.stages;
+            state.writeAccess          = exit.access & WRITE_ACCESS;
+            state.readStages           = 0;
+            state.visibleStages        = exit.stages;
+            if (resource.isImage)
+                state.layout = exit.layout;
+        }
+    }
+}
+
+}  // namespace DownPour
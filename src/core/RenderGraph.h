@@ -0,0 +1,332 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/MemoryAllocator.h"
+#include "core/TimelineSemaphore.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief How a pass uses a resource; each maps to pipeline stages, access flags and (for images) a layout
+ */
+enum class RenderAccess : uint8_t {
+    ColorAttachment,      // COLOR_ATTACHMENT_OPTIMAL, read/write
+    DepthAttachment,      // DEPTH_STENCIL_ATTACHMENT_OPTIMAL, read/write
+    FragmentSampled,      // SHADER_READ_ONLY_OPTIMAL in fragment shaders
+    VertexSampled,        // SHADER_READ_ONLY_OPTIMAL in vertex shaders
+    ComputeSampled,       // SHADER_READ_ONLY_OPTIMAL in compute shaders
+    ComputeStorage,       // GENERAL / storage buffer, read/write in compute shaders
+    ComputeStorageRead,   // GENERAL / storage buffer, read in compute shaders
+    VertexStorageRead,    // Storage buffer read in vertex shaders
+    FragmentStorageRead,  // Storage buffer read in fragment shaders
+    IndirectRead,         // Indirect draw arguments
+    TransferSrc,          // TRANSFER_SRC_OPTIMAL / copy source
+    TransferDst,          // TRANSFER_DST_OPTIMAL / copy destination
+    Present,              // PRESENT_SRC_KHR, handed to the presentation engine
+    Count
+};
+
+/**
+ * @brief Queue a pass is recorded for
+ *
+ * AsyncCompute passes run on VulkanContext's compute-only queue when the
+ * device has one. Their resources must be imported, and any they share with
+ * graphics passes must only be used by graphics passes declared after them and
+ * needs timeline semaphores; otherwise they record in line on the graphics queue.
+ */
+enum class RenderQueue : uint8_t { Graphics, AsyncCompute };
+
+using RenderResource = uint32_t;
+using RenderPassId   = uint32_t;
+
+/**
+ * @brief A graph-owned image that lives within a frame and may share memory with others
+ */
+struct TransientImageDesc {
+    VkFormat           format = VK_FORMAT_UNDEFINED;
+    VkExtent2D         extent = {0, 0};
+    VkImageUsageFlags  usage  = 0;
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;  // Every aspect of the format; views take depth alone
+    uint32_t           layers = 1;                          // More than one gets a 2D array view
+};
+
+/**
+ * @brief Frame graph: orders passes, derives their barriers and aliases transient images
+ *
+ * Passes are declared once, in execution order, with the resources they read
+ * and write. Resources are either imported (owned elsewhere and persistent
+ * across frames, e.g. the swap chain image or the Hi-Z pyramid) or transient
+ * (created by compile() and valid only between their first and last use in a
+ * frame). compile() places transients whose lifetimes do not overlap at the
+ * same memory, so targets needed by only a stretch of the frame share
+ * allocations with those needed by another.
+ *
+ * Every frame, execute() drops disabled passes and any pass whose writes reach
+ * neither an enabled reader nor an imported resource, then records each
+ * surviving pass after one batched vkCmdPipelineBarrier. Barriers come from
+ * each resource's last access, carried across frames, so a pass only declares
+ * what it touches and never the hazards around it. Render passes recorded by
+ * a pass begin and end with their attachments in the declared layouts.
+ *
+ * Async compute passes record into the graph's own command buffer per frame
+ * slot and are submitted to the compute queue from execute(), ahead of the
+ * frame's graphics work. Each queue signals a timeline semaphore with the frame
+ * number, and a queue touching a resource the other queue used last waits for
+ * that frame there, at the stages of its first access; the caller adds the
+ * graphics side to its submission with addGraphicsSync(). Resources both queues
+ * use must be created VK_SHARING_MODE_CONCURRENT for both families
+ * (VulkanContext::getComputeSharingFamilies()). Imports made per frame have one
+ * resource per frame slot, so compute writing one slot's copy overlaps the
+ * previous frames' graphics work still reading theirs instead of waiting on it.
+ *
+ * Single-threaded: declare, compile and execute from the render thread.
+ * execute() makes no heap allocations.
+ */
+class RenderGraph {
+public:
+    using RecordFn = std::function<void(VkCommandBuffer cmd, uint32_t frameIndex)>;
+
+    /**
+     * @brief Declares one pass's resource uses; returned by addPass()
+     */
+    class PassBuilder {
+    public:
+        PassBuilder& read(RenderResource resource, RenderAccess access);
+
+        /**
+         * @brief Declare a write
+         * @param exit How the pass leaves the resource, if not as @p access (e.g. a copy followed by an
+         *             internal transition to an attachment)
+         */
+        PassBuilder& write(RenderResource resource, RenderAccess access, RenderAccess exit = RenderAccess::Count);
+
+        RenderPassId id() const { return pass; }
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, RenderPassId pass) : graph(graph), pass(pass) {}
+
+        RenderGraph& graph;
+        RenderPassId pass;
+    };
+
+    RenderGraph()  = default;
+    ~RenderGraph() = default;
+
+    RenderGraph(const RenderGraph&)            = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /**
+     * @param asyncQueue Compute-only queue, or VK_NULL_HANDLE to keep every pass on the graphics queue
+     * @param timelineSemaphores Whether async passes may share resources with graphics passes
+     */
+    void init(VkDevice device, VkQueue asyncQueue, uint32_t asyncQueueFamily, uint32_t framesInFlight,
+              bool timelineSemaphores);
+
+    /**
+     * @brief Destroy transients, their memory, the async command buffers and the timelines; the device must be idle
+     */
+    void destroy();
+
+    /**
+     * @brief Import resources owned elsewhere; call after init()
+     * @param perFrame One resource per frame slot, each bound through frameResource(); passes declare the
+     *                 returned handle and use the copy of the frame slot they execute in
+     */
+    RenderResource importImage(const std::string& name, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+                               bool perFrame = false);
+    RenderResource importBuffer(const std::string& name, bool perFrame = false);
+    RenderResource createImage(const std::string& name, const TransientImageDesc& desc);
+
+    /** @brief Frame slot @p frameIndex's copy of a per-frame import, for setImage() and setBuffer() */
+    RenderResource frameResource(RenderResource resource, uint32_t frameIndex) const {
+        return resources[resource].frameCopies > 1 ? resource + frameIndex : resource;
+    }
+
+    /**
+     * @brief Bind an imported image; may change every frame
+     * @param discard Forget the previous contents and layout (e.g. a newly acquired swap chain image)
+     */
+    void setImage(RenderResource resource, VkImage image, bool discard = false);
+
+    /**
+     * @brief Bind an imported buffer, or the range of it the graph tracks; may change every frame
+     */
+    void setBuffer(RenderResource resource, VkBuffer buffer, VkDeviceSize offset = 0,
+                   VkDeviceSize size = VK_WHOLE_SIZE);
+
+    /**
+     * @brief Access an imported resource is left in at the end of every frame (e.g. Present); not per frame
+     */
+    void setFinalAccess(RenderResource resource, RenderAccess access);
+
+    PassBuilder addPass(const std::string& name, RenderQueue queue, RecordFn record);
+
+    /**
+     * @brief Include or skip a pass from the next execute() on; passes start enabled
+     */
+    void setPassEnabled(RenderPassId pass, bool enabled) { passes[pass].enabled = enabled; }
+
+    /**
+     * @brief Place the passes on queues and create and alias the transient images; call once after declaring
+     */
+    void compile();
+
+    /**
+     * @brief Record every live pass; graphics passes into @p cmd, async ones submitted from here
+     *
+     * Record @p cmd outside any render pass, after the frame slot's fence has signalled.
+     */
+    void execute(VkCommandBuffer cmd, uint32_t frameIndex);
+
+    /**
+     * @brief Add the last execute()'s waits on async work and its timeline signal to the graphics submission
+     *
+     * Required for every submission of the command buffer execute() recorded into, once async passes share
+     * resources with graphics passes; the next frames' async work waits on the signal.
+     */
+    void addGraphicsSync(SubmitSemaphores& submit) const;
+
+    VkImage     getImage(RenderResource resource) const { return resources[resource].image; }
+    VkImageView getImageView(RenderResource resource) const { return resources[resource].view; }
+
+    /** @brief Whether @p pass runs on the async compute queue (known after compile()) */
+    bool isAsync(RenderPassId pass) const { return passes[pass].async; }
+
+    /** @brief Whether async passes share resources with graphics passes, joined by timeline semaphores */
+    bool hasQueueSync() const { return graphicsTimeline.isValid(); }
+
+    /** @brief Passes culled by the last execute() for having no live reader */
+    uint32_t getCulledPassCount() const { return culledPasses; }
+
+    /** @brief Bytes transient images would need without aliasing, and with it */
+    VkDeviceSize getTransientBytes() const { return transientBytes; }
+    VkDeviceSize getAliasedBytes() const { return aliasedBytes; }
+
+private:
+    // Last access to a resource: writes since which later readers must wait, and reads since the last write
+    struct AccessState {
+        VkPipelineStageFlags writeStages   = 0;
+        VkAccessFlags        writeAccess   = 0;
+        VkPipelineStageFlags readStages    = 0;
+        VkPipelineStageFlags visibleStages = 0;  // Readers the last write was already made visible to
+        VkImageLayout        layout        = VK_IMAGE_LAYOUT_UNDEFINED;
+    };
+
+    struct Resource {
+        std::string        name;
+        bool               isImage   = true;
+        bool               transient = false;
+        TransientImageDesc desc;
+        VkImageAspectFlags aspect      = VK_IMAGE_ASPECT_COLOR_BIT;
+        RenderAccess       finalAccess = RenderAccess::Count;
+
+        VkImage      image  = VK_NULL_HANDLE;
+        VkImageView  view   = VK_NULL_HANDLE;  // Transients only
+        VkBuffer     buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size   = VK_WHOLE_SIZE;
+
+        AccessState state;
+        bool        usedThisFrame = false;
+        uint32_t    frameCopies   = 1;  // Per-frame imports: this and the next frameCopies - 1 resources
+
+        // Frame numbers of the last use on each queue, the timeline value the other queue waits for
+        uint64_t graphicsFrame = 0;
+        uint64_t asyncFrame    = 0;
+        bool     lastAsync     = false;
+
+        // Transients: lifetime in declared pass order, placement, and the transients sharing its memory
+        uint32_t              firstPass  = UINT32_MAX;
+        uint32_t              lastPass   = 0;
+        uint32_t              heap       = 0;
+        VkDeviceSize          heapOffset = 0;
+        VkMemoryRequirements  requirements{};
+        std::vector<uint32_t> aliases;
+        bool                  asyncUse    = false;
+        bool                  graphicsUse = false;
+    };
+
+    struct Use {
+        RenderResource resource;
+        RenderAccess   access;
+        RenderAccess   exit;
+        bool           write;
+    };
+
+    struct Pass {
+        std::string      name;
+        RenderQueue      queue = RenderQueue::Graphics;
+        RecordFn         record;
+        std::vector<Use> uses;
+        bool             enabled = true;
+        bool             async   = false;
+        bool             live    = false;  // This frame
+    };
+
+    struct Heap {
+        uint32_t     memoryTypeBits = 0;
+        VkDeviceSize size           = 0;
+        Allocation   memory;
+    };
+
+    // What one queue's submission of this frame waits for on the other queue's timeline
+    struct QueueWait {
+        uint64_t             value  = 0;
+        VkPipelineStageFlags stages = 0;
+    };
+
+    VkDevice                     device           = VK_NULL_HANDLE;
+    VkQueue                      asyncQueue       = VK_NULL_HANDLE;
+    uint32_t                     asyncQueueFamily = 0;
+    uint32_t                     framesInFlight   = 0;
+    VkCommandPool                asyncPool        = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> asyncCommands;  // One per frame slot
+    std::vector<VkFence>         asyncFences;
+    bool                         timelineSemaphores = false;
+    bool                         compiled           = false;
+
+    // Signalled with frameNumber by each queue's submission of a frame
+    TimelineSemaphore graphicsTimeline;
+    TimelineSemaphore asyncTimeline;
+    uint64_t          frameNumber = 0;
+    QueueWait         graphicsWait;
+    QueueWait         asyncWait;
+
+    std::vector<Resource> resources;
+    std::vector<Pass>     passes;
+    std::vector<Heap>     heaps;
+
+    // Per-frame scratch, sized by compile() so execute() does not allocate
+    std::vector<uint8_t>               needed;
+    std::vector<VkImageMemoryBarrier>  imageBarriers;
+    std::vector<VkBufferMemoryBarrier> bufferBarriers;
+    VkPipelineStageFlags               srcStages = 0;
+    VkPipelineStageFlags               dstStages = 0;
+
+    uint32_t     culledPasses   = 0;
+    VkDeviceSize transientBytes = 0;
+    VkDeviceSize aliasedBytes   = 0;
+
+    RenderResource importResource(const std::string& name, bool isImage, VkImageAspectFlags aspect, bool perFrame);
+    Resource&      frameCopy(RenderResource resource, uint32_t frameIndex) {
+        return resources[frameResource(resource, frameIndex)];
+    }
+
+    void placeAsyncPasses();
+    void createTransients();
+    void cullPasses();
+    void handOver(Resource& resource, RenderAccess access, bool async);
+    void transition(Resource& resource, RenderAccess access);
+    void flushBarriers(VkCommandBuffer cmd);
+    void recordPasses(VkCommandBuffer cmd, uint32_t frameIndex, bool async);
+};
+
+}  // namespace DownPour
@@ -6,101 +6,85 @@ namespace DownPour {
 
 void ResourceManager::createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize size,
                                    VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                                   VkDeviceMemory& bufferMemory) {
+                                   Allocation& allocation, MemoryTag tag, const std::vector<uint32_t>& queueFamilies) {
+    const bool concurrent = queueFamilies.size() > 1;
+
     VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size        = size;
-    bufferInfo.usage       = usage;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size                  = size;
+    bufferInfo.usage                 = usage;
+    bufferInfo.sharingMode           = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    bufferInfo.queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(queueFamilies.size()) : 0;
+    bufferInfo.pQueueFamilyIndices   = concurrent ? queueFamilies.data() : nullptr;
 
     if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create buffer!");
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize  = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
+    // Sub-allocated from a pooled block and bound at its offset
+    allocation = MemoryAllocator::get().allocateForBuffer(buffer, properties, tag);
+}
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory!");
+void ResourceManager::destroyBuffer(VkDevice device, VkBuffer& buffer, Allocation& allocation) {
+    if (buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
     }
-
-    vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    MemoryAllocator::get().free(allocation);
 }
 
-void ResourceManager::copyBuffer(VkDevice device, VkCommandPool commandPool, VkQueue graphicsQueue,
-                                 VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool        = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferCopy copyRegion{};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+UploadFuture ResourceManager::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+    return UploadManager::get().copyBuffer(srcBuffer, dstBuffer, size);
 }
 
 void ResourceManager::createImage(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height,
                                   VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-                                  VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) {
+                                  VkMemoryPropertyFlags properties, VkImage& image, Allocation& allocation,
+                                  MemoryTag tag, const std::vector<uint32_t>& queueFamilies) {
+    const bool concurrent = queueFamilies.size() > 1;
+
     VkImageCreateInfo imageInfo{};
-    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width  = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth  = 1;
-    imageInfo.mipLevels     = 1;
-    imageInfo.arrayLayers   = 1;
-    imageInfo.format        = format;
-    imageInfo.tiling        = tiling;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage         = usage;
-    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType             = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width          = width;
+    imageInfo.extent.height         = height;
+    imageInfo.extent.depth          = 1;
+    imageInfo.mipLevels             = 1;
+    imageInfo.arrayLayers           = 1;
+    imageInfo.format                = format;
+    imageInfo.tiling                = tiling;
+    imageInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage                 = usage;
+    imageInfo.samples               = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode           = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(queueFamilies.size()) : 0;
+    imageInfo.pQueueFamilyIndices   = concurrent ? queueFamilies.data() : nullptr;
 
     if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create image!");
     }
 
+    allocateImageMemory(device, image, tiling, properties, allocation, tag);
+}
+
+void ResourceManager::allocateImageMemory(VkDevice device, VkImage image, VkImageTiling tiling,
+                                          VkMemoryPropertyFlags properties, Allocation& allocation,
+                                          MemoryTag tag) {
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(device, image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize  = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
+    // Linear images share pools with buffers; optimal images get their own to respect bufferImageGranularity
+    allocation =
+        MemoryAllocator::get().allocate(memRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR, tag);
+    vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+}
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate image memory!");
+void ResourceManager::destroyImage(VkDevice device, VkImage& image, Allocation& allocation) {
+    if (image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, image, nullptr);
+        image = VK_NULL_HANDLE;
     }
-
-    vkBindImageMemory(device, image, imageMemory, 0);
+    MemoryAllocator::get().free(allocation);
 }
 
 uint32_t ResourceManager::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
@@ -3,6 +3,9 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+
 #include <vector>
 
 namespace DownPour {
@@ -11,6 +14,8 @@ namespace DownPour {
  * @brief Manages Vulkan resource creation and memory management
  *
  * Handles buffer creation, image creation, memory allocation, and descriptor sets.
+ * All memory comes from the pooled MemoryAllocator; pair every create with the
+ * matching destroy so sub-allocations are returned to their block.
  */
 class ResourceManager {
 public:
@@ -26,24 +31,31 @@ public:
      * @param usage Buffer usage flags
      * @param properties Memory property flags
      * @param buffer Output buffer handle
-     * @param bufferMemory Output memory handle
+     * @param allocation Output sub-allocation (host-visible memory is persistently mapped)
+     * @param tag Subsystem the memory is accounted to
+     * @param queueFamilies Families that use the buffer concurrently; with fewer than two it is exclusive
      */
     static void createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize size,
                             VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                            VkDeviceMemory& bufferMemory);
+                            Allocation& allocation, MemoryTag tag = MemoryTag::General,
+                            const std::vector<uint32_t>& queueFamilies = {});
+
+    /**
+     * @brief Destroy a buffer created by createBuffer() and release its memory
+     */
+    static void destroyBuffer(VkDevice device, VkBuffer& buffer, Allocation& allocation);
 
     /**
-     * @brief Copy data between buffers using a command buffer
+     * @brief Copy data between buffers on the upload queue
+     *
+     * The copy joins the current UploadManager batch and is not waited on.
      *
-     * @param device Vulkan logical device
-     * @param commandPool Command pool for temporary command buffer
-     * @param graphicsQueue Queue to submit copy command
      * @param srcBuffer Source buffer
      * @param dstBuffer Destination buffer
      * @param size Number of bytes to copy
+     * @return Future that completes when the copy has executed
      */
-    static void copyBuffer(VkDevice device, VkCommandPool commandPool, VkQueue graphicsQueue, VkBuffer srcBuffer,
-                          VkBuffer dstBuffer, VkDeviceSize size);
+    static UploadFuture copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
 
     /**
      * @brief Create a Vulkan image with memory
@@ -57,11 +69,26 @@ public:
      * @param usage Image usage flags
      * @param properties Memory property flags
      * @param image Output image handle
-     * @param imageMemory Output memory handle
+     * @param allocation Output sub-allocation
+     * @param tag Subsystem the memory is accounted to
+     * @param queueFamilies Families that use the image concurrently; with fewer than two it is exclusive
      */
     static void createImage(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height,
                            VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-                           VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
+                           VkMemoryPropertyFlags properties, VkImage& image, Allocation& allocation,
+                           MemoryTag tag = MemoryTag::General, const std::vector<uint32_t>& queueFamilies = {});
+
+    /**
+     * @brief Allocate and bind memory for an image the caller created itself
+     */
+    static void allocateImageMemory(VkDevice device, VkImage image, VkImageTiling tiling,
+                                    VkMemoryPropertyFlags properties, Allocation& allocation,
+                                    MemoryTag tag = MemoryTag::General);
+
+    /**
+     * @brief Destroy an image created by createImage() and release its memory
+     */
+    static void destroyImage(VkDevice device, VkImage& image, Allocation& allocation);
 
     /**
      * @brief Find suitable memory type from requirements
@@ -1,5 +1,7 @@
 #include "SwapChainManager.h"
 
+#include "ResourceManager.h"
+
 #include <stdexcept>
 #include <algorithm>
 #include <array>
@@ -7,18 +9,38 @@
 namespace DownPour {
 
 void SwapChainManager::initialize(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
-                                  GLFWwindow* window, VkFormat depthFmt) {
+                                  GLFWwindow* window, VkFormat depthFmt, uint32_t framesInFlight) {
     this->depthFormat = depthFmt;
-    createSwapChain(device, physicalDevice, surface, window);
+    createSwapChain(device, physicalDevice, surface, window, framesInFlight);
+    createImageViews(device);
+    createRenderPass(device);
+}
+
+void SwapChainManager::initializeOffscreen(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D extent,
+                                           VkFormat depthFmt, uint32_t imageCount) {
+    this->depthFormat    = depthFmt;
+    swapchainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;  // Same as the preferred surface format, so pipelines match
+    swapchainExtent      = extent;
+
+    swapchainImages.resize(imageCount);
+    offscreenMemory.resize(imageCount);
+    for (uint32_t i = 0; i < imageCount; i++) {
+        ResourceManager::createImage(device, physicalDevice, extent.width, extent.height, swapchainImageFormat,
+                                     VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, swapchainImages[i], offscreenMemory[i]);
+    }
+
     createImageViews(device);
     createRenderPass(device);
 }
 
 void SwapChainManager::cleanup(VkDevice device) {
-    for (auto framebuffer : swapchainFramebuffers) {
+    if (framebuffer != VK_NULL_HANDLE) {
         vkDestroyFramebuffer(device, framebuffer, nullptr);
+        framebuffer = VK_NULL_HANDLE;
     }
-    swapchainFramebuffers.clear();
 
     for (auto imageView : swapchainImageViews) {
         vkDestroyImageView(device, imageView, nullptr); 
@@ -34,17 +56,25 @@ void SwapChainManager::cleanup(VkDevice device) {
         vkDestroySwapchainKHR(device, swapchain, nullptr);
         swapchain = VK_NULL_HANDLE;
     }
+
+    // Offscreen targets are owned here; swap chain images belong to the swap chain
+    for (size_t i = 0; i < offscreenMemory.size(); i++) {
+        ResourceManager::destroyImage(device, swapchainImages[i], offscreenMemory[i]);
+    }
+    offscreenMemory.clear();
+    swapchainImages.clear();
 }
 
 void SwapChainManager::createSwapChain(VkDevice device, VkPhysicalDevice physicalDevice,
-                                       VkSurfaceKHR surface, GLFWwindow* window) {
+                                       VkSurfaceKHR surface, GLFWwindow* window, uint32_t framesInFlight) {
     Vulkan::SwapChainSupportDetails swapChainSupport = querySwapChainSupport(physicalDevice, surface);
 
     VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
     VkPresentModeKHR   presentMode   = chooseSwapPresentMode(swapChainSupport.presentModes);
     VkExtent2D         extent        = chooseSwapExtent(swapChainSupport.capabilities, window);
 
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+    // One image on screen plus one per frame in flight; more would only add queueing latency
+    uint32_t imageCount = std::max(swapChainSupport.capabilities.minImageCount, framesInFlight + 1);
     if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
         imageCount = swapChainSupport.capabilities.maxImageCount;
     }
@@ -57,7 +87,11 @@ void SwapChainManager::createSwapChain(VkDevice device, VkPhysicalDevice physica
     createInfo.imageColorSpace  = surfaceFormat.colorSpace;
     createInfo.imageExtent      = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    createInfo.imageUsage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+    // The scene renders offscreen and is blitted or copied in (see TemporalUpscaler)
+    if (!(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+        throw std::runtime_error("Swap chain images cannot be transfer destinations");
 
     // For simplicity, use exclusive sharing mode (most common case)
     createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -111,75 +145,152 @@ void SwapChainManager::createRenderPass(VkDevice device) {
     colorAttachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;  // The render graph moves every
+    colorAttachment.finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;  // attachment in and out of the pass
 
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    // Motion vectors, cleared to "held still"; stored for the temporal upscaler
+    VkAttachmentDescription motionAttachment = colorAttachment;
+    motionAttachment.format                  = MOTION_FORMAT;
+
+    std::array<VkAttachmentReference, OPAQUE_COLOR_TARGETS> opaqueTargetRefs = {{
+        colorAttachmentRef,
+        {VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED},
+        {4, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+    }};
+
     VkAttachmentDescription depthAttachment{};
     depthAttachment.format         = depthFormat;
     depthAttachment.samples        = VK_SAMPLE_COUNT_1_BIT;
     depthAttachment.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;  // Reduced into the Hi-Z pyramid after the pass
     depthAttachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depthAttachment.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.initialLayout  = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depthAttachment.finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference depthAttachmentRef{};
     depthAttachmentRef.attachment = 1;
     depthAttachmentRef.layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount    = 1;
-    subpass.pColorAttachments       = &colorAttachmentRef;
-    subpass.pDepthStencilAttachment = &depthAttachmentRef;
-
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass    = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass    = 0;
-    dependency.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    std::array<VkAttachmentDescription, 2> attachments = {colorAttachment, depthAttachment};
+    // OIT targets live only within the pass: cleared to "nothing accumulated, fully revealed"
+    VkAttachmentDescription accumAttachment{};
+    accumAttachment.format         = OIT_ACCUM_FORMAT;
+    accumAttachment.samples        = VK_SAMPLE_COUNT_1_BIT;
+    accumAttachment.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    accumAttachment.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    accumAttachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    accumAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    accumAttachment.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    accumAttachment.finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentDescription revealageAttachment = accumAttachment;
+    revealageAttachment.format                  = OIT_REVEALAGE_FORMAT;
+
+    // Transparent subpass: accumulate into both OIT targets, depth-tested against the opaque surfaces
+    std::array<VkAttachmentReference, 2> oitTargetRefs = {{
+        {2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {3, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+    }};
+    VkAttachmentReference readOnlyDepthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+
+    // Composite subpass: read the OIT targets at the same pixel, blend over the color attachment
+    std::array<VkAttachmentReference, 2> oitInputRefs = {{
+        {2, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {3, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+    }};
+    // Depth is stored for the Hi-Z pyramid and motion for the upscaler, so both must survive the later subpasses
+    uint32_t                preservedMotion    = 4;
+    std::array<uint32_t, 2> preservedComposite = {1, 4};
+
+    std::array<VkSubpassDescription, 3> subpasses{};
+    subpasses[SUBPASS_OPAQUE].pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_OPAQUE].colorAttachmentCount    = static_cast<uint32_t>(opaqueTargetRefs.size());
+    subpasses[SUBPASS_OPAQUE].pColorAttachments       = opaqueTargetRefs.data();
+    subpasses[SUBPASS_OPAQUE].pDepthStencilAttachment = &depthAttachmentRef;
+
+    subpasses[SUBPASS_TRANSPARENT].pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_TRANSPARENT].colorAttachmentCount    = static_cast<uint32_t>(oitTargetRefs.size());
+    subpasses[SUBPASS_TRANSPARENT].pColorAttachments       = oitTargetRefs.data();
+    subpasses[SUBPASS_TRANSPARENT].pDepthStencilAttachment = &readOnlyDepthRef;
+    subpasses[SUBPASS_TRANSPARENT].preserveAttachmentCount = 1;
+    subpasses[SUBPASS_TRANSPARENT].pPreserveAttachments    = &preservedMotion;
+
+    subpasses[SUBPASS_COMPOSITE].pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[SUBPASS_COMPOSITE].inputAttachmentCount    = static_cast<uint32_t>(oitInputRefs.size());
+    subpasses[SUBPASS_COMPOSITE].pInputAttachments       = oitInputRefs.data();
+    subpasses[SUBPASS_COMPOSITE].colorAttachmentCount    = 1;
+    subpasses[SUBPASS_COMPOSITE].pColorAttachments       = &colorAttachmentRef;
+    subpasses[SUBPASS_COMPOSITE].preserveAttachmentCount = static_cast<uint32_t>(preservedComposite.size());
+    subpasses[SUBPASS_COMPOSITE].pPreserveAttachments    = preservedComposite.data();
+
+    // Entry and exit barriers come from the render graph; these only order the subpasses
+    std::array<VkSubpassDependency, 3> dependencies{};
+
+    // Transparent fragments test against the finished opaque depth
+    dependencies[0].srcSubpass      = SUBPASS_OPAQUE;
+    dependencies[0].dstSubpass      = SUBPASS_TRANSPARENT;
+    dependencies[0].srcStageMask    = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask    = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    dependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // The composite reads what the transparent subpass accumulated
+    dependencies[1].srcSubpass      = SUBPASS_TRANSPARENT;
+    dependencies[1].dstSubpass      = SUBPASS_COMPOSITE;
+    dependencies[1].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask   = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    // ...and blends over the opaque color
+    dependencies[2].srcSubpass      = SUBPASS_OPAQUE;
+    dependencies[2].dstSubpass      = SUBPASS_COMPOSITE;
+    dependencies[2].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    std::array<VkAttachmentDescription, ATTACHMENT_COUNT> attachments = {
+        colorAttachment, depthAttachment, accumAttachment, revealageAttachment, motionAttachment};
 
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 2;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
     renderPassInfo.pAttachments    = attachments.data();
-    renderPassInfo.subpassCount    = 1;
-    renderPassInfo.pSubpasses      = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies   = &dependency;
+    renderPassInfo.subpassCount    = static_cast<uint32_t>(subpasses.size());
+    renderPassInfo.pSubpasses      = subpasses.data();
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies   = dependencies.data();
 
     if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create render pass!");
     }
 }
 
-void SwapChainManager::createFramebuffers(VkDevice device, VkImageView depthImageView) {
-    swapchainFramebuffers.resize(swapchainImageViews.size());
-
-    for (size_t i = 0; i < swapchainImageViews.size(); i++) {
-        std::array<VkImageView, 2> attachments = {swapchainImageViews[i], depthImageView};
-
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass      = renderPass;
-        framebufferInfo.attachmentCount = 2;
-        framebufferInfo.pAttachments    = attachments.data();
-        framebufferInfo.width           = swapchainExtent.width;
-        framebufferInfo.height          = swapchainExtent.height;
-        framebufferInfo.layers          = 1;
-
-        if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &swapchainFramebuffers[i]) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to create framebuffer!");
-        }
+void SwapChainManager::createFramebuffer(VkDevice device, VkImageView colorImageView, VkImageView depthImageView,
+                                         VkImageView accumImageView, VkImageView revealageImageView,
+                                         VkImageView motionImageView) {
+    std::array<VkImageView, ATTACHMENT_COUNT> attachments = {colorImageView, depthImageView, accumImageView,
+                                                             revealageImageView, motionImageView};
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass      = renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments    = attachments.data();
+    framebufferInfo.width           = swapchainExtent.width;
+    framebufferInfo.height          = swapchainExtent.height;
+    framebufferInfo.layers          = 1;
+
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create framebuffer!");
     }
 }
 
@@ -3,6 +3,7 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include "../vulkan/VulkanTypes.h"
+#include "MemoryAllocator.h"
 
 #include <vector>
 
@@ -27,9 +28,46 @@ public:
      * @param surface Window surface
      * @param window GLFW window for extent queries
      * @param depthFormat Format for depth attachment
+     * @param framesInFlight Frames the CPU may queue; the image count follows it (framesInFlight + 1)
      */
     void initialize(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
-                   GLFWwindow* window, VkFormat depthFormat);
+                   GLFWwindow* window, VkFormat depthFormat, uint32_t framesInFlight);
+
+    /**
+     * @brief Create offscreen color targets in place of a swap chain (headless rendering)
+     *
+     * The images, views, render pass and framebuffers are exposed through the same
+     * accessors, so recording code is unchanged. There is no swap chain to acquire
+     * from or present to; each frame ends with its image in TRANSFER_SRC_OPTIMAL.
+     *
+     * @param device Vulkan logical device
+     * @param physicalDevice Vulkan physical device
+     * @param extent Render target size
+     * @param depthFormat Format for depth attachment
+     * @param imageCount Number of color targets (one per frame in flight)
+     */
+    void initializeOffscreen(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D extent,
+                             VkFormat depthFormat, uint32_t imageCount);
+
+    bool isOffscreen() const { return !offscreenMemory.empty(); }
+
+    // Subpasses of the render pass. Opaque geometry writes color, motion vectors and depth; transparent
+    // geometry then accumulates into the weighted blended OIT targets (depth-tested, not written), and the
+    // composite resolves those over the color attachment.
+    static constexpr uint32_t SUBPASS_OPAQUE      = 0;
+    static constexpr uint32_t SUBPASS_TRANSPARENT = 1;
+    static constexpr uint32_t SUBPASS_COMPOSITE   = 2;
+
+    // Framebuffer attachments: scene color, depth, the OIT accumulation and revealage targets, then motion
+    static constexpr uint32_t ATTACHMENT_COUNT     = 5;
+    static constexpr VkFormat OIT_ACCUM_FORMAT     = VK_FORMAT_R16G16B16A16_SFLOAT;  // Sum of weighted color, alpha
+    static constexpr VkFormat OIT_REVEALAGE_FORMAT = VK_FORMAT_R16_SFLOAT;           // Product of (1 - alpha)
+    static constexpr VkFormat MOTION_FORMAT        = VK_FORMAT_R16G16_SFLOAT;        // Screen UV moved since last frame
+
+    // The opaque subpass's color attachments line up with the scene shaders' outputs: color at location 0,
+    // nothing at 1 (the transparent variants' revealage), motion at 2. Pipelines in it set
+    // PipelineConfig::motionTarget
+    static constexpr uint32_t OPAQUE_COLOR_TARGETS = 3;
 
     /**
      * @brief Clean up swap chain resources
@@ -44,12 +82,16 @@ public:
 
     const std::vector<VkImage>& getImages() const { return swapchainImages; }
     const std::vector<VkImageView>& getImageViews() const { return swapchainImageViews; }
-    const std::vector<VkFramebuffer>& getFramebuffers() const { return swapchainFramebuffers; }
+    VkFramebuffer getFramebuffer() const { return framebuffer; }
 
     /**
-     * @brief Update framebuffers after depth image is created
+     * @brief Create the framebuffer once the scene color, depth, OIT and motion images exist
+     *
+     * Every attachment is a full-size offscreen target, so one framebuffer serves
+     * all swap chain images; the scene color is blitted to the acquired image.
      */
-    void createFramebuffers(VkDevice device, VkImageView depthImageView);
+    void createFramebuffer(VkDevice device, VkImageView colorImageView, VkImageView depthImageView,
+                           VkImageView accumImageView, VkImageView revealageImageView, VkImageView motionImageView);
 
 private:
     VkSwapchainKHR             swapchain = VK_NULL_HANDLE;
@@ -58,11 +100,14 @@ private:
     VkExtent2D                 swapchainExtent;
     std::vector<VkImageView>   swapchainImageViews;
     VkRenderPass               renderPass = VK_NULL_HANDLE;
-    std::vector<VkFramebuffer> swapchainFramebuffers;
+    VkFramebuffer              framebuffer = VK_NULL_HANDLE;
 
     VkFormat depthFormat;
 
-    void createSwapChain(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow* window);
+    std::vector<Allocation> offscreenMemory;  // Backing for swapchainImages when offscreen
+
+    void createSwapChain(VkDevice device, VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, GLFWwindow* window,
+                         uint32_t framesInFlight);
     void createImageViews(VkDevice device);
     void createRenderPass(VkDevice device);
 
@@ -0,0 +1,61 @@
+#pragma once
+
+/*
+ * Shared-memory telemetry layout, written by DownPour (TelemetryPublisher)
+ * and read by src/tools/SystemMonitor. Plain C so both sides compile it.
+ *
+ * The region is a header followed by a ring of DP_TELEMETRY_RING_SIZE frame
+ * records. The single writer (the render thread) publishes frame n into slot
+ * n % DP_TELEMETRY_RING_SIZE under a per-slot sequence lock and then bumps
+ * writeCount, so it never waits on readers. A reader copies a slot, and keeps
+ * the copy only if the slot's sequence was even and unchanged around it.
+ * Sequence and writeCount are accessed with __atomic builtins on both sides.
+ */
+
+#include <stdint.h>
+
+#define DP_TELEMETRY_SHM_NAME     "/downpour_telemetry"
+#define DP_TELEMETRY_MAGIC        0x31545044u /* "DPT1" */
+#define DP_TELEMETRY_VERSION      1u
+#define DP_TELEMETRY_RING_SIZE    256u
+#define DP_TELEMETRY_MAX_SECTIONS 16u /* GPU timestamp sections */
+#define DP_TELEMETRY_MAX_ZONES    8u  /* CPU frame zones */
+#define DP_TELEMETRY_NAME_LENGTH  24u /* Including the terminator */
+
+/* One rendered frame */
+typedef struct DpTelemetryFrame {
+    uint64_t sequence; /* Odd while the writer is inside the slot */
+    uint64_t frameNumber;
+    uint64_t timestampNs; /* Steady clock at publish */
+    float    frameMs;     /* Since the previous frame was published */
+    float    gpuMs;       /* Sum of gpuSectionMs */
+    float    cpuZoneMs[DP_TELEMETRY_MAX_ZONES];
+    float    gpuSectionMs[DP_TELEMETRY_MAX_SECTIONS]; /* Resolved a few frames late; 0 if a section did not run */
+    uint32_t drawCalls;
+    uint32_t rainDrops; /* GPU drops drawn */
+    uint64_t triangles;
+    uint32_t cpuRaindrops;      /* Live drops in the CPU fallback field */
+    uint32_t deviceAllocations; /* Live VkDeviceMemory objects */
+    uint64_t deviceReservedBytes;
+    uint64_t deviceUsedBytes;
+    float    renderScale;
+    uint32_t padding;
+} DpTelemetryFrame;
+
+typedef struct DpTelemetryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ringSize;
+    uint32_t frameSize; /* sizeof(DpTelemetryFrame), to catch mismatched builds */
+    uint64_t processId;
+    uint32_t zoneCount;
+    uint32_t sectionCount;
+    char     zoneNames[DP_TELEMETRY_MAX_ZONES][DP_TELEMETRY_NAME_LENGTH];
+    char     sectionNames[DP_TELEMETRY_MAX_SECTIONS][DP_TELEMETRY_NAME_LENGTH];
+    uint64_t writeCount; /* Frames published; the newest is in slot (writeCount - 1) % ringSize */
+} DpTelemetryHeader;
+
+typedef struct DpTelemetryRegion {
+    DpTelemetryHeader header;
+    DpTelemetryFrame  frames[DP_TELEMETRY_RING_SIZE];
+} DpTelemetryRegion;
@@ -0,0 +1,151 @@
+#include "TelemetryPublisher.h"
+
+#include "core/Profiler.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DownPour {
+
+namespace {
+
+void copyNames(const std::vector<std::string>& names, uint32_t maxCount, char (*out)[DP_TELEMETRY_NAME_LENGTH],
+               uint32_t& outCount) {
+    outCount = static_cast<uint32_t>(std::min<size_t>(names.size(), maxCount));
+    for (uint32_t i = 0; i < outCount; i++) {
+        std::strncpy(out[i], names[i].c_str(), DP_TELEMETRY_NAME_LENGTH - 1);
+        out[i][DP_TELEMETRY_NAME_LENGTH - 1] = '\0';
+    }
+}
+
+#if !defined(_WIN32)
+// True while the process that created the existing region is still running
+bool regionOwnerAlive() {
+    int fd = shm_open(DP_TELEMETRY_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    bool        alive = false;
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(DpTelemetryHeader)) {
+        void* mapped = mmap(nullptr, sizeof(DpTelemetryHeader), PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            const pid_t owner = static_cast<pid_t>(static_cast<const DpTelemetryHeader*>(mapped)->processId);
+            alive             = owner > 0 && (kill(owner, 0) == 0 || errno == EPERM);
+            munmap(mapped, sizeof(DpTelemetryHeader));
+        }
+    }
+    ::close(fd);
+    return alive;
+}
+#endif
+
+}  // namespace
+
+bool TelemetryPublisher::open(const std::vector<std::string>& zoneNames,
+                              const std::vector<std::string>& sectionNames) {
+#if defined(_WIN32)
+    (void)zoneNames;
+    (void)sectionNames;
+    return false;
+#else
+    close();
+
+    // Created exclusively, so a second instance never clears a live region; one left by a crashed run is replaced
+    int fd = shm_open(DP_TELEMETRY_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        if (regionOwnerAlive()) {
+            DP_LOG(Warning, "Telemetry: another instance is publishing to %s, telemetry disabled",
+                   DP_TELEMETRY_SHM_NAME);
+            return false;
+        }
+        shm_unlink(DP_TELEMETRY_SHM_NAME);
+        fd = shm_open(DP_TELEMETRY_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        DP_LOG(Warning, "Telemetry: shm_open failed, telemetry disabled");
+        return false;
+    }
+    if (ftruncate(fd, sizeof(DpTelemetryRegion)) != 0) {
+        DP_LOG(Warning, "Telemetry: could not size the shared region, telemetry disabled");
+        ::close(fd);
+        shm_unlink(DP_TELEMETRY_SHM_NAME);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, sizeof(DpTelemetryRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the region alive
+    if (mapped == MAP_FAILED) {
+        DP_LOG(Warning, "Telemetry: mmap failed, telemetry disabled");
+        shm_unlink(DP_TELEMETRY_SHM_NAME);
+        return false;
+    }
+
+    region = static_cast<DpTelemetryRegion*>(mapped);
+    std::memset(region, 0, sizeof(DpTelemetryRegion));
+
+    DpTelemetryHeader& header = region->header;
+    header.version            = DP_TELEMETRY_VERSION;
+    header.ringSize           = DP_TELEMETRY_RING_SIZE;
+    header.frameSize          = sizeof(DpTelemetryFrame);
+    header.processId          = static_cast<uint64_t>(getpid());
+    copyNames(zoneNames, DP_TELEMETRY_MAX_ZONES, header.zoneNames, header.zoneCount);
+    copyNames(sectionNames, DP_TELEMETRY_MAX_SECTIONS, header.sectionNames, header.sectionCount);
+
+    // Readers check the magic last, so they never see a half-written header
+    __atomic_store_n(&header.magic, DP_TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+    frameNumber = 0;
+
+    DP_LOG(Info, "Telemetry: publishing to shared memory %s", DP_TELEMETRY_SHM_NAME);
+    return true;
+#endif
+}
+
+void TelemetryPublisher::close() {
+#if !defined(_WIN32)
+    if (region == nullptr)
+        return;
+    __atomic_store_n(&region->header.magic, 0u, __ATOMIC_RELEASE);
+    munmap(region, sizeof(DpTelemetryRegion));
+    shm_unlink(DP_TELEMETRY_SHM_NAME);
+    region = nullptr;
+#endif
+}
+
+void TelemetryPublisher::publish(const DpTelemetryFrame& frame) {
+#if defined(_WIN32)
+    (void)frame;
+#else
+    if (region == nullptr)
+        return;
+
+    DpTelemetryFrame& slot     = region->frames[frameNumber % DP_TELEMETRY_RING_SIZE];
+    uint64_t          sequence = slot.sequence;
+
+    // Odd sequence: readers discard anything they copy until the closing store
+    __atomic_store_n(&slot.sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    DpTelemetryFrame record = frame;
+    record.frameNumber      = frameNumber;
+    record.timestampNs      = Profiler::now();
+    std::memcpy(reinterpret_cast<char*>(&slot) + sizeof(slot.sequence),
+                reinterpret_cast<const char*>(&record) + sizeof(record.sequence),
+                sizeof(DpTelemetryFrame) - sizeof(slot.sequence));
+
+    __atomic_store_n(&slot.sequence, sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&region->header.writeCount, ++frameNumber, __ATOMIC_RELEASE);
+#endif
+}
+
+}  // namespace DownPour
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/TelemetryFormat.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Publishes per-frame records into the shared-memory telemetry ring
+ *
+ * Creates the DP_TELEMETRY_SHM_NAME region (TelemetryFormat.h) that
+ * SystemMonitor attaches to. publish() copies one fixed-size record into the
+ * next ring slot behind a sequence lock: no locks, syscalls or allocations
+ * per frame, and readers never hold the writer up. POSIX only; elsewhere
+ * open() fails and publish() does nothing.
+ *
+ * Single writer: call publish() from one thread (the render thread).
+ */
+class TelemetryPublisher {
+public:
+    TelemetryPublisher() = default;
+    ~TelemetryPublisher() { close(); }
+
+    TelemetryPublisher(const TelemetryPublisher&)            = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    /**
+     * @brief Create the shared region and write its header
+     *
+     * A region left behind by a run that exited without close() is replaced;
+     * one whose creator is still running is left alone and open() fails.
+     * @param zoneNames Names of DpTelemetryFrame::cpuZoneMs entries (at most DP_TELEMETRY_MAX_ZONES)
+     * @param sectionNames Names of DpTelemetryFrame::gpuSectionMs entries (at most DP_TELEMETRY_MAX_SECTIONS)
+     * @return false if shared memory is unavailable or taken; telemetry is then off
+     */
+    bool open(const std::vector<std::string>& zoneNames, const std::vector<std::string>& sectionNames);
+
+    /**
+     * @brief Unmap and unlink the region
+     */
+    void close();
+
+    bool isOpen() const { return region != nullptr; }
+
+    /**
+     * @brief Write @p frame into the next slot; its sequence, frameNumber and timestampNs are filled in here
+     */
+    void publish(const DpTelemetryFrame& frame);
+
+private:
+    DpTelemetryRegion* region      = nullptr;
+    uint64_t           frameNumber = 0;
+};
+
+}  // namespace DownPour
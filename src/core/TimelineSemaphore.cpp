@@ -0,0 +1,83 @@
+#include "TimelineSemaphore.h"
+
+#include <stdexcept>
+
+namespace DownPour {
+
+void TimelineSemaphore::init(VkDevice vkDevice, uint64_t initialValue) {
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue  = initialValue;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(vkDevice, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create timeline semaphore");
+    device = vkDevice;
+}
+
+void TimelineSemaphore::destroy() {
+    if (semaphore != VK_NULL_HANDLE)
+        vkDestroySemaphore(device, semaphore, nullptr);
+    semaphore = VK_NULL_HANDLE;
+    device    = VK_NULL_HANDLE;
+}
+
+uint64_t TimelineSemaphore::getCompletedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(device, semaphore, &value);
+    return value;
+}
+
+bool TimelineSemaphore::wait(uint64_t value, uint64_t timeoutNs) const {
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &semaphore;
+    waitInfo.pValues        = &value;
+    return vkWaitSemaphores(device, &waitInfo, timeoutNs) == VK_SUCCESS;
+}
+
+void SubmitSemaphores::wait(VkSemaphore semaphore, VkPipelineStageFlags stages, uint64_t value) {
+    if (waitCount == MAX_SEMAPHORES)
+        throw std::runtime_error("Too many semaphore waits for one submission");
+    waitSemaphores[waitCount] = semaphore;
+    waitStages[waitCount]     = stages;
+    waitValues[waitCount]     = value;
+    waitCount++;
+    timeline = timeline || value != 0;
+}
+
+void SubmitSemaphores::signal(VkSemaphore semaphore, uint64_t value) {
+    if (signalCount == MAX_SEMAPHORES)
+        throw std::runtime_error("Too many semaphore signals for one submission");
+    signalSemaphores[signalCount] = semaphore;
+    signalValues[signalCount]     = value;
+    signalCount++;
+    timeline = timeline || value != 0;
+}
+
+void SubmitSemaphores::apply(VkSubmitInfo& submit) {
+    submit.waitSemaphoreCount   = waitCount;
+    submit.pWaitSemaphores      = waitSemaphores.data();
+    submit.pWaitDstStageMask    = waitStages.data();
+    submit.signalSemaphoreCount = signalCount;
+    submit.pSignalSemaphores    = signalSemaphores.data();
+    if (!timeline)
+        return;
+
+    // Without this in the chain the driver would take every semaphore for a binary one
+    timelineInfo                           = VkTimelineSemaphoreSubmitInfo{};
+    timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount   = waitCount;
+    timelineInfo.pWaitSemaphoreValues      = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = signalCount;
+    timelineInfo.pSignalSemaphoreValues    = signalValues.data();
+    timelineInfo.pNext                     = submit.pNext;
+    submit.pNext                           = &timelineInfo;
+}
+
+}  // namespace DownPour
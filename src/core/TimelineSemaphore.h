@@ -0,0 +1,79 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <array>
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief A timeline semaphore: one counter that submissions signal and wait on, and the host reads
+ *
+ * Each signal sets the counter to a larger value, so one semaphore tracks every
+ * submission made to a queue; a wait for value N is satisfied by any later
+ * signal too. Needs VulkanContext::hasTimelineSemaphores().
+ */
+class TimelineSemaphore {
+public:
+    TimelineSemaphore()  = default;
+    ~TimelineSemaphore() = default;
+
+    TimelineSemaphore(const TimelineSemaphore&)            = delete;
+    TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+    void init(VkDevice device, uint64_t initialValue = 0);
+    void destroy();
+
+    bool        isValid() const { return semaphore != VK_NULL_HANDLE; }
+    VkSemaphore get() const { return semaphore; }
+
+    /** @brief Largest value signalled so far */
+    uint64_t getCompletedValue() const;
+
+    /**
+     * @brief Block until the counter reaches @p value
+     * @return false if @p timeoutNs passed first
+     */
+    bool wait(uint64_t value, uint64_t timeoutNs = UINT64_MAX) const;
+
+private:
+    VkDevice    device    = VK_NULL_HANDLE;
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+};
+
+/**
+ * @brief Semaphore waits and signals for one vkQueueSubmit, binary and timeline alike
+ *
+ * Timeline entries take a value; binary ones pass 0, which the driver ignores.
+ * Fixed capacity, so a submission built every frame does not allocate.
+ */
+class SubmitSemaphores {
+public:
+    static constexpr uint32_t MAX_SEMAPHORES = 4;
+
+    /**
+     * @param stages Stages of the submission that wait; earlier stages run ahead
+     */
+    void wait(VkSemaphore semaphore, VkPipelineStageFlags stages, uint64_t value = 0);
+    void signal(VkSemaphore semaphore, uint64_t value = 0);
+
+    /**
+     * @brief Point @p submit at the semaphores; keep this object alive until vkQueueSubmit returns
+     */
+    void apply(VkSubmitInfo& submit);
+
+private:
+    std::array<VkSemaphore, MAX_SEMAPHORES>          waitSemaphores{};
+    std::array<VkPipelineStageFlags, MAX_SEMAPHORES> waitStages{};
+    std::array<uint64_t, MAX_SEMAPHORES>             waitValues{};
+    std::array<VkSemaphore, MAX_SEMAPHORES>          signalSemaphores{};
+    std::array<uint64_t, MAX_SEMAPHORES>             signalValues{};
+    uint32_t                                         waitCount   = 0;
+    uint32_t                                         signalCount = 0;
+    bool                                             timeline    = false;  // Any entry with a value
+    VkTimelineSemaphoreSubmitInfo                    timelineInfo{};
+};
+
+}  // namespace DownPour
@@ -0,0 +1,569 @@
+#include "UploadManager.h"
+
+#include "ResourceManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+/**
+ * @brief Fill levels 1..mipLevels-1 by blitting each level to the next, halving the size
+ *
+ * Expects every level in TRANSFER_DST_OPTIMAL with level 0 written; leaves all of
+ * them in SHADER_READ_ONLY_OPTIMAL. Needs a graphics-capable queue.
+ */
+void recordMipBlits(VkCommandBuffer cmd, VkImage image, uint32_t width, uint32_t height, uint32_t mipLevels) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = image;
+    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount     = 1;
+
+    int32_t mipWidth  = static_cast<int32_t>(width);
+    int32_t mipHeight = static_cast<int32_t>(height);
+
+    for (uint32_t level = 1; level < mipLevels; level++) {
+        // Previous level becomes the blit source
+        barrier.subresourceRange.baseMipLevel = level - 1;
+        barrier.oldLayout                     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout                     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask                 = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                             nullptr, 1, &barrier);
+
+        const int32_t nextWidth  = std::max(1, mipWidth / 2);
+        const int32_t nextHeight = std::max(1, mipHeight / 2);
+
+        VkImageBlit blit{};
+        blit.srcOffsets[0]                 = {0, 0, 0};
+        blit.srcOffsets[1]                 = {mipWidth, mipHeight, 1};
+        blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel       = level - 1;
+        blit.srcSubresource.baseArrayLayer = 0;
+        blit.srcSubresource.layerCount     = 1;
+        blit.dstOffsets[0]                 = {0, 0, 0};
+        blit.dstOffsets[1]                 = {nextWidth, nextHeight, 1};
+        blit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.dstSubresource.mipLevel       = level;
+        blit.dstSubresource.baseArrayLayer = 0;
+        blit.dstSubresource.layerCount     = 1;
+        vkCmdBlitImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                       &blit, VK_FILTER_LINEAR);
+
+        // Source level is final
+        barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0,
+                             nullptr, 1, &barrier);
+
+        mipWidth  = nextWidth;
+        mipHeight = nextHeight;
+    }
+
+    // Smallest level was only ever written
+    barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+    barrier.oldLayout                     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout                     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask                 = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask                 = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+}
+
+}  // namespace
+
+// ============================================================================
+// UploadFuture
+// ============================================================================
+
+bool UploadFuture::isReady() const {
+    return owner == nullptr || owner->isComplete(value);
+}
+
+void UploadFuture::wait() const {
+    if (owner != nullptr)
+        owner->wait(value);
+}
+
+// ============================================================================
+// UploadManager
+// ============================================================================
+
+UploadManager& UploadManager::get() {
+    static UploadManager manager;
+    return manager;
+}
+
+void UploadManager::init(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue transferQueue,
+                         uint32_t transferFamily, uint32_t graphicsFamily, bool useTimelineSemaphore) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    this->device         = device;
+    this->physicalDevice = physicalDevice;
+    this->queue          = transferQueue;
+    this->transferFamily = transferFamily;
+    this->graphicsFamily = graphicsFamily;
+    this->useTimeline    = useTimelineSemaphore;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = transferFamily;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upload command pool");
+
+    std::array<VkCommandBuffer, MAX_BATCHES> commandBuffers;
+    VkCommandBufferAllocateInfo              allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool        = commandPool;
+    allocInfo.commandBufferCount = MAX_BATCHES;
+
+    if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate upload command buffers");
+
+    for (uint32_t i = 0; i < MAX_BATCHES; i++) {
+        batches[i]     = Batch{};
+        batches[i].cmd = commandBuffers[i];
+    }
+
+    if (useTimeline) {
+        timeline.init(device);
+    } else {
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        for (Batch& batch : batches) {
+            if (vkCreateFence(device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+                throw std::runtime_error("Failed to create upload fence");
+        }
+    }
+
+    ResourceManager::createBuffer(device, physicalDevice, STAGING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  stagingBuffer, stagingMemory, MemoryTag::Staging);
+
+    stagingHead    = 0;
+    currentBatch   = 0;
+    nextValue      = 1;
+    completedValue = 0;
+}
+
+void UploadManager::shutdown() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (device == VK_NULL_HANDLE)
+        return;
+
+    waitIdle();
+
+    for (Batch& batch : batches) {
+        retireBatch(batch);
+        if (batch.fence != VK_NULL_HANDLE)
+            vkDestroyFence(device, batch.fence, nullptr);
+        batch = Batch{};
+    }
+    readyBufferAcquires.clear();
+    readyImageAcquires.clear();
+    readyMipGenerations.clear();
+
+    ResourceManager::destroyBuffer(device, stagingBuffer, stagingMemory);
+
+    timeline.destroy();
+    // Destroying the pool frees the batch command buffers
+    vkDestroyCommandPool(device, commandPool, nullptr);
+    commandPool = VK_NULL_HANDLE;
+    device      = VK_NULL_HANDLE;
+}
+
+UploadFuture UploadManager::uploadBuffer(VkBuffer dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset) {
+    if (size == 0)
+        return UploadFuture();
+
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    VkBuffer     src;
+    VkDeviceSize srcOffset;
+    memcpy(reserveStaging(size, src, srcOffset), data, static_cast<size_t>(size));
+
+    Batch& batch = beginBatch();
+
+    VkBufferCopy region{};
+    region.srcOffset = srcOffset;
+    region.dstOffset = dstOffset;
+    region.size      = size;
+    vkCmdCopyBuffer(batch.cmd, src, dst, 1, &region);
+
+    if (needsOwnershipTransfer()) {
+        // Release to the graphics family; the matching acquire runs on the graphics queue
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask       = 0;
+        barrier.srcQueueFamilyIndex = transferFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        barrier.buffer              = dst;
+        barrier.offset              = dstOffset;
+        barrier.size                = size;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                             nullptr, 1, &barrier, 0, nullptr);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        batch.bufferAcquires.push_back(barrier);
+    }
+
+    return UploadFuture(this, batch.value);
+}
+
+UploadFuture UploadManager::uploadImage(VkImage dst, const void* data, VkDeviceSize size, uint32_t width,
+                                        uint32_t height, uint32_t mipLevels) {
+    const ImageLevel base{0, width, height};
+    return recordImageUpload(dst, data, size, &base, 1, std::max(1u, mipLevels));
+}
+
+UploadFuture UploadManager::uploadImageLevels(VkImage dst, const void* data, VkDeviceSize size,
+                                              const std::vector<ImageLevel>& levels) {
+    if (levels.empty())
+        return UploadFuture();
+    const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    return recordImageUpload(dst, data, size, levels.data(), levelCount, levelCount);
+}
+
+UploadFuture UploadManager::copyBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Batch& batch = beginBatch();
+
+    VkBufferCopy region{};
+    region.size = size;
+    vkCmdCopyBuffer(batch.cmd, src, dst, 1, &region);
+
+    if (needsOwnershipTransfer()) {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask       = 0;
+        barrier.srcQueueFamilyIndex = transferFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        barrier.buffer              = dst;
+        barrier.offset              = 0;
+        barrier.size                = size;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                             nullptr, 1, &barrier, 0, nullptr);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        batch.bufferAcquires.push_back(barrier);
+    }
+
+    return UploadFuture(this, batch.value);
+}
+
+UploadFuture UploadManager::flush() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    return submitBatch();
+}
+
+void UploadManager::waitIdle() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    submitBatch();
+    waitForValue(nextValue - 1);
+}
+
+void UploadManager::recordAcquireBarriers(VkCommandBuffer cmd) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (!needsOwnershipTransfer())
+        return;
+
+    updateCompleted();
+    if (readyBufferAcquires.empty() && readyImageAcquires.empty())
+        return;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+                         static_cast<uint32_t>(readyBufferAcquires.size()), readyBufferAcquires.data(),
+                         static_cast<uint32_t>(readyImageAcquires.size()), readyImageAcquires.data());
+    readyBufferAcquires.clear();
+    readyImageAcquires.clear();
+
+    // Acquired in TRANSFER_DST layout; the transfer queue could not blit
+    for (const MipGeneration& generation : readyMipGenerations)
+        recordMipBlits(cmd, generation.image, generation.width, generation.height, generation.mipLevels);
+    readyMipGenerations.clear();
+}
+
+bool UploadManager::isComplete(uint64_t value) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (value > completedValue)
+        updateCompleted();
+    return value <= completedValue;
+}
+
+void UploadManager::wait(uint64_t value) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    waitForValue(value);
+}
+
+// ============================================================================
+// Private Helper Methods
+// ============================================================================
+
+UploadManager::Batch& UploadManager::beginBatch() {
+    Batch& batch = batches[currentBatch];
+    if (batch.recording)
+        return batch;
+
+    // Reusing a slot: its previous submission must have finished
+    if (batch.inFlight)
+        waitForValue(batch.value);
+
+    vkResetCommandBuffer(batch.cmd, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(batch.cmd, &beginInfo);
+
+    batch.recording = true;
+    batch.value     = nextValue;
+    return batch;
+}
+
+UploadFuture UploadManager::submitBatch() {
+    Batch& batch = batches[currentBatch];
+    if (!batch.recording)
+        return UploadFuture(this, nextValue - 1);  // Nothing new; covers everything already submitted
+
+    if (!needsOwnershipTransfer()) {
+        // Same queue as rendering: one barrier makes every copy in the batch visible to later submissions
+        VkMemoryBarrier barrier{};
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    vkEndCommandBuffer(batch.cmd);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers    = &batch.cmd;
+
+    SubmitSemaphores semaphores;
+    VkFence          fence = VK_NULL_HANDLE;
+    if (useTimeline) {
+        semaphores.signal(timeline.get(), batch.value);
+        semaphores.apply(submitInfo);
+    } else {
+        fence = batch.fence;
+        vkResetFences(device, 1, &fence);
+    }
+
+    if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS)
+        throw std::runtime_error("Failed to submit upload batch");
+
+    batch.recording = false;
+    batch.inFlight  = true;
+    nextValue++;
+    currentBatch = (currentBatch + 1) % MAX_BATCHES;
+
+    return UploadFuture(this, batch.value);
+}
+
+UploadFuture UploadManager::recordImageUpload(VkImage dst, const void* data, VkDeviceSize size,
+                                              const ImageLevel* levels, uint32_t levelCount, uint32_t mipLevels) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    VkBuffer     src;
+    VkDeviceSize srcOffset;
+    memcpy(reserveStaging(size, src, srcOffset), data, static_cast<size_t>(size));
+
+    Batch& batch = beginBatch();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = dst;
+    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel   = 0;
+    barrier.subresourceRange.levelCount     = mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount     = 1;
+    barrier.srcAccessMask                   = 0;
+    barrier.dstAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                         0, nullptr, 1, &barrier);
+
+    std::vector<VkBufferImageCopy> regions(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        VkBufferImageCopy& region              = regions[i];
+        region.bufferOffset                    = srcOffset + levels[i].offset;
+        region.bufferRowLength                 = 0;
+        region.bufferImageHeight               = 0;
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = {0, 0, 0};
+        region.imageExtent                     = {levels[i].width, levels[i].height, 1};
+    }
+    vkCmdCopyBufferToImage(batch.cmd, src, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, levelCount, regions.data());
+
+    // Levels past the copied ones are blitted down from level 0
+    const bool generateMips = mipLevels > levelCount;
+    if (generateMips && !needsOwnershipTransfer()) {
+        recordMipBlits(batch.cmd, dst, levels[0].width, levels[0].height, mipLevels);
+        return UploadFuture(this, batch.value);
+    }
+
+    barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    if (needsOwnershipTransfer()) {
+        // The layout transition is part of the release/acquire pair and must match on both queues.
+        // Images that still need blits stay in TRANSFER_DST until the graphics queue owns them.
+        if (generateMips)
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.dstAccessMask       = 0;
+        barrier.srcQueueFamilyIndex = transferFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = generateMips ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+                                             : VK_ACCESS_SHADER_READ_BIT;
+        batch.imageAcquires.push_back(barrier);
+        if (generateMips)
+            batch.mipGenerations.push_back(MipGeneration{dst, levels[0].width, levels[0].height, mipLevels});
+    } else {
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(batch.cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    return UploadFuture(this, batch.value);
+}
+
+void* UploadManager::reserveStaging(VkDeviceSize size, VkBuffer& outBuffer, VkDeviceSize& outOffset) {
+    // Uploads too large for the ring get a temporary buffer released with their batch
+    if (size > STAGING_SIZE / 2) {
+        OverflowBuffer overflow;
+        ResourceManager::createBuffer(device, physicalDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      overflow.buffer, overflow.memory, MemoryTag::Staging);
+        beginBatch().overflow.push_back(overflow);
+
+        outBuffer = overflow.buffer;
+        outOffset = 0;
+        return overflow.memory.mapped;
+    }
+
+    VkDeviceSize offset;
+    while (true) {
+        offset = (stagingHead + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+        if (offset + size > STAGING_SIZE)
+            offset = 0;  // Wrap
+        if (!rangeInUse(offset, size))
+            break;
+
+        // Ring is full: make sure the recording batch is submitted, then wait for the oldest batch
+        submitBatch();
+        uint64_t oldest = std::numeric_limits<uint64_t>::max();
+        for (const Batch& batch : batches) {
+            if (batch.inFlight)
+                oldest = std::min(oldest, batch.value);
+        }
+        waitForValue(oldest);
+    }
+
+    stagingHead = offset + size;
+    beginBatch().ranges.push_back(StagingRange{offset, size});
+
+    outBuffer = stagingBuffer;
+    outOffset = offset;
+    return static_cast<char*>(stagingMemory.mapped) + offset;
+}
+
+bool UploadManager::rangeInUse(VkDeviceSize offset, VkDeviceSize size) const {
+    for (const Batch& batch : batches) {
+        for (const StagingRange& range : batch.ranges) {
+            if (offset < range.offset + range.size && range.offset < offset + size)
+                return true;
+        }
+    }
+    return false;
+}
+
+void UploadManager::updateCompleted() {
+    if (useTimeline) {
+        completedValue = timeline.getCompletedValue();
+    } else {
+        // Completed = everything below the oldest unfinished batch
+        uint64_t oldestPending = nextValue;
+        for (const Batch& batch : batches) {
+            if (batch.inFlight && vkGetFenceStatus(device, batch.fence) != VK_SUCCESS)
+                oldestPending = std::min(oldestPending, batch.value);
+        }
+        completedValue = std::max(completedValue, oldestPending - 1);
+    }
+
+    for (Batch& batch : batches) {
+        if (batch.inFlight && batch.value <= completedValue)
+            retireBatch(batch);
+    }
+}
+
+void UploadManager::retireBatch(Batch& batch) {
+    batch.inFlight = false;
+    batch.ranges.clear();
+
+    for (OverflowBuffer& overflow : batch.overflow)
+        ResourceManager::destroyBuffer(device, overflow.buffer, overflow.memory);
+    batch.overflow.clear();
+
+    // Released resources may now be acquired by the graphics queue
+    readyBufferAcquires.insert(readyBufferAcquires.end(), batch.bufferAcquires.begin(), batch.bufferAcquires.end());
+    readyImageAcquires.insert(readyImageAcquires.end(), batch.imageAcquires.begin(), batch.imageAcquires.end());
+    readyMipGenerations.insert(readyMipGenerations.end(), batch.mipGenerations.begin(), batch.mipGenerations.end());
+    batch.bufferAcquires.clear();
+    batch.imageAcquires.clear();
+    batch.mipGenerations.clear();
+}
+
+void UploadManager::waitForValue(uint64_t value) {
+    if (value == 0 || value <= completedValue)
+        return;
+
+    // Waiting on the batch still being recorded means submitting it first
+    if (batches[currentBatch].recording && value >= batches[currentBatch].value)
+        submitBatch();
+
+    if (useTimeline) {
+        timeline.wait(value);
+    } else {
+        for (const Batch& batch : batches) {
+            if (batch.inFlight && batch.value <= value)
+                vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        }
+    }
+
+    updateCompleted();
+}
+
+}  // namespace DownPour
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+#include "TimelineSemaphore.h"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace DownPour {
+
+class UploadManager;
+
+/**
+ * @brief One mip level of a prebuilt chain passed to UploadManager::uploadImageLevels()
+ */
+struct ImageLevel {
+    VkDeviceSize offset;  // Relative to the start of the upload data
+    uint32_t     width;
+    uint32_t     height;
+};
+
+/**
+ * @brief Handle to a pending upload batch
+ *
+ * Cheap to copy. A default-constructed future is always ready.
+ */
+class UploadFuture {
+public:
+    UploadFuture() = default;
+
+    /** @brief True once the GPU has finished the copies in this batch */
+    bool isReady() const;
+
+    /** @brief Block until the batch completes (submits it first if still recording) */
+    void wait() const;
+
+    uint64_t getValue() const { return value; }
+
+private:
+    friend class UploadManager;
+    UploadFuture(UploadManager* owner, uint64_t value) : owner(owner), value(value) {}
+
+    UploadManager* owner = nullptr;
+    uint64_t       value = 0;
+};
+
+/**
+ * @brief Batched, asynchronous staging uploads
+ *
+ * Copies are written into a persistently mapped staging ring and recorded into
+ * one command buffer per batch, so loading a model costs one submit instead of
+ * a submit + vkQueueWaitIdle per resource. Batches go to the dedicated transfer
+ * queue when the device has one and are tracked by a timeline semaphore
+ * (fences on pre-1.2 devices). The batch value doubles as the future value.
+ *
+ * When the transfer queue is a different family, resources are released by the
+ * transfer queue and acquired by the graphics queue. The render loop must call
+ * recordAcquireBarriers() on its primary command buffer each frame. Callers must
+ * wait() a resource's future before drawing with it.
+ *
+ * Process-wide like MemoryAllocator; VulkanContext owns its lifetime.
+ * All methods are thread-safe, but when uploads share the graphics queue the
+ * caller must not submit from another thread while the render loop submits.
+ */
+class UploadManager {
+public:
+    static UploadManager& get();
+
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkQueue transferQueue, uint32_t transferFamily,
+              uint32_t graphicsFamily, bool useTimelineSemaphore);
+    void shutdown();
+
+    /**
+     * @brief Queue a CPU -> buffer copy; data is copied into staging immediately
+     */
+    UploadFuture uploadBuffer(VkBuffer dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+    /**
+     * @brief Queue a CPU -> image copy of mip 0, then fill the remaining levels by blitting down
+     *
+     * The image must be in UNDEFINED layout; every level ends in SHADER_READ_ONLY_OPTIMAL.
+     * With mipLevels > 1 it also needs TRANSFER_SRC usage and a format that supports
+     * linear blits. Blits need a graphics queue, so with a dedicated transfer queue they
+     * are recorded by recordAcquireBarriers() instead.
+     */
+    UploadFuture uploadImage(VkImage dst, const void* data, VkDeviceSize size, uint32_t width, uint32_t height,
+                             uint32_t mipLevels = 1);
+
+    /**
+     * @brief Queue a CPU -> image copy of a prebuilt mip chain (e.g. block-compressed KTX2 levels)
+     *
+     * Levels are largest first; offsets must meet the format's block alignment.
+     * The image must be in UNDEFINED layout; it ends in SHADER_READ_ONLY_OPTIMAL.
+     */
+    UploadFuture uploadImageLevels(VkImage dst, const void* data, VkDeviceSize size,
+                                   const std::vector<ImageLevel>& levels);
+
+    /**
+     * @brief Queue a GPU buffer -> buffer copy within the same batch
+     */
+    UploadFuture copyBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size);
+
+    /**
+     * @brief Submit the batch currently being recorded
+     * @return Future for everything queued so far
+     */
+    UploadFuture flush();
+
+    /**
+     * @brief Flush and wait for every submitted batch
+     */
+    void waitIdle();
+
+    /**
+     * @brief Record queue-family acquire barriers for completed uploads (graphics queue)
+     *
+     * Also generates the mip chains that could not be blitted on the transfer queue.
+     */
+    void recordAcquireBarriers(VkCommandBuffer cmd);
+
+    bool isComplete(uint64_t value);
+    void wait(uint64_t value);
+
+    static constexpr VkDeviceSize STAGING_SIZE = 32ull * 1024 * 1024;
+
+private:
+    static constexpr uint32_t MAX_BATCHES = 4;
+
+    // Covers texel block size and optimalBufferCopyOffsetAlignment
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    struct StagingRange {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    struct OverflowBuffer {
+        VkBuffer   buffer = VK_NULL_HANDLE;
+        Allocation memory;
+    };
+
+    struct MipGeneration {
+        VkImage  image;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+    };
+
+    struct Batch {
+        VkCommandBuffer                    cmd       = VK_NULL_HANDLE;
+        VkFence                            fence     = VK_NULL_HANDLE;  // Only without timeline semaphores
+        uint64_t                           value     = 0;
+        bool                               recording = false;
+        bool                               inFlight  = false;
+        std::vector<StagingRange>          ranges;
+        std::vector<OverflowBuffer>        overflow;  // Uploads bigger than half the ring
+        std::vector<VkBufferMemoryBarrier> bufferAcquires;
+        std::vector<VkImageMemoryBarrier>  imageAcquires;
+        std::vector<MipGeneration>         mipGenerations;  // Run on the graphics queue after the acquire
+    };
+
+    VkDevice          device         = VK_NULL_HANDLE;
+    VkPhysicalDevice  physicalDevice = VK_NULL_HANDLE;
+    VkQueue           queue          = VK_NULL_HANDLE;
+    uint32_t          transferFamily = 0;
+    uint32_t          graphicsFamily = 0;
+    bool              useTimeline    = false;
+    VkCommandPool     commandPool    = VK_NULL_HANDLE;
+    TimelineSemaphore timeline;
+
+    VkBuffer     stagingBuffer = VK_NULL_HANDLE;
+    Allocation   stagingMemory;
+    VkDeviceSize stagingHead = 0;
+
+    std::array<Batch, MAX_BATCHES> batches;
+    uint32_t                       currentBatch   = 0;
+    uint64_t                       nextValue      = 1;  // Value the recording batch will signal
+    uint64_t                       completedValue = 0;
+
+    std::vector<VkBufferMemoryBarrier> readyBufferAcquires;
+    std::vector<VkImageMemoryBarrier>  readyImageAcquires;
+    std::vector<MipGeneration>         readyMipGenerations;
+
+    std::recursive_mutex mutex;
+
+    bool         needsOwnershipTransfer() const { return transferFamily != graphicsFamily; }
+    Batch&       beginBatch();
+    UploadFuture submitBatch();
+    UploadFuture recordImageUpload(VkImage dst, const void* data, VkDeviceSize size, const ImageLevel* levels,
+                                   uint32_t levelCount, uint32_t mipLevels);
+    void*        reserveStaging(VkDeviceSize size, VkBuffer& outBuffer, VkDeviceSize& outOffset);
+    bool         rangeInUse(VkDeviceSize offset, VkDeviceSize size) const;
+    void         updateCompleted();
+    void         retireBatch(Batch& batch);
+    void         waitForValue(uint64_t value);
+};
+
+}  // namespace DownPour
@@ -1,5 +1,8 @@
 #include "VulkanContext.h"
 
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+
 #include <stdexcept>
 #include <set>
 #include <cstring>
@@ -9,13 +12,20 @@ namespace DownPour {
 void VulkanContext::initialize(GLFWwindow* window) {
     this->window = window;
     createInstance();
-    createSurface();
+    if (window) {
+        createSurface();
+    }
     pickPhysicalDevice();
     createLogicalDevice();
+    MemoryAllocator::get().init(device, physicalDevice, memoryBudgetSupported);
+    UploadManager::get().init(device, physicalDevice, transferQueue, transferQueueFamily, graphicsQueueFamily,
+                              timelineSemaphoresSupported);
 }
 
 void VulkanContext::cleanup() {
     if (device != VK_NULL_HANDLE) {
+        UploadManager::get().shutdown();
+        MemoryAllocator::get().shutdown();
         vkDestroyDevice(device, nullptr);
         device = VK_NULL_HANDLE;
     }
@@ -39,14 +49,18 @@ void VulkanContext::createInstance() {
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName        = "No Engine";
     appInfo.engineVersion      = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion         = VK_API_VERSION_1_0;
-
-    // Get required GLFW extensions
-    uint32_t     glfwExtensionCount = 0;
-    const char** glfwExtensions     = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    appInfo.apiVersion         = selectApiVersion();
+    apiVersion                 = appInfo.apiVersion;
+
+    // Get required GLFW extensions (none when headless: GLFW is never initialised)
+    std::vector<const char*> extensions;
+    if (window) {
+        uint32_t     glfwExtensionCount = 0;
+        const char** glfwExtensions     = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
 
     // Add portability extension for macOS compatibility
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
     extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
 
     // Create Vulkan instance
@@ -63,6 +77,34 @@ void VulkanContext::createInstance() {
     }
 }
 
+uint32_t VulkanContext::selectApiVersion() const {
+    // vkEnumerateInstanceVersion only exists on 1.1+ loaders
+    uint32_t loaderVersion    = VK_API_VERSION_1_0;
+    auto     enumerateVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+        vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+    if (enumerateVersion) {
+        enumerateVersion(&loaderVersion);
+    }
+
+    // 1.2 is the newest version whose features we use
+    return loaderVersion >= VK_API_VERSION_1_2 ? VK_API_VERSION_1_2 : loaderVersion;
+}
+
+bool VulkanContext::hasDeviceExtension(const char* name) const {
+    for (const auto& extension : availableDeviceExtensions) {
+        if (strcmp(extension.extensionName, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<uint32_t> VulkanContext::getComputeSharingFamilies() const {
+    if (!hasAsyncCompute())
+        return {};
+    return {graphicsQueueFamily, asyncComputeQueueFamily};
+}
+
 void VulkanContext::createSurface() {
     if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create window surface!");
@@ -98,6 +140,12 @@ void VulkanContext::createLogicalDevice() {
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily.value(), indices.presentFamily.value()};
+    if (indices.transferFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
+    if (indices.computeFamily.has_value()) {
+        uniqueQueueFamilies.insert(indices.computeFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -109,43 +157,192 @@ void VulkanContext::createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    // Enable the optional features the indirect draw path and the texture samplers rely on when the device has them
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.multiDrawIndirect          = supportedFeatures.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance  = supportedFeatures.drawIndirectFirstInstance;
+    deviceFeatures.samplerAnisotropy          = supportedFeatures.samplerAnisotropy;
+    deviceFeatures.textureCompressionBC       = supportedFeatures.textureCompressionBC;
+    deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
 
     // Enable required device extensions
-    std::vector<const char*> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<const char*> deviceExtensions;
+    if (surface != VK_NULL_HANDLE) {
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
 
-    // Check if portability subset extension is available (required for MoltenVK on macOS)
     uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
-    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
-    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+    availableDeviceExtensions.resize(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableDeviceExtensions.data());
 
-    bool portabilitySubsetAvailable = false;
-    for (const auto& extension : availableExtensions) {
-        if (strcmp(extension.extensionName, "VK_KHR_portability_subset") == 0) {
-            portabilitySubsetAvailable = true;
-            break;
-        }
+    // Check if portability subset extension is available (required for MoltenVK on macOS)
+    if (hasDeviceExtension("VK_KHR_portability_subset")) {
+        deviceExtensions.push_back("VK_KHR_portability_subset");
     }
 
-    if (portabilitySubsetAvailable) {
-        deviceExtensions.push_back("VK_KHR_portability_subset");
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    bool hasFeatures2 = apiVersion >= VK_API_VERSION_1_1 && deviceProperties.apiVersion >= VK_API_VERSION_1_1;
+
+    // Descriptor indexing (bindless materials): only enable when every feature the bindless path needs is present
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+    if (hasFeatures2 && hasDeviceExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+        VkPhysicalDeviceDescriptorIndexingFeatures supportedIndexing{};
+        supportedIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+        VkPhysicalDeviceFeatures2 query{};
+        query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        query.pNext = &supportedIndexing;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &query);
+
+        descriptorIndexingSupported = supportedIndexing.runtimeDescriptorArray &&
+                                      supportedIndexing.descriptorBindingPartiallyBound &&
+                                      supportedIndexing.descriptorBindingVariableDescriptorCount &&
+                                      supportedIndexing.descriptorBindingSampledImageUpdateAfterBind &&
+                                      supportedIndexing.descriptorBindingStorageBufferUpdateAfterBind &&
+                                      supportedIndexing.descriptorBindingUpdateUnusedWhilePending &&
+                                      supportedIndexing.shaderSampledImageArrayNonUniformIndexing;
+    }
+
+    if (descriptorIndexingSupported) {
+        indexingFeatures.runtimeDescriptorArray                        = VK_TRUE;
+        indexingFeatures.descriptorBindingPartiallyBound               = VK_TRUE;
+        indexingFeatures.descriptorBindingVariableDescriptorCount      = VK_TRUE;
+        indexingFeatures.descriptorBindingSampledImageUpdateAfterBind  = VK_TRUE;
+        indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        indexingFeatures.descriptorBindingUpdateUnusedWhilePending     = VK_TRUE;
+        indexingFeatures.shaderSampledImageArrayNonUniformIndexing     = VK_TRUE;
+        deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+    }
+
+    // Timeline semaphores let the upload manager track many batches with one semaphore.
+    // Only used on 1.2 devices, where the entry points are core.
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    if (apiVersion >= VK_API_VERSION_1_2 && deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+        VkPhysicalDeviceTimelineSemaphoreFeatures supportedTimeline{};
+        supportedTimeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+        VkPhysicalDeviceFeatures2 query{};
+        query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        query.pNext = &supportedTimeline;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &query);
+
+        timelineSemaphoresSupported        = supportedTimeline.timelineSemaphore == VK_TRUE;
+        timelineFeatures.timelineSemaphore = timelineSemaphoresSupported ? VK_TRUE : VK_FALSE;
+    }
+
+    // Multiview draws the mirror views in one pass, each view to its own layer
+    VkPhysicalDeviceMultiviewFeatures multiviewFeatures{};
+    multiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+    if (hasFeatures2) {
+        VkPhysicalDeviceMultiviewFeatures supportedMultiview{};
+        supportedMultiview.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+
+        VkPhysicalDeviceFeatures2 query{};
+        query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        query.pNext = &supportedMultiview;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &query);
+
+        multiviewSupported          = supportedMultiview.multiview == VK_TRUE;
+        multiviewFeatures.multiview = multiviewSupported ? VK_TRUE : VK_FALSE;
+    }
+
+    // Present id + present wait let the frame pacer block until a given frame is on screen
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+    if (hasFeatures2 && surface != VK_NULL_HANDLE && hasDeviceExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        hasDeviceExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        VkPhysicalDevicePresentIdFeaturesKHR supportedPresentId{};
+        supportedPresentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        VkPhysicalDevicePresentWaitFeaturesKHR supportedPresentWait{};
+        supportedPresentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        supportedPresentId.pNext   = &supportedPresentWait;
+
+        VkPhysicalDeviceFeatures2 query{};
+        query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        query.pNext = &supportedPresentId;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &query);
+
+        presentWaitSupported = supportedPresentId.presentId && supportedPresentWait.presentWait;
+    }
+
+    if (presentWaitSupported) {
+        presentIdFeatures.presentId     = VK_TRUE;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        deviceExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        deviceExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+    }
+
+    // Per-heap budget and usage for this process, so streaming can back off before allocations fail
+    if (hasFeatures2 && hasDeviceExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        memoryBudgetSupported = true;
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Feature structs are chained through VkPhysicalDeviceFeatures2 when available
+    VkPhysicalDeviceFeatures2 enabledFeatures2{};
+    enabledFeatures2.sType    = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    enabledFeatures2.features = deviceFeatures;
+
+    void** chainTail = &enabledFeatures2.pNext;
+    if (descriptorIndexingSupported) {
+        *chainTail = &indexingFeatures;
+        chainTail  = &indexingFeatures.pNext;
+    }
+    if (timelineSemaphoresSupported) {
+        *chainTail = &timelineFeatures;
+        chainTail  = &timelineFeatures.pNext;
+    }
+    if (multiviewSupported) {
+        *chainTail = &multiviewFeatures;
+        chainTail  = &multiviewFeatures.pNext;
+    }
+    if (presentWaitSupported) {
+        *chainTail = &presentIdFeatures;
+        chainTail  = &presentIdFeatures.pNext;
+        *chainTail = &presentWaitFeatures;
+        chainTail  = &presentWaitFeatures.pNext;
     }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos       = queueCreateInfos.data();
-    createInfo.pEnabledFeatures        = &deviceFeatures;
+    createInfo.pNext                   = hasFeatures2 ? &enabledFeatures2 : nullptr;
+    createInfo.pEnabledFeatures        = hasFeatures2 ? nullptr : &deviceFeatures;
     createInfo.enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create logical device!");
     }
+    enabledFeatures = deviceFeatures;
 
     vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
     vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+
+    // Uploads fall back to the graphics queue when there is no dedicated transfer family
+    graphicsQueueFamily = indices.graphicsFamily.value();
+    transferQueueFamily = indices.transferFamily.value_or(graphicsQueueFamily);
+    vkGetDeviceQueue(device, transferQueueFamily, 0, &transferQueue);
+
+    // Without a compute-only family, the render graph keeps compute passes on the graphics queue
+    if (indices.computeFamily.has_value()) {
+        asyncComputeQueueFamily = indices.computeFamily.value();
+        vkGetDeviceQueue(device, asyncComputeQueueFamily, 0, &asyncComputeQueue);
+    }
 }
 
 Vulkan::QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) const {
@@ -163,8 +360,11 @@ Vulkan::QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice dev
             indices.graphicsFamily = i;
         }
 
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        // Headless: nothing is presented, so any graphics family will do
+        VkBool32 presentSupport = surface == VK_NULL_HANDLE && (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+        if (surface != VK_NULL_HANDLE) {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        }
         if (presentSupport) {
             indices.presentFamily = i;
         }
@@ -176,6 +376,24 @@ Vulkan::QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice dev
         i++;
     }
 
+    // Prefer a DMA-only family for uploads so copies overlap rendering
+    for (uint32_t family = 0; family < queueFamilyCount; family++) {
+        VkQueueFlags flags = queueFamilies[family].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            indices.transferFamily = family;
+            break;
+        }
+    }
+
+    // A compute family without graphics runs on its own hardware queue on most desktop GPUs
+    for (uint32_t family = 0; family < queueFamilyCount; family++) {
+        VkQueueFlags flags = queueFamilies[family].queueFlags;
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.computeFamily = family;
+            break;
+        }
+    }
+
     return indices;
 }
 
@@ -13,7 +13,9 @@ namespace DownPour {
  *
  * Encapsulates all Vulkan core setup, separating initialization logic
  * from the main Application class. Handles instance, physical device
- * selection, logical device creation, and queue management.
+ * selection, logical device creation, and queue management: besides the
+ * graphics and present queues, a dedicated transfer queue for uploads and a
+ * compute-only queue for async compute are created when the device has them.
  */
 class VulkanContext {
 public:
@@ -23,7 +25,8 @@ public:
     /**
      * @brief Initialize Vulkan instance, device, and surface
      *
-     * @param window GLFW window for surface creation
+     * @param window GLFW window for surface creation, or nullptr for headless (offscreen) rendering
+     *               without a surface, present queue or swapchain extension
      */
     void initialize(GLFWwindow* window);
 
@@ -37,9 +40,76 @@ public:
     VkPhysicalDevice getPhysicalDevice() const { return physicalDevice; }
     VkDevice getDevice() const { return device; }
     VkSurfaceKHR getSurface() const { return surface; }
+    bool isHeadless() const { return window == nullptr; }
     VkQueue getGraphicsQueue() const { return graphicsQueue; }
     VkQueue getPresentQueue() const { return presentQueue; }
 
+    /**
+     * @brief Queue used for asset uploads
+     *
+     * A dedicated transfer queue when the device has one, otherwise the graphics queue.
+     */
+    VkQueue  getTransferQueue() const { return transferQueue; }
+    uint32_t getTransferQueueFamily() const { return transferQueueFamily; }
+    uint32_t getGraphicsQueueFamily() const { return graphicsQueueFamily; }
+
+    /**
+     * @brief Whether the device has a compute family without graphics, for work that overlaps rendering
+     */
+    bool     hasAsyncCompute() const { return asyncComputeQueue != VK_NULL_HANDLE; }
+    VkQueue  getAsyncComputeQueue() const { return asyncComputeQueue; }
+    uint32_t getAsyncComputeQueueFamily() const { return asyncComputeQueueFamily; }
+
+    /**
+     * @brief Families to create VK_SHARING_MODE_CONCURRENT resources with when graphics and async compute share them
+     *
+     * Empty without an async compute queue, where exclusive resources never change queue.
+     */
+    std::vector<uint32_t> getComputeSharingFamilies() const;
+
+    /**
+     * @brief Whether timeline semaphores (Vulkan 1.2 core) were enabled
+     */
+    bool hasTimelineSemaphores() const { return timelineSemaphoresSupported; }
+
+    /**
+     * @brief Whether VK_KHR_present_id and VK_KHR_present_wait were enabled
+     */
+    bool hasPresentWait() const { return presentWaitSupported; }
+
+    /**
+     * @brief Whether multiview (VK_KHR_multiview, Vulkan 1.1 core) was enabled
+     */
+    bool hasMultiview() const { return multiviewSupported; }
+
+    /**
+     * @brief Whether VK_EXT_memory_budget was enabled (MemoryAllocator::updateBudget)
+     */
+    bool hasMemoryBudget() const { return memoryBudgetSupported; }
+
+    /**
+     * @brief Features actually enabled on the logical device
+     *
+     * Optional features (multiDrawIndirect, drawIndirectFirstInstance) are only
+     * enabled when the physical device supports them; callers must check here.
+     */
+    const VkPhysicalDeviceFeatures& getEnabledFeatures() const { return enabledFeatures; }
+
+    /**
+     * @brief Whether VK_EXT_descriptor_indexing was enabled with the features bindless materials need
+     */
+    bool hasDescriptorIndexing() const { return descriptorIndexingSupported; }
+
+    /**
+     * @brief Vulkan API version the instance was created with (1.0 - 1.2)
+     */
+    uint32_t getApiVersion() const { return apiVersion; }
+
+    /**
+     * @brief Check whether the selected physical device exposes an extension
+     */
+    bool hasDeviceExtension(const char* name) const;
+
     Vulkan::QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) const;
 
 private:
@@ -49,6 +119,20 @@ private:
     VkSurfaceKHR surface = VK_NULL_HANDLE;
     VkQueue graphicsQueue = VK_NULL_HANDLE;
     VkQueue presentQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    VkQueue asyncComputeQueue = VK_NULL_HANDLE;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = 0;
+    uint32_t asyncComputeQueueFamily = 0;
+
+    VkPhysicalDeviceFeatures           enabledFeatures{};
+    std::vector<VkExtensionProperties> availableDeviceExtensions;
+    uint32_t                           apiVersion                  = VK_API_VERSION_1_0;
+    bool                               descriptorIndexingSupported = false;
+    bool                               timelineSemaphoresSupported = false;
+    bool                               presentWaitSupported        = false;
+    bool                               multiviewSupported          = false;
+    bool                               memoryBudgetSupported       = false;
 
     GLFWwindow* window = nullptr;
 
@@ -56,6 +140,8 @@ private:
     void createSurface();
     void pickPhysicalDevice();
     void createLogicalDevice();
+
+    uint32_t selectApiVersion() const;
 };
 
 } // namespace DownPour
@@ -1,6 +1,78 @@
 // SPDX-License-Identifier: MIT
 #include "Logger.h"
 
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+struct LogTypeInfo {
+    const char*        label;
+    const std::string* color;
+    bool               bold;
+};
+
+const std::array<LogTypeInfo, static_cast<size_t>(LogType::Count)> LOG_TYPES = {{
+    {"Trace", &LogColors::WHITE, false},
+    {"Debug", &LogColors::BLUE, false},
+    {"Position", &LogColors::GREEN, false},
+    {"Info", &LogColors::CYAN, false},
+    {"Warning", &LogColors::BRIGHT_YELLOW, false},
+    {"Error", &LogColors::RED, false},
+    {"Bug", &LogColors::MAGENTA, true},
+    {"Critical", &LogColors::BRIGHT_RED, false},
+    {"Fatal", &LogColors::BRIGHT_RED, true},
+}};
+
+const LogTypeInfo& typeInfo(LogType type) {
+    return LOG_TYPES[std::min(static_cast<size_t>(type), LOG_TYPES.size() - 1)];
+}
+
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(5);  // Idle wake-up; severe records wake it early
+
+}  // namespace
+
+// ============================================================================
+// Sinks
+// ============================================================================
+
+void ConsoleLogger::write(LogType type, const char* message, size_t length) {
+    const LogTypeInfo& info = typeInfo(type);
+    std::fputs(info.color->c_str(), stream);
+    if (info.bold)
+        std::fputs(LogColors::BOLD.c_str(), stream);
+    std::fputs(info.label, stream);
+    std::fputs(": ", stream);
+    std::fputs(LogColors::RESET.c_str(), stream);
+    std::fwrite(message, 1, length, stream);
+    std::fputc('\n', stream);
+}
+
+void ConsoleLogger::flush() {
+    std::fflush(stream);
+}
+
+FileLogger::FileLogger(const std::string& path) : file(std::fopen(path.c_str(), "w")) {}
+
+FileLogger::~FileLogger() {
+    if (file)
+        std::fclose(file);
+}
+
+void FileLogger::write(LogType type, const char* message, size_t length) {
+    if (!file)
+        return;
+    std::fputs(typeInfo(type).label, file);
+    std::fputs(": ", file);
+    std::fwrite(message, 1, length, file);
+    std::fputc('\n', file);
+}
+
+void FileLogger::flush() {
+    if (file)
+        std::fflush(file);
+}
+
 ILogger* LoggerFactory::createLogger(const std::string& type) {
     if (type == "console") {
         return new ConsoleLogger();
@@ -9,3 +81,127 @@ ILogger* LoggerFactory::createLogger(const std::string& type) {
     }
     return nullptr;
 }
+
+// ============================================================================
+// Backend
+// ============================================================================
+
+LogBackend& LogBackend::get() {
+    static LogBackend backend;
+    return backend;
+}
+
+LogBackend::LogBackend() : sink(std::make_unique<ConsoleLogger>()) {
+    for (size_t i = 0; i < RING_CAPACITY; i++)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    drainThread = std::thread(&LogBackend::drainLoop, this);
+}
+
+LogBackend::~LogBackend() {
+    running.store(false, std::memory_order_release);
+    wake.notify_one();
+    drainThread.join();
+}
+
+void LogBackend::write(LogType type, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    writeV(type, format, args);
+    va_end(args);
+}
+
+void LogBackend::writeV(LogType type, const char* format, va_list args) {
+    const bool mustDeliver = type >= LogType::Warning;
+
+    // Claim a slot: it is free when its sequence equals the position being claimed
+    Slot*    slot = nullptr;
+    uint64_t pos  = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot                = &slots[pos & (RING_CAPACITY - 1)];
+        const uint64_t seq  = slot->sequence.load(std::memory_order_acquire);
+        const int64_t  diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // Ring full: the drain thread has not freed this slot yet
+            if (!mustDeliver) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake.notify_one();
+            std::this_thread::yield();
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    int written  = std::vsnprintf(slot->text, MAX_MESSAGE, format, args);
+    slot->type   = type;
+    slot->length = static_cast<uint16_t>(std::clamp(written, 0, static_cast<int>(MAX_MESSAGE) - 1));
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (type >= LogType::Critical)
+        flush();
+}
+
+void LogBackend::setSink(std::unique_ptr<ILogger> newSink) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    if (sink)
+        sink->flush();
+    sink = std::move(newSink);
+}
+
+void LogBackend::flush() {
+    const uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    while (dequeuePos.load(std::memory_order_acquire) < target) {
+        wake.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+void LogBackend::drainLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        if (!drainOnce()) {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, DRAIN_INTERVAL);
+        }
+    }
+    drainOnce();  // Whatever was logged before shutdown
+}
+
+bool LogBackend::drainOnce() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+
+    bool     drained = false;
+    uint64_t pos     = dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[pos & (RING_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+            break;  // Not yet published
+
+        if (sink)
+            sink->write(slot.type, slot.text, slot.length);
+
+        // Hand the slot back one lap ahead
+        slot.sequence.store(pos + RING_CAPACITY, std::memory_order_release);
+        dequeuePos.store(++pos, std::memory_order_release);
+        drained = true;
+    }
+
+    const uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != droppedReported && sink) {
+        char   note[64];
+        size_t length = static_cast<size_t>(
+            std::snprintf(note, sizeof(note), "%llu log records dropped (ring full)",
+                          static_cast<unsigned long long>(droppedNow - droppedReported)));
+        sink->write(LogType::Warning, note, std::min(length, sizeof(note) - 1));
+        droppedReported = droppedNow;
+        drained         = true;
+    }
+
+    if (drained && sink)
+        sink->flush();
+    return drained;
+}
@@ -1,9 +1,15 @@
 #pragma once
 
-#include <iostream>
-#include <map>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 // ANSI color codes
 namespace LogColors {
@@ -20,101 +26,150 @@ const std::string BRIGHT_RED    = "\033[91m";
 const std::string BRIGHT_YELLOW = "\033[93m";
 }  // namespace LogColors
 
+/**
+ * @brief Log types in increasing severity; DOWNPOUR_LOG_LEVEL filters on this order
+ */
+enum class LogType : uint8_t { Trace, Debug, Position, Info, Warning, Error, Bug, Critical, Fatal, Count };
+
+// Lowest LogType compiled in (numeric value of the enum). Release builds drop
+// trace, debug and position logging entirely; override with -DDOWNPOUR_LOG_LEVEL=N.
+#ifndef DOWNPOUR_LOG_LEVEL
+#ifdef NDEBUG
+#define DOWNPOUR_LOG_LEVEL 3
+#else
+#define DOWNPOUR_LOG_LEVEL 0
+#endif
+#endif
+
+/**
+ * @brief Whether records of this type are compiled in
+ */
+constexpr int MIN_LOG_LEVEL = DOWNPOUR_LOG_LEVEL;
+
+constexpr bool isLogTypeEnabled(LogType type) {
+    return static_cast<int>(type) >= MIN_LOG_LEVEL;
+}
+
+/**
+ * @brief Destination for drained log records
+ *
+ * Only the backend's drain thread calls a sink, so implementations need no locking.
+ */
 struct ILogger {
-    virtual ~ILogger()                           = default;
-    virtual void log(const std::string& message) = 0;
+    virtual ~ILogger()                                                     = default;
+    virtual void write(LogType type, const char* message, size_t length) = 0;
+    virtual void flush() {}
 };
 
+/**
+ * @brief Colored output to stdout (or another console stream, e.g. stderr)
+ */
 struct ConsoleLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::CYAN << "ConsoleLogger: " << LogColors::RESET << message << std::endl;
-    }
-};
-
-struct FileLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::BLUE << "FileLogger: " << LogColors::RESET << message << std::endl;
-    }
-};
-
-struct LoggerFactory {
-    static ILogger* createLogger(const std::string& type);
-};
-
-struct BugLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::MAGENTA << LogColors::BOLD << "Bug: " << LogColors::RESET << message << std::endl;
-    }
-};
+    explicit ConsoleLogger(std::FILE* stream = stdout) : stream(stream) {}
 
-struct WarningLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::BRIGHT_YELLOW << "Warning: " << LogColors::RESET << message << std::endl;
-    }
-};
+    void write(LogType type, const char* message, size_t length) override;
+    void flush() override;
 
-struct InfoLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::CYAN << "Info: " << LogColors::RESET << message << std::endl;
-    }
+private:
+    std::FILE* stream;
 };
 
-struct DebugLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::BLUE << "Debug: " << LogColors::RESET << message << std::endl;
-    }
-};
+/**
+ * @brief Plain-text output to a file (truncated on open)
+ */
+struct FileLogger : public ILogger {
+    explicit FileLogger(const std::string& path = "downpour.log");
+    ~FileLogger() override;
 
-struct TraceLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::WHITE << "Trace: " << LogColors::RESET << message << std::endl;
-    }
-};
+    void write(LogType type, const char* message, size_t length) override;
+    void flush() override;
 
-struct FatalLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::BRIGHT_RED << LogColors::BOLD << "Fatal: " << LogColors::RESET << LogColors::RED
-                  << message << LogColors::RESET << std::endl;
-    }
-};
+    bool isOpen() const { return file != nullptr; }
 
-struct ErrorLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::RED << "Error: " << LogColors::RESET << message << std::endl;
-    }
+private:
+    std::FILE* file = nullptr;
 };
 
-struct CriticalLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::BRIGHT_RED << "Critical: " << LogColors::RESET << message << std::endl;
-    }
+struct LoggerFactory {
+    static ILogger* createLogger(const std::string& type);
 };
 
-struct PositionLogger : public ILogger {
-    void log(const std::string& message) override {
-        std::cout << LogColors::GREEN << "Position: " << LogColors::RESET << message << std::endl;
-    }
+/**
+ * @brief Asynchronous logging backend
+ *
+ * Producers format straight into a slot of a fixed ring (a bounded multi-producer
+ * queue with per-slot sequence numbers), so logging from any thread takes no lock
+ * and never allocates. A background thread drains the ring into the sink.
+ *
+ * When the ring is full, records below Warning are dropped and counted, while
+ * Warning and above wait for space. Critical and Fatal records block until they
+ * have been written, so they survive a crash or an exception escaping main.
+ */
+class LogBackend {
+public:
+    static constexpr size_t RING_CAPACITY = 4096;  // Power of two; ~1 MB of slots
+    static constexpr size_t MAX_MESSAGE   = 240;   // Longer messages are truncated
+
+    static LogBackend& get();
+
+    /**
+     * @brief Format and enqueue one record (printf-style)
+     */
+    void write(LogType type, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+    void writeV(LogType type, const char* format, va_list args);
+
+    /**
+     * @brief Replace the sink; records already queued go to the new one
+     */
+    void setSink(std::unique_ptr<ILogger> sink);
+
+    /**
+     * @brief Block until every record enqueued before this call has been written
+     */
+    void flush();
+
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    LogBackend();
+    ~LogBackend();
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        LogType               type   = LogType::Info;
+        uint16_t              length = 0;
+        char                  text[MAX_MESSAGE];
+    };
+
+    std::array<Slot, RING_CAPACITY> slots;
+    alignas(64) std::atomic<uint64_t> enqueuePos{0};
+    alignas(64) std::atomic<uint64_t> dequeuePos{0};  // Written by the drain thread only
+    std::atomic<uint64_t>             dropped{0};
+    uint64_t                          droppedReported = 0;
+
+    std::mutex               sinkMutex;  // Held by the drain thread and setSink, never by producers
+    std::unique_ptr<ILogger> sink;
+
+    std::mutex              wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool>       running{true};
+    std::thread             drainThread;
+
+    void drainLoop();
+    bool drainOnce();
 };
 
-struct Log {
-    ILogger*                                        logger;
-    std::map<std::string, std::unique_ptr<ILogger>> loggerDispatch;
-    Log() {
-        loggerDispatch["bug"]      = std::make_unique<BugLogger>();
-        loggerDispatch["warning"]  = std::make_unique<WarningLogger>();
-        loggerDispatch["info"]     = std::make_unique<InfoLogger>();
-        loggerDispatch["debug"]    = std::make_unique<DebugLogger>();
-        loggerDispatch["trace"]    = std::make_unique<TraceLogger>();
-        loggerDispatch["fatal"]    = std::make_unique<FatalLogger>();
-        loggerDispatch["error"]    = std::make_unique<ErrorLogger>();
-        loggerDispatch["critical"] = std::make_unique<CriticalLogger>();
-        loggerDispatch["position"] = std::make_unique<PositionLogger>();
-    }
-    void log(const std::string& type, const std::string& message) {
-        try {
-            loggerDispatch[type]->log(message);
-        } catch (const std::exception& e) {
-            std::cout << "Logger not found" << std::endl;
-        }
-    }
-};
+/**
+ * @brief Log a printf-style message, e.g. DP_LOG(Info, "Loaded %zu meshes", count)
+ *
+ * Types below DOWNPOUR_LOG_LEVEL compile to nothing, arguments included.
+ */
+#define DP_LOG(type, ...)                                        \
+    do {                                                         \
+        if constexpr (isLogTypeEnabled(LogType::type))           \
+            LogBackend::get().write(LogType::type, __VA_ARGS__); \
+    } while (0)
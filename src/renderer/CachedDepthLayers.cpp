@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: MIT
+#include "CachedDepthLayers.h"
+
+#include "core/ResourceManager.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace DownPour {
+
+void CachedDepthLayers::init(VkDevice device, VkFormat format, uint32_t resolution, uint32_t layerCount) {
+    this->format     = format;
+    this->resolution = resolution;
+    this->layerCount = layerCount;
+
+    // Only ever drawn and copied on the graphics queue
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent        = {resolution, resolution, 1};
+    imageInfo.mipLevels     = 1;
+    imageInfo.arrayLayers   = layerCount;
+    imageInfo.format        = format;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &staticImage) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create static depth layers");
+    ResourceManager::allocateImageMemory(device, staticImage, VK_IMAGE_TILING_OPTIMAL,
+                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, staticMemory);
+
+    staticPass  = createRenderPass(device, false);
+    dynamicPass = createRenderPass(device, true);
+
+    staticViews.resize(layerCount);
+    staticFramebuffers.resize(layerCount);
+    for (uint32_t i = 0; i < layerCount; i++) {
+        staticViews[i]        = createLayerView(device, staticImage, i);
+        staticFramebuffers[i] = createFramebuffer(device, staticPass, staticViews[i]);
+    }
+}
+
+void CachedDepthLayers::destroy(VkDevice device) {
+    for (VkFramebuffer framebuffer : staticFramebuffers) {
+        if (framebuffer != VK_NULL_HANDLE)
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    for (VkImageView view : staticViews) {
+        if (view != VK_NULL_HANDLE)
+            vkDestroyImageView(device, view, nullptr);
+    }
+    staticFramebuffers.clear();
+    staticViews.clear();
+    for (VkRenderPass* r : {&staticPass, &dynamicPass}) {
+        if (*r != VK_NULL_HANDLE)
+            vkDestroyRenderPass(device, *r, nullptr);
+        *r = VK_NULL_HANDLE;
+    }
+    ResourceManager::destroyImage(device, staticImage, staticMemory);
+}
+
+VkImageView CachedDepthLayers::createLayerView(VkDevice device, VkImage image, uint32_t layer) const {
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                           = image;
+    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format                          = format;
+    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewInfo.subresourceRange.baseMipLevel   = 0;
+    viewInfo.subresourceRange.levelCount     = 1;
+    viewInfo.subresourceRange.baseArrayLayer = layer;
+    viewInfo.subresourceRange.layerCount     = 1;
+
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth layer view");
+    return view;
+}
+
+VkFramebuffer CachedDepthLayers::createDynamicFramebuffer(VkDevice device, VkImageView targetLayerView) const {
+    return createFramebuffer(device, dynamicPass, targetLayerView);
+}
+
+void CachedDepthLayers::beginStaticPass(VkCommandBuffer cmd, uint32_t layer) const {
+    beginPass(cmd, staticPass, staticFramebuffers[layer]);
+}
+
+void CachedDepthLayers::copyToTarget(VkCommandBuffer cmd, VkImage target) const {
+    // Every static layer is a copy source by now: either just rendered, or since an earlier frame.
+    // The render graph moved the target to TRANSFER_DST
+    VkImageCopy region{};
+    region.srcSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, layerCount};
+    region.dstSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, layerCount};
+    region.extent         = {resolution, resolution, 1};
+    vkCmdCopyImage(cmd, staticImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1, &region);
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                           = target;
+    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT;
+    barrier.subresourceRange.baseMipLevel   = 0;
+    barrier.subresourceRange.levelCount     = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount     = layerCount;
+    barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0,
+                         nullptr, 0, nullptr, 1, &barrier);
+}
+
+void CachedDepthLayers::beginDynamicPass(VkCommandBuffer cmd, VkFramebuffer framebuffer) const {
+    beginPass(cmd, dynamicPass, framebuffer);
+}
+
+VkRenderPass CachedDepthLayers::createRenderPass(VkDevice device, bool load) const {
+    VkAttachmentDescription attachment{};
+    attachment.format         = format;
+    attachment.samples        = VK_SAMPLE_COUNT_1_BIT;
+    attachment.loadOp         = load ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachment.initialLayout  = load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+    attachment.finalLayout =
+        load ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    VkAttachmentReference depthRef{0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    constexpr VkPipelineStageFlags depthStages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+    // A static layer: earlier copies stop reading before the clear, and the next copy waits for
+    // the writes. A target: the barrier after the copy covers entry and the render graph covers exit
+    std::array<VkSubpassDependency, 2> dependencies{};
+    dependencies[0].srcSubpass    = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass    = 0;
+    dependencies[0].srcStageMask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstStageMask  = depthStages;
+    dependencies[0].dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    dependencies[1].srcSubpass    = 0;
+    dependencies[1].dstSubpass    = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask  = depthStages;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments    = &attachment;
+    renderPassInfo.subpassCount    = 1;
+    renderPassInfo.pSubpasses      = &subpass;
+    renderPassInfo.dependencyCount = load ? 0 : static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies   = dependencies.data();
+
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth layer render pass");
+    return renderPass;
+}
+
+VkFramebuffer CachedDepthLayers::createFramebuffer(VkDevice device, VkRenderPass renderPass, VkImageView view) const {
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass      = renderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments    = &view;
+    framebufferInfo.width           = resolution;
+    framebufferInfo.height          = resolution;
+    framebufferInfo.layers          = 1;
+
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth layer framebuffer");
+    return framebuffer;
+}
+
+void CachedDepthLayers::beginPass(VkCommandBuffer cmd, VkRenderPass renderPass, VkFramebuffer framebuffer) const {
+    VkClearValue clear{};
+    clear.depthStencil = {1.0f, 0};  // Nothing in front of the far plane
+
+    VkRenderPassBeginInfo rp{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    rp.renderPass        = renderPass;
+    rp.framebuffer       = framebuffer;
+    rp.renderArea.offset = {0, 0};
+    rp.renderArea.extent = {resolution, resolution};
+    rp.clearValueCount   = 1;
+    rp.pClearValues      = &clear;
+    vkCmdBeginRenderPass(cmd, &rp, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(resolution), static_cast<float>(resolution), 0.0f, 1.0f};
+    VkRect2D   scissor{{0, 0}, {resolution, resolution}};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+}  // namespace DownPour
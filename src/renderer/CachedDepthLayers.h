@@ -0,0 +1,95 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/MemoryAllocator.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Static depth layers kept between frames and copied under per-frame depth
+ *
+ * The shared half of depth maps that cache their static geometry
+ * (RainOcclusionMap, ShadowCascades). It owns a square layered image holding the
+ * static world and two render passes over one depth attachment:
+ * - the static pass clears a static layer and leaves it a copy source;
+ * - the dynamic pass loads a target layer and leaves it a depth attachment.
+ * copyToTarget() copies every static layer into the caller's target image,
+ * which must have the same layer count, and makes it a depth attachment for
+ * the dynamic passes. Target images belong to the caller, and so do the
+ * framebuffers made for them with createDynamicFramebuffer().
+ *
+ * Pipelines built against getStaticPass() work in either pass.
+ */
+class CachedDepthLayers {
+public:
+    CachedDepthLayers()  = default;
+    ~CachedDepthLayers() = default;
+
+    CachedDepthLayers(const CachedDepthLayers&)            = delete;
+    CachedDepthLayers& operator=(const CachedDepthLayers&) = delete;
+
+    /**
+     * @brief Create the static image, a framebuffer per layer and both render passes
+     * @param format Depth format of the static layers and the targets
+     * @param resolution Width and height of every layer
+     */
+    void init(VkDevice device, VkFormat format, uint32_t resolution, uint32_t layerCount);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief View of one layer of an image in this format, e.g. a target layer for createDynamicFramebuffer()
+     */
+    VkImageView createLayerView(VkDevice device, VkImage image, uint32_t layer) const;
+
+    /**
+     * @brief Framebuffer for drawing into one target layer with the dynamic pass
+     */
+    VkFramebuffer createDynamicFramebuffer(VkDevice device, VkImageView targetLayerView) const;
+
+    /**
+     * @brief Begin the pass that clears static layer @p layer; record outside any render pass
+     */
+    void beginStaticPass(VkCommandBuffer cmd, uint32_t layer) const;
+
+    /**
+     * @brief Copy every static layer into @p target and make it a depth attachment
+     *
+     * Every static layer must have been rendered at least once; @p target must be in
+     * TRANSFER_DST_OPTIMAL. It is left in DEPTH_STENCIL_ATTACHMENT_OPTIMAL.
+     */
+    void copyToTarget(VkCommandBuffer cmd, VkImage target) const;
+
+    /**
+     * @brief Begin drawing over a target layer copied by copyToTarget()
+     */
+    void beginDynamicPass(VkCommandBuffer cmd, VkFramebuffer framebuffer) const;
+
+    void endPass(VkCommandBuffer cmd) const { vkCmdEndRenderPass(cmd); }
+
+    VkRenderPass getStaticPass() const { return staticPass; }
+
+private:
+    VkFormat format     = VK_FORMAT_UNDEFINED;
+    uint32_t resolution = 0;
+    uint32_t layerCount = 0;
+
+    VkImage                    staticImage = VK_NULL_HANDLE;
+    Allocation                 staticMemory;
+    std::vector<VkImageView>   staticViews;
+    std::vector<VkFramebuffer> staticFramebuffers;
+
+    VkRenderPass staticPass  = VK_NULL_HANDLE;  // Clears; leaves the layer a copy source
+    VkRenderPass dynamicPass = VK_NULL_HANDLE;  // Loads the copy; leaves an attachment
+
+    VkRenderPass  createRenderPass(VkDevice device, bool load) const;
+    VkFramebuffer createFramebuffer(VkDevice device, VkRenderPass renderPass, VkImageView view) const;
+    void          beginPass(VkCommandBuffer cmd, VkRenderPass renderPass, VkFramebuffer framebuffer) const;
+};
+
+}  // namespace DownPour
@@ -54,6 +54,23 @@ mat4 Camera::getProjectionMatrix() {
     return glm::perspective(glm::radians(fov), aspectRatio, nearPlane, farPlane);
 }
 
+mat4 Camera::getMirrorViewMatrix(uint32_t index) const {
+    const MirrorView& mirror = mirrorViews[index];
+
+    // Straight back is -Z in the cockpit frame; positive yaw turns towards -X, the driver's right
+    vec3 eye  = position + targetRotation * mirror.offset;  // position is the cockpit eye in cockpit mode
+    vec3 look = targetRotation * (glm::angleAxis(glm::radians(mirror.yaw), vec3(0.0f, 1.0f, 0.0f)) *
+                                  vec3(0.0f, 0.0f, -1.0f));
+    return glm::lookAt(eye, eye + glm::normalize(look), vec3(0.0f, 1.0f, 0.0f));
+}
+
+mat4 Camera::getMirrorProjectionMatrix(uint32_t index) const {
+    const MirrorView& mirror = mirrorViews[index];
+    mat4 projection = glm::perspective(glm::radians(mirror.fov), mirror.aspect, nearPlane, farPlane);
+    projection[0][0] *= -1.0f;  // A mirror shows the scene reflected left to right
+    return projection;
+}
+
 void Camera::updateCameraVectors() {
     vec3 front;
     front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
@@ -171,14 +188,8 @@ void Camera::updateCockpitCamera() {
     // Log camera position periodically (every 60 frames)
     static int frameCount = 0;
     if (++frameCount % 60 == 0) {  // Log every 60 frames (~1 second at 60fps)
-        Log logger;
-        logger.log("position",
-            "Camera: (" + std::to_string(position.x) + ", " +
-            std::to_string(position.y) + ", " +
-            std::to_string(position.z) + ") | Car: (" +
-            std::to_string(targetPosition.x) + ", " +
-            std::to_string(targetPosition.y) + ", " +
-            std::to_string(targetPosition.z) + ")");
+        DP_LOG(Position, "Camera: (%.3f, %.3f, %.3f) | Car: (%.3f, %.3f, %.3f)", position.x, position.y, position.z,
+               targetPosition.x, targetPosition.y, targetPosition.z);
     }
 }
 
@@ -3,6 +3,8 @@
 #include "core/Types.h"
 
 #include <GLFW/glfw3.h>
+
+#include <vector>
 // logger
 #include "logger/Logger.h"
 
@@ -23,6 +25,21 @@ enum class CameraMode {
     ThirdPerson  
 };
 
+/**
+ * @brief A rear-view or side mirror seen from the cockpit
+ *
+ * Placed in the cockpit frame (+Z forward, +Y up, +X to the driver's left), so
+ * the mirror follows the car. Rendered as an extra view of the scene and drawn
+ * over the cockpit view at screenRect.
+ */
+struct MirrorView {
+    vec3 offset     = vec3(0.0f);  // Mirror position relative to the cockpit eye
+    f32  yaw        = 0.0f;        // Degrees from straight back, positive towards the driver's right
+    f32  fov        = 20.0f;       // Vertical, degrees
+    f32  aspect     = 3.0f;
+    vec4 screenRect = vec4(0.0f);  // x, y, width, height as fractions of the cockpit view
+};
+
 class Camera {
 public:
     Camera(vec3 pos, f32 aspect);
@@ -61,6 +78,12 @@ public:
     void setChaseHeight(f32 height) { chaseHeight = height; }
     void setThirdPersonDistance(f32 distance) { thirdPersonDistance = distance; }
 
+    // Mirrors only follow the car in cockpit mode; their images are reflected left to right
+    void                           setMirrorViews(const std::vector<MirrorView>& views) { mirrorViews = views; }
+    const std::vector<MirrorView>& getMirrorViews() const { return mirrorViews; }
+    mat4                           getMirrorViewMatrix(uint32_t index) const;
+    mat4                           getMirrorProjectionMatrix(uint32_t index) const;
+
 private:
 
     vec3 position;
@@ -87,6 +110,8 @@ private:
     f32 thirdPersonHeight   = 3.0f;  
     f32 thirdPersonAngle    = 0.0f;  
 
+    std::vector<MirrorView> mirrorViews;
+
     void updateCameraVectors();               
     void updateCockpitCamera();               
     void updateChaseCamera(float deltaTime);  
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: MIT
+#include "ClusteredLights.h"
+
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace DownPour {
+
+static_assert(sizeof(LightGridHeader) % 16 == 0, "The light array must start 16-byte aligned for std430");
+static_assert(ClusteredLights::CLUSTER_COUNT % ClusteredLights::GROUP_SIZE == 0, "Froxels fill whole workgroups");
+
+void ClusteredLights::init(VkDevice device, VkPhysicalDevice physicalDevice, VkBuffer frameBuffer,
+                           VkPipelineCache pipelineCache) {
+    lights.reserve(MAX_LIGHTS);
+
+    ResourceManager::createBuffer(device, physicalDevice, CLUSTER_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, clusterBuffer, clusterMemory);
+    createDescriptors(device, frameBuffer);
+
+    layout   = PipelineFactory::createPipelineLayout(device, {setLayout});
+    pipeline = PipelineFactory::createComputePipeline(device, "light_cull.comp.spv", layout, pipelineCache);
+}
+
+void ClusteredLights::destroy(VkDevice device) {
+    if (pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    if (layout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, layout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    ResourceManager::destroyBuffer(device, clusterBuffer, clusterMemory);
+
+    pipeline  = VK_NULL_HANDLE;
+    layout    = VK_NULL_HANDLE;
+    pool      = VK_NULL_HANDLE;
+    set       = VK_NULL_HANDLE;
+    setLayout = VK_NULL_HANDLE;
+    lights.clear();
+}
+
+bool ClusteredLights::addPointLight(const glm::vec3& position, const glm::vec3& color, float range) {
+    if (lights.size() >= MAX_LIGHTS || range <= 0.0f)
+        return false;
+
+    LocalLight light;
+    light.positionRange = glm::vec4(position, range);
+    light.color         = glm::vec4(color, 0.0f);
+    light.spotDirection = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+    light.bounds        = glm::vec4(position, range);
+    lights.push_back(light);
+    return true;
+}
+
+bool ClusteredLights::addSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color,
+                                   float range, float halfAngleDegrees) {
+    if (lights.size() >= MAX_LIGHTS || range <= 0.0f)
+        return false;
+
+    const glm::vec3 axis      = glm::normalize(direction);
+    const float     halfAngle = glm::radians(glm::clamp(halfAngleDegrees, 1.0f, 89.0f));
+    const float     cosAngle  = std::cos(halfAngle);
+
+    // Smallest sphere around the cone: through its rim when it is wide, through its apex and rim when narrow
+    glm::vec4 bounds;
+    if (halfAngle > glm::radians(45.0f)) {
+        bounds = glm::vec4(position + axis * (range * cosAngle), range * std::sin(halfAngle));
+    } else {
+        const float radius = range / (2.0f * cosAngle);
+        bounds             = glm::vec4(position + axis * radius, radius);
+    }
+
+    LocalLight light;
+    light.positionRange = glm::vec4(position, range);
+    light.color         = glm::vec4(color, 0.0f);
+    light.spotDirection = glm::vec4(axis, cosAngle);
+    light.bounds        = bounds;
+    lights.push_back(light);
+    return true;
+}
+
+void ClusteredLights::upload(const FrameAllocation& buffer, const glm::mat4& view, const glm::mat4& proj) {
+    // Slice k of GRID_Z starts at GRID_NEAR * (GRID_FAR / GRID_NEAR)^(k / GRID_Z)
+    const float sliceScale = static_cast<float>(GRID_Z) / std::log(GRID_FAR / GRID_NEAR);
+
+    LightGridHeader header{};
+    header.view        = view;
+    header.viewProj    = proj * view;
+    header.inverseProj = glm::inverse(proj);
+    header.depthParams = glm::vec4(GRID_NEAR, GRID_FAR, sliceScale, -std::log(GRID_NEAR) * sliceScale);
+    header.counts      = glm::uvec4(static_cast<uint32_t>(lights.size()), 0u, 0u, 0u);
+
+    auto* bytes = static_cast<uint8_t*>(buffer.data);
+    memcpy(bytes, &header, sizeof(header));
+    if (!lights.empty())
+        memcpy(bytes + sizeof(header), lights.data(), sizeof(LocalLight) * lights.size());
+
+    lightOffset = buffer.dynamicOffset();
+}
+
+void ClusteredLights::recordCull(VkCommandBuffer cmd) const {
+    if (pipeline == VK_NULL_HANDLE)
+        return;
+
+    // Every froxel is rewritten, so one with no lights still clears last frame's list
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &set, 1, &lightOffset);
+    vkCmdDispatch(cmd, CLUSTER_COUNT / GROUP_SIZE, 1, 1);
+}
+
+void ClusteredLights::createDescriptors(VkDevice device, VkBuffer frameBuffer) {
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding         = 0;
+    bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding         = 1;
+    bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create light cull descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create light cull descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate light cull descriptor set");
+
+    VkDescriptorBufferInfo lightInfo{};
+    lightInfo.buffer = frameBuffer;
+    lightInfo.offset = 0;
+    lightInfo.range  = LIGHT_BUFFER_SIZE;
+
+    VkDescriptorBufferInfo clusterInfo{};
+    clusterInfo.buffer = clusterBuffer;
+    clusterInfo.offset = 0;
+    clusterInfo.range  = CLUSTER_BUFFER_SIZE;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t b = 0; b < writes.size(); b++) {
+        writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[b].dstSet          = set;
+        writes[b].dstBinding      = b;
+        writes[b].descriptorType  = bindings[b].descriptorType;
+        writes[b].descriptorCount = 1;
+    }
+    writes[0].pBufferInfo = &lightInfo;
+    writes[1].pBufferInfo = &clusterInfo;
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+}  // namespace DownPour
@@ -0,0 +1,137 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/FrameAllocator.h"
+#include "core/MemoryAllocator.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief One local light, as the light cull shader and the scene shaders read it (std430)
+ */
+struct LocalLight {
+    glm::vec4 positionRange;  // xyz: world position, w: range (m); nothing is lit beyond it
+    glm::vec4 color;          // rgb: color * intensity
+    glm::vec4 spotDirection;  // xyz: unit cone axis, w: cosine of the cone's half-angle; -1 lights every direction
+    glm::vec4 bounds;         // World sphere the light reaches (xyz center, w radius), for culling
+};
+
+/**
+ * @brief Start of the light buffer: how the main view is sliced into clusters, then the lights (std430)
+ */
+struct LightGridHeader {
+    glm::mat4  view;
+    glm::mat4  viewProj;
+    glm::mat4  inverseProj;
+    glm::vec4  depthParams;  // x: GRID_NEAR, y: GRID_FAR, z/w: slice = log(view depth) * z + w
+    glm::uvec4 counts;       // x: light count
+};
+
+/**
+ * @brief Clustered forward lighting for the car's lamps, street lamps and anything else small and bright
+ *
+ * The main view's frustum is cut into a GRID_X x GRID_Y x GRID_Z grid of
+ * froxels: screen tiles, sliced exponentially in view depth between
+ * GRID_NEAR and GRID_FAR. Each frame the caller adds its lights, upload()
+ * writes them with the view into the frame allocator, and recordCull()
+ * dispatches one thread per froxel to list the lights whose bounding sphere
+ * touches it. The scene's fragment shaders find their froxel from their
+ * world position and shade with that list alone, so a pixel costs as much
+ * as the lights near it rather than every light in the scene.
+ *
+ * A froxel keeps at most LIGHTS_PER_CLUSTER lights, the first added; add the
+ * important and the near ones first. Surfaces outside the main view's grid
+ * (past GRID_FAR, or seen only in a mirror) get no local light.
+ */
+class ClusteredLights {
+public:
+    // The grid and LIGHTS_PER_CLUSTER must match shaders/light_grid.glsl, which every shader using them includes
+    static constexpr uint32_t GRID_X             = 16;
+    static constexpr uint32_t GRID_Y             = 9;
+    static constexpr uint32_t GRID_Z             = 24;
+    static constexpr uint32_t CLUSTER_COUNT      = GRID_X * GRID_Y * GRID_Z;
+    static constexpr uint32_t LIGHTS_PER_CLUSTER = 32;
+    static constexpr uint32_t MAX_LIGHTS         = 1024;  // Per frame
+    static constexpr uint32_t GROUP_SIZE         = 64;    // Must match light_cull.comp
+
+    static constexpr float GRID_NEAR = 0.5f;    // Metres; the first slice reaches back to the eye
+    static constexpr float GRID_FAR  = 500.0f;  // Metres; farther surfaces get no local light
+
+    // A count, then LIGHTS_PER_CLUSTER indices, per froxel
+    static constexpr VkDeviceSize CLUSTER_BUFFER_SIZE =
+        sizeof(uint32_t) * CLUSTER_COUNT * (LIGHTS_PER_CLUSTER + 1);
+    static constexpr VkDeviceSize LIGHT_BUFFER_SIZE = sizeof(LightGridHeader) + sizeof(LocalLight) * MAX_LIGHTS;
+
+    ClusteredLights()  = default;
+    ~ClusteredLights() = default;
+
+    ClusteredLights(const ClusteredLights&)            = delete;
+    ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+    /**
+     * @brief Create the cluster buffer and the cull pipeline
+     * @param frameBuffer Buffer holding the allocations passed to upload()
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkBuffer frameBuffer, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /** @brief Forget last frame's lights */
+    void clear() { lights.clear(); }
+
+    /**
+     * @brief Add a light shining every way; false once MAX_LIGHTS are queued
+     */
+    bool addPointLight(const glm::vec3& position, const glm::vec3& color, float range);
+
+    /**
+     * @brief Add a cone of light; false once MAX_LIGHTS are queued
+     * @param halfAngleDegrees Between the axis and the cone's edge, as glTF's outerConeAngle
+     */
+    bool addSpotLight(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color, float range,
+                      float halfAngleDegrees);
+
+    uint32_t getLightCount() const { return static_cast<uint32_t>(lights.size()); }
+
+    /**
+     * @brief Write the grid for the main view and this frame's lights
+     * @param buffer LIGHT_BUFFER_SIZE bytes, storage aligned; bound to the scene shaders at its dynamic offset
+     * @param proj The view's projection, Y already flipped for Vulkan
+     */
+    void upload(const FrameAllocation& buffer, const glm::mat4& view, const glm::mat4& proj);
+
+    /**
+     * @brief List each froxel's lights; record outside a render pass, after upload()
+     *
+     * The caller orders the cluster buffer's writes before the fragment shaders read it.
+     */
+    void recordCull(VkCommandBuffer cmd) const;
+
+    /** @brief CLUSTER_BUFFER_SIZE bytes, rewritten by every recordCull() */
+    VkBuffer getClusterBuffer() const { return clusterBuffer; }
+
+private:
+    std::vector<LocalLight> lights;           // Reserved to MAX_LIGHTS by init()
+    uint32_t                lightOffset = 0;  // Dynamic offset of the last upload()
+
+    VkBuffer   clusterBuffer = VK_NULL_HANDLE;
+    Allocation clusterMemory;
+
+    // Binding 0: lights at the frame's dynamic offset, binding 1: clusters
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool      pool      = VK_NULL_HANDLE;
+    VkDescriptorSet       set       = VK_NULL_HANDLE;
+    VkPipelineLayout      layout    = VK_NULL_HANDLE;
+    VkPipeline            pipeline  = VK_NULL_HANDLE;
+
+    void createDescriptors(VkDevice device, VkBuffer frameBuffer);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: MIT
+#include "DynamicResolution.h"
+
+#include "core/ResourceManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace DownPour {
+
+void DynamicResolution::createTarget(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D extent,
+                                     VkFormat format) {
+    outputExtent = extent;
+    applyScale(scale);
+
+    ResourceManager::createImage(device, physicalDevice, extent.width, extent.height, format, VK_IMAGE_TILING_OPTIMAL,
+                                 VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImage, colorMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                           = colorImage;
+    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format                          = format;
+    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel   = 0;
+    viewInfo.subresourceRange.levelCount     = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount     = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &colorView) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create scene color view");
+}
+
+void DynamicResolution::destroy(VkDevice device) {
+    if (colorView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, colorView, nullptr);
+    ResourceManager::destroyImage(device, colorImage, colorMemory);
+    colorView = VK_NULL_HANDLE;
+}
+
+void DynamicResolution::setTargetFrameTime(float ms) {
+    targetMs   = std::max(ms, 0.0f);
+    smoothedMs = 0.0f;
+    if (targetMs == 0.0f)
+        applyScale(MAX_SCALE);
+}
+
+void DynamicResolution::update(const GpuProfiler& profiler) {
+    if (targetMs == 0.0f || !profiler.isEnabled() || profiler.getResolvedFrameCount() == lastResolved)
+        return;
+    lastResolved = profiler.getResolvedFrameCount();
+
+    const float frameMs = profiler.getLastFrameMs();
+    smoothedMs          = smoothedMs == 0.0f ? frameMs : smoothedMs + (frameMs - smoothedMs) * SMOOTHING;
+
+    // Frames recorded before the last change are still resolving; let them drain from the average
+    if (settleFrames > 0) {
+        settleFrames--;
+        return;
+    }
+    if (smoothedMs <= 0.0f)
+        return;
+
+    // Cost follows the pixel count, i.e. the square of the per-axis scale
+    const float desired = scale * std::sqrt(targetMs / smoothedMs);
+    float       next    = scale;
+    if (smoothedMs > targetMs)
+        next = std::max(desired, scale - SCALE_STEP_DOWN);
+    else if (smoothedMs < targetMs * RAISE_HEADROOM)
+        next = std::min(desired, scale + SCALE_STEP_UP);
+
+    next = std::clamp(next, MIN_SCALE, MAX_SCALE);
+    if (std::abs(next - scale) > 1e-3f) {
+        applyScale(next);
+        settleFrames = SETTLE_FRAMES;
+    }
+}
+
+void DynamicResolution::applyScale(float newScale) {
+    scale        = newScale;
+    renderExtent = {std::max(1u, static_cast<uint32_t>(std::lround(outputExtent.width * scale))),
+                    std::max(1u, static_cast<uint32_t>(std::lround(outputExtent.height * scale)))};
+}
+
+}  // namespace DownPour
@@ -0,0 +1,88 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/GpuProfiler.h"
+#include "core/MemoryAllocator.h"
+
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Scene color target rendered at a variable scale and reconstructed at the output size
+ *
+ * The target is allocated at the output size and the render pass draws into
+ * its top-left getRenderExtent() (render area, viewport and scissor), so a
+ * scale change costs nothing but the next frame's smaller region; depth, motion
+ * and the OIT targets are used the same way. TemporalUpscaler then rebuilds the
+ * whole swap chain image from that region and the frames before it.
+ *
+ * update() steers the scale towards a GPU frame time target from the
+ * profiler's resolved frames: GPU cost is taken to follow the pixel count, so
+ * the scale moves by the square root of target / measured, limited per step
+ * and with headroom before scaling back up, so it does not oscillate.
+ */
+class DynamicResolution {
+public:
+    static constexpr float MIN_SCALE = 0.5f;  // Per axis
+    static constexpr float MAX_SCALE = 1.0f;
+
+    DynamicResolution()  = default;
+    ~DynamicResolution() = default;
+
+    DynamicResolution(const DynamicResolution&)            = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    /**
+     * @brief Create the scene color target at the output size
+     * @param format Must match the render pass color attachment
+     *
+     * Besides rendering, the target is sampled by the temporal upscaler and the wet road's reflections.
+     */
+    void createTarget(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D outputExtent, VkFormat format);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief GPU frame time to hold (ms); 0 disables scaling and renders at the full size
+     */
+    void  setTargetFrameTime(float ms);
+    float getTargetFrameTime() const { return targetMs; }
+
+    /**
+     * @brief Adjust the scale from the profiler's latest resolved frame; call once per frame before recording
+     */
+    void update(const GpuProfiler& profiler);
+
+    float      getScale() const { return scale; }
+    VkExtent2D getRenderExtent() const { return renderExtent; }
+    VkExtent2D getOutputExtent() const { return outputExtent; }
+
+    VkImage     getColorImage() const { return colorImage; }
+    VkImageView getColorView() const { return colorView; }
+
+private:
+    static constexpr float SCALE_STEP_DOWN = 0.1f;   // Largest change per adjustment
+    static constexpr float SCALE_STEP_UP   = 0.02f;  // Recover slowly; dropping frames is worse
+    static constexpr float RAISE_HEADROOM  = 0.85f;  // Only scale up below this fraction of the target
+    static constexpr float SMOOTHING       = 0.2f;   // Weight of each new sample in the running average
+    static constexpr int   SETTLE_FRAMES   = 4;      // Resolved frames to skip after a change (still in flight)
+
+    VkImage     colorImage = VK_NULL_HANDLE;
+    Allocation  colorMemory;
+    VkImageView colorView    = VK_NULL_HANDLE;
+    VkExtent2D  outputExtent = {0, 0};
+    VkExtent2D  renderExtent = {0, 0};
+
+    float    targetMs     = 0.0f;
+    float    scale        = MAX_SCALE;
+    float    smoothedMs   = 0.0f;
+    uint64_t lastResolved = 0;
+    int      settleFrames = 0;
+
+    void applyScale(float newScale);
+};
+
+}  // namespace DownPour
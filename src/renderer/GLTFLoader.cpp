@@ -4,6 +4,8 @@
 
 #include "GLTFLoader.h"
 #include "Model.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
 #include "logger/Logger.h"
 
 #include <tiny_gltf.h>
@@ -15,10 +17,94 @@
 
 namespace DownPour {
 
-bool GLTFLoader::load(const std::string& filepath, Model& outModel) {
-    tinygltf::TinyGLTF loader;
-    tinygltf::Model    model;
-    std::string        err, warn;
+namespace {
+
+/**
+ * @brief tinygltf image callback that keeps the encoded bytes instead of decoding them
+ *
+ * tinygltf would decode every image serially while parsing; decodeImages()
+ * decodes the ones materials use afterwards, in parallel.
+ */
+bool keepEncodedImage(tinygltf::Image* /*image*/, const int imageIndex, std::string* /*err*/,
+                      std::string* /*warn*/, int /*reqWidth*/, int /*reqHeight*/, const unsigned char* bytes, int size,
+                      void* userData) {
+    auto& encoded = *static_cast<std::vector<std::vector<unsigned char>>*>(userData);
+    if (imageIndex < 0)
+        return false;
+    if (static_cast<size_t>(imageIndex) >= encoded.size())
+        encoded.resize(static_cast<size_t>(imageIndex) + 1);
+    encoded[imageIndex].assign(bytes, bytes + size);
+    return true;
+}
+
+int imageOfTexture(const tinygltf::Model& model, int textureIndex) {
+    if (textureIndex < 0 || textureIndex >= static_cast<int>(model.textures.size()))
+        return -1;
+    const int source = model.textures[textureIndex].source;
+    return source >= 0 && source < static_cast<int>(model.images.size()) ? source : -1;
+}
+
+/**
+ * @brief Decode every embedded image a material samples, once each, on the job system
+ *
+ * Images referenced by several materials decode into one shared buffer.
+ * External images (with a URI) are left to MaterialManager, which loads them by path.
+ */
+std::vector<EmbeddedTexture> decodeImages(const tinygltf::Model&                  model,
+                                          std::vector<std::vector<unsigned char>>& encoded) {
+    DP_PROFILE_SCOPE("GLTFLoader::decodeImages");
+
+    std::vector<int>  unique;
+    std::vector<bool> seen(model.images.size(), false);
+    for (const tinygltf::Material& material : model.materials) {
+        const int textures[] = {material.pbrMetallicRoughness.baseColorTexture.index, material.normalTexture.index,
+                                material.pbrMetallicRoughness.metallicRoughnessTexture.index,
+                                material.emissiveTexture.index};
+        for (int textureIndex : textures) {
+            const int image = imageOfTexture(model, textureIndex);
+            if (image < 0 || seen[image] || !model.images[image].uri.empty() ||
+                static_cast<size_t>(image) >= encoded.size() || encoded[image].empty())
+                continue;
+            seen[image] = true;
+            unique.push_back(image);
+        }
+    }
+
+    std::vector<EmbeddedTexture> images(model.images.size());
+    JobSystem::get().parallelFor(static_cast<uint32_t>(unique.size()), 1, [&](uint32_t i) {
+        const int                   image = unique[i];
+        std::vector<unsigned char>& bytes = encoded[image];
+
+        int      width, height, channels;
+        stbi_uc* pixels = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height,
+                                                &channels, STBI_rgb_alpha);
+        std::vector<unsigned char>().swap(bytes);  // The encoded copy is no longer needed
+        if (!pixels) {
+            DP_LOG(Warning, "glTF: failed to decode image %d (%s)", image, stbi_failure_reason());
+            return;
+        }
+
+        EmbeddedTexture& texture = images[image];
+        texture.setPixels(std::vector<unsigned char>(pixels, pixels + static_cast<size_t>(width) * height * 4));
+        texture.width  = width;
+        texture.height = height;
+        stbi_image_free(pixels);
+    });
+
+    DP_LOG(Info, "  Images: %zu decoded", unique.size());
+    return images;
+}
+
+}  // namespace
+
+bool GLTFLoader::load(const std::string& filepath, Model& outModel, std::vector<std::string>* outDependencies) {
+    DP_PROFILE_SCOPE("GLTFLoader::load");
+
+    tinygltf::TinyGLTF                      loader;
+    tinygltf::Model                         model;
+    std::string                             err, warn;
+    std::vector<std::vector<unsigned char>> encodedImages;
+    loader.SetImageLoader(keepEncodedImage, &encodedImages);
 
     bool ret = false;
     if (filepath.substr(filepath.find_last_of(".") + 1) == "glb") {
@@ -28,25 +114,35 @@ bool GLTFLoader::load(const std::string& filepath, Model& outModel) {
     }
 
     // Check for loading errors
-    Log logger;
-
     if (!warn.empty()) {
-        logger.log("warning", "glTF Warning: " + warn);
+        DP_LOG(Warning, "glTF Warning: %s", warn.c_str());
     }
 
     if (!err.empty()) {
-        logger.log("error", "glTF Error: " + err);
+        DP_LOG(Error, "glTF Error: %s", err.c_str());
     }
 
     if (!ret) {
-        logger.log("fatal", "Failed to load glTF model: " + filepath);
+        DP_LOG(Fatal, "Failed to load glTF model: %s", filepath.c_str());
         return false;
     }
 
-    logger.log("info", "Successfully loaded glTF model: " + filepath);
-    logger.log("info", "  Nodes: " + std::to_string(model.nodes.size()));
-    logger.log("info", "  Meshes: " + std::to_string(model.meshes.size()));
-    logger.log("info", "  Materials: " + std::to_string(model.materials.size()));
+    DP_LOG(Info, "Successfully loaded glTF model: %s", filepath.c_str());
+    DP_LOG(Info, "  Nodes: %zu", model.nodes.size());
+    DP_LOG(Info, "  Meshes: %zu", model.meshes.size());
+    DP_LOG(Info, "  Materials: %zu", model.materials.size());
+
+    // External buffers feed the vertex data too, so a cooked copy must track them
+    if (outDependencies) {
+        const std::filesystem::path modelDir = std::filesystem::path(filepath).parent_path();
+        for (const auto& buffer : model.buffers) {
+            if (!buffer.uri.empty() && buffer.uri.rfind("data:", 0) != 0)
+                outDependencies->push_back((modelDir / buffer.uri).string());
+        }
+    }
+
+    // Decoded up front so materials sharing an image share its pixels
+    const std::vector<EmbeddedTexture> images = decodeImages(model, encodedImages);
 
     // Process each mesh in the model
     for (size_t meshIdx = 0; meshIdx < model.meshes.size(); meshIdx++) {
@@ -174,6 +270,7 @@ bool GLTFLoader::load(const std::string& filepath, Model& outModel) {
                 newMaterial.name           = gltfMaterial.name;
                 newMaterial.meshIndex      = static_cast<int32_t>(meshIdx);
                 newMaterial.primitiveIndex = static_cast<int32_t>(primIdx);
+                newMaterial.sourceIndex    = primitive.material;
                 newMaterial.indexStart     = primitiveIndexStart;
                 newMaterial.indexCount     = primitiveIndexCount;
 
@@ -205,18 +302,21 @@ bool GLTFLoader::load(const std::string& filepath, Model& outModel) {
                 }
 
                 // Extract texture paths or embedded data using helper
-                processGLTFTexture(filepath, &model, gltfMaterial.pbrMetallicRoughness.baseColorTexture.index,
+                processGLTFTexture(filepath, &model, images, gltfMaterial.pbrMetallicRoughness.baseColorTexture.index,
                                    newMaterial.baseColorTexture, newMaterial.embeddedBaseColor, dummyFlag);
 
-                processGLTFTexture(filepath, &model, gltfMaterial.normalTexture.index, newMaterial.normalMapTexture,
-                                   newMaterial.embeddedNormalMap, newMaterial.props.hasNormalMap);
+                processGLTFTexture(filepath, &model, images, gltfMaterial.normalTexture.index,
+                                   newMaterial.normalMapTexture, newMaterial.embeddedNormalMap,
+                                   newMaterial.props.hasNormalMap);
 
-                processGLTFTexture(filepath, &model, gltfMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index,
+                processGLTFTexture(filepath, &model, images,
+                                   gltfMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index,
                                    newMaterial.metallicRoughnessTexture, newMaterial.embeddedMetallicRoughness,
                                    newMaterial.props.hasMetallicRoughness);
 
-                processGLTFTexture(filepath, &model, gltfMaterial.emissiveTexture.index, newMaterial.emissiveTexture,
-                                   newMaterial.embeddedEmissive, newMaterial.props.hasEmissive);
+                processGLTFTexture(filepath, &model, images, gltfMaterial.emissiveTexture.index,
+                                   newMaterial.emissiveTexture, newMaterial.embeddedEmissive,
+                                   newMaterial.props.hasEmissive);
 
                 outModel.materials.push_back(newMaterial);
             }
@@ -333,27 +433,20 @@ std::string GLTFLoader::resolveTexturePath(const std::string& modelPath, const s
     return texturePath.string();
 }
 
-void GLTFLoader::processGLTFTexture(const std::string& filepath, const void* modelPtr, int textureIndex,
-                                   std::string& outPath, EmbeddedTexture& outEmbedded, bool& outHasFlag) {
-    if (textureIndex < 0)
-        return;
-
-    const auto& model = *static_cast<const tinygltf::Model*>(modelPtr);
-    if (textureIndex >= static_cast<int>(model.textures.size()))
-        return;
-
-    const auto& texture = model.textures[textureIndex];
-    if (texture.source < 0 || texture.source >= static_cast<int>(model.images.size()))
+void GLTFLoader::processGLTFTexture(const std::string& filepath, const void* modelPtr,
+                                    const std::vector<EmbeddedTexture>& images, int textureIndex,
+                                    std::string& outPath, EmbeddedTexture& outEmbedded, bool& outHasFlag) {
+    const auto& model      = *static_cast<const tinygltf::Model*>(modelPtr);
+    const int   imageIndex = imageOfTexture(model, textureIndex);
+    if (imageIndex < 0)
         return;
 
-    const auto& image = model.images[texture.source];
+    const auto& image = model.images[imageIndex];
 
     if (!image.uri.empty()) {
         outPath = resolveTexturePath(filepath, image.uri);
-    } else if (!image.image.empty()) {
-        outEmbedded.pixels = image.image;
-        outEmbedded.width  = image.width;
-        outEmbedded.height = image.height;
+    } else if (images[imageIndex].isValid()) {
+        outEmbedded = images[imageIndex];  // Shares the decoded pixels
     }
     outHasFlag = true;
 }
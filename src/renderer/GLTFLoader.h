@@ -1,10 +1,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace DownPour {
 
 class Model;
+struct EmbeddedTexture;
 
 /**
  * @brief Utility for loading GLTF/GLB files into Model data structures
@@ -23,18 +25,21 @@ public:
      *
      * @param filepath Path to .gltf or .glb file
      * @param outModel Model to populate with loaded data
+     * @param outDependencies Optional; receives the external buffer files (.bin) that were read
      * @return true on success, false on failure
      */
-    static bool load(const std::string& filepath, Model& outModel);
+    static bool load(const std::string& filepath, Model& outModel,
+                     std::vector<std::string>* outDependencies = nullptr);
 
 private:
     // Helper to resolve texture paths (external or embedded)
     static std::string resolveTexturePath(const std::string& modelPath,
                                          const std::string& textureUri);
 
-    // Helper to process GLTF texture references
+    // Helper to process GLTF texture references; images holds the decoded embedded images by index
     static void processGLTFTexture(const std::string& filepath,
                                   const void* modelPtr,
+                                  const std::vector<EmbeddedTexture>& images,
                                   int textureIndex,
                                   std::string& outPath,
                                   struct EmbeddedTexture& outEmbedded,
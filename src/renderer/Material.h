@@ -1,9 +1,19 @@
 #pragma once
 
+#include "core/JobSystem.h"
+#include "core/MemoryAllocator.h"
+#include "core/PipelineFactory.h"
+#include "core/UploadManager.h"
+
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -14,24 +24,105 @@ namespace DownPour {
  * @brief Wrapper for Vulkan texture resources
  *
  * Encapsulates all Vulkan handles needed for a single texture,
- * providing type safety and easier resource management.
+ * providing type safety and easier resource management. Handles from
+ * MaterialManager are shared: the image is reference counted by the
+ * manager's texture cache and the sampler belongs to its sampler cache.
  */
 struct TextureHandle {
-    VkImage        image   = VK_NULL_HANDLE;
-    VkImageView    view    = VK_NULL_HANDLE;
-    VkSampler      sampler = VK_NULL_HANDLE;
-    VkDeviceMemory memory  = VK_NULL_HANDLE;
+    VkImage     image     = VK_NULL_HANDLE;
+    VkImageView view      = VK_NULL_HANDLE;
+    VkSampler   sampler   = VK_NULL_HANDLE;
+    Allocation  memory;
+    VkFormat    format    = VK_FORMAT_R8G8B8A8_SRGB;
+    uint32_t    mipLevels = 1;
 
     bool isValid() const { return image != VK_NULL_HANDLE; }
 
     void reset() {
-        image   = VK_NULL_HANDLE;
-        view    = VK_NULL_HANDLE;
-        sampler = VK_NULL_HANDLE;
-        memory  = VK_NULL_HANDLE;
+        image     = VK_NULL_HANDLE;
+        view      = VK_NULL_HANDLE;
+        sampler   = VK_NULL_HANDLE;
+        memory    = Allocation{};
+        format    = VK_FORMAT_R8G8B8A8_SRGB;
+        mipLevels = 1;
+    }
+};
+
+/**
+ * @brief Texture slots of a material, in VulkanMaterialResources order
+ */
+enum TextureMap : uint32_t {
+    TEXTURE_MAP_BASE_COLOR         = 0,
+    TEXTURE_MAP_NORMAL             = 1,
+    TEXTURE_MAP_METALLIC_ROUGHNESS = 2,
+    TEXTURE_MAP_EMISSIVE           = 3,
+    TEXTURE_MAP_COUNT              = 4,
+};
+
+/**
+ * @brief Texture streaming settings (MaterialManager::enableTextureStreaming)
+ */
+struct TextureStreamingConfig {
+    uint64_t uploadBytesPerFrame    = 8ull << 20;    // Queued per frame; a single larger texture still goes alone
+    uint64_t vramBudget             = 256ull << 20;  // Streamed texture images; less when the device runs short
+    float    fullResolutionDistance = 15.0f;         // Draws nearer than this want every level; each doubling drops one
+    uint32_t minResidentSize        = 64;            // Coarsest streamed image keeps at least this many texels a side
+};
+
+struct TextureStreamingStats {
+    uint32_t textures       = 0;  // Distinct streamed textures
+    uint32_t resident       = 0;  // With an image bound, at any level
+    uint32_t fullResolution = 0;  // With every level bound
+    uint32_t pending        = 0;  // Decoding, or with an upload in flight
+    uint64_t residentBytes  = 0;
+};
+
+/**
+ * @brief Sampler state; MaterialManager creates one VkSampler per distinct value
+ */
+struct SamplerState {
+    VkFilter             filter        = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode  mipmapMode    = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressMode   = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    float                maxAnisotropy = 1.0f;  // 1 = anisotropic filtering off
+    float                maxLod        = 0.0f;
+
+    bool operator==(const SamplerState& other) const {
+        return filter == other.filter && mipmapMode == other.mipmapMode && addressMode == other.addressMode &&
+               maxAnisotropy == other.maxAnisotropy && maxLod == other.maxLod;
+    }
+};
+
+struct SamplerStateHash {
+    size_t operator()(const SamplerState& state) const {
+        size_t h = std::hash<uint32_t>()(static_cast<uint32_t>(state.filter) |
+                                         static_cast<uint32_t>(state.mipmapMode) << 8 |
+                                         static_cast<uint32_t>(state.addressMode) << 16);
+        h ^= std::hash<float>()(state.maxAnisotropy) + 0x9E3779B9u + (h << 6) + (h >> 2);
+        h ^= std::hash<float>()(state.maxLod) + 0x9E3779B9u + (h << 6) + (h >> 2);
+        return h;
     }
 };
 
+/**
+ * @brief Material features compiled into a pipeline variant
+ *
+ * Bit N is the car fragment shaders' specialization constant N, so a variant
+ * only contains the texture reads and blending its materials need.
+ */
+enum MaterialFeature : uint32_t {
+    MATERIAL_FEATURE_NORMAL_MAP         = 1u << 0,
+    MATERIAL_FEATURE_METALLIC_ROUGHNESS = 1u << 1,
+    MATERIAL_FEATURE_EMISSIVE           = 1u << 2,
+    MATERIAL_FEATURE_TRANSPARENT        = 1u << 3,
+
+    // Features that come from the material's texture maps
+    MATERIAL_FEATURE_TEXTURES = MATERIAL_FEATURE_NORMAL_MAP | MATERIAL_FEATURE_METALLIC_ROUGHNESS |
+                                MATERIAL_FEATURE_EMISSIVE,
+};
+
+constexpr uint32_t MATERIAL_FEATURE_COUNT = 4;
+
 /**
  * @brief Material properties (data-only, no GPU resources)
  *
@@ -45,6 +136,13 @@ struct MaterialProperties {
     bool  hasMetallicRoughness = false;  // Material uses PBR metallic-roughness
     bool  hasEmissive          = false;  // Material has emissive component
 
+    /** @brief MaterialFeature bits of these properties */
+    uint32_t getFeatureMask() const {
+        return (hasNormalMap ? MATERIAL_FEATURE_NORMAL_MAP : 0u) |
+               (hasMetallicRoughness ? MATERIAL_FEATURE_METALLIC_ROUGHNESS : 0u) |
+               (hasEmissive ? MATERIAL_FEATURE_EMISSIVE : 0u) | (isTransparent ? MATERIAL_FEATURE_TRANSPARENT : 0u);
+    }
+
     // TODO: Add more PBR properties as needed
     // float metallicFactor = 0.0f;
     // float roughnessFactor = 1.0f;
@@ -61,14 +159,31 @@ struct MaterialProperties {
 /**
  * @brief Embedded texture data (for GLB files)
  *
- * Stores raw pixel data for textures embedded in binary glTF files.
+ * Stores raw pixel data for textures embedded in binary glTF files. Textures
+ * decoded from a KTX2 file instead hold block-compressed data: `format` names
+ * the Vulkan format and `levels` locates each prebuilt mip level in `pixels`.
+ *
+ * The pixels are immutable and shared, so copies (materials referencing the
+ * same glTF image, Model::materials, streaming) do not duplicate them; code
+ * that changes them builds a new buffer and calls setPixels().
  */
 struct EmbeddedTexture {
-    std::vector<unsigned char> pixels;  // Raw RGBA pixel data
-    int                        width  = 0;
-    int                        height = 0;
+    std::shared_ptr<const std::vector<unsigned char>> pixels;  // RGBA8 data, or compressed levels when format is set
+    int                                               width  = 0;
+    int                                               height = 0;
+    VkFormat                                          format = VK_FORMAT_UNDEFINED;  // UNDEFINED = RGBA8
+    std::vector<ImageLevel>                           levels;
 
-    bool isValid() const { return !pixels.empty() && width > 0 && height > 0; }
+    const unsigned char* data() const { return pixels ? pixels->data() : nullptr; }
+    size_t               byteSize() const { return pixels ? pixels->size() : 0; }
+
+    void setPixels(std::vector<unsigned char> bytes) {
+        pixels = std::make_shared<const std::vector<unsigned char>>(std::move(bytes));
+    }
+
+    bool isCompressed() const { return format != VK_FORMAT_UNDEFINED; }
+
+    bool isValid() const { return byteSize() > 0 && width > 0 && height > 0; }
 };
 
 struct Material {
@@ -91,15 +206,30 @@ struct Material {
     // Mesh association (which mesh/primitive this material belongs to)
     int32_t meshIndex      = -1;  // glTF mesh index (-1 if not associated)
     int32_t primitiveIndex = -1;  // Primitive within the mesh
+    int32_t sourceIndex    = -1;  // glTF material; primitives sharing it look the same
 
     // Index range for rendering (which part of mesh uses this material)
-    uint32_t indexStart = 0;
-    uint32_t indexCount = 0;
+    uint32_t indexStart   = 0;
+    uint32_t indexCount   = 0;
+    int32_t  vertexOffset = 0;  // Base vertex the range's indices are relative to
 
     // Helper to check if we have a base color texture (path or embedded)
     bool hasBaseColorTexture() const { return !baseColorTexture.empty() || embeddedBaseColor.isValid(); }
 };
 
+/**
+ * @brief Pixels of a material's file-backed textures, decoded ahead of upload
+ *
+ * Produced by MaterialManager::decodeTextures() on any thread. Maps that are
+ * embedded in the material (or absent) stay empty.
+ */
+struct DecodedTextures {
+    EmbeddedTexture baseColor;
+    EmbeddedTexture normalMap;
+    EmbeddedTexture metallicRoughness;
+    EmbeddedTexture emissive;
+};
+
 struct MaterialDispatcher {
     std::string                                                 name;
     std::function<bool(const Material&)>                        dispatchFunction;
@@ -126,6 +256,29 @@ struct MaterialDispatcher {
     }
 };
 
+/**
+ * @brief Per-material record in the bindless material buffer (std430)
+ *
+ * Texture fields index into the bindless texture array. Slot 0 is always the
+ * default white texture, so unused maps can be sampled unconditionally.
+ */
+struct GPUMaterialData {
+    uint32_t baseColorIndex         = 0;
+    uint32_t normalMapIndex         = 0;
+    uint32_t metallicRoughnessIndex = 0;
+    uint32_t emissiveIndex          = 0;
+    float    alphaValue             = 1.0f;
+    uint32_t flags                  = 0;  // GPUMaterialFlags
+};
+static_assert(sizeof(GPUMaterialData) == 24, "GPUMaterialData must match the std430 MaterialData in car_bindless.frag");
+
+enum GPUMaterialFlags : uint32_t {
+    GPU_MATERIAL_TRANSPARENT        = 1u << 0,
+    GPU_MATERIAL_NORMAL_MAP         = 1u << 1,
+    GPU_MATERIAL_METALLIC_ROUGHNESS = 1u << 2,
+    GPU_MATERIAL_EMISSIVE           = 1u << 3,
+};
+
 /**
  * @brief Vulkan-specific material resources
  *
@@ -137,7 +290,13 @@ struct VulkanMaterialResources {
     TextureHandle                   normalMap;
     TextureHandle                   metallicRoughness;
     TextureHandle                   emissive;
-    std::vector<VkDescriptorSet>    descriptorSets;  // Per-frame descriptor sets
+    std::vector<VkDescriptorSet>    descriptorSets;  // Per-frame descriptor sets (non-bindless path only)
+    uint32_t                        staleFrames = 0;  // Bit N: descriptorSets[N] binds a replaced baseColor
+
+    TextureHandle& getMap(uint32_t map) {
+        TextureHandle* maps[TEXTURE_MAP_COUNT] = {&baseColor, &normalMap, &metallicRoughness, &emissive};
+        return *maps[map];
+    }
 
     bool hasAnyTextures() const {
         return baseColor.isValid() || normalMap.isValid() || metallicRoughness.isValid() || emissive.isValid();
@@ -151,7 +310,7 @@ struct VulkanMaterialResources {
  * Separates material data (Material struct) from GPU implementation (Vulkan resources).
  *
  * Usage:
- *   MaterialManager matMgr(device, physicalDevice, commandPool, queue);
+ *   MaterialManager matMgr(device, physicalDevice);
  *   uint32_t matId = matMgr.createMaterial(materialData);
  *   matMgr.bindMaterial(matId, commandBuffer, pipelineLayout);
  */
@@ -160,7 +319,7 @@ public:
     /**
      * @brief Construct material manager with Vulkan context
      */
-    MaterialManager(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue);
+    MaterialManager(VkDevice device, VkPhysicalDevice physicalDevice);
 
     ~MaterialManager();
 
@@ -175,6 +334,27 @@ public:
      */
     uint32_t createMaterial(const Material& material);
 
+    /**
+     * @brief Create a material from textures decoded beforehand
+     *
+     * Thread-safe: texture images are created and queued for upload in
+     * parallel; only ID assignment and descriptor writes are serialized.
+     * Textures come from the texture cache, keyed by normalized file path or
+     * by a hash of embedded pixels, so maps shared between materials and
+     * models are uploaded once.
+     */
+    uint32_t createMaterial(const Material& material, const DecodedTextures& decoded);
+
+    /**
+     * @brief Decode the material's file-backed textures
+     *
+     * Prefers a GPU-compressed KTX2 sibling of each file (`name.astc.ktx2`, then
+     * `name.bc7.ktx2`) when the device can sample it, and falls back to
+     * stb_image otherwise. CPU only and thread-safe, so loading jobs can decode
+     * every texture in parallel. Files already in the texture cache are skipped.
+     */
+    DecodedTextures decodeTextures(const Material& material) const;
+
     /**
      * @brief Get descriptor set for a material
      *
@@ -232,16 +412,111 @@ public:
      */
     VkDescriptorSet getDescriptorSet(uint32_t materialId, uint32_t frameIndex) const;
 
+    /**
+     * @brief Switch to bindless materials (requires VK_EXT_descriptor_indexing)
+     *
+     * Creates a single descriptor set holding every material texture in one
+     * runtime-sized array plus a storage buffer of GPUMaterialData indexed by
+     * material ID. The set is bound once per frame; shaders select textures
+     * through the material index instead of per-material descriptor sets.
+     * Materials created before or after this call are both registered.
+     */
+    void initBindless();
+
+    bool isBindless() const { return bindlessSet != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Layout of the bindless set (binding 0: material buffer, binding 1: texture array)
+     */
+    VkDescriptorSetLayout getBindlessLayout() const { return bindlessLayout; }
+
+    /**
+     * @brief Descriptor set shared by all materials in bindless mode
+     */
+    VkDescriptorSet getBindlessSet() const { return bindlessSet; }
+
+    /**
+     * @brief Set the pipeline state shared by every material variant
+     *
+     * @p base supplies the shaders, layout and cull mode; each variant sets its
+     * own blending, depth write, vertex format and feature constants.
+     */
+    void initPipelineVariants(const PipelineConfig& base, VkRenderPass renderPass, VkPipelineCache cache);
+
+    /**
+     * @brief Create the variant of every registered material up front, so none compile mid-frame
+     *
+     * Missing variants are compiled as one PipelineFactory::createPipelines batch.
+     */
+    void createPipelineVariants(VertexFormat format);
+
+    /**
+     * @brief Pipeline with @p featureMask (MaterialFeature bits) compiled in
+     *
+     * Created and cached on first use; thread-safe. Features the active
+     * material path cannot sample are dropped first, so without bindless
+     * materials variants only differ by transparency.
+     */
+    VkPipeline getPipelineVariant(uint32_t featureMask, VertexFormat format);
+
+    size_t getPipelineVariantCount() const {
+        std::lock_guard<std::mutex> lock(variantMutex);
+        return pipelineVariants.size();
+    }
+
+    /**
+     * @brief Stream textures in the background instead of uploading them with their material
+     *
+     * Call before creating materials. Each material map then binds a 1x1
+     * placeholder (white, flat normal, matte, black emission) at once, and
+     * its texture is decoded into a mip chain on a JobSystem worker instead
+     * of in decodeTextures(). updateStreaming() uploads levels nearest first
+     * within a per-frame byte budget, swaps descriptors once an upload lands,
+     * and drops levels of distant textures when the VRAM budget runs out.
+     *
+     * Decoded chains stay in CPU memory so evicted levels can come back.
+     * Streamed textures live until cleanup().
+     */
+    void enableTextureStreaming(const TextureStreamingConfig& config, uint32_t framesInFlight);
+
+    bool isStreamingTextures() const { return streaming; }
+
+    /**
+     * @brief Report that @p materialId draws @p distance world units from the camera this frame
+     *
+     * The nearest report per frame wins; materials with none count as not
+     * drawn. Main thread only.
+     */
+    void noteMaterialDistance(uint32_t materialId, float distance);
+
+    /**
+     * @brief Apply finished uploads, then queue and evict texture levels
+     *
+     * Call once per frame on the main thread, after @p frameIndex's fence
+     * wait and before recording it. Replaced images are destroyed once no
+     * frame in flight can still sample them.
+     */
+    void updateStreaming(uint32_t frameIndex);
+
+    TextureStreamingStats getStreamingStats() const;
+
+    /**
+     * @brief Distinct texture images and samplers currently alive (excluding the default texture)
+     */
+    size_t getTextureCount() const;
+    size_t getSamplerCount() const;
+
     /**
      * @brief Clean up all GPU resources
      */
     void cleanup();
 
+    static constexpr uint32_t MAX_BINDLESS_TEXTURES  = 1024;
+    static constexpr uint32_t MAX_BINDLESS_MATERIALS = 1024;
+
 private:
     VkDevice              device;
     VkPhysicalDevice      physicalDevice;
-    VkCommandPool         commandPool;
-    VkQueue               graphicsQueue;
     VkDescriptorSetLayout descriptorSetLayout;
     VkDescriptorPool      descriptorPool;
     uint32_t              maxFramesInFlight;
@@ -249,27 +524,134 @@ private:
     std::unordered_map<uint32_t, VulkanMaterialResources> resources;
     std::unordered_map<uint32_t, MaterialProperties>      properties;
     uint32_t                                              nextMaterialId;
+    std::mutex                                            registryMutex;  // IDs, maps and descriptor writes
+
+    // Bindless resources (only created by initBindless)
+    VkDescriptorSetLayout bindlessLayout       = VK_NULL_HANDLE;
+    VkDescriptorPool      bindlessPool         = VK_NULL_HANDLE;
+    VkDescriptorSet       bindlessSet          = VK_NULL_HANDLE;
+    VkBuffer              materialBuffer       = VK_NULL_HANDLE;
+    Allocation            materialBufferMemory;
+    GPUMaterialData*      materialBufferMapped = nullptr;
+    uint32_t              bindlessTextureCount = 0;
+    uint32_t              bindlessTextureLimit = 0;
+
+    // Pipeline variants keyed by feature mask and vertex format (see initPipelineVariants)
+    PipelineConfig                           variantConfig;
+    VkRenderPass                             variantRenderPass = VK_NULL_HANDLE;
+    VkPipelineCache                          variantCache      = VK_NULL_HANDLE;
+    std::unordered_map<uint32_t, VkPipeline> pipelineVariants;
+    mutable std::mutex                       variantMutex;
+
+    static constexpr uint32_t NOT_STREAMED = UINT32_MAX;
+
+    // Texture cache: every distinct file or embedded image is created once and reference counted
+    struct CachedTexture {
+        TextureHandle texture;
+        uint32_t      refCount = 0;
+        uint32_t      streamed = NOT_STREAMED;  // Index into streamedTextures in streaming mode
+        bool          ready    = false;         // False while the first requester is still creating it
+    };
+    std::unordered_map<std::string, CachedTexture> textureCache;     // Keyed by textureKey()
+    std::unordered_map<VkImage, std::string>       textureCacheKeys;  // Image -> key, for releaseTexture()
+    mutable std::mutex                             textureCacheMutex;
+    std::condition_variable                        textureCacheReady;
+
+    // Sampler cache: textures share one VkSampler per SamplerState
+    std::unordered_map<SamplerState, VkSampler, SamplerStateHash> samplerCache;
+    mutable std::mutex                                            samplerCacheMutex;
+
+    // Bindless array slot of each registered image, so shared textures take one slot
+    std::unordered_map<VkImage, uint32_t> bindlessTextureSlots;
+    std::vector<uint32_t>                 freeBindlessSlots;  // Released by streaming, reusable
+
+    // Texture streaming (enableTextureStreaming). `users` and everything below `decoded`
+    // are guarded by registryMutex; the vector itself by textureCacheMutex
+    struct StreamedTexture {
+        std::string       path;    // Decoded by the job when no pixels were given
+        EmbeddedTexture   source;  // Every level, largest first; kept to re-upload after eviction
+        VkFormat          format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t          maxDrop = 0;  // Most top levels that may be left out (minResidentSize)
+        JobHandle         decode;
+        std::atomic<bool> decoded{false};
+
+        std::vector<std::pair<uint32_t, uint32_t>> users;  // (material ID, TextureMap)
+
+        TextureHandle resident;  // Invalid: users bind their placeholder
+        uint32_t      residentDrop = 0;
+        uint32_t      bindlessSlot = 0;
+        TextureHandle uploading;
+        uint32_t      uploadingDrop = 0;
+        UploadFuture  upload;
+        TextureHandle previous;  // Replaced image, retired once every binding moved off it
+        uint32_t      previousSlot = 0;
+        uint64_t      applyFrame   = 0;  // Bindless: frame the material records switch to bindlessSlot
+        float         distance     = 0.0f;
+        uint32_t      targetDrop   = 0;  // Chosen by updateStreaming(); NOT_STREAMED = placeholder only
+    };
+
+    struct RetiredTexture {
+        TextureHandle texture;
+        uint32_t      bindlessSlot;  // 0 = none
+        uint64_t      frame;         // Destroyed once updateStreaming() reaches it
+    };
+
+    bool                                          streaming = false;
+    TextureStreamingConfig                        streamingConfig;
+    uint32_t                                      streamingFramesInFlight = 2;
+    uint64_t                                      streamFrame             = 0;
+    uint64_t                                      streamingStartNs        = 0;
+    bool                                          streamingSettled        = false;  // Everything wanted is resident
+    std::vector<std::unique_ptr<StreamedTexture>> streamedTextures;
+    std::vector<RetiredTexture>                   retiredTextures;
+    std::vector<float>                            materialDistances;  // Per material ID, this frame
+    std::vector<uint32_t>                         streamOrder;        // Scratch for updateStreaming()
+    std::array<TextureHandle, TEXTURE_MAP_COUNT>  placeholderTextures;  // [0] is defaultWhiteTexture
 
     // Default textures for materials without specific textures
     TextureHandle defaultWhiteTexture;
 
+    // Device capabilities queried once at construction
+    bool  supportsBC7          = false;
+    bool  supportsASTC         = false;
+    bool  supportsLinearBlit   = false;  // Mip generation for RGBA8 sRGB textures
+    float maxSamplerAnisotropy = 0.0f;   // 0 = anisotropic filtering unsupported
+
+    // Variant key and pipeline state for a feature mask; drops features the material path cannot sample
+    uint32_t       pipelineVariantKey(uint32_t& featureMask, VertexFormat format) const;
+    PipelineConfig pipelineVariantConfig(uint32_t featureMask, VertexFormat format) const;
+
     // Helper methods for texture loading
-    TextureHandle loadTexture(const std::string& path);
+    TextureHandle acquireTexture(const EmbeddedTexture& embedded, const std::string& path,
+                                 const EmbeddedTexture& decoded, uint32_t& outStreamed);
+    uint32_t      streamTexture(const EmbeddedTexture& embedded, const std::string& path,
+                                const EmbeddedTexture& decoded);
+    TextureHandle createSolidTexture(const unsigned char rgba[4]);
+    void          startStreamedUpload(StreamedTexture& texture, uint32_t drop);
+    void          swapStreamedTexture(StreamedTexture& texture, TextureHandle replacement, uint32_t drop);
+    void          applyStreamedBindings(StreamedTexture& texture);
+    void          retireTexture(const TextureHandle& texture, uint32_t bindlessSlot, uint64_t frame);
+    void          releaseTexture(const TextureHandle& texture);
+    VkSampler     getSampler(const SamplerState& state);
     TextureHandle loadTextureFromData(const EmbeddedTexture& embeddedTex);
     TextureHandle createDefaultWhiteTexture();
     void          createTextureImage(const unsigned char* pixels, const int width, const int height, const int channels,
                                      TextureHandle& outTexture);
+    void          createCompressedTextureImage(const EmbeddedTexture& texture, TextureHandle& outTexture);
     void          createTextureImageView(TextureHandle& texture);
     void          createTextureSampler(TextureHandle& texture);
     void          destroyTextureHandle(TextureHandle& texture);
-    void createImage(const uint32_t width, const uint32_t height, const VkFormat format, const VkImageTiling tiling,
-                     const VkImageUsageFlags usage, const VkMemoryPropertyFlags properties, VkImage& image,
-                     VkDeviceMemory& imageMemory);
-
-    void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-
-    void     copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    uint32_t      registerBindlessTexture(const TextureHandle& texture);
+    bool          allocateBindlessSlot(uint32_t& outIndex);
+    void          writeBindlessTexture(uint32_t index, const TextureHandle& texture);
+    void          writeBindlessMaterial(uint32_t id, const VulkanMaterialResources& gpuResources,
+                                        const MaterialProperties& props);
+    EmbeddedTexture decodeTexture(const std::string& path) const;
+    EmbeddedTexture decodeKTX2(const std::string& path) const;
+    bool            canSample(VkFormat format) const;
+    void createImage(const uint32_t width, const uint32_t height, const uint32_t mipLevels, const VkFormat format,
+                     const VkImageTiling tiling, const VkImageUsageFlags usage, const VkMemoryPropertyFlags properties,
+                     VkImage& image, Allocation& imageMemory);
 };
 
 }  // namespace DownPour
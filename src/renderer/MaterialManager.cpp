@@ -1,23 +1,172 @@
 #include "Material.h"
 
+#include "core/Hash.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+#include "core/ResourceManager.h"
+#include "core/SwapChainManager.h"
+#include "core/UploadManager.h"
+#include "logger/Logger.h"
+
 #include <stb_image.h>
 #include <vulkan/vulkan.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <stdexcept>
+#include <utility>
 namespace DownPour {
 
-MaterialManager::MaterialManager(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                                 VkQueue graphicsQueue)
+namespace {
+
+constexpr unsigned char KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+constexpr size_t        KTX2_HEADER_SIZE    = 80;  // Identifier, header and the dfd/kvd/sgd index
+constexpr size_t        KTX2_LEVEL_SIZE     = 24;  // byteOffset, byteLength, uncompressedByteLength
+constexpr VkDeviceSize  LEVEL_ALIGNMENT     = 16;  // One block; keeps every copy offset valid
+
+uint32_t readU32(const unsigned char* data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t readU64(const unsigned char* data) {
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Block footprint of the compressed formats KTX2 textures may use
+ * @return false for anything else
+ */
+bool blockExtent(VkFormat format, uint32_t& outWidth, uint32_t& outHeight) {
+    switch (format) {
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            outWidth = outHeight = 4;
+            return true;
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            outWidth = outHeight = 6;
+            return true;
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            outWidth = outHeight = 8;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief `dir/name.png` -> `dir/name<suffix>`
+ */
+std::string replaceExtension(const std::string& path, const char* suffix) {
+    const size_t slash = path.find_last_of("/\\");
+    const size_t dot   = path.find_last_of('.');
+    const size_t stem  = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? dot : path.size();
+    return path.substr(0, stem) + suffix;
+}
+
+bool endsWith(const std::string& value, const char* suffix) {
+    const size_t length = strlen(suffix);
+    return value.size() >= length && value.compare(value.size() - length, length, suffix) == 0;
+}
+
+bool fileExists(const std::string& path) {
+    return std::ifstream(path, std::ios::binary).good();
+}
+
+/**
+ * @brief Append a 2x2 box-filtered mip chain to an RGBA8 texture holding level 0
+ *
+ * Streamed textures upload a range of prebuilt levels, so their chains are
+ * built here on the decoding worker instead of by blits on upload. Averages
+ * the stored (sRGB) values, which is close enough for levels seen from afar.
+ */
+void buildMipChain(EmbeddedTexture& texture) {
+    uint32_t                   width  = static_cast<uint32_t>(texture.width);
+    uint32_t                   height = static_cast<uint32_t>(texture.height);
+    std::vector<unsigned char> chain(texture.data(), texture.data() + texture.byteSize());
+    texture.levels = {ImageLevel{0, width, height}};
+
+    while (width > 1 || height > 1) {
+        const uint32_t     nextWidth  = std::max(1u, width / 2);
+        const uint32_t     nextHeight = std::max(1u, height / 2);
+        const VkDeviceSize source     = texture.levels.back().offset;
+        const VkDeviceSize offset     = (source + VkDeviceSize(width) * height * 4 + LEVEL_ALIGNMENT - 1) /
+                                    LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+        chain.resize(static_cast<size_t>(offset + VkDeviceSize(nextWidth) * nextHeight * 4));
+
+        const unsigned char* in  = &chain[static_cast<size_t>(source)];
+        unsigned char*       out = &chain[static_cast<size_t>(offset)];
+        for (uint32_t y = 0; y < nextHeight; y++) {
+            const uint32_t y0 = std::min(2 * y, height - 1) * width;
+            const uint32_t y1 = std::min(2 * y + 1, height - 1) * width;
+            for (uint32_t x = 0; x < nextWidth; x++) {
+                const uint32_t x0 = std::min(2 * x, width - 1);
+                const uint32_t x1 = std::min(2 * x + 1, width - 1);
+                for (uint32_t c = 0; c < 4; c++) {
+                    const uint32_t sum = in[(y0 + x0) * 4 + c] + in[(y0 + x1) * 4 + c] + in[(y1 + x0) * 4 + c] +
+                                         in[(y1 + x1) * 4 + c];
+                    out[(y * nextWidth + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        texture.levels.push_back(ImageLevel{offset, nextWidth, nextHeight});
+        width  = nextWidth;
+        height = nextHeight;
+    }
+    texture.setPixels(std::move(chain));
+}
+
+/**
+ * @brief Texture cache key: a hash of embedded pixels, otherwise the normalized file path
+ */
+std::string textureKey(const EmbeddedTexture& embedded, const std::string& path) {
+    if (embedded.isValid()) {
+        const uint64_t hash = hashBytes(embedded.data(), embedded.byteSize(), embedded.format);
+        return "data:" + std::to_string(hash) + ":" + std::to_string(embedded.width) + "x" +
+               std::to_string(embedded.height);
+    }
+    return "file:" + std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+}  // namespace
+
+MaterialManager::MaterialManager(VkDevice device, VkPhysicalDevice physicalDevice)
     : device(device),
       physicalDevice(physicalDevice),
-      commandPool(commandPool),
-      graphicsQueue(graphicsQueue),
       descriptorSetLayout(VK_NULL_HANDLE),
       descriptorPool(VK_NULL_HANDLE),
-      maxFramesInFlight(0) {
+      maxFramesInFlight(0),
+      nextMaterialId(0) {
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+    VkPhysicalDeviceProperties deviceProperties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+    // VulkanContext enables exactly the features the device reports
+    supportsBC7          = features.textureCompressionBC == VK_TRUE && canSample(VK_FORMAT_BC7_SRGB_BLOCK);
+    supportsASTC         = features.textureCompressionASTC_LDR == VK_TRUE && canSample(VK_FORMAT_ASTC_4x4_SRGB_BLOCK);
+    maxSamplerAnisotropy = features.samplerAnisotropy == VK_TRUE ? deviceProperties.limits.maxSamplerAnisotropy : 0.0f;
+
+    VkFormatProperties rgba;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, VK_FORMAT_R8G8B8A8_SRGB, &rgba);
+    supportsLinearBlit = (rgba.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+
     // Create default white texture for materials without baseColor textures
     defaultWhiteTexture = createDefaultWhiteTexture();
 }
@@ -27,43 +176,64 @@ MaterialManager::~MaterialManager() {
 }
 
 uint32_t MaterialManager::createMaterial(const Material& material) {
-    uint32_t id = nextMaterialId++;
+    return createMaterial(material, decodeTextures(material));
+}
 
-    VulkanMaterialResources gpuResources;
+uint32_t MaterialManager::createMaterial(const Material& material, const DecodedTextures& decoded) {
+    DP_PROFILE_SCOPE("MaterialManager::createMaterial");
 
-    // Load base color texture (prefer embedded, fallback to file path, then default white)
-    if (material.embeddedBaseColor.isValid()) {
-        gpuResources.baseColor = loadTextureFromData(material.embeddedBaseColor);
-    } else if (!material.baseColorTexture.empty()) {
-        gpuResources.baseColor = loadTexture(material.baseColorTexture);
-    } else {
-        // Use default white texture for materials with only baseColorFactor
-        gpuResources.baseColor = defaultWhiteTexture;
-    }
+    VulkanMaterialResources gpuResources;
 
-    // Load normal map
-    if (material.embeddedNormalMap.isValid()) {
-        gpuResources.normalMap = loadTextureFromData(material.embeddedNormalMap);
-    } else if (!material.normalMapTexture.empty()) {
-        gpuResources.normalMap = loadTexture(material.normalMapTexture);
+    // Prefer embedded pixels, then the file; unloaded maps stay invalid
+    std::array<uint32_t, TEXTURE_MAP_COUNT> streamed;
+    gpuResources.baseColor = acquireTexture(material.embeddedBaseColor, material.baseColorTexture, decoded.baseColor,
+                                            streamed[TEXTURE_MAP_BASE_COLOR]);
+    gpuResources.normalMap = acquireTexture(material.embeddedNormalMap, material.normalMapTexture, decoded.normalMap,
+                                            streamed[TEXTURE_MAP_NORMAL]);
+    gpuResources.metallicRoughness = acquireTexture(material.embeddedMetallicRoughness,
+                                                    material.metallicRoughnessTexture, decoded.metallicRoughness,
+                                                    streamed[TEXTURE_MAP_METALLIC_ROUGHNESS]);
+    gpuResources.emissive = acquireTexture(material.embeddedEmissive, material.emissiveTexture, decoded.emissive,
+                                           streamed[TEXTURE_MAP_EMISSIVE]);
+
+    // Streamed maps bind a placeholder until updateStreaming() swaps their texture in
+    for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++) {
+        if (streamed[map] != NOT_STREAMED)
+            gpuResources.getMap(map) = placeholderTextures[map];
     }
 
-    // Load metallic roughness
-    if (material.embeddedMetallicRoughness.isValid()) {
-        gpuResources.metallicRoughness = loadTextureFromData(material.embeddedMetallicRoughness);
-    } else if (!material.metallicRoughnessTexture.empty()) {
-        gpuResources.metallicRoughness = loadTexture(material.metallicRoughnessTexture);
+    // Use default white texture for materials with only baseColorFactor (or a base color that failed to load)
+    if (!gpuResources.baseColor.isValid()) {
+        gpuResources.baseColor = defaultWhiteTexture;
     }
 
-    // Load emissive
-    if (material.embeddedEmissive.isValid()) {
-        gpuResources.emissive = loadTextureFromData(material.embeddedEmissive);
-    } else if (!material.emissiveTexture.empty()) {
-        gpuResources.emissive = loadTexture(material.emissiveTexture);
+    // Texture images above are created in parallel; registration below is shared state
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint32_t                    id = nextMaterialId++;
+
+    if (streaming) {
+        std::lock_guard<std::mutex> cacheLock(textureCacheMutex);
+        for (uint32_t map = 0; map < TEXTURE_MAP_COUNT; map++) {
+            if (streamed[map] == NOT_STREAMED)
+                continue;
+            StreamedTexture& texture = *streamedTextures[streamed[map]];
+            texture.users.emplace_back(id, map);
+
+            // Already swapped in by an earlier material: per-set binds it directly, bindless records pick up
+            // its slot on the next updateStreaming() (a pending change covers every user anyway)
+            if (texture.resident.isValid()) {
+                if (!isBindless())
+                    gpuResources.getMap(map) = texture.resident;
+                else if (texture.applyFrame == 0)
+                    texture.applyFrame = streamFrame;
+            }
+        }
     }
 
-    // Create descriptor sets if descriptor support is initialized
-    if (descriptorSetLayout != VK_NULL_HANDLE && descriptorPool != VK_NULL_HANDLE && maxFramesInFlight > 0) {
+    if (isBindless()) {
+        // One shared set for every material; only the material buffer entry is per-material
+        writeBindlessMaterial(id, gpuResources, material.props);
+    } else if (descriptorSetLayout != VK_NULL_HANDLE && descriptorPool != VK_NULL_HANDLE && maxFramesInFlight > 0) {
         std::vector<VkDescriptorSet> matDescriptorSets(maxFramesInFlight);
 
         // Allocate descriptor sets for all frames
@@ -114,6 +284,9 @@ void MaterialManager::initDescriptorSupport(VkDescriptorSetLayout layout, VkDesc
 }
 
 void MaterialManager::createDescriptorSetsForExistingMaterials() {
+    if (isBindless())
+        return;  // Existing materials were registered by initBindless()
+
     if (descriptorSetLayout == VK_NULL_HANDLE || descriptorPool == VK_NULL_HANDLE || maxFramesInFlight == 0) {
         std::cerr << "MaterialManager: Descriptor support not initialized" << std::endl;
         return;
@@ -182,6 +355,9 @@ VkDescriptorSet MaterialManager::getDescriptorSet(uint32_t materialId, uint32_t
         throw std::runtime_error("Material ID " + std::to_string(materialId) + " not found");
     }
 
+    if (isBindless())
+        return bindlessSet;
+
     // Return the descriptor set for the requested frame
     if (frameIndex >= it->second.descriptorSets.size()) {
         return VK_NULL_HANDLE;  // No descriptor set for this frame
@@ -194,6 +370,11 @@ void MaterialManager::bindMaterial(uint32_t materialId, VkCommandBuffer cmd, VkP
     if (it == resources.end())
         throw std::runtime_error("Material ID " + std::to_string(materialId) + " not found");
 
+    if (isBindless()) {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &bindlessSet, 0, nullptr);
+        return;
+    }
+
     const auto& res = it->second;
     if (!res.descriptorSets.empty() && res.descriptorSets[0] != VK_NULL_HANDLE) {
         vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 1, 1, &res.descriptorSets[0], 0, nullptr);
@@ -208,54 +389,854 @@ const MaterialProperties& MaterialManager::getProperties(uint32_t materialId) co
     return it->second;
 }
 
+void MaterialManager::initBindless() {
+    if (isBindless())
+        return;
+
+    // The set is created update-after-bind, so the array is bounded by the update-after-bind limits
+    VkPhysicalDeviceDescriptorIndexingProperties indexingProperties{};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 deviceProperties{};
+    deviceProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    deviceProperties.pNext = &indexingProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &deviceProperties);
+
+    bindlessTextureLimit = std::min({MAX_BINDLESS_TEXTURES,
+                                     indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                     indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                     indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
+
+    // Binding 0: material records, binding 1: every texture in one array
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding         = 0;
+    bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    bindings[1].binding         = 1;
+    bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = bindlessTextureLimit;
+    bindings[1].stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Textures are appended while earlier frames may still be in flight, so the array
+    // must be partially bound and updatable after binding
+    std::array<VkDescriptorBindingFlags, 2> bindingFlags = {
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+            VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT};
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount  = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext        = &bindingFlagsInfo;
+    layoutInfo.flags        = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &bindlessLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create bindless descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = bindlessTextureLimit;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets       = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &bindlessPool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create bindless descriptor pool");
+
+    VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+    variableCountInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+    variableCountInfo.descriptorSetCount = 1;
+    variableCountInfo.pDescriptorCounts  = &bindlessTextureLimit;
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.pNext              = &variableCountInfo;
+    allocInfo.descriptorPool     = bindlessPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &bindlessLayout;
+
+    VkDescriptorSet set;
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate bindless descriptor set");
+
+    // Material records are rewritten rarely, so a persistently mapped host-visible buffer is enough
+    VkDeviceSize bufferSize = sizeof(GPUMaterialData) * MAX_BINDLESS_MATERIALS;
+    ResourceManager::createBuffer(device, physicalDevice, bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  materialBuffer, materialBufferMemory, MemoryTag::Textures);
+    materialBufferMapped = static_cast<GPUMaterialData*>(materialBufferMemory.mapped);
+    std::fill(materialBufferMapped, materialBufferMapped + MAX_BINDLESS_MATERIALS, GPUMaterialData{});
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = materialBuffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range  = bufferSize;
+
+    VkWriteDescriptorSet bufferWrite{};
+    bufferWrite.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    bufferWrite.dstSet          = set;
+    bufferWrite.dstBinding      = 0;
+    bufferWrite.dstArrayElement = 0;
+    bufferWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bufferWrite.descriptorCount = 1;
+    bufferWrite.pBufferInfo     = &bufferInfo;
+    vkUpdateDescriptorSets(device, 1, &bufferWrite, 0, nullptr);
+
+    bindlessSet = set;
+
+    // Slot 0 is the default white texture so unset indices still sample something valid
+    registerBindlessTexture(defaultWhiteTexture);
+
+    for (auto& [id, gpuResources] : resources)
+        writeBindlessMaterial(id, gpuResources, properties[id]);
+
+    DP_LOG(Info, "MaterialManager: bindless materials enabled (%u texture slots)", bindlessTextureLimit);
+}
+
+uint32_t MaterialManager::registerBindlessTexture(const TextureHandle& texture) {
+    if (!texture.isValid())
+        return 0;
+
+    // Textures shared between materials keep the slot they were first given
+    auto slot = bindlessTextureSlots.find(texture.image);
+    if (slot != bindlessTextureSlots.end())
+        return slot->second;
+
+    uint32_t index;
+    if (!allocateBindlessSlot(index))
+        return 0;
+
+    writeBindlessTexture(index, texture);
+    bindlessTextureSlots[texture.image] = index;
+    return index;
+}
+
+bool MaterialManager::allocateBindlessSlot(uint32_t& outIndex) {
+    if (!freeBindlessSlots.empty()) {
+        outIndex = freeBindlessSlots.back();
+        freeBindlessSlots.pop_back();
+        return true;
+    }
+
+    if (bindlessTextureCount >= bindlessTextureLimit) {
+        DP_LOG(Warning, "MaterialManager: bindless texture array full, falling back to default texture");
+        return false;
+    }
+    outIndex = bindlessTextureCount++;
+    return true;
+}
+
+void MaterialManager::writeBindlessTexture(uint32_t index, const TextureHandle& texture) {
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView   = texture.view;
+    imageInfo.sampler     = texture.sampler;
+
+    VkWriteDescriptorSet descriptorWrite{};
+    descriptorWrite.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet          = bindlessSet;
+    descriptorWrite.dstBinding      = 1;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo      = &imageInfo;
+
+    vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+}
+
+void MaterialManager::writeBindlessMaterial(uint32_t id, const VulkanMaterialResources& gpuResources,
+                                            const MaterialProperties& props) {
+    if (id >= MAX_BINDLESS_MATERIALS) {
+        DP_LOG(Warning, "MaterialManager: material %u exceeds bindless material capacity", id);
+        return;
+    }
+
+    GPUMaterialData data;
+    data.baseColorIndex         = registerBindlessTexture(gpuResources.baseColor);
+    data.normalMapIndex         = registerBindlessTexture(gpuResources.normalMap);
+    data.metallicRoughnessIndex = registerBindlessTexture(gpuResources.metallicRoughness);
+    data.emissiveIndex          = registerBindlessTexture(gpuResources.emissive);
+    data.alphaValue             = props.alphaValue;
+
+    if (props.isTransparent)
+        data.flags |= GPU_MATERIAL_TRANSPARENT;
+    if (gpuResources.normalMap.isValid())
+        data.flags |= GPU_MATERIAL_NORMAL_MAP;
+    if (gpuResources.metallicRoughness.isValid())
+        data.flags |= GPU_MATERIAL_METALLIC_ROUGHNESS;
+    if (gpuResources.emissive.isValid())
+        data.flags |= GPU_MATERIAL_EMISSIVE;
+
+    materialBufferMapped[id] = data;
+}
+
+void MaterialManager::initPipelineVariants(const PipelineConfig& base, VkRenderPass renderPass,
+                                           VkPipelineCache cache) {
+    std::lock_guard<std::mutex> lock(variantMutex);
+    variantConfig     = base;
+    variantRenderPass = renderPass;
+    variantCache      = cache;
+}
+
+void MaterialManager::createPipelineVariants(VertexFormat format) {
+    std::vector<uint32_t> masks;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& [id, props] : properties)
+            masks.push_back(props.getFeatureMask());
+    }
+
+    // One request per missing variant; the batch compiles them in parallel outside the lock
+    std::vector<uint32_t>        keys;
+    std::vector<PipelineRequest> requests;
+    VkPipelineCache              cache;
+    {
+        std::lock_guard<std::mutex> lock(variantMutex);
+        if (variantConfig.layout == VK_NULL_HANDLE)
+            throw std::runtime_error("MaterialManager: pipeline variants requested before initPipelineVariants()");
+        for (uint32_t mask : masks) {
+            const uint32_t key = pipelineVariantKey(mask, format);
+            if (pipelineVariants.count(key) || std::find(keys.begin(), keys.end(), key) != keys.end())
+                continue;
+            keys.push_back(key);
+            requests.push_back({pipelineVariantConfig(mask, format), variantRenderPass, nullptr});
+        }
+        cache = variantCache;
+    }
+
+    std::vector<VkPipeline> pipelines(requests.size(), VK_NULL_HANDLE);
+    for (size_t i = 0; i < requests.size(); i++)
+        requests[i].output = &pipelines[i];
+    PipelineFactory::createPipelines(device, requests, cache);
+
+    std::lock_guard<std::mutex> lock(variantMutex);
+    for (size_t i = 0; i < keys.size(); i++) {
+        // A concurrent getPipelineVariant() may have built the same variant meanwhile
+        if (!pipelineVariants.emplace(keys[i], pipelines[i]).second)
+            vkDestroyPipeline(device, pipelines[i], nullptr);
+    }
+
+    DP_LOG(Info, "MaterialManager: %zu pipeline variant(s) for %zu materials", pipelineVariants.size(), masks.size());
+}
+
+VkPipeline MaterialManager::getPipelineVariant(uint32_t featureMask, VertexFormat format) {
+    const uint32_t key = pipelineVariantKey(featureMask, format);
+
+    std::lock_guard<std::mutex> lock(variantMutex);
+    auto                        it = pipelineVariants.find(key);
+    if (it != pipelineVariants.end())
+        return it->second;
+
+    if (variantConfig.layout == VK_NULL_HANDLE)
+        throw std::runtime_error("MaterialManager: pipeline variants requested before initPipelineVariants()");
+
+    VkPipeline pipeline = PipelineFactory::createPipeline(device, pipelineVariantConfig(featureMask, format),
+                                                          variantRenderPass, variantCache);
+    pipelineVariants[key] = pipeline;
+    return pipeline;
+}
+
+uint32_t MaterialManager::pipelineVariantKey(uint32_t& featureMask, VertexFormat format) const {
+    // The per-set path binds only the base color texture, so other maps would compile identical variants
+    featureMask &= isBindless() ? ~0u : static_cast<uint32_t>(MATERIAL_FEATURE_TRANSPARENT);
+    return featureMask | (format == VertexFormat::Packed ? 1u << MATERIAL_FEATURE_COUNT : 0u);
+}
+
+PipelineConfig MaterialManager::pipelineVariantConfig(uint32_t featureMask, VertexFormat format) const {
+    const bool     transparent = (featureMask & MATERIAL_FEATURE_TRANSPARENT) != 0;
+    PipelineConfig config      = variantConfig;
+    config.oitAccumulation     = transparent;  // Order-independent, so the draw list needs no depth sort
+    config.enableDepthWrite    = !transparent;
+    config.motionTarget        = !transparent;
+    config.subpass             = transparent ? SwapChainManager::SUBPASS_TRANSPARENT : SwapChainManager::SUBPASS_OPAQUE;
+    config.vertexFormat        = format;
+    config.specializationConstants.resize(MATERIAL_FEATURE_COUNT);
+    for (uint32_t bit = 0; bit < MATERIAL_FEATURE_COUNT; bit++)
+        config.specializationConstants[bit] = (featureMask & (1u << bit)) ? VK_TRUE : VK_FALSE;
+    return config;
+}
+
 void MaterialManager::cleanup() {
+    // Streamed images are owned here rather than by the texture cache
+    if (!streamedTextures.empty())
+        UploadManager::get().waitIdle();
+    for (auto& texture : streamedTextures) {
+        texture->decode.wait();
+        destroyTextureHandle(texture->resident);
+        destroyTextureHandle(texture->uploading);
+        destroyTextureHandle(texture->previous);
+    }
+    streamedTextures.clear();
+    for (RetiredTexture& retired : retiredTextures)
+        destroyTextureHandle(retired.texture);
+    retiredTextures.clear();
+    freeBindlessSlots.clear();
+    materialDistances.clear();
+    for (uint32_t map = TEXTURE_MAP_BASE_COLOR + 1; map < TEXTURE_MAP_COUNT; map++)
+        destroyTextureHandle(placeholderTextures[map]);
+    placeholderTextures = {};
+    streaming           = false;
+
+    for (auto& [key, pipeline] : pipelineVariants)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    pipelineVariants.clear();
+
+    // Shared textures are destroyed with their last material
     for (auto& pair : resources) {
         auto& res = pair.second;
-        // Don't destroy baseColor if it's the default texture (shared resource)
-        if (res.baseColor.image != defaultWhiteTexture.image) {
-            destroyTextureHandle(res.baseColor);
-        }
-        destroyTextureHandle(res.normalMap);
-        destroyTextureHandle(res.metallicRoughness);
-        destroyTextureHandle(res.emissive);
+        releaseTexture(res.baseColor);
+        releaseTexture(res.normalMap);
+        releaseTexture(res.metallicRoughness);
+        releaseTexture(res.emissive);
     }
 
     resources.clear();
     properties.clear();
 
+    // Only failed loads are left; they hold no resources
+    textureCache.clear();
+    textureCacheKeys.clear();
+
     // Clean up default texture
     destroyTextureHandle(defaultWhiteTexture);
+
+    for (auto& [state, sampler] : samplerCache)
+        vkDestroySampler(device, sampler, nullptr);
+    samplerCache.clear();
+
+    // Clean up bindless resources
+    ResourceManager::destroyBuffer(device, materialBuffer, materialBufferMemory);
+    materialBufferMapped = nullptr;
+    if (bindlessPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, bindlessPool, nullptr);
+        bindlessPool = VK_NULL_HANDLE;
+    }
+    if (bindlessLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, bindlessLayout, nullptr);
+        bindlessLayout = VK_NULL_HANDLE;
+    }
+    bindlessSet          = VK_NULL_HANDLE;
+    bindlessTextureCount = 0;
+    bindlessTextureSlots.clear();
+}
+
+size_t MaterialManager::getTextureCount() const {
+    std::lock_guard<std::mutex> lock(textureCacheMutex);
+    return textureCacheKeys.size();
+}
+
+size_t MaterialManager::getSamplerCount() const {
+    std::lock_guard<std::mutex> lock(samplerCacheMutex);
+    return samplerCache.size();
 }
 
 // ============================================================================
-// Private Helper Methods
+// Texture Streaming
 // ============================================================================
 
-TextureHandle MaterialManager::loadTexture(const std::string& path) {
+void MaterialManager::enableTextureStreaming(const TextureStreamingConfig& config, uint32_t framesInFlight) {
+    streaming               = true;
+    streamingConfig         = config;
+    streamingFramesInFlight = framesInFlight;
+    streamingStartNs        = Profiler::now();
+
+    // Neutral stand-ins per map. Textures are sampled as sRGB, where 188 decodes to a flat normal's 0.5
+    const unsigned char flatNormal[4] = {188, 188, 255, 255};
+    const unsigned char matte[4]      = {0, 255, 0, 255};  // Roughness 1 (G), metallic 0 (B)
+    const unsigned char black[4]      = {0, 0, 0, 255};
+    placeholderTextures[TEXTURE_MAP_BASE_COLOR]         = defaultWhiteTexture;
+    placeholderTextures[TEXTURE_MAP_NORMAL]             = createSolidTexture(flatNormal);
+    placeholderTextures[TEXTURE_MAP_METALLIC_ROUGHNESS] = createSolidTexture(matte);
+    placeholderTextures[TEXTURE_MAP_EMISSIVE]           = createSolidTexture(black);
+
+    DP_LOG(Info, "MaterialManager: texture streaming enabled (%llu MB budget, %llu MB per frame)",
+           static_cast<unsigned long long>(config.vramBudget >> 20),
+           static_cast<unsigned long long>(config.uploadBytesPerFrame >> 20));
+}
+
+void MaterialManager::noteMaterialDistance(uint32_t materialId, float distance) {
+    if (!streaming)
+        return;
+    if (materialId >= materialDistances.size())
+        materialDistances.resize(materialId + 1, std::numeric_limits<float>::infinity());
+    materialDistances[materialId] = std::min(materialDistances[materialId], distance);
+}
+
+uint32_t MaterialManager::streamTexture(const EmbeddedTexture& embedded, const std::string& path,
+                                        const EmbeddedTexture& decoded) {
+    auto             texture = std::make_unique<StreamedTexture>();
+    StreamedTexture* target  = texture.get();
+    if (embedded.isValid())
+        target->source = embedded;
+    else if (decoded.isValid())
+        target->source = decoded;
+    else
+        target->path = path;
+
+    uint32_t index;
+    {
+        std::lock_guard<std::mutex> lock(textureCacheMutex);
+        index = static_cast<uint32_t>(streamedTextures.size());
+        streamedTextures.push_back(std::move(texture));
+    }
+
+    // Entries are never removed before cleanup(), which waits for this job
+    const uint32_t minResidentSize = streamingConfig.minResidentSize;
+    target->decode                 = JobSystem::get().schedule([this, target, minResidentSize] {
+        DP_PROFILE_SCOPE("MaterialManager::decodeStreamedTexture");
+
+        EmbeddedTexture& source = target->source;
+        if (!source.isValid())
+            source = decodeTexture(target->path);
+        if (source.isValid() && !source.isCompressed())
+            buildMipChain(source);
+
+        target->format = source.isCompressed() ? source.format : VK_FORMAT_R8G8B8A8_SRGB;
+        while (target->maxDrop + 1 < source.levels.size() &&
+               std::min(source.levels[target->maxDrop + 1].width, source.levels[target->maxDrop + 1].height) >=
+                   minResidentSize) {
+            target->maxDrop++;
+        }
+        target->decoded.store(true, std::memory_order_release);
+    });
+    return index;
+}
+
+TextureHandle MaterialManager::createSolidTexture(const unsigned char rgba[4]) {
     TextureHandle texture;
+    createTextureImage(rgba, 1, 1, 4, texture);
+    createTextureImageView(texture);
+    createTextureSampler(texture);
+    return texture;
+}
+
+void MaterialManager::updateStreaming(uint32_t frameIndex) {
+    if (!streaming)
+        return;
+    DP_PROFILE_SCOPE("MaterialManager::updateStreaming");
+
+    streamFrame++;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::lock_guard<std::mutex> cacheLock(textureCacheMutex);
+
+    // Images and bindless slots that no frame in flight can reach any more
+    size_t kept = 0;
+    for (RetiredTexture& retired : retiredTextures) {
+        if (retired.frame > streamFrame) {
+            retiredTextures[kept++] = retired;
+            continue;
+        }
+        destroyTextureHandle(retired.texture);
+        if (retired.bindlessSlot != 0)
+            freeBindlessSlots.push_back(retired.bindlessSlot);
+    }
+    retiredTextures.erase(retiredTextures.begin() + static_cast<ptrdiff_t>(kept), retiredTextures.end());
+
+    auto levelBytes = [](const StreamedTexture& texture, uint32_t drop) -> uint64_t {
+        return texture.source.byteSize() - texture.source.levels[drop].offset;
+    };
+
+    // Land finished uploads and pick up this frame's distances
+    const float infinity      = std::numeric_limits<float>::infinity();
+    uint32_t    pending       = 0;
+    uint64_t    streamedBytes = 0;
+    streamOrder.clear();
+    for (uint32_t i = 0; i < streamedTextures.size(); i++) {
+        StreamedTexture& texture = *streamedTextures[i];
+
+        if (texture.applyFrame != 0 && streamFrame >= texture.applyFrame)
+            applyStreamedBindings(texture);
+        if (texture.uploading.isValid() && texture.upload.isReady())
+            swapStreamedTexture(texture, texture.uploading, texture.uploadingDrop);
+
+        if (!texture.decoded.load(std::memory_order_acquire)) {
+            pending++;
+            continue;
+        }
+        if (texture.source.levels.empty())
+            continue;  // Failed to decode; its users keep the placeholder
+
+        if (texture.resident.isValid())
+            streamedBytes += levelBytes(texture, texture.residentDrop);
+        if (texture.uploading.isValid())
+            streamedBytes += levelBytes(texture, texture.uploadingDrop);
+        texture.distance = infinity;
+        for (const auto& [material, map] : texture.users) {
+            if (material < materialDistances.size())
+                texture.distance = std::min(texture.distance, materialDistances[material]);
+        }
+        streamOrder.push_back(i);
+    }
+    std::fill(materialDistances.begin(), materialDistances.end(), infinity);
+
+    // Nearest first, each texture takes the finest level its distance asks for that still fits the
+    // VRAM budget; what is left over goes coarser, and past the coarsest level back to the placeholder
+    std::sort(streamOrder.begin(), streamOrder.end(), [this](uint32_t a, uint32_t b) {
+        return streamedTextures[a]->distance < streamedTextures[b]->distance;
+    });
+    // What is streamed in now plus whatever the device can still spare, so a full card evicts instead of failing
+    const uint64_t headroom = MemoryAllocator::get().getDeviceHeadroom();
+    uint64_t       budget   = std::min<uint64_t>(
+        streamingConfig.vramBudget, streamedBytes + std::min<uint64_t>(headroom, UINT64_MAX - streamedBytes));
+    for (uint32_t i : streamOrder) {
+        StreamedTexture& texture = *streamedTextures[i];
+
+        // Each doubling of distance past fullResolutionDistance drops one level; undrawn textures want the least
+        uint32_t wanted = texture.maxDrop;
+        if (texture.distance <= streamingConfig.fullResolutionDistance) {
+            wanted = 0;
+        } else if (std::isfinite(texture.distance)) {
+            const float doublings = std::log2(texture.distance / streamingConfig.fullResolutionDistance);
+            wanted = std::min(texture.maxDrop, static_cast<uint32_t>(doublings) + 1);
+        }
+        // One level of slack before giving detail up, so textures at a threshold do not reload back and forth
+        if (texture.resident.isValid() && wanted == texture.residentDrop + 1)
+            wanted = texture.residentDrop;
+
+        texture.targetDrop = NOT_STREAMED;
+        for (uint32_t drop = wanted; drop <= texture.maxDrop; drop++) {
+            const uint64_t bytes = levelBytes(texture, drop);
+            if (bytes <= budget) {
+                texture.targetDrop = drop;
+                budget -= bytes;
+                break;
+            }
+        }
+    }
+
+    // Queue uploads nearest first within the per-frame byte budget; one change in flight per texture
+    uint64_t uploadBytes = 0;
+    for (uint32_t i : streamOrder) {
+        StreamedTexture& texture = *streamedTextures[i];
+        if (texture.uploading.isValid() || texture.applyFrame != 0) {
+            pending++;
+            continue;
+        }
+
+        if (texture.targetDrop == NOT_STREAMED) {
+            if (texture.resident.isValid())
+                swapStreamedTexture(texture, TextureHandle{}, 0);  // Evicted: back to the placeholder
+            continue;
+        }
+        if (texture.resident.isValid() && texture.targetDrop == texture.residentDrop)
+            continue;
+
+        pending++;
+        const uint64_t bytes = levelBytes(texture, texture.targetDrop);
+        if (uploadBytes > 0 && uploadBytes + bytes > streamingConfig.uploadBytesPerFrame)
+            continue;
+        startStreamedUpload(texture, texture.targetDrop);
+        uploadBytes += bytes;
+    }
+    if (uploadBytes > 0)
+        UploadManager::get().flush();
+
+    // Per-set path: this frame's sets are free again after its fence wait, so rewrite the stale ones now
+    if (!isBindless()) {
+        for (auto& [id, gpuResources] : resources) {
+            const uint32_t bit = 1u << frameIndex;
+            if ((gpuResources.staleFrames & bit) == 0)
+                continue;
+            gpuResources.staleFrames &= ~bit;
+            if (frameIndex >= gpuResources.descriptorSets.size())
+                continue;
+
+            VkDescriptorImageInfo imageInfo{};
+            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            imageInfo.imageView   = gpuResources.baseColor.view;
+            imageInfo.sampler     = gpuResources.baseColor.sampler;
+
+            VkWriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrite.dstSet          = gpuResources.descriptorSets[frameIndex];
+            descriptorWrite.dstBinding      = 0;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            descriptorWrite.descriptorCount = 1;
+            descriptorWrite.pImageInfo      = &imageInfo;
+            vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+        }
+    }
+
+    if (!streamingSettled && pending == 0 && !streamOrder.empty()) {
+        streamingSettled = true;
+        DP_LOG(Info, "MaterialManager: %zu streamed textures settled after %llu ms", streamOrder.size(),
+               static_cast<unsigned long long>((Profiler::now() - streamingStartNs) / 1000000));
+    }
+}
+
+void MaterialManager::startStreamedUpload(StreamedTexture& texture, uint32_t drop) {
+    const EmbeddedTexture& source = texture.source;
+    const ImageLevel&      top    = source.levels[drop];
+
+    // The chain from `drop` down, with offsets relative to its first level
+    std::vector<ImageLevel> levels(source.levels.begin() + drop, source.levels.end());
+    for (ImageLevel& level : levels)
+        level.offset -= top.offset;
+
+    TextureHandle image;
+    try {
+        createImage(top.width, top.height, static_cast<uint32_t>(levels.size()), texture.format,
+                    VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image.image, image.memory);
+        image.format    = texture.format;
+        image.mipLevels = static_cast<uint32_t>(levels.size());
+        createTextureImageView(image);
+        createTextureSampler(image);
+    } catch (const std::exception& e) {
+        DP_LOG(Warning, "MaterialManager: streamed texture upload failed: %s", e.what());
+        destroyTextureHandle(image);
+        return;
+    }
+
+    texture.upload        = UploadManager::get().uploadImageLevels(image.image, source.data() + top.offset,
+                                                                   source.byteSize() - top.offset, levels);
+    texture.uploading     = image;
+    texture.uploadingDrop = drop;
+}
+
+void MaterialManager::swapStreamedTexture(StreamedTexture& texture, TextureHandle replacement, uint32_t drop) {
+    texture.previous     = texture.resident;
+    texture.previousSlot = texture.bindlessSlot;
+    texture.resident     = replacement;
+    texture.residentDrop = drop;
+    texture.bindlessSlot = 0;
+    texture.uploading.reset();
+
+    // Material handles follow, so descriptor sets created later bind the current image
+    const uint32_t allFrames = (1u << streamingFramesInFlight) - 1;
+    for (const auto& [material, map] : texture.users) {
+        VulkanMaterialResources& gpuResources = resources[material];
+        gpuResources.getMap(map)              = replacement.isValid() ? replacement : placeholderTextures[map];
+        if (map == TEXTURE_MAP_BASE_COLOR)
+            gpuResources.staleFrames = allFrames;
+    }
+
+    if (isBindless()) {
+        // The new slot is unused, so it may be written now. Material records move to it only once every
+        // frame submitted before this write has finished, since those never saw the descriptor
+        if (replacement.isValid() && allocateBindlessSlot(texture.bindlessSlot))
+            writeBindlessTexture(texture.bindlessSlot, replacement);
+        texture.applyFrame = streamFrame + streamingFramesInFlight;
+    } else {
+        // Each frame rewrites its own sets before recording, starting with this one
+        retireTexture(texture.previous, 0, streamFrame + streamingFramesInFlight);
+        texture.previous.reset();
+    }
+}
+
+void MaterialManager::applyStreamedBindings(StreamedTexture& texture) {
+    for (const auto& [material, map] : texture.users) {
+        if (material >= MAX_BINDLESS_MATERIALS)
+            continue;
+        GPUMaterialData& data = materialBufferMapped[material];
+        uint32_t* indices[TEXTURE_MAP_COUNT] = {&data.baseColorIndex, &data.normalMapIndex,
+                                                &data.metallicRoughnessIndex, &data.emissiveIndex};
+        *indices[map] = texture.resident.isValid() ? texture.bindlessSlot
+                                                   : registerBindlessTexture(placeholderTextures[map]);
+    }
+
+    // Frames recorded until now may still read the old slot
+    retireTexture(texture.previous, texture.previousSlot, streamFrame + streamingFramesInFlight);
+    texture.previous.reset();
+    texture.previousSlot = 0;
+    texture.applyFrame   = 0;
+}
+
+void MaterialManager::retireTexture(const TextureHandle& texture, uint32_t bindlessSlot, uint64_t frame) {
+    if (texture.isValid() || bindlessSlot != 0)
+        retiredTextures.push_back(RetiredTexture{texture, bindlessSlot, frame});
+}
+
+TextureStreamingStats MaterialManager::getStreamingStats() const {
+    TextureStreamingStats       stats;
+    std::lock_guard<std::mutex> lock(textureCacheMutex);
+    for (const auto& texture : streamedTextures) {
+        stats.textures++;
+        if (!texture->decoded.load(std::memory_order_acquire)) {
+            stats.pending++;
+            continue;
+        }
+        if (texture->uploading.isValid())
+            stats.pending++;
+        if (texture->resident.isValid()) {
+            stats.resident++;
+            stats.fullResolution += texture->residentDrop == 0 ? 1 : 0;
+            stats.residentBytes += texture->source.byteSize() - texture->source.levels[texture->residentDrop].offset;
+        }
+    }
+    return stats;
+}
+
+// ============================================================================
+// Private Helper Methods
+// ============================================================================
+
+DecodedTextures MaterialManager::decodeTextures(const Material& material) const {
+    DecodedTextures decoded;
+
+    // Streamed textures are decoded by their own jobs, off the loading path
+    if (streaming)
+        return decoded;
+
+    // Only maps that are not embedded need decoding; embedded ones were decoded with the model.
+    // Files another material already loaded (or is loading) come from the texture cache instead.
+    auto needsDecode = [this](const EmbeddedTexture& embedded, const std::string& path) {
+        if (embedded.isValid() || path.empty())
+            return false;
+        std::lock_guard<std::mutex> lock(textureCacheMutex);
+        return textureCache.find(textureKey(embedded, path)) == textureCache.end();
+    };
+
+    if (needsDecode(material.embeddedBaseColor, material.baseColorTexture))
+        decoded.baseColor = decodeTexture(material.baseColorTexture);
+    if (needsDecode(material.embeddedNormalMap, material.normalMapTexture))
+        decoded.normalMap = decodeTexture(material.normalMapTexture);
+    if (needsDecode(material.embeddedMetallicRoughness, material.metallicRoughnessTexture))
+        decoded.metallicRoughness = decodeTexture(material.metallicRoughnessTexture);
+    if (needsDecode(material.embeddedEmissive, material.emissiveTexture))
+        decoded.emissive = decodeTexture(material.emissiveTexture);
+
+    return decoded;
+}
+
+EmbeddedTexture MaterialManager::decodeTexture(const std::string& path) const {
+    DP_PROFILE_SCOPE("MaterialManager::decodeTexture");
+
+    // A compressed variant skips both the decode here and the mip blits on upload
+    if (endsWith(path, ".ktx2"))
+        return decodeKTX2(path);
+
+    const std::pair<const char*, bool> variants[] = {{".astc.ktx2", supportsASTC}, {".bc7.ktx2", supportsBC7}};
+    for (const auto& [suffix, supported] : variants) {
+        if (!supported)
+            continue;
+
+        const std::string variant = replaceExtension(path, suffix);
+        if (!fileExists(variant))
+            continue;
+
+        EmbeddedTexture compressed = decodeKTX2(variant);
+        if (compressed.isValid())
+            return compressed;
+    }
+
+    EmbeddedTexture texture;
 
     int      texWidth, texHeight, texChannels;
     stbi_uc* pixels = stbi_load(path.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
     if (!pixels) {
         std::cerr << "Warning: Failed to load texture: " << path << "\n";
-        return texture;  // Return invalid handle
+        return texture;  // Return invalid texture
     }
 
-    try {
-        createTextureImage(pixels, texWidth, texHeight, 4, texture);
-        createTextureImageView(texture);
-        createTextureSampler(texture);
+    texture.setPixels(std::vector<unsigned char>(pixels, pixels + static_cast<size_t>(texWidth) * texHeight * 4));
+    texture.width  = texWidth;
+    texture.height = texHeight;
 
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading texture " << path << ": " << e.what() << "\n";
-        destroyTextureHandle(texture);
+    stbi_image_free(pixels);
+    return texture;
+}
+
+EmbeddedTexture MaterialManager::decodeKTX2(const std::string& path) const {
+    DP_PROFILE_SCOPE("MaterialManager::decodeKTX2");
+
+    EmbeddedTexture texture;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Warning: Failed to open KTX2 texture: " << path << "\n";
+        return texture;
     }
 
-    stbi_image_free(pixels);
+    std::vector<unsigned char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if (!file || data.size() < KTX2_HEADER_SIZE || memcmp(data.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        std::cerr << "Warning: Not a KTX2 file: " << path << "\n";
+        return texture;
+    }
+
+    const VkFormat format           = static_cast<VkFormat>(readU32(&data[12]));
+    const uint32_t width            = readU32(&data[20]);
+    const uint32_t height           = readU32(&data[24]);
+    const uint32_t depth            = readU32(&data[28]);
+    const uint32_t layerCount       = readU32(&data[32]);
+    const uint32_t faceCount        = readU32(&data[36]);
+    const uint32_t levelCount       = std::max(1u, readU32(&data[40]));
+    const uint32_t supercompression = readU32(&data[44]);
+
+    // Only plain 2D block-compressed textures; Basis/zstd payloads would need a transcoder
+    uint32_t blockWidth, blockHeight;
+    if (!blockExtent(format, blockWidth, blockHeight) || supercompression != 0 || width == 0 || height == 0 ||
+        depth > 1 || layerCount > 1 || faceCount != 1 || levelCount > 32) {
+        std::cerr << "Warning: Unsupported KTX2 texture (format " << format << "): " << path << "\n";
+        return texture;
+    }
+    if (!canSample(format)) {
+        std::cerr << "Warning: Device cannot sample KTX2 format " << format << ": " << path << "\n";
+        return texture;
+    }
+    if (data.size() < KTX2_HEADER_SIZE + static_cast<size_t>(levelCount) * KTX2_LEVEL_SIZE) {
+        std::cerr << "Warning: Truncated KTX2 level index: " << path << "\n";
+        return texture;
+    }
+
+    // Repack largest level first, block-aligned, so the chain uploads as one staging copy
+    std::vector<unsigned char> packed;
+    VkDeviceSize               packedSize = 0;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const unsigned char* entry       = &data[KTX2_HEADER_SIZE + level * KTX2_LEVEL_SIZE];
+        const uint64_t       byteOffset  = readU64(entry);
+        const uint64_t       byteLength  = readU64(entry + 8);
+        const uint32_t       levelWidth  = std::max(1u, width >> level);
+        const uint32_t       levelHeight = std::max(1u, height >> level);
+        const uint64_t       blocksX     = (levelWidth + blockWidth - 1) / blockWidth;
+        const uint64_t       blocks      = blocksX * ((levelHeight + blockHeight - 1) / blockHeight);
+
+        if (byteLength < blocks * 16 || byteOffset > data.size() || byteLength > data.size() - byteOffset) {
+            std::cerr << "Warning: Corrupt KTX2 level " << level << ": " << path << "\n";
+            return EmbeddedTexture{};
+        }
+
+        packedSize = (packedSize + LEVEL_ALIGNMENT - 1) / LEVEL_ALIGNMENT * LEVEL_ALIGNMENT;
+        texture.levels.push_back(ImageLevel{packedSize, levelWidth, levelHeight});
+        packed.resize(static_cast<size_t>(packedSize + blocks * 16));
+        memcpy(&packed[static_cast<size_t>(packedSize)], &data[static_cast<size_t>(byteOffset)],
+               static_cast<size_t>(blocks * 16));
+        packedSize += blocks * 16;
+    }
+
+    texture.setPixels(std::move(packed));
+    texture.width  = static_cast<int>(width);
+    texture.height = static_cast<int>(height);
+    texture.format = format;
     return texture;
 }
 
+bool MaterialManager::canSample(VkFormat format) const {
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
 TextureHandle MaterialManager::createDefaultWhiteTexture() {
     TextureHandle texture;
 
@@ -275,7 +1256,88 @@ TextureHandle MaterialManager::createDefaultWhiteTexture() {
     return texture;
 }
 
+TextureHandle MaterialManager::acquireTexture(const EmbeddedTexture& embedded, const std::string& path,
+                                              const EmbeddedTexture& decoded, uint32_t& outStreamed) {
+    outStreamed = NOT_STREAMED;
+    if (!embedded.isValid() && path.empty())
+        return TextureHandle{};
+
+    const std::string key = textureKey(embedded, path);
+    {
+        std::unique_lock<std::mutex> lock(textureCacheMutex);
+        for (;;) {
+            auto it = textureCache.find(key);
+            if (it == textureCache.end()) {
+                textureCache.emplace(key, CachedTexture{});  // Claimed; other requesters wait for it below
+                break;
+            }
+            if (it->second.ready) {
+                if (it->second.texture.isValid())
+                    it->second.refCount++;
+                outStreamed = it->second.streamed;
+                return it->second.texture;
+            }
+            textureCacheReady.wait(lock);
+        }
+    }
+
+    if (streaming) {
+        const uint32_t index = streamTexture(embedded, path, decoded);
+        {
+            std::lock_guard<std::mutex> lock(textureCacheMutex);
+            CachedTexture&              entry = textureCache[key];
+            entry.streamed                    = index;
+            entry.ready                       = true;
+        }
+        textureCacheReady.notify_all();
+        outStreamed = index;
+        return TextureHandle{};
+    }
+
+    // decodeTextures() skips files that were claimed when it ran, so decode here if that claim later failed
+    TextureHandle texture;
+    if (embedded.isValid())
+        texture = loadTextureFromData(embedded);
+    else if (decoded.isValid())
+        texture = loadTextureFromData(decoded);
+    else
+        texture = loadTextureFromData(decodeTexture(path));
+
+    {
+        // Failed loads stay cached as invalid entries, so a bad file is not retried per material
+        std::lock_guard<std::mutex> lock(textureCacheMutex);
+        CachedTexture&              entry = textureCache[key];
+        entry.texture                     = texture;
+        entry.refCount                    = texture.isValid() ? 1 : 0;
+        entry.ready                       = true;
+        if (texture.isValid())
+            textureCacheKeys[texture.image] = key;
+    }
+    textureCacheReady.notify_all();
+    return texture;
+}
+
+void MaterialManager::releaseTexture(const TextureHandle& texture) {
+    if (!texture.isValid() || texture.image == defaultWhiteTexture.image)
+        return;
+
+    std::lock_guard<std::mutex> lock(textureCacheMutex);
+    auto                        keyIt = textureCacheKeys.find(texture.image);
+    if (keyIt == textureCacheKeys.end())
+        return;
+
+    auto it = textureCache.find(keyIt->second);
+    if (--it->second.refCount > 0)
+        return;
+
+    destroyTextureHandle(it->second.texture);
+    textureCache.erase(it);
+    textureCacheKeys.erase(keyIt);
+}
+
 TextureHandle MaterialManager::loadTextureFromData(const EmbeddedTexture& embeddedTex) {
+    DP_PROFILE_SCOPE("MaterialManager::loadTextureFromData");
+
     TextureHandle texture;
 
     if (!embeddedTex.isValid()) {
@@ -283,8 +1345,11 @@ TextureHandle MaterialManager::loadTextureFromData(const EmbeddedTexture& embedd
     }
 
     try {
-        // Embedded textures from tinygltf are already decoded as RGBA
-        createTextureImage(embeddedTex.pixels.data(), embeddedTex.width, embeddedTex.height, 4, texture);
+        // Embedded textures from tinygltf are already decoded as RGBA; KTX2 ones carry their own levels
+        if (embeddedTex.isCompressed())
+            createCompressedTextureImage(embeddedTex, texture);
+        else
+            createTextureImage(embeddedTex.data(), embeddedTex.width, embeddedTex.height, 4, texture);
         createTextureImageView(texture);
         createTextureSampler(texture);
     } catch (const std::exception& e) {
@@ -297,60 +1362,37 @@ TextureHandle MaterialManager::loadTextureFromData(const EmbeddedTexture& embedd
 
 void MaterialManager::createTextureImage(const unsigned char* pixels, int width, int height, int channels,
                                          TextureHandle& outTexture) {
-    VkDeviceSize imageSize = width * height * 4;  // Always RGBA
-
-    // Create staging buffer
-    VkBuffer       stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size        = imageSize;
-    bufferInfo.usage       = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS)
-        throw std::runtime_error("Failed to create staging buffer");
+    DP_PROFILE_SCOPE("MaterialManager::createTextureImage");
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, stagingBuffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize  = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(
-        memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    VkDeviceSize imageSize = width * height * 4;  // Always RGBA
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &stagingBufferMemory) != VK_SUCCESS) {
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        throw std::runtime_error("Failed to allocate staging buffer memory");
-    }
+    // Full chain down to 1x1, blitted from level 0 by the upload; without linear blits, level 0 only
+    const uint32_t mipLevels =
+        supportsLinearBlit ? static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1 : 1;
 
-    vkBindBufferMemory(device, stagingBuffer, stagingBufferMemory, 0);
+    // Create image
+    createImage(width, height, mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outTexture.image, outTexture.memory);
+    outTexture.format    = VK_FORMAT_R8G8B8A8_SRGB;
+    outTexture.mipLevels = mipLevels;
+
+    // Staging, layout transitions, the copy and the blits are batched; the image is ready once uploads are flushed
+    UploadManager::get().uploadImage(outTexture.image, pixels, imageSize, width, height, mipLevels);
+}
 
-    // Copy pixel data
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(device, stagingBufferMemory);
+void MaterialManager::createCompressedTextureImage(const EmbeddedTexture& texture, TextureHandle& outTexture) {
+    DP_PROFILE_SCOPE("MaterialManager::createCompressedTextureImage");
 
-    // Create image
-    createImage(width, height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
+    const uint32_t mipLevels = static_cast<uint32_t>(texture.levels.size());
+    createImage(texture.width, texture.height, mipLevels, texture.format, VK_IMAGE_TILING_OPTIMAL,
                 VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                 outTexture.image, outTexture.memory);
+    outTexture.format    = texture.format;
+    outTexture.mipLevels = mipLevels;
 
-    // Transition and copy
-    transitionImageLayout(outTexture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    copyBufferToImage(stagingBuffer, outTexture.image, width, height);
-
-    transitionImageLayout(outTexture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-    // Cleanup staging
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
+    // Block-compressed formats cannot be blitted, so every level comes from the file
+    UploadManager::get().uploadImageLevels(outTexture.image, texture.data(), texture.byteSize(), texture.levels);
 }
 
 void MaterialManager::createTextureImageView(TextureHandle& texture) {
@@ -358,10 +1400,10 @@ void MaterialManager::createTextureImageView(TextureHandle& texture) {
     viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image                           = texture.image;
     viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format                          = VK_FORMAT_R8G8B8A8_SRGB;
+    viewInfo.format                          = texture.format;
     viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel   = 0;
-    viewInfo.subresourceRange.levelCount     = 1;
+    viewInfo.subresourceRange.levelCount     = texture.mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount     = 1;
 
@@ -370,47 +1412,64 @@ void MaterialManager::createTextureImageView(TextureHandle& texture) {
 }
 
 void MaterialManager::createTextureSampler(TextureHandle& texture) {
+    // The view already limits sampling to the texture's own levels, so an unclamped LOD lets every texture share
+    SamplerState state;
+    state.maxAnisotropy = std::min(16.0f, std::max(1.0f, maxSamplerAnisotropy));
+    state.maxLod        = VK_LOD_CLAMP_NONE;
+    texture.sampler     = getSampler(state);
+}
+
+VkSampler MaterialManager::getSampler(const SamplerState& state) {
+    std::lock_guard<std::mutex> lock(samplerCacheMutex);
+    auto                        it = samplerCache.find(state);
+    if (it != samplerCache.end())
+        return it->second;
+
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter               = VK_FILTER_LINEAR;
-    samplerInfo.minFilter               = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerInfo.anisotropyEnable        = VK_TRUE;
-    samplerInfo.maxAnisotropy           = 16.0f;
+    samplerInfo.magFilter               = state.filter;
+    samplerInfo.minFilter               = state.filter;
+    samplerInfo.addressModeU            = state.addressMode;
+    samplerInfo.addressModeV            = state.addressMode;
+    samplerInfo.addressModeW            = state.addressMode;
+    samplerInfo.anisotropyEnable        = state.maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy           = state.maxAnisotropy;
     samplerInfo.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     samplerInfo.unnormalizedCoordinates = VK_FALSE;
     samplerInfo.compareEnable           = VK_FALSE;
     samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.mipmapMode              = state.mipmapMode;
+    samplerInfo.minLod                  = 0.0f;
+    samplerInfo.maxLod                  = state.maxLod;
 
-    if (vkCreateSampler(device, &samplerInfo, nullptr, &texture.sampler) != VK_SUCCESS)
+    VkSampler sampler;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
         throw std::runtime_error("Failed to create texture sampler");
+
+    samplerCache.emplace(state, sampler);
+    return sampler;
 }
 
 void MaterialManager::destroyTextureHandle(TextureHandle& texture) {
-    if (texture.sampler != VK_NULL_HANDLE)
-        vkDestroySampler(device, texture.sampler, nullptr);
+    // The sampler belongs to samplerCache
     if (texture.view != VK_NULL_HANDLE)
         vkDestroyImageView(device, texture.view, nullptr);
     if (texture.image != VK_NULL_HANDLE)
         vkDestroyImage(device, texture.image, nullptr);
-    if (texture.memory != VK_NULL_HANDLE)
-        vkFreeMemory(device, texture.memory, nullptr);
+    MemoryAllocator::get().free(texture.memory);
     texture.reset();
 }
 
-void MaterialManager::createImage(const uint32_t width, const uint32_t height, const VkFormat format,
-                                  const VkImageTiling tiling, const VkImageUsageFlags usage,
-                                  const VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) {
+void MaterialManager::createImage(const uint32_t width, const uint32_t height, const uint32_t mipLevels,
+                                  const VkFormat format, const VkImageTiling tiling, const VkImageUsageFlags usage,
+                                  const VkMemoryPropertyFlags properties, VkImage& image, Allocation& imageMemory) {
     VkImageCreateInfo imageInfo{};
     imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType     = VK_IMAGE_TYPE_2D;
     imageInfo.extent.width  = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth  = 1;
-    imageInfo.mipLevels     = 1;
+    imageInfo.mipLevels     = mipLevels;
     imageInfo.arrayLayers   = 1;
     imageInfo.format        = format;
     imageInfo.tiling        = tiling;
@@ -422,134 +1481,7 @@ void MaterialManager::createImage(const uint32_t width, const uint32_t height, c
     if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
         throw std::runtime_error("Failed to create image");
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, image, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize  = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-        throw std::runtime_error("Failed to allocate image memory");
-    vkBindImageMemory(device, image, imageMemory, 0);
-}
-
-void MaterialManager::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout,
-                                            VkImageLayout newLayout) {
-    // Create command buffer
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool        = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout                       = oldLayout;
-    barrier.newLayout                       = newLayout;
-    barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image                           = image;
-    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel   = 0;
-    barrier.subresourceRange.levelCount     = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount     = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
-
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        sourceStage           = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage      = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-               newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        sourceStage           = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage      = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-
-    vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
-}
-
-void MaterialManager::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool        = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferImageCopy region{};
-    region.bufferOffset                    = 0;
-    region.bufferRowLength                 = 0;
-    region.bufferImageHeight               = 0;
-    region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel       = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount     = 1;
-    region.imageOffset                     = {0, 0, 0};
-    region.imageExtent                     = {width, height, 1};
-
-    vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
-}
-
-uint32_t MaterialManager::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-
-    throw std::runtime_error("Failed to find suitable memory type");
+    ResourceManager::allocateImageMemory(device, image, tiling, properties, imageMemory, MemoryTag::Textures);
 }
 
 }  // namespace DownPour
@@ -1,7 +1,57 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
+
+/** @brief Most simplified levels generated per primitive, besides the full-detail one */
+constexpr uint32_t MAX_MESH_LODS = 3;
+
+/**
+ * @brief One simplified level of a primitive
+ *
+ * Indexes the same vertex run as the full-detail range (same vertexOffset),
+ * so selecting a level only changes the index range that is drawn.
+ */
+struct MeshLod {
+    uint32_t indexStart = 0;
+    uint32_t indexCount = 0;
+    float    error      = 0.0f;  // Largest distance a vertex moved, in model units
+};
+
+constexpr float LOD_MAX_PIXEL_ERROR = 1.0f;  // Coarsest level allowed is the one whose error projects to this
+constexpr float LOD_HYSTERESIS      = 0.2f;  // Fraction of the projected size past a switch point before switching
+
+/**
+ * @brief Level to draw: the coarsest within LOD_MAX_PIXEL_ERROR, switching only LOD_HYSTERESIS past the threshold
+ *
+ * @param current Level drawn last frame
+ * @param pixelsPerModelUnit Pixels one model unit covers at the mesh's distance
+ * @return 0 for full detail, else 1 + index into `lods`
+ */
+inline uint32_t selectMeshLod(const MeshLod* lods, uint32_t lodCount, uint32_t current, float pixelsPerModelUnit) {
+    auto coarsestFor = [&](float projected) {
+        uint32_t level = 0;
+        while (level < lodCount && lods[level].error * projected <= LOD_MAX_PIXEL_ERROR)
+            level++;
+        return level;
+    };
+
+    // Coarsen only once that level would still pass a bit closer, refine only once needed a bit further out
+    const uint32_t finest   = coarsestFor(pixelsPerModelUnit * (1.0f + LOD_HYSTERESIS));
+    const uint32_t coarsest = coarsestFor(pixelsPerModelUnit * (1.0f - LOD_HYSTERESIS));
+    return std::min(std::max(current, finest), coarsest);
+}
+
+/**
+ * @brief NamedMesh::meshIndex of merged static geometry (Model::getStaticBatches())
+ *
+ * No glTF node references it; primitiveIndex then holds the material index.
+ */
+constexpr uint32_t STATIC_BATCH_MESH_INDEX = ~0u;
 
 /**
  * @brief Named mesh structure holding mesh name and index range
@@ -16,17 +66,58 @@ struct NamedMesh {
     uint32_t    primitiveIndex;  // Which primitive within the mesh (0, 1, 2...)
     uint32_t    indexStart;      // Starting index in the index buffer
     uint32_t    indexCount;      // Number of indices for this primitive
+    int32_t     vertexOffset;    // Added to each index when drawing (non-zero once MeshOptimizer rebased it)
     glm::mat4   transform;       // Optional transform (defaults to identity)
 
     glm::vec3 minBounds;
     glm::vec3 maxBounds;
 
+    std::vector<MeshLod> lods;  // Coarser levels, finest first; empty when none were generated
+
     NamedMesh()
         : meshIndex(0),
           primitiveIndex(0),
           indexStart(0),
           indexCount(0),
+          vertexOffset(0),
           transform(glm::mat4(1.0f)),
           minBounds(0.0f),
           maxBounds(0.0f) {}
 };
+
+/** @brief WorldTileSection::material for geometry without materials (drawn untextured) */
+constexpr uint32_t WORLD_TILE_NO_MATERIAL = ~0u;
+
+/**
+ * @brief One material's triangles within a world tile
+ *
+ * Indices are relative to the tile's vertex run, and starts to its index run.
+ */
+struct WorldTileSection {
+    uint32_t                           material   = WORLD_TILE_NO_MATERIAL;  // Index into the model's materials
+    uint32_t                           indexStart = 0;
+    uint32_t                           indexCount = 0;
+    uint32_t                           lodCount   = 0;
+    std::array<MeshLod, MAX_MESH_LODS> lods{};
+};
+
+/**
+ * @brief Spatial chunk of a tiled model, streamed in on its own
+ *
+ * Tiles are square cells of the XZ plane in model space. A triangle belongs to
+ * the cell holding its centroid, so bounds may reach a little past the cell.
+ */
+struct WorldTile {
+    int32_t   gridX = 0;
+    int32_t   gridZ = 0;
+    glm::vec3 minBounds{0.0f};
+    glm::vec3 maxBounds{0.0f};
+
+    // Runs in the model's vertex and index blobs (tile-contiguous in the cooked file)
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex  = 0;
+    uint32_t indexCount  = 0;
+
+    std::vector<WorldTileSection> sections;
+};
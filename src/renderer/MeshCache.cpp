@@ -0,0 +1,477 @@
+// SPDX-License-Identifier: MIT
+#include "MeshCache.h"
+
+#include "MeshOptimizer.h"
+#include "Model.h"
+#include "core/BinaryIO.h"
+#include "core/Profiler.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace DownPour {
+
+namespace {
+
+constexpr char     CACHE_MAGIC[4]    = {'D', 'P', 'M', 'C'};
+constexpr char     CACHE_EXTENSION[] = ".dpmesh";
+constexpr uint64_t BLOB_ALIGNMENT    = 16;
+constexpr uint32_t COOKED_OPTIMIZED  = 1u << 0;  // Geometry went through MeshOptimizer
+
+/**
+ * @brief Fixed-size file header; blobs follow at 16-byte aligned offsets
+ *
+ * Everything is stored in native byte order and layout. The cache is a local
+ * build artefact, never shipped, so VERSION plus the stride check is enough.
+ */
+struct CookedHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t sourceHash;      // Source path + bytes; also part of the file name
+    uint64_t dependencyHash;  // External .bin buffers listed in the metadata
+    uint32_t vertexStride;    // sizeof(Vertex) when cooked
+    uint32_t indexSize;       // 2 or 4, the model's index type
+    uint32_t flags;           // COOKED_* bits: load options the geometry was cooked with
+    uint32_t lodLevels;       // ModelLoadOptions::lodLevels when cooked
+    float    tileSize;        // ModelLoadOptions::tileSize; > 0 means the blobs are laid out tile by tile
+    uint32_t mergeKey;        // cookedMergeKey(): which nodes were baked into static batches
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t metadataOffset;
+    uint64_t metadataSize;
+    Vec3     minBounds;
+    Vec3     maxBounds;
+};
+
+static_assert(std::is_trivially_copyable<CookedHeader>::value, "CookedHeader is read with memcpy");
+static_assert(std::is_trivially_copyable<Vertex>::value, "Vertex blobs are copied verbatim");
+static_assert(std::is_trivially_copyable<WorldTileSection>::value, "Tile sections are stored as an array");
+
+bool hashSource(const std::string& sourcePath, uint64_t& outHash) {
+    // Seeded with the path: texture paths in the material table are resolved relative to it
+    const auto*    path     = reinterpret_cast<const unsigned char*>(sourcePath.data());
+    const uint64_t pathHash = hashBytes(path, sourcePath.size(), 0);
+    return hashFile(sourcePath, pathHash, outHash);
+}
+
+bool hashDependencies(const std::vector<std::string>& dependencies, uint64_t& outHash) {
+    uint64_t h = 0;
+    for (const std::string& path : dependencies) {
+        if (!hashFile(path, h, h))
+            return false;
+    }
+    outHash = h;
+    return true;
+}
+
+/**
+ * @brief LOD levels the load options actually produce; LODs are built by the optimizer pass
+ */
+uint32_t cookedLodLevels(const ModelLoadOptions& options) {
+    return options.optimizeMesh ? options.lodLevels : 0;
+}
+
+/**
+ * @brief Fingerprint of the static-merge options; 0 when merging is off
+ */
+uint32_t cookedMergeKey(const ModelLoadOptions& options) {
+    if (!options.mergeStatic)
+        return 0;
+    std::vector<std::string> names = options.movableNodes;
+    std::sort(names.begin(), names.end());
+    uint64_t h = 0;
+    for (const std::string& name : names)
+        h = hashBytes(reinterpret_cast<const unsigned char*>(name.c_str()), name.size() + 1, h);
+    return static_cast<uint32_t>(h ^ (h >> 32)) | 1u;
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+}
+
+void writeTexture(BlobWriter& out, const EmbeddedTexture& texture) {
+    out.put(static_cast<int32_t>(texture.width));
+    out.put(static_cast<int32_t>(texture.height));
+    out.putArray(texture.pixels ? *texture.pixels : std::vector<unsigned char>{});
+}
+
+void readTexture(BlobReader& in, EmbeddedTexture& texture) {
+    texture.width  = in.get<int32_t>();
+    texture.height = in.get<int32_t>();
+    texture.setPixels(in.getArray<unsigned char>());
+}
+
+bool reject(const std::string& cachePath, const char* reason) {
+    DP_LOG(Info, "Mesh cache: ignoring %s (%s)", cachePath.c_str(), reason);
+    return false;
+}
+
+}  // namespace
+
+bool MeshCache::load(const std::string& sourcePath, Model& outModel, VkDevice device,
+                     VkPhysicalDevice physicalDevice) {
+    DP_PROFILE_SCOPE("MeshCache::load");
+
+    uint64_t sourceHash = 0;
+    if (!hashSource(sourcePath, sourceHash))
+        return false;
+
+    const std::string cachePath = cachePathFor(sourcePath, sourceHash);
+    MappedFile        cooked(cachePath);
+    if (!cooked.isOpen())
+        return false;  // Not cooked yet
+
+    CookedHeader header{};
+    if (cooked.size() < sizeof(header))
+        return reject(cachePath, "truncated");
+    memcpy(&header, cooked.data(), sizeof(header));
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION ||
+        header.sourceHash != sourceHash || header.vertexStride != sizeof(Vertex) ||
+        (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t))) {
+        return reject(cachePath, "stale format");
+    }
+
+    const bool optimized = (header.flags & COOKED_OPTIMIZED) != 0;
+    if (optimized != outModel.loadOptions.optimizeMesh || header.lodLevels != cookedLodLevels(outModel.loadOptions) ||
+        header.tileSize != outModel.loadOptions.tileSize || header.mergeKey != cookedMergeKey(outModel.loadOptions)) {
+        return reject(cachePath, "cooked with other load options");
+    }
+
+    const uint64_t fileSize = cooked.size();
+    auto inFile = [fileSize](uint64_t offset, uint64_t count, uint64_t stride) {
+        return offset <= fileSize && count <= (fileSize - offset) / stride;
+    };
+    if (!inFile(header.vertexOffset, header.vertexCount, sizeof(Vertex)) ||
+        !inFile(header.indexOffset, header.indexCount, header.indexSize) ||
+        !inFile(header.metadataOffset, header.metadataSize, 1)) {
+        return reject(cachePath, "truncated");
+    }
+
+    BlobReader meta(cooked.data() + header.metadataOffset, static_cast<size_t>(header.metadataSize));
+
+    std::vector<std::string> dependencies(meta.getCount(sizeof(uint32_t)));
+    for (std::string& path : dependencies)
+        path = meta.getString();
+    uint64_t dependencyHash = 0;
+    if (!meta.ok() || !hashDependencies(dependencies, dependencyHash) || dependencyHash != header.dependencyHash)
+        return reject(cachePath, "buffers changed");
+
+    std::vector<NamedMesh> namedMeshes(meta.getCount(sizeof(uint32_t)));
+    for (NamedMesh& mesh : namedMeshes) {
+        mesh.name           = meta.getString();
+        mesh.nodeName       = meta.getString();
+        mesh.meshIndex      = meta.get<uint32_t>();
+        mesh.primitiveIndex = meta.get<uint32_t>();
+        mesh.indexStart     = meta.get<uint32_t>();
+        mesh.indexCount     = meta.get<uint32_t>();
+        mesh.vertexOffset   = meta.get<int32_t>();
+        mesh.transform      = meta.get<Mat4>();
+        mesh.minBounds      = meta.get<Vec3>();
+        mesh.maxBounds      = meta.get<Vec3>();
+        mesh.lods           = meta.getArray<MeshLod>();
+    }
+
+    std::vector<glTFNode> nodes(meta.getCount(sizeof(uint32_t)));
+    for (glTFNode& node : nodes) {
+        node.name           = meta.getString();
+        node.meshIndex      = meta.get<int32_t>();
+        node.primitiveIndex = meta.get<int32_t>();
+        node.translation    = meta.get<Vec3>();
+        node.rotation       = meta.get<Quat>();
+        node.scale          = meta.get<Vec3>();
+        node.matrix         = meta.get<Mat4>();
+        node.children       = meta.getArray<int>();
+        node.parent         = meta.get<int32_t>();
+    }
+
+    std::vector<glTFScene> scenes(meta.getCount(sizeof(uint32_t)));
+    for (glTFScene& scene : scenes) {
+        scene.name      = meta.getString();
+        scene.rootNodes = meta.getArray<int>();
+    }
+    const int32_t defaultSceneIndex = meta.get<int32_t>();
+
+    std::vector<Material> materials(meta.getCount(sizeof(uint32_t)));
+    for (Material& material : materials) {
+        material.id                         = meta.get<uint32_t>();
+        material.name                       = meta.getString();
+        material.props.alphaValue           = meta.get<float>();
+        material.props.isTransparent        = meta.get<uint8_t>() != 0;
+        material.props.hasNormalMap         = meta.get<uint8_t>() != 0;
+        material.props.hasMetallicRoughness = meta.get<uint8_t>() != 0;
+        material.props.hasEmissive          = meta.get<uint8_t>() != 0;
+        material.baseColorTexture           = meta.getString();
+        material.normalMapTexture           = meta.getString();
+        material.metallicRoughnessTexture   = meta.getString();
+        material.emissiveTexture            = meta.getString();
+        readTexture(meta, material.embeddedBaseColor);
+        readTexture(meta, material.embeddedNormalMap);
+        readTexture(meta, material.embeddedMetallicRoughness);
+        readTexture(meta, material.embeddedEmissive);
+        material.meshIndex      = meta.get<int32_t>();
+        material.primitiveIndex = meta.get<int32_t>();
+        material.sourceIndex    = meta.get<int32_t>();
+        material.indexStart     = meta.get<uint32_t>();
+        material.indexCount     = meta.get<uint32_t>();
+        material.vertexOffset   = meta.get<int32_t>();
+    }
+
+    std::vector<WorldTile> tiles(meta.getCount(sizeof(int32_t) * 2 + sizeof(Vec3) * 2 + sizeof(uint32_t) * 5));
+    for (WorldTile& tile : tiles) {
+        tile.gridX       = meta.get<int32_t>();
+        tile.gridZ       = meta.get<int32_t>();
+        tile.minBounds   = meta.get<Vec3>();
+        tile.maxBounds   = meta.get<Vec3>();
+        tile.firstVertex = meta.get<uint32_t>();
+        tile.vertexCount = meta.get<uint32_t>();
+        tile.firstIndex  = meta.get<uint32_t>();
+        tile.indexCount  = meta.get<uint32_t>();
+        tile.sections    = meta.getArray<WorldTileSection>();
+        if (tile.firstVertex + static_cast<uint64_t>(tile.vertexCount) > header.vertexCount ||
+            tile.firstIndex + static_cast<uint64_t>(tile.indexCount) > header.indexCount) {
+            return reject(cachePath, "damaged tile table");
+        }
+    }
+
+    if (!meta.ok())
+        return reject(cachePath, "damaged metadata");
+
+    outModel.namedMeshes       = std::move(namedMeshes);
+    outModel.nodes             = std::move(nodes);
+    outModel.scenes            = std::move(scenes);
+    outModel.defaultSceneIndex = defaultSceneIndex;
+    outModel.materials         = std::move(materials);
+    outModel.minBounds         = header.minBounds;
+    outModel.maxBounds         = header.maxBounds;
+    outModel.indexType         = header.indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    // Tiled: nothing is uploaded here, WorldStreamer reads tiles from this file as the car gets near them
+    if (!tiles.empty()) {
+        outModel.tiles          = std::move(tiles);
+        outModel.tileSourcePath = cachePath;
+        outModel.useStreamedGeometry();
+        DP_LOG(Info, "Loaded cooked tile table %s (%zu tiles)", cachePath.c_str(), outModel.tiles.size());
+        return true;
+    }
+
+    // Straight from the mapping into staging; the model keeps no CPU copy of the geometry
+    outModel.createGeometry(reinterpret_cast<const Vertex*>(cooked.data() + header.vertexOffset),
+                            static_cast<size_t>(header.vertexCount), cooked.data() + header.indexOffset,
+                            static_cast<size_t>(header.indexCount), device, physicalDevice);
+
+    DP_LOG(Info, "Loaded cooked mesh %s (%llu vertices, %llu indices)", cachePath.c_str(),
+           static_cast<unsigned long long>(header.vertexCount), static_cast<unsigned long long>(header.indexCount));
+    return true;
+}
+
+bool MeshCache::cook(const std::string& sourcePath, const Model& model, const std::vector<std::string>& dependencies,
+                     std::string* outCachePath) {
+    DP_PROFILE_SCOPE("MeshCache::cook");
+
+    CookedHeader header{};
+    if (!hashSource(sourcePath, header.sourceHash) || !hashDependencies(dependencies, header.dependencyHash))
+        return false;
+
+    BlobWriter meta;
+
+    meta.put(static_cast<uint32_t>(dependencies.size()));
+    for (const std::string& path : dependencies)
+        meta.putString(path);
+
+    meta.put(static_cast<uint32_t>(model.namedMeshes.size()));
+    for (const NamedMesh& mesh : model.namedMeshes) {
+        meta.putString(mesh.name);
+        meta.putString(mesh.nodeName);
+        meta.put(mesh.meshIndex);
+        meta.put(mesh.primitiveIndex);
+        meta.put(mesh.indexStart);
+        meta.put(mesh.indexCount);
+        meta.put(mesh.vertexOffset);
+        meta.put(mesh.transform);
+        meta.put(mesh.minBounds);
+        meta.put(mesh.maxBounds);
+        meta.putArray(mesh.lods);
+    }
+
+    meta.put(static_cast<uint32_t>(model.nodes.size()));
+    for (const glTFNode& node : model.nodes) {
+        meta.putString(node.name);
+        meta.put(static_cast<int32_t>(node.meshIndex));
+        meta.put(static_cast<int32_t>(node.primitiveIndex));
+        meta.put(node.translation);
+        meta.put(node.rotation);
+        meta.put(node.scale);
+        meta.put(node.matrix);
+        meta.putArray(node.children);
+        meta.put(static_cast<int32_t>(node.parent));
+    }
+
+    meta.put(static_cast<uint32_t>(model.scenes.size()));
+    for (const glTFScene& scene : model.scenes) {
+        meta.putString(scene.name);
+        meta.putArray(scene.rootNodes);
+    }
+    meta.put(static_cast<int32_t>(model.defaultSceneIndex));
+
+    meta.put(static_cast<uint32_t>(model.materials.size()));
+    for (const Material& material : model.materials) {
+        meta.put(material.id);
+        meta.putString(material.name);
+        meta.put(material.props.alphaValue);
+        meta.put(static_cast<uint8_t>(material.props.isTransparent));
+        meta.put(static_cast<uint8_t>(material.props.hasNormalMap));
+        meta.put(static_cast<uint8_t>(material.props.hasMetallicRoughness));
+        meta.put(static_cast<uint8_t>(material.props.hasEmissive));
+        meta.putString(material.baseColorTexture);
+        meta.putString(material.normalMapTexture);
+        meta.putString(material.metallicRoughnessTexture);
+        meta.putString(material.emissiveTexture);
+        writeTexture(meta, material.embeddedBaseColor);
+        writeTexture(meta, material.embeddedNormalMap);
+        writeTexture(meta, material.embeddedMetallicRoughness);
+        writeTexture(meta, material.embeddedEmissive);
+        meta.put(material.meshIndex);
+        meta.put(material.primitiveIndex);
+        meta.put(material.sourceIndex);
+        meta.put(material.indexStart);
+        meta.put(material.indexCount);
+        meta.put(material.vertexOffset);
+    }
+
+    meta.put(static_cast<uint32_t>(model.tiles.size()));
+    for (const WorldTile& tile : model.tiles) {
+        meta.put(tile.gridX);
+        meta.put(tile.gridZ);
+        meta.put(tile.minBounds);
+        meta.put(tile.maxBounds);
+        meta.put(tile.firstVertex);
+        meta.put(tile.vertexCount);
+        meta.put(tile.firstIndex);
+        meta.put(tile.indexCount);
+        meta.putArray(tile.sections);
+    }
+
+    // Store indices at their GPU width, so a warm start copies them straight from the mapping
+    std::vector<uint16_t> narrowed;
+    const void*           indexData = model.indices.data();
+    if (model.indexType == VK_INDEX_TYPE_UINT16) {
+        narrowed  = MeshOptimizer::narrowIndices(model.indices.data(), model.indices.size());
+        indexData = narrowed.data();
+    }
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version        = VERSION;
+    header.vertexStride   = sizeof(Vertex);
+    header.indexSize      = model.indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    header.flags          = model.loadOptions.optimizeMesh ? COOKED_OPTIMIZED : 0;
+    header.lodLevels      = cookedLodLevels(model.loadOptions);
+    header.tileSize       = model.loadOptions.tileSize;
+    header.mergeKey       = cookedMergeKey(model.loadOptions);
+    header.vertexCount    = model.vertices.size();
+    header.indexCount     = model.indices.size();
+    header.vertexOffset   = alignUp(sizeof(CookedHeader));
+    header.indexOffset    = alignUp(header.vertexOffset + header.vertexCount * sizeof(Vertex));
+    header.metadataOffset = alignUp(header.indexOffset + header.indexCount * header.indexSize);
+    header.metadataSize   = meta.getData().size();
+    header.minBounds      = model.minBounds;
+    header.maxBounds      = model.maxBounds;
+
+    const std::string cachePath = cachePathFor(sourcePath, header.sourceHash);
+    const std::string tempPath  = cachePath + ".tmp";
+
+    std::error_code error;
+    std::filesystem::create_directories(CACHE_DIRECTORY, error);
+
+    // Same temp-and-rename as PipelineCache, so a crash never leaves a truncated file
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        DP_LOG(Warning, "Mesh cache: cannot write %s", tempPath.c_str());
+        return false;
+    }
+
+    const char padding[BLOB_ALIGNMENT] = {};
+    uint64_t   written                 = 0;
+    auto       writeAt                 = [&](uint64_t offset, const void* data, uint64_t size) {
+        file.write(padding, static_cast<std::streamsize>(offset - written));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written = offset + size;
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.vertexOffset, model.vertices.data(), header.vertexCount * sizeof(Vertex));
+    writeAt(header.indexOffset, indexData, header.indexCount * header.indexSize);
+    writeAt(header.metadataOffset, meta.getData().data(), header.metadataSize);
+    file.close();
+
+    if (!file) {
+        DP_LOG(Warning, "Mesh cache: failed writing %s", tempPath.c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        DP_LOG(Warning, "Mesh cache: cannot replace %s: %s", cachePath.c_str(), error.message().c_str());
+        return false;
+    }
+
+    // Drop files cooked from earlier versions of this source (<stem>-<16 hex digits>.dpmesh)
+    const std::string prefix = std::filesystem::path(sourcePath).stem().string() + "-";
+    const size_t      length = prefix.size() + 16 + sizeof(CACHE_EXTENSION) - 1;
+    for (const auto& entry : std::filesystem::directory_iterator(CACHE_DIRECTORY, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == length && name.rfind(prefix, 0) == 0 && entry.path().extension() == CACHE_EXTENSION &&
+            entry.path() != std::filesystem::path(cachePath)) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    DP_LOG(Info, "Cooked mesh %s -> %s", sourcePath.c_str(), cachePath.c_str());
+    if (outCachePath)
+        *outCachePath = cachePath;
+    return true;
+}
+
+bool MeshCache::readTile(const std::string& cachePath, const WorldTile& tile, std::vector<Vertex>& outVertices,
+                         std::vector<unsigned char>& outIndices) {
+    DP_PROFILE_SCOPE("MeshCache::readTile");
+
+    // Plain reads rather than a mapping: only this tile's runs are touched, from any thread
+    std::ifstream file(cachePath, std::ios::binary);
+    CookedHeader  header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION ||
+        header.vertexStride != sizeof(Vertex) || header.tileSize <= 0.0f ||
+        tile.firstVertex + static_cast<uint64_t>(tile.vertexCount) > header.vertexCount ||
+        tile.firstIndex + static_cast<uint64_t>(tile.indexCount) > header.indexCount) {
+        return false;
+    }
+
+    const uint64_t vertexStart = header.vertexOffset + static_cast<uint64_t>(tile.firstVertex) * sizeof(Vertex);
+    const uint64_t indexStart  = header.indexOffset + static_cast<uint64_t>(tile.firstIndex) * header.indexSize;
+
+    outVertices.resize(tile.vertexCount);
+    outIndices.resize(static_cast<size_t>(tile.indexCount) * header.indexSize);
+    file.seekg(static_cast<std::streamoff>(vertexStart));
+    file.read(reinterpret_cast<char*>(outVertices.data()),
+              static_cast<std::streamsize>(outVertices.size() * sizeof(Vertex)));
+    file.seekg(static_cast<std::streamoff>(indexStart));
+    file.read(reinterpret_cast<char*>(outIndices.data()), static_cast<std::streamsize>(outIndices.size()));
+    return static_cast<bool>(file);
+}
+
+std::string MeshCache::cachePathFor(const std::string& sourcePath, uint64_t sourceHash) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(sourceHash));
+    std::string name = std::filesystem::path(sourcePath).stem().string() + "-" + hash + CACHE_EXTENSION;
+    return (std::filesystem::path(CACHE_DIRECTORY) / name).string();
+}
+
+}  // namespace DownPour
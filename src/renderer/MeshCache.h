@@ -0,0 +1,72 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "Mesh.h"
+#include "Vertex.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DownPour {
+
+class Model;
+
+/**
+ * @brief Cooked binary cache of parsed glTF models
+ *
+ * A cooked file holds everything GLTFLoader produces, after MeshOptimizer
+ * when the model asks for it: the final interleaved vertex blob, the index
+ * blob at its GPU width (16 or 32 bit), NamedMesh ranges and LODs, the node
+ * hierarchy, scenes and the material table (embedded textures already
+ * decoded). Files live in
+ * CACHE_DIRECTORY, named `<stem>-<hash>.dpmesh` where the hash covers the
+ * source path and bytes; external .bin buffers are hashed separately and
+ * checked on open, so editing any input re-cooks on the next launch.
+ *
+ * Loading maps the file and copies the geometry blobs straight into upload
+ * staging, so a warm start costs I/O rather than parsing. A missing, stale or
+ * damaged file is never an error: load() returns false and the caller parses
+ * the source as usual, then cooks it.
+ *
+ * A tiled model (ModelLoadOptions::tileSize) stores its blobs tile by tile
+ * plus a tile table. Loading it uploads nothing; readTile() fetches single
+ * tiles for WorldStreamer, so startup cost no longer depends on its size.
+ */
+class MeshCache {
+public:
+    static constexpr const char* CACHE_DIRECTORY = "cache/meshes";
+    static constexpr uint32_t    VERSION         = 5;  // Bump whenever the layout or Vertex changes
+
+    /**
+     * @brief Populate a model from its cooked file and upload the geometry
+     * @return false if there is no valid cooked file for the source; the model is untouched
+     */
+    static bool load(const std::string& sourcePath, Model& outModel, VkDevice device,
+                     VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Write the cooked file for a freshly parsed model
+     * @param dependencies External files the model was built from (glTF .bin buffers)
+     * @param outCachePath Set to the written file on success
+     * @return false if the file could not be written; the next launch just parses again
+     */
+    static bool cook(const std::string& sourcePath, const Model& model, const std::vector<std::string>& dependencies,
+                     std::string* outCachePath = nullptr);
+
+    /**
+     * @brief Read one tile's vertices and indices (at the cooked index width) from a tiled cooked file
+     *
+     * Thread-safe; WorldStreamer calls it from its load jobs.
+     * @return false if the file no longer holds that tile
+     */
+    static bool readTile(const std::string& cachePath, const WorldTile& tile, std::vector<Vertex>& outVertices,
+                         std::vector<unsigned char>& outIndices);
+
+private:
+    static std::string cachePathFor(const std::string& sourcePath, uint64_t sourceHash);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,484 @@
+// SPDX-License-Identifier: MIT
+#include "MeshOptimizer.h"
+
+#include "core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+
+namespace DownPour {
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX    = ~0u;
+constexpr uint32_t LRU_CACHE_SIZE   = 32;  // Forsyth's modelled cache; larger than any real one on purpose
+constexpr uint32_t FIFO_CACHE_SIZE  = 16;  // Conservative stand-in for the hardware cache when measuring
+constexpr float    LAST_TRIANGLE    = 0.75f;
+constexpr float    CACHE_DECAY      = 1.5f;
+constexpr float    VALENCE_BOOST    = 2.0f;
+constexpr float    VALENCE_EXPONENT = 0.5f;
+
+constexpr uint32_t LOD_MIN_TRIANGLES = 64;    // Smaller primitives cost less than the draw itself
+constexpr float    LOD_MIN_REDUCTION = 0.8f;  // A level must drop at least 20% of the previous one's triangles
+constexpr uint32_t LOD_MAX_GRID      = 1024;  // Cells along the longest axis at the finest searched grid
+constexpr uint32_t LOD_SEARCH_STEPS  = 10;    // Enough to bisect [1, LOD_MAX_GRID]
+
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Welding hashes Vertex as eight packed floats");
+static_assert(std::is_trivially_copyable<Vertex>::value, "Welding compares Vertex bytes");
+
+/**
+ * @brief Bitwise vertex identity: only exact duplicates weld, so welding never moves a vertex
+ */
+struct VertexBitsHash {
+    size_t operator()(const Vertex& vertex) const {
+        uint32_t words[8];
+        memcpy(words, &vertex, sizeof(words));
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (uint32_t word : words)
+            h = (h ^ word) * 0x100000001B3ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+struct VertexBitsEqual {
+    bool operator()(const Vertex& a, const Vertex& b) const { return memcmp(&a, &b, sizeof(Vertex)) == 0; }
+};
+
+/**
+ * @brief Forsyth vertex score: recently used vertices and vertices with few triangles left score high
+ */
+float vertexScore(int32_t cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0)
+        return -1.0f;  // Nothing left to draw with it
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Part of the triangle just emitted: fixed score, so the next one doesn't just reuse its edge
+            score = LAST_TRIANGLE;
+        } else {
+            const float scaler = 1.0f / static_cast<float>(LRU_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CACHE_DECAY);
+        }
+    }
+
+    // Finish off vertices with few triangles left, so they can leave the cache for good
+    return score + VALENCE_BOOST * std::pow(static_cast<float>(remainingTriangles), -VALENCE_EXPONENT);
+}
+
+/**
+ * @brief Which of +X, -X, +Y, -Y, +Z, -Z a normal points closest to (0-5)
+ */
+uint64_t normalDirection(const glm::vec3& normal) {
+    const float x = std::abs(normal.x), y = std::abs(normal.y), z = std::abs(normal.z);
+    const int   axis = x >= y && x >= z ? 0 : (y >= z ? 1 : 2);
+    return static_cast<uint64_t>(axis * 2 + (normal[axis] < 0.0f ? 1 : 0));
+}
+
+/**
+ * @brief One clustering pass: collapse each cell onto its most central vertex
+ * @return Largest distance a vertex moved; the surviving triangles go to outIndices
+ */
+float clusterVertices(const Vertex* vertices, uint32_t vertexCount, const std::vector<uint32_t>& indices,
+                      const glm::vec3& origin, float cellSize, std::vector<uint32_t>& outIndices) {
+    constexpr uint64_t CELL_MASK = (1ull << 20) - 1;  // 20 bits per axis, 3 for the normal direction
+
+    std::unordered_map<uint64_t, uint32_t> cells;
+    std::vector<uint32_t>                  cellOf(vertexCount);
+    std::vector<glm::vec3>                 cellMean;
+    std::vector<uint32_t>                  cellCount;
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const glm::vec3 p = (vertices[v].position - origin) / cellSize;
+        uint64_t        key = normalDirection(vertices[v].normal) << 60;
+        for (int axis = 0; axis < 3; axis++) {
+            const auto cell = static_cast<uint64_t>(std::max(0.0f, p[axis]));
+            key |= std::min(cell, CELL_MASK) << (axis * 20);
+        }
+
+        auto inserted = cells.emplace(key, static_cast<uint32_t>(cellMean.size()));
+        if (inserted.second) {
+            cellMean.push_back(glm::vec3(0.0f));
+            cellCount.push_back(0);
+        }
+        cellOf[v] = inserted.first->second;
+        cellMean[cellOf[v]] += vertices[v].position;
+        cellCount[cellOf[v]]++;
+    }
+
+    // The representative is a real vertex, so the level needs no new vertex data
+    std::vector<uint32_t> representative(cellMean.size(), INVALID_INDEX);
+    std::vector<float>    bestDistance(cellMean.size(), 0.0f);
+    for (size_t c = 0; c < cellMean.size(); c++)
+        cellMean[c] /= static_cast<float>(cellCount[c]);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const uint32_t  c     = cellOf[v];
+        const glm::vec3 delta = vertices[v].position - cellMean[c];
+        const float     d     = glm::dot(delta, delta);
+        if (representative[c] == INVALID_INDEX || d < bestDistance[c]) {
+            representative[c] = v;
+            bestDistance[c]   = d;
+        }
+    }
+
+    float error = 0.0f;
+    for (uint32_t v = 0; v < vertexCount; v++)
+        error = std::max(error, glm::length(vertices[v].position - vertices[representative[cellOf[v]]].position));
+
+    outIndices.clear();
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        const uint32_t a = representative[cellOf[indices[t]]];
+        const uint32_t b = representative[cellOf[indices[t + 1]]];
+        const uint32_t c = representative[cellOf[indices[t + 2]]];
+        if (a == b || b == c || a == c)
+            continue;  // Collapsed
+        outIndices.insert(outIndices.end(), {a, b, c});
+    }
+    return error;
+}
+
+}  // namespace
+
+MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                             std::vector<IndexRange>& ranges) {
+    DP_PROFILE_SCOPE("MeshOptimizer::optimize");
+
+    Stats stats;
+    stats.verticesBefore = vertices.size();
+    if (vertices.empty())
+        return stats;
+
+    std::vector<Vertex>   optimized;
+    std::vector<Vertex>   local;
+    std::vector<uint32_t> localIndices;
+    std::vector<uint32_t> remap;
+    optimized.reserve(vertices.size());
+
+    std::unordered_map<Vertex, uint32_t, VertexBitsHash, VertexBitsEqual> welded;
+
+    size_t triangles    = 0;
+    double missesBefore = 0.0, missesAfter = 0.0;
+
+    for (IndexRange& range : ranges) {
+        range.vertexOffset = static_cast<int32_t>(optimized.size());
+        if (range.indexCount == 0 || range.indexStart + static_cast<size_t>(range.indexCount) > indices.size())
+            continue;
+
+        // A range that is not a triangle list is only welded and remapped
+        uint32_t*    rangeIndices   = indices.data() + range.indexStart;
+        const size_t rangeTriangles = range.indexCount % 3 == 0 ? range.indexCount / 3 : 0;
+        const auto   inputVertices  = static_cast<uint32_t>(vertices.size());
+        missesBefore += averageCacheMissRatio(rangeIndices, range.indexCount, inputVertices) * rangeTriangles;
+
+        // 1. Weld into a range-local vertex list
+        local.clear();
+        welded.clear();
+        localIndices.resize(range.indexCount);
+        for (uint32_t i = 0; i < range.indexCount; i++) {
+            // A malformed index points at the first vertex rather than out of the buffer
+            const Vertex& vertex = rangeIndices[i] < vertices.size() ? vertices[rangeIndices[i]] : vertices.front();
+
+            auto inserted = welded.emplace(vertex, static_cast<uint32_t>(local.size()));
+            if (inserted.second)
+                local.push_back(vertex);
+            localIndices[i] = inserted.first->second;
+        }
+
+        // 2-3. Triangle order: vertex cache first, then overdraw at cluster granularity
+        if (rangeTriangles > 0) {
+            optimizeVertexCache(localIndices, static_cast<uint32_t>(local.size()));
+            optimizeOverdraw(localIndices, local);
+        }
+
+        // 4. Vertex fetch: emit vertices in first-use order, indices relative to the range
+        remap.assign(local.size(), INVALID_INDEX);
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < range.indexCount; i++) {
+            const uint32_t index = localIndices[i];
+            if (remap[index] == INVALID_INDEX) {
+                remap[index] = next++;
+                optimized.push_back(local[index]);
+            }
+            rangeIndices[i] = remap[index];
+        }
+
+        stats.maxRangeVertices = std::max(stats.maxRangeVertices, next);
+        missesAfter += averageCacheMissRatio(rangeIndices, range.indexCount, next) * rangeTriangles;
+        triangles += rangeTriangles;
+    }
+
+    vertices.swap(optimized);
+    stats.verticesAfter = vertices.size();
+    if (triangles > 0) {
+        stats.acmrBefore = static_cast<float>(missesBefore / static_cast<double>(triangles));
+        stats.acmrAfter  = static_cast<float>(missesAfter / static_cast<double>(triangles));
+    }
+    return stats;
+}
+
+std::vector<uint16_t> MeshOptimizer::narrowIndices(const uint32_t* indices, size_t count) {
+    std::vector<uint16_t> narrowed(count);
+    for (size_t i = 0; i < count; i++)
+        narrowed[i] = static_cast<uint16_t>(indices[i]);
+    return narrowed;
+}
+
+std::vector<MeshLod> MeshOptimizer::buildLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                              const IndexRange& range, uint32_t maxLevels) {
+    DP_PROFILE_SCOPE("MeshOptimizer::buildLods");
+
+    std::vector<MeshLod> lods;
+    if (maxLevels == 0 || range.indexCount % 3 != 0 || range.indexCount / 3 < LOD_MIN_TRIANGLES ||
+        range.vertexOffset < 0 || range.indexStart + static_cast<size_t>(range.indexCount) > indices.size()) {
+        return lods;
+    }
+
+    // A copy: appending levels may reallocate `indices`
+    const std::vector<uint32_t> source(indices.begin() + range.indexStart,
+                                       indices.begin() + range.indexStart + range.indexCount);
+    const uint32_t              vertexCount = *std::max_element(source.begin(), source.end()) + 1;
+    if (static_cast<size_t>(range.vertexOffset) + vertexCount > vertices.size())
+        return lods;
+    const Vertex* run = vertices.data() + range.vertexOffset;
+
+    glm::vec3 boundsMin = run[0].position, boundsMax = run[0].position;
+    for (uint32_t v = 1; v < vertexCount; v++) {
+        boundsMin = glm::min(boundsMin, run[v].position);
+        boundsMax = glm::max(boundsMax, run[v].position);
+    }
+    const glm::vec3 extent  = boundsMax - boundsMin;
+    const float     longest = std::max(extent.x, std::max(extent.y, extent.z));
+    if (longest <= 0.0f)
+        return lods;
+
+    std::vector<uint32_t> candidate, best;
+    size_t                previousTriangles = source.size() / 3;
+    float                 previousError     = 0.0f;
+    uint32_t              gridHigh          = LOD_MAX_GRID;
+
+    for (uint32_t level = 0; level < std::min(maxLevels, MAX_MESH_LODS); level++) {
+        // Finest grid that reaches the target: triangles fall (roughly monotonically) as cells grow
+        const size_t target   = previousTriangles / 2;
+        uint32_t     low      = 1;
+        uint32_t     high     = gridHigh;
+        uint32_t     bestGrid = 0;
+        float        error    = 0.0f;
+        best.clear();
+        for (uint32_t step = 0; step < LOD_SEARCH_STEPS && low <= high; step++) {
+            const uint32_t grid      = low + (high - low + 1) / 2;
+            const float    passError = clusterVertices(run, vertexCount, source, boundsMin,
+                                                       longest / static_cast<float>(grid), candidate);
+            if (!candidate.empty() && candidate.size() / 3 <= target) {
+                best.swap(candidate);
+                bestGrid = grid;
+                error    = passError;
+                low      = grid + 1;
+            } else {
+                high = grid - 1;
+            }
+        }
+
+        const size_t triangles = best.size() / 3;
+        if (bestGrid == 0 || static_cast<float>(triangles) > static_cast<float>(previousTriangles) * LOD_MIN_REDUCTION)
+            break;
+
+        optimizeVertexCache(best, vertexCount);
+
+        MeshLod lod;
+        lod.indexStart = static_cast<uint32_t>(indices.size());
+        lod.indexCount = static_cast<uint32_t>(best.size());
+        lod.error      = std::max(error, previousError);  // Keeps selection monotonic in distance
+        indices.insert(indices.end(), best.begin(), best.end());
+        lods.push_back(lod);
+
+        previousTriangles = triangles;
+        previousError     = lod.error;
+        gridHigh          = bestGrid;
+        if (triangles < LOD_MIN_TRIANGLES)
+            break;
+    }
+    return lods;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+
+    // Per-vertex lists of triangles not yet emitted (CSR; the first `remaining[v]` entries are live)
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t index : indices)
+        remaining[index]++;
+
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+
+    std::vector<uint32_t> vertexTriangles(indices.size());
+    std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (size_t k = 0; k < 3; k++)
+            vertexTriangles[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<float> score(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        score[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool>  emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++)
+        triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(LRU_CACHE_SIZE + 3);
+    nextCache.reserve(LRU_CACHE_SIZE + 3);
+
+    uint32_t best   = static_cast<uint32_t>(std::max_element(triangleScore.begin(), triangleScore.end()) -
+                                          triangleScore.begin());
+    size_t   cursor = 0;  // Fallback scan when nothing in the cache has triangles left
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+        if (best == INVALID_INDEX) {
+            while (emitted[cursor])
+                cursor++;
+            best = static_cast<uint32_t>(cursor);
+        }
+
+        const uint32_t* triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+        emitted[best] = true;
+
+        // Retire the triangle from its vertices' live lists
+        for (size_t k = 0; k < 3; k++) {
+            const uint32_t v     = triangle[k];
+            uint32_t*      live  = &vertexTriangles[firstTriangle[v]];
+            uint32_t*      found = std::find(live, live + remaining[v], best);
+            std::swap(*found, live[remaining[v] - 1]);
+            remaining[v]--;
+        }
+
+        // LRU update: the triangle's vertices move to the front
+        nextCache.assign(triangle, triangle + 3);
+        for (uint32_t v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                nextCache.push_back(v);
+        }
+        for (size_t i = LRU_CACHE_SIZE; i < nextCache.size(); i++)
+            score[nextCache[i]] = vertexScore(-1, remaining[nextCache[i]]);
+        nextCache.resize(std::min<size_t>(nextCache.size(), LRU_CACHE_SIZE));
+        cache.swap(nextCache);
+
+        for (size_t i = 0; i < cache.size(); i++)
+            score[cache[i]] = vertexScore(static_cast<int32_t>(i), remaining[cache[i]]);
+
+        // Next triangle: the best one touching the cache
+        best            = INVALID_INDEX;
+        float bestScore = -1.0f;
+        for (uint32_t v : cache) {
+            const uint32_t* live = &vertexTriangles[firstTriangle[v]];
+            for (uint32_t i = 0; i < remaining[v]; i++) {
+                const uint32_t  t = live[i];
+                const uint32_t* c = &indices[t * 3];
+                triangleScore[t]  = score[c[0]] + score[c[1]] + score[c[2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best      = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // Cluster boundaries where the cache order restarts: a triangle with no cached vertex. Moving whole
+    // clusters around keeps the cache behaviour just computed.
+    std::vector<uint32_t> clusterStarts;
+    std::vector<uint32_t> cachedAt(vertices.size(), 0);
+    uint32_t              time = FIFO_CACHE_SIZE + 1;
+    for (size_t t = 0; t < triangleCount; t++) {
+        uint32_t misses = 0;
+        for (size_t k = 0; k < 3; k++) {
+            uint32_t& stamp = cachedAt[indices[t * 3 + k]];
+            if (time - stamp > FIFO_CACHE_SIZE) {
+                stamp = time++;
+                misses++;
+            }
+        }
+        if (misses == 3)
+            clusterStarts.push_back(static_cast<uint32_t>(t));
+    }
+    if (clusterStarts.size() < 2)
+        return;
+    clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+    glm::vec3 meshCenter(0.0f);
+    for (const Vertex& vertex : vertices)
+        meshCenter += vertex.position;
+    meshCenter /= static_cast<float>(vertices.size());
+
+    // Clusters facing away from the centre are likely on the outside and occlude the rest: draw them first
+    const size_t       clusterCount = clusterStarts.size() - 1;
+    std::vector<float> facing(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; c++) {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float     area = 0.0f;
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; t++) {
+            const glm::vec3& p0 = vertices[indices[t * 3]].position;
+            const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+            const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+            const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);  // Length is twice the area
+            const float     a = glm::length(n);
+            centroid += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+
+        const float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f)
+            facing[c] = glm::dot(centroid / area - meshCenter, normal / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return facing[a] > facing[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (uint32_t c : order)
+        sorted.insert(sorted.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    indices.swap(sorted);
+}
+
+float MeshOptimizer::averageCacheMissRatio(const uint32_t* indices, size_t count, uint32_t vertexCount) {
+    if (count < 3)
+        return 0.0f;
+
+    // FIFO: a vertex is cached while fewer than FIFO_CACHE_SIZE misses happened since it was loaded
+    std::vector<uint32_t> cachedAt(vertexCount, 0);
+    uint32_t              time   = FIFO_CACHE_SIZE + 1;
+    uint32_t              misses = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (indices[i] >= vertexCount)
+            continue;
+        uint32_t& stamp = cachedAt[indices[i]];
+        if (time - stamp > FIFO_CACHE_SIZE) {
+            stamp = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(count / 3);
+}
+
+}  // namespace DownPour
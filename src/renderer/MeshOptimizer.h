@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Vertex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Post-load optimization of a model's vertex and index data
+ *
+ * Runs per primitive (index range), in this order:
+ *   1. Weld: bitwise-identical vertices collapse into one.
+ *   2. Vertex cache: triangles are reordered for the post-transform cache
+ *      (Forsyth's linear-speed algorithm, 32-entry LRU model).
+ *   3. Overdraw: the cache-ordered triangles are cut into clusters at cache
+ *      restarts and the clusters sorted outside-in, so the outer surface
+ *      tends to be drawn (and depth-tested against) first.
+ *   4. Vertex fetch: vertices are renumbered in first-use order.
+ *
+ * Afterwards each range references a private, contiguous vertex run and its
+ * indices are relative to that run (draw with the range's vertexOffset). That
+ * is what lets a model with more than 64K vertices in total still use 16-bit
+ * indices. Index counts and starts are unchanged, so existing NamedMesh and
+ * Material ranges stay valid. Vertices no range references are dropped.
+ *
+ * buildLods() then adds simplified levels on top, as extra index ranges.
+ */
+class MeshOptimizer {
+public:
+    /** @brief One primitive's triangles in the shared index buffer */
+    struct IndexRange {
+        uint32_t indexStart   = 0;
+        uint32_t indexCount   = 0;
+        int32_t  vertexOffset = 0;  // Output: first vertex of the range's run
+    };
+
+    struct Stats {
+        size_t   verticesBefore   = 0;
+        size_t   verticesAfter    = 0;
+        float    acmrBefore       = 0.0f;  // Average cache misses per triangle, 16-entry FIFO
+        float    acmrAfter        = 0.0f;
+        uint32_t maxRangeVertices = 0;  // Largest vertex run; <= 65536 means 16-bit indices fit
+    };
+
+    /**
+     * @brief Optimize in place and fill each range's vertexOffset
+     *
+     * `ranges` must not overlap and must cover every index that is drawn: the
+     * vertex array is rebuilt, so indices outside all ranges no longer mean anything.
+     */
+    static Stats optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                          std::vector<IndexRange>& ranges);
+
+    /**
+     * @brief Whether every index of an optimized model fits in 16 bits
+     */
+    static bool fitsUint16(const Stats& stats) { return stats.maxRangeVertices <= 65536; }
+
+    /**
+     * @brief Narrow 32-bit indices already known to fit in 16 bits
+     */
+    static std::vector<uint16_t> narrowIndices(const uint32_t* indices, size_t count);
+
+    /**
+     * @brief Generate up to `maxLevels` simplified levels of one optimized range
+     *
+     * Vertex clustering: vertices snap to a grid and each cell collapses onto the
+     * existing vertex nearest its mean, so every level reuses the range's vertex
+     * run and only adds indices. Cells are also split by dominant normal
+     * direction, which keeps hard edges from folding flat. Each level aims for
+     * half the previous one's triangles; the grid size is searched to get there.
+     * Levels are appended to `indices`, cache-optimized; primitives too small to
+     * gain anything get none.
+     *
+     * Call after optimize(): the range's indices must be relative to its vertexOffset.
+     */
+    static std::vector<MeshLod> buildLods(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                          const IndexRange& range, uint32_t maxLevels);
+
+private:
+    static void  optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+    static void  optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices);
+    static float averageCacheMissRatio(const uint32_t* indices, size_t count, uint32_t vertexCount);
+};
+
+}  // namespace DownPour
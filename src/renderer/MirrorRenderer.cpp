@@ -0,0 +1,346 @@
+// SPDX-License-Identifier: MIT
+#include "MirrorRenderer.h"
+
+#include "core/ResourceManager.h"
+#include "core/SwapChainManager.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+// Push constants of mirror_composite.vert: where each layer lands on screen
+struct CompositeParams {
+    glm::vec4 rects[MirrorRenderer::MAX_VIEWS];
+};
+
+}  // namespace
+
+void MirrorRenderer::init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D viewExtent, uint32_t views,
+                          VkFormat colorFormat, VkFormat depthFormat) {
+    extent    = viewExtent;
+    viewCount = std::clamp(views, 1u, MAX_VIEWS);
+
+    createLayers(device, physicalDevice, colorFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                 VK_IMAGE_ASPECT_COLOR_BIT, colorImage, colorMemory, colorView);
+    createLayers(device, physicalDevice, depthFormat, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                 VK_IMAGE_ASPECT_DEPTH_BIT, depthImage, depthMemory, depthView);
+    createRenderPass(device, colorFormat, depthFormat);
+
+    // Multiview framebuffers have one layer; the view mask addresses the array layers
+    std::array<VkImageView, 2> attachments = {colorView, depthView};
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass      = renderPass;
+    framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferInfo.pAttachments    = attachments.data();
+    framebufferInfo.width           = extent.width;
+    framebufferInfo.height          = extent.height;
+    framebufferInfo.layers          = 1;
+
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror framebuffer");
+}
+
+void MirrorRenderer::queueScenePipelines(const PipelineConfig& base, std::vector<PipelineRequest>& batch) {
+    PipelineConfig config = base;
+    config.vertShader     = "mirror.vert.spv";
+    config.subpass        = 0;
+    config.motionTarget   = false;  // Only the color target here; the motion output is dropped
+
+    config.vertexFormat = VertexFormat::Float;
+    batch.push_back({config, renderPass, &scenePipeline});
+    config.vertexFormat = VertexFormat::Packed;
+    batch.push_back({config, renderPass, &scenePackedPipeline});
+}
+
+void MirrorRenderer::createCompositePipeline(VkDevice device, VkRenderPass mainRenderPass,
+                                             VkPipelineCache pipelineCache) {
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter    = VK_FILTER_LINEAR;
+    samplerInfo.minFilter    = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod       = 0.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror sampler");
+
+    VkDescriptorSetLayoutBinding binding{};
+    binding.binding         = 0;
+    binding.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings    = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror composite descriptor set layout");
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes    = &poolSize;
+    poolInfo.maxSets       = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror composite descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate mirror composite descriptor set");
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler     = sampler;
+    imageInfo.imageView   = colorView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;  // The main pass reads it as FragmentSampled
+
+    VkWriteDescriptorSet write{};
+    write.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet          = set;
+    write.dstBinding      = 0;
+    write.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo      = &imageInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+    VkPushConstantRange range{};
+    range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    range.offset     = 0;
+    range.size       = sizeof(CompositeParams);
+    pipelineLayout   = PipelineFactory::createPipelineLayout(device, {setLayout}, {range});
+
+    // One four-vertex quad per mirror, instanced over the layers; opaque and drawn over everything
+    PipelineConfig config;
+    config.vertShader       = "mirror_composite.vert.spv";
+    config.fragShader       = "mirror_composite.frag.spv";
+    config.layout           = pipelineLayout;
+    config.cullMode         = VK_CULL_MODE_NONE;
+    config.topology         = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    config.enableDepthWrite = false;
+    config.useVertexInput   = false;
+    config.subpass          = SwapChainManager::SUBPASS_COMPOSITE;
+
+    pipeline = PipelineFactory::createPipeline(device, config, mainRenderPass, pipelineCache);
+}
+
+void MirrorRenderer::destroy(VkDevice device) {
+    for (VkPipeline* p : {&pipeline, &scenePipeline, &scenePackedPipeline}) {
+        if (*p != VK_NULL_HANDLE)
+            vkDestroyPipeline(device, *p, nullptr);
+        *p = VK_NULL_HANDLE;
+    }
+    if (pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees `set`
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    if (sampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, sampler, nullptr);
+    if (framebuffer != VK_NULL_HANDLE)
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    if (renderPass != VK_NULL_HANDLE)
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    if (colorView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, colorView, nullptr);
+    if (depthView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, depthView, nullptr);
+    ResourceManager::destroyImage(device, colorImage, colorMemory);
+    ResourceManager::destroyImage(device, depthImage, depthMemory);
+
+    pipelineLayout = VK_NULL_HANDLE;
+    pool           = VK_NULL_HANDLE;
+    set            = VK_NULL_HANDLE;
+    setLayout      = VK_NULL_HANDLE;
+    sampler        = VK_NULL_HANDLE;
+    framebuffer    = VK_NULL_HANDLE;
+    renderPass     = VK_NULL_HANDLE;
+    colorView      = VK_NULL_HANDLE;
+    depthView      = VK_NULL_HANDLE;
+    hasContent     = false;
+}
+
+bool MirrorRenderer::beginFrame(bool visible) {
+    if (!isEnabled() || !visible) {
+        hasContent = false;  // Stale by the time they show again
+        return false;
+    }
+    if (hasContent && ++framesSinceUpdate < UPDATE_INTERVAL)
+        return false;
+
+    framesSinceUpdate = 0;
+    return true;
+}
+
+void MirrorRenderer::beginPass(VkCommandBuffer cmd) const {
+    // Mirrors have no skybox pass; clear to the sky's horizon color instead
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color        = {{0.4f, 0.55f, 0.8f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+
+    VkRenderPassBeginInfo rp{VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    rp.renderPass        = renderPass;
+    rp.framebuffer       = framebuffer;
+    rp.renderArea.offset = {0, 0};
+    rp.renderArea.extent = extent;
+    rp.clearValueCount   = static_cast<uint32_t>(clearValues.size());
+    rp.pClearValues      = clearValues.data();
+    vkCmdBeginRenderPass(cmd, &rp, VK_SUBPASS_CONTENTS_INLINE);
+
+    VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+    VkRect2D   scissor{{0, 0}, extent};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+void MirrorRenderer::endPass(VkCommandBuffer cmd) {
+    vkCmdEndRenderPass(cmd);
+    hasContent = true;
+}
+
+void MirrorRenderer::recordComposite(VkCommandBuffer cmd, VkExtent2D renderExtent,
+                                     const glm::vec4* screenRects) const {
+    if (!hasContent || pipeline == VK_NULL_HANDLE)
+        return;
+
+    CompositeParams params{};
+    std::copy(screenRects, screenRects + viewCount, params.rects);
+
+    VkViewport viewport{
+        0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f};
+    VkRect2D scissor{{0, 0}, renderExtent};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &set, 0, nullptr);
+    vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(params), &params);
+    vkCmdDraw(cmd, 4, viewCount, 0, 0);
+}
+
+VkPipeline MirrorRenderer::getScenePipeline(VertexFormat format) const {
+    return format == VertexFormat::Packed ? scenePackedPipeline : scenePipeline;
+}
+
+void MirrorRenderer::createLayers(VkDevice device, VkPhysicalDevice physicalDevice, VkFormat format,
+                                  VkImageUsageFlags usage, VkImageAspectFlags aspect, VkImage& image,
+                                  Allocation& memory, VkImageView& view) {
+    (void)physicalDevice;  // Memory comes from the shared allocator
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent        = {extent.width, extent.height, 1};
+    imageInfo.mipLevels     = 1;
+    imageInfo.arrayLayers   = viewCount;
+    imageInfo.format        = format;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = usage;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror layers");
+    ResourceManager::allocateImageMemory(device, image, VK_IMAGE_TILING_OPTIMAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                         memory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                           = image;
+    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format                          = format;
+    viewInfo.subresourceRange.aspectMask     = aspect;
+    viewInfo.subresourceRange.baseMipLevel   = 0;
+    viewInfo.subresourceRange.levelCount     = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount     = viewCount;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror layer view");
+}
+
+void MirrorRenderer::createRenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat) {
+    std::array<VkAttachmentDescription, 2> attachments{};
+    attachments[0].format         = colorFormat;
+    attachments[0].samples        = VK_SAMPLE_COUNT_1_BIT;
+    attachments[0].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[0].storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[0].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[0].initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;  // The render graph moves it in
+    attachments[0].finalLayout    = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;  // and out of the pass
+
+    attachments[1].format         = depthFormat;
+    attachments[1].samples        = VK_SAMPLE_COUNT_1_BIT;
+    attachments[1].loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[1].storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[1].finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount    = 1;
+    subpass.pColorAttachments       = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    // The last pass's depth writes finish before the clear; the render graph orders the color layers
+    constexpr VkPipelineStageFlags depthStages =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass    = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass    = 0;
+    dependency.srcStageMask  = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask  = depthStages;
+    dependency.dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // One bit per layer: every draw in the subpass is broadcast to all of them
+    const uint32_t viewMask = (1u << viewCount) - 1;
+
+    VkRenderPassMultiviewCreateInfo multiviewInfo{};
+    multiviewInfo.sType        = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+    multiviewInfo.subpassCount = 1;
+    multiviewInfo.pViewMasks   = &viewMask;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.pNext           = &multiviewInfo;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments    = attachments.data();
+    renderPassInfo.subpassCount    = 1;
+    renderPassInfo.pSubpasses      = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies   = &dependency;
+
+    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create mirror render pass");
+}
+
+}  // namespace DownPour
@@ -0,0 +1,135 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/MemoryAllocator.h"
+#include "core/PipelineFactory.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Rear-view and side mirrors, drawn in one multiview pass and composited over the cockpit view
+ *
+ * Every mirror is one layer of a small color/depth array. The render pass sets
+ * one view mask bit per mirror, so each draw recorded into it reaches every
+ * layer at once (VK_KHR_multiview); mirror.vert picks the layer's
+ * view-projection with gl_ViewIndex. The CPU records the mirror draws once,
+ * from the draw list the main view was culled with (Scene::cullDrawList's
+ * extra views), instead of once per mirror.
+ *
+ * Mirrors re-render every UPDATE_INTERVAL frames; in between, the composite
+ * keeps showing the last image. recordComposite() draws each layer as a quad
+ * in SwapChainManager::SUBPASS_COMPOSITE, after the transparent layers.
+ *
+ * The color target is shared by every frame in flight and imported into the
+ * render graph, which orders the pass after earlier composites' sampling and
+ * moves the layers between attachment and sampled layouts.
+ */
+class MirrorRenderer {
+public:
+    static constexpr uint32_t MAX_VIEWS       = 3;  // Layers; must match mirror.vert and mirror_composite.vert
+    static constexpr uint32_t UPDATE_INTERVAL = 2;  // Frames per mirror update
+
+    MirrorRenderer()  = default;
+    ~MirrorRenderer() = default;
+
+    MirrorRenderer(const MirrorRenderer&)            = delete;
+    MirrorRenderer& operator=(const MirrorRenderer&) = delete;
+
+    /**
+     * @brief Create the layered targets and the multiview render pass
+     *
+     * @param viewExtent Size of each mirror's layer
+     * @param viewCount  Mirrors to render, at most MAX_VIEWS
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D viewExtent, uint32_t viewCount,
+              VkFormat colorFormat, VkFormat depthFormat);
+
+    /**
+     * @brief Queue the scene pipelines, derived from the main opaque pipeline's config, into @p batch
+     *
+     * Keeps @p base's fragment shader, layout and specialization; the vertex
+     * shader becomes mirror.vert and the render pass the multiview one. The
+     * handles are written when the batch runs (PipelineFactory::createPipelines).
+     */
+    void queueScenePipelines(const PipelineConfig& base, std::vector<PipelineRequest>& batch);
+
+    /**
+     * @brief Create the composite pipeline for @p renderPass's composite subpass
+     */
+    void createCompositePipeline(VkDevice device, VkRenderPass renderPass, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    bool isEnabled() const { return renderPass != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Decide whether this frame renders the mirrors; call once per frame
+     * @param visible Whether the mirrors are shown this frame (cockpit view); hidden mirrors are not kept
+     */
+    bool beginFrame(bool visible);
+
+    /**
+     * @brief Begin the multiview pass; record outside any other render pass
+     *
+     * Clears every layer and sets the viewport and scissor to the layer size.
+     */
+    void beginPass(VkCommandBuffer cmd) const;
+
+    /**
+     * @brief End the pass, leaving the layers in COLOR_ATTACHMENT_OPTIMAL
+     */
+    void endPass(VkCommandBuffer cmd);
+
+    /**
+     * @brief Draw each mirror over the cockpit view; record inline in SUBPASS_COMPOSITE
+     *
+     * Does nothing before the first mirror pass.
+     * @param renderExtent Top-left region of the targets the frame rendered into
+     * @param screenRects  getViewCount() rects (x, y, width, height) as fractions of that region
+     */
+    void recordComposite(VkCommandBuffer cmd, VkExtent2D renderExtent, const glm::vec4* screenRects) const;
+
+    VkPipeline   getScenePipeline(VertexFormat format) const;
+    VkRenderPass getRenderPass() const { return renderPass; }
+    VkImage      getColorImage() const { return colorImage; }
+    uint32_t     getViewCount() const { return viewCount; }
+
+private:
+    VkExtent2D  extent    = {0, 0};
+    uint32_t    viewCount = 0;
+    VkImage     colorImage = VK_NULL_HANDLE;
+    Allocation  colorMemory;
+    VkImageView colorView  = VK_NULL_HANDLE;  // All layers
+    VkImage     depthImage = VK_NULL_HANDLE;
+    Allocation  depthMemory;
+    VkImageView depthView = VK_NULL_HANDLE;
+
+    VkRenderPass  renderPass  = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+    VkPipeline scenePipeline       = VK_NULL_HANDLE;
+    VkPipeline scenePackedPipeline = VK_NULL_HANDLE;  // PackedVertex input
+
+    // Composite: the color array sampled once per mirror quad
+    VkSampler             sampler        = VK_NULL_HANDLE;
+    VkDescriptorSetLayout setLayout      = VK_NULL_HANDLE;
+    VkDescriptorPool      pool           = VK_NULL_HANDLE;
+    VkDescriptorSet       set            = VK_NULL_HANDLE;
+    VkPipelineLayout      pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline            pipeline       = VK_NULL_HANDLE;
+
+    uint32_t framesSinceUpdate = 0;
+    bool     hasContent        = false;  // Layers hold a finished mirror pass
+
+    void createLayers(VkDevice device, VkPhysicalDevice physicalDevice, VkFormat format, VkImageUsageFlags usage,
+                      VkImageAspectFlags aspect, VkImage& image, Allocation& memory, VkImageView& view);
+    void createRenderPass(VkDevice device, VkFormat colorFormat, VkFormat depthFormat);
+};
+
+}  // namespace DownPour
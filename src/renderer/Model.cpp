@@ -1,19 +1,319 @@
 #include "Model.h"
 #include "GLTFLoader.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "WorldTiler.h"
 
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace DownPour {
 
+namespace {
+
+Mat4 nodeLocalMatrix(const glTFNode& node) {
+    if (node.matrix != Mat4(1.0f))
+        return node.matrix;
+    return glm::translate(Mat4(1.0f), node.translation) * glm::mat4_cast(node.rotation) *
+           glm::scale(Mat4(1.0f), node.scale);
+}
+
+}  // namespace
+
 void Model::loadFromFile(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice,
-                         VkCommandPool commandPool, VkQueue graphicsQueue) {
+                         const ModelLoadOptions& options) {
+    loadOptions = options;
+
+    // Warm start: the cooked file uploads its geometry straight from the mapping
+    if (MeshCache::load(filepath, *this, device, physicalDevice)) {
+        markStaticNodes();
+        return;
+    }
+
     // Load data from GLTF file using GLTFLoader
-    if (!GLTFLoader::load(filepath, *this)) {
+    std::vector<std::string> dependencies;
+    if (!GLTFLoader::load(filepath, *this, &dependencies)) {
         throw std::runtime_error("Failed to load model: " + filepath);
     }
 
+    // Before optimizing, so the batches get the same vertex cache order and LODs as any primitive
+    if (loadOptions.mergeStatic)
+        mergeStaticGeometry();
+
+    if (loadOptions.optimizeMesh)
+        optimizeGeometry();
+
+    if (loadOptions.tileSize > 0.0f) {
+        tileGeometry();
+        useStreamedGeometry();
+
+        // Tiles stream from the cooked file; only when it cannot be written do they stay in memory
+        if (MeshCache::cook(filepath, *this, dependencies, &tileSourcePath)) {
+            std::vector<Vertex>().swap(vertices);
+            std::vector<uint32_t>().swap(indices);
+        }
+        return;
+    }
+
     // Create Vulkan buffers from loaded geometry
-    geometry.createBuffers(vertices, indices, device, physicalDevice, commandPool, graphicsQueue);
+    if (indexType == VK_INDEX_TYPE_UINT16) {
+        const std::vector<uint16_t> narrowed = MeshOptimizer::narrowIndices(indices.data(), indices.size());
+        createGeometry(vertices.data(), vertices.size(), narrowed.data(), narrowed.size(), device, physicalDevice);
+    } else {
+        createGeometry(vertices.data(), vertices.size(), indices.data(), indices.size(), device, physicalDevice);
+    }
+
+    // Failing to cook only costs the next launch a parse
+    MeshCache::cook(filepath, *this, dependencies);
+}
+
+void Model::optimizeGeometry() {
+    // One range per primitive; GLTFLoader appends each primitive's vertices and indices, so none overlap
+    std::vector<MeshOptimizer::IndexRange> ranges;
+    ranges.reserve(namedMeshes.size());
+    for (const NamedMesh& mesh : namedMeshes)
+        ranges.push_back({mesh.indexStart, mesh.indexCount, 0});
+
+    const MeshOptimizer::Stats stats = MeshOptimizer::optimize(vertices, indices, ranges);
+
+    // Materials carry their primitive's index range, so they share its base vertex
+    for (size_t i = 0; i < namedMeshes.size(); i++) {
+        namedMeshes[i].vertexOffset = ranges[i].vertexOffset;
+        for (Material& material : materials) {
+            if (material.indexStart == namedMeshes[i].indexStart && material.indexCount == namedMeshes[i].indexCount)
+                material.vertexOffset = ranges[i].vertexOffset;
+        }
+    }
+
+    indexType = MeshOptimizer::fitsUint16(stats) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    DP_LOG(Info, "Optimized mesh: %zu -> %zu vertices, ACMR %.2f -> %.2f, %s indices", stats.verticesBefore,
+           stats.verticesAfter, stats.acmrBefore, stats.acmrAfter,
+           indexType == VK_INDEX_TYPE_UINT16 ? "16-bit" : "32-bit");
+
+    // LODs reuse each primitive's vertex run, so they are appended indices only and keep the index type.
+    // Tiled models build theirs per tile instead.
+    if (loadOptions.lodLevels == 0 || loadOptions.tileSize > 0.0f)
+        return;
+    size_t lodCount = 0;
+    for (size_t i = 0; i < namedMeshes.size(); i++) {
+        namedMeshes[i].lods = MeshOptimizer::buildLods(vertices, indices, ranges[i], loadOptions.lodLevels);
+        lodCount += namedMeshes[i].lods.size();
+    }
+    DP_LOG(Info, "Generated %zu LOD levels over %zu primitives (%zu indices in total)", lodCount, namedMeshes.size(),
+           indices.size());
+}
+
+void Model::markStaticNodes() {
+    mergedNodes.assign(nodes.size(), 0);
+    if (!loadOptions.mergeStatic || scenes.empty())
+        return;
+
+    const std::unordered_set<std::string> movable(loadOptions.movableNodes.begin(), loadOptions.movableNodes.end());
+    auto visit = [&](auto& self, int nodeIndex, bool insideMovable) -> void {
+        if (nodeIndex < 0 || nodeIndex >= static_cast<int>(nodes.size()))
+            return;
+        const glTFNode& node   = nodes[nodeIndex];
+        insideMovable          = insideMovable || movable.count(node.name) > 0;
+        mergedNodes[nodeIndex] = !insideMovable && node.meshIndex >= 0;
+        for (int child : node.children)
+            self(self, child, insideMovable);
+    };
+    for (int root : scenes[defaultSceneIndex].rootNodes)
+        visit(visit, root, false);
+}
+
+void Model::mergeStaticGeometry() {
+    markStaticNodes();
+    if (std::find(mergedNodes.begin(), mergedNodes.end(), 1) == mergedNodes.end())
+        return;
+
+    // Root-space transform of every node in the default scene
+    std::vector<Mat4> globals(nodes.size(), Mat4(1.0f));
+    auto              place = [&](auto& self, int nodeIndex, const Mat4& parent) -> void {
+        if (nodeIndex < 0 || nodeIndex >= static_cast<int>(nodes.size()))
+            return;
+        globals[nodeIndex] = parent * nodeLocalMatrix(nodes[nodeIndex]);
+        for (int child : nodes[nodeIndex].children)
+            self(self, child, globals[nodeIndex]);
+    };
+    for (int root : scenes[defaultSceneIndex].rootNodes)
+        place(place, root, Mat4(1.0f));
+
+    struct Batch {
+        uint32_t              material;  // First material of its glTF material; they all look the same
+        std::vector<Vertex>   vertices;
+        std::vector<uint32_t> indices;
+        Vec3                  minBounds = Vec3(std::numeric_limits<float>::max());
+        Vec3                  maxBounds = Vec3(-std::numeric_limits<float>::max());
+    };
+    std::vector<Batch>                     batches;
+    std::unordered_map<int32_t, size_t>    openBatch;  // glTF material -> batch still taking primitives
+    std::unordered_map<uint32_t, uint32_t> remap;      // Source vertex -> batch vertex, per primitive
+    std::vector<uint32_t>                  used;       // Source vertices of the primitive, in first-use order
+    size_t                                 mergedCount = 0;
+
+    for (size_t n = 0; n < nodes.size(); n++) {
+        if (!mergedNodes[n])
+            continue;
+        mergedCount++;
+
+        const Mat4 world   = globals[n];
+        const Mat3 normals = glm::transpose(glm::inverse(Mat3(world)));
+        const bool mirror  = glm::determinant(Mat3(world)) < 0.0f;  // Flips winding
+        for (size_t m = 0; m < materials.size(); m++) {
+            const Material& material = materials[m];
+            if (material.meshIndex != nodes[n].meshIndex || material.indexCount == 0)
+                continue;
+
+            // Collect the primitive's vertices first: a batch is split before it outgrows 16-bit indices
+            remap.clear();
+            used.clear();
+            for (uint32_t i = 0; i < material.indexCount; i++) {
+                const uint32_t source = indices[material.indexStart + i] + material.vertexOffset;
+                if (remap.emplace(source, 0).second)
+                    used.push_back(source);
+            }
+
+            const int32_t key = material.sourceIndex >= 0 ? material.sourceIndex : -1 - static_cast<int32_t>(m);
+            auto          it  = openBatch.find(key);
+            if (it == openBatch.end() || batches[it->second].vertices.size() + used.size() > 65536) {
+                batches.push_back({static_cast<uint32_t>(m), {}, {}});
+                it = openBatch.insert_or_assign(key, batches.size() - 1).first;
+            }
+            Batch& batch = batches[it->second];
+
+            for (uint32_t source : used) {
+                Vertex     vertex = vertices[source];
+                const Vec3 normal = normals * vertex.normal;
+                vertex.position   = Vec3(world * Vec4(vertex.position, 1.0f));
+                vertex.normal     = glm::dot(normal, normal) > 0.0f ? glm::normalize(normal) : vertex.normal;
+                remap[source]     = static_cast<uint32_t>(batch.vertices.size());
+                batch.vertices.push_back(vertex);
+                batch.minBounds = glm::min(batch.minBounds, vertex.position);
+                batch.maxBounds = glm::max(batch.maxBounds, vertex.position);
+            }
+            for (uint32_t i = 0; i + 2 < material.indexCount; i += 3) {
+                const uint32_t* triangle = &indices[material.indexStart + i];
+                const uint32_t  a        = remap[triangle[0] + material.vertexOffset];
+                const uint32_t  b        = remap[triangle[1] + material.vertexOffset];
+                const uint32_t  c        = remap[triangle[2] + material.vertexOffset];
+                batch.indices.insert(batch.indices.end(), {a, mirror ? c : b, mirror ? b : c});
+            }
+        }
+    }
+
+    // A primitive keeps its own range while some node still draws it separately (or no node uses it at all)
+    std::vector<uint8_t> drawnAlone, referenced;
+    for (size_t n = 0; n < nodes.size(); n++) {
+        const int meshIndex = nodes[n].meshIndex;
+        if (meshIndex < 0)
+            continue;
+        if (static_cast<size_t>(meshIndex) >= referenced.size()) {
+            referenced.resize(meshIndex + 1, 0);
+            drawnAlone.resize(meshIndex + 1, 0);
+        }
+        referenced[meshIndex] = 1;
+        drawnAlone[meshIndex] |= mergedNodes[n] ? 0 : 1;
+    }
+    auto keepsRange = [&](uint32_t meshIndex) {
+        return meshIndex >= referenced.size() || !referenced[meshIndex] || drawnAlone[meshIndex];
+    };
+
+    // Compact the index buffer down to the ranges still drawn, then append the batches
+    std::vector<uint32_t> compacted;
+    compacted.reserve(indices.size());
+    for (NamedMesh& mesh : namedMeshes) {
+        const bool     keep  = keepsRange(mesh.meshIndex);
+        const uint32_t start = static_cast<uint32_t>(compacted.size());
+        for (Material& material : materials) {
+            if (material.meshIndex == static_cast<int32_t>(mesh.meshIndex) &&
+                material.primitiveIndex == static_cast<int32_t>(mesh.primitiveIndex)) {
+                material.indexStart = start + (material.indexStart - mesh.indexStart);
+                material.indexCount = keep ? material.indexCount : 0;
+            }
+        }
+        if (keep)
+            compacted.insert(compacted.end(), indices.begin() + mesh.indexStart,
+                             indices.begin() + mesh.indexStart + mesh.indexCount);
+        mesh.indexStart = start;
+        mesh.indexCount = keep ? mesh.indexCount : 0;
+    }
+    indices.swap(compacted);
+
+    size_t mergedTriangles = 0;
+    for (size_t b = 0; b < batches.size(); b++) {
+        Batch&         batch      = batches[b];
+        const uint32_t baseVertex = static_cast<uint32_t>(vertices.size());
+        vertices.insert(vertices.end(), batch.vertices.begin(), batch.vertices.end());
+
+        NamedMesh mesh;
+        mesh.name           = "static_batch_" + std::to_string(b);
+        mesh.meshIndex      = STATIC_BATCH_MESH_INDEX;
+        mesh.primitiveIndex = batch.material;
+        mesh.indexStart     = static_cast<uint32_t>(indices.size());
+        mesh.indexCount     = static_cast<uint32_t>(batch.indices.size());
+        mesh.minBounds      = batch.minBounds;
+        mesh.maxBounds      = batch.maxBounds;
+        for (uint32_t index : batch.indices)
+            indices.push_back(baseVertex + index);
+        namedMeshes.push_back(mesh);
+
+        // Baked positions can leave the raw vertex bounds; packed vertices quantize over these
+        minBounds = glm::min(minBounds, batch.minBounds);
+        maxBounds = glm::max(maxBounds, batch.maxBounds);
+        mergedTriangles += batch.indices.size() / 3;
+    }
+
+    DP_LOG(Info, "Merged %zu static nodes into %zu batches (%zu triangles)", mergedCount, batches.size(),
+           mergedTriangles);
+}
+
+void Model::tileGeometry() {
+    // Every drawn range becomes a section: materials when there are any, else primitives (drawn untextured)
+    std::vector<WorldTiler::Section> sections;
+    if (!materials.empty()) {
+        for (size_t i = 0; i < materials.size(); i++) {
+            const Material& material = materials[i];
+            sections.push_back({static_cast<uint32_t>(i), material.indexStart, material.indexCount,
+                                material.vertexOffset});
+        }
+    } else {
+        for (const NamedMesh& mesh : namedMeshes)
+            sections.push_back({WORLD_TILE_NO_MATERIAL, mesh.indexStart, mesh.indexCount, mesh.vertexOffset});
+    }
+
+    const uint32_t lodLevels       = loadOptions.optimizeMesh ? loadOptions.lodLevels : 0;
+    uint32_t       maxTileVertices = 0;
+    tiles = WorldTiler::split(vertices, indices, sections, loadOptions.tileSize, lodLevels, maxTileVertices);
+
+    indexType = maxTileVertices <= 65536 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    DP_LOG(Info, "Tiled mesh into %zu tiles of %.0f units (largest %u vertices, %s indices)", tiles.size(),
+           loadOptions.tileSize, maxTileVertices, indexType == VK_INDEX_TYPE_UINT16 ? "16-bit" : "32-bit");
+}
+
+void Model::useStreamedGeometry() {
+    geometry.setVertexFormat(loadOptions.vertexFormat, VertexQuantization::fromBounds(minBounds, maxBounds));
+}
+
+void Model::createGeometry(const Vertex* vertexData, size_t vertexCount, const void* indexData, size_t indexCount,
+                           VkDevice device, VkPhysicalDevice physicalDevice) {
+    const VertexFormat vertexFormat = loadOptions.vertexFormat;
+
+    // The cache always holds float vertices, so either format can come from it
+    if (vertexFormat == VertexFormat::Packed) {
+        const Vec3  extent = maxBounds - minBounds;
+        const float step   = std::max(extent.x, std::max(extent.y, extent.z)) / 65535.0f;
+        DP_LOG(Info, "Packing %zu vertices (position step %.5f model units)", vertexCount, step);
+    }
+
+    geometry.setVertexFormat(vertexFormat, VertexQuantization::fromBounds(minBounds, maxBounds));
+    geometry.createBuffers(vertexData, vertexCount, indexData, indexCount, indexType, device, physicalDevice);
 }
 
 void Model::cleanup(VkDevice device) {
@@ -33,6 +333,30 @@ uint32_t Model::getIndexCount() const {
     return geometry.getIndexCount();
 }
 
+VkIndexType Model::getIndexType() const {
+    return geometry.getIndexType();
+}
+
+VertexFormat Model::getVertexFormat() const {
+    return geometry.getVertexFormat();
+}
+
+const VertexQuantization& Model::getVertexQuantization() const {
+    return geometry.getVertexQuantization();
+}
+
+void Model::getDequantization(Vec4& outOffset, Vec4& outScale) const {
+    if (geometry.getVertexFormat() != VertexFormat::Packed) {
+        outOffset = Vec4(0.0f);
+        outScale  = Vec4(1.0f, 1.0f, 1.0f, 0.0f);
+        return;
+    }
+
+    const VertexQuantization& quantization = geometry.getVertexQuantization();
+    outOffset                              = Vec4(quantization.offset, 1.0f);
+    outScale                               = Vec4(quantization.scale, 0.0f);
+}
+
 glm::mat4 Model::getModelMatrix() const {
     return this->modelMatrix;
 }
@@ -97,16 +421,7 @@ void Model::getHierarchyBounds(glm::vec3& minOut, glm::vec3& maxOut) const {
     auto traverse = [&](auto& self, int nodeIdx, const glm::mat4& parentMatrix) -> void {
         const auto& node = nodes[nodeIdx];
 
-        // Compute local matrix
-        glm::mat4 localMatrix;
-        if (node.matrix != glm::mat4(1.0f)) {
-            localMatrix = node.matrix;
-        } else {
-            localMatrix = glm::translate(glm::mat4(1.0f), node.translation) * glm::mat4_cast(node.rotation) *
-                          glm::scale(glm::mat4(1.0f), node.scale);
-        }
-
-        glm::mat4 globalMatrix = parentMatrix * localMatrix;
+        glm::mat4 globalMatrix = parentMatrix * nodeLocalMatrix(node);
 
         // If node has a mesh, transform its bounding boxes
         if (node.meshIndex >= 0) {
@@ -155,6 +470,10 @@ void Model::getHierarchyBounds(glm::vec3& minOut, glm::vec3& maxOut) const {
     }
 }
 
+const std::vector<NamedMesh>& Model::getNamedMeshes() const {
+    return namedMeshes;
+}
+
 std::vector<std::string> Model::getMeshNames() const {
     std::vector<std::string> names;
     names.reserve(namedMeshes.size());
@@ -193,6 +512,69 @@ bool Model::getMeshIndexRange(const std::string& name, uint32_t& outStart, uint3
     return false;
 }
 
+bool Model::getPrimitiveBounds(uint32_t meshIndex, uint32_t primitiveIndex, glm::vec3& outMin,
+                               glm::vec3& outMax) const {
+    for (const auto& mesh : namedMeshes) {
+        if (mesh.meshIndex == meshIndex && mesh.primitiveIndex == primitiveIndex) {
+            outMin = mesh.minBounds;
+            outMax = mesh.maxBounds;
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::vector<WorldTile>& Model::getTiles() const {
+    return tiles;
+}
+
+bool Model::readTile(size_t tileIndex, std::vector<Vertex>& outVertices, std::vector<unsigned char>& outIndices) const {
+    if (tileIndex >= tiles.size())
+        return false;
+    const WorldTile& tile = tiles[tileIndex];
+    if (!tileSourcePath.empty())
+        return MeshCache::readTile(tileSourcePath, tile, outVertices, outIndices);
+
+    // Never cooked: the tiled geometry stayed in memory
+    if (tile.firstVertex + static_cast<size_t>(tile.vertexCount) > vertices.size() ||
+        tile.firstIndex + static_cast<size_t>(tile.indexCount) > indices.size()) {
+        return false;
+    }
+    outVertices.assign(vertices.begin() + tile.firstVertex, vertices.begin() + tile.firstVertex + tile.vertexCount);
+
+    const uint32_t* tileIndices = indices.data() + tile.firstIndex;
+    if (indexType == VK_INDEX_TYPE_UINT16) {
+        const std::vector<uint16_t> narrowed = MeshOptimizer::narrowIndices(tileIndices, tile.indexCount);
+        outIndices.resize(narrowed.size() * sizeof(uint16_t));
+        memcpy(outIndices.data(), narrowed.data(), outIndices.size());
+    } else {
+        outIndices.resize(static_cast<size_t>(tile.indexCount) * sizeof(uint32_t));
+        memcpy(outIndices.data(), tileIndices, outIndices.size());
+    }
+    return true;
+}
+
+std::vector<const NamedMesh*> Model::getStaticBatches() const {
+    std::vector<const NamedMesh*> batches;
+    for (const NamedMesh& mesh : namedMeshes) {
+        if (mesh.meshIndex == STATIC_BATCH_MESH_INDEX)
+            batches.push_back(&mesh);
+    }
+    return batches;
+}
+
+bool Model::isNodeMerged(int nodeIndex) const {
+    return nodeIndex >= 0 && static_cast<size_t>(nodeIndex) < mergedNodes.size() && mergedNodes[nodeIndex] != 0;
+}
+
+const NamedMesh* Model::findPrimitive(uint32_t meshIndex, uint32_t primitiveIndex) const {
+    for (const auto& mesh : namedMeshes) {
+        if (mesh.meshIndex == meshIndex && mesh.primitiveIndex == primitiveIndex)
+            return &mesh;
+    }
+    return nullptr;
+}
+
 // Hierarchy accessors
 const std::vector<glTFNode>& Model::getNodes() const {
     return nodes;
@@ -42,6 +42,36 @@ struct glTFScene {
     std::vector<int> rootNodes;
 };
 
+/**
+ * @brief How Model::loadFromFile prepares geometry for the GPU
+ */
+struct ModelLoadOptions {
+    /**
+     * GPU vertex layout; Packed quantizes positions over the model's AABB, so
+     * keep it for compact models (a car), not kilometre-long ones (the road)
+     */
+    VertexFormat vertexFormat = VertexFormat::Float;
+
+    /** Run MeshOptimizer after parsing (weld, cache/overdraw order, 16-bit indices when they fit) */
+    bool optimizeMesh = true;
+
+    /** Simplified levels per primitive, up to MAX_MESH_LODS; 0 disables. Needs optimizeMesh */
+    uint32_t lodLevels = MAX_MESH_LODS;
+
+    /**
+     * > 0: split the geometry into square tiles this many model units wide and
+     * stream them (WorldStreamer) instead of uploading one resident buffer
+     */
+    float tileSize = 0.0f;
+
+    /**
+     * Pre-transform the meshes of every node outside the movableNodes subtrees
+     * and merge them into one range per material (Model::getStaticBatches())
+     */
+    bool                     mergeStatic = false;
+    std::vector<std::string> movableNodes;  // glTF node names whose subtrees animate (CarEntity roles)
+};
+
 /**
  * @brief Model class for loading and rendering GLTF models
  *
@@ -62,14 +92,16 @@ public:
      * Extracts geometry and material definitions from the model file.
      * Does NOT create GPU resources - use MaterialManager for that.
      *
+     * Uses the cooked copy in MeshCache when it matches the source, and
+     * cooks one (after optimization) otherwise.
+     *
      * @param filepath Path to the GLTF/GLB file
      * @param device Vulkan logical device (for geometry buffers)
      * @param physicalDevice Vulkan physical device
-     * @param commandPool Command pool for buffer operations
-     * @param graphicsQueue Graphics queue for command submission
+     * @param options Vertex format and optimization
      */
     void loadFromFile(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice,
-                      VkCommandPool commandPool, VkQueue graphicsQueue);
+                      const ModelLoadOptions& options = {});
 
     /**
      * @brief Clean up Vulkan geometry resources
@@ -79,16 +111,65 @@ public:
     void cleanup(VkDevice device);
 
     // Geometry accessors
-    VkBuffer getVertexBuffer() const;
-    VkBuffer getIndexBuffer() const;
-    uint32_t getIndexCount() const;
+    VkBuffer     getVertexBuffer() const;
+    VkBuffer     getIndexBuffer() const;
+    uint32_t     getIndexCount() const;
+    VkIndexType  getIndexType() const;
+    VertexFormat getVertexFormat() const;
+
+    const VertexQuantization& getVertexQuantization() const;
 
-    // Mesh queries
+    /**
+     * @brief Per-draw shader constants that decode this model's vertex buffer (ObjectData)
+     *
+     * position = offset.xyz + stored * scale.xyz; offset.w = 1 marks octahedral normals.
+     * Identity for VertexFormat::Float.
+     */
+    void getDequantization(Vec4& outOffset, Vec4& outScale) const;
+
+    // Mesh queries (draw a range with its NamedMesh::vertexOffset)
     std::vector<std::string> getMeshNames() const;
     bool                     getMeshByName(const std::string& name, NamedMesh& outMesh) const;
     std::vector<NamedMesh>   getMeshesByPrefix(const std::string& prefix) const;
     bool                     getMeshIndexRange(const std::string& name, uint32_t& outStart, uint32_t& outCount) const;
 
+    /** @brief Every primitive's range, in glTF mesh/primitive order */
+    const std::vector<NamedMesh>& getNamedMeshes() const;
+
+    /**
+     * @brief Get the local-space bounds of one mesh primitive
+     * @return false if the model has no such primitive
+     */
+    bool getPrimitiveBounds(uint32_t meshIndex, uint32_t primitiveIndex, Vec3& outMin, Vec3& outMax) const;
+
+    /**
+     * @brief Find one mesh primitive's range (and its LODs)
+     * @return nullptr if the model has no such primitive
+     */
+    const NamedMesh* findPrimitive(uint32_t meshIndex, uint32_t primitiveIndex) const;
+
+    /**
+     * @brief Merged static geometry (ModelLoadOptions::mergeStatic), one range per material
+     *
+     * Vertices are already in the default scene's root space, so draw these with
+     * the transform the glTF roots get. primitiveIndex is the material index.
+     */
+    std::vector<const NamedMesh*> getStaticBatches() const;
+
+    /** @brief Whether a glTF node's mesh is drawn through a static batch instead of on its own */
+    bool isNodeMerged(int nodeIndex) const;
+
+    // Tiled models (ModelLoadOptions::tileSize): no resident buffers, and material/mesh index ranges do not apply
+    bool                          isTiled() const { return !tiles.empty(); }
+    float                         getTileSize() const { return loadOptions.tileSize; }
+    const std::vector<WorldTile>& getTiles() const;
+
+    /**
+     * @brief Fetch one tile's vertices and indices (getIndexType() width); thread-safe
+     * @return false if the tile data could not be read
+     */
+    bool readTile(size_t tileIndex, std::vector<Vertex>& outVertices, std::vector<unsigned char>& outIndices) const;
+
     // Transform
     Mat4 getModelMatrix() const;
     void setModelMatrix(const Mat4& matrix);
@@ -126,15 +207,18 @@ public:
     bool                          hasHierarchy() const;
 
 private:
-    // Allow GLTFLoader to populate private data
+    // Allow GLTFLoader and MeshCache to populate private data
     friend class GLTFLoader;
+    friend class MeshCache;
 
-    // Geometry data
+    // Geometry data (left empty when loaded from a cooked mesh file)
     std::vector<Vertex>   vertices;
     std::vector<uint32_t> indices;
+    VkIndexType           indexType = VK_INDEX_TYPE_UINT32;  // GPU/cooked width; `indices` is always 32-bit
 
     // Vulkan geometry resources
-    ModelGeometry geometry;
+    ModelGeometry    geometry;
+    ModelLoadOptions loadOptions;
 
     // Material definitions (NEW: pure data, no GPU resources)
     std::vector<Material> materials;
@@ -149,10 +233,47 @@ private:
     // Named meshes
     std::vector<NamedMesh> namedMeshes;
 
+    // World tiles; read from tileSourcePath (the cooked file), or from `vertices`/`indices` when it is empty
+    std::vector<WorldTile> tiles;
+    std::string            tileSourcePath;
+
     // Hierarchy data (NEW: extracted from glTF)
     std::vector<glTFNode>  nodes;
     std::vector<glTFScene> scenes;
     int                    defaultSceneIndex = 0;
+    std::vector<uint8_t>   mergedNodes;  // Per node: mesh lives in a static batch
+
+    /**
+     * @brief Run MeshOptimizer over the parsed geometry and rebase mesh/material ranges
+     */
+    void optimizeGeometry();
+
+    /**
+     * @brief Fill mergedNodes: nodes with a mesh in the default scene and outside every movable subtree
+     */
+    void markStaticNodes();
+
+    /**
+     * @brief Bake merged nodes into per-material batches and drop ranges nothing draws any more
+     */
+    void mergeStaticGeometry();
+
+    /**
+     * @brief Rearrange the geometry into tiles of loadOptions.tileSize (WorldTiler)
+     */
+    void tileGeometry();
+
+    /**
+     * @brief Set up a tiled model's vertex format without uploading anything; tiles upload in it
+     */
+    void useStreamedGeometry();
+
+    /**
+     * @brief Upload geometry in the requested vertex format (bounds must already be set)
+     * @param indexData indexCount values of the model's indexType
+     */
+    void createGeometry(const Vertex* vertexData, size_t vertexCount, const void* indexData, size_t indexCount,
+                        VkDevice device, VkPhysicalDevice physicalDevice);
 };
 
 }  // namespace DownPour
\ No newline at end of file
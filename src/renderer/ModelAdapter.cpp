@@ -1,14 +1,54 @@
 // SPDX-License-Identifier: MIT
 #include "ModelAdapter.h"
 
+#include "core/BinaryIO.h"
 #include "logger/Logger.h"
+#include "scene/SceneBuilder.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 
 namespace DownPour {
 
+namespace {
+
+void putStrings(BlobWriter& out, const std::vector<std::string>& values) {
+    out.put(static_cast<uint32_t>(values.size()));
+    for (const std::string& value : values)
+        out.putString(value);
+}
+
+std::vector<std::string> getStrings(BlobReader& in) {
+    std::vector<std::string> values(in.getCount(sizeof(uint32_t)));
+    for (std::string& value : values)
+        value = in.getString();
+    return values;
+}
+
+template <typename T>
+void putNamed(BlobWriter& out, const std::unordered_map<std::string, T>& values) {
+    out.put(static_cast<uint32_t>(values.size()));
+    for (const auto& [name, value] : values) {
+        out.putString(name);
+        out.put(value);
+    }
+}
+
+template <typename T>
+std::unordered_map<std::string, T> getNamed(BlobReader& in) {
+    std::unordered_map<std::string, T> values;
+    const uint32_t                     count = in.getCount(sizeof(uint32_t) + sizeof(T));
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name = in.getString();
+        values[name]     = in.get<T>();
+    }
+    return values;
+}
+
+}  // namespace
+
 ModelAdapter::~ModelAdapter() {
     // Note: Model pointer might be managed by DownPourApplication or ModelAdapter
     // For now, let's assume ModelAdapter owns it if we created it here.
@@ -18,20 +58,26 @@ ModelAdapter::~ModelAdapter() {
     }
 }
 
-bool ModelAdapter::load(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice,
-                        VkCommandPool commandPool, VkQueue graphicsQueue) {
-    Log logger;
-    logger.log("info", "Loading model via adapter: " + filepath);
+bool ModelAdapter::load(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice) {
+    DP_LOG(Info, "Loading model via adapter: %s", filepath.c_str());
+    sourcePath = filepath;
+
+    // Metadata first: it selects how the geometry is prepared and uploaded. A scene snapshot
+    // holds it already parsed, so the sidecar is only read again once it or the model changed
+    if (!sceneCache.load(filepath) || !readConfig(sceneCache.getConfig())) {
+        sceneCache.clear();
+        hasSidecar = loadMetadata(filepath);
+    }
+    const bool hasMetadata = hasSidecar;
 
     model = new Model();
     try {
-        model->loadFromFile(filepath, device, physicalDevice, commandPool, graphicsQueue);
+        model->loadFromFile(filepath, device, physicalDevice, loadOptions);
     } catch (const std::exception& e) {
         return false;
     }
 
-    // Attempt to load metadata
-    if (!loadMetadata(filepath)) {
+    if (!hasMetadata) {
         // Default target length from hierarchy if missing
         glm::vec3 minB, maxB;
         model->getHierarchyBounds(minB, maxB);
@@ -47,8 +93,7 @@ bool ModelAdapter::loadMetadata(const std::string& filepath) {
         return false;
     }
 
-    Log logger;
-    logger.log("info", "Loading rich metadata: " + jsonPath);
+    DP_LOG(Info, "Loading rich metadata: %s", jsonPath.c_str());
 
     try {
         std::ifstream  f(jsonPath);
@@ -87,6 +132,33 @@ bool ModelAdapter::loadMetadata(const std::string& filepath) {
             if (m.contains("positionOffset") && m["positionOffset"].is_array() && m["positionOffset"].size() == 3) {
                 positionOffset = Vec3(m["positionOffset"][0], m["positionOffset"][1], m["positionOffset"][2]);
             }
+
+            // "packed" halves vertex fetch; positions quantize over the model's bounds
+            if (m.contains("vertexFormat"))
+                loadOptions.vertexFormat = m["vertexFormat"] == "packed" ? VertexFormat::Packed : VertexFormat::Float;
+
+            // Mesh optimization is on unless the sidecar opts out (e.g. to inspect the raw glTF order)
+            loadOptions.optimizeMesh = m.value("optimizeMesh", true);
+
+            // Simplified levels per primitive for distant draws; 0 keeps full detail only
+            loadOptions.lodLevels = std::min(m.value("lodLevels", MAX_MESH_LODS), MAX_MESH_LODS);
+
+            // Bake everything no role animates into one draw per material
+            loadOptions.mergeStatic = m.value("mergeStatic", false);
+        }
+
+        // --- 1b. World Streaming ---
+        // A tileSize cuts the model into tiles at cook time; only those near the car stay resident
+        if (data.contains("streaming")) {
+            auto s                = data["streaming"];
+            loadOptions.tileSize  = std::max(s.value("tileSize", 0.0f), 0.0f);
+            auto& sc              = streamingConfig;
+            sc.loadRadius         = s.value("loadRadius", sc.loadRadius);
+            sc.evictRadius        = s.value("evictRadius", sc.evictRadius);
+            sc.prefetchSeconds    = s.value("prefetchSeconds", sc.prefetchSeconds);
+            sc.vramBudget         = s.value("vramBudgetMB", sc.vramBudget >> 20) << 20;
+            sc.ramBudget          = s.value("ramBudgetMB", sc.ramBudget >> 20) << 20;
+            sc.maxUploadsPerFrame = std::max(s.value("maxUploadsPerFrame", sc.maxUploadsPerFrame), 1u);
         }
 
         // --- 2. Camera Configuration ---
@@ -216,7 +288,8 @@ bool ModelAdapter::loadMetadata(const std::string& filepath) {
                     if (j.contains("color") && j["color"].size() == 3) {
                         out.color = Vec3(j["color"][0], j["color"][1], j["color"][2]);
                     }
-                    out.range = j.value("range", 50.0f);
+                    out.range     = j.value("range", 50.0f);
+                    out.spotAngle = j.value("spotAngle", 45.0f);
                 };
                 if (l.contains("headlights"))
                     parseLight(l["headlights"], lightsConfig.headlights);
@@ -292,13 +365,185 @@ bool ModelAdapter::loadMetadata(const std::string& filepath) {
             debugConfig.hasData            = true;
         }
 
+        // Role nodes move at runtime, so their subtrees stay out of the static batches
+        if (loadOptions.mergeStatic) {
+            loadOptions.movableNodes.clear();
+            for (const auto& [role, nodeName] : roleMap)
+                loadOptions.movableNodes.push_back(nodeName);
+            std::sort(loadOptions.movableNodes.begin(), loadOptions.movableNodes.end());
+        }
+
         return true;
     } catch (const std::exception& e) {
-        logger.log("error", "Error parsing metadata " + jsonPath + ": " + e.what());
+        DP_LOG(Error, "Error parsing metadata %s: %s", jsonPath.c_str(), e.what());
         return false;
     }
 }
 
+std::vector<NodeHandle> ModelAdapter::buildScene(Scene* scene,
+                                                 const std::unordered_map<size_t, uint32_t>& materialIds) {
+    if (!scene || !model)
+        return {};
+
+    std::vector<NodeHandle> roots;
+    const bool              restored = sceneCache.instantiate(*scene, *model, materialIds, roots, roleNodes);
+    sceneCache.clear();  // Only needed once
+    if (restored)
+        return roots;
+
+    roots = SceneBuilder::buildFromModel(scene, model, materialIds);
+
+    roleNodes.clear();
+    for (const auto& [role, nodeName] : roleMap) {
+        if (NodeHandle node = scene->findNode(nodeName); node.isValid())
+            roleNodes[role] = node;
+    }
+
+    // Failing to save only costs the next launch a build
+    BlobWriter config;
+    writeConfig(config);
+    SceneCache::save(sourcePath, *scene, *model, roots, materialIds, roleNodes, config.getData());
+    return roots;
+}
+
+NodeHandle ModelAdapter::getRoleNode(const std::string& role) const {
+    auto it = roleNodes.find(role);
+    return it != roleNodes.end() ? it->second : NodeHandle{};
+}
+
+void ModelAdapter::writeConfig(BlobWriter& out) const {
+    out.put(static_cast<uint8_t>(hasSidecar));
+    out.put(targetLength);
+    out.put(modelRotation);
+    out.put(modelScale);
+    out.put(positionOffset);
+
+    out.put(loadOptions.vertexFormat);
+    out.put(static_cast<uint8_t>(loadOptions.optimizeMesh));
+    out.put(loadOptions.lodLevels);
+    out.put(loadOptions.tileSize);
+    out.put(static_cast<uint8_t>(loadOptions.mergeStatic));
+    putStrings(out, loadOptions.movableNodes);
+    out.put(streamingConfig);
+
+    out.put(cameraConfig);
+    out.put(windshieldConfig);
+
+    out.put(wheelConfig.radius);
+    out.put(wheelConfig.width);
+    out.put(wheelConfig.rotationAxis);
+    putNamed(out, wheelConfig.wheels);
+    out.put(static_cast<uint8_t>(wheelConfig.hasData));
+
+    out.put(steeringWheelConfig);
+
+    out.put(doorsConfig.openAngle);
+    out.put(doorsConfig.openSpeed);
+    out.put(doorsConfig.rotationAxis);
+    putNamed(out, doorsConfig.doors);
+    out.put(static_cast<uint8_t>(doorsConfig.hasData));
+
+    out.put(lightsConfig);
+
+    out.put(animationConfig.idleAnimations);
+    out.put(animationConfig.turnSignals.blinkFrequency);
+    putStrings(out, animationConfig.turnSignals.leftNodes);
+    putStrings(out, animationConfig.turnSignals.rightNodes);
+    out.put(static_cast<uint8_t>(animationConfig.hasData));
+
+    out.put(physics);
+    out.put(spawnConfig);
+    out.put(debugConfig);
+
+    out.put(static_cast<uint32_t>(roleMap.size()));
+    for (const auto& [role, nodeName] : roleMap) {
+        out.putString(role);
+        out.putString(nodeName);
+    }
+}
+
+bool ModelAdapter::readConfig(const std::vector<unsigned char>& blob) {
+    // Read everything first: a damaged blob must leave the defaults for loadMetadata()
+    BlobReader in(blob.data(), blob.size());
+
+    const bool readSidecar        = in.get<uint8_t>() != 0;
+    const auto readTargetLength   = in.get<float>();
+    const auto readModelRotation  = in.get<Vec3>();
+    const auto readModelScale     = in.get<Vec3>();
+    const auto readPositionOffset = in.get<Vec3>();
+
+    ModelLoadOptions options;
+    options.vertexFormat = in.get<VertexFormat>();
+    options.optimizeMesh = in.get<uint8_t>() != 0;
+    options.lodLevels    = in.get<uint32_t>();
+    options.tileSize     = in.get<float>();
+    options.mergeStatic  = in.get<uint8_t>() != 0;
+    options.movableNodes = getStrings(in);
+    const auto streaming = in.get<WorldStreamingConfig>();
+
+    const auto camera     = in.get<CameraConfig>();
+    const auto windshield = in.get<WindshieldConfig>();
+
+    WheelConfig wheel;
+    wheel.radius       = in.get<float>();
+    wheel.width        = in.get<float>();
+    wheel.rotationAxis = in.get<Vec3>();
+    wheel.wheels       = getNamed<WheelConfig::Individual>(in);
+    wheel.hasData      = in.get<uint8_t>() != 0;
+
+    const auto steeringWheel = in.get<SteeringWheelConfig>();
+
+    DoorsConfig doors;
+    doors.openAngle    = in.get<float>();
+    doors.openSpeed    = in.get<float>();
+    doors.rotationAxis = in.get<Vec3>();
+    doors.doors        = getNamed<DoorsConfig::Individual>(in);
+    doors.hasData      = in.get<uint8_t>() != 0;
+
+    const auto lights = in.get<LightsConfig>();
+
+    AnimationConfig animation;
+    animation.idleAnimations             = in.get<AnimationConfig::IdleAnimations>();
+    animation.turnSignals.blinkFrequency = in.get<float>();
+    animation.turnSignals.leftNodes      = getStrings(in);
+    animation.turnSignals.rightNodes     = getStrings(in);
+    animation.hasData                    = in.get<uint8_t>() != 0;
+
+    const auto readPhysics = in.get<PhysicsConfig>();
+    const auto spawn       = in.get<SpawnConfig>();
+    const auto debug       = in.get<DebugConfig>();
+
+    std::unordered_map<std::string, std::string> roles;
+    const uint32_t                               roleCount = in.getCount(sizeof(uint32_t) * 2);
+    for (uint32_t i = 0; i < roleCount; i++) {
+        std::string role = in.getString();
+        roles[role]      = in.getString();
+    }
+
+    if (!in.atEnd())
+        return false;
+
+    hasSidecar          = readSidecar;
+    targetLength        = readTargetLength;
+    modelRotation       = readModelRotation;
+    modelScale          = readModelScale;
+    positionOffset      = readPositionOffset;
+    loadOptions         = std::move(options);
+    streamingConfig     = streaming;
+    cameraConfig        = camera;
+    windshieldConfig    = windshield;
+    wheelConfig         = std::move(wheel);
+    steeringWheelConfig = steeringWheel;
+    doorsConfig         = std::move(doors);
+    lightsConfig        = lights;
+    animationConfig     = std::move(animation);
+    physics             = readPhysics;
+    spawnConfig         = spawn;
+    debugConfig         = debug;
+    roleMap             = std::move(roles);
+    return true;
+}
+
 std::string ModelAdapter::getNodeNameForRole(const std::string& role) const {
     auto it = roleMap.find(role);
     if (it != roleMap.end()) {
@@ -3,6 +3,8 @@
 
 #include "../core/Types.h"
 #include "Model.h"
+#include "WorldStreamer.h"
+#include "scene/SceneCache.h"
 
 #include <json.hpp>
 #include <string>
@@ -12,11 +14,17 @@
 namespace DownPour {
 using namespace Types;
 
+class BlobWriter;
+
 /**
  * @brief Adapter for loading models with external configuration (JSON sidecar)
  *
  * This handles the loading of both GLB/GLTF geometry and its associated
  * metadata (roles, physical properties, target dimensions).
+ *
+ * Once buildScene() has run, the next launch restores the parsed sidecar,
+ * the scene nodes and the role handles from a SceneCache snapshot instead,
+ * for as long as neither the model nor the sidecar changes.
  */
 class ModelAdapter {
 public:
@@ -27,8 +35,7 @@ public:
      * @brief Load model and optional sidecar configuration
      * @param filepath Path to .gltf or .glb file
      */
-    bool load(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-              VkQueue graphicsQueue);
+    bool load(const std::string& filepath, VkDevice device, VkPhysicalDevice physicalDevice);
 
     // Getters
     Model* getModel() const { return model; }
@@ -37,12 +44,33 @@ public:
     std::string getNodeNameForRole(const std::string& role) const;
     bool        hasRole(const std::string& role) const;
 
+    /**
+     * @brief Create the model's scene nodes in `scene` and resolve the role nodes
+     *
+     * Restores the snapshot load() found when it still matches the model;
+     * otherwise builds with SceneBuilder::buildFromModel() and saves a new one.
+     *
+     * @param materialIds Map from material index to MaterialManager ID
+     * @return Root node handles, as SceneBuilder::buildFromModel() returns them
+     */
+    std::vector<NodeHandle> buildScene(Scene* scene, const std::unordered_map<size_t, uint32_t>& materialIds);
+
+    /**
+     * @brief Node the last buildScene() tagged with `role`; invalid if the role or its node is missing
+     */
+    NodeHandle getRoleNode(const std::string& role) const;
+
     // Model properties
     float getTargetLength() const { return targetLength; }
     Vec3  getModelRotation() const { return modelRotation; }
     Vec3  getModelScale() const { return modelScale; }
     Vec3  getPositionOffset() const { return positionOffset; }
 
+    const ModelLoadOptions& getLoadOptions() const { return loadOptions; }
+
+    // Tile residency, used when the "streaming" block sets a tileSize
+    const WorldStreamingConfig& getStreamingConfig() const { return streamingConfig; }
+
     // Camera configuration (expanded)
     struct CameraConfig {
         struct CockpitCamera {
@@ -126,7 +154,7 @@ public:
             float intensity = 1.0f;
             Vec3  color     = Vec3(1.0f);
             float range     = 50.0f;
-            float spotAngle = 45.0f;
+            float spotAngle = 45.0f;  // Degrees from the beam's axis to its edge
         };
         Light headlights;
         Light taillights;
@@ -201,7 +229,9 @@ public:
     const DebugConfig& getDebugConfig() const { return debugConfig; }
 
 private:
-    Model* model = nullptr;
+    Model*      model = nullptr;
+    std::string sourcePath;
+    bool        hasSidecar = false;  // A sidecar was parsed, now or when the snapshot was saved
 
     // Metadata from JSON
     float targetLength   = 0.0f;
@@ -209,6 +239,9 @@ private:
     Vec3  modelScale     = Vec3(1.0f);
     Vec3  positionOffset = Vec3(0.0f);
 
+    ModelLoadOptions     loadOptions;
+    WorldStreamingConfig streamingConfig;
+
     CameraConfig        cameraConfig;
     WindshieldConfig    windshieldConfig;
     WheelConfig         wheelConfig;
@@ -222,7 +255,14 @@ private:
     std::unordered_map<std::string, std::string> roleMap;
     PhysicsConfig                                physics;
 
+    SceneCache            sceneCache;  // Snapshot found by load(), until buildScene() uses it
+    SceneCache::RoleNodes roleNodes;
+
     bool loadMetadata(const std::string& filepath);
+
+    // Everything loadMetadata() sets, as stored in the scene snapshot
+    void writeConfig(BlobWriter& out) const;
+    bool readConfig(const std::vector<unsigned char>& blob);
 };
 
 }  // namespace DownPour
@@ -1,167 +1,66 @@
 #include "ModelGeometry.h"
 #include "Vertex.h"
 
-#include <cstring>
+#include "core/ResourceManager.h"
+
 #include <stdexcept>
+#include <vector>
 
 namespace DownPour {
 
 void ModelGeometry::createBuffers(const std::vector<Vertex>& vertices,
                                   const std::vector<uint32_t>& indices,
                                   VkDevice device,
-                                  VkPhysicalDevice physicalDevice,
-                                  VkCommandPool commandPool,
-                                  VkQueue graphicsQueue) {
-    indexCount = static_cast<uint32_t>(indices.size());
-
-    // Create vertex buffer
-    VkDeviceSize vertexBufferSize = sizeof(Vertex) * vertices.size();
-
-    // Create staging buffer
-    VkBuffer       stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(device, physicalDevice, vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
-                 stagingBufferMemory);
-
-    // Copy vertex data to staging buffer
-    void* data;
-    vkMapMemory(device, stagingBufferMemory, 0, vertexBufferSize, 0, &data);
-    memcpy(data, vertices.data(), vertexBufferSize);
-    vkUnmapMemory(device, stagingBufferMemory);
-
-    // Create device local buffer
-    createBuffer(device, physicalDevice, vertexBufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory);
-
-    // Copy from staging to device local
-    copyBuffer(device, commandPool, graphicsQueue, stagingBuffer, vertexBuffer, vertexBufferSize);
-
-    // Cleanup staging buffer
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
-
-    // Create index buffer
-    VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
-
-    // Create staging buffer
-    createBuffer(device, physicalDevice, indexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,
-                 stagingBufferMemory);
-
-    // Copy index data to staging buffer
-    vkMapMemory(device, stagingBufferMemory, 0, indexBufferSize, 0, &data);
-    memcpy(data, indices.data(), indexBufferSize);
-    vkUnmapMemory(device, stagingBufferMemory);
-
-    // Create device local buffer
-    createBuffer(device, physicalDevice, indexBufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory);
-
-    // Copy from staging to device local
-    copyBuffer(device, commandPool, graphicsQueue, stagingBuffer, indexBuffer, indexBufferSize);
-
-    // Cleanup staging buffer
-    vkDestroyBuffer(device, stagingBuffer, nullptr);
-    vkFreeMemory(device, stagingBufferMemory, nullptr);
-}
-
-void ModelGeometry::cleanup(VkDevice device) {
-    if (indexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, indexBuffer, nullptr);
-        indexBuffer = VK_NULL_HANDLE;
-    }
-    if (indexBufferMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, indexBufferMemory, nullptr);
-        indexBufferMemory = VK_NULL_HANDLE;
-    }
-    if (vertexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(device, vertexBuffer, nullptr);
-        vertexBuffer = VK_NULL_HANDLE;
-    }
-    if (vertexBufferMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, vertexBufferMemory, nullptr);
-        vertexBufferMemory = VK_NULL_HANDLE;
-    }
-    indexCount = 0;
+                                  VkPhysicalDevice physicalDevice) {
+    createBuffers(vertices.data(), vertices.size(), indices.data(), indices.size(), VK_INDEX_TYPE_UINT32, device,
+                  physicalDevice);
 }
 
-void ModelGeometry::createBuffer(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize size,
-                                 VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                                 VkDeviceMemory& bufferMemory) {
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size        = size;
-    bufferInfo.usage       = usage;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create buffer");
-    }
-
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
-
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize  = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory");
+void ModelGeometry::createBuffers(const Vertex* vertices, size_t vertexCount,
+                                  const void* indices, size_t indexCount, VkIndexType indexType,
+                                  VkDevice device,
+                                  VkPhysicalDevice physicalDevice) {
+    this->indexCount = static_cast<uint32_t>(indexCount);
+    this->indexType  = indexType;
+
+    // Packed models are converted here, so the CPU side (and the mesh cache) only ever holds Vertex
+    std::vector<PackedVertex> packed;
+    const void*               vertexData = vertices;
+    if (vertexFormat == VertexFormat::Packed) {
+        packed.reserve(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            packed.push_back(PackedVertex::pack(vertices[i], quantization));
+        vertexData = packed.data();
     }
 
-    vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    const size_t vertexStride     = vertexFormat == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    VkDeviceSize vertexBufferSize = vertexStride * vertexCount;
+    const size_t indexSize        = indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    VkDeviceSize indexBufferSize  = indexSize * indexCount;
+
+    // Create device local buffers
+    ResourceManager::createBuffer(device, physicalDevice, vertexBufferSize,
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory, memoryTag);
+    ResourceManager::createBuffer(device, physicalDevice, indexBufferSize,
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory, memoryTag);
+
+    // Both copies land in the same upload batch; the index future covers the vertex copy too
+    UploadManager& uploads = UploadManager::get();
+    uploads.uploadBuffer(vertexBuffer, vertexData, vertexBufferSize);
+    uploadFuture = uploads.uploadBuffer(indexBuffer, indices, indexBufferSize);
 }
 
-void ModelGeometry::copyBuffer(VkDevice device, VkCommandPool commandPool, VkQueue graphicsQueue,
-                               VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool        = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    VkBufferCopy copyRegion{};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-
-    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+void ModelGeometry::setVertexFormat(VertexFormat format, const VertexQuantization& quantization) {
+    this->vertexFormat = format;
+    this->quantization = quantization;
 }
 
-uint32_t ModelGeometry::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
-                                       VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-
-    throw std::runtime_error("Failed to find suitable memory type");
+void ModelGeometry::cleanup(VkDevice device) {
+    ResourceManager::destroyBuffer(device, indexBuffer, indexBufferMemory);
+    ResourceManager::destroyBuffer(device, vertexBuffer, vertexBufferMemory);
+    indexCount = 0;
 }
 
 } // namespace DownPour
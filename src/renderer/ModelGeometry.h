@@ -1,13 +1,15 @@
 #pragma once
 
+#include "Vertex.h"
+#include "core/MemoryAllocator.h"
+#include "core/UploadManager.h"
+
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <cstdint>
 
 namespace DownPour {
 
-struct Vertex;
-
 /**
  * @brief Manages Vulkan vertex and index buffers for a model
  *
@@ -27,15 +29,40 @@ public:
      * @param indices CPU index data
      * @param device Vulkan logical device
      * @param physicalDevice Vulkan physical device for memory queries
-     * @param commandPool Command pool for buffer transfer operations
-     * @param graphicsQueue Graphics queue for command submission
+     *
+     * Uploads are queued on the UploadManager and not waited on; check
+     * getUploadFuture() before the first draw.
      */
     void createBuffers(const std::vector<Vertex>& vertices,
                       const std::vector<uint32_t>& indices,
                       VkDevice device,
-                      VkPhysicalDevice physicalDevice,
-                      VkCommandPool commandPool,
-                      VkQueue graphicsQueue);
+                      VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Create buffers from raw arrays (e.g. a memory-mapped cooked mesh)
+     *
+     * The data is copied into staging before this returns, so it only has
+     * to stay valid for the duration of the call.
+     *
+     * @param indices indexCount uint16_t or uint32_t values, as given by indexType
+     */
+    void createBuffers(const Vertex* vertices, size_t vertexCount,
+                      const void* indices, size_t indexCount, VkIndexType indexType,
+                      VkDevice device,
+                      VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Choose the GPU vertex layout for the next createBuffers call
+     *
+     * Input data is always Vertex; with VertexFormat::Packed it is converted to
+     * PackedVertex during upload, quantizing positions with `quantization`.
+     */
+    void setVertexFormat(VertexFormat format, const VertexQuantization& quantization);
+
+    /**
+     * @brief Subsystem the next createBuffers call's memory is accounted to (default Geometry)
+     */
+    void setMemoryTag(MemoryTag tag) { memoryTag = tag; }
 
     /**
      * @brief Clean up Vulkan buffer resources
@@ -47,26 +74,22 @@ public:
     VkBuffer getVertexBuffer() const { return vertexBuffer; }
     VkBuffer getIndexBuffer() const { return indexBuffer; }
     uint32_t getIndexCount() const { return indexCount; }
+    VkIndexType getIndexType() const { return indexType; }
+    const UploadFuture& getUploadFuture() const { return uploadFuture; }
+    VertexFormat getVertexFormat() const { return vertexFormat; }
+    const VertexQuantization& getVertexQuantization() const { return quantization; }
 
 private:
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
+    Allocation vertexBufferMemory;
     VkBuffer indexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory indexBufferMemory = VK_NULL_HANDLE;
+    Allocation indexBufferMemory;
     uint32_t indexCount = 0;
-
-    void createBuffer(VkDevice device, VkPhysicalDevice physicalDevice,
-                     VkDeviceSize size, VkBufferUsageFlags usage,
-                     VkMemoryPropertyFlags properties,
-                     VkBuffer& buffer, VkDeviceMemory& bufferMemory);
-
-    void copyBuffer(VkDevice device, VkCommandPool commandPool,
-                   VkQueue graphicsQueue, VkBuffer srcBuffer,
-                   VkBuffer dstBuffer, VkDeviceSize size);
-
-    uint32_t findMemoryType(VkPhysicalDevice physicalDevice,
-                           uint32_t typeFilter,
-                           VkMemoryPropertyFlags properties);
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    UploadFuture uploadFuture;
+    VertexFormat vertexFormat = VertexFormat::Float;
+    VertexQuantization quantization;
+    MemoryTag memoryTag = MemoryTag::Geometry;
 };
 
 } // namespace DownPour
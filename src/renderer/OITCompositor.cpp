@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: MIT
+#include "OITCompositor.h"
+
+#include "core/PipelineFactory.h"
+#include "core/SwapChainManager.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace DownPour {
+
+void OITCompositor::setTargets(VkImageView accum, VkImageView revealage) {
+    accumView     = accum;
+    revealageView = revealage;
+}
+
+void OITCompositor::createPipeline(VkDevice device, VkRenderPass renderPass, VkPipelineCache pipelineCache) {
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); i++) {
+        bindings[i].binding         = i;
+        bindings[i].descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags      = VK_SHADER_STAGE_FRAGMENT_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create OIT composite descriptor set layout");
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size());
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes    = &poolSize;
+    poolInfo.maxSets       = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create OIT composite descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate OIT composite descriptor set");
+
+    // Input attachments are read in the layout the composite subpass puts them in
+    std::array<VkDescriptorImageInfo, 2> imageInfos{};
+    imageInfos[0].imageView   = accumView;
+    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfos[1].imageView   = revealageView;
+    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t i = 0; i < writes.size(); i++) {
+        writes[i].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet          = set;
+        writes[i].dstBinding      = i;
+        writes[i].descriptorType  = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        writes[i].descriptorCount = 1;
+        writes[i].pImageInfo      = &imageInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    pipelineLayout = PipelineFactory::createPipelineLayout(device, {setLayout});
+
+    // Fullscreen triangle with no depth attachment; standard alpha blending applies 1 - revealage
+    PipelineConfig config;
+    config.vertShader       = "oit_composite.vert.spv";
+    config.fragShader       = "oit_composite.frag.spv";
+    config.layout           = pipelineLayout;
+    config.cullMode         = VK_CULL_MODE_NONE;
+    config.enableBlending   = true;
+    config.enableDepthWrite = false;
+    config.useVertexInput   = false;
+    config.subpass          = SwapChainManager::SUBPASS_COMPOSITE;
+
+    pipeline = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+}
+
+void OITCompositor::destroy(VkDevice device) {
+    if (pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    if (pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees `set`
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+
+    pipeline       = VK_NULL_HANDLE;
+    pipelineLayout = VK_NULL_HANDLE;
+    pool           = VK_NULL_HANDLE;
+    set            = VK_NULL_HANDLE;
+    setLayout      = VK_NULL_HANDLE;
+    accumView      = VK_NULL_HANDLE;
+    revealageView  = VK_NULL_HANDLE;
+}
+
+void OITCompositor::recordComposite(VkCommandBuffer cmd, VkExtent2D renderExtent) const {
+    VkViewport viewport{
+        0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f};
+    VkRect2D scissor{{0, 0}, renderExtent};
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &set, 0, nullptr);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+}
+
+}  // namespace DownPour
@@ -0,0 +1,66 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace DownPour {
+
+/**
+ * @brief Targets and resolve for weighted blended order-independent transparency
+ *
+ * Transparent pipelines (PipelineConfig::oitAccumulation) draw in
+ * SwapChainManager::SUBPASS_TRANSPARENT into two screen-sized targets: the
+ * sum of depth-weighted premultiplied color and alpha, and the product of
+ * (1 - alpha). Both blend commutatively, so transparent draws and particles
+ * need no sorting and cost the same however many layers overlap. In
+ * SUBPASS_COMPOSITE a fullscreen triangle reads the targets as input
+ * attachments and blends their weighted average over the opaque color.
+ *
+ * The targets are render graph transients, shared by every framebuffer like
+ * the depth buffer; their memory is reused by images outside the main pass.
+ */
+class OITCompositor {
+public:
+    OITCompositor()  = default;
+    ~OITCompositor() = default;
+
+    OITCompositor(const OITCompositor&)            = delete;
+    OITCompositor& operator=(const OITCompositor&) = delete;
+
+    /**
+     * @brief Use the given targets; their views go into every framebuffer
+     *
+     * The images need color attachment, input attachment and transient attachment usage, in
+     * SwapChainManager::OIT_ACCUM_FORMAT and OIT_REVEALAGE_FORMAT. Call before createPipeline().
+     */
+    void setTargets(VkImageView accum, VkImageView revealage);
+
+    /**
+     * @brief Create the composite pipeline for @p renderPass's composite subpass
+     */
+    void createPipeline(VkDevice device, VkRenderPass renderPass, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Resolve the transparent layers; record inline in SUBPASS_COMPOSITE
+     * @param renderExtent Top-left region of the targets the frame rendered into
+     */
+    void recordComposite(VkCommandBuffer cmd, VkExtent2D renderExtent) const;
+
+    VkImageView getAccumView() const { return accumView; }
+    VkImageView getRevealageView() const { return revealageView; }
+
+private:
+    VkImageView accumView     = VK_NULL_HANDLE;  // Not owned
+    VkImageView revealageView = VK_NULL_HANDLE;
+
+    // Composite: both targets as input attachments, one set for the whole run
+    VkDescriptorSetLayout setLayout      = VK_NULL_HANDLE;
+    VkDescriptorPool      pool           = VK_NULL_HANDLE;
+    VkDescriptorSet       set            = VK_NULL_HANDLE;
+    VkPipelineLayout      pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline            pipeline       = VK_NULL_HANDLE;
+};
+
+}  // namespace DownPour
@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: MIT
+#include "OcclusionCuller.h"
+
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+constexpr VkFormat PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+struct ReduceParams {
+    glm::ivec2 srcSize;
+    glm::ivec2 dstSize;
+};
+
+struct CullParams {
+    glm::mat4 viewProj;
+    glm::vec2 pyramidSize;
+    uint32_t  drawCount;
+    uint32_t  levelCount;
+};
+
+uint32_t previousPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result * 2 <= value)
+        result *= 2;
+    return result;
+}
+
+VkImageMemoryBarrier pyramidBarrier(VkImage image, uint32_t baseLevel, uint32_t levelCount) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                         = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask                 = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask                 = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout                     = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout                     = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex           = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex           = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                         = image;
+    barrier.subresourceRange.aspectMask   = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = baseLevel;
+    barrier.subresourceRange.levelCount   = levelCount;
+    barrier.subresourceRange.layerCount   = 1;
+    return barrier;
+}
+
+}  // namespace
+
+void OcclusionCuller::init(VkDevice device, VkPhysicalDevice physicalDevice, VkImageView depthView, VkExtent2D extent,
+                           VkBuffer drawBuffer, uint32_t maxDraws, VkPipelineCache pipelineCache) {
+    depthExtent = extent;
+    createPyramid(device, physicalDevice);
+    createDescriptors(device, depthView, drawBuffer, maxDraws);
+
+    VkPushConstantRange reduceRange{};
+    reduceRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    reduceRange.offset     = 0;
+    reduceRange.size       = sizeof(ReduceParams);
+
+    reduceLayout   = PipelineFactory::createPipelineLayout(device, {reduceSetLayout}, {reduceRange});
+    reducePipeline = PipelineFactory::createComputePipeline(device, "depth_reduce.comp.spv", reduceLayout,
+                                                            pipelineCache);
+
+    VkPushConstantRange cullRange{};
+    cullRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    cullRange.offset     = 0;
+    cullRange.size       = sizeof(CullParams);
+
+    cullLayout   = PipelineFactory::createPipelineLayout(device, {cullSetLayout}, {cullRange});
+    cullPipeline = PipelineFactory::createComputePipeline(device, "occlusion_cull.comp.spv", cullLayout,
+                                                          pipelineCache);
+
+    pyramidValid = false;
+}
+
+void OcclusionCuller::destroy(VkDevice device) {
+    if (cullPipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, cullPipeline, nullptr);
+    if (cullLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, cullLayout, nullptr);
+    if (reducePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, reducePipeline, nullptr);
+    if (reduceLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, reduceLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees every set
+    if (cullSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, cullSetLayout, nullptr);
+    if (reduceSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, reduceSetLayout, nullptr);
+    if (sampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, sampler, nullptr);
+    for (VkImageView view : levelViews)
+        vkDestroyImageView(device, view, nullptr);
+    if (pyramidView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, pyramidView, nullptr);
+    ResourceManager::destroyImage(device, pyramidImage, pyramidMemory);
+
+    cullPipeline    = VK_NULL_HANDLE;
+    cullLayout      = VK_NULL_HANDLE;
+    reducePipeline  = VK_NULL_HANDLE;
+    reduceLayout    = VK_NULL_HANDLE;
+    pool            = VK_NULL_HANDLE;
+    cullSet         = VK_NULL_HANDLE;
+    cullSetLayout   = VK_NULL_HANDLE;
+    reduceSetLayout = VK_NULL_HANDLE;
+    sampler         = VK_NULL_HANDLE;
+    pyramidView     = VK_NULL_HANDLE;
+    levelViews.clear();
+    reduceSets.clear();
+    pyramidValid = false;
+}
+
+void OcclusionCuller::cull(VkCommandBuffer cmd, const FrameAllocation& commands, const FrameAllocation& bounds,
+                           uint32_t drawCount) {
+    if (!pyramidValid || drawCount == 0 || cullPipeline == VK_NULL_HANDLE)
+        return;
+
+    CullParams params{};
+    params.viewProj    = pyramidViewProj;
+    params.pyramidSize = glm::vec2(static_cast<float>(pyramidExtent.width), static_cast<float>(pyramidExtent.height));
+    params.drawCount   = drawCount;
+    params.levelCount  = levelCount;
+
+    std::array<uint32_t, 2> offsets = {commands.dynamicOffset(), bounds.dynamicOffset()};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, cullLayout, 0, 1, &cullSet,
+                            static_cast<uint32_t>(offsets.size()), offsets.data());
+    vkCmdPushConstants(cmd, cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(cmd, (drawCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+}
+
+void OcclusionCuller::buildPyramid(VkCommandBuffer cmd, VkExtent2D renderExtent, const glm::mat4& viewProj) {
+    if (reducePipeline == VK_NULL_HANDLE)
+        return;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline);
+
+    // Level 0 reads only the rendered region; depth outside it is stale
+    VkExtent2D src = {std::min(renderExtent.width, depthExtent.width),
+                      std::min(renderExtent.height, depthExtent.height)};
+    for (uint32_t level = 0; level < levelCount; level++) {
+        VkExtent2D dst = {std::max(pyramidExtent.width >> level, 1u), std::max(pyramidExtent.height >> level, 1u)};
+
+        ReduceParams params{};
+        params.srcSize = glm::ivec2(static_cast<int>(src.width), static_cast<int>(src.height));
+        params.dstSize = glm::ivec2(static_cast<int>(dst.width), static_cast<int>(dst.height));
+
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reduceLayout, 0, 1, &reduceSets[level], 0,
+                                nullptr);
+        vkCmdPushConstants(cmd, reduceLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(cmd, (dst.width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE,
+                      (dst.height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1);
+
+        // The level just written is the next dispatch's source
+        VkImageMemoryBarrier levelBarrier = pyramidBarrier(pyramidImage, level, 1);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &levelBarrier);
+        src = dst;
+    }
+
+    pyramidViewProj = viewProj;
+    pyramidValid    = true;
+}
+
+void OcclusionCuller::createPyramid(VkDevice device, VkPhysicalDevice physicalDevice) {
+    // Powers of two make every level after the first an exact 2x2 reduction
+    pyramidExtent = {previousPowerOfTwo(depthExtent.width), previousPowerOfTwo(depthExtent.height)};
+    levelCount    = 1;
+    while ((std::max(pyramidExtent.width, pyramidExtent.height) >> levelCount) > 0)
+        levelCount++;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent        = {pyramidExtent.width, pyramidExtent.height, 1};
+    imageInfo.mipLevels     = levelCount;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.format        = PYRAMID_FORMAT;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &pyramidImage) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth pyramid image");
+    ResourceManager::allocateImageMemory(device, pyramidImage, VK_IMAGE_TILING_OPTIMAL,
+                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pyramidMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                           = pyramidImage;
+    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format                          = PYRAMID_FORMAT;
+    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel   = 0;
+    viewInfo.subresourceRange.levelCount     = levelCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount     = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &pyramidView) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth pyramid view");
+
+    levelViews.resize(levelCount, VK_NULL_HANDLE);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        viewInfo.subresourceRange.baseMipLevel = level;
+        viewInfo.subresourceRange.levelCount   = 1;
+        if (vkCreateImageView(device, &viewInfo, nullptr, &levelViews[level]) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create depth pyramid level view");
+    }
+
+    // Nearest texel of an explicit level: the shaders do the max reduction themselves
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter               = VK_FILTER_NEAREST;
+    samplerInfo.minFilter               = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.minLod                  = 0.0f;
+    samplerInfo.maxLod                  = static_cast<float>(levelCount);
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable           = VK_FALSE;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth pyramid sampler");
+}
+
+void OcclusionCuller::createDescriptors(VkDevice device, VkImageView depthView, VkBuffer drawBuffer,
+                                        uint32_t maxDraws) {
+    // Reduction set: binding 0 = source level (sampled), binding 1 = destination level (storage)
+    std::array<VkDescriptorSetLayoutBinding, 2> reduceBindings{};
+    reduceBindings[0].binding         = 0;
+    reduceBindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    reduceBindings[0].descriptorCount = 1;
+    reduceBindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    reduceBindings[1].binding         = 1;
+    reduceBindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    reduceBindings[1].descriptorCount = 1;
+    reduceBindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(reduceBindings.size());
+    layoutInfo.pBindings    = reduceBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &reduceSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create depth reduce descriptor set layout");
+
+    // Cull set: binding 0 = commands, binding 1 = bounds (both at the frame's dynamic offsets),
+    // binding 2 = the whole pyramid
+    std::array<VkDescriptorSetLayoutBinding, 3> cullBindings{};
+    cullBindings[0].binding         = 0;
+    cullBindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    cullBindings[0].descriptorCount = 1;
+    cullBindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    cullBindings[1].binding         = 1;
+    cullBindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    cullBindings[1].descriptorCount = 1;
+    cullBindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    cullBindings[2].binding         = 2;
+    cullBindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    cullBindings[2].descriptorCount = 1;
+    cullBindings[2].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    layoutInfo.bindingCount = static_cast<uint32_t>(cullBindings.size());
+    layoutInfo.pBindings    = cullBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &cullSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create occlusion cull descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = levelCount + 1;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = levelCount;
+    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[2].descriptorCount = 2;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = levelCount + 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create occlusion culling descriptor pool");
+
+    std::vector<VkDescriptorSetLayout> layouts(levelCount, reduceSetLayout);
+    reduceSets.resize(levelCount, VK_NULL_HANDLE);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = levelCount;
+    allocInfo.pSetLayouts        = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, reduceSets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate depth reduce descriptor sets");
+
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &cullSetLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &cullSet) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate occlusion cull descriptor set");
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        VkDescriptorImageInfo srcInfo{};
+        srcInfo.sampler     = sampler;
+        srcInfo.imageView   = level == 0 ? depthView : levelViews[level - 1];
+        srcInfo.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo dstInfo{};
+        dstInfo.imageView   = levelViews[level];
+        dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = reduceSets[level];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = reduceBindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
+        }
+        writes[0].pImageInfo = &srcInfo;
+        writes[1].pImageInfo = &dstInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    VkDescriptorBufferInfo commandInfo{};
+    commandInfo.buffer = drawBuffer;
+    commandInfo.offset = 0;
+    commandInfo.range  = sizeof(VkDrawIndexedIndirectCommand) * maxDraws;
+
+    VkDescriptorBufferInfo boundsInfo{};
+    boundsInfo.buffer = drawBuffer;
+    boundsInfo.offset = 0;
+    boundsInfo.range  = sizeof(OcclusionBounds) * maxDraws;
+
+    VkDescriptorImageInfo pyramidInfo{};
+    pyramidInfo.sampler     = sampler;
+    pyramidInfo.imageView   = pyramidView;
+    pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    std::array<VkWriteDescriptorSet, 3> writes{};
+    for (uint32_t b = 0; b < writes.size(); b++) {
+        writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[b].dstSet          = cullSet;
+        writes[b].dstBinding      = b;
+        writes[b].descriptorType  = cullBindings[b].descriptorType;
+        writes[b].descriptorCount = 1;
+    }
+    writes[0].pBufferInfo = &commandInfo;
+    writes[1].pBufferInfo = &boundsInfo;
+    writes[2].pImageInfo  = &pyramidInfo;
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+}  // namespace DownPour
@@ -0,0 +1,130 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/FrameAllocator.h"
+#include "core/MemoryAllocator.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief World-space box of one indirect draw, read by the occlusion cull shader (std430)
+ *
+ * Covers every instance of the command. A w of 0 in `min` marks a draw with
+ * no bounds, which is never culled.
+ */
+struct OcclusionBounds {
+    glm::vec4 min;  // xyz, w = 1 to test the box
+    glm::vec4 max;
+};
+
+/**
+ * @brief GPU Hi-Z occlusion culling against the previous frame's depth
+ *
+ * buildPyramid() reduces the depth buffer into a mip chain holding the
+ * farthest depth under each texel, once the render pass has ended. The next
+ * frame, cull() runs before its render pass: one thread per indirect command
+ * projects the command's bounds with the view-projection the pyramid was
+ * rendered with, reads the level at which the box covers at most 2x2 texels,
+ * and zeroes instanceCount when the box lies entirely behind it. Culled
+ * commands stay in place as empty draws, so runs the CPU recorded for
+ * (multi-)indirect drawing are unchanged and the hidden geometry never reaches
+ * the vertex stage. Draws are only tested after they pass frustum culling.
+ *
+ * Something hidden last frame is tested against depth it did not write, so at
+ * worst it reappears one frame late as the view reveals it.
+ */
+class OcclusionCuller {
+public:
+    OcclusionCuller()  = default;
+    ~OcclusionCuller() = default;
+
+    OcclusionCuller(const OcclusionCuller&)            = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    /**
+     * @brief Create the pyramid for a depth buffer and the reduce/cull pipelines
+     *
+     * @param depthView Depth-aspect view of the depth attachment; the image needs VK_IMAGE_USAGE_SAMPLED_BIT
+     * @param drawBuffer Buffer holding the commands and bounds passed to cull()
+     * @param maxDraws Most commands one cull() call tests
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkImageView depthView, VkExtent2D depthExtent,
+              VkBuffer drawBuffer, uint32_t maxDraws, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Zero the instance count of every command the pyramid hides
+     *
+     * Record outside a render pass, with the pyramid in VK_IMAGE_LAYOUT_GENERAL and readable by compute
+     * shaders; the caller makes the commands visible to the indirect draws. Does nothing until a pyramid
+     * has been built.
+     *
+     * @param commands    drawCount VkDrawIndexedIndirectCommands, later read by indirect draws
+     * @param bounds      drawCount OcclusionBounds, in the same order
+     */
+    void cull(VkCommandBuffer cmd, const FrameAllocation& commands, const FrameAllocation& bounds, uint32_t drawCount);
+
+    /**
+     * @brief Reduce the depth buffer into the pyramid for the next frame's cull()
+     *
+     * Record after the render pass that wrote the depth, with the depth in
+     * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and the pyramid in VK_IMAGE_LAYOUT_GENERAL,
+     * both ready for compute shaders; the barriers between levels are recorded here. The
+     * pyramid always covers the whole view, stretched from the region that was rendered.
+     * @param renderExtent Top-left region of the depth buffer the frame rendered into
+     * @param viewProj The view-projection the depth was rendered with
+     */
+    void buildPyramid(VkCommandBuffer cmd, VkExtent2D renderExtent, const glm::mat4& viewProj);
+
+    /**
+     * @brief Drop the pyramid, e.g. after a camera cut, so nothing is culled until the next build
+     */
+    void invalidate() { pyramidValid = false; }
+
+    bool       isReady() const { return pyramidValid; }
+    VkImage    getPyramidImage() const { return pyramidImage; }
+    VkExtent2D getPyramidExtent() const { return pyramidExtent; }
+    uint32_t   getLevelCount() const { return levelCount; }
+
+    static constexpr uint32_t REDUCE_GROUP_SIZE = 8;   // Both axes; must match depth_reduce.comp
+    static constexpr uint32_t CULL_GROUP_SIZE   = 64;  // Must match occlusion_cull.comp
+
+private:
+    // Pyramid: R32_SFLOAT, largest power of two per axis that fits in the depth buffer
+    VkImage                  pyramidImage = VK_NULL_HANDLE;
+    Allocation               pyramidMemory;
+    VkImageView              pyramidView = VK_NULL_HANDLE;  // All levels, for culling
+    std::vector<VkImageView> levelViews;                    // One per level, for reduction
+    VkSampler                sampler       = VK_NULL_HANDLE;  // Nearest, clamped; reductions are explicit
+    VkExtent2D               depthExtent   = {0, 0};
+    VkExtent2D               pyramidExtent = {0, 0};
+    uint32_t                 levelCount    = 0;
+    bool                     pyramidValid  = false;
+    glm::mat4                pyramidViewProj{1.0f};
+
+    // Reduction: level N reads level N - 1 (level 0 reads the depth buffer)
+    VkDescriptorSetLayout        reduceSetLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> reduceSets;
+    VkPipelineLayout             reduceLayout   = VK_NULL_HANDLE;
+    VkPipeline                   reducePipeline = VK_NULL_HANDLE;
+
+    // Culling: commands and bounds as dynamic storage buffers, pyramid sampled at any level
+    VkDescriptorSetLayout cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSet       cullSet       = VK_NULL_HANDLE;
+    VkPipelineLayout      cullLayout    = VK_NULL_HANDLE;
+    VkPipeline            cullPipeline  = VK_NULL_HANDLE;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+
+    void createPyramid(VkDevice device, VkPhysicalDevice physicalDevice);
+    void createDescriptors(VkDevice device, VkImageView depthView, VkBuffer drawBuffer, uint32_t maxDraws);
+};
+
+}  // namespace DownPour
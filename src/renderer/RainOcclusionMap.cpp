@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MIT
+#include "RainOcclusionMap.h"
+
+#include "core/ResourceManager.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace DownPour {
+
+void RainOcclusionMap::init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t mapCount,
+                            const std::vector<uint32_t>& queueFamilies, VkDescriptorSetLayout cameraLayout,
+                            VkPipelineCache pipelineCache) {
+    staticLayer.init(device, MAP_FORMAT, RESOLUTION, 1);
+
+    maps.resize(mapCount);
+    for (SampledMap& map : maps) {
+        ResourceManager::createImage(device, physicalDevice, RESOLUTION, RESOLUTION, MAP_FORMAT,
+                                     VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                         VK_IMAGE_USAGE_SAMPLED_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, map.image, map.memory, MemoryTag::General,
+                                     queueFamilies);
+        map.view        = staticLayer.createLayerView(device, map.image, 0);
+        map.framebuffer = staticLayer.createDynamicFramebuffer(device, map.view);
+    }
+
+    // Nearest: a drop is either under a surface or not
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType        = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter    = VK_FILTER_NEAREST;
+    samplerInfo.minFilter    = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode   = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod       = 0.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create rain occlusion sampler");
+
+    // car.vert's set 0 only; there is no fragment shading to feed
+    pipelineLayout = PipelineFactory::createPipelineLayout(device, {cameraLayout});
+
+    // Both passes share a subpass layout, so the pipelines work in either
+    PipelineConfig config;
+    config.vertShader = "car.vert.spv";
+    config.fragShader = "depth_only.frag.spv";
+    config.layout     = pipelineLayout;
+    config.cullMode   = VK_CULL_MODE_NONE;  // Roofs are seen from above, whichever way they face
+    config.depthOnly  = true;
+
+    VkRenderPass renderPass = staticLayer.getStaticPass();
+    pipeline                = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+    config.vertexFormat     = VertexFormat::Packed;
+    packedPipeline          = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+}
+
+void RainOcclusionMap::destroy(VkDevice device) {
+    for (VkPipeline* p : {&pipeline, &packedPipeline}) {
+        if (*p != VK_NULL_HANDLE)
+            vkDestroyPipeline(device, *p, nullptr);
+        *p = VK_NULL_HANDLE;
+    }
+    if (pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    for (SampledMap& map : maps) {
+        if (map.framebuffer != VK_NULL_HANDLE)
+            vkDestroyFramebuffer(device, map.framebuffer, nullptr);
+        if (map.view != VK_NULL_HANDLE)
+            vkDestroyImageView(device, map.view, nullptr);
+        ResourceManager::destroyImage(device, map.image, map.memory);
+    }
+    maps.clear();
+    if (sampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, sampler, nullptr);
+    staticLayer.destroy(device);
+
+    pipelineLayout = VK_NULL_HANDLE;
+    sampler        = VK_NULL_HANDLE;
+    currentMap     = 0;
+    staticValid    = false;
+}
+
+bool RainOcclusionMap::beginFrame(uint32_t slot, const glm::vec3& cameraPosition, uint64_t staticVersion) {
+    currentMap = slot;
+
+    bool recenter = !staticValid || glm::length(cameraPosition - center) > RECENTER_DISTANCE;
+    if (!recenter && staticVersion == renderedStatic) {
+        maps[slot].area = getArea();
+        return false;
+    }
+
+    if (recenter) {
+        // Snap to whole texels so static edges don't shimmer from one recenter to the next
+        const float texel = SIZE / static_cast<float>(RESOLUTION);
+        center            = glm::vec3(std::floor(cameraPosition.x / texel) * texel, cameraPosition.y,
+                                      std::floor(cameraPosition.z / texel) * texel);
+    }
+
+    // x and z map straight onto the square, and height onto depth from HEIGHT_ABOVE down:
+    // clip = ((x - cx) / half, (z - cz) / half, (top - y) / DEPTH_RANGE)
+    const float half = SIZE * 0.5f;
+    const float top  = center.y + HEIGHT_ABOVE;
+    viewProj         = glm::mat4(0.0f);
+    viewProj[0][0]   = 1.0f / half;
+    viewProj[2][1]   = 1.0f / half;
+    viewProj[1][2]   = -1.0f / DEPTH_RANGE;
+    viewProj[3]      = glm::vec4(-center.x / half, -center.z / half, top / DEPTH_RANGE, 1.0f);
+
+    renderedStatic  = staticVersion;
+    staticValid     = true;
+    maps[slot].area = getArea();
+    return true;
+}
+
+glm::vec4 RainOcclusionMap::getArea() const {
+    const float half = SIZE * 0.5f;
+    return glm::vec4(center.x - half, center.z - half, SIZE, center.y + HEIGHT_ABOVE);
+}
+
+void RainOcclusionMap::beginStaticPass(VkCommandBuffer cmd) const {
+    staticLayer.beginStaticPass(cmd, 0);
+}
+
+void RainOcclusionMap::endStaticPass(VkCommandBuffer cmd) const {
+    staticLayer.endPass(cmd);
+}
+
+void RainOcclusionMap::beginDynamicPass(VkCommandBuffer cmd) const {
+    // The graph moved the map to TRANSFER_DST
+    staticLayer.copyToTarget(cmd, maps[currentMap].image);
+    staticLayer.beginDynamicPass(cmd, maps[currentMap].framebuffer);
+}
+
+void RainOcclusionMap::endDynamicPass(VkCommandBuffer cmd) const {
+    staticLayer.endPass(cmd);
+}
+
+VkPipeline RainOcclusionMap::getPipeline(VertexFormat format) const {
+    return format == VertexFormat::Packed ? packedPipeline : pipeline;
+}
+
+}  // namespace DownPour
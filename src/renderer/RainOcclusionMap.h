@@ -0,0 +1,134 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "CachedDepthLayers.h"
+#include "core/MemoryAllocator.h"
+#include "core/PipelineFactory.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Top-down depth of everything rain can land on, around the camera
+ *
+ * An orthographic depth pass looking straight down over a SIZE-metre square.
+ * rain_update.comp samples it to kill drops at the first surface above them,
+ * so rain stops at the car roof and under bridges instead of at the ground.
+ *
+ * Updated incrementally through CachedDepthLayers: the static world (the
+ * road) is rendered into its own image only when the camera has moved
+ * RECENTER_DISTANCE from the map's center or the caller's static version
+ * changes (streamed tiles arriving). Each frame copies it into the sampled
+ * image and draws the moving scene (the car) on top.
+ *
+ * There is one sampled map per frame slot, imported into the render graph per
+ * frame: the rain compute step reads a slot's map, drawn framesInFlight frames
+ * earlier, on the async compute queue while later frames draw theirs, and the
+ * rain's vertex shader reads the map drawn in its own frame. Recordings begin
+ * with the slot's map in TRANSFER_DST_OPTIMAL and leave it as a depth attachment.
+ *
+ * Both passes draw with car.vert; bind set 0 with a CameraUBO whose
+ * viewProj is getViewProj().
+ */
+class RainOcclusionMap {
+public:
+    static constexpr uint32_t RESOLUTION        = 512;
+    static constexpr float    SIZE              = 64.0f;  // Metres; covers the rain volume plus RECENTER_DISTANCE
+    static constexpr float    RECENTER_DISTANCE = 8.0f;
+    static constexpr float    HEIGHT_ABOVE      = 40.0f;  // Depth 0, above the center; rain spawns below it
+    static constexpr float    DEPTH_RANGE       = 80.0f;  // Metres from depth 0 to depth 1
+
+    // Depth attachment and sampled image support are both mandatory for D16
+    static constexpr VkFormat MAP_FORMAT = VK_FORMAT_D16_UNORM;
+
+    RainOcclusionMap()  = default;
+    ~RainOcclusionMap() = default;
+
+    RainOcclusionMap(const RainOcclusionMap&)            = delete;
+    RainOcclusionMap& operator=(const RainOcclusionMap&) = delete;
+
+    /**
+     * @brief Create the static image, the sampled maps, render passes and depth-only pipelines
+     * @param mapCount Sampled maps, one per frame slot
+     * @param queueFamilies Families sampling the maps concurrently (VulkanContext::getComputeSharingFamilies())
+     * @param cameraLayout Descriptor set layout of car.vert's set 0 (camera UBO + object SSBO)
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t mapCount,
+              const std::vector<uint32_t>& queueFamilies, VkDescriptorSetLayout cameraLayout,
+              VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    bool isEnabled() const { return pipeline != VK_NULL_HANDLE; }
+
+    /**
+     * @brief Place this frame's map; call before recording either pass
+     * @param slot Frame slot whose map the dynamic pass draws
+     * @param staticVersion Changes whenever the static geometry does
+     * @return Whether the static pass must be recorded this frame
+     */
+    bool beginFrame(uint32_t slot, const glm::vec3& cameraPosition, uint64_t staticVersion);
+
+    /**
+     * @brief Begin the static pass, which clears the static image; record outside any render pass
+     */
+    void beginStaticPass(VkCommandBuffer cmd) const;
+    void endStaticPass(VkCommandBuffer cmd) const;
+
+    /**
+     * @brief Copy the static image into the slot's sampled map and begin drawing the moving scene over it
+     */
+    void beginDynamicPass(VkCommandBuffer cmd) const;
+
+    /**
+     * @brief End the dynamic pass, leaving the map in DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+     */
+    void endDynamicPass(VkCommandBuffer cmd) const;
+
+    /** @brief World to map clip space: x and z across the square, y (top down) into depth */
+    const glm::mat4& getViewProj() const { return viewProj; }
+
+    /** @brief xy = the square's minimum corner (world xz), z = SIZE, w = height of depth 0 */
+    glm::vec4 getArea() const;
+
+    /** @brief getArea() when @p slot's map was last drawn; z = 0 until it first is */
+    const glm::vec4& getArea(uint32_t slot) const { return maps[slot].area; }
+
+    VkPipeline       getPipeline(VertexFormat format) const;
+    VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
+    VkImage          getImage(uint32_t slot) const { return maps[slot].image; }
+    VkImageView      getView(uint32_t slot) const { return maps[slot].view; }
+    VkSampler        getSampler() const { return sampler; }
+
+private:
+    struct SampledMap {
+        VkImage       image = VK_NULL_HANDLE;
+        Allocation    memory;
+        VkImageView   view        = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer = VK_NULL_HANDLE;  // For the dynamic pass
+        glm::vec4     area        = glm::vec4(0.0f);
+    };
+
+    // The maps are sampled by the rain; staticLayer keeps the world between recenters
+    CachedDepthLayers       staticLayer;
+    std::vector<SampledMap> maps;
+    uint32_t                currentMap = 0;
+    VkSampler               sampler    = VK_NULL_HANDLE;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline       pipeline       = VK_NULL_HANDLE;
+    VkPipeline       packedPipeline = VK_NULL_HANDLE;  // PackedVertex input
+
+    glm::vec3 center         = glm::vec3(0.0f);
+    glm::mat4 viewProj       = glm::mat4(1.0f);
+    uint64_t  renderedStatic = 0;  // staticVersion the static image holds
+    bool      staticValid    = false;
+};
+
+}  // namespace DownPour
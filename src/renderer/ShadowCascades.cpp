@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: MIT
+#include "ShadowCascades.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace DownPour {
+
+glm::vec3 ShadowCascades::getSunDirection() {
+    // Daylight sun, high overhead and slightly to the side
+    return glm::normalize(glm::vec3(0.3f, 0.8f, 0.4f));
+}
+
+float ShadowCascades::getTexelSize(uint32_t cascade) {
+    return 2.0f * CASCADE_RADII[cascade] * (1.0f + RECENTER_FRACTION) / static_cast<float>(RESOLUTION);
+}
+
+void ShadowCascades::init(VkDevice device, VkPhysicalDevice physicalDevice, VkImage mapImage,
+                          VkDescriptorSetLayout cameraLayout, VkPipelineCache pipelineCache) {
+    staticLayers.init(device, MAP_FORMAT, RESOLUTION, CASCADE_COUNT);
+    this->mapImage = mapImage;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        mapViews[i]            = staticLayers.createLayerView(device, mapImage, i);
+        dynamicFramebuffers[i] = staticLayers.createDynamicFramebuffer(device, mapViews[i]);
+    }
+
+    // Hardware 2x2 PCF needs linear filtering of the depth format, which D16 does not guarantee
+    VkFormatProperties formatProps;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, MAP_FORMAT, &formatProps);
+    const VkFilter filter = (formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+                                ? VK_FILTER_LINEAR
+                                : VK_FILTER_NEAREST;
+
+    // Outside a cascade compares against the white border, i.e. lit
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType         = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter     = filter;
+    samplerInfo.minFilter     = filter;
+    samplerInfo.mipmapMode    = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeV  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeW  = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.borderColor   = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp     = VK_COMPARE_OP_LESS_OR_EQUAL;
+    samplerInfo.maxLod        = 0.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create shadow sampler");
+
+    // car.vert's set 0 only; there is no fragment shading to feed
+    pipelineLayout = PipelineFactory::createPipelineLayout(device, {cameraLayout});
+
+    // Both passes share a subpass layout, so the pipelines work in either. Open meshes (the car's
+    // panels) cast from either face; the slope bias keeps faces at grazing sun angles off themselves
+    PipelineConfig config;
+    config.vertShader        = "car.vert.spv";
+    config.fragShader        = "depth_only.frag.spv";
+    config.layout            = pipelineLayout;
+    config.cullMode          = VK_CULL_MODE_NONE;
+    config.depthOnly         = true;
+    config.depthBiasConstant = 2.0f;
+    config.depthBiasSlope    = 2.0f;
+
+    VkRenderPass renderPass = staticLayers.getStaticPass();
+    pipeline                = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+    config.vertexFormat     = VertexFormat::Packed;
+    packedPipeline          = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+}
+
+void ShadowCascades::destroy(VkDevice device) {
+    for (VkPipeline* p : {&pipeline, &packedPipeline}) {
+        if (*p != VK_NULL_HANDLE)
+            vkDestroyPipeline(device, *p, nullptr);
+        *p = VK_NULL_HANDLE;
+    }
+    if (pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        if (dynamicFramebuffers[i] != VK_NULL_HANDLE)
+            vkDestroyFramebuffer(device, dynamicFramebuffers[i], nullptr);
+        if (mapViews[i] != VK_NULL_HANDLE)
+            vkDestroyImageView(device, mapViews[i], nullptr);
+        dynamicFramebuffers[i] = VK_NULL_HANDLE;
+        mapViews[i]            = VK_NULL_HANDLE;
+    }
+    if (sampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, sampler, nullptr);
+    staticLayers.destroy(device);
+
+    pipelineLayout = VK_NULL_HANDLE;
+    sampler        = VK_NULL_HANDLE;
+    mapImage       = VK_NULL_HANDLE;
+    cascades       = {};
+}
+
+uint32_t ShadowCascades::beginFrame(const glm::vec3& cameraPosition, uint64_t staticVersion) {
+    uint32_t moved = 0;
+    for (uint32_t i = 0; i < CASCADE_COUNT; i++) {
+        const Cascade& cascade = cascades[i];
+        if (cascade.valid && staticVersion == renderedStatic &&
+            glm::length(cameraPosition - cascade.anchor) <= CASCADE_RADII[i] * RECENTER_FRACTION)
+            continue;
+
+        place(i, cameraPosition);
+        moved |= 1u << i;
+    }
+    renderedStatic = staticVersion;
+    return moved;
+}
+
+void ShadowCascades::place(uint32_t index, const glm::vec3& cameraPosition) {
+    // A fixed basis along the sun, so snapped windows line up texel for texel from one placement to the next
+    const glm::vec3 sun   = getSunDirection();
+    const glm::vec3 right = glm::normalize(glm::cross(sun, glm::vec3(0.0f, 1.0f, 0.0f)));
+    const glm::vec3 up    = glm::cross(right, sun);
+
+    // The camera may move RECENTER_FRACTION of the radius before this cascade is placed again, and
+    // anything within the radius of it must still be inside: pad the window by as much
+    const float half  = CASCADE_RADII[index] * (1.0f + RECENTER_FRACTION);
+    const float texel = getTexelSize(index);
+    const float u     = std::floor(glm::dot(cameraPosition, right) / texel) * texel;
+    const float v     = std::floor(glm::dot(cameraPosition, up) / texel) * texel;
+
+    // Depth 0 sits toward the sun past anything the window can reach; depth 1 as far beyond it
+    const float top   = glm::dot(cameraPosition, sun) + half + DEPTH_MARGIN;
+    const float range = 2.0f * (half + DEPTH_MARGIN);
+
+    // clip = (dot(p, right) - u) / half, (dot(p, up) - v) / half, (top - dot(p, sun)) / range
+    glm::mat4& viewProj = viewProjs[index];
+    viewProj            = glm::mat4(0.0f);
+    for (int axis = 0; axis < 3; axis++) {
+        viewProj[axis][0] = right[axis] / half;
+        viewProj[axis][1] = up[axis] / half;
+        viewProj[axis][2] = -sun[axis] / range;
+    }
+    viewProj[3] = glm::vec4(-u / half, -v / half, top / range, 1.0f);
+
+    cascades[index].anchor = cameraPosition;
+    cascades[index].valid  = true;
+}
+
+void ShadowCascades::beginStaticPass(VkCommandBuffer cmd, uint32_t cascade) const {
+    staticLayers.beginStaticPass(cmd, cascade);
+}
+
+void ShadowCascades::endStaticPass(VkCommandBuffer cmd) const {
+    staticLayers.endPass(cmd);
+}
+
+void ShadowCascades::copyStaticLayers(VkCommandBuffer cmd) const {
+    // The render graph moved the whole map to TRANSFER_DST
+    staticLayers.copyToTarget(cmd, mapImage);
+}
+
+void ShadowCascades::beginDynamicPass(VkCommandBuffer cmd, uint32_t cascade) const {
+    staticLayers.beginDynamicPass(cmd, dynamicFramebuffers[cascade]);
+}
+
+void ShadowCascades::endDynamicPass(VkCommandBuffer cmd) const {
+    staticLayers.endPass(cmd);
+}
+
+VkPipeline ShadowCascades::getPipeline(VertexFormat format) const {
+    return format == VertexFormat::Packed ? packedPipeline : pipeline;
+}
+
+}  // namespace DownPour
@@ -0,0 +1,132 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "CachedDepthLayers.h"
+#include "core/PipelineFactory.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Cascaded sun shadow maps whose static layers are cached between frames
+ *
+ * Each cascade is an orthographic depth view along the sun over a square
+ * around the camera, one layer of a 2D array. The static world (the road and
+ * the scenery streamed with it) is rendered into a cascade's own static layer
+ * (CachedDepthLayers) only when the camera has moved RECENTER_FRACTION of the
+ * cascade's radius from where the layer was rendered, or the caller's static
+ * version changes.
+ * Each frame copies the static layers into the sampled map and draws the
+ * moving casters (the car, traffic) over them, so the per-frame cost follows
+ * the dynamic casters rather than the 50 km road.
+ *
+ * The sampled map belongs to the render graph and is a CASCADE_COUNT-layer
+ * array; recordings begin with it in TRANSFER_DST_OPTIMAL and leave it as a
+ * depth attachment.
+ *
+ * Both passes draw with car.vert; bind set 0 with a CameraUBO whose viewProj
+ * is the cascade's getViewProj().
+ */
+class ShadowCascades {
+public:
+    static constexpr uint32_t CASCADE_COUNT = 3;
+    static constexpr uint32_t RESOLUTION    = 2048;
+
+    // Metres from the camera each cascade covers; beyond the last, nothing is shadowed
+    static constexpr std::array<float, CASCADE_COUNT> CASCADE_RADII = {12.0f, 48.0f, 192.0f};
+
+    static constexpr float RECENTER_FRACTION = 0.25f;  // Of the radius; the window is padded by as much
+    static constexpr float DEPTH_MARGIN      = 50.0f;  // Metres past the window's reach, for hills and casters
+
+    static constexpr VkFormat MAP_FORMAT = VK_FORMAT_D16_UNORM;
+
+    ShadowCascades()  = default;
+    ~ShadowCascades() = default;
+
+    ShadowCascades(const ShadowCascades&)            = delete;
+    ShadowCascades& operator=(const ShadowCascades&) = delete;
+
+    /** @brief Unit vector toward the sun, the one the scene shaders light with */
+    static glm::vec3 getSunDirection();
+
+    /**
+     * @brief Create the static layers, render passes, comparison sampler and depth-only pipelines
+     * @param mapImage RESOLUTION-square, CASCADE_COUNT-layer MAP_FORMAT image the scene samples, with depth
+     *                 attachment, transfer destination and sampled usage; owned by the caller
+     * @param cameraLayout Descriptor set layout of car.vert's set 0 (camera UBO + object SSBO)
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkImage mapImage, VkDescriptorSetLayout cameraLayout,
+              VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Place this frame's cascades; call before culling and before recording either pass
+     * @param staticVersion Changes whenever the static geometry does
+     * @return Bit N set: cascade N moved, so its static pass must be recorded this frame
+     */
+    uint32_t beginFrame(const glm::vec3& cameraPosition, uint64_t staticVersion);
+
+    /**
+     * @brief Begin a cascade's static pass, which clears its static layer; record outside any render pass
+     */
+    void beginStaticPass(VkCommandBuffer cmd, uint32_t cascade) const;
+    void endStaticPass(VkCommandBuffer cmd) const;
+
+    /**
+     * @brief Copy every static layer into the sampled map, leaving the map a depth attachment
+     */
+    void copyStaticLayers(VkCommandBuffer cmd) const;
+
+    /**
+     * @brief Begin drawing the moving casters over a cascade's copied layer; after copyStaticLayers()
+     */
+    void beginDynamicPass(VkCommandBuffer cmd, uint32_t cascade) const;
+    void endDynamicPass(VkCommandBuffer cmd) const;
+
+    /** @brief World to cascade clip space: the sun's right and up across the square, along it into depth */
+    const glm::mat4& getViewProj(uint32_t cascade) const { return viewProjs[cascade]; }
+
+    /** @brief Every cascade's getViewProj(), in order; extra views for Scene::cullDrawList() */
+    const std::array<glm::mat4, CASCADE_COUNT>& getViewProjs() const { return viewProjs; }
+
+    /** @brief World size of one texel in @p cascade, for the shaders' normal offset */
+    static float getTexelSize(uint32_t cascade);
+
+    VkPipeline       getPipeline(VertexFormat format) const;
+    VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
+
+    /** @brief Depth comparison sampler: filtered 2x2 where the format allows it, lit outside the map */
+    VkSampler getSampler() const { return sampler; }
+
+private:
+    struct Cascade {
+        glm::vec3 anchor = glm::vec3(0.0f);  // Camera position the static layer was rendered around
+        bool      valid  = false;
+    };
+
+    // mapImage is sampled by the scene; staticLayers keep each cascade's world between recenters
+    CachedDepthLayers                        staticLayers;
+    VkImage                                  mapImage = VK_NULL_HANDLE;  // Not owned
+    std::array<VkImageView, CASCADE_COUNT>   mapViews{};                 // One layer each, for the framebuffers
+    std::array<VkFramebuffer, CASCADE_COUNT> dynamicFramebuffers{};
+    VkSampler                                sampler = VK_NULL_HANDLE;
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline       pipeline       = VK_NULL_HANDLE;
+    VkPipeline       packedPipeline = VK_NULL_HANDLE;  // PackedVertex input
+
+    std::array<Cascade, CASCADE_COUNT>   cascades{};
+    std::array<glm::mat4, CASCADE_COUNT> viewProjs{};
+    uint64_t                             renderedStatic = 0;  // staticVersion the static layers hold
+
+    void place(uint32_t index, const glm::vec3& cameraPosition);
+};
+
+}  // namespace DownPour
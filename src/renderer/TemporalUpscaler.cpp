@@ -0,0 +1,473 @@
+// SPDX-License-Identifier: MIT
+#include "TemporalUpscaler.h"
+
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace DownPour {
+
+namespace {
+
+struct ResolveParams {
+    glm::vec2  jitter;  // The frame's sub-pixel offset, in render pixels
+    glm::uvec2 renderExtent;
+    glm::uvec2 outputExtent;
+    uint32_t   historyValid;
+    uint32_t   padding;
+};
+
+struct EncodeParams {
+    glm::uvec2 outputExtent;
+    uint32_t   swapRedBlue;
+    uint32_t   encodeSrgb;
+};
+
+// Radical inverse of `index` in `base`: a low-discrepancy sequence in [0, 1)
+float halton(uint32_t index, uint32_t base) {
+    float result   = 0.0f;
+    float fraction = 1.0f;
+    while (index > 0) {
+        fraction /= static_cast<float>(base);
+        result += fraction * static_cast<float>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+VkSampler createSampler(VkDevice device, VkFilter filter) {
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter               = filter;
+    samplerInfo.minFilter               = filter;
+    samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.minLod                  = 0.0f;
+    samplerInfo.maxLod                  = 0.0f;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable           = VK_FALSE;
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upscaler sampler");
+    return sampler;
+}
+
+}  // namespace
+
+void TemporalUpscaler::init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D extent,
+                            VkFormat outputFormat, VkImageView sceneColorView, VkImageView motionView,
+                            VkPipelineCache pipelineCache) {
+    outputExtent = extent;
+
+    // Blitting to the swap chain converts the format for free, but BLIT_DST is optional for swap chain formats
+    VkFormatProperties outputProperties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, outputFormat, &outputProperties);
+    copyOutput = !(outputProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
+    if (copyOutput) {
+        switch (outputFormat) {
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                swapRedBlue = 1;
+                encodeSrgb  = 1;
+                break;
+            case VK_FORMAT_B8G8R8A8_UNORM:
+                swapRedBlue = 1;
+                encodeSrgb  = 0;
+                break;
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                swapRedBlue = 0;
+                encodeSrgb  = 1;
+                break;
+            case VK_FORMAT_R8G8B8A8_UNORM:
+                swapRedBlue = 0;
+                encodeSrgb  = 0;
+                break;
+            default:
+                throw std::runtime_error("Swap chain format " + std::to_string(outputFormat) +
+                                         " can neither be blitted nor copied to");
+        }
+    }
+
+    createImages(device, physicalDevice);
+    createDescriptors(device, sceneColorView, motionView);
+
+    VkPushConstantRange range{};
+    range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    range.offset     = 0;
+    range.size       = sizeof(ResolveParams);
+
+    pipelineLayout = PipelineFactory::createPipelineLayout(device, {setLayout}, {range});
+    pipeline = PipelineFactory::createComputePipeline(device, "temporal_upscale.comp.spv", pipelineLayout,
+                                                      pipelineCache);
+
+    if (copyOutput)
+        createEncoder(device, physicalDevice, pipelineCache);
+
+    resolved = false;
+}
+
+void TemporalUpscaler::destroy(VkDevice device) {
+    if (encodePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, encodePipeline, nullptr);
+    if (encodePipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, encodePipelineLayout, nullptr);
+    if (encodeSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, encodeSetLayout, nullptr);
+    if (encodeView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, encodeView, nullptr);
+    if (encodeImage != VK_NULL_HANDLE)
+        ResourceManager::destroyImage(device, encodeImage, encodeMemory);
+    if (pipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    if (pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees every set
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    if (linearSampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, linearSampler, nullptr);
+    if (nearestSampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, nearestSampler, nullptr);
+    for (uint32_t i = 0; i < historyImages.size(); i++) {
+        if (historyViews[i] != VK_NULL_HANDLE)
+            vkDestroyImageView(device, historyViews[i], nullptr);
+        ResourceManager::destroyImage(device, historyImages[i], historyMemory[i]);
+        historyViews[i] = VK_NULL_HANDLE;
+    }
+
+    pipeline             = VK_NULL_HANDLE;
+    pipelineLayout       = VK_NULL_HANDLE;
+    pool                 = VK_NULL_HANDLE;
+    setLayout            = VK_NULL_HANDLE;
+    linearSampler        = VK_NULL_HANDLE;
+    nearestSampler       = VK_NULL_HANDLE;
+    sets                 = {};
+    encodePipeline       = VK_NULL_HANDLE;
+    encodePipelineLayout = VK_NULL_HANDLE;
+    encodeSetLayout      = VK_NULL_HANDLE;
+    encodeView           = VK_NULL_HANDLE;
+    encodeImage          = VK_NULL_HANDLE;
+    encodeSets           = {};
+    copyOutput           = false;
+    resolved             = false;
+}
+
+glm::mat4 TemporalUpscaler::jitterProjection(const glm::mat4& proj, VkExtent2D renderExtent) {
+    // Phase 0 would be the pixel's corner; start the sequence at 1
+    const uint32_t phase = frameCount % JITTER_PHASES + 1;
+    pendingJitter        = glm::vec2(halton(phase, 2), halton(phase, 3)) - 0.5f;
+    pendingRender        = {std::min(renderExtent.width, outputExtent.width),
+                            std::min(renderExtent.height, outputExtent.height)};
+
+    // Scaled by view z, which is -w, so every point moves the same -jitter render pixels (2 / size in NDC each)
+    glm::mat4 jittered = proj;
+    jittered[2][0] += pendingJitter.x * 2.0f / static_cast<float>(pendingRender.width);
+    jittered[2][1] += pendingJitter.y * 2.0f / static_cast<float>(pendingRender.height);
+    return jittered;
+}
+
+void TemporalUpscaler::record(VkCommandBuffer cmd, VkImage outputImage) {
+    if (pipeline == VK_NULL_HANDLE || pendingRender.width == 0 || pendingRender.height == 0)
+        return;
+
+    ResolveParams params{};
+    params.jitter       = pendingJitter;
+    params.renderExtent = glm::uvec2(pendingRender.width, pendingRender.height);
+    params.outputExtent = glm::uvec2(outputExtent.width, outputExtent.height);
+    params.historyValid = resolved ? 1u : 0u;
+
+    const uint32_t writeIndex = resolved ? 1 - readIndex : 0;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &sets[writeIndex], 0,
+                            nullptr);
+    vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(cmd, (outputExtent.width + GROUP_SIZE - 1) / GROUP_SIZE,
+                  (outputExtent.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+    if (copyOutput) {
+        recordEncodeAndCopy(cmd, writeIndex, outputImage);
+    } else {
+        // The result is blitted straight from GENERAL, so the render graph keeps seeing it as a storage image
+        VkImageMemoryBarrier barrier{};
+        barrier.sType                       = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask               = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask               = VK_ACCESS_TRANSFER_READ_BIT;
+        barrier.oldLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                       = historyImages[writeIndex];
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                             0, nullptr, 1, &barrier);
+
+        // Same size, so the blit only converts to the swap chain's format
+        VkImageBlit blit{};
+        blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        blit.srcOffsets[1]  = {static_cast<int32_t>(outputExtent.width), static_cast<int32_t>(outputExtent.height), 1};
+        blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        blit.dstOffsets[1]  = blit.srcOffsets[1];
+        vkCmdBlitImage(cmd, historyImages[writeIndex], VK_IMAGE_LAYOUT_GENERAL, outputImage,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_NEAREST);
+    }
+
+    // Next frame's resolve and encode overwrite what the transfer reads; the graph's barriers only wait on compute
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 0, nullptr);
+
+    readIndex = writeIndex;
+    frameCount++;
+    resolved = true;
+}
+
+void TemporalUpscaler::createImages(VkDevice device, VkPhysicalDevice physicalDevice) {
+    for (uint32_t i = 0; i < historyImages.size(); i++) {
+        ResourceManager::createImage(device, physicalDevice, outputExtent.width, outputExtent.height, HISTORY_FORMAT,
+                                     VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, historyImages[i], historyMemory[i]);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType                       = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image                       = historyImages[i];
+        viewInfo.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format                      = HISTORY_FORMAT;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(device, &viewInfo, nullptr, &historyViews[i]) != VK_SUCCESS)
+            throw std::runtime_error("Failed to create upscaler history view");
+    }
+
+    nearestSampler = createSampler(device, VK_FILTER_NEAREST);
+    linearSampler  = createSampler(device, VK_FILTER_LINEAR);
+}
+
+void TemporalUpscaler::createDescriptors(VkDevice device, VkImageView sceneColorView, VkImageView motionView) {
+    // Binding 0 = scene color, 1 = motion, 2 = history (sampled), 3 = result (storage)
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t b = 0; b < bindings.size(); b++) {
+        bindings[b].binding         = b;
+        bindings[b].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[b].descriptorCount = 1;
+        bindings[b].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upscaler descriptor set layout");
+
+    const uint32_t setCount = static_cast<uint32_t>(sets.size());
+
+    // The encode sets, when used, take one sampled and one storage image each
+    const uint32_t encodeSetCount = copyOutput ? static_cast<uint32_t>(encodeSets.size()) : 0;
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = 3 * setCount + encodeSetCount;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = setCount + encodeSetCount;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = setCount + encodeSetCount;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upscaler descriptor pool");
+
+    std::array<VkDescriptorSetLayout, 2> layouts = {setLayout, setLayout};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts        = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate upscaler descriptor sets");
+
+    VkDescriptorImageInfo colorInfo{};
+    colorInfo.sampler     = nearestSampler;
+    colorInfo.imageView   = sceneColorView;
+    colorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorImageInfo motionInfo = colorInfo;
+    motionInfo.imageView             = motionView;
+
+    for (uint32_t set = 0; set < setCount; set++) {
+        VkDescriptorImageInfo historyInfo{};
+        historyInfo.sampler     = linearSampler;
+        historyInfo.imageView   = historyViews[1 - set];
+        historyInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo resultInfo{};
+        resultInfo.imageView   = historyViews[set];
+        resultInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 4> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = sets[set];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = bindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
+        }
+        writes[0].pImageInfo = &colorInfo;
+        writes[1].pImageInfo = &motionInfo;
+        writes[2].pImageInfo = &historyInfo;
+        writes[3].pImageInfo = &resultInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void TemporalUpscaler::createEncoder(VkDevice device, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache) {
+    ResourceManager::createImage(device, physicalDevice, outputExtent.width, outputExtent.height, ENCODE_FORMAT,
+                                 VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, encodeImage, encodeMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                       = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                       = encodeImage;
+    viewInfo.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format                      = ENCODE_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &encodeView) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upscaler encode view");
+
+    // Binding 0 = resolved history (sampled), 1 = encoded output (storage)
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    for (uint32_t b = 0; b < bindings.size(); b++) {
+        bindings[b].binding         = b;
+        bindings[b].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[b].descriptorCount = 1;
+        bindings[b].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &encodeSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create upscaler encode descriptor set layout");
+
+    // The pool was sized for these sets too (see createDescriptors)
+    std::array<VkDescriptorSetLayout, 2> layouts = {encodeSetLayout, encodeSetLayout};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(encodeSets.size());
+    allocInfo.pSetLayouts        = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, encodeSets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate upscaler encode descriptor sets");
+
+    VkDescriptorImageInfo encodedInfo{};
+    encodedInfo.imageView   = encodeView;
+    encodedInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    for (uint32_t set = 0; set < encodeSets.size(); set++) {
+        VkDescriptorImageInfo historyInfo{};
+        historyInfo.sampler     = nearestSampler;
+        historyInfo.imageView   = historyViews[set];
+        historyInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = encodeSets[set];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = bindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
+        }
+        writes[0].pImageInfo = &historyInfo;
+        writes[1].pImageInfo = &encodedInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    VkPushConstantRange range{};
+    range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    range.offset     = 0;
+    range.size       = sizeof(EncodeParams);
+
+    encodePipelineLayout = PipelineFactory::createPipelineLayout(device, {encodeSetLayout}, {range});
+    encodePipeline = PipelineFactory::createComputePipeline(device, "upscale_encode.comp.spv", encodePipelineLayout,
+                                                            pipelineCache);
+}
+
+void TemporalUpscaler::recordEncodeAndCopy(VkCommandBuffer cmd, uint32_t historyIndex, VkImage outputImage) {
+    // The resolve's result is read by the encode; the encode image's old contents are never read
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    for (VkImageMemoryBarrier& barrier : barriers) {
+        barrier.sType                       = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.newLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+    }
+    barriers[0].srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barriers[0].oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
+    barriers[0].image         = historyImages[historyIndex];
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barriers[1].oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].image         = encodeImage;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                         nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    EncodeParams params{};
+    params.outputExtent = glm::uvec2(outputExtent.width, outputExtent.height);
+    params.swapRedBlue  = swapRedBlue;
+    params.encodeSrgb   = encodeSrgb;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, encodePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, encodePipelineLayout, 0, 1,
+                            &encodeSets[historyIndex], 0, nullptr);
+    vkCmdPushConstants(cmd, encodePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(cmd, (outputExtent.width + GROUP_SIZE - 1) / GROUP_SIZE,
+                  (outputExtent.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+    VkImageMemoryBarrier encoded = barriers[1];
+    encoded.srcAccessMask        = VK_ACCESS_SHADER_WRITE_BIT;
+    encoded.dstAccessMask        = VK_ACCESS_TRANSFER_READ_BIT;
+    encoded.oldLayout            = VK_IMAGE_LAYOUT_GENERAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &encoded);
+
+    // Same texel size and layout as the swap chain format, so a plain copy is exact
+    VkImageCopy copy{};
+    copy.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    copy.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    copy.extent         = {outputExtent.width, outputExtent.height, 1};
+    vkCmdCopyImage(cmd, encodeImage, VK_IMAGE_LAYOUT_GENERAL, outputImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                   &copy);
+}
+
+}  // namespace DownPour
@@ -0,0 +1,126 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/MemoryAllocator.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace DownPour {
+
+/**
+ * @brief Reconstructs the scene, rendered at a reduced and jittered resolution, at the output size
+ *
+ * Every frame renders with its projection shifted by a different sub-pixel
+ * offset (Halton 2,3 over JITTER_PHASES frames), so successive frames sample
+ * different points inside each pixel. record() then resolves each output pixel
+ * from the rendered samples nearest to it, and blends that into the history:
+ * last frame's result, reprojected through the main pass's motion vectors and
+ * clamped to the colors of the rendered samples around the pixel, so history
+ * that no longer fits (disocclusions, lighting changes) fades within a frame or
+ * two. Over a few frames the output gathers more detail than one frame at the
+ * render resolution holds, so DynamicResolution's scaled-down frames stay
+ * sharp; at full scale the same resolve antialiases edges.
+ *
+ * The two history images alternate at the output size: a resolve reads one
+ * and writes the other, which is then blitted to the swap chain image. Swap
+ * chain formats without VK_FORMAT_FEATURE_BLIT_DST_BIT get the result through
+ * a second pass instead, which encodes it into an 8-bit image laid out like the
+ * swap chain's format, copied over with vkCmdCopyImage.
+ */
+class TemporalUpscaler {
+public:
+    static constexpr VkFormat HISTORY_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+    static constexpr VkFormat ENCODE_FORMAT  = VK_FORMAT_R8G8B8A8_UNORM;  // Copy-compatible with 8-bit swap chains
+    static constexpr uint32_t GROUP_SIZE     = 8;                         // Both axes; must match both compute shaders
+    static constexpr uint32_t JITTER_PHASES  = 8;
+
+    TemporalUpscaler()  = default;
+    ~TemporalUpscaler() = default;
+
+    TemporalUpscaler(const TemporalUpscaler&)            = delete;
+    TemporalUpscaler& operator=(const TemporalUpscaler&) = delete;
+
+    /**
+     * @brief Create the history images and the resolve pipeline
+     * @param outputFormat The swap chain's format; decides between the blit and the encode-and-copy path
+     * @param sceneColorView The main pass's color; the image needs VK_IMAGE_USAGE_SAMPLED_BIT
+     * @param motionView The main pass's motion vectors (SwapChainManager::MOTION_FORMAT), likewise
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D outputExtent, VkFormat outputFormat,
+              VkImageView sceneColorView, VkImageView motionView, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Drop the history, e.g. after a camera cut; the next resolve starts from that frame alone
+     */
+    void invalidate() { resolved = false; }
+
+    /**
+     * @brief This frame's projection, shifted by the frame's sub-pixel offset; call once per frame before record()
+     * @param proj The view's projection, Y already flipped for Vulkan
+     * @param renderExtent Top-left region of the scene color the frame renders into
+     */
+    glm::mat4 jitterProjection(const glm::mat4& proj, VkExtent2D renderExtent);
+
+    /**
+     * @brief Resolve the frame into the next history image and blit (or encode and copy) it over @p outputImage
+     *
+     * Record after the main pass, outside a render pass, with the scene color and motion in
+     * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and both history images in VK_IMAGE_LAYOUT_GENERAL, all
+     * ready for compute shaders, and @p outputImage in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL. The history
+     * images are left as they came, ready for the next frame's compute shaders.
+     */
+    void record(VkCommandBuffer cmd, VkImage outputImage);
+
+    VkImage getHistoryImage(uint32_t index) const { return historyImages[index]; }
+
+private:
+    VkExtent2D outputExtent = {0, 0};
+
+    std::array<VkImage, 2>     historyImages{};
+    std::array<Allocation, 2>  historyMemory{};
+    std::array<VkImageView, 2> historyViews{};
+
+    VkSampler nearestSampler = VK_NULL_HANDLE;  // Rendered samples and motion, fetched by texel
+    VkSampler linearSampler  = VK_NULL_HANDLE;  // The reprojected history
+
+    // Set N reads history image 1 - N and writes image N
+    VkDescriptorSetLayout          setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool               pool      = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> sets{};
+    VkPipelineLayout               pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline                     pipeline       = VK_NULL_HANDLE;
+
+    // Encode-and-copy output, only created when the swap chain format cannot be blitted to.
+    // Encode set N reads history image N.
+    bool                           copyOutput  = false;
+    uint32_t                       swapRedBlue = 0;
+    uint32_t                       encodeSrgb  = 0;
+    VkImage                        encodeImage = VK_NULL_HANDLE;
+    Allocation                     encodeMemory{};
+    VkImageView                    encodeView      = VK_NULL_HANDLE;
+    VkDescriptorSetLayout          encodeSetLayout = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> encodeSets{};
+    VkPipelineLayout               encodePipelineLayout = VK_NULL_HANDLE;
+    VkPipeline                     encodePipeline       = VK_NULL_HANDLE;
+
+    // What jitterProjection() set up for this frame's record()
+    glm::vec2  pendingJitter{0.0f};  // Render pixels
+    VkExtent2D pendingRender = {0, 0};
+    uint32_t   frameCount    = 0;  // Picks the jitter phase
+    uint32_t   readIndex     = 0;  // The newest history image
+    bool       resolved      = false;
+
+    void createImages(VkDevice device, VkPhysicalDevice physicalDevice);
+    void createDescriptors(VkDevice device, VkImageView sceneColorView, VkImageView motionView);
+    void createEncoder(VkDevice device, VkPhysicalDevice physicalDevice, VkPipelineCache pipelineCache);
+    void recordEncodeAndCopy(VkCommandBuffer cmd, uint32_t historyIndex, VkImage outputImage);
+};
+
+}  // namespace DownPour
@@ -1,9 +1,45 @@
 #include "Vertex.h"
 
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 
 namespace DownPour {
 
+namespace {
+
+uint16_t quantizeUnorm(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+int16_t quantizeSnorm(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float signNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+/**
+ * @brief Project a unit vector onto the octahedron and unfold it into [-1, 1]^2
+ */
+glm::vec2 encodeOctahedral(const glm::vec3& n) {
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 <= 0.0f)
+        return glm::vec2(0.0f);  // Degenerate normal: decodes to +Z
+
+    glm::vec2 p(n.x / l1, n.y / l1);
+    if (n.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        p = glm::vec2((1.0f - std::abs(p.y)) * signNotZero(p.x), (1.0f - std::abs(p.x)) * signNotZero(p.y));
+    }
+    return p;
+}
+
+}  // namespace
+
 VkVertexInputBindingDescription Vertex::getBindingDescription() {
     VkVertexInputBindingDescription bindingDescription{};
     bindingDescription.binding   = 0;
@@ -36,4 +72,63 @@ std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescription
     return attributeDescriptions;
 }
 
-};  // namespace DownPour
\ No newline at end of file
+VertexQuantization VertexQuantization::fromBounds(const glm::vec3& minBounds, const glm::vec3& maxBounds) {
+    VertexQuantization quantization;
+    quantization.offset = minBounds;
+
+    // A flat axis still needs a non-zero scale to divide by
+    const glm::vec3 extent = maxBounds - minBounds;
+    quantization.scale     = glm::vec3(extent.x > 0.0f ? extent.x : 1.0f, extent.y > 0.0f ? extent.y : 1.0f,
+                                       extent.z > 0.0f ? extent.z : 1.0f);
+    return quantization;
+}
+
+PackedVertex PackedVertex::pack(const Vertex& vertex, const VertexQuantization& quantization) {
+    PackedVertex packed;
+    packed.position[0] = quantizeUnorm((vertex.position.x - quantization.offset.x) / quantization.scale.x);
+    packed.position[1] = quantizeUnorm((vertex.position.y - quantization.offset.y) / quantization.scale.y);
+    packed.position[2] = quantizeUnorm((vertex.position.z - quantization.offset.z) / quantization.scale.z);
+    packed.position[3] = 0;
+
+    const glm::vec2 octahedral = encodeOctahedral(vertex.normal);
+    packed.normal[0]           = quantizeSnorm(octahedral.x);
+    packed.normal[1]           = quantizeSnorm(octahedral.y);
+
+    packed.texCoord[0] = glm::packHalf1x16(vertex.texCoord.x);
+    packed.texCoord[1] = glm::packHalf1x16(vertex.texCoord.y);
+    return packed;
+}
+
+VkVertexInputBindingDescription PackedVertex::getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding   = 0;
+    bindingDescription.stride    = sizeof(PackedVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 3> PackedVertex::getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+    // Position at location 0 (the shader's vec3 drops the padding component)
+    attributeDescriptions[0].binding  = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format   = VK_FORMAT_R16G16B16A16_UNORM;
+    attributeDescriptions[0].offset   = offsetof(PackedVertex, position);
+
+    // Octahedral normal at location 1 (arrives as inNormal.xy, z = 0)
+    attributeDescriptions[1].binding  = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format   = VK_FORMAT_R16G16_SNORM;
+    attributeDescriptions[1].offset   = offsetof(PackedVertex, normal);
+
+    // TexCoord at location 2
+    attributeDescriptions[2].binding  = 0;
+    attributeDescriptions[2].location = 2;
+    attributeDescriptions[2].format   = VK_FORMAT_R16G16_SFLOAT;
+    attributeDescriptions[2].offset   = offsetof(PackedVertex, texCoord);
+
+    return attributeDescriptions;
+}
+
+};  // namespace DownPour
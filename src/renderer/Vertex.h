@@ -2,10 +2,19 @@
 #include <vulkan/vulkan.h>
 
 #include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace DownPour {
 
+/**
+ * @brief Layout of a model's GPU vertex buffer, chosen per model at load time
+ */
+enum class VertexFormat : uint32_t {
+    Float,   // Vertex: full-float position, normal and UV (32 bytes)
+    Packed,  // PackedVertex: quantized position, octahedral normal, half-float UV (16 bytes)
+};
+
 struct Vertex {
     glm::vec3                                               position;
     glm::vec3                                               normal;
@@ -14,4 +23,35 @@ struct Vertex {
     static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
 };
 
-};  // namespace DownPour
\ No newline at end of file
+/**
+ * @brief Maps 16-bit quantized positions back into model space: position = offset + unorm * scale
+ *
+ * Built from the model's AABB, so precision is the AABB extent / 65535 per axis.
+ */
+struct VertexQuantization {
+    glm::vec3 offset = glm::vec3(0.0f);
+    glm::vec3 scale  = glm::vec3(1.0f);
+
+    static VertexQuantization fromBounds(const glm::vec3& minBounds, const glm::vec3& maxBounds);
+};
+
+/**
+ * @brief Compact vertex for VertexFormat::Packed, half the size of Vertex
+ *
+ * Same shader locations as Vertex. The normal arrives in inNormal.xy and is
+ * decoded in the vertex shader; ObjectData carries the position dequantization.
+ */
+struct PackedVertex {
+    uint16_t position[4];  // UNORM over VertexQuantization; w is padding (3-component 16-bit formats are rare)
+    int16_t  normal[2];    // Octahedral-encoded unit normal, SNORM
+    uint16_t texCoord[2];  // Half floats
+
+    static PackedVertex pack(const Vertex& vertex, const VertexQuantization& quantization);
+
+    static VkVertexInputBindingDescription                  getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must match its attribute formats");
+
+};  // namespace DownPour
@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: MIT
+#include "WetRoadReflections.h"
+
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+struct ReduceParams {
+    glm::ivec2 srcSize;
+    glm::ivec2 dstSize;
+};
+
+// Levels a pyramid whose first level is `extent` needs to reach a single texel
+uint32_t levelsFor(VkExtent2D extent) {
+    uint32_t levels = 1;
+    while ((std::max(extent.width, extent.height) >> levels) > 0)
+        levels++;
+    return levels;
+}
+
+VkImageView createView(VkDevice device, VkImage image, VkFormat format, uint32_t baseLevel, uint32_t levels) {
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image                           = image;
+    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format                          = format;
+    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel   = baseLevel;
+    viewInfo.subresourceRange.levelCount     = levels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount     = 1;
+
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection image view");
+    return view;
+}
+
+VkSampler createSampler(VkDevice device, VkFilter filter, float maxLod) {
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter               = filter;
+    samplerInfo.minFilter               = filter;
+    samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.minLod                  = 0.0f;
+    samplerInfo.maxLod                  = maxLod;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable           = VK_FALSE;
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection sampler");
+    return sampler;
+}
+
+VkImageMemoryBarrier pyramidBarrier(VkImage image, uint32_t level) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType                         = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask                 = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask                 = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout                     = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.newLayout                     = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex           = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex           = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image                         = image;
+    barrier.subresourceRange.aspectMask   = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = level;
+    barrier.subresourceRange.levelCount   = 1;
+    barrier.subresourceRange.layerCount   = 1;
+    return barrier;
+}
+
+}  // namespace
+
+void WetRoadReflections::init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D outputExtent,
+                              VkImageView depthView, VkImageView sceneColorView, VkBuffer frameBuffer,
+                              VkPipelineCache pipelineCache) {
+    imageExtent = {(outputExtent.width + 1) / 2, (outputExtent.height + 1) / 2};
+    levelCount  = levelsFor(imageExtent);
+    createImages(device, physicalDevice);
+    createDescriptors(device, depthView, sceneColorView, frameBuffer);
+
+    VkPushConstantRange reduceRange{};
+    reduceRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    reduceRange.offset     = 0;
+    reduceRange.size       = sizeof(ReduceParams);
+
+    reduceLayout   = PipelineFactory::createPipelineLayout(device, {reduceSetLayout}, {reduceRange});
+    reducePipeline = PipelineFactory::createComputePipeline(device, "reflection_depth.comp.spv", reduceLayout,
+                                                            pipelineCache);
+
+    traceLayout   = PipelineFactory::createPipelineLayout(device, {traceSetLayout});
+    tracePipeline = PipelineFactory::createComputePipeline(device, "reflection_trace.comp.spv", traceLayout,
+                                                           pipelineCache);
+
+    traced = false;
+}
+
+void WetRoadReflections::destroy(VkDevice device) {
+    if (tracePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, tracePipeline, nullptr);
+    if (traceLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, traceLayout, nullptr);
+    if (reducePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, reducePipeline, nullptr);
+    if (reduceLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, reduceLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees every set
+    if (traceSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, traceSetLayout, nullptr);
+    if (reduceSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, reduceSetLayout, nullptr);
+    if (linearSampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, linearSampler, nullptr);
+    if (nearestSampler != VK_NULL_HANDLE)
+        vkDestroySampler(device, nearestSampler, nullptr);
+    for (uint32_t i = 0; i < colorImages.size(); i++) {
+        if (colorViews[i] != VK_NULL_HANDLE)
+            vkDestroyImageView(device, colorViews[i], nullptr);
+        ResourceManager::destroyImage(device, colorImages[i], colorMemory[i]);
+        colorViews[i] = VK_NULL_HANDLE;
+    }
+    for (VkImageView view : levelViews)
+        vkDestroyImageView(device, view, nullptr);
+    if (pyramidView != VK_NULL_HANDLE)
+        vkDestroyImageView(device, pyramidView, nullptr);
+    ResourceManager::destroyImage(device, pyramidImage, pyramidMemory);
+
+    tracePipeline   = VK_NULL_HANDLE;
+    traceLayout     = VK_NULL_HANDLE;
+    reducePipeline  = VK_NULL_HANDLE;
+    reduceLayout    = VK_NULL_HANDLE;
+    pool            = VK_NULL_HANDLE;
+    traceSetLayout  = VK_NULL_HANDLE;
+    reduceSetLayout = VK_NULL_HANDLE;
+    linearSampler   = VK_NULL_HANDLE;
+    nearestSampler  = VK_NULL_HANDLE;
+    pyramidView     = VK_NULL_HANDLE;
+    traceSets       = {};
+    levelViews.clear();
+    reduceSets.clear();
+    traced = false;
+}
+
+void WetRoadReflections::upload(const FrameAllocation& buffer, const glm::mat4& view, const glm::mat4& proj,
+                                const glm::vec3& cameraPosition, float wetness, VkExtent2D renderExtent) {
+    pendingViewProj = proj * view;
+    pendingRender   = {std::min(renderExtent.width, imageExtent.width * 2),
+                       std::min(renderExtent.height, imageExtent.height * 2)};
+    pendingExtent   = {(pendingRender.width + 1) / 2, (pendingRender.height + 1) / 2};
+    pendingLevels   = std::min(levelsFor(pendingExtent), levelCount);
+
+    // A perspective projection maps view distance d to depth -x + y / d
+    ReflectionTraceParams params{};
+    params.viewProj        = pendingViewProj;
+    params.inverseViewProj = glm::inverse(pendingViewProj);
+    params.historyViewProj = tracedViewProj;
+    params.cameraPosition  = glm::vec4(cameraPosition, std::clamp(wetness, 0.0f, 1.0f));
+    params.depthParams     = glm::vec4(proj[2][2], proj[3][2], static_cast<float>(pendingLevels), 0.0f);
+    params.extents =
+        glm::uvec4(pendingExtent.width, pendingExtent.height, tracedExtent.width, tracedExtent.height);
+    params.renderExtent    = glm::uvec4(pendingRender.width, pendingRender.height, traceCount, traced ? 1u : 0u);
+
+    memcpy(buffer.data, &params, sizeof(params));
+    paramsOffset = buffer.dynamicOffset();
+}
+
+void WetRoadReflections::record(VkCommandBuffer cmd) {
+    if (reducePipeline == VK_NULL_HANDLE || tracePipeline == VK_NULL_HANDLE || pendingLevels == 0)
+        return;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipeline);
+
+    // Level 0 reads only the rendered region; depth outside it is stale
+    VkExtent2D src = pendingRender;
+    for (uint32_t level = 0; level < pendingLevels; level++) {
+        VkExtent2D dst = {(src.width + 1) / 2, (src.height + 1) / 2};
+
+        ReduceParams params{};
+        params.srcSize = glm::ivec2(static_cast<int>(src.width), static_cast<int>(src.height));
+        params.dstSize = glm::ivec2(static_cast<int>(dst.width), static_cast<int>(dst.height));
+
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, reduceLayout, 0, 1, &reduceSets[level], 0,
+                                nullptr);
+        vkCmdPushConstants(cmd, reduceLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+        vkCmdDispatch(cmd, (dst.width + GROUP_SIZE - 1) / GROUP_SIZE, (dst.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+        // The level just written is the next dispatch's source, and the trace's
+        VkImageMemoryBarrier levelBarrier = pyramidBarrier(pyramidImage, level);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 1, &levelBarrier);
+        src = dst;
+    }
+
+    // The scene shaders read readIndex this frame; it becomes the history of the other
+    const uint32_t writeIndex = traced ? 1 - readIndex : 0;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, tracePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, traceLayout, 0, 1, &traceSets[writeIndex], 1,
+                            &paramsOffset);
+    vkCmdDispatch(cmd, (pendingExtent.width + GROUP_SIZE - 1) / GROUP_SIZE,
+                  (pendingExtent.height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+
+    tracedViewProj = pendingViewProj;
+    tracedExtent   = pendingExtent;
+    readIndex      = writeIndex;
+    traceCount++;
+    traced = true;
+}
+
+void WetRoadReflections::createImages(VkDevice device, VkPhysicalDevice physicalDevice) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+    imageInfo.extent        = {imageExtent.width, imageExtent.height, 1};
+    imageInfo.mipLevels     = levelCount;
+    imageInfo.arrayLayers   = 1;
+    imageInfo.format        = DEPTH_FORMAT;
+    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage         = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &pyramidImage) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection depth pyramid");
+    ResourceManager::allocateImageMemory(device, pyramidImage, VK_IMAGE_TILING_OPTIMAL,
+                                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pyramidMemory);
+
+    pyramidView = createView(device, pyramidImage, DEPTH_FORMAT, 0, levelCount);
+    levelViews.resize(levelCount, VK_NULL_HANDLE);
+    for (uint32_t level = 0; level < levelCount; level++)
+        levelViews[level] = createView(device, pyramidImage, DEPTH_FORMAT, level, 1);
+
+    for (uint32_t i = 0; i < colorImages.size(); i++) {
+        ResourceManager::createImage(device, physicalDevice, imageExtent.width, imageExtent.height, COLOR_FORMAT,
+                                     VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImages[i], colorMemory[i]);
+        colorViews[i] = createView(device, colorImages[i], COLOR_FORMAT, 0, 1);
+    }
+
+    // Shaders fetch depth and scene color texels explicitly; only the reprojected history is filtered
+    nearestSampler = createSampler(device, VK_FILTER_NEAREST, static_cast<float>(levelCount));
+    linearSampler  = createSampler(device, VK_FILTER_LINEAR, 0.0f);
+}
+
+void WetRoadReflections::createDescriptors(VkDevice device, VkImageView depthView, VkImageView sceneColorView,
+                                           VkBuffer frameBuffer) {
+    // Reduction set: binding 0 = source level (sampled), binding 1 = destination level (storage)
+    std::array<VkDescriptorSetLayoutBinding, 2> reduceBindings{};
+    reduceBindings[0].binding         = 0;
+    reduceBindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    reduceBindings[0].descriptorCount = 1;
+    reduceBindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    reduceBindings[1].binding         = 1;
+    reduceBindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    reduceBindings[1].descriptorCount = 1;
+    reduceBindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(reduceBindings.size());
+    layoutInfo.pBindings    = reduceBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &reduceSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection depth descriptor set layout");
+
+    // Trace set: binding 0 = the whole pyramid, 1 = scene color, 2 = history (sampled), 3 = result (storage),
+    // 4 = ReflectionTraceParams at the frame's dynamic offset
+    std::array<VkDescriptorSetLayoutBinding, 5> traceBindings{};
+    for (uint32_t b = 0; b < traceBindings.size(); b++) {
+        traceBindings[b].binding         = b;
+        traceBindings[b].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        traceBindings[b].descriptorCount = 1;
+        traceBindings[b].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    traceBindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    traceBindings[4].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+
+    layoutInfo.bindingCount = static_cast<uint32_t>(traceBindings.size());
+    layoutInfo.pBindings    = traceBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &traceSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection trace descriptor set layout");
+
+    const uint32_t traceSetCount = static_cast<uint32_t>(traceSets.size());
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = levelCount + 3 * traceSetCount;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = levelCount + traceSetCount;
+    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[2].descriptorCount = traceSetCount;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = levelCount + traceSetCount;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create reflection descriptor pool");
+
+    std::vector<VkDescriptorSetLayout> layouts(levelCount, reduceSetLayout);
+    reduceSets.resize(levelCount, VK_NULL_HANDLE);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = levelCount;
+    allocInfo.pSetLayouts        = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, reduceSets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate reflection depth descriptor sets");
+
+    std::array<VkDescriptorSetLayout, 2> traceLayouts = {traceSetLayout, traceSetLayout};
+    allocInfo.descriptorSetCount                      = traceSetCount;
+    allocInfo.pSetLayouts                             = traceLayouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, traceSets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate reflection trace descriptor sets");
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        if (level == 0 && depthView == VK_NULL_HANDLE)
+            continue;  // Never traced
+
+        VkDescriptorImageInfo srcInfo{};
+        srcInfo.sampler     = nearestSampler;
+        srcInfo.imageView   = level == 0 ? depthView : levelViews[level - 1];
+        srcInfo.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo dstInfo{};
+        dstInfo.imageView   = levelViews[level];
+        dstInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = reduceSets[level];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = reduceBindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
+        }
+        writes[0].pImageInfo = &srcInfo;
+        writes[1].pImageInfo = &dstInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+
+    VkDescriptorImageInfo pyramidInfo{};
+    pyramidInfo.sampler     = nearestSampler;
+    pyramidInfo.imageView   = pyramidView;
+    pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkDescriptorImageInfo colorInfo{};
+    colorInfo.sampler     = nearestSampler;
+    colorInfo.imageView   = sceneColorView;
+    colorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkDescriptorBufferInfo paramsInfo{};
+    paramsInfo.buffer = frameBuffer;
+    paramsInfo.offset = 0;
+    paramsInfo.range  = sizeof(ReflectionTraceParams);
+
+    for (uint32_t set = 0; set < traceSetCount; set++) {
+        VkDescriptorImageInfo historyInfo{};
+        historyInfo.sampler     = linearSampler;
+        historyInfo.imageView   = colorViews[1 - set];
+        historyInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo resultInfo{};
+        resultInfo.imageView   = colorViews[set];
+        resultInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 5> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = traceSets[set];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = traceBindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
+        }
+        writes[0].pImageInfo  = &pyramidInfo;
+        writes[1].pImageInfo  = &colorInfo;
+        writes[2].pImageInfo  = &historyInfo;
+        writes[3].pImageInfo  = &resultInfo;
+        writes[4].pBufferInfo = &paramsInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+}  // namespace DownPour
@@ -0,0 +1,174 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include "core/FrameAllocator.h"
+#include "core/MemoryAllocator.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Parameters of one reflection trace, read by reflection_trace.comp (std140)
+ */
+struct ReflectionTraceParams {
+    glm::mat4  viewProj;
+    glm::mat4  inverseViewProj;
+    glm::mat4  historyViewProj;  // The view the history was traced from
+    glm::vec4  cameraPosition;   // xyz, w: wetness
+    glm::vec4  depthParams;      // View distance = y / (depth + x); z: pyramid levels in use
+    glm::uvec4 extents;          // xy: half-resolution texels traced, zw: the history's
+    glm::uvec4 renderExtent;     // xy: scene color pixels rendered, z: trace count, w: 1 when the history is valid
+};
+
+/**
+ * @brief Screen-space reflections on the wet road, traced at half resolution and accumulated over frames
+ *
+ * Once the main pass has ended, record() reduces its depth into a
+ * half-resolution pyramid holding the nearest depth under each texel, then
+ * traces one ray per texel of it: the view ray reflected about the road's
+ * normal, jittered every frame by a roughness that falls as the road gets
+ * wetter. Rays march through the pyramid, skipping whole cells they stay in
+ * front of, and take the scene color where they pass behind the depth. Only
+ * roughly horizontal surfaces are traced; the rest of the screen is left
+ * empty.
+ *
+ * Each result is blended into the history, reprojected through the camera's
+ * motion since the last trace (the road is static) and clamped to the new
+ * results around it, so the jitter averages into a glossy reflection and
+ * disoccluded history fades fast. The two history images alternate: a trace
+ * reads one and writes the other.
+ *
+ * The scene shaders read the newest image the next frame, through the view it
+ * was traced from (getViewProj()), and upsample it with the pyramid's first
+ * level: of the four texels around a point, those whose depth is far from
+ * its own are left out, so reflections do not bleed across silhouettes.
+ */
+class WetRoadReflections {
+public:
+    static constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;  // rgb: premultiplied, a: coverage
+    static constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_R32_SFLOAT;
+    static constexpr uint32_t GROUP_SIZE   = 8;  // Both axes; must match both reflection shaders
+
+    WetRoadReflections()  = default;
+    ~WetRoadReflections() = default;
+
+    WetRoadReflections(const WetRoadReflections&)            = delete;
+    WetRoadReflections& operator=(const WetRoadReflections&) = delete;
+
+    /**
+     * @brief Create the half-resolution images and the reduce and trace pipelines
+     * @param outputExtent Largest extent the scene renders at; the images cover half of it
+     * @param depthView Depth-aspect view of the main pass's depth; the image needs VK_IMAGE_USAGE_SAMPLED_BIT.
+     *        VK_NULL_HANDLE when the depth format cannot be sampled: the images are created for the scene
+     *        shaders to bind, but record() must not be called
+     * @param sceneColorView The main pass's color; the image needs VK_IMAGE_USAGE_SAMPLED_BIT
+     * @param frameBuffer Buffer holding the allocations passed to upload()
+     */
+    void init(VkDevice device, VkPhysicalDevice physicalDevice, VkExtent2D outputExtent, VkImageView depthView,
+              VkImageView sceneColorView, VkBuffer frameBuffer, VkPipelineCache pipelineCache);
+
+    void destroy(VkDevice device);
+
+    /**
+     * @brief Drop the history, e.g. when the road dries; nothing is read until the next record()
+     */
+    void invalidate() { traced = false; }
+
+    /**
+     * @brief Write this frame's trace parameters; call before record(), with the view the frame renders
+     * @param buffer sizeof(ReflectionTraceParams) bytes, uniform aligned
+     * @param proj The view's projection, Y already flipped for Vulkan
+     * @param wetness 0 (dry) to 1 (soaked); wetter roads reflect more sharply
+     * @param renderExtent Top-left region of the depth and color the frame renders into
+     */
+    void upload(const FrameAllocation& buffer, const glm::mat4& view, const glm::mat4& proj,
+                const glm::vec3& cameraPosition, float wetness, VkExtent2D renderExtent);
+
+    /**
+     * @brief Reduce the depth, then trace and accumulate into the next history image
+     *
+     * Record after the main pass, outside a render pass, with the depth and color in
+     * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL and the pyramid and both history images in
+     * VK_IMAGE_LAYOUT_GENERAL, all ready for compute shaders; the barriers in between are recorded here.
+     */
+    void record(VkCommandBuffer cmd);
+
+    /** @brief Whether a trace has run since init() or invalidate(), so the getters below are meaningful */
+    bool isReady() const { return traced; }
+
+    /** @brief The view the newest image was traced from */
+    const glm::mat4& getViewProj() const { return tracedViewProj; }
+
+    /** @brief Texels of the newest image (and the pyramid's first level) the last trace covered */
+    VkExtent2D getTracedExtent() const { return tracedExtent; }
+
+    /** @brief Which of getColorImage(0) and getColorImage(1) the last trace wrote */
+    uint32_t getReadIndex() const { return readIndex; }
+
+    VkImage     getColorImage(uint32_t index) const { return colorImages[index]; }
+    VkImageView getColorView(uint32_t index) const { return colorViews[index]; }
+    VkImage     getDepthImage() const { return pyramidImage; }
+    VkImageView getDepthView() const { return pyramidView; }
+
+    /** @brief Linear, clamped: for the history and the scene shaders' lookups */
+    VkSampler getSampler() const { return linearSampler; }
+
+    /** @brief Nearest, clamped, any level: for the pyramid */
+    VkSampler getDepthSampler() const { return nearestSampler; }
+
+private:
+    VkExtent2D imageExtent = {0, 0};  // Half the output extent, rounded up
+    uint32_t   levelCount  = 0;
+
+    // Pyramid: level 0 holds the nearest depth of each 2x2 block of the depth buffer, every later level the
+    // nearest of a 2x2 block of the one before, so cells at level N are exactly 2^N texels of level 0
+    VkImage                  pyramidImage = VK_NULL_HANDLE;
+    Allocation               pyramidMemory;
+    VkImageView              pyramidView = VK_NULL_HANDLE;  // All levels
+    std::vector<VkImageView> levelViews;                    // One per level, for reduction
+
+    std::array<VkImage, 2>     colorImages{};
+    std::array<Allocation, 2>  colorMemory{};
+    std::array<VkImageView, 2> colorViews{};
+
+    VkSampler nearestSampler = VK_NULL_HANDLE;
+    VkSampler linearSampler  = VK_NULL_HANDLE;
+
+    // Reduction: level N reads level N - 1 (level 0 reads the depth buffer)
+    VkDescriptorSetLayout        reduceSetLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> reduceSets;
+    VkPipelineLayout             reduceLayout   = VK_NULL_HANDLE;
+    VkPipeline                   reducePipeline = VK_NULL_HANDLE;
+
+    // Trace: set N reads history image 1 - N and writes image N
+    VkDescriptorSetLayout          traceSetLayout = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> traceSets{};
+    VkPipelineLayout               traceLayout   = VK_NULL_HANDLE;
+    VkPipeline                     tracePipeline = VK_NULL_HANDLE;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+
+    // The trace upload() prepared, and what the last record() left for the scene shaders
+    glm::mat4  pendingViewProj{1.0f};
+    VkExtent2D pendingRender = {0, 0};  // Full resolution
+    VkExtent2D pendingExtent = {0, 0};  // Half resolution
+    uint32_t   pendingLevels = 0;
+    uint32_t   paramsOffset  = 0;
+    glm::mat4  tracedViewProj{1.0f};
+    VkExtent2D tracedExtent = {0, 0};
+    uint32_t   readIndex    = 0;
+    uint32_t   traceCount   = 0;  // Seeds the jitter, so successive traces sample different directions
+    bool       traced       = false;
+
+    void createImages(VkDevice device, VkPhysicalDevice physicalDevice);
+    void createDescriptors(VkDevice device, VkImageView depthView, VkImageView sceneColorView, VkBuffer frameBuffer);
+};
+
+}  // namespace DownPour
@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: MIT
+#include "WorldStreamer.h"
+
+#include "core/MemoryAllocator.h"
+#include "core/Profiler.h"
+#include "core/UploadManager.h"
+#include "logger/Logger.h"
+#include "scene/Frustum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace DownPour {
+
+namespace {
+
+uint64_t cellKey(int32_t x, int32_t z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+}  // namespace
+
+void WorldStreamer::init(const Model& model, const WorldStreamingConfig& config, uint32_t framesInFlight,
+                         VkDevice device, VkPhysicalDevice physicalDevice) {
+    this->model          = &model;
+    this->config         = config;
+    this->framesInFlight = framesInFlight;
+
+    // Evicting inside the load radius would reload the same tiles every frame
+    this->config.evictRadius = std::max(config.evictRadius, config.loadRadius);
+    this->device         = device;
+    this->physicalDevice = physicalDevice;
+
+    const std::vector<WorldTile>& worldTiles = model.getTiles();
+    tiles.clear();
+    tiles.resize(worldTiles.size());
+
+    // Index each tile under every cell its bounds overlap: triangles are binned by centroid, so bounds spill over
+    const float tileSize = model.getTileSize();
+    tilesByCell.clear();
+    for (uint32_t i = 0; i < worldTiles.size(); i++) {
+        const WorldTile& tile = worldTiles[i];
+        const auto       minX = static_cast<int32_t>(std::floor(tile.minBounds.x / tileSize));
+        const auto       maxX = static_cast<int32_t>(std::floor(tile.maxBounds.x / tileSize));
+        const auto       minZ = static_cast<int32_t>(std::floor(tile.minBounds.z / tileSize));
+        const auto       maxZ = static_cast<int32_t>(std::floor(tile.maxBounds.z / tileSize));
+        for (int32_t z = minZ; z <= maxZ; z++) {
+            for (int32_t x = minX; x <= maxX; x++)
+                tilesByCell[cellKey(x, z)].push_back(i);
+        }
+    }
+
+    DP_LOG(Info, "World streaming: %zu tiles, budgets %llu MB VRAM / %llu MB RAM, load radius %.0f", tiles.size(),
+           static_cast<unsigned long long>(config.vramBudget >> 20),
+           static_cast<unsigned long long>(config.ramBudget >> 20), config.loadRadius);
+}
+
+void WorldStreamer::update(const glm::vec3& position, const glm::vec3& velocity) {
+    DP_PROFILE_SCOPE("WorldStreamer::update");
+
+    if (!model)
+        return;
+    frame++;
+
+    // Buffers released framesInFlight frames ago are no longer referenced by any command buffer
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [this](RetiredGeometry& old) {
+                                     if (frame <= old.frame + framesInFlight)
+                                         return false;
+                                     old.geometry.cleanup(device);
+                                     return true;
+                                 }),
+                  retired.end());
+
+    // Focus points in model space: the car, and where it will be prefetchSeconds from now
+    const glm::mat4 toModel = glm::inverse(model->getModelMatrix());
+    const glm::vec3 car     = glm::vec3(toModel * glm::vec4(position, 1.0f));
+    const glm::vec3 ahead   = glm::vec3(toModel * glm::vec4(position + velocity * config.prefetchSeconds, 1.0f));
+
+    // Rank every live tile and every tile near either point
+    candidates.clear();
+    gatherCandidates(car);
+    gatherCandidates(ahead);
+    for (uint32_t index : live) {
+        if (tiles[index].rankedFrame != frame) {
+            tiles[index].rankedFrame = frame;
+            candidates.push_back(index);
+        }
+    }
+    for (uint32_t index : candidates)
+        tiles[index].priority = std::min(distanceTo(index, car), distanceTo(index, ahead));
+
+    // Finished reads and uploads; far tiles go regardless of budget
+    for (uint32_t index : live) {
+        Tile& tile = tiles[index];
+        if (tile.state == TileState::Reading && tile.read.isDone()) {
+            try {
+                tile.read.wait();
+                tile.state = TileState::Read;
+            } catch (const std::exception& e) {
+                DP_LOG(Warning, "World streaming: tile %u failed to load: %s", index, e.what());
+                pendingCpuBytes -= cpuBytes(index);
+                reservedGpuBytes -= gpuBytes(index);
+                std::vector<Vertex>().swap(tile.vertices);
+                std::vector<unsigned char>().swap(tile.indices);
+                tile.state = TileState::Failed;
+                continue;
+            }
+        } else if (tile.state == TileState::Uploading && tile.geometry.getUploadFuture().isReady()) {
+            tile.state = TileState::Resident;
+        }
+
+        if (tile.priority > config.evictRadius)
+            release(index);
+    }
+
+    // Wanted tiles, nearest first, while they fit the budgets
+    auto nearer = [this](uint32_t a, uint32_t b) { return tiles[a].priority < tiles[b].priority; };
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [this](uint32_t index) {
+                                        return tiles[index].state != TileState::Unloaded ||
+                                               tiles[index].priority > config.loadRadius;
+                                    }),
+                     candidates.end());
+    std::sort(candidates.begin(), candidates.end(), nearer);
+
+    // Never more than the device can spare on top of what the road holds already
+    const uint64_t headroom   = MemoryAllocator::get().getDeviceHeadroom();
+    const uint64_t vramBudget = std::min<uint64_t>(
+        config.vramBudget, reservedGpuBytes + std::min<uint64_t>(headroom, UINT64_MAX - reservedGpuBytes));
+
+    for (uint32_t index : candidates) {
+        if (pendingCpuBytes + cpuBytes(index) > config.ramBudget)
+            break;
+
+        // Make room by evicting the furthest tile that ranks below this one
+        bool fits = true;
+        while (fits && reservedGpuBytes + gpuBytes(index) > vramBudget) {
+            uint32_t victim = UINT32_MAX;
+            for (uint32_t other : live) {
+                const Tile& candidate = tiles[other];
+                const bool  evictable = candidate.state == TileState::Read || candidate.state == TileState::Resident;
+                if (evictable && candidate.priority > tiles[index].priority &&
+                    (victim == UINT32_MAX || candidate.priority > tiles[victim].priority)) {
+                    victim = other;
+                }
+            }
+            if (victim == UINT32_MAX)
+                fits = false;
+            else
+                release(victim);
+        }
+        if (!fits)
+            break;
+
+        startRead(index);
+        live.push_back(index);
+    }
+
+    // A few uploads per frame, nearest first, to bound the main thread's share
+    candidates.clear();
+    for (uint32_t index : live) {
+        if (tiles[index].state == TileState::Read)
+            candidates.push_back(index);
+    }
+    std::sort(candidates.begin(), candidates.end(), nearer);
+    const size_t uploads = std::min<size_t>(candidates.size(), config.maxUploadsPerFrame);
+    for (size_t i = 0; i < uploads; i++)
+        upload(candidates[i]);
+    if (uploads > 0)
+        UploadManager::get().flush();
+
+    live.erase(std::remove_if(live.begin(), live.end(),
+                              [this](uint32_t index) {
+                                  return tiles[index].state == TileState::Unloaded ||
+                                         tiles[index].state == TileState::Failed;
+                              }),
+               live.end());
+}
+
+void WorldStreamer::collectDraws(const glm::mat4& viewProj, const glm::vec3& cameraPosition, float pixelsPerUnit,
+                                 std::vector<Draw>& outDraws) {
+    outDraws.clear();
+    if (!model)
+        return;
+
+    const Frustum                 frustum(viewProj);
+    const Mat4&                   world      = model->getModelMatrix();
+    const std::vector<WorldTile>& worldTiles = model->getTiles();
+    const float                   scale      = std::max(
+        glm::length(Vec3(world[0])), std::max(glm::length(Vec3(world[1])), glm::length(Vec3(world[2]))));
+
+    for (uint32_t index : live) {
+        Tile& tile = tiles[index];
+        if (tile.state != TileState::Resident)
+            continue;
+
+        const WorldTile& worldTile = worldTiles[index];
+        Vec3             worldMin, worldMax;
+        transformAABB(world, worldTile.minBounds, worldTile.maxBounds, worldMin, worldMax);
+        if (!frustum.intersectsAABB(worldMin, worldMax))
+            continue;
+
+        // Pixels per model unit at the nearest point of the tile's bounds, as in Scene::selectLods()
+        const Vec3  center    = (worldMin + worldMax) * 0.5f;
+        const float radius    = glm::length(worldMax - worldMin) * 0.5f;
+        const float distance  = std::max(glm::length(center - cameraPosition) - radius, 1e-3f);
+        const float projected = pixelsPerUnit * scale / distance;
+
+        for (size_t s = 0; s < worldTile.sections.size(); s++) {
+            const WorldTileSection& section = worldTile.sections[s];
+            const uint32_t          level   = selectMeshLod(section.lods.data(), section.lodCount,
+                                                            tile.sectionLods[s], projected);
+            tile.sectionLods[s]             = static_cast<uint8_t>(level);
+
+            Draw draw;
+            draw.vertexBuffer = tile.geometry.getVertexBuffer();
+            draw.indexBuffer  = tile.geometry.getIndexBuffer();
+            draw.indexType    = tile.geometry.getIndexType();
+            draw.material     = section.material;
+            draw.indexStart   = level == 0 ? section.indexStart : section.lods[level - 1].indexStart;
+            draw.indexCount   = level == 0 ? section.indexCount : section.lods[level - 1].indexCount;
+            outDraws.push_back(draw);
+        }
+    }
+
+    // One descriptor bind per material; tiles stay in distance-ranked order within it
+    std::stable_sort(outDraws.begin(), outDraws.end(),
+                     [](const Draw& a, const Draw& b) { return a.material < b.material; });
+}
+
+void WorldStreamer::cleanup() {
+    // Reads write into the tiles, so let them finish first
+    for (Tile& tile : tiles) {
+        if (tile.state != TileState::Reading)
+            continue;
+        try {
+            tile.read.wait();
+        } catch (const std::exception&) {
+            // Shutting down anyway
+        }
+    }
+
+    for (Tile& tile : tiles) {
+        if (tile.state == TileState::Uploading || tile.state == TileState::Resident)
+            tile.geometry.cleanup(device);
+    }
+    for (RetiredGeometry& old : retired)
+        old.geometry.cleanup(device);
+
+    tiles.clear();
+    live.clear();
+    retired.clear();
+    tilesByCell.clear();
+    reservedGpuBytes = 0;
+    pendingCpuBytes  = 0;
+    model            = nullptr;
+}
+
+WorldStreamer::Stats WorldStreamer::getStats() const {
+    Stats stats;
+    for (uint32_t index : live) {
+        if (tiles[index].state == TileState::Resident)
+            stats.residentTiles++;
+        else
+            stats.loadingTiles++;
+    }
+    stats.residentBytes = reservedGpuBytes;
+    stats.pendingBytes  = pendingCpuBytes;
+    return stats;
+}
+
+uint64_t WorldStreamer::gpuBytes(uint32_t tileIndex) const {
+    const WorldTile& tile       = model->getTiles()[tileIndex];
+    const bool       packed     = model->getVertexFormat() == VertexFormat::Packed;
+    const uint64_t   vertexSize = packed ? sizeof(PackedVertex) : sizeof(Vertex);
+    const uint64_t   indexSize  = model->getIndexType() == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    return tile.vertexCount * vertexSize + tile.indexCount * indexSize;
+}
+
+uint64_t WorldStreamer::cpuBytes(uint32_t tileIndex) const {
+    // As read from disk: float vertices, indices at the cooked width
+    const WorldTile& tile      = model->getTiles()[tileIndex];
+    const uint64_t   indexSize = model->getIndexType() == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    return tile.vertexCount * sizeof(Vertex) + tile.indexCount * indexSize;
+}
+
+float WorldStreamer::distanceTo(uint32_t tileIndex, const glm::vec3& point) const {
+    // Ground-plane distance to the bounds: height does not matter for what the car will reach
+    const WorldTile& tile = model->getTiles()[tileIndex];
+    const float      dx   = std::max(std::max(tile.minBounds.x - point.x, point.x - tile.maxBounds.x), 0.0f);
+    const float      dz   = std::max(std::max(tile.minBounds.z - point.z, point.z - tile.maxBounds.z), 0.0f);
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+void WorldStreamer::gatherCandidates(const glm::vec3& point) {
+    // A cell k cells away is at least (k - 1) tile sizes from any point in the centre cell
+    const float   tileSize = model->getTileSize();
+    const auto    reach    = static_cast<int32_t>(config.loadRadius / tileSize) + 1;
+    const int32_t centerX  = static_cast<int32_t>(std::floor(point.x / tileSize));
+    const int32_t centerZ  = static_cast<int32_t>(std::floor(point.z / tileSize));
+
+    for (int32_t z = centerZ - reach; z <= centerZ + reach; z++) {
+        for (int32_t x = centerX - reach; x <= centerX + reach; x++) {
+            auto it = tilesByCell.find(cellKey(x, z));
+            if (it == tilesByCell.end())
+                continue;
+            for (uint32_t index : it->second) {
+                if (tiles[index].rankedFrame != frame) {
+                    tiles[index].rankedFrame = frame;
+                    candidates.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+void WorldStreamer::startRead(uint32_t tileIndex) {
+    Tile& tile = tiles[tileIndex];
+    tile.state = TileState::Reading;
+    pendingCpuBytes += cpuBytes(tileIndex);
+    reservedGpuBytes += gpuBytes(tileIndex);
+
+    // `tiles` is never resized while streaming, so the job may fill the tile in place
+    const Model* source = model;
+    tile.read           = JobSystem::get().schedule([source, &tile, tileIndex] {
+        DP_PROFILE_SCOPE("WorldStreamer::read");
+        if (!source->readTile(tileIndex, tile.vertices, tile.indices))
+            throw std::runtime_error("tile data missing from the cooked file");
+    });
+}
+
+void WorldStreamer::upload(uint32_t tileIndex) {
+    Tile&            tile      = tiles[tileIndex];
+    const WorldTile& worldTile = model->getTiles()[tileIndex];
+
+    tile.geometry.setVertexFormat(model->getVertexFormat(), model->getVertexQuantization());
+    tile.geometry.setMemoryTag(MemoryTag::Road);
+    tile.geometry.createBuffers(tile.vertices.data(), tile.vertices.size(), tile.indices.data(), worldTile.indexCount,
+                                model->getIndexType(), device, physicalDevice);
+
+    pendingCpuBytes -= cpuBytes(tileIndex);
+    std::vector<Vertex>().swap(tile.vertices);
+    std::vector<unsigned char>().swap(tile.indices);
+    tile.sectionLods.assign(worldTile.sections.size(), 0);
+    tile.state = TileState::Uploading;
+}
+
+void WorldStreamer::release(uint32_t tileIndex) {
+    Tile& tile = tiles[tileIndex];
+    switch (tile.state) {
+        case TileState::Read:
+            pendingCpuBytes -= cpuBytes(tileIndex);
+            std::vector<Vertex>().swap(tile.vertices);
+            std::vector<unsigned char>().swap(tile.indices);
+            break;
+        case TileState::Resident:
+            retired.push_back({tile.geometry, frame});
+            tile.geometry = ModelGeometry();
+            break;
+        default:
+            return;  // Reads and uploads in flight still own their memory; released once they land
+    }
+    reservedGpuBytes -= gpuBytes(tileIndex);
+    tile.sectionLods.clear();
+    tile.state = TileState::Unloaded;
+}
+
+}  // namespace DownPour
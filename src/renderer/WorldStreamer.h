@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Model.h"
+#include "ModelGeometry.h"
+#include "core/JobSystem.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Residency settings for a tiled model (the sidecar's "streaming" block)
+ */
+struct WorldStreamingConfig {
+    float    loadRadius         = 750.0f;        // Tiles this close to the car or the prefetch point are loaded
+    float    evictRadius        = 1000.0f;       // Resident tiles further than this are released, budget or not
+    float    prefetchSeconds    = 5.0f;          // Prefetch point: this far ahead along the direction of travel
+    uint64_t vramBudget         = 256ull << 20;  // Tile vertex and index buffers; less when the device runs short
+    uint64_t ramBudget          = 64ull << 20;   // Tile data read from disk and not uploaded yet
+    uint32_t maxUploadsPerFrame = 4;
+};
+
+/**
+ * @brief Keeps the tiles of a tiled Model resident around the car
+ *
+ * Every frame update() ranks tiles by distance to two focus points, the car
+ * and where it will be prefetchSeconds from now. Wanted tiles are read from
+ * the cooked file on JobSystem workers and uploaded from the main thread (a
+ * few per frame), nearest first; tiles past evictRadius are released. When
+ * a wanted tile does not fit the VRAM budget, the furthest resident tile that
+ * ranks below it is evicted, so memory is bounded by the budgets and the
+ * radii, never by the length of the route.
+ *
+ * Released buffers are destroyed framesInFlight frames later, once no
+ * command buffer can still reference them. All methods are main-thread only.
+ */
+class WorldStreamer {
+public:
+    /** @brief One section of a resident tile to draw at its selected LOD */
+    struct Draw {
+        VkBuffer    vertexBuffer;
+        VkBuffer    indexBuffer;
+        VkIndexType indexType;
+        uint32_t    material;  // Index into the model's materials, or WORLD_TILE_NO_MATERIAL
+        uint32_t    indexStart;
+        uint32_t    indexCount;
+    };
+
+    struct Stats {
+        uint32_t residentTiles = 0;
+        uint32_t loadingTiles  = 0;  // Being read or uploaded
+        uint64_t residentBytes = 0;  // GPU bytes of resident and uploading tiles
+        uint64_t pendingBytes  = 0;  // CPU bytes read but not uploaded
+    };
+
+    /**
+     * @brief Start streaming `model`, which must be tiled and outlive the streamer
+     */
+    void init(const Model& model, const WorldStreamingConfig& config, uint32_t framesInFlight, VkDevice device,
+              VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Load, upload and evict tiles for this frame
+     * @param position Car position (world space)
+     * @param velocity Car velocity (world units per second), for prefetching
+     */
+    void update(const glm::vec3& position, const glm::vec3& velocity);
+
+    /**
+     * @brief Draws for resident tiles in the frustum, grouped by material
+     *
+     * Picks each section's LOD from its projected size, like Scene::selectLods().
+     * @param pixelsPerUnit Pixels one world unit covers at distance 1
+     */
+    void collectDraws(const glm::mat4& viewProj, const glm::vec3& cameraPosition, float pixelsPerUnit,
+                      std::vector<Draw>& outDraws);
+
+    /**
+     * @brief Wait for outstanding reads and destroy every tile buffer (device must be idle)
+     */
+    void cleanup();
+
+    bool  isActive() const { return model != nullptr; }
+    Stats getStats() const;
+
+private:
+    enum class TileState : uint8_t {
+        Unloaded,
+        Reading,    // Job filling `vertices`/`indices`
+        Read,       // Waiting for an upload slot
+        Uploading,  // Buffers created, transfer in flight
+        Resident,
+        Failed,     // Read failed; not retried
+    };
+
+    struct Tile {
+        TileState                  state = TileState::Unloaded;
+        JobHandle                  read;
+        std::vector<Vertex>        vertices;  // Between read and upload
+        std::vector<unsigned char> indices;
+        ModelGeometry              geometry;
+        std::vector<uint8_t>       sectionLods;         // Level drawn last frame, per section
+        float                      priority    = 0.0f;  // Distance to the nearer focus point (model space)
+        uint64_t                   rankedFrame = 0;     // Frame `priority` was computed in
+    };
+
+    struct RetiredGeometry {
+        ModelGeometry geometry;
+        uint64_t      frame;
+    };
+
+    const Model*                 model = nullptr;
+    WorldStreamingConfig         config;
+    uint32_t                     framesInFlight = 2;
+    VkDevice                     device         = VK_NULL_HANDLE;
+    VkPhysicalDevice             physicalDevice = VK_NULL_HANDLE;
+    uint64_t                     frame          = 0;
+    std::vector<Tile>            tiles;       // Parallel to model->getTiles(); never resized after init
+    std::vector<uint32_t>        live;        // Tiles in any state but Unloaded/Failed
+    std::vector<uint32_t>        candidates;  // Scratch for update()
+    std::vector<RetiredGeometry> retired;
+
+    std::unordered_map<uint64_t, std::vector<uint32_t>> tilesByCell;  // Grid cell -> tiles overlapping it
+
+    uint64_t reservedGpuBytes = 0;  // Tiles from Reading to Resident, at their GPU size
+    uint64_t pendingCpuBytes  = 0;  // Tiles in Reading or Read
+
+    uint64_t gpuBytes(uint32_t tileIndex) const;
+    uint64_t cpuBytes(uint32_t tileIndex) const;
+    float    distanceTo(uint32_t tileIndex, const glm::vec3& point) const;
+    void     gatherCandidates(const glm::vec3& point);
+    void     startRead(uint32_t tileIndex);
+    void     upload(uint32_t tileIndex);
+    void     release(uint32_t tileIndex);
+};
+
+}  // namespace DownPour
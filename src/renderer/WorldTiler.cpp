@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: MIT
+#include "WorldTiler.h"
+
+#include "MeshOptimizer.h"
+#include "core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace DownPour {
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = ~0u;
+
+uint64_t cellKey(int32_t x, int32_t z) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+}  // namespace
+
+std::vector<WorldTile> WorldTiler::split(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                         const std::vector<Section>& sections, float tileSize, uint32_t lodLevels,
+                                         uint32_t& outMaxTileVertices) {
+    DP_PROFILE_SCOPE("WorldTiler::split");
+
+    outMaxTileVertices = 0;
+
+    // Bucket triangles by the cell of their centroid; per cell, one absolute-index list per section
+    struct Cell {
+        int32_t                            x = 0, z = 0;
+        std::vector<std::vector<uint32_t>> sectionIndices;
+    };
+    std::vector<Cell>                      cells;
+    std::unordered_map<uint64_t, uint32_t> cellIndex;
+
+    for (size_t s = 0; s < sections.size(); s++) {
+        const Section& section = sections[s];
+        const size_t   end     = section.indexStart + static_cast<size_t>(section.indexCount);
+        if (section.indexCount % 3 != 0 || end > indices.size())
+            continue;
+
+        for (size_t i = section.indexStart; i < end; i += 3) {
+            uint32_t triangle[3];
+            bool     valid = true;
+            for (uint32_t k = 0; k < 3; k++) {
+                triangle[k] = static_cast<uint32_t>(static_cast<int64_t>(indices[i + k]) + section.vertexOffset);
+                valid       = valid && triangle[k] < vertices.size();
+            }
+            if (!valid)
+                continue;
+
+            const glm::vec3 centroid = (vertices[triangle[0]].position + vertices[triangle[1]].position +
+                                        vertices[triangle[2]].position) / 3.0f;
+            const auto      x        = static_cast<int32_t>(std::floor(centroid.x / tileSize));
+            const auto      z        = static_cast<int32_t>(std::floor(centroid.z / tileSize));
+
+            auto inserted = cellIndex.emplace(cellKey(x, z), static_cast<uint32_t>(cells.size()));
+            if (inserted.second) {
+                cells.emplace_back();
+                cells.back().x = x;
+                cells.back().z = z;
+                cells.back().sectionIndices.resize(sections.size());
+            }
+            std::vector<uint32_t>& out = cells[inserted.first->second].sectionIndices[s];
+            out.insert(out.end(), triangle, triangle + 3);
+        }
+    }
+
+    // Row-major cell order keeps neighbouring tiles close in the cooked file
+    std::sort(cells.begin(), cells.end(),
+              [](const Cell& a, const Cell& b) { return a.z != b.z ? a.z < b.z : a.x < b.x; });
+
+    std::vector<Vertex>    tiledVertices;
+    std::vector<uint32_t>  tiledIndices;
+    std::vector<WorldTile> tiles;
+    tiledVertices.reserve(vertices.size());
+    tiledIndices.reserve(indices.size());
+    tiles.reserve(cells.size());
+
+    std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+    std::vector<Vertex>   localVertices;
+    std::vector<uint32_t> localIndices;
+
+    for (const Cell& cell : cells) {
+        WorldTile tile;
+        tile.gridX = cell.x;
+        tile.gridZ = cell.z;
+
+        // Tile-local vertex run in first-use order
+        localVertices.clear();
+        localIndices.clear();
+        for (size_t s = 0; s < sections.size(); s++) {
+            const std::vector<uint32_t>& source = cell.sectionIndices[s];
+            if (source.empty())
+                continue;
+
+            WorldTileSection section;
+            section.material   = sections[s].material;
+            section.indexStart = static_cast<uint32_t>(localIndices.size());
+            section.indexCount = static_cast<uint32_t>(source.size());
+            for (uint32_t index : source) {
+                if (remap[index] == INVALID_INDEX) {
+                    remap[index] = static_cast<uint32_t>(localVertices.size());
+                    localVertices.push_back(vertices[index]);
+                }
+                localIndices.push_back(remap[index]);
+            }
+            tile.sections.push_back(section);
+        }
+        for (const std::vector<uint32_t>& source : cell.sectionIndices) {
+            for (uint32_t index : source)
+                remap[index] = INVALID_INDEX;
+        }
+
+        // LODs go after all full-detail sections, still inside the tile's index run
+        for (WorldTileSection& section : tile.sections) {
+            const MeshOptimizer::IndexRange range{section.indexStart, section.indexCount, 0};
+            const std::vector<MeshLod> lods = MeshOptimizer::buildLods(localVertices, localIndices, range, lodLevels);
+            section.lodCount = static_cast<uint32_t>(std::min<size_t>(lods.size(), MAX_MESH_LODS));
+            std::copy_n(lods.begin(), section.lodCount, section.lods.begin());
+        }
+
+        tile.minBounds = tile.maxBounds = localVertices.front().position;
+        for (const Vertex& vertex : localVertices) {
+            tile.minBounds = glm::min(tile.minBounds, vertex.position);
+            tile.maxBounds = glm::max(tile.maxBounds, vertex.position);
+        }
+
+        tile.firstVertex = static_cast<uint32_t>(tiledVertices.size());
+        tile.vertexCount = static_cast<uint32_t>(localVertices.size());
+        tile.firstIndex  = static_cast<uint32_t>(tiledIndices.size());
+        tile.indexCount  = static_cast<uint32_t>(localIndices.size());
+        tiledVertices.insert(tiledVertices.end(), localVertices.begin(), localVertices.end());
+        tiledIndices.insert(tiledIndices.end(), localIndices.begin(), localIndices.end());
+
+        outMaxTileVertices = std::max(outMaxTileVertices, tile.vertexCount);
+        tiles.push_back(std::move(tile));
+    }
+
+    vertices.swap(tiledVertices);
+    indices.swap(tiledIndices);
+    return tiles;
+}
+
+}  // namespace DownPour
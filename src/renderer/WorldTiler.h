@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Splits a model's geometry into square XZ tiles for streaming
+ *
+ * Each tile gets its own contiguous vertex run (vertices shared across a tile
+ * boundary are duplicated) and index run with tile-local indices, so a tile
+ * uploads as an independent pair of buffers and usually fits 16-bit indices.
+ * Triangle order within a section is kept, so MeshOptimizer's cache order
+ * survives. Sections can also get their own LODs, built per tile.
+ */
+class WorldTiler {
+public:
+    /** @brief A drawn range of the input (one per material, or per primitive without materials) */
+    struct Section {
+        uint32_t material     = WORLD_TILE_NO_MATERIAL;
+        uint32_t indexStart   = 0;
+        uint32_t indexCount   = 0;
+        int32_t  vertexOffset = 0;
+    };
+
+    /**
+     * @brief Rebuild `vertices` and `indices` tile by tile
+     *
+     * Ranges other than `sections` (e.g. primitive LODs) are dropped.
+     *
+     * @param tileSize Cell edge in model units
+     * @param lodLevels Levels to build per tile section (0 for none)
+     * @param outMaxTileVertices Largest tile vertex run; <= 65536 means 16-bit indices fit
+     */
+    static std::vector<WorldTile> split(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                        const std::vector<Section>& sections, float tileSize, uint32_t lodLevels,
+                                        uint32_t& outMaxTileVertices);
+};
+
+}  // namespace DownPour
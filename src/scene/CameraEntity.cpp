@@ -22,7 +22,7 @@ Vec3 CameraEntity::getWorldPosition() const {
     }
 
     // Extract position from world transform
-    return Vec3(node->worldTransform[3]);
+    return Vec3(scenePtr->getWorldTransform(getRootNode())[3]);
 }
 
 Quat CameraEntity::getWorldRotation() const {
@@ -43,7 +43,7 @@ Quat CameraEntity::getWorldRotation() const {
     Vec3 translation;
     Vec3 skew;
     Vec4 perspective;
-    glm::decompose(node->worldTransform, scale, rotation, translation, skew, perspective);
+    glm::decompose(scenePtr->getWorldTransform(getRootNode()), scale, rotation, translation, skew, perspective);
 
     return rotation;
 }
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: MIT
+#include "CarAnimationSystem.h"
+
+#include "Scene.h"
+#include "core/Profiler.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace DownPour {
+
+void CarAnimationSystem::update(Scene& scene) {
+    DP_PROFILE_SCOPE("CarAnimationSystem::update");
+
+    auto pose = [&](NodeHandle handle, const Quat& rotation) {
+        if (SceneNode* node = scene.getNode(handle)) {
+            node->setLocalRotation(rotation);
+            scene.markDirty(handle);
+        }
+    };
+
+    for (const CarAnimation& car : scene.getRegistry().pool<CarAnimation>().components()) {
+        const Quat wheelRotation = glm::angleAxis(car.wheelRotation, Vec3(1.0f, 0.0f, 0.0f));
+        for (NodeHandle wheel : car.wheels)
+            pose(wheel, wheelRotation);
+
+        const Quat steeringRotation = glm::angleAxis(glm::radians(car.steeringAngle), Vec3(0.0f, 0.0f, 1.0f));
+        for (NodeHandle steeringWheel : car.steering)
+            pose(steeringWheel, steeringRotation);
+    }
+}
+
+}  // namespace DownPour
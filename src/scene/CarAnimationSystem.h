@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "EntityRegistry.h"
+#include "SceneNode.h"
+
+#include <array>
+
+namespace DownPour {
+
+class Scene;
+
+/**
+ * @brief Per-car animation state, stored in a Scene's EntityRegistry
+ *
+ * Part nodes are resolved once, when the car is spawned (e.g. from
+ * CarEntity::getPartNode()); invalid handles are skipped.
+ */
+struct CarAnimation {
+    std::array<NodeHandle, 4> wheels{};            // FL, FR, RL, RR
+    std::array<NodeHandle, 2> steering{};          // Steering wheel front and back
+    float                     wheelRotation = 0.0f;  // Radians around the wheel's local X axis
+    float                     steeringAngle = 0.0f;  // Degrees around the steering wheel's local Z axis
+};
+
+/**
+ * @brief Poses every car's wheels and steering wheel in one pass over the CarAnimation pool
+ *
+ * Run before Scene::updateTransforms() (SceneManager::update() does).
+ */
+class CarAnimationSystem {
+public:
+    static void update(Scene& scene);
+};
+
+}  // namespace DownPour
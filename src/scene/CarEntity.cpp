@@ -9,48 +9,85 @@
 
 namespace DownPour {
 
+namespace {
+
+constexpr size_t PART_COUNT = static_cast<size_t>(CarEntity::Part::Count);
+
+// Indexed by CarEntity::Part
+constexpr const char* PART_ROLES[PART_COUNT] = {
+    CarEntity::ROLE_WHEEL_FL,
+    CarEntity::ROLE_WHEEL_FR,
+    CarEntity::ROLE_WHEEL_RL,
+    CarEntity::ROLE_WHEEL_RR,
+    CarEntity::ROLE_STEERING_WHEEL_FRONT,
+    CarEntity::ROLE_STEERING_WHEEL_BACK,
+    CarEntity::ROLE_WIPER_LEFT,
+    CarEntity::ROLE_WIPER_RIGHT,
+    CarEntity::ROLE_HOOD,
+    CarEntity::ROLE_DOOR_L,
+    CarEntity::ROLE_DOOR_R,
+    CarEntity::ROLE_HEADLIGHTS,
+    CarEntity::ROLE_TAILLIGHTS,
+};
+
+}  // namespace
+
+const char* CarEntity::getPartRole(Part part) {
+    return PART_ROLES[static_cast<size_t>(part)];
+}
+
+void CarEntity::onRoleAssigned(NameId role, NodeHandle node) {
+    // Interned once for all cars
+    static const std::array<NameId, PART_COUNT> partIds = [] {
+        std::array<NameId, PART_COUNT> ids{};
+        for (size_t i = 0; i < PART_COUNT; i++)
+            ids[i] = NameTable::intern(PART_ROLES[i]);
+        return ids;
+    }();
+
+    for (size_t i = 0; i < PART_COUNT; i++) {
+        if (partIds[i] == role)
+            parts[i] = node;
+    }
+}
+
 // ============================================================================
 // Node Getters
 // ============================================================================
 
 NodeHandle CarEntity::getWheelNode(Side side, bool front) const {
-    const char* role = nullptr;
     if (front) {
-        role = (side == Side::Left) ? ROLE_WHEEL_FL : ROLE_WHEEL_FR;
-    } else {
-        role = (side == Side::Left) ? ROLE_WHEEL_RL : ROLE_WHEEL_RR;
+        return getPartNode(side == Side::Left ? Part::WheelFL : Part::WheelFR);
     }
-    return getNode(role);
+    return getPartNode(side == Side::Left ? Part::WheelRL : Part::WheelRR);
 }
 
 NodeHandle CarEntity::getSteeringWheelFrontNode() const {
-    return getNode(ROLE_STEERING_WHEEL_FRONT);
+    return getPartNode(Part::SteeringWheelFront);
 }
 
 NodeHandle CarEntity::getSteeringWheelBackNode() const {
-    return getNode(ROLE_STEERING_WHEEL_BACK);
+    return getPartNode(Part::SteeringWheelBack);
 }
 
 NodeHandle CarEntity::getWiperNode(Side side) const {
-    const char* role = (side == Side::Left) ? ROLE_WIPER_LEFT : ROLE_WIPER_RIGHT;
-    return getNode(role);
+    return getPartNode(side == Side::Left ? Part::WiperLeft : Part::WiperRight);
 }
 
 NodeHandle CarEntity::getHeadlightsNode() const {
-    return getNode(ROLE_HEADLIGHTS);
+    return getPartNode(Part::Headlights);
 }
 
 NodeHandle CarEntity::getTaillightsNode() const {
-    return getNode(ROLE_TAILLIGHTS);
+    return getPartNode(Part::Taillights);
 }
 
 NodeHandle CarEntity::getHoodNode() const {
-    return getNode(ROLE_HOOD);
+    return getPartNode(Part::Hood);
 }
 
 NodeHandle CarEntity::getDoorNode(Side side) const {
-    const char* role = (side == Side::Left) ? ROLE_DOOR_L : ROLE_DOOR_R;
-    return getNode(role);
+    return getPartNode(side == Side::Left ? Part::DoorLeft : Part::DoorRight);
 }
 
 // ============================================================================
@@ -68,8 +105,8 @@ void CarEntity::setSteeringAngle(float degrees) {
 
     // Rotate steering wheel around its local Z-axis
     glm::quat rotation = glm::angleAxis(glm::radians(currentSteeringAngle), glm::vec3(0.0f, 0.0f, 1.0f));
-    animateRotation(ROLE_STEERING_WHEEL_FRONT, rotation);
-    animateRotation(ROLE_STEERING_WHEEL_BACK, rotation);
+    animateRotation(steeringWheelFront, rotation);
+    animateRotation(steeringWheelBack, rotation);
 }
 
 void CarEntity::setWheelRotation(float radians) {
@@ -83,11 +120,11 @@ void CarEntity::setWheelRotation(float radians) {
     glm::quat rotation = glm::angleAxis(radians, glm::vec3(1.0f, 0.0f, 0.0f));
 
     // Apply to all wheels
-    const char* wheelRoles[] = {ROLE_WHEEL_FL, ROLE_WHEEL_FR, ROLE_WHEEL_RL, ROLE_WHEEL_RR};
-    for (const char* role : wheelRoles) {
-        NodeHandle wheel = getNode(role);
+    const Part wheels[] = {Part::WheelFL, Part::WheelFR, Part::WheelRL, Part::WheelRR};
+    for (Part part : wheels) {
+        NodeHandle wheel = getPartNode(part);
         if (wheel.isValid()) {
-            animateRotation(role, rotation);
+            animateRotation(wheel, rotation);
         }
     }
 }
@@ -105,17 +142,20 @@ void CarEntity::setWiperAngle(float degrees) {
     // Apply to both wipers (might have different base angles)
     NodeHandle leftWiper = getWiperNode(Side::Left);
     if (leftWiper.isValid()) {
-        animateRotation(ROLE_WIPER_LEFT, rotation);
+        animateRotation(leftWiper, rotation);
     }
 
     NodeHandle rightWiper = getWiperNode(Side::Right);
     if (rightWiper.isValid()) {
         // Right wiper might mirror the left one
-        animateRotation(ROLE_WIPER_RIGHT, rotation);
+        animateRotation(rightWiper, rotation);
     }
 }
 
 void CarEntity::setLights(bool on) {
+    // The lamps' light on the scene follows this flag (see Application::updateLocalLights)
+    lightsOn = on;
+
     // TODO: Toggle emissive materials for headlights and taillights
     // This requires MaterialManager integration to modify material properties
     // For now, this is a stub that can be implemented when material
@@ -137,15 +177,14 @@ void CarEntity::openDoor(Side side, bool open) {
         return;
     }
 
-    const char* roleName    = (side == Side::Left) ? ROLE_DOOR_L : ROLE_DOOR_R;
-    float       targetAngle = open ? config.doorOpenAngle : 0.0f;
+    float targetAngle = open ? config.doorOpenAngle : 0.0f;
 
     // Doors typically rotate around their hinge (Y-axis)
     // Left door opens outward (positive rotation), right door might be opposite
     float     angle    = (side == Side::Left) ? targetAngle : -targetAngle;
     glm::quat rotation = glm::angleAxis(glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
 
-    animateRotation(roleName, rotation);
+    animateRotation(door, rotation);
 }
 
 void CarEntity::openHood(bool open) {
@@ -159,7 +198,7 @@ void CarEntity::openHood(bool open) {
     // Hood typically rotates around its hinge at the front (X-axis)
     glm::quat rotation = glm::angleAxis(glm::radians(targetAngle), glm::vec3(1.0f, 0.0f, 0.0f));
 
-    animateRotation(ROLE_HOOD, rotation);
+    animateRotation(hood, rotation);
 }
 
 }  // namespace DownPour
@@ -4,6 +4,8 @@
 #include "Entity.h"
 #include "SceneNode.h"
 
+#include <array>
+
 namespace DownPour {
 
 /**
@@ -33,6 +35,27 @@ public:
 
     enum class Side { Left, Right };
 
+    /** @brief Parts with a standard role, resolved to a node when the role is assigned */
+    enum class Part : uint8_t {
+        WheelFL,
+        WheelFR,
+        WheelRL,
+        WheelRR,
+        SteeringWheelFront,
+        SteeringWheelBack,
+        WiperLeft,
+        WiperRight,
+        Hood,
+        DoorLeft,
+        DoorRight,
+        Headlights,
+        Taillights,
+        Count
+    };
+
+    /** @brief The ROLE_* string of a part */
+    static const char* getPartRole(Part part);
+
     // Sub-structure for car specific state/properties for easier editing
     struct Config {
         // Physical dimensions (meters)
@@ -66,6 +89,7 @@ public:
     // ========================================================================
     // Node Getters (for specific car parts)
     // ========================================================================
+    NodeHandle getPartNode(Part part) const { return parts[static_cast<size_t>(part)]; }
     NodeHandle getWheelNode(Side side, bool front) const;
     NodeHandle getSteeringWheelFrontNode() const;
     NodeHandle getSteeringWheelBackNode() const;
@@ -90,7 +114,7 @@ public:
     void setSteeringAngle(float degrees);  // Rotate steering wheel
     void setWheelRotation(float radians);  // Rotate all wheels (for driving)
     void setWiperAngle(float degrees);     // Control wiper animation
-    void setLights(bool on);               // Toggle emissive materials
+    void setLights(bool on);               // Headlights and taillights; lit by ClusteredLights while on
     void openDoor(Side side, bool open);   // Animate door rotation
     void openHood(bool open);              // Animate hood rotation
 
@@ -100,14 +124,22 @@ public:
     float getCurrentSteeringAngle() const { return currentSteeringAngle; }
     float getCurrentWheelRotation() const { return currentWheelRotation; }
     float getCurrentWiperAngle() const { return currentWiperAngle; }
+    bool  areLightsOn() const { return lightsOn; }
+
+protected:
+    void onRoleAssigned(NameId role, NodeHandle node) override;
 
 private:
     Config config;
 
+    // Node of each standard part (invalid until its role is assigned); getters index this, no lookups
+    std::array<NodeHandle, static_cast<size_t>(Part::Count)> parts{};
+
     // Current animation state
     float currentSteeringAngle = 0.0f;  // degrees
     float currentWheelRotation = 0.0f;  // radians (accumulated)
     float currentWiperAngle    = 0.0f;  // degrees
+    bool  lightsOn             = true;
 };
 
 }  // namespace DownPour
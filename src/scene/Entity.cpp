@@ -22,11 +22,18 @@ void Entity::addNode(NodeHandle node, const str& role) {
 
     // Store named node role
     if (!role.empty()) {
-        namedNodes[role] = node;
+        NameId id      = NameTable::intern(role);
+        namedNodes[id] = node;
+        onRoleAssigned(id, node);
     }
 }
 
 NodeHandle Entity::getNode(const str& role) const {
+    NameId id = NameTable::find(role);
+    return id != INVALID_NAME_ID ? getNode(id) : NodeHandle{};
+}
+
+NodeHandle Entity::getNode(NameId role) const {
     auto it = namedNodes.find(role);
     if (it != namedNodes.end()) {
         return it->second;
@@ -117,12 +124,23 @@ void Entity::rotate(const Quat& delta) {
 }
 
 void Entity::animate(const str& role, const Mat4& localTransform) {
-    if (!scene) {
-        return;
-    }
+    animate(getNode(role), localTransform);
+}
+
+void Entity::animatePosition(const str& role, const Vec3& position) {
+    animatePosition(getNode(role), position);
+}
+
+void Entity::animateRotation(const str& role, const Quat& rotation) {
+    animateRotation(getNode(role), rotation);
+}
+
+void Entity::animateScale(const str& role, const Vec3& scale) {
+    animateScale(getNode(role), scale);
+}
 
-    NodeHandle handle = getNode(role);
-    if (!handle.isValid()) {
+void Entity::animate(NodeHandle handle, const Mat4& localTransform) {
+    if (!scene || !handle.isValid()) {
         return;
     }
 
@@ -133,13 +151,8 @@ void Entity::animate(const str& role, const Mat4& localTransform) {
     }
 }
 
-void Entity::animatePosition(const str& role, const Vec3& position) {
-    if (!scene) {
-        return;
-    }
-
-    NodeHandle handle = getNode(role);
-    if (!handle.isValid()) {
+void Entity::animatePosition(NodeHandle handle, const Vec3& position) {
+    if (!scene || !handle.isValid()) {
         return;
     }
 
@@ -150,13 +163,8 @@ void Entity::animatePosition(const str& role, const Vec3& position) {
     }
 }
 
-void Entity::animateRotation(const str& role, const Quat& rotation) {
-    if (!scene) {
-        return;
-    }
-
-    NodeHandle handle = getNode(role);
-    if (!handle.isValid()) {
+void Entity::animateRotation(NodeHandle handle, const Quat& rotation) {
+    if (!scene || !handle.isValid()) {
         return;
     }
 
@@ -167,13 +175,8 @@ void Entity::animateRotation(const str& role, const Quat& rotation) {
     }
 }
 
-void Entity::animateScale(const str& role, const Vec3& scale) {
-    if (!scene) {
-        return;
-    }
-
-    NodeHandle handle = getNode(role);
-    if (!handle.isValid()) {
+void Entity::animateScale(NodeHandle handle, const Vec3& scale) {
+    if (!scene || !handle.isValid()) {
         return;
     }
 
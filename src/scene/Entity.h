@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "../core/NameTable.h"
 #include "../core/Types.h"
 #include "Scene.h"
 #include "SceneNode.h"
@@ -29,9 +30,10 @@ public:
     Entity(const str& name, Scene* scene);
     virtual ~Entity() = default;
 
-    // Node management
+    // Node management; roles are interned, so getNode(NameId) hashes no strings
     void                    addNode(NodeHandle node, const str& role = "");
     NodeHandle              getNode(const str& role) const;
+    NodeHandle              getNode(NameId role) const;
     std::vector<NodeHandle> getAllNodes() const;
 
     // Root transform (applies to entire entity)
@@ -53,18 +55,30 @@ public:
     void animateRotation(const str& role, const Quat& rotation);
     void animateScale(const str& role, const Vec3& scale);
 
+    // Same, for a node already resolved (e.g. through a role table); preferred per frame
+    void animate(NodeHandle node, const Mat4& localTransform);
+    void animatePosition(NodeHandle node, const Vec3& position);
+    void animateRotation(NodeHandle node, const Quat& rotation);
+    void animateScale(NodeHandle node, const Vec3& scale);
+
     // Accessors
     NodeHandle getRootNode() const { return rootNode; }
     const str& getName() const { return name; }
     Scene*     getScene() const { return scene; }
-    
+
+protected:
+    /**
+     * @brief Called by addNode() for every node given a role, so subclasses can cache it
+     */
+    virtual void onRoleAssigned(NameId /*role*/, NodeHandle /*node*/) {}
+
 private:
     str        name;
     Scene*     scene;
     NodeHandle rootNode;
 
     // Named node roles (e.g., "wheel_FL", "door_left", "steering_wheel")
-    std::unordered_map<str, NodeHandle> namedNodes;
+    std::unordered_map<NameId, NodeHandle> namedNodes;
 };
 
 }  // namespace DownPour
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: MIT
+#include "EntityRegistry.h"
+
+#include <atomic>
+
+namespace DownPour {
+
+EntityId EntityRegistry::create() {
+    uint32_t index;
+    if (!freeList.empty()) {
+        index = freeList.back();
+        freeList.pop_back();
+    } else {
+        index = static_cast<uint32_t>(generations.size());
+        generations.push_back(1);
+    }
+
+    aliveCount++;
+    return EntityId{index, generations[index]};
+}
+
+void EntityRegistry::destroy(EntityId id) {
+    if (!isAlive(id))
+        return;
+
+    for (auto& pool : pools) {
+        if (pool)
+            pool->remove(id);
+    }
+
+    generations[id.index]++;
+    freeList.push_back(id.index);
+    aliveCount--;
+}
+
+bool EntityRegistry::isAlive(EntityId id) const {
+    return id.index < generations.size() && generations[id.index] == id.generation;
+}
+
+void EntityRegistry::clear() {
+    for (auto& pool : pools) {
+        if (pool)
+            pool->clear();
+    }
+
+    // Keep generations so ids handed out before the clear never resolve again
+    freeList.clear();
+    for (uint32_t i = 0; i < generations.size(); i++) {
+        generations[i]++;
+        freeList.push_back(i);
+    }
+    aliveCount = 0;
+}
+
+uint32_t EntityRegistry::nextComponentType() {
+    static std::atomic<uint32_t> next{0};
+    return next++;
+}
+
+}  // namespace DownPour
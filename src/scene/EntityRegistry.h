@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace DownPour {
+
+/**
+ * @brief Stable id of an entity in an EntityRegistry
+ *
+ * Index + generation, like NodeHandle: ids of destroyed entities stop
+ * resolving even after their index is reused.
+ */
+struct EntityId {
+    uint32_t index      = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const EntityId& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityId& other) const { return !(*this == other); }
+
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+};
+
+/** @brief Type-erased pool interface, so the registry can strip an entity of all its components */
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase()     = default;
+    virtual void remove(EntityId id) = 0;
+    virtual void clear()             = 0;
+};
+
+/**
+ * @brief Sparse set of one component type
+ *
+ * Components are packed in a dense array, so systems iterate them
+ * contiguously with no per-entity indirection. `sparse` maps an entity
+ * index to its component's dense slot; removal swaps the last component
+ * into the hole, so dense order is not stable across removals.
+ */
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    /** @brief Add (or replace) `id`'s component */
+    T& add(EntityId id, T component) {
+        if (T* existing = get(id)) {
+            *existing = std::move(component);
+            return *existing;
+        }
+
+        if (id.index >= sparse.size())
+            sparse.resize(id.index + 1, NO_SLOT);
+        sparse[id.index] = static_cast<uint32_t>(dense.size());
+        owners.push_back(id);
+        dense.push_back(std::move(component));
+        return dense.back();
+    }
+
+    void remove(EntityId id) override {
+        if (!has(id))
+            return;
+
+        uint32_t slot = sparse[id.index];
+        uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+        if (slot != last) {
+            dense[slot]                = std::move(dense[last]);
+            owners[slot]               = owners[last];
+            sparse[owners[slot].index] = slot;
+        }
+        dense.pop_back();
+        owners.pop_back();
+        sparse[id.index] = NO_SLOT;
+    }
+
+    void clear() override {
+        sparse.clear();
+        owners.clear();
+        dense.clear();
+    }
+
+    bool has(EntityId id) const {
+        return id.index < sparse.size() && sparse[id.index] != NO_SLOT && owners[sparse[id.index]] == id;
+    }
+
+    T*       get(EntityId id) { return has(id) ? &dense[sparse[id.index]] : nullptr; }
+    const T* get(EntityId id) const { return has(id) ? &dense[sparse[id.index]] : nullptr; }
+
+    // Dense iteration: components()[i] belongs to entities()[i]
+    size_t                       size() const { return dense.size(); }
+    std::vector<T>&              components() { return dense; }
+    const std::vector<T>&        components() const { return dense; }
+    const std::vector<EntityId>& entities() const { return owners; }
+
+private:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFF;
+
+    std::vector<uint32_t> sparse;  // Entity index -> dense slot, or NO_SLOT
+    std::vector<EntityId> owners;  // Dense slot -> entity
+    std::vector<T>        dense;
+};
+
+/**
+ * @brief Entities as integer ids with components in per-type packed pools
+ *
+ * For entities that exist in large numbers (traffic): an entity is only an
+ * id, its data lives in ComponentPools, and systems update a whole pool in
+ * one loop. Entity subclasses remain the API for one-off objects (the
+ * player car, the camera); both can refer to the same scene nodes.
+ * Not thread-safe.
+ */
+class EntityRegistry {
+public:
+    EntityId create();
+    void     destroy(EntityId id);  // Removes all of its components
+    bool     isAlive(EntityId id) const;
+    size_t   size() const { return aliveCount; }
+    void     clear();
+
+    template <typename T>
+    ComponentPool<T>& pool() {
+        const uint32_t type = componentType<T>();
+        if (type >= pools.size())
+            pools.resize(type + 1);
+        if (!pools[type])
+            pools[type] = std::make_unique<ComponentPool<T>>();
+        return *static_cast<ComponentPool<T>*>(pools[type].get());
+    }
+
+    template <typename T>
+    T& add(EntityId id, T component = T{}) {
+        return pool<T>().add(id, std::move(component));
+    }
+
+    template <typename T>
+    T* get(EntityId id) {
+        return isAlive(id) ? pool<T>().get(id) : nullptr;
+    }
+
+    template <typename T>
+    void remove(EntityId id) {
+        pool<T>().remove(id);
+    }
+
+private:
+    std::vector<uint32_t>                           generations;  // Per index; bumped on destroy
+    std::vector<uint32_t>                           freeList;
+    size_t                                          aliveCount = 0;
+    std::vector<std::unique_ptr<ComponentPoolBase>> pools;  // Indexed by componentType<T>()
+
+    static uint32_t nextComponentType();
+
+    // Dense per-process id of each component type
+    template <typename T>
+    static uint32_t componentType() {
+        static const uint32_t type = nextComponentType();
+        return type;
+    }
+};
+
+}  // namespace DownPour
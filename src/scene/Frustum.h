@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "core/Types.h"
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace DownPour {
+using namespace DownPour::Types;
+
+/**
+ * @brief View frustum as six world-space planes
+ *
+ * Planes are extracted from a view-projection matrix (Gribb/Hartmann) and
+ * stored as (normal, distance) with normals pointing into the frustum.
+ * The near plane uses the OpenGL -w..w depth convention, which is also a
+ * conservative bound for Vulkan's 0..w depth range.
+ */
+struct Frustum {
+    std::array<Vec4, 6> planes;
+
+    Frustum() = default;
+    explicit Frustum(const Mat4& viewProj) { setFromMatrix(viewProj); }
+
+    void setFromMatrix(const Mat4& m) {
+        // glm is column-major: m[col][row]
+        Vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        Vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        Vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        Vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        planes[0] = row3 + row0;  // Left
+        planes[1] = row3 - row0;  // Right
+        planes[2] = row3 + row1;  // Bottom
+        planes[3] = row3 - row1;  // Top
+        planes[4] = row3 + row2;  // Near
+        planes[5] = row3 - row2;  // Far
+
+        for (Vec4& plane : planes) {
+            float length = glm::length(Vec3(plane));
+            if (length > 0.0f)
+                plane /= length;
+        }
+    }
+
+    /**
+     * @brief Test a world-space AABB against the frustum
+     * @return false only if the box is entirely outside one plane
+     */
+    bool intersectsAABB(const Vec3& boxMin, const Vec3& boxMax) const {
+        for (const Vec4& plane : planes) {
+            // Corner furthest along the plane normal
+            Vec3 positive(plane.x >= 0.0f ? boxMax.x : boxMin.x, plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                          plane.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (glm::dot(Vec3(plane), positive) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Transform a local-space AABB into a world-space AABB
+ *
+ * Uses the center/extent form so only one matrix-vector product is needed
+ * instead of transforming all eight corners.
+ */
+inline void transformAABB(const Mat4& transform, const Vec3& localMin, const Vec3& localMax, Vec3& outMin,
+                          Vec3& outMax) {
+    Vec3 center = (localMin + localMax) * 0.5f;
+    Vec3 extent = (localMax - localMin) * 0.5f;
+
+    Vec3 worldCenter = Vec3(transform * Vec4(center, 1.0f));
+    Vec3 worldExtent = glm::abs(Vec3(transform[0])) * extent.x + glm::abs(Vec3(transform[1])) * extent.y +
+                       glm::abs(Vec3(transform[2])) * extent.z;
+
+    outMin = worldCenter - worldExtent;
+    outMax = worldCenter + worldExtent;
+}
+
+}  // namespace DownPour
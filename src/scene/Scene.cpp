@@ -1,8 +1,14 @@
 // SPDX-License-Identifier: MIT
 #include "Scene.h"
 
+#include "Frustum.h"
+#include "core/JobSystem.h"
+#include "core/Profiler.h"
+
 #include <algorithm>
-#include <queue>
+#include <array>
+#include <functional>
+#include <iterator>
 
 namespace DownPour {
 typedef std::string str;
@@ -15,16 +21,22 @@ NodeHandle Scene::createNode(const str& nodeName) {
 
     SceneNode& node = nodes[index];
     node.name       = nodeName;
+    node.nameId     = NameTable::intern(nodeName);
     node.generation = node.generation + 1;  // Increment generation for new node
     node.parent     = NodeHandle{};         // No parent (invalid handle)
     node.children.clear();
-    node.localPosition  = Vec3(0.0f);
-    node.localRotation  = Quat(1.0f, 0.0f, 0.0f, 0.0f);
-    node.localScale     = Vec3(1.0f);
-    node.worldTransform = Mat4(1.0f);
-    node.isDirty        = true;
-    node.renderData     = std::nullopt;
-    node.isStatic       = true;
+    node.localPosition = Vec3(0.0f);
+    node.localRotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);
+    node.localScale    = Vec3(1.0f);
+    node.isDirty       = true;
+    node.renderData    = std::nullopt;
+    node.boundsMin     = Vec3(0.0f);
+    node.boundsMax     = Vec3(0.0f);
+    node.isStatic      = true;
+
+    // A reused slot must not pick up the transforms of the node it last held
+    if (index < slotToFlat.size())
+        slotToFlat[index] = NO_FLAT_INDEX;
 
     NodeHandle handle{index, node.generation};
 
@@ -35,7 +47,12 @@ NodeHandle Scene::createNode(const str& nodeName) {
     activeNodes.push_back(handle);
 
     // Add to name lookup
-    nameToHandle[nodeName] = handle;
+    nameToHandle[node.nameId] = handle;
+    prefixIndexDirty          = true;
+
+    spatialIndexDirty = true;
+    drawListDirty     = true;
+    hierarchyDirty    = true;
 
     return handle;
 }
@@ -48,6 +65,47 @@ NodeHandle Scene::createNode(const str& nodeName, NodeHandle parent) {
     return handle;
 }
 
+std::vector<NodeHandle> Scene::appendNodes(std::vector<SceneNode>&& newNodes, const std::vector<uint32_t>& parents) {
+    DP_PROFILE_SCOPE("Scene::appendNodes");
+
+    const uint32_t          base  = static_cast<uint32_t>(nodes.size());
+    const uint32_t          count = static_cast<uint32_t>(std::min(newNodes.size(), parents.size()));
+    std::vector<NodeHandle> handles(count);
+    activeNodes.reserve(activeNodes.size() + count);
+
+    // Fresh slots start at generation 0, so their first handles carry 1, as createNode() would give them
+    for (uint32_t i = 0; i < count; i++) {
+        SceneNode& node = newNodes[i];
+        handles[i]      = NodeHandle{base + i, 1};
+        node.generation = 1;
+        node.nameId     = NameTable::intern(node.name);
+        node.isDirty    = true;
+        node.children.clear();
+
+        const uint32_t parent = parents[i];
+        if (parent < i) {
+            node.parent = handles[parent];
+            newNodes[parent].children.push_back(handles[i]);
+        } else {
+            node.parent = NodeHandle{};
+            rootNodes.push_back(handles[i]);
+        }
+
+        activeNodes.push_back(handles[i]);
+        nameToHandle[node.nameId] = handles[i];
+    }
+
+    nodes.insert(nodes.end(), std::make_move_iterator(newNodes.begin()),
+                 std::make_move_iterator(newNodes.begin() + count));
+    newNodes.clear();
+
+    prefixIndexDirty  = true;
+    spatialIndexDirty = true;
+    drawListDirty     = true;
+    hierarchyDirty    = true;
+    return handles;
+}
+
 void Scene::destroyNode(NodeHandle handle) {
     if (!isHandleValid(handle))
         return;
@@ -71,13 +129,18 @@ void Scene::destroyNode(NodeHandle handle) {
     for (NodeHandle child : childrenCopy)
         destroyNode(child);
 
-    auto it = nameToHandle.find(node->name);
-    if (it != nameToHandle.end() && it->second == handle)
+    auto it = nameToHandle.find(node->nameId);
+    if (it != nameToHandle.end() && it->second == handle) {
         nameToHandle.erase(it);
+        prefixIndexDirty = true;
+    }
 
     activeNodes.erase(std::remove(activeNodes.begin(), activeNodes.end(), handle), activeNodes.end());
 
     freeNodeSlot(handle.index);
+    spatialIndexDirty = true;
+    drawListDirty     = true;
+    hierarchyDirty    = true;
 }
 
 SceneNode* Scene::getNode(NodeHandle handle) {
@@ -93,6 +156,12 @@ const SceneNode* Scene::getNode(NodeHandle handle) const {
 }
 
 NodeHandle Scene::findNode(const str& nodeName) const {
+    // A name nobody interned cannot belong to a node
+    NameId id = NameTable::find(nodeName);
+    return id != INVALID_NAME_ID ? findNode(id) : NodeHandle{};
+}
+
+NodeHandle Scene::findNode(NameId nodeName) const {
     auto it = nameToHandle.find(nodeName);
     if (it != nameToHandle.end())
         return it->second;
@@ -100,10 +169,23 @@ NodeHandle Scene::findNode(const str& nodeName) const {
 }
 
 std::vector<NodeHandle> Scene::findNodesWithPrefix(const str& prefix) const {
+    if (prefixIndexDirty) {
+        prefixIndex.clear();
+        prefixIndex.reserve(nameToHandle.size());
+        for (const auto& [id, handle] : nameToHandle)
+            prefixIndex.emplace_back(&NameTable::name(id), handle);
+        std::sort(prefixIndex.begin(), prefixIndex.end(),
+                  [](const auto& a, const auto& b) { return *a.first < *b.first; });
+        prefixIndexDirty = false;
+    }
+
+    // Names with the prefix sort contiguously, starting at the first name >= prefix
+    auto first = std::lower_bound(prefixIndex.begin(), prefixIndex.end(), prefix,
+                                  [](const auto& entry, const str& value) { return *entry.first < value; });
+
     std::vector<NodeHandle> results;
-    for (const auto& [name, handle] : nameToHandle)
-        if (name.find(prefix) == 0)
-            results.push_back(handle);
+    for (auto it = first; it != prefixIndex.end() && it->first->compare(0, prefix.size(), prefix) == 0; ++it)
+        results.push_back(it->second);
     return results;
 }
 
@@ -137,7 +219,8 @@ void Scene::setParent(NodeHandle child, NodeHandle parent) {
         rootNodes.push_back(child);
     }
 
-    markSubtreeDirty(child);
+    // Moves the subtree within the flat order; the rebuild updates every transform
+    hierarchyDirty = true;
 }
 
 void Scene::removeParent(NodeHandle child) {
@@ -145,69 +228,277 @@ void Scene::removeParent(NodeHandle child) {
 }
 
 void Scene::updateTransforms() {
-    if (rootNodes.empty())
-        return;
+    DP_PROFILE_SCOPE("Scene::updateTransforms");
 
-    std::queue<std::pair<NodeHandle, glm::mat4>> queue;
+    if (hierarchyDirty)
+        rebuildHierarchy();
 
-    for (NodeHandle rootHandle : rootNodes)
-        queue.push({rootHandle, glm::mat4(1.0f)});
+    for (uint32_t flat : dynamicFlat)
+        dirtyBits[flat >> 6] |= 1ull << (flat & 63);
+    anyDirty = anyDirty || !dynamicFlat.empty();
 
-    while (!queue.empty()) {
-        auto [handle, parentWorld] = queue.front();
-        queue.pop();
+    // Nothing moved: world transforms and BVH bounds are all current
+    if (!anyDirty) {
+        if (spatialIndexDirty)
+            rebuildSpatialIndex();
+        return;
+    }
 
-        SceneNode* node = getNode(handle);
-        if (!node)
+    // Each dirty node starts a range covering its whole subtree; dirty nodes inside it are covered too
+    dirtyRanges.clear();
+    const uint32_t count      = static_cast<uint32_t>(flatSlot.size());
+    uint32_t       dirtyNodes = 0;
+    for (uint32_t flat = 0; flat < count;) {
+        uint64_t bits = dirtyBits[flat >> 6] >> (flat & 63);
+        if (bits == 0) {
+            flat = (flat | 63) + 1;  // Rest of this word is clean
             continue;
+        }
+        for (; (bits & 1) == 0; bits >>= 1)
+            flat++;
 
-        if (node->isStatic && !node->isDirty)
-            continue;
+        const uint32_t end = flatSubtreeEnd[flat];
+        dirtyRanges.push_back({flat, end});
+        dirtyNodes += end - flat;
+        flat = end;
+    }
+    std::fill(dirtyBits.begin(), dirtyBits.end(), 0);
+    anyDirty = false;
 
-        glm::mat4 localTransform = node->getLocalTransform();
-        node->worldTransform     = parentWorld * localTransform;
-        node->isDirty            = false;
+    if (dirtyNodes < PARALLEL_UPDATE_NODES) {
+        for (const FlatRange& range : dirtyRanges)
+            updateRange(range.first, range.second);
+    } else {
+        // Large subtrees are cut below their top nodes, which go first so every job's parents are current
+        jobRanges.clear();
+        spineNodes.clear();
+        for (const FlatRange& range : dirtyRanges)
+            splitForJobs(range.first);
+
+        for (uint32_t flat : spineNodes)
+            updateRange(flat, flat + 1);
+        JobSystem::get().parallelFor(static_cast<uint32_t>(jobRanges.size()), 1, [this](uint32_t job) {
+            updateRange(jobRanges[job].first, jobRanges[job].second);
+        });
+    }
+
+    // Nodes new to the hierarchy did not move: they start out where they are
+    for (uint32_t flat : newFlat)
+        flatPreviousWorld[flat] = flatWorld[flat];
+    newFlat.clear();
 
-        for (NodeHandle childHandle : node->children)
-            queue.push({childHandle, node->worldTransform});
+    // Many updates between captures would only repeat the same ranges; past that, catch everything up
+    if (movedRanges.size() + dirtyRanges.size() > count) {
+        movedRanges.assign(1, {0, count});
+    } else {
+        movedRanges.insert(movedRanges.end(), dirtyRanges.begin(), dirtyRanges.end());
     }
-}
 
-void Scene::markDirty(NodeHandle handle) {
-    if (!isHandleValid(handle))
+    if (spatialIndexDirty || bvh.needsRebuild()) {
+        rebuildSpatialIndex();
         return;
+    }
 
-    SceneNode* node = getNode(handle);
-    if (node) {
-        node->isDirty = true;
+    // Refit the leaves of moved renderables (single-threaded: the BVH queues dirty leaves)
+    Vec3 worldMin, worldMax;
+    for (const FlatRange& range : dirtyRanges) {
+        for (uint32_t flat = range.first; flat < range.second; flat++) {
+            if (computeWorldBounds(flatSlot[flat], worldMin, worldMax))
+                bvh.updateItem(flatSlot[flat], worldMin, worldMax);
+        }
     }
+    bvh.refit();
 }
 
-void Scene::markSubtreeDirty(NodeHandle handle) {
-    if (!isHandleValid(handle))
+void Scene::capturePreviousTransforms() {
+    // Only the nodes moved since the last capture differ from their previous transforms
+    for (const FlatRange& range : movedRanges)
+        std::copy(flatWorld.begin() + range.first, flatWorld.begin() + range.second,
+                  flatPreviousWorld.begin() + range.first);
+    movedRanges.clear();
+}
+
+void Scene::updateRange(uint32_t first, uint32_t end) {
+    // Pre-order: a parent's world transform is always written before its children read it
+    for (uint32_t flat = first; flat < end; flat++) {
+        SceneNode& node = nodes[flatSlot[flat]];
+        if (node.isDirty) {
+            flatLocal[flat] = node.getLocalTransform();
+            node.isDirty    = false;
+        }
+
+        const uint32_t parent = flatParent[flat];
+        flatWorld[flat]       = parent == NO_FLAT_INDEX ? flatLocal[flat] : flatWorld[parent] * flatLocal[flat];
+    }
+}
+
+void Scene::splitForJobs(uint32_t first) {
+    const uint32_t end = flatSubtreeEnd[first];
+    if (end - first <= SUBTREE_JOB_NODES) {
+        // Siblings sit next to each other in the flat order; pack small ones into one job
+        if (!jobRanges.empty() && jobRanges.back().second == first &&
+            end - jobRanges.back().first <= SUBTREE_JOB_NODES)
+            jobRanges.back().second = end;
+        else
+            jobRanges.push_back({first, end});
         return;
+    }
 
-    std::queue<NodeHandle> queue;
-    queue.push(handle);
+    spineNodes.push_back(first);
+    for (uint32_t child = first + 1; child < end; child = flatSubtreeEnd[child])
+        splitForJobs(child);
+}
 
-    while (!queue.empty()) {
-        NodeHandle current = queue.front();
-        queue.pop();
+void Scene::rebuildHierarchy() {
+    // Surviving nodes keep their previous transforms through the reorder; every node is recomputed below,
+    // so the moved ranges restart from the full update that follows
+    std::vector<Mat4>     lastPreviousWorld = std::move(flatPreviousWorld);
+    std::vector<uint32_t> lastSlotToFlat    = std::move(slotToFlat);
+    flatPreviousWorld.clear();
+    newFlat.clear();
+    movedRanges.clear();
+
+    const size_t count = activeNodes.size();
+    flatSlot.clear();
+    flatParent.clear();
+    flatSlot.reserve(count);
+    flatParent.reserve(count);
+    dynamicFlat.clear();
+    slotToFlat.assign(nodes.size(), NO_FLAT_INDEX);
+
+    // Depth-first from each root; children are pushed in reverse so they come out in order
+    std::vector<std::pair<NodeHandle, uint32_t>> stack;
+    for (auto root = rootNodes.rbegin(); root != rootNodes.rend(); ++root)
+        stack.push_back({*root, NO_FLAT_INDEX});
+
+    while (!stack.empty()) {
+        auto [handle, parent] = stack.back();
+        stack.pop_back();
 
-        SceneNode* node = getNode(current);
+        SceneNode* node = getNode(handle);
         if (!node)
             continue;
 
+        const uint32_t flat      = static_cast<uint32_t>(flatSlot.size());
+        slotToFlat[handle.index] = flat;
+        flatSlot.push_back(handle.index);
+        flatParent.push_back(parent);
+        if (handle.index < lastSlotToFlat.size() && lastSlotToFlat[handle.index] != NO_FLAT_INDEX) {
+            flatPreviousWorld.push_back(lastPreviousWorld[lastSlotToFlat[handle.index]]);
+        } else {
+            flatPreviousWorld.emplace_back(1.0f);
+            newFlat.push_back(flat);
+        }
+        if (!node->isStatic)
+            dynamicFlat.push_back(flat);
+
+        // Every transform is recomputed below, local ones included
         node->isDirty = true;
 
-        for (NodeHandle child : node->children)
-            queue.push(child);
+        for (auto child = node->children.rbegin(); child != node->children.rend(); ++child)
+            stack.push_back({*child, flat});
     }
+
+    // Children follow their parent, so one backwards pass extends each parent over its subtree
+    const uint32_t flatCount = static_cast<uint32_t>(flatSlot.size());
+    flatSubtreeEnd.resize(flatCount);
+    for (uint32_t flat = 0; flat < flatCount; flat++)
+        flatSubtreeEnd[flat] = flat + 1;
+    for (uint32_t flat = flatCount; flat-- > 0;) {
+        if (flatParent[flat] != NO_FLAT_INDEX)
+            flatSubtreeEnd[flatParent[flat]] = std::max(flatSubtreeEnd[flatParent[flat]], flatSubtreeEnd[flat]);
+    }
+
+    flatLocal.resize(flatCount);
+    flatWorld.resize(flatCount);
+
+    // All roots dirty: the next pass covers every node
+    dirtyBits.assign((flatCount + 63) / 64, 0);
+    for (uint32_t flat = 0; flat < flatCount; flat = flatSubtreeEnd[flat])
+        dirtyBits[flat >> 6] |= 1ull << (flat & 63);
+    anyDirty       = flatCount > 0;
+    hierarchyDirty = false;
+}
+
+const Mat4& Scene::getWorldTransform(NodeHandle handle) const {
+    static const Mat4 identity(1.0f);
+    return isHandleValid(handle) ? worldTransformOf(handle.index) : identity;
+}
+
+const Mat4& Scene::worldTransformOf(uint32_t slot) const {
+    static const Mat4 identity(1.0f);
+    if (slot >= slotToFlat.size() || slotToFlat[slot] == NO_FLAT_INDEX)
+        return identity;  // Created since the last rebuild
+    return flatWorld[slotToFlat[slot]];
+}
+
+const Mat4& Scene::getPreviousWorldTransform(NodeHandle handle) const {
+    static const Mat4 identity(1.0f);
+    if (!isHandleValid(handle) || handle.index >= slotToFlat.size() || slotToFlat[handle.index] == NO_FLAT_INDEX)
+        return identity;
+    return flatPreviousWorld[slotToFlat[handle.index]];
 }
 
-std::vector<Scene::RenderBatch> Scene::getRenderBatches() const {
-    std::unordered_map<const Model*, std::vector<SceneNode*>> opaqueBatches;
-    std::unordered_map<const Model*, std::vector<SceneNode*>> transparentBatches;
+void Scene::rebuildSpatialIndex() {
+    std::vector<SceneBVH::Item> items;
+    items.reserve(activeNodes.size());
+    unboundedSlots.clear();
+
+    for (const NodeHandle& handle : activeNodes) {
+        const SceneNode* node = getNode(handle);
+        if (!node || !node->renderData)
+            continue;
+
+        SceneBVH::Item item{handle.index, Vec3(0.0f), Vec3(0.0f)};
+        if (computeWorldBounds(handle.index, item.boundsMin, item.boundsMax))
+            items.push_back(item);
+        else
+            unboundedSlots.push_back(handle.index);
+    }
+
+    bvh.build(items);
+    spatialIndexDirty = false;
+}
+
+bool Scene::computeWorldBounds(uint32_t slot, Vec3& outMin, Vec3& outMax) const {
+    const SceneNode& node = nodes[slot];
+    if (!node.renderData || node.boundsMin == node.boundsMax)
+        return false;
+    transformAABB(worldTransformOf(slot), node.boundsMin, node.boundsMax, outMin, outMax);
+    return true;
+}
+
+bool Scene::getWorldBounds(NodeHandle handle, Vec3& outMin, Vec3& outMax) const {
+    if (!getNode(handle))
+        return false;
+    return computeWorldBounds(handle.index, outMin, outMax);
+}
+
+void Scene::markDirty(NodeHandle handle) {
+    SceneNode* node = getNode(handle);
+    if (!node)
+        return;
+    node->isDirty = true;
+
+    // A pending rebuild marks everything anyway
+    if (hierarchyDirty || handle.index >= slotToFlat.size() || slotToFlat[handle.index] == NO_FLAT_INDEX)
+        return;
+
+    const uint32_t flat = slotToFlat[handle.index];
+    dirtyBits[flat >> 6] |= 1ull << (flat & 63);
+    anyDirty = true;
+}
+
+ArenaVector<Scene::RenderBatch> Scene::getRenderBatches(FrameArena& arena) const {
+    // Group with one sort over (transparency, model, creation order) instead of per-model maps
+    struct Entry {
+        bool         isTransparent;
+        const Model* model;
+        uint32_t     order;
+        SceneNode*   node;
+    };
+    ArenaVector<Entry> entries{ArenaAllocator<Entry>(arena)};
+    entries.reserve(activeNodes.size());
 
     for (const NodeHandle& handle : activeNodes) {
         const SceneNode* node = getNode(handle);
@@ -221,41 +512,278 @@ std::vector<Scene::RenderBatch> Scene::getRenderBatches() const {
         if (!model)
             continue;
 
-        bool isTransparent = node->renderData->isTransparent;
-
-        if (isTransparent)
-            transparentBatches[model].push_back(const_cast<SceneNode*>(node));
-        else
-            opaqueBatches[model].push_back(const_cast<SceneNode*>(node));
+        entries.push_back(Entry{node->renderData->isTransparent, model, static_cast<uint32_t>(entries.size()),
+                                const_cast<SceneNode*>(node)});
     }
 
-    std::vector<RenderBatch> batches;
-    for (const auto& [model, nodeList] : opaqueBatches)
-        batches.push_back(RenderBatch{model, nodeList, false});
-    for (const auto& [model, nodeList] : transparentBatches)
-        batches.push_back(RenderBatch{model, nodeList, true});
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.isTransparent != b.isTransparent)
+            return !a.isTransparent;
+        if (a.model != b.model)
+            return std::less<const Model*>()(a.model, b.model);
+        return a.order < b.order;
+    });
+
+    ArenaVector<RenderBatch> batches{ArenaAllocator<RenderBatch>(arena)};
+    for (size_t i = 0; i < entries.size();) {
+        size_t end = i + 1;
+        while (end < entries.size() && entries[end].model == entries[i].model &&
+               entries[end].isTransparent == entries[i].isTransparent)
+            end++;
+
+        RenderBatch batch{entries[i].model, ArenaVector<SceneNode*>(ArenaAllocator<SceneNode*>(arena)),
+                          entries[i].isTransparent};
+        batch.nodes.reserve(end - i);
+        for (size_t e = i; e < end; e++)
+            batch.nodes.push_back(entries[e].node);
+        batches.push_back(std::move(batch));
+        i = end;
+    }
 
     return batches;
 }
 
-void Scene::collectVisibleNodes(const glm::mat4& viewProj, std::vector<SceneNode*>& outNodes) const {
+template <typename Allocator>
+void Scene::collectVisibleNodes(const glm::mat4& viewProj, std::vector<SceneNode*, Allocator>& outNodes) const {
+    Frustum frustum(viewProj);
+
+    // Index not built yet (updateTransforms not called since the last topology change):
+    // fall back to testing every node directly
+    if (spatialIndexDirty) {
+        for (const NodeHandle& handle : activeNodes) {
+            const SceneNode* node = getNode(handle);
+            if (!node)
+                continue;
+            if (!node->renderData || !node->renderData->isVisible)
+                continue;
+
+            Vec3 worldMin, worldMax;
+            if (computeWorldBounds(handle.index, worldMin, worldMax) && !frustum.intersectsAABB(worldMin, worldMax))
+                continue;
+
+            outNodes.push_back(const_cast<SceneNode*>(node));
+        }
+        return;
+    }
+
+    querySlots.clear();
+    bvh.query(frustum, querySlots);
+    querySlots.insert(querySlots.end(), unboundedSlots.begin(), unboundedSlots.end());
+
+    for (uint32_t slot : querySlots) {
+        const SceneNode& node = nodes[slot];
+        if (!node.renderData || !node.renderData->isVisible)
+            continue;
+        outNodes.push_back(const_cast<SceneNode*>(&node));
+    }
+}
+
+template void Scene::collectVisibleNodes(const glm::mat4&, std::vector<SceneNode*>&) const;
+template void Scene::collectVisibleNodes(const glm::mat4&, ArenaVector<SceneNode*>&) const;
+
+uint64_t Scene::makeSortKey(bool isTransparent, uint32_t materialFeatures, uint32_t materialId, uint32_t modelId) {
+    return (static_cast<uint64_t>(isTransparent ? 1 : 0) << 63) |
+           (static_cast<uint64_t>(materialFeatures & 0x7u) << 60) |
+           (static_cast<uint64_t>(materialId & 0x0FFFFFFFu) << 32) | static_cast<uint64_t>(modelId);
+}
+
+const std::vector<Scene::DrawItem>& Scene::getDrawList() {
+    if (drawListDirty)
+        rebuildDrawList();
+    return drawList;
+}
+
+void Scene::rebuildDrawList() {
+    drawList.clear();  // Keeps capacity
+    modelIds.clear();
+
     for (const NodeHandle& handle : activeNodes) {
         const SceneNode* node = getNode(handle);
-        if (!node)
-            continue;
-        if (!node->renderData || !node->renderData->isVisible)
+        if (!node || !node->renderData || !node->renderData->isVisible || !node->renderData->model)
             continue;
 
-        outNodes.push_back(const_cast<SceneNode*>(node));
+        const SceneNode::RenderData& rd = *node->renderData;
+        uint32_t modelId = modelIds.emplace(rd.model, static_cast<uint32_t>(modelIds.size())).first->second;
+
+        DrawItem item{};
+        item.sortKey          = makeSortKey(rd.isTransparent, rd.materialFeatures, rd.materialId, modelId);
+        item.handle           = handle;
+        item.model            = rd.model;
+        item.materialId       = rd.materialId;
+        item.materialFeatures = rd.materialFeatures;
+        item.baseIndexStart   = rd.indexStart;
+        item.indexStart       = rd.indexStart;
+        item.indexCount       = rd.indexCount;
+        item.vertexOffset     = rd.vertexOffset;
+        item.isTransparent    = rd.isTransparent;
+        drawList.push_back(item);
+    }
+
+    // Group copies of a primitive for instancing, then tie-break on slot index so the
+    // order is stable between rebuilds
+    std::sort(drawList.begin(), drawList.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.sortKey != b.sortKey)
+            return a.sortKey < b.sortKey;
+        if (a.baseIndexStart != b.baseIndexStart)
+            return a.baseIndexStart < b.baseIndexStart;
+        if (a.vertexOffset != b.vertexOffset)
+            return a.vertexOffset < b.vertexOffset;
+        return a.handle.index < b.handle.index;
+    });
+
+    drawListDirty = false;
+}
+
+void Scene::cullDrawList(const glm::mat4& viewProj, const glm::mat4* extraViewProjs, uint32_t extraViewCount) {
+    if (drawListDirty)
+        rebuildDrawList();
+
+    // View 0 is the main view, extra view N is bit N + 1
+    const uint32_t viewCount = 1 + std::min(extraViewCount, MAX_EXTRA_VIEWS);
+
+    std::array<Frustum, 1 + MAX_EXTRA_VIEWS> frustums;
+    frustums[0] = Frustum(viewProj);
+    for (uint32_t view = 1; view < viewCount; view++)
+        frustums[view] = Frustum(extraViewProjs[view - 1]);
+    const uint8_t allViews = static_cast<uint8_t>((1u << viewCount) - 1);
+
+    // No BVH yet: test each draw's bounds directly
+    if (spatialIndexDirty) {
+        for (DrawItem& item : drawList) {
+            Vec3    worldMin, worldMax;
+            uint8_t mask = allViews;
+            if (computeWorldBounds(item.handle.index, worldMin, worldMax)) {
+                mask = 0;
+                for (uint32_t view = 0; view < viewCount; view++) {
+                    if (frustums[view].intersectsAABB(worldMin, worldMax))
+                        mask |= static_cast<uint8_t>(1u << view);
+                }
+            }
+            item.inFrustum     = (mask & 1) != 0;
+            item.extraViewMask = static_cast<uint8_t>(mask >> 1);
+        }
+        return;
+    }
+
+    slotInFrustum.assign(nodes.size(), 0);
+    for (uint32_t view = 0; view < viewCount; view++) {
+        querySlots.clear();
+        bvh.query(frustums[view], querySlots);
+        for (uint32_t slot : querySlots)
+            slotInFrustum[slot] |= static_cast<uint8_t>(1u << view);
+    }
+    for (uint32_t slot : unboundedSlots)
+        slotInFrustum[slot] = allViews;
+
+    for (DrawItem& item : drawList) {
+        const uint8_t mask = slotInFrustum[item.handle.index];
+        item.inFrustum     = (mask & 1) != 0;
+        item.extraViewMask = static_cast<uint8_t>(mask >> 1);
+    }
+}
+
+void Scene::selectLods(const glm::vec3& cameraPosition, float pixelsPerUnit) {
+    DP_PROFILE_SCOPE("Scene::selectLods");
+
+    if (drawListDirty)
+        rebuildDrawList();
+
+    for (DrawItem& item : drawList) {
+        const SceneNode&             node = nodes[item.handle.index];
+        const SceneNode::RenderData& rd   = *node.renderData;
+
+        // Distance to the nearest point of the node's bounds; kept for culled draws too (texture streaming)
+        const Mat4& world = worldTransformOf(item.handle.index);
+        const float scale = std::max(glm::length(Vec3(world[0])),
+                                     std::max(glm::length(Vec3(world[1])), glm::length(Vec3(world[2]))));
+        const Vec3  center = Vec3(world * glm::vec4((node.boundsMin + node.boundsMax) * 0.5f, 1.0f));
+        const float radius = glm::length(node.boundsMax - node.boundsMin) * 0.5f * scale;
+        item.distance      = std::max(glm::length(center - cameraPosition) - radius, 1e-3f);
+
+        if (rd.lodCount == 0 || (!item.inFrustum && item.extraViewMask == 0))
+            continue;  // Culled draws keep their level until they come back; extra views share the main view's
+
+        // Pixels per model unit at that point
+        const float projected = pixelsPerUnit * scale / item.distance;
+
+        const uint32_t level = selectMeshLod(rd.lods.data(), rd.lodCount, item.lod, projected);
+
+        item.lod        = static_cast<uint8_t>(level);
+        item.indexStart = level == 0 ? rd.indexStart : rd.lods[level - 1].indexStart;
+        item.indexCount = level == 0 ? rd.indexCount : rd.lods[level - 1].indexCount;
     }
 }
 
+void Scene::setRenderData(NodeHandle handle, const SceneNode::RenderData& renderData) {
+    SceneNode* node = getNode(handle);
+    if (!node)
+        return;
+    node->renderData  = renderData;
+    drawListDirty     = true;
+    spatialIndexDirty = true;
+}
+
+void Scene::clearRenderData(NodeHandle handle) {
+    SceneNode* node = getNode(handle);
+    if (!node || !node->renderData)
+        return;
+    node->renderData  = std::nullopt;
+    drawListDirty     = true;
+    spatialIndexDirty = true;
+}
+
+void Scene::setVisible(NodeHandle handle, bool visible) {
+    SceneNode* node = getNode(handle);
+    if (!node || !node->renderData || node->renderData->isVisible == visible)
+        return;
+    node->renderData->isVisible = visible;
+    drawListDirty               = true;
+}
+
+void Scene::setMaterial(NodeHandle handle, uint32_t materialId) {
+    SceneNode* node = getNode(handle);
+    if (!node || !node->renderData || node->renderData->materialId == materialId)
+        return;
+    node->renderData->materialId = materialId;
+    drawListDirty                = true;
+}
+
+void Scene::setTransparent(NodeHandle handle, bool transparent) {
+    SceneNode* node = getNode(handle);
+    if (!node || !node->renderData || node->renderData->isTransparent == transparent)
+        return;
+    node->renderData->isTransparent = transparent;
+    drawListDirty                   = true;
+}
+
 void Scene::clear() {
     nodes.clear();
     freeList.clear();
     rootNodes.clear();
     activeNodes.clear();
     nameToHandle.clear();
+    registry.clear();
+    prefixIndex.clear();
+    prefixIndexDirty = true;
+    bvh.clear();
+    unboundedSlots.clear();
+    spatialIndexDirty = true;
+    drawList.clear();
+    modelIds.clear();
+    drawListDirty = true;
+    flatSlot.clear();
+    flatParent.clear();
+    flatSubtreeEnd.clear();
+    flatLocal.clear();
+    flatWorld.clear();
+    flatPreviousWorld.clear();
+    newFlat.clear();
+    movedRanges.clear();
+    slotToFlat.clear();
+    dirtyBits.clear();
+    dynamicFlat.clear();
+    hierarchyDirty = true;
+    anyDirty       = false;
 }
 
 bool Scene::isHandleValid(NodeHandle handle) const {
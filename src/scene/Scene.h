@@ -1,12 +1,16 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "../core/FrameArena.h"
 #include "../core/Types.h"
+#include "EntityRegistry.h"
+#include "SceneBVH.h"
 #include "SceneNode.h"
 
 #include <glm/glm.hpp>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 namespace DownPour {
 typedef std::string str;
@@ -18,6 +22,11 @@ using namespace DownPour::Types;
  * Manages a collection of SceneNodes with parent-child relationships.
  * Provides efficient transform propagation and rendering traversal.
  * Uses flat array storage for cache efficiency.
+ *
+ * Transforms live apart from the nodes, in arrays ordered parent-first
+ * (pre-order, so every subtree is one contiguous range). updateTransforms()
+ * walks only the subtrees marked dirty, front to back, which reads each
+ * parent's world matrix just before its children need it.
  */
 class Scene {
 public:
@@ -37,9 +46,33 @@ public:
     NodeHandle createNode(const str& name, NodeHandle parent);
     void       destroyNode(NodeHandle handle);
 
+    /** @brief Parent index appendNodes() takes for nodes that become roots */
+    static constexpr uint32_t APPEND_ROOT = 0xFFFFFFFF;
+
+    /**
+     * @brief Add many nodes at once, as restored by SceneCache
+     *
+     * The nodes take fresh slots at the end of the node array, in order, so
+     * their handles are fixed up from `parents` alone: parent[i] is the index
+     * of node i's parent within `newNodes` (it must come earlier) or
+     * APPEND_ROOT. Names are interned, children lists and parents rebuilt;
+     * everything else, renderData included, is taken as given.
+     *
+     * @return Handles of the added nodes, in order
+     */
+    std::vector<NodeHandle> appendNodes(std::vector<SceneNode>&& newNodes, const std::vector<uint32_t>& parents);
+
     SceneNode*              getNode(NodeHandle handle);
     const SceneNode*        getNode(NodeHandle handle) const;
     NodeHandle              findNode(const str& name) const;
+    NodeHandle              findNode(NameId name) const;
+
+    /**
+     * @brief Nodes whose name starts with `prefix`, in name order
+     *
+     * Binary search over a sorted name index, rebuilt on first use after nodes
+     * are created or destroyed (not thread-safe).
+     */
     std::vector<NodeHandle> findNodesWithPrefix(const str& prefix) const;
 
     // Hierarchy manipulation
@@ -47,20 +80,162 @@ public:
     void                    removeParent(NodeHandle child);  // Make node a root
     std::vector<NodeHandle> getRootNodes() const { return rootNodes; }
 
-    // Transform propagation
-    void updateTransforms();                   // Update all dirty transforms
-    void markDirty(NodeHandle handle);         // Mark node as dirty
-    void markSubtreeDirty(NodeHandle handle);  // Mark node and all descendants as dirty
+    /**
+     * @brief Recompute world transforms of dirty subtrees and refit the spatial index
+     *
+     * Does nothing when no node was marked dirty (or is non-static) and the
+     * hierarchy is unchanged. Large updates are split into per-subtree jobs.
+     */
+    void updateTransforms();
+
+    /**
+     * @brief Flag a node whose local TRS changed; its descendants are updated with it
+     *
+     * SceneNode's setters only flag the node itself, so changes to existing
+     * nodes must be reported here to be picked up.
+     */
+    void markDirty(NodeHandle handle);
+    void markSubtreeDirty(NodeHandle handle) { markDirty(handle); }  // Same thing: subtrees always update together
+
+    /**
+     * @brief World transform as of the last updateTransforms() (identity for nodes created since)
+     */
+    const Mat4& getWorldTransform(NodeHandle handle) const;
+
+    /**
+     * @brief Remember the current world transforms as the previous ones, for motion vectors
+     *
+     * Call once per frame, before the frame's updateTransforms(). Copies only the
+     * nodes moved since the last call.
+     */
+    void capturePreviousTransforms();
+
+    /**
+     * @brief World transform as of the last capturePreviousTransforms()
+     *
+     * Nodes added to the hierarchy since then start out with their first world transform.
+     */
+    const Mat4& getPreviousWorldTransform(NodeHandle handle) const;
+
+    /**
+     * @brief World-space AABB of a node's mesh as of the last updateTransforms()
+     * @return false for invalid handles and nodes without bounds
+     */
+    bool getWorldBounds(NodeHandle handle, Vec3& outMin, Vec3& outMax) const;
+
+    /**
+     * @brief Force the spatial index to be rebuilt on the next updateTransforms()
+     *
+     * Node creation/destruction does this automatically; call it after attaching
+     * renderData or changing bounds on an existing node.
+     */
+    void invalidateSpatialIndex() { spatialIndexDirty = true; }
 
     // Rendering support
     struct RenderBatch {
         const Model*            model;
-        std::vector<SceneNode*> nodes;  // All nodes sharing this model
+        ArenaVector<SceneNode*> nodes;  // All nodes sharing this model, in creation order
         bool                    isTransparent;
     };
 
-    std::vector<RenderBatch> getRenderBatches() const;
-    void                     collectVisibleNodes(const glm::mat4& viewProj, std::vector<SceneNode*>& outNodes) const;
+    /**
+     * @brief Visible renderable nodes grouped by model, opaque batches first
+     * @param arena Holds the result; valid until the arena is reset
+     */
+    ArenaVector<RenderBatch> getRenderBatches(FrameArena& arena) const;
+
+    /**
+     * @brief Cached draw entry for one visible renderable node
+     *
+     * Render state is copied out of the node so iteration never touches the
+     * optional RenderData or the node array except for the world transform.
+     */
+    struct DrawItem {
+        uint64_t     sortKey;
+        NodeHandle   handle;
+        const Model* model;
+        uint32_t     materialId;
+        uint32_t     materialFeatures;
+        uint32_t     baseIndexStart;  // Full-detail range; with model and vertexOffset, identifies the primitive
+        uint32_t     indexStart;      // Range drawn at the selected LOD
+        uint32_t     indexCount;
+        int32_t      vertexOffset;
+        bool         isTransparent;
+        bool         inFrustum     = true;  // Updated by cullDrawList()
+        uint8_t      extraViewMask = 0;     // Bit N: in extra view N's frustum; updated by cullDrawList()
+        uint8_t      lod           = 0;     // 0 = full detail, else RenderData::lods[lod - 1]; set by selectLods()
+        float        distance      = 0.0f;  // Camera to the nearest point of the bounds; set by selectLods()
+    };
+
+    /**
+     * @brief Build a draw sort key: transparency (bit 63), material features (bits 60-62),
+     *        material (bits 32-59), model (bits 0-31)
+     *
+     * The top four bits select the pipeline variant, so each variant's draws are contiguous.
+     */
+    static uint64_t makeSortKey(bool isTransparent, uint32_t materialFeatures, uint32_t materialId, uint32_t modelId);
+
+    /** @brief Sort key bits holding the material ID */
+    static constexpr uint64_t SORT_KEY_MATERIAL_MASK = 0x0FFFFFFF00000000ull;
+
+    /**
+     * @brief Persistent draw list, sorted by sortKey
+     *
+     * Within a key, draws of the same primitive are adjacent, so the renderer
+     * can draw all copies of a repeated model as one instanced command.
+     * Rebuilt only after nodes are created/destroyed or their render state changes
+     * through the setters below; otherwise returned as-is with no allocation.
+     */
+    const std::vector<DrawItem>& getDrawList();
+
+    /**
+     * @brief Id-based entities of this scene (traffic and other bulk objects) and their components
+     */
+    EntityRegistry&       getRegistry() { return registry; }
+    const EntityRegistry& getRegistry() const { return registry; }
+
+    /** @brief Most extra views cullDrawList() tests in the same pass (DrawItem::extraViewMask bits) */
+    static constexpr uint32_t MAX_EXTRA_VIEWS = 7;
+
+    /**
+     * @brief Update DrawItem::inFrustum for every draw against the view frustum
+     *
+     * Extra views (shadow cascades, mirrors) are culled in the same pass over the draw list
+     * into DrawItem::extraViewMask, so every view records from one list.
+     *
+     * @param extraViewProjs extraViewCount view-projections, at most MAX_EXTRA_VIEWS
+     */
+    void cullDrawList(const glm::mat4& viewProj, const glm::mat4* extraViewProjs = nullptr,
+                      uint32_t extraViewCount = 0);
+
+    /**
+     * @brief Pick each in-frustum draw's LOD from its projected size; updates indexStart/indexCount
+     *
+     * Takes the coarsest level whose simplification error projects to at most
+     * LOD_MAX_PIXEL_ERROR pixels. A draw only switches once its projection is
+     * LOD_HYSTERESIS past the switch point, so nodes sitting right at it don't pop.
+     *
+     * @param cameraPosition World-space eye position
+     * @param pixelsPerUnit Pixels one world unit covers at distance 1: viewport height / (2 tan(fovY / 2))
+     */
+    void selectLods(const glm::vec3& cameraPosition, float pixelsPerUnit);
+
+    // Render state changes (keep the draw list and spatial index in sync)
+    void setRenderData(NodeHandle handle, const SceneNode::RenderData& renderData);
+    void clearRenderData(NodeHandle handle);
+    void setVisible(NodeHandle handle, bool visible);
+    void setMaterial(NodeHandle handle, uint32_t materialId);
+    void setTransparent(NodeHandle handle, bool transparent);
+
+    /**
+     * @brief Collect renderable, visible nodes whose world bounds intersect the view frustum
+     *
+     * Traverses the BVH maintained by updateTransforms(). Nodes without bounds are
+     * always returned. Call updateTransforms() first so world bounds are current.
+     * Instantiated for std::vector's default allocator and for ArenaVector.
+     */
+    template <typename Allocator>
+    void collectVisibleNodes(const glm::mat4& viewProj, std::vector<SceneNode*, Allocator>& outNodes) const;
 
     // Scene management
     void       clear();
@@ -84,14 +259,60 @@ private:
     // Active nodes (excludes nodes in free list) - for efficient iteration
     std::vector<NodeHandle> activeNodes;
 
-    // Name lookup cache
-    std::unordered_map<str, NodeHandle> nameToHandle;
+    // Name lookup cache; the last node created with a name wins
+    std::unordered_map<NameId, NodeHandle>                 nameToHandle;
+    mutable std::vector<std::pair<const str*, NodeHandle>> prefixIndex;  // nameToHandle sorted by name
+    mutable bool                                           prefixIndexDirty = true;
+
+    EntityRegistry registry;
+
+    // Spatial index over world-space bounds of renderable nodes
+    SceneBVH                      bvh;
+    std::vector<uint32_t>         unboundedSlots;  // Renderable nodes without bounds (never culled)
+    bool                          spatialIndexDirty = true;
+    mutable std::vector<uint32_t> querySlots;  // Scratch for collectVisibleNodes (not thread-safe)
+
+    // Transform hierarchy, indexed by flat (pre-order) position; rebuilt when parenting changes
+    static constexpr uint32_t NO_FLAT_INDEX         = 0xFFFFFFFF;
+    static constexpr uint32_t PARALLEL_UPDATE_NODES = 4096;  // Dirty nodes before the update is split into jobs
+    static constexpr uint32_t SUBTREE_JOB_NODES     = 1024;  // Target size of one job's range
+
+    typedef std::pair<uint32_t, uint32_t> FlatRange;  // [first, end) flat indices
+
+    std::vector<uint32_t>  flatSlot;           // Node slot at each flat index
+    std::vector<uint32_t>  flatParent;         // Parent's flat index, or NO_FLAT_INDEX for roots
+    std::vector<uint32_t>  flatSubtreeEnd;     // One past the node's last descendant
+    std::vector<Mat4>      flatLocal;          // Cached TRS; rebuilt only when SceneNode::isDirty
+    std::vector<Mat4>      flatWorld;
+    std::vector<Mat4>      flatPreviousWorld;  // flatWorld at the last capturePreviousTransforms()
+    std::vector<uint32_t>  slotToFlat;         // Node slot -> flat index
+    std::vector<uint64_t>  dirtyBits;          // Flat indices whose subtree needs new world transforms
+    std::vector<uint32_t>  dynamicFlat;        // Non-static nodes, marked dirty every update
+    std::vector<FlatRange> dirtyRanges;        // Scratch for updateTransforms()
+    std::vector<FlatRange> movedRanges;        // Updated since the last capturePreviousTransforms()
+    std::vector<uint32_t>  newFlat;            // Nodes added by the last rebuild, with no previous transform yet
+    std::vector<FlatRange> jobRanges;
+    std::vector<uint32_t>  spineNodes;         // Parents of job ranges, updated before the jobs run
+    bool                   hierarchyDirty = true;
+    bool                   anyDirty       = false;
+
+    // Cached, sorted draw list
+    std::vector<DrawItem>                      drawList;
+    std::unordered_map<const Model*, uint32_t> modelIds;       // Dense ids for sort keys
+    std::vector<uint8_t>                       slotInFrustum;  // Scratch for cullDrawList: bit per view
+    bool                                       drawListDirty = true;
 
     // Helper methods
-    void     propagateTransform(NodeHandle handle, const Mat4& parentWorld);
-    bool     isHandleValid(NodeHandle handle) const;
-    uint32_t allocateNodeSlot();
-    void     freeNodeSlot(uint32_t index);
+    void        rebuildHierarchy();
+    void        updateRange(uint32_t first, uint32_t end);
+    void        splitForJobs(uint32_t first);
+    bool        isHandleValid(NodeHandle handle) const;
+    uint32_t    allocateNodeSlot();
+    void        freeNodeSlot(uint32_t index);
+    void        rebuildSpatialIndex();
+    void        rebuildDrawList();
+    bool        computeWorldBounds(uint32_t slot, Vec3& outMin, Vec3& outMax) const;
+    const Mat4& worldTransformOf(uint32_t slot) const;
 };
 
 }  // namespace DownPour
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: MIT
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace DownPour {
+
+void SceneBVH::build(const std::vector<Item>& newItems) {
+    clear();
+    if (newItems.empty())
+        return;
+
+    items = newItems;
+    nodes.reserve(items.size() * 2 / MAX_LEAF_ITEMS + 1);
+    itemToLeaf.assign(items.size(), INVALID_NODE);
+
+    buildRecursive(0, static_cast<uint32_t>(items.size()), INVALID_NODE);
+
+    // Map scene slots back to their (reordered) item positions for refits
+    uint32_t maxSlot = 0;
+    for (const Item& item : items)
+        maxSlot = std::max(maxSlot, item.slot);
+    slotToItem.assign(maxSlot + 1, INVALID_NODE);
+    for (size_t i = 0; i < items.size(); i++)
+        slotToItem[items[i].slot] = static_cast<int32_t>(i);
+
+    builtRootArea = surfaceArea(nodes[0].boundsMin, nodes[0].boundsMax);
+}
+
+int32_t SceneBVH::buildRecursive(uint32_t begin, uint32_t end, int32_t parent) {
+    int32_t nodeIndex = static_cast<int32_t>(nodes.size());
+    nodes.emplace_back();
+    nodes[nodeIndex].parent = parent;
+
+    // Bounds of the whole range, plus bounds of the centroids for choosing the split axis
+    Vec3 boundsMin = items[begin].boundsMin;
+    Vec3 boundsMax = items[begin].boundsMax;
+    Vec3 centroidMin(std::numeric_limits<float>::max());
+    Vec3 centroidMax(-std::numeric_limits<float>::max());
+    for (uint32_t i = begin; i < end; i++) {
+        boundsMin     = glm::min(boundsMin, items[i].boundsMin);
+        boundsMax     = glm::max(boundsMax, items[i].boundsMax);
+        Vec3 centroid = (items[i].boundsMin + items[i].boundsMax) * 0.5f;
+        centroidMin   = glm::min(centroidMin, centroid);
+        centroidMax   = glm::max(centroidMax, centroid);
+    }
+    nodes[nodeIndex].boundsMin = boundsMin;
+    nodes[nodeIndex].boundsMax = boundsMax;
+
+    uint32_t count = end - begin;
+    if (count <= MAX_LEAF_ITEMS) {
+        nodes[nodeIndex].firstItem = begin;
+        nodes[nodeIndex].itemCount = count;
+        for (uint32_t i = begin; i < end; i++)
+            itemToLeaf[i] = nodeIndex;
+        return nodeIndex;
+    }
+
+    // Median split along the axis with the widest centroid spread
+    Vec3 spread = centroidMax - centroidMin;
+    int  axis   = 0;
+    if (spread.y > spread.x)
+        axis = 1;
+    if (spread.z > spread[axis])
+        axis = 2;
+
+    uint32_t mid = begin + count / 2;
+    std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                     [axis](const Item& a, const Item& b) {
+                         return a.boundsMin[axis] + a.boundsMax[axis] < b.boundsMin[axis] + b.boundsMax[axis];
+                     });
+
+    // nodes may reallocate during recursion, so only index it afterwards
+    int32_t left           = buildRecursive(begin, mid, nodeIndex);
+    int32_t right          = buildRecursive(mid, end, nodeIndex);
+    nodes[nodeIndex].left  = left;
+    nodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+void SceneBVH::updateItem(uint32_t slot, const Vec3& boundsMin, const Vec3& boundsMax) {
+    if (slot >= slotToItem.size() || slotToItem[slot] == INVALID_NODE)
+        return;
+
+    Item& item = items[slotToItem[slot]];
+    if (item.boundsMin == boundsMin && item.boundsMax == boundsMax)
+        return;
+
+    item.boundsMin = boundsMin;
+    item.boundsMax = boundsMax;
+    dirtyLeaves.push_back(itemToLeaf[slotToItem[slot]]);
+}
+
+void SceneBVH::refit() {
+    for (int32_t nodeIndex : dirtyLeaves) {
+        // Walk towards the root, stopping as soon as a node's bounds are unaffected
+        while (nodeIndex != INVALID_NODE) {
+            BVHNode& node   = nodes[nodeIndex];
+            Vec3     oldMin = node.boundsMin;
+            Vec3     oldMax = node.boundsMax;
+            computeBounds(node);
+            if (node.boundsMin == oldMin && node.boundsMax == oldMax)
+                break;
+            nodeIndex = node.parent;
+        }
+    }
+    dirtyLeaves.clear();
+}
+
+void SceneBVH::computeBounds(BVHNode& node) const {
+    if (node.isLeaf()) {
+        node.boundsMin = items[node.firstItem].boundsMin;
+        node.boundsMax = items[node.firstItem].boundsMax;
+        for (uint32_t i = node.firstItem + 1; i < node.firstItem + node.itemCount; i++) {
+            node.boundsMin = glm::min(node.boundsMin, items[i].boundsMin);
+            node.boundsMax = glm::max(node.boundsMax, items[i].boundsMax);
+        }
+    } else {
+        node.boundsMin = glm::min(nodes[node.left].boundsMin, nodes[node.right].boundsMin);
+        node.boundsMax = glm::max(nodes[node.left].boundsMax, nodes[node.right].boundsMax);
+    }
+}
+
+void SceneBVH::query(const Frustum& frustum, std::vector<uint32_t>& outSlots) const {
+    if (nodes.empty())
+        return;
+
+    // Fixed-size traversal stack; depth is bounded by log2 of the item count
+    int32_t stack[64];
+    int     stackSize  = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHNode& node = nodes[stack[--stackSize]];
+        if (!frustum.intersectsAABB(node.boundsMin, node.boundsMax))
+            continue;
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount; i++) {
+                if (frustum.intersectsAABB(items[i].boundsMin, items[i].boundsMax))
+                    outSlots.push_back(items[i].slot);
+            }
+        } else {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+}
+
+bool SceneBVH::needsRebuild() const {
+    if (nodes.empty())
+        return false;
+    float area = surfaceArea(nodes[0].boundsMin, nodes[0].boundsMax);
+    return area > std::max(builtRootArea, 1e-6f) * REBUILD_AREA_RATIO;
+}
+
+void SceneBVH::clear() {
+    nodes.clear();
+    items.clear();
+    slotToItem.clear();
+    itemToLeaf.clear();
+    dirtyLeaves.clear();
+    builtRootArea = 0.0f;
+}
+
+float SceneBVH::surfaceArea(const Vec3& boundsMin, const Vec3& boundsMax) {
+    Vec3 d = glm::max(boundsMax - boundsMin, Vec3(0.0f));
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+}  // namespace DownPour
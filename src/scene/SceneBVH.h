@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "Frustum.h"
+#include "core/Types.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+using namespace DownPour::Types;
+
+/**
+ * @brief Bounding volume hierarchy over renderable scene node slots
+ *
+ * Built top-down with a median split along the longest axis. Items whose
+ * bounds change (dynamic nodes) are refit in place by walking from their
+ * leaf to the root; the tree is only rebuilt when its topology becomes stale
+ * (items added/removed) or refitting has inflated the root too far.
+ */
+class SceneBVH {
+public:
+    struct Item {
+        uint32_t slot;  // Scene node slot index
+        Vec3     boundsMin;
+        Vec3     boundsMax;
+    };
+
+    /**
+     * @brief Rebuild the hierarchy from scratch
+     * @param items World-space bounds for every node slot to index
+     */
+    void build(const std::vector<Item>& items);
+
+    /**
+     * @brief Update the bounds of an already indexed slot
+     *
+     * Takes effect on the next refit(). Slots not in the tree are ignored.
+     */
+    void updateItem(uint32_t slot, const Vec3& boundsMin, const Vec3& boundsMax);
+
+    /**
+     * @brief Propagate bounds changes from updateItem() up to the root
+     */
+    void refit();
+
+    /**
+     * @brief Append the slots of all items intersecting the frustum
+     */
+    void query(const Frustum& frustum, std::vector<uint32_t>& outSlots) const;
+
+    /**
+     * @brief True when refitting has degraded the tree enough to warrant a rebuild
+     */
+    bool needsRebuild() const;
+
+    void   clear();
+    bool   empty() const { return nodes.empty(); }
+    size_t getItemCount() const { return items.size(); }
+
+private:
+    static constexpr uint32_t MAX_LEAF_ITEMS     = 4;
+    static constexpr int32_t  INVALID_NODE       = -1;
+    static constexpr float    REBUILD_AREA_RATIO = 2.0f;  // Rebuild once the root grows past 2x its built area
+
+    struct BVHNode {
+        Vec3     boundsMin;
+        Vec3     boundsMax;
+        int32_t  parent    = INVALID_NODE;
+        int32_t  left      = INVALID_NODE;  // Child indices (internal nodes only)
+        int32_t  right     = INVALID_NODE;
+        uint32_t firstItem = 0;  // Item range (leaves only)
+        uint32_t itemCount = 0;
+
+        bool isLeaf() const { return itemCount > 0; }
+    };
+
+    std::vector<BVHNode> nodes;
+    std::vector<Item>    items;       // Reordered so each leaf owns a contiguous range
+    std::vector<int32_t> slotToItem;  // Scene slot -> index into items, or INVALID_NODE
+    std::vector<int32_t> itemToLeaf;  // Item index -> owning leaf node
+    std::vector<int32_t> dirtyLeaves;
+    float                builtRootArea = 0.0f;
+
+    int32_t      buildRecursive(uint32_t begin, uint32_t end, int32_t parent);
+    void         computeBounds(BVHNode& node) const;
+    static float surfaceArea(const Vec3& boundsMin, const Vec3& boundsMax);
+};
+
+}  // namespace DownPour
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: MIT
 #include "SceneBuilder.h"
 
+#include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace DownPour {
@@ -30,6 +31,42 @@ std::vector<NodeHandle> SceneBuilder::buildFromModel(Scene* scene, const Model*
         }
     }
 
+    // Merged static geometry: one extra root per batch, in the same space as the glTF roots
+    for (const NamedMesh* batch : model->getStaticBatches()) {
+        if (batch->primitiveIndex >= model->getMaterialCount()) {
+            continue;
+        }
+
+        NodeHandle handle = scene->createNode(batch->name);
+        SceneNode* node   = scene->getNode(handle);
+        if (!node) {
+            continue;
+        }
+        node->boundsMin = batch->minBounds;
+        node->boundsMax = batch->maxBounds;
+
+        const size_t          matIdx = batch->primitiveIndex;
+        SceneNode::RenderData renderData;
+        renderData.model            = model;
+        renderData.meshIndex        = batch->meshIndex;
+        renderData.primitiveIndex   = batch->primitiveIndex;
+        renderData.indexStart       = batch->indexStart;
+        renderData.indexCount       = batch->indexCount;
+        renderData.vertexOffset     = batch->vertexOffset;
+        renderData.isVisible        = true;
+        renderData.isTransparent    = model->getMaterial(matIdx).props.isTransparent;
+        renderData.materialFeatures = model->getMaterial(matIdx).props.getFeatureMask() & MATERIAL_FEATURE_TEXTURES;
+
+        auto it               = materialIds.find(matIdx);
+        renderData.materialId = it != materialIds.end() ? it->second : 0;
+
+        renderData.lodCount = static_cast<uint32_t>(std::min<size_t>(batch->lods.size(), MAX_MESH_LODS));
+        std::copy_n(batch->lods.begin(), renderData.lodCount, renderData.lods.begin());
+
+        scene->setRenderData(handle, renderData);
+        rootHandles.push_back(handle);
+    }
+
     return rootHandles;
 }
 
@@ -62,8 +99,8 @@ NodeHandle SceneBuilder::createNodeRecursive(Scene* scene, const Model* model, i
 
     node->isDirty = true;  // Needs transform update
 
-    // Attach render data if node has a mesh
-    if (gltfNode.meshIndex >= 0) {
+    // Attach render data if node has a mesh (merged nodes are drawn by their static batch)
+    if (gltfNode.meshIndex >= 0 && !model->isNodeMerged(nodeIndex)) {
         // Find materials that belong to this specific mesh
         auto meshMaterials = model->getMaterialsForMesh(gltfNode.meshIndex);
 
@@ -73,13 +110,15 @@ NodeHandle SceneBuilder::createNodeRecursive(Scene* scene, const Model* model, i
 
             // Create render data
             SceneNode::RenderData renderData;
-            renderData.model          = model;
-            renderData.meshIndex      = static_cast<uint32_t>(gltfNode.meshIndex);
-            renderData.primitiveIndex = static_cast<uint32_t>(material->primitiveIndex);
-            renderData.indexStart     = material->indexStart;
-            renderData.indexCount     = material->indexCount;
-            renderData.isVisible      = true;
-            renderData.isTransparent  = material->props.isTransparent;
+            renderData.model            = model;
+            renderData.meshIndex        = static_cast<uint32_t>(gltfNode.meshIndex);
+            renderData.primitiveIndex   = static_cast<uint32_t>(material->primitiveIndex);
+            renderData.indexStart       = material->indexStart;
+            renderData.indexCount       = material->indexCount;
+            renderData.vertexOffset     = material->vertexOffset;
+            renderData.isVisible        = true;
+            renderData.isTransparent    = material->props.isTransparent;
+            renderData.materialFeatures = material->props.getFeatureMask() & MATERIAL_FEATURE_TEXTURES;
 
             // Get MaterialManager ID from the mapping
             auto it = materialIds.find(matIdx);
@@ -90,7 +129,19 @@ NodeHandle SceneBuilder::createNodeRecursive(Scene* scene, const Model* model, i
                 renderData.materialId = 0;  // Fallback (may cause issues)
             }
 
-            node->renderData = renderData;
+            // LODs belong to the primitive's range, so only take them when the material draws exactly that
+            const NamedMesh* primitive = model->findPrimitive(renderData.meshIndex, renderData.primitiveIndex);
+            if (primitive && primitive->indexStart == material->indexStart &&
+                primitive->indexCount == material->indexCount) {
+                renderData.lodCount = static_cast<uint32_t>(std::min<size_t>(primitive->lods.size(), MAX_MESH_LODS));
+                std::copy_n(primitive->lods.begin(), renderData.lodCount, renderData.lods.begin());
+            }
+
+            // Local-space bounds for frustum culling
+            model->getPrimitiveBounds(renderData.meshIndex, renderData.primitiveIndex, node->boundsMin,
+                                      node->boundsMax);
+
+            scene->setRenderData(handle, renderData);
         }
         // If no materials found for this mesh, node has no render data (invisible)
     }
@@ -21,12 +21,14 @@ public:
      *
      * Traverses the model's node hierarchy and creates corresponding SceneNodes
      * with proper parent-child relationships and transforms. Attaches rendering
-     * data for nodes that reference meshes.
+     * data for nodes that reference meshes. Nodes the model merged into static
+     * batches (ModelLoadOptions::mergeStatic) are created without it; each batch
+     * becomes an extra root node instead, so the draw count follows materials.
      *
      * @param scene Target scene to populate
      * @param model Source model with glTF hierarchy
      * @param materialIds Map from material index to MaterialManager ID
-     * @return Root node handle of created hierarchy (or multiple roots if scene has multiple)
+     * @return Root node handles of the created hierarchy, then one per static batch
      */
     static std::vector<NodeHandle> buildFromModel(Scene* scene, const Model* model,
                                                   const std::unordered_map<size_t, uint32_t>& materialIds);
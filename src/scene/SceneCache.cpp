@@ -0,0 +1,358 @@
+// SPDX-License-Identifier: MIT
+#include "SceneCache.h"
+
+#include "core/BinaryIO.h"
+#include "core/Profiler.h"
+#include "logger/Logger.h"
+#include "renderer/Model.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace DownPour {
+
+namespace {
+
+constexpr char CACHE_MAGIC[4]    = {'D', 'P', 'S', 'C'};
+constexpr char CACHE_EXTENSION[] = ".dpscene";
+
+/**
+ * @brief Fixed-size file header; the body follows immediately
+ */
+struct SnapshotHeader {
+    char     magic[4];
+    uint32_t version;
+    uint64_t sourceHash;   // Source path + bytes
+    uint64_t sidecarHash;  // `.json` sidecar bytes; 0 without one
+    uint64_t modelKey;     // modelFingerprint() of the model the nodes were built from
+    uint32_t nodeStride;   // sizeof(CachedNode) when saved
+    uint32_t reserved;
+    uint64_t bodySize;
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "SnapshotHeader is read with memcpy");
+
+bool reject(const std::string& cachePath, const char* reason) {
+    DP_LOG(Info, "Scene cache: ignoring %s (%s)", cachePath.c_str(), reason);
+    return false;
+}
+
+}  // namespace
+
+bool SceneCache::load(const std::string& sourcePath) {
+    DP_PROFILE_SCOPE("SceneCache::load");
+    clear();
+
+    uint64_t sourceHash = 0, sidecarHash = 0;
+    if (!hashInputs(sourcePath, sourceHash, sidecarHash))
+        return false;
+
+    const std::string path = cachePathFor(sourcePath, sourceHash, sidecarHash);
+    MappedFile        file(path);
+    if (!file.isOpen())
+        return false;  // Not saved yet
+
+    SnapshotHeader header{};
+    if (file.size() < sizeof(header))
+        return reject(path, "truncated");
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION ||
+        header.sourceHash != sourceHash || header.sidecarHash != sidecarHash ||
+        header.nodeStride != sizeof(CachedNode)) {
+        return reject(path, "stale format");
+    }
+    if (header.bodySize != file.size() - sizeof(header))
+        return reject(path, "truncated");
+
+    BlobReader              in(file.data() + sizeof(header), header.bodySize);
+    std::vector<CachedNode> readNodes = in.getArray<CachedNode>();
+    std::string             readNames = in.getString();
+
+    std::vector<std::pair<std::string, uint32_t>> readRoles(in.getCount(sizeof(uint32_t) * 2));
+    for (auto& [role, node] : readRoles) {
+        role = in.getString();
+        node = in.get<uint32_t>();
+    }
+    std::vector<unsigned char> readConfig = in.getArray<unsigned char>();
+    if (!in.atEnd())
+        return reject(path, "damaged");
+
+    // Every index is fixed up blindly on instantiate(), so check them all once here
+    for (size_t i = 0; i < readNodes.size(); i++) {
+        const CachedNode& record = readNodes[i];
+        if ((record.parent >= i && record.parent != Scene::APPEND_ROOT) || record.lodCount > MAX_MESH_LODS ||
+            record.nameOffset > readNames.size() || record.nameLength > readNames.size() - record.nameOffset) {
+            return reject(path, "damaged");
+        }
+    }
+    for (const auto& [role, node] : readRoles) {
+        if (node >= readNodes.size())
+            return reject(path, "damaged");
+    }
+
+    cachePath = path;
+    modelKey  = header.modelKey;
+    nodes     = std::move(readNodes);
+    names     = std::move(readNames);
+    roles     = std::move(readRoles);
+    config    = std::move(readConfig);
+    loaded    = true;
+    return true;
+}
+
+bool SceneCache::instantiate(Scene& scene, const Model& model, const std::unordered_map<size_t, uint32_t>& materialIds,
+                             std::vector<NodeHandle>& outRoots, RoleNodes& outRoles) const {
+    DP_PROFILE_SCOPE("SceneCache::instantiate");
+
+    if (!loaded)
+        return false;
+    if (modelFingerprint(model) != modelKey)
+        return reject(cachePath, "model geometry changed");
+
+    std::vector<SceneNode> sceneNodes(nodes.size());
+    std::vector<uint32_t>  parents(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const CachedNode& record = nodes[i];
+        SceneNode&        node   = sceneNodes[i];
+        node.name.assign(names, record.nameOffset, record.nameLength);
+        node.localPosition = record.localPosition;
+        node.localRotation = record.localRotation;
+        node.localScale    = record.localScale;
+        node.boundsMin     = record.boundsMin;
+        node.boundsMax     = record.boundsMax;
+        node.isStatic      = record.isStatic != 0;
+        parents[i]         = record.parent;
+
+        if (record.hasRenderData) {
+            SceneNode::RenderData renderData;
+            renderData.model            = &model;
+            renderData.meshIndex        = record.meshIndex;
+            renderData.primitiveIndex   = record.primitiveIndex;
+            renderData.materialFeatures = record.materialFeatures;
+            renderData.isVisible        = record.isVisible != 0;
+            renderData.isTransparent    = record.isTransparent != 0;
+            renderData.indexStart       = record.indexStart;
+            renderData.indexCount       = record.indexCount;
+            renderData.vertexOffset     = record.vertexOffset;
+            renderData.lods             = record.lods;
+            renderData.lodCount         = record.lodCount;
+
+            // Same fallback as SceneBuilder for a material without a GPU mapping
+            auto it               = materialIds.find(record.materialIndex);
+            renderData.materialId = it != materialIds.end() ? it->second : 0;
+            node.renderData       = renderData;
+        }
+    }
+
+    const std::vector<NodeHandle> handles = scene.appendNodes(std::move(sceneNodes), parents);
+
+    outRoots.clear();
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (parents[i] == Scene::APPEND_ROOT)
+            outRoots.push_back(handles[i]);
+    }
+    outRoles.clear();
+    for (const auto& [role, node] : roles)
+        outRoles[role] = handles[node];
+
+    DP_LOG(Info, "Scene cache: restored %zu nodes from %s", handles.size(), cachePath.c_str());
+    return true;
+}
+
+bool SceneCache::save(const std::string& sourcePath, const Scene& scene, const Model& model,
+                      const std::vector<NodeHandle>& roots, const std::unordered_map<size_t, uint32_t>& materialIds,
+                      const RoleNodes& roles, const std::vector<char>& config) {
+    DP_PROFILE_SCOPE("SceneCache::save");
+
+    SnapshotHeader header{};
+    if (!hashInputs(sourcePath, header.sourceHash, header.sidecarHash))
+        return false;
+
+    // Render data only keeps the ID; IDs are unique per material, so the map inverts
+    std::unordered_map<uint32_t, uint32_t> materialIndices;
+    for (const auto& [index, id] : materialIds)
+        materialIndices[id] = static_cast<uint32_t>(index);
+
+    // Pre-order from each root, children in order: every parent is written before its children
+    std::vector<CachedNode>                      records;
+    std::string                                  nameTable;
+    std::unordered_map<uint32_t, uint32_t>       slotToRecord;
+    std::vector<std::pair<NodeHandle, uint32_t>> stack;
+    for (auto root = roots.rbegin(); root != roots.rend(); ++root)
+        stack.push_back({*root, Scene::APPEND_ROOT});
+
+    while (!stack.empty()) {
+        const auto [handle, parent] = stack.back();
+        stack.pop_back();
+        const SceneNode* node = scene.getNode(handle);
+        if (!node)
+            continue;
+
+        const uint32_t index = static_cast<uint32_t>(records.size());
+        slotToRecord[handle.index] = index;
+
+        CachedNode record{};
+        record.nameOffset    = static_cast<uint32_t>(nameTable.size());
+        record.nameLength    = static_cast<uint32_t>(node->name.size());
+        record.parent        = parent;
+        record.materialIndex = NO_MATERIAL;
+        record.localPosition = node->localPosition;
+        record.localRotation = node->localRotation;
+        record.localScale    = node->localScale;
+        record.boundsMin     = node->boundsMin;
+        record.boundsMax     = node->boundsMax;
+        record.isStatic      = node->isStatic;
+        nameTable += node->name;
+
+        if (const auto& renderData = node->renderData) {
+            auto it                 = materialIndices.find(renderData->materialId);
+            record.materialIndex    = it != materialIndices.end() ? it->second : NO_MATERIAL;
+            record.meshIndex        = renderData->meshIndex;
+            record.primitiveIndex   = renderData->primitiveIndex;
+            record.materialFeatures = renderData->materialFeatures;
+            record.indexStart       = renderData->indexStart;
+            record.indexCount       = renderData->indexCount;
+            record.vertexOffset     = renderData->vertexOffset;
+            record.lodCount         = renderData->lodCount;
+            record.lods             = renderData->lods;
+            record.hasRenderData    = 1;
+            record.isVisible        = renderData->isVisible;
+            record.isTransparent    = renderData->isTransparent;
+        }
+        records.push_back(record);
+
+        for (auto child = node->children.rbegin(); child != node->children.rend(); ++child)
+            stack.push_back({*child, index});
+    }
+
+    BlobWriter body;
+    body.putArray(records);
+    body.putString(nameTable);
+
+    std::vector<std::pair<const std::string*, uint32_t>> roleRecords;
+    for (const auto& [role, handle] : roles) {
+        auto it = slotToRecord.find(handle.index);
+        if (it != slotToRecord.end() && scene.getNode(handle))
+            roleRecords.push_back({&role, it->second});
+    }
+    body.put(static_cast<uint32_t>(roleRecords.size()));
+    for (const auto& [role, record] : roleRecords) {
+        body.putString(*role);
+        body.put(record);
+    }
+    body.putArray(config);
+
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version    = VERSION;
+    header.modelKey   = modelFingerprint(model);
+    header.nodeStride = sizeof(CachedNode);
+    header.bodySize   = body.getData().size();
+
+    const std::string cachePath = cachePathFor(sourcePath, header.sourceHash, header.sidecarHash);
+    const std::string tempPath  = cachePath + ".tmp";
+
+    std::error_code error;
+    std::filesystem::create_directories(CACHE_DIRECTORY, error);
+
+    // Same temp-and-rename as MeshCache, so a crash never leaves a truncated file
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        DP_LOG(Warning, "Scene cache: cannot write %s", tempPath.c_str());
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(body.getData().data(), static_cast<std::streamsize>(header.bodySize));
+    file.close();
+
+    if (!file) {
+        DP_LOG(Warning, "Scene cache: failed writing %s", tempPath.c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        DP_LOG(Warning, "Scene cache: cannot replace %s: %s", cachePath.c_str(), error.message().c_str());
+        return false;
+    }
+
+    // Drop snapshots of earlier versions of this source (<stem>-<16 hex digits>.dpscene)
+    const std::string prefix = std::filesystem::path(sourcePath).stem().string() + "-";
+    const size_t      length = prefix.size() + 16 + sizeof(CACHE_EXTENSION) - 1;
+    for (const auto& entry : std::filesystem::directory_iterator(CACHE_DIRECTORY, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == length && name.rfind(prefix, 0) == 0 && entry.path().extension() == CACHE_EXTENSION &&
+            entry.path() != std::filesystem::path(cachePath)) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    DP_LOG(Info, "Scene cache: saved %zu nodes to %s", records.size(), cachePath.c_str());
+    return true;
+}
+
+void SceneCache::clear() {
+    cachePath.clear();
+    modelKey = 0;
+    nodes.clear();
+    names.clear();
+    roles.clear();
+    config.clear();
+    loaded = false;
+}
+
+bool SceneCache::hashInputs(const std::string& sourcePath, uint64_t& outSourceHash, uint64_t& outSidecarHash) {
+    // Seeded with the path, like the mesh cache: the same bytes elsewhere are another model
+    const auto* path = reinterpret_cast<const unsigned char*>(sourcePath.data());
+    if (!hashFile(sourcePath, hashBytes(path, sourcePath.size(), 0), outSourceHash))
+        return false;
+
+    // Same path rule as ModelAdapter::loadMetadata(); a sidecar that exists but cannot be read disables the cache
+    const std::string sidecarPath = sourcePath + ".json";
+    outSidecarHash                = 0;
+    return !std::filesystem::exists(sidecarPath) || hashFile(sidecarPath, outSourceHash, outSidecarHash);
+}
+
+uint64_t SceneCache::modelFingerprint(const Model& model) {
+    // Everything SceneBuilder copies out of the loaded model besides the glTF nodes, which the source hash covers
+    BlobWriter key;
+    key.put(static_cast<uint64_t>(model.getNodes().size()));
+    for (const NamedMesh& mesh : model.getNamedMeshes()) {
+        key.put(mesh.meshIndex);
+        key.put(mesh.primitiveIndex);
+        key.put(mesh.indexStart);
+        key.put(mesh.indexCount);
+        key.put(mesh.vertexOffset);
+        key.put(mesh.minBounds);
+        key.put(mesh.maxBounds);
+        key.putArray(mesh.lods);
+    }
+    for (const Material& material : model.getMaterials()) {
+        key.put(material.meshIndex);
+        key.put(material.primitiveIndex);
+        key.put(material.indexStart);
+        key.put(material.indexCount);
+        key.put(material.vertexOffset);
+        key.put(material.props.getFeatureMask());
+        key.put(static_cast<uint8_t>(material.props.isTransparent));
+    }
+
+    const std::vector<char>& bytes = key.getData();
+    return hashBytes(reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size(), 0);
+}
+
+std::string SceneCache::cachePathFor(const std::string& sourcePath, uint64_t sourceHash, uint64_t sidecarHash) {
+    const auto*    sidecar = reinterpret_cast<const unsigned char*>(&sidecarHash);
+    const uint64_t key     = hashBytes(sidecar, sizeof(sidecarHash), sourceHash);
+
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(key));
+    std::string name = std::filesystem::path(sourcePath).stem().string() + "-" + hash + CACHE_EXTENSION;
+    return (std::filesystem::path(CACHE_DIRECTORY) / name).string();
+}
+
+}  // namespace DownPour
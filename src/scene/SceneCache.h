@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "Scene.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace DownPour {
+
+class Model;
+
+/**
+ * @brief Snapshot of the scene graph built from a model, with its adapter's parsed sidecar
+ *
+ * Building a model's scene parses the `.json` sidecar, creates the nodes one
+ * at a time and resolves roles by name. A snapshot keeps the result instead:
+ * the nodes SceneBuilder created, as one array of fixed-size records in
+ * pre-order with parents stored as record indices, their names in one string
+ * table, the role -> node table and ModelAdapter's config blob. Files live in
+ * CACHE_DIRECTORY, named `<stem>-<hash>.dpscene` where the hash covers the
+ * model and sidecar bytes, so editing either rebuilds on the next launch.
+ *
+ * load() reads the file once, before the model itself loads, so the adapter
+ * can skip the sidecar. instantiate() appends every node with a single
+ * Scene::appendNodes() and fixes up parents, roles, the model pointer and
+ * material IDs. Records hold model material indices, not MaterialManager IDs:
+ * those are handed out as materials finish loading, so they are mapped through
+ * the caller's table each time. A fingerprint of the loaded model's ranges
+ * and bounds guards against geometry that changed without the source (external
+ * buffers, MeshOptimizer). A missing, stale or damaged snapshot is never an
+ * error: the caller builds the scene as usual and saves a new one.
+ */
+class SceneCache {
+public:
+    static constexpr const char* CACHE_DIRECTORY = "cache/scenes";
+    static constexpr uint32_t    VERSION         = 1;  // Bump when the layout, SceneNode or adapter configs change
+
+    typedef std::unordered_map<std::string, NodeHandle> RoleNodes;
+
+    /**
+     * @brief Read the current snapshot for a model source
+     * @return false if there is none, or it is stale or damaged; the cache is left empty
+     */
+    bool load(const std::string& sourcePath);
+
+    bool isLoaded() const { return loaded; }
+
+    /** @brief Adapter config blob the snapshot was saved with */
+    const std::vector<unsigned char>& getConfig() const { return config; }
+
+    /**
+     * @brief Append the snapshot's nodes to a scene
+     * @param model The model loaded from the snapshot's source; render data points at it
+     * @param materialIds Map from material index to MaterialManager ID
+     * @param outRoots Root handles, in the order SceneBuilder::buildFromModel() returns them
+     * @param outRoles Role name -> node
+     * @return false, with the scene untouched, if nothing is loaded or the model no longer matches
+     */
+    bool instantiate(Scene& scene, const Model& model, const std::unordered_map<size_t, uint32_t>& materialIds,
+                     std::vector<NodeHandle>& outRoots, RoleNodes& outRoles) const;
+
+    /**
+     * @brief Write the snapshot of a freshly built model scene
+     * @param roots Roots returned by SceneBuilder::buildFromModel(); their subtrees are stored
+     * @param roles Role name -> node; nodes outside those subtrees are left out
+     * @param config Adapter config blob, returned by getConfig() after the next load()
+     * @return false if the file could not be written; the next launch just builds again
+     */
+    static bool save(const std::string& sourcePath, const Scene& scene, const Model& model,
+                     const std::vector<NodeHandle>& roots, const std::unordered_map<size_t, uint32_t>& materialIds,
+                     const RoleNodes& roles, const std::vector<char>& config);
+
+    /** @brief Drop the loaded snapshot */
+    void clear();
+
+private:
+    static constexpr uint32_t NO_MATERIAL = 0xFFFFFFFF;  // Render data whose material had no ID when saved
+
+    /**
+     * @brief One SceneNode, stored verbatim as an array element
+     */
+    struct CachedNode {
+        uint32_t                           nameOffset;     // Into names
+        uint32_t                           nameLength;
+        uint32_t                           parent;         // Index of the parent record, or Scene::APPEND_ROOT
+        uint32_t                           materialIndex;  // Model material, or NO_MATERIAL
+        Vec3                               localPosition;
+        Quat                               localRotation;
+        Vec3                               localScale;
+        Vec3                               boundsMin;
+        Vec3                               boundsMax;
+        uint32_t                           meshIndex;
+        uint32_t                           primitiveIndex;
+        uint32_t                           materialFeatures;
+        uint32_t                           indexStart;
+        uint32_t                           indexCount;
+        int32_t                            vertexOffset;
+        uint32_t                           lodCount;
+        std::array<MeshLod, MAX_MESH_LODS> lods;
+        uint8_t                            isStatic;
+        uint8_t                            hasRenderData;
+        uint8_t                            isVisible;
+        uint8_t                            isTransparent;
+    };
+
+    std::string                                   cachePath;
+    uint64_t                                      modelKey = 0;  // modelFingerprint() when saved
+    std::vector<CachedNode>                       nodes;
+    std::string                                   names;
+    std::vector<std::pair<std::string, uint32_t>> roles;  // Role name, node record
+    std::vector<unsigned char>                    config;
+    bool                                          loaded = false;
+
+    static bool        hashInputs(const std::string& sourcePath, uint64_t& outSourceHash, uint64_t& outSidecarHash);
+    static uint64_t    modelFingerprint(const Model& model);
+    static std::string cachePathFor(const std::string& sourcePath, uint64_t sourceHash, uint64_t sidecarHash);
+};
+
+}  // namespace DownPour
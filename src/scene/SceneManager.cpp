@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: MIT
 #include "SceneManager.h"
 
+#include "CarAnimationSystem.h"
+
 namespace DownPour {
 
 SceneManager::SceneManager() : activeSceneName("") {}
@@ -96,9 +98,11 @@ void SceneManager::destroyEntity(const std::string& name) {
 }
 
 void SceneManager::update(float deltaTime) {
-    // Update active scene transforms
+    // Run component systems, then update the transforms they changed; last frame's become the previous ones
     Scene* activeScene = getActiveScene();
     if (activeScene) {
+        activeScene->capturePreviousTransforms();
+        CarAnimationSystem::update(*activeScene);
         activeScene->updateTransforms();
     }
 
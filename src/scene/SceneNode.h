@@ -1,8 +1,11 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "core/NameTable.h"
 #include "core/Types.h"
+#include "renderer/Mesh.h"
 
+#include <array>
 #include <optional>
 #include <string>
 #include <vector>
@@ -46,8 +49,9 @@ typedef std::vector<NodeHandle> NodeHandleList;
  */
 struct SceneNode {
     // Identification
-    str  name;
-    uint generation = 0;
+    str    name;
+    NameId nameId     = INVALID_NAME_ID;  // Interned `name`
+    uint   generation = 0;
 
     // Hierarchy (stored as flat indices, not pointers)
     NodeHandle     parent;
@@ -58,9 +62,10 @@ struct SceneNode {
     Quat localRotation = Quat(1.0f, 0.0f, 0.0f, 0.0f);  // Identity quaternion
     Vec3 localScale    = Vec3(1.0f);
 
-    // Cached world transform (updated during transform propagation)
-    Mat4 worldTransform = Mat4(1.0f);
-    bool isDirty        = true;  // Needs transform update
+    // Local TRS changed since the last Scene::updateTransforms(); the world
+    // transform itself lives in the Scene (Scene::getWorldTransform()), as does
+    // last frame's (Scene::getPreviousWorldTransform())
+    bool isDirty = true;
 
     // Rendering data (optional - not all nodes have meshes)
     struct RenderData {
@@ -68,17 +73,23 @@ struct SceneNode {
         uint         meshIndex;        // Which mesh in the glTF
         uint         primitiveIndex;   // Which primitive within the mesh
         uint         materialId;       // MaterialManager ID
-        bool         isVisible     = true;
-        bool         isTransparent = false;
+        uint32_t     materialFeatures = 0;  // MATERIAL_FEATURE_TEXTURES bits; picks the pipeline variant
+        bool         isVisible        = true;
+        bool         isTransparent    = false;
 
         // Index range for rendering this specific primitive
-        uint32_t indexStart = 0;
-        uint32_t indexCount = 0;
+        uint32_t indexStart   = 0;
+        uint32_t indexCount   = 0;
+        int32_t  vertexOffset = 0;
+
+        // Simplified levels of the same primitive, finest first; Scene::selectLods() picks one per frame
+        std::array<MeshLod, MAX_MESH_LODS> lods{};
+        uint32_t                           lodCount = 0;
     };
     typedef std::optional<RenderData> RenderDataOpt;
     RenderDataOpt                     renderData;
 
-    // Bounding volume (for frustum culling, future optimization)
+    // Local-space bounding volume (for frustum culling); empty bounds mean "never cull"
     Vec3 boundsMin = Vec3(0.0f);
     Vec3 boundsMax = Vec3(0.0f);
 
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: MIT
+#include "simulation/InputRecording.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace DownPour {
+namespace Simulation {
+
+namespace {
+
+constexpr char MAGIC[4] = {'D', 'P', 'I', 'R'};
+
+enum InputFlag : uint8_t {
+    ACCELERATE  = 1 << 0,
+    BRAKE       = 1 << 1,
+    STEER_LEFT  = 1 << 2,
+    STEER_RIGHT = 1 << 3,
+    RAINING     = 1 << 4,
+    WIPERS      = 1 << 5,
+};
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; i++)
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @brief Bounds-checked little-endian reader over a loaded file
+ */
+struct Reader {
+    const std::vector<uint8_t>& data;
+    const std::string&          path;
+    size_t                      offset = 0;
+
+    uint8_t byte() {
+        if (offset >= data.size())
+            throw std::runtime_error("Input recording is truncated: " + path);
+        return data[offset++];
+    }
+
+    uint32_t u32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(byte()) << (8 * i);
+        return value;
+    }
+
+    uint64_t u64() {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++)
+            value |= static_cast<uint64_t>(byte()) << (8 * i);
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        throw std::runtime_error("Input recording has a malformed run length: " + path);
+    }
+};
+
+}  // namespace
+
+uint8_t InputRecording::pack(const VehicleInput& input) {
+    uint8_t flags = 0;
+    if (input.accelerate)
+        flags |= ACCELERATE;
+    if (input.brake)
+        flags |= BRAKE;
+    if (input.steerLeft)
+        flags |= STEER_LEFT;
+    if (input.steerRight)
+        flags |= STEER_RIGHT;
+    if (input.raining)
+        flags |= RAINING;
+    if (input.wipers)
+        flags |= WIPERS;
+    return flags;
+}
+
+VehicleInput InputRecording::unpack(uint8_t flags) {
+    VehicleInput input;
+    input.accelerate = (flags & ACCELERATE) != 0;
+    input.brake      = (flags & BRAKE) != 0;
+    input.steerLeft  = (flags & STEER_LEFT) != 0;
+    input.steerRight = (flags & STEER_RIGHT) != 0;
+    input.raining    = (flags & RAINING) != 0;
+    input.wipers     = (flags & WIPERS) != 0;
+    return input;
+}
+
+void InputRecording::save(const std::string& path) const {
+    std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+    putU32(out, VERSION);
+
+    uint64_t rateBits;
+    std::memcpy(&rateBits, &rate, sizeof(rateBits));
+    putU64(out, rateBits);
+    putU32(out, seed);
+    putU64(out, steps.size());
+
+    for (size_t i = 0; i < steps.size();) {
+        size_t end = i + 1;
+        while (end < steps.size() && steps[end] == steps[i])
+            end++;
+        out.push_back(steps[i]);
+        putVarint(out, end - i);
+        i = end;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    if (!file)
+        throw std::runtime_error("Failed to write input recording: " + path);
+}
+
+InputRecording InputRecording::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open input recording: " + path);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader reader{data, path};
+    for (char c : MAGIC) {
+        if (reader.byte() != static_cast<uint8_t>(c))
+            throw std::runtime_error("Not an input recording: " + path);
+    }
+    if (reader.u32() != VERSION)
+        throw std::runtime_error("Unsupported input recording version: " + path);
+
+    uint64_t rateBits = reader.u64();
+    double   rate;
+    std::memcpy(&rate, &rateBits, sizeof(rate));
+    if (!(rate > 0.0))
+        throw std::runtime_error("Input recording has an invalid step rate: " + path);
+
+    InputRecording recording(rate, reader.u32());
+    const uint64_t stepCount = reader.u64();
+    while (recording.steps.size() < stepCount) {
+        uint8_t  flags  = reader.byte();
+        uint64_t length = reader.varint();
+        if (length == 0 || length > stepCount - recording.steps.size())
+            throw std::runtime_error("Input recording has a malformed run length: " + path);
+        recording.steps.insert(recording.steps.end(), static_cast<size_t>(length), flags);
+    }
+    return recording;
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
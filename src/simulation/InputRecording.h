@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "simulation/SimulationThread.h"
+#include "simulation/VehicleState.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DownPour {
+namespace Simulation {
+
+/**
+ * @brief The input of every fixed simulation step of one drive, for repeatable runs
+ *
+ * Steps are kept as one byte of VehicleInput flags each, together with the
+ * step rate and the WeatherSystem seed the drive ran with: stepping the same
+ * inputs at the same rate from the same seed reproduces the simulation
+ * exactly, whatever the frame rate. On disk consecutive identical steps are
+ * stored as one run (flags + varint length), so a held key costs a few bytes:
+ *   "DPIR" | u32 version | f64 rate | u32 seed | u64 steps | runs...
+ * All fields are little-endian. Not thread-safe.
+ */
+class InputRecording {
+public:
+    static constexpr uint32_t DEFAULT_SEED = 1;
+
+    explicit InputRecording(double rate = SimulationThread::DEFAULT_RATE, uint32_t seed = DEFAULT_SEED)
+        : rate(rate), seed(seed) {}
+
+    /**
+     * @brief Drop all steps; rate and seed are kept
+     */
+    void clear() { steps.clear(); }
+
+    /**
+     * @brief Record the input of the next step
+     */
+    void append(const VehicleInput& input) { steps.push_back(pack(input)); }
+
+    /**
+     * @brief Input of step @p index; past the end every control is released
+     */
+    VehicleInput at(uint64_t index) const { return index < steps.size() ? unpack(steps[index]) : VehicleInput(); }
+
+    size_t   size() const { return steps.size(); }
+    bool     empty() const { return steps.empty(); }
+    double   getRate() const { return rate; }
+    uint32_t getSeed() const { return seed; }
+
+    /**
+     * @brief Write the recording to @p path; throws std::runtime_error on failure
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Read a file written by save(); throws std::runtime_error if it is missing or malformed
+     */
+    static InputRecording load(const std::string& path);
+
+private:
+    static constexpr uint32_t VERSION = 1;
+
+    std::vector<uint8_t> steps;  // Packed flags, one per step
+    double               rate;   // Steps per second
+    uint32_t             seed;   // WeatherSystem::reseed() value at step 0
+
+    static uint8_t      pack(const VehicleInput& input);
+    static VehicleInput unpack(uint8_t flags);
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
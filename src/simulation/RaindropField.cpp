@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: MIT
+#include "simulation/RaindropField.h"
+
+#include "core/JobSystem.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DOWNPOUR_RAIN_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DOWNPOUR_RAIN_NEON 1
+#endif
+
+namespace DownPour {
+namespace Simulation {
+
+namespace {
+
+constexpr size_t PARALLEL_GRAIN = 8192;  // Below this many drops per job, scheduling costs more than it saves
+
+// Stateless PCG hash so respawns are deterministic and safe to run from any worker
+uint32_t pcgHash(uint32_t v) {
+    uint32_t state = v * 747796405u + 2891336453u;
+    uint32_t word  = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random01(uint32_t& seed) {
+    seed = pcgHash(seed);
+    return static_cast<float>(seed) * (1.0f / 4294967296.0f);
+}
+
+}  // namespace
+
+RaindropField::RaindropField(size_t capacity, const RaindropSpawnVolume& volume)
+    : capacity(capacity), stride((capacity + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH), volume(volume) {
+    // Each component array starts on its own SIMD_ALIGNMENT boundary
+    constexpr size_t alignFloats = SIMD_ALIGNMENT / sizeof(float);
+    stride                       = (stride + alignFloats - 1) / alignFloats * alignFloats;
+
+    const size_t total = stride * 8;
+    storage.reset(static_cast<float*>(::operator new[](total * sizeof(float), std::align_val_t(SIMD_ALIGNMENT))));
+    std::fill(storage.get(), storage.get() + total, 0.0f);
+
+    positionX = storage.get();
+    positionY = positionX + stride;
+    positionZ = positionY + stride;
+    velocityX = positionZ + stride;
+    velocityY = velocityX + stride;
+    velocityZ = velocityY + stride;
+    lifetime  = velocityZ + stride;
+    dropSize  = lifetime + stride;
+}
+
+void RaindropField::spawn() {
+    if (capacity == 0)
+        return;
+
+    respawn(head, pcgHash(spawnSerial++) ^ 0x5bd1e995u);
+    head  = (head + 1) % capacity;
+    count = std::min(count + 1, capacity);
+}
+
+void RaindropField::clear() {
+    count = 0;
+    head  = 0;
+}
+
+void RaindropField::reseed(uint32_t seed) {
+    clear();
+    spawnSerial = seed;
+    stepSerial  = seed * 0x9E3779B9u;  // Decorrelate the two sequences
+}
+
+RaindropView RaindropField::view() const {
+    RaindropView view;
+    view.positionX = positionX;
+    view.positionY = positionY;
+    view.positionZ = positionZ;
+    view.velocityX = velocityX;
+    view.velocityY = velocityY;
+    view.velocityZ = velocityZ;
+    view.lifetime  = lifetime;
+    view.dropSize  = dropSize;
+    view.count     = count;
+    return view;
+}
+
+void RaindropField::update(float deltaTime) {
+    if (count == 0)
+        return;
+
+    const uint32_t seed = pcgHash(stepSerial++);
+
+    // Kernels work on whole SIMD groups; lanes past `count` are padding and never respawned
+    const size_t simdCount = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+
+    if (simdCount < 2 * PARALLEL_GRAIN) {
+        updateRange(0, simdCount, deltaTime, seed);
+        return;
+    }
+
+    // PARALLEL_GRAIN is a multiple of SIMD_ALIGNMENT's floats, so jobs never share a cache line
+    static_assert(PARALLEL_GRAIN % (SIMD_ALIGNMENT / sizeof(float)) == 0, "Rain jobs must start on a cache line");
+    const uint32_t chunks = static_cast<uint32_t>((simdCount + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN);
+    JobSystem::get().parallelFor(chunks, 1, [&](uint32_t chunk) {
+        const size_t begin = chunk * PARALLEL_GRAIN;
+        updateRange(begin, std::min(begin + PARALLEL_GRAIN, simdCount), deltaTime, seed);
+    });
+}
+
+void RaindropField::respawn(size_t index, uint32_t seed) {
+    seed ^= static_cast<uint32_t>(index) * 0x9e3779b9u;
+
+    positionX[index] = (random01(seed) * 2.0f - 1.0f) * volume.radius;
+    positionY[index] = volume.height;
+    positionZ[index] = (random01(seed) * 2.0f - 1.0f) * volume.radius;
+    velocityX[index] = 0.0f;
+    velocityY[index] = -volume.fallSpeed;
+    velocityZ[index] = 0.0f;
+    lifetime[index]  = 0.0f;
+    dropSize[index]  = volume.minSize + random01(seed) * (volume.maxSize - volume.minSize);
+}
+
+void RaindropField::updateRange(size_t begin, size_t end, float deltaTime, uint32_t seed) {
+    const size_t live = count;
+
+    // Respawning is rare (a few drops per frame), so dead lanes are handled one by one
+    auto recycle = [&](size_t base, uint32_t deadLanes) {
+        for (size_t lane = 0; lane < SIMD_WIDTH; lane++) {
+            if ((deadLanes & (1u << lane)) && base + lane < live)
+                respawn(base + lane, seed);
+        }
+    };
+
+#if defined(DOWNPOUR_RAIN_SSE2)
+    const __m128 dt      = _mm_set1_ps(deltaTime);
+    const __m128 ground  = _mm_setzero_ps();
+    const __m128 maxLife = _mm_set1_ps(volume.maxLifetime);
+
+    for (size_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m128 px   = _mm_add_ps(_mm_load_ps(positionX + i), _mm_mul_ps(_mm_load_ps(velocityX + i), dt));
+        __m128 py   = _mm_add_ps(_mm_load_ps(positionY + i), _mm_mul_ps(_mm_load_ps(velocityY + i), dt));
+        __m128 pz   = _mm_add_ps(_mm_load_ps(positionZ + i), _mm_mul_ps(_mm_load_ps(velocityZ + i), dt));
+        __m128 life = _mm_add_ps(_mm_load_ps(lifetime + i), dt);
+
+        _mm_store_ps(positionX + i, px);
+        _mm_store_ps(positionY + i, py);
+        _mm_store_ps(positionZ + i, pz);
+        _mm_store_ps(lifetime + i, life);
+
+        // Dead: hit the ground or lived too long
+        int dead = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(py, ground), _mm_cmpgt_ps(life, maxLife)));
+        if (dead)
+            recycle(i, static_cast<uint32_t>(dead));
+    }
+#elif defined(DOWNPOUR_RAIN_NEON)
+    const float32x4_t dt      = vdupq_n_f32(deltaTime);
+    const float32x4_t ground  = vdupq_n_f32(0.0f);
+    const float32x4_t maxLife = vdupq_n_f32(volume.maxLifetime);
+
+    for (size_t i = begin; i < end; i += SIMD_WIDTH) {
+        float32x4_t px   = vmlaq_f32(vld1q_f32(positionX + i), vld1q_f32(velocityX + i), dt);
+        float32x4_t py   = vmlaq_f32(vld1q_f32(positionY + i), vld1q_f32(velocityY + i), dt);
+        float32x4_t pz   = vmlaq_f32(vld1q_f32(positionZ + i), vld1q_f32(velocityZ + i), dt);
+        float32x4_t life = vaddq_f32(vld1q_f32(lifetime + i), dt);
+
+        vst1q_f32(positionX + i, px);
+        vst1q_f32(positionY + i, py);
+        vst1q_f32(positionZ + i, pz);
+        vst1q_f32(lifetime + i, life);
+
+        uint32x4_t deadMask = vorrq_u32(vcltq_f32(py, ground), vcgtq_f32(life, maxLife));
+        uint32_t   lanes[SIMD_WIDTH];
+        vst1q_u32(lanes, deadMask);
+        uint32_t dead = (lanes[0] & 1u) | (lanes[1] & 2u) | (lanes[2] & 4u) | (lanes[3] & 8u);
+        if (dead)
+            recycle(i, dead);
+    }
+#else
+    for (size_t i = begin; i < end; i += SIMD_WIDTH) {
+        uint32_t dead = 0;
+        for (size_t lane = 0; lane < SIMD_WIDTH; lane++) {
+            size_t j = i + lane;
+            positionX[j] += velocityX[j] * deltaTime;
+            positionY[j] += velocityY[j] * deltaTime;
+            positionZ[j] += velocityZ[j] * deltaTime;
+            lifetime[j] += deltaTime;
+            if (positionY[j] < 0.0f || lifetime[j] > volume.maxLifetime)
+                dead |= 1u << lane;
+        }
+        if (dead)
+            recycle(i, dead);
+    }
+#endif
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
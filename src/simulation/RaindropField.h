@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace DownPour {
+namespace Simulation {
+
+/**
+ * @brief Read-only view over the live drops of a RaindropField
+ *
+ * Components are separate arrays; index i of each array belongs to the same
+ * drop. Every drop in [0, count) is alive. Valid until the next update().
+ */
+struct RaindropView {
+    const float* positionX = nullptr;
+    const float* positionY = nullptr;
+    const float* positionZ = nullptr;
+    const float* velocityX = nullptr;
+    const float* velocityY = nullptr;
+    const float* velocityZ = nullptr;
+    const float* lifetime  = nullptr;  // Time alive (s)
+    const float* dropSize  = nullptr;
+    size_t       count     = 0;
+
+    size_t size() const { return count; }
+    bool   empty() const { return count == 0; }
+
+    glm::vec3 position(size_t i) const { return glm::vec3(positionX[i], positionY[i], positionZ[i]); }
+    glm::vec3 velocity(size_t i) const { return glm::vec3(velocityX[i], velocityY[i], velocityZ[i]); }
+};
+
+/**
+ * @brief Spawn volume and limits for CPU raindrops
+ */
+struct RaindropSpawnVolume {
+    float radius      = 20.0f;  // Half-extent in X/Z around the origin
+    float height      = 30.0f;  // Spawn height
+    float minSize     = 0.1f;
+    float maxSize     = 0.2f;
+    float maxLifetime = 10.0f;
+    float fallSpeed   = 9.8f;
+};
+
+/**
+ * @brief Fixed-capacity structure-of-arrays raindrop simulation
+ *
+ * CPU fallback for the GPU rain path. Drops live in a ring of aligned float
+ * arrays; spawning writes at the ring head (overwriting the oldest drop once
+ * full) and drops that hit the ground or expire are respawned in place, so
+ * nothing is ever erased or reallocated. update() runs SSE2 or NEON kernels
+ * (scalar elsewhere) and splits large fields across cores.
+ */
+class RaindropField {
+public:
+    explicit RaindropField(size_t capacity, const RaindropSpawnVolume& volume = RaindropSpawnVolume());
+
+    /**
+     * @brief Spawn one drop at the ring head
+     */
+    void spawn();
+
+    /**
+     * @brief Advance every live drop, respawning dead ones in place
+     */
+    void update(float deltaTime);
+
+    /**
+     * @brief Remove all drops (capacity is kept)
+     */
+    void clear();
+
+    /**
+     * @brief Remove all drops and restart the spawn/respawn sequences from @p seed
+     */
+    void reseed(uint32_t seed);
+
+    RaindropView view() const;
+    size_t       getCapacity() const { return capacity; }
+
+    static constexpr size_t SIMD_WIDTH     = 4;
+    static constexpr size_t SIMD_ALIGNMENT = 64;  // Cache line; also covers 16-byte SSE/NEON loads
+
+private:
+    struct AlignedDeleter {
+        void operator()(float* p) const { ::operator delete[](p, std::align_val_t(SIMD_ALIGNMENT)); }
+    };
+
+    size_t              capacity;
+    size_t              stride;  // Capacity rounded up to SIMD_WIDTH, so kernels never need a scalar tail
+    size_t              count       = 0;
+    size_t              head        = 0;
+    uint32_t            spawnSerial = 0;  // Seeds spawn()
+    uint32_t            stepSerial  = 0;  // Seeds in-place respawns
+    RaindropSpawnVolume volume;
+
+    std::unique_ptr<float[], AlignedDeleter> storage;  // All components in one block
+    float*                                   positionX;
+    float*                                   positionY;
+    float*                                   positionZ;
+    float*                                   velocityX;
+    float*                                   velocityY;
+    float*                                   velocityZ;
+    float*                                   lifetime;
+    float*                                   dropSize;
+
+    void respawn(size_t index, uint32_t seed);
+    void updateRange(size_t begin, size_t end, float deltaTime, uint32_t seed);
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
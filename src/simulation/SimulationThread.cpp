@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MIT
+#include "simulation/SimulationThread.h"
+
+#include "core/Profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace DownPour {
+namespace Simulation {
+
+void SimulationThread::start(const SimulationSnapshot& initial, StepFunction step, double rate) {
+    stop();
+
+    stepFunction = std::move(step);
+    stepSeconds  = 1.0 / rate;
+    previous     = initial;
+    current      = initial;
+    publishedAt  = Clock::now();
+
+    running.store(true, std::memory_order_release);
+    worker = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable())
+        worker.join();
+}
+
+void SimulationThread::setInput(const VehicleInput& newInput) {
+    std::lock_guard<std::mutex> lock(inputLock);
+    input = newInput;
+}
+
+SimulationSnapshot SimulationThread::sample() const {
+    std::lock_guard<std::mutex> lock(snapshotLock);
+
+    std::chrono::duration<double> sincePublish = Clock::now() - publishedAt;
+    float alpha = static_cast<float>(std::clamp(sincePublish.count() / stepSeconds, 0.0, 1.0));
+
+    SimulationSnapshot blended = current;
+    blended.vehicle            = VehicleState::interpolate(previous.vehicle, current.vehicle, alpha);
+    return blended;
+}
+
+void SimulationThread::run() {
+    DP_PROFILE_THREAD_NAME("Simulation");
+    const auto stepDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(stepSeconds));
+    const float deltaTime   = static_cast<float>(stepSeconds);
+
+    // Only this thread writes `current`, so it can be read here without the snapshot lock
+    SimulationSnapshot state    = current;
+    Clock::time_point  nextStep = Clock::now() + stepDuration;
+
+    while (running.load(std::memory_order_acquire)) {
+        int steps = 0;
+        while (nextStep <= Clock::now() && steps < MAX_CATCH_UP_STEPS) {
+            VehicleInput stepInput;
+            {
+                std::lock_guard<std::mutex> lock(inputLock);
+                stepInput = input;
+            }
+
+            {
+                DP_PROFILE_SCOPE("SimulationThread::step");
+                std::lock_guard<std::mutex> lock(worldLock);
+                stepFunction(deltaTime, stepInput, state);
+            }
+            state.step++;
+
+            {
+                std::lock_guard<std::mutex> lock(snapshotLock);
+                previous    = current;
+                current     = state;
+                publishedAt = Clock::now();
+            }
+
+            nextStep += stepDuration;
+            steps++;
+        }
+
+        // Fell too far behind (debugger, swap storm): resume from now rather than spiralling
+        if (steps == MAX_CATCH_UP_STEPS && nextStep <= Clock::now())
+            nextStep = Clock::now() + stepDuration;
+
+        std::this_thread::sleep_until(nextStep);
+    }
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
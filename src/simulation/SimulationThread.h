@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "simulation/VehicleState.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace DownPour {
+namespace Simulation {
+
+/**
+ * @brief State published by the simulation after each fixed step
+ */
+struct SimulationSnapshot {
+    VehicleState vehicle;
+    uint64_t     step = 0;  // Number of steps taken so far
+};
+
+/**
+ * @brief Runs the simulation at a fixed rate on its own thread
+ *
+ * Each step receives the latest input and advances a private copy of the
+ * state, which is then published as the newest of two snapshots. The render
+ * thread samples between the two by wall-clock time, so it draws smooth
+ * motion one step behind the simulation and a slow frame never changes the
+ * step length. Systems the step updates in place (weather, windshield) are
+ * guarded by worldMutex(), which is held for the whole step.
+ */
+class SimulationThread {
+public:
+    /**
+     * @brief Advances @p state by @p deltaTime; runs on the simulation thread with worldMutex() held
+     */
+    using StepFunction = std::function<void(float deltaTime, const VehicleInput& input, SimulationSnapshot& state)>;
+
+    static constexpr double DEFAULT_RATE       = 120.0;  // Steps per second
+    static constexpr int    MAX_CATCH_UP_STEPS = 8;      // Beyond this the backlog is dropped instead of replayed
+
+    SimulationThread() = default;
+    ~SimulationThread() { stop(); }
+
+    SimulationThread(const SimulationThread&)            = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * @brief Start stepping from @p initial
+     * @param initial State both snapshots start from
+     * @param step Called once per fixed step
+     * @param rate Steps per second
+     */
+    void start(const SimulationSnapshot& initial, StepFunction step, double rate = DEFAULT_RATE);
+
+    /**
+     * @brief Stop the thread and wait for the current step to finish
+     */
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Replace the input seen by subsequent steps
+     */
+    void setInput(const VehicleInput& input);
+
+    /**
+     * @brief Newest state blended with the one before, by how far wall-clock time is into the current step
+     */
+    SimulationSnapshot sample() const;
+
+    /**
+     * @brief Lock to take before touching anything the step function updates
+     */
+    std::mutex& worldMutex() { return worldLock; }
+
+    float getStepSeconds() const { return static_cast<float>(stepSeconds); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    StepFunction      stepFunction;
+    double            stepSeconds = 1.0 / DEFAULT_RATE;
+    std::thread       worker;
+    std::atomic<bool> running{false};
+
+    mutable std::mutex snapshotLock;
+    SimulationSnapshot previous;
+    SimulationSnapshot current;
+    Clock::time_point  publishedAt;  // When `current` was published
+
+    mutable std::mutex inputLock;
+    VehicleInput       input;
+
+    std::mutex worldLock;
+
+    void run();
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
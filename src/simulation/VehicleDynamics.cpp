@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: MIT
+#include "simulation/VehicleDynamics.h"
+
+#include "core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DOWNPOUR_VEHICLE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DOWNPOUR_VEHICLE_NEON 1
+#endif
+
+namespace DownPour {
+namespace Simulation {
+
+namespace {
+
+constexpr uint32_t PARALLEL_GRAIN = 1024;  // Vehicles per job; below two of these the batch runs inline
+constexpr float    AIR_DENSITY    = 1.225f;  // kg/m^3
+constexpr float    GRAVITY        = 9.81f;   // m/s^2
+
+}  // namespace
+
+uint32_t VehicleBatch::add(const VehicleParams& vehicle, const glm::vec3& position, float headingDegrees) {
+    const uint32_t lane   = count++;
+    const size_t   padded = (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+
+    // New padding lanes sit at rest facing +X, so kernels can run them without producing NaNs
+    for (std::vector<float>* array : {&positionX, &positionY, &positionZ, &forwardZ, &speed, &wheelRotation, &command,
+                                      &coast, &curvature, &dragFactor, &rolling, &maxForward, &maxReverse,
+                                      &spinFactor}) {
+        array->resize(padded, 0.0f);
+    }
+    forwardX.resize(padded, 1.0f);
+    params.push_back(vehicle);
+
+    dragFactor[lane] = 0.5f * AIR_DENSITY * vehicle.dragCoefficient * vehicle.frontalArea / vehicle.mass;
+    rolling[lane]    = vehicle.rollingResistance * GRAVITY;
+    maxForward[lane] = vehicle.maxSpeed;
+    maxReverse[lane] = vehicle.maxSpeed * 0.5f;
+    spinFactor[lane] = 1.0f / vehicle.wheelRadius;
+
+    setState(lane, position, headingDegrees, 0.0f);
+    setControls(lane, VehicleControls());
+    return lane;
+}
+
+void VehicleBatch::clear() {
+    count = 0;
+    for (std::vector<float>* array : {&positionX, &positionY, &positionZ, &forwardX, &forwardZ, &speed, &wheelRotation,
+                                      &command, &coast, &curvature, &dragFactor, &rolling, &maxForward, &maxReverse,
+                                      &spinFactor}) {
+        array->clear();
+    }
+    params.clear();
+}
+
+void VehicleBatch::setControls(uint32_t lane, const VehicleControls& controls) {
+    const VehicleParams& vehicle  = params[lane];
+    const float          throttle = std::clamp(controls.throttle, 0.0f, 1.0f);
+    const float          brake    = std::clamp(controls.brake, 0.0f, 1.0f);
+    const float          steer    = std::clamp(controls.steer, -1.0f, 1.0f);
+
+    command[lane]   = throttle * vehicle.maxAcceleration - brake * vehicle.maxBraking;
+    coast[lane]     = (throttle == 0.0f && brake == 0.0f) ? vehicle.coastDeceleration : 0.0f;
+    curvature[lane] = std::tan(glm::radians(steer * vehicle.maxSteerAngle)) / vehicle.wheelBase;
+}
+
+void VehicleBatch::setState(uint32_t lane, const glm::vec3& position, float headingDegrees, float laneSpeed,
+                            float wheelSpin) {
+    const float heading = glm::radians(headingDegrees);
+    positionX[lane]     = position.x;
+    positionY[lane]     = position.y;
+    positionZ[lane]     = position.z;
+    forwardX[lane]      = std::cos(heading);
+    forwardZ[lane]      = -std::sin(heading);
+    speed[lane]         = laneSpeed;
+    wheelRotation[lane] = wheelSpin;
+}
+
+float VehicleBatch::getHeading(uint32_t lane) const {
+    return glm::degrees(std::atan2(-forwardZ[lane], forwardX[lane]));
+}
+
+void VehicleBatch::step(float deltaTime) {
+    if (count == 0)
+        return;
+
+    const uint32_t padded = static_cast<uint32_t>(positionX.size());
+    if (padded < 2 * PARALLEL_GRAIN) {
+        stepRange(0, padded, deltaTime);
+        return;
+    }
+
+    // PARALLEL_GRAIN is a multiple of SIMD_WIDTH, so every chunk starts on a whole SIMD group
+    const uint32_t chunks = (padded + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+    JobSystem::get().parallelFor(chunks, 1, [&](uint32_t chunk) {
+        const uint32_t begin = chunk * PARALLEL_GRAIN;
+        stepRange(begin, std::min(begin + PARALLEL_GRAIN, padded), deltaTime);
+    });
+}
+
+void VehicleBatch::stepRange(uint32_t begin, uint32_t end, float deltaTime) {
+    // Heading turns by angle = speed * curvature * dt per step, a few hundredths of a radian
+    // at most, where cos ~ 1 - a^2/2 and sin ~ a - a^3/6 are exact to float precision
+#if defined(DOWNPOUR_VEHICLE_SSE2)
+    const __m128 dt       = _mm_set1_ps(deltaTime);
+    const __m128 zero     = _mm_setzero_ps();
+    const __m128 one      = _mm_set1_ps(1.0f);
+    const __m128 half     = _mm_set1_ps(0.5f);
+    const __m128 sixth    = _mm_set1_ps(1.0f / 6.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(&speed[i]), _mm_mul_ps(_mm_loadu_ps(&command[i]), dt));
+
+        // Resistance shrinks |v| towards zero but never reverses it
+        __m128 resist = _mm_mul_ps(_mm_loadu_ps(&dragFactor[i]), _mm_mul_ps(v, v));
+        resist        = _mm_add_ps(resist, _mm_add_ps(_mm_loadu_ps(&rolling[i]), _mm_loadu_ps(&coast[i])));
+        __m128 sign   = _mm_and_ps(v, signMask);
+        __m128 mag    = _mm_max_ps(_mm_sub_ps(_mm_andnot_ps(signMask, v), _mm_mul_ps(resist, dt)), zero);
+        v             = _mm_or_ps(mag, sign);
+        v             = _mm_max_ps(v, _mm_xor_ps(_mm_loadu_ps(&maxReverse[i]), signMask));
+        v             = _mm_min_ps(v, _mm_loadu_ps(&maxForward[i]));
+
+        __m128 a  = _mm_mul_ps(_mm_mul_ps(v, _mm_loadu_ps(&curvature[i])), dt);
+        __m128 a2 = _mm_mul_ps(a, a);
+        __m128 c  = _mm_sub_ps(one, _mm_mul_ps(half, a2));
+        __m128 s  = _mm_mul_ps(a, _mm_sub_ps(one, _mm_mul_ps(sixth, a2)));
+
+        __m128 fx = _mm_loadu_ps(&forwardX[i]);
+        __m128 fz = _mm_loadu_ps(&forwardZ[i]);
+        __m128 nx = _mm_add_ps(_mm_mul_ps(fx, c), _mm_mul_ps(fz, s));
+        __m128 nz = _mm_sub_ps(_mm_mul_ps(fz, c), _mm_mul_ps(fx, s));
+
+        // Renormalize so rounding never accumulates into the speed
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(nz, nz))));
+        nx               = _mm_mul_ps(nx, invLength);
+        nz               = _mm_mul_ps(nz, invLength);
+
+        __m128 distance = _mm_mul_ps(v, dt);
+        _mm_storeu_ps(&positionX[i], _mm_add_ps(_mm_loadu_ps(&positionX[i]), _mm_mul_ps(nx, distance)));
+        _mm_storeu_ps(&positionZ[i], _mm_add_ps(_mm_loadu_ps(&positionZ[i]), _mm_mul_ps(nz, distance)));
+        _mm_storeu_ps(&wheelRotation[i],
+                      _mm_add_ps(_mm_loadu_ps(&wheelRotation[i]), _mm_mul_ps(distance, _mm_loadu_ps(&spinFactor[i]))));
+        _mm_storeu_ps(&forwardX[i], nx);
+        _mm_storeu_ps(&forwardZ[i], nz);
+        _mm_storeu_ps(&speed[i], v);
+    }
+#elif defined(DOWNPOUR_VEHICLE_NEON)
+    const float32x4_t dt    = vdupq_n_f32(deltaTime);
+    const float32x4_t zero  = vdupq_n_f32(0.0f);
+    const float32x4_t one   = vdupq_n_f32(1.0f);
+    const float32x4_t half  = vdupq_n_f32(0.5f);
+    const float32x4_t sixth = vdupq_n_f32(1.0f / 6.0f);
+
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        float32x4_t v = vmlaq_f32(vld1q_f32(&speed[i]), vld1q_f32(&command[i]), dt);
+
+        // Resistance shrinks |v| towards zero but never reverses it
+        float32x4_t resist = vmulq_f32(vld1q_f32(&dragFactor[i]), vmulq_f32(v, v));
+        resist             = vaddq_f32(resist, vaddq_f32(vld1q_f32(&rolling[i]), vld1q_f32(&coast[i])));
+        float32x4_t mag    = vmaxq_f32(vmlsq_f32(vabsq_f32(v), resist, dt), zero);
+        v                  = vbslq_f32(vcltq_f32(v, zero), vnegq_f32(mag), mag);
+        v                  = vmaxq_f32(v, vnegq_f32(vld1q_f32(&maxReverse[i])));
+        v                  = vminq_f32(v, vld1q_f32(&maxForward[i]));
+
+        float32x4_t a  = vmulq_f32(vmulq_f32(v, vld1q_f32(&curvature[i])), dt);
+        float32x4_t a2 = vmulq_f32(a, a);
+        float32x4_t c  = vmlsq_f32(one, half, a2);
+        float32x4_t s  = vmulq_f32(a, vmlsq_f32(one, sixth, a2));
+
+        float32x4_t fx = vld1q_f32(&forwardX[i]);
+        float32x4_t fz = vld1q_f32(&forwardZ[i]);
+        float32x4_t nx = vmlaq_f32(vmulq_f32(fx, c), fz, s);
+        float32x4_t nz = vmlsq_f32(vmulq_f32(fz, c), fx, s);
+
+        // Renormalize: reciprocal square root estimate plus two Newton steps
+        float32x4_t lengthSq  = vmlaq_f32(vmulq_f32(nx, nx), nz, nz);
+        float32x4_t invLength = vrsqrteq_f32(lengthSq);
+        invLength             = vmulq_f32(invLength, vrsqrtsq_f32(vmulq_f32(lengthSq, invLength), invLength));
+        invLength             = vmulq_f32(invLength, vrsqrtsq_f32(vmulq_f32(lengthSq, invLength), invLength));
+        nx                    = vmulq_f32(nx, invLength);
+        nz                    = vmulq_f32(nz, invLength);
+
+        float32x4_t distance = vmulq_f32(v, dt);
+        vst1q_f32(&positionX[i], vmlaq_f32(vld1q_f32(&positionX[i]), nx, distance));
+        vst1q_f32(&positionZ[i], vmlaq_f32(vld1q_f32(&positionZ[i]), nz, distance));
+        vst1q_f32(&wheelRotation[i], vmlaq_f32(vld1q_f32(&wheelRotation[i]), distance, vld1q_f32(&spinFactor[i])));
+        vst1q_f32(&forwardX[i], nx);
+        vst1q_f32(&forwardZ[i], nz);
+        vst1q_f32(&speed[i], v);
+    }
+#else
+    // Same operation order as the SSE2 kernel
+    constexpr float sixth = 1.0f / 6.0f;
+
+    for (uint32_t i = begin; i < end; i++) {
+        float v = speed[i] + command[i] * deltaTime;
+
+        // Resistance shrinks |v| towards zero but never reverses it
+        float resist = dragFactor[i] * (v * v) + (rolling[i] + coast[i]);
+        float mag    = std::max(std::fabs(v) - resist * deltaTime, 0.0f);
+        v            = std::clamp(std::copysign(mag, v), -maxReverse[i], maxForward[i]);
+
+        float a  = v * curvature[i] * deltaTime;
+        float a2 = a * a;
+        float c  = 1.0f - 0.5f * a2;
+        float s  = a * (1.0f - sixth * a2);
+        float nx = forwardX[i] * c + forwardZ[i] * s;
+        float nz = forwardZ[i] * c - forwardX[i] * s;
+
+        float invLength = 1.0f / std::sqrt(nx * nx + nz * nz);
+        nx *= invLength;
+        nz *= invLength;
+
+        float distance = v * deltaTime;
+        positionX[i] += nx * distance;
+        positionZ[i] += nz * distance;
+        wheelRotation[i] += distance * spinFactor[i];
+        forwardX[i] = nx;
+        forwardZ[i] = nz;
+        speed[i]    = v;
+    }
+#endif
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
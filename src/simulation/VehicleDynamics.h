@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DownPour {
+namespace Simulation {
+
+/**
+ * @brief Physical parameters of one vehicle (CarEntity::Config holds the player's)
+ */
+struct VehicleParams {
+    float wheelBase         = 2.85f;    // m
+    float wheelRadius       = 0.35f;    // m, for wheel spin
+    float maxSteerAngle     = 35.0f;    // Road wheel angle at full lock (degrees)
+    float maxAcceleration   = 5.0f;     // m/s^2 at full throttle
+    float maxBraking        = 8.0f;     // m/s^2 at full brake; keeps pushing into reverse once stopped
+    float coastDeceleration = 2.0f;     // m/s^2 engine braking with neither pedal pressed
+    float maxSpeed          = 15.0f;    // m/s forward; reverse is limited to half
+    float mass              = 1500.0f;  // kg
+    float dragCoefficient   = 0.3f;
+    float frontalArea       = 2.2f;     // m^2
+    float rollingResistance = 0.015f;
+};
+
+/**
+ * @brief Driver (or AI) commands for one vehicle
+ */
+struct VehicleControls {
+    float throttle = 0.0f;  // 0 - 1
+    float brake    = 0.0f;  // 0 - 1
+    float steer    = 0.0f;  // -1 (full right) to 1 (full left)
+};
+
+/**
+ * @brief Structure-of-arrays kinematic bicycle model for many vehicles at once
+ *
+ * Each vehicle (lane) moves on the XZ plane along its heading:
+ *   speed   += command - (drag * speed^2 + rolling + coast), never crossing zero by resistance alone
+ *   yaw rate = speed * tan(steer angle) / wheelBase
+ * Heading is kept as a unit direction and rotated by a small-angle series
+ * each step, so step() needs no trigonometry and runs as SSE2 or NEON
+ * kernels (scalar elsewhere); large batches are split across JobSystem
+ * workers. Controls are converted to accelerations and curvature when set.
+ * The kernels share one operation order, but results are only equal to
+ * within rounding: NEON and compilers that contract to FMA fuse some steps.
+ *
+ * Heading follows VehicleState::rotation: degrees around Y, forward =
+ * (cos, 0, -sin), so -90 drives along +Z. Not thread-safe.
+ */
+class VehicleBatch {
+public:
+    /**
+     * @brief Add a vehicle at rest
+     * @return Its lane, stable for the life of the batch
+     */
+    uint32_t add(const VehicleParams& params, const glm::vec3& position, float headingDegrees);
+
+    void     clear();
+    uint32_t size() const { return count; }
+
+    void setControls(uint32_t lane, const VehicleControls& controls);
+
+    /**
+     * @brief Overwrite a vehicle's state (spawn, restarts, or a state kept outside the batch)
+     */
+    void setState(uint32_t lane, const glm::vec3& position, float headingDegrees, float speed,
+                  float wheelSpin = 0.0f);
+
+    /**
+     * @brief Advance every vehicle by deltaTime with its current controls
+     */
+    void step(float deltaTime);
+
+    glm::vec3 getPosition(uint32_t lane) const { return glm::vec3(positionX[lane], positionY[lane], positionZ[lane]); }
+    float     getHeading(uint32_t lane) const;  // Degrees, in (-180, 180]
+    float     getSpeed(uint32_t lane) const { return speed[lane]; }
+    float     getWheelRotation(uint32_t lane) const { return wheelRotation[lane]; }  // Accumulated spin (radians)
+
+    static constexpr uint32_t SIMD_WIDTH = 4;
+
+private:
+    uint32_t count = 0;
+
+    // State; arrays are padded to a multiple of SIMD_WIDTH with lanes at rest
+    std::vector<float> positionX;
+    std::vector<float> positionY;  // Carried, not integrated
+    std::vector<float> positionZ;
+    std::vector<float> forwardX;  // Unit heading
+    std::vector<float> forwardZ;
+    std::vector<float> speed;  // m/s along forward
+    std::vector<float> wheelRotation;
+
+    // Controls, as set by setControls()
+    std::vector<float> command;    // Pedal acceleration (m/s^2)
+    std::vector<float> coast;      // Engine braking while no pedal is pressed (m/s^2)
+    std::vector<float> curvature;  // tan(steer angle) / wheelBase (1/m)
+
+    // Parameters, premultiplied
+    std::vector<float>         dragFactor;  // 0.5 * rho * Cd * A / m (1/m)
+    std::vector<float>         rolling;     // Crr * g (m/s^2)
+    std::vector<float>         maxForward;  // m/s
+    std::vector<float>         maxReverse;  // m/s, positive
+    std::vector<float>         spinFactor;  // 1 / wheelRadius
+    std::vector<VehicleParams> params;
+
+    void stepRange(uint32_t begin, uint32_t end, float deltaTime);
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: MIT
+#include "simulation/VehicleState.h"
+
+#include <cmath>
+
+namespace DownPour {
+namespace Simulation {
+
+void VehicleState::writeLane(const VehicleInput& input, float deltaTime, VehicleBatch& batch, uint32_t lane) {
+    // Steering wheel follows A/D and returns to centre when released
+    const float steeringSpeed = 180.0f;  // degrees per second
+    const float returnSpeed   = 360.0f;  // degrees per second
+
+    if (input.steerLeft && !input.steerRight) {
+        steeringWheelRotation += steeringSpeed * deltaTime;
+        steeringWheelRotation = glm::min(steeringWheelRotation, MAX_STEERING_WHEEL_ANGLE);
+    } else if (input.steerRight && !input.steerLeft) {
+        steeringWheelRotation -= steeringSpeed * deltaTime;
+        steeringWheelRotation = glm::max(steeringWheelRotation, -MAX_STEERING_WHEEL_ANGLE);
+    } else {
+        if (steeringWheelRotation > 0.0f) {
+            steeringWheelRotation -= returnSpeed * deltaTime;
+            if (steeringWheelRotation < 0.0f)
+                steeringWheelRotation = 0.0f;
+        } else if (steeringWheelRotation < 0.0f) {
+            steeringWheelRotation += returnSpeed * deltaTime;
+            if (steeringWheelRotation > 0.0f)
+                steeringWheelRotation = 0.0f;
+        }
+    }
+
+    // Road wheels turn in proportion to the steering wheel
+    VehicleControls controls;
+    controls.throttle = input.accelerate ? 1.0f : 0.0f;
+    controls.brake    = input.brake ? 1.0f : 0.0f;
+    controls.steer    = steeringWheelRotation / MAX_STEERING_WHEEL_ANGLE;
+
+    batch.setState(lane, position, rotation, velocity, wheelRotation);
+    batch.setControls(lane, controls);
+}
+
+void VehicleState::readLane(const VehicleBatch& batch, uint32_t lane) {
+    position      = batch.getPosition(lane);
+    velocity      = batch.getSpeed(lane);
+    wheelRotation = batch.getWheelRotation(lane);
+    rotation += std::remainder(batch.getHeading(lane) - rotation, 360.0f);
+}
+
+glm::vec3 VehicleState::forward() const {
+    const float heading = glm::radians(rotation);
+    return glm::vec3(std::cos(heading), 0.0f, -std::sin(heading));
+}
+
+VehicleState VehicleState::interpolate(const VehicleState& a, const VehicleState& b, float t) {
+    VehicleState result;
+    result.position              = glm::mix(a.position, b.position, t);
+    result.velocity              = glm::mix(a.velocity, b.velocity, t);
+    result.rotation              = glm::mix(a.rotation, b.rotation, t);
+    result.steeringWheelRotation = glm::mix(a.steeringWheelRotation, b.steeringWheelRotation, t);
+    result.wheelRotation         = glm::mix(a.wheelRotation, b.wheelRotation, t);
+    return result;
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
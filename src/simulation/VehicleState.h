@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "simulation/VehicleDynamics.h"
+
+#include <glm/glm.hpp>
+
+namespace DownPour {
+namespace Simulation {
+
+/**
+ * @brief Driver controls sampled on the main thread and consumed by the simulation
+ *
+ * Everything a step reacts to goes through here, so InputRecording can
+ * capture and replay a drive step for step.
+ */
+struct VehicleInput {
+    bool accelerate = false;
+    bool brake      = false;
+    bool steerLeft  = false;
+    bool steerRight = false;
+    bool raining    = false;  // Requested weather; the step switches WeatherSystem to match
+    bool wipers     = false;
+};
+
+/**
+ * @brief Simulated state of the player car
+ *
+ * Plain data so it can be copied into snapshots and interpolated; the scene
+ * graph is updated from it on the render thread. Motion comes from the
+ * player's lane of a VehicleBatch (see readLane()).
+ */
+struct VehicleState {
+    glm::vec3 position              = glm::vec3(0.0f, 2.0f, 2.0f);
+    float     velocity              = 0.0f;    // Forward speed (m/s)
+    float     rotation              = -90.0f;  // Heading around Y (degrees, unwrapped); forward = (cos, 0, -sin)
+    float     steeringWheelRotation = 0.0f;    // Degrees
+    float     wheelRotation         = 0.0f;    // Accumulated wheel spin (radians)
+
+    static constexpr float MAX_STEERING_WHEEL_ANGLE = 450.0f;  // Degrees (1.25 turns) at full lock
+
+    /**
+     * @brief Start a step: turn the steering wheel from the input and load this car into its batch lane
+     *
+     * Writes the whole state and the resulting controls, so the state stays
+     * authoritative and can be restored or replayed without touching the batch.
+     * Step the batch, then call readLane().
+     * @param input Controls held during the step
+     * @param deltaTime Step length in seconds
+     */
+    void writeLane(const VehicleInput& input, float deltaTime, VehicleBatch& batch, uint32_t lane);
+
+    /**
+     * @brief Finish a step: copy the lane back, keeping rotation continuous across +-180 degrees
+     */
+    void readLane(const VehicleBatch& batch, uint32_t lane);
+
+    /**
+     * @brief World-space direction of travel
+     */
+    glm::vec3 forward() const;
+
+    /**
+     * @brief Blend two states
+     * @param t 0 returns a, 1 returns b
+     */
+    static VehicleState interpolate(const VehicleState& a, const VehicleState& b, float t);
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
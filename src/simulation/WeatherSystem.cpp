@@ -1,9 +1,15 @@
 // SPDX-License-Identifier: MIT
 #include "simulation/WeatherSystem.h"
 
+#include "core/PipelineFactory.h"
+#include "core/Profiler.h"
+#include "core/ResourceManager.h"
+#include "core/SwapChainManager.h"
+
 #include <algorithm>
+#include <array>
 #include <iostream>
-#include <random>
+#include <stdexcept>
 
 namespace DownPour {
 namespace Simulation {
@@ -14,13 +20,25 @@ constexpr float RAINDROP_MAX_SIZE = 0.2f;
 constexpr float SPAWN_RADIUS      = 20.0f;
 constexpr float SPAWN_HEIGHT      = 30.0f;
 
-// Random number generator
-static std::random_device                    rd;
-static std::mt19937                          gen(rd());
-static std::uniform_real_distribution<float> distPos(-SPAWN_RADIUS, SPAWN_RADIUS);
-static std::uniform_real_distribution<float> distSize(RAINDROP_MIN_SIZE, RAINDROP_MAX_SIZE);
+// GPU rain
+constexpr float    MAX_COMPUTE_STEP    = 0.1f;  // Clamp long frames so drops don't tunnel through the volume
+constexpr uint32_t RAIN_WORKGROUP_SIZE = 256;   // local_size_x in rain_update.comp
+
+constexpr float RAINDROP_MAX_LIFE = 10.0f;
+constexpr float GRAVITY           = 9.8f;
+
+static RaindropSpawnVolume makeSpawnVolume() {
+    RaindropSpawnVolume volume;
+    volume.radius      = SPAWN_RADIUS;
+    volume.height      = SPAWN_HEIGHT;
+    volume.minSize     = RAINDROP_MIN_SIZE;
+    volume.maxSize     = RAINDROP_MAX_SIZE;
+    volume.maxLifetime = RAINDROP_MAX_LIFE;
+    volume.fallSpeed   = GRAVITY;
+    return volume;
+}
 
-WeatherSystem::WeatherSystem() : currentState(WeatherState::Sunny) {
+WeatherSystem::WeatherSystem() : currentState(WeatherState::Sunny), raindrops(MAX_RAINDROPS, makeSpawnVolume()) {
     std::cout << "Weather System initialized - Current state: Sunny" << std::endl;
 }
 
@@ -32,74 +50,276 @@ void WeatherSystem::toggleWeather() {
         currentState = WeatherState::Sunny;
         std::cout << "Weather changed to: SUNNY" << std::endl;
         raindrops.clear();
+        gpuBufferClear = true;  // Next shower starts from freshly spawned drops
     }
 }
 
-void WeatherSystem::spawnRaindrop() {
-    if (currentState != WeatherState::Rainy)
-        return;
-    if (raindrops.size() >= MAX_RAINDROPS)
+void WeatherSystem::update(float deltaTime) {
+    DP_PROFILE_SCOPE("WeatherSystem::update");
+
+    if (currentState != WeatherState::Rainy) {
+        raindrops.clear();
+        wetness = 0.0f;
         return;
+    }
+
+    wetness = std::min(wetness + deltaTime / WETTING_SECONDS, 1.0f);
+    pendingDelta += deltaTime;
 
-    Raindrop drop;
-    // Spawn in a volume around camera
-    drop.position = glm::vec3(distPos(gen),  // -20 to +20m
-                              SPAWN_HEIGHT,  // Start 30m up
-                              distPos(gen)   // -20 to +20m
-    );
-    drop.velocity = glm::vec3(0.0f, -9.8f, 0.0f);  // Gravity
-    drop.lifetime = 0.0f;
-    drop.size     = distSize(gen);
-    drop.active   = true;
-
-    raindrops.push_back(drop);
+    // Spawn new drops; once the ring is full they replace the oldest ones
+    spawnTimer += deltaTime;
+    while (spawnTimer > spawnRate) {
+        raindrops.spawn();
+        spawnTimer -= spawnRate;
+    }
+
+    // Dead drops are recycled in place, so there is nothing to compact afterwards
+    raindrops.update(deltaTime);
+}
+
+void WeatherSystem::reseed(uint32_t seed) {
+    raindrops.reseed(seed);
+    frameSeed      = seed;
+    spawnTimer     = 0.0f;
+    pendingDelta   = 0.0f;
+    gpuBufferClear = true;
 }
 
-void WeatherSystem::updateRaindrops(float deltaTime) {
-    for (auto& drop : raindrops) {
-        if (!drop.active)
-            continue;
+void WeatherSystem::setRainIntensity(float intensity) {
+    rainIntensity = std::clamp(intensity, 0.0f, 1.0f);
+    gpuDropCount  = static_cast<uint32_t>(rainIntensity * MAX_GPU_RAINDROPS);
+}
+
+void WeatherSystem::initGPU(VkDevice device, VkPhysicalDevice physicalDevice, VkRenderPass renderPass,
+                            VkDescriptorSetLayout cameraLayout, VkPipelineCache pipelineCache,
+                            const std::vector<VkImageView>& occlusionViews, VkSampler occlusionSampler,
+                            const std::vector<uint32_t>& queueFamilies) {
+    const VkDeviceSize bufferSize = sizeof(GPURaindrop) * MAX_GPU_RAINDROPS;
+    const uint32_t     slotCount  = static_cast<uint32_t>(occlusionViews.size());
+
+    // Only the compute step touches the state, on whichever queue it runs
+    ResourceManager::createBuffer(device, physicalDevice, bufferSize,
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, stateBuffer, stateBufferMemory);
+    dropSlots.resize(slotCount);
+    for (DropSlot& dropSlot : dropSlots) {
+        ResourceManager::createBuffer(device, physicalDevice, bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, dropSlot.buffer, dropSlot.memory,
+                                      MemoryTag::General, queueFamilies);
+    }
+
+    // The state for the compute step, the occlusion map for both stages, and the drops it writes and the draw reads
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    bindings[0].binding         = 0;
+    bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding         = 1;
+    bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    bindings[2].binding         = 2;
+    bindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[2].descriptorCount = 1;
+    bindings[2].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &dropSetLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create rain descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 2 * slotCount;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = slotCount;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = slotCount;
 
-        // Physics
-        drop.position += drop.velocity * deltaTime;
-        drop.lifetime += deltaTime;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &dropPool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create rain descriptor pool");
 
-        // Deactivate if hit ground or lived too long
-        if (drop.position.y < 0.0f || drop.lifetime > 10.0f) {
-            drop.active = false;
-        }
+    VkDescriptorBufferInfo stateInfo{};
+    stateInfo.buffer = stateBuffer;
+    stateInfo.offset = 0;
+    stateInfo.range  = VK_WHOLE_SIZE;
+
+    for (uint32_t slot = 0; slot < slotCount; slot++) {
+        DropSlot& dropSlot = dropSlots[slot];
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool     = dropPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts        = &dropSetLayout;
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &dropSlot.set) != VK_SUCCESS)
+            throw std::runtime_error("Failed to allocate rain descriptor set");
+
+        VkDescriptorImageInfo occlusionInfo{};
+        occlusionInfo.sampler     = occlusionSampler;
+        occlusionInfo.imageView   = occlusionViews[slot];
+        occlusionInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkDescriptorBufferInfo dropsInfo{};
+        dropsInfo.buffer = dropSlot.buffer;
+        dropsInfo.offset = 0;
+        dropsInfo.range  = VK_WHOLE_SIZE;
+
+        std::array<VkWriteDescriptorSet, 3> writes{};
+        writes[0].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[0].dstSet          = dropSlot.set;
+        writes[0].dstBinding      = 0;
+        writes[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[0].descriptorCount = 1;
+        writes[0].pBufferInfo     = &stateInfo;
+        writes[1].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[1].dstSet          = dropSlot.set;
+        writes[1].dstBinding      = 1;
+        writes[1].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        writes[1].descriptorCount = 1;
+        writes[1].pImageInfo      = &occlusionInfo;
+        writes[2].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[2].dstSet          = dropSlot.set;
+        writes[2].dstBinding      = 2;
+        writes[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[2].descriptorCount = 1;
+        writes[2].pBufferInfo     = &dropsInfo;
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
     }
+
+    // Compute: rain set + simulation parameters
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset     = 0;
+    pushRange.size       = sizeof(RainComputeParams);
+
+    computeLayout   = PipelineFactory::createPipelineLayout(device, {dropSetLayout}, {pushRange});
+    computePipeline = PipelineFactory::createComputePipeline(device, "rain_update.comp.spv", computeLayout,
+                                                             pipelineCache);
+
+    // Render: camera UBO in set 0 (same layout as the main passes), rain set in set 1 + this frame's map placement
+    VkPushConstantRange renderPushRange{};
+    renderPushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    renderPushRange.offset     = 0;
+    renderPushRange.size       = sizeof(RainRenderParams);
+
+    renderLayout = PipelineFactory::createPipelineLayout(device, {cameraLayout, dropSetLayout}, {renderPushRange});
+
+    PipelineConfig config;
+    config.vertShader       = "rain_particles.vert.spv";
+    config.fragShader       = "rain_particles.frag.spv";
+    config.layout           = renderLayout;
+    config.cullMode         = VK_CULL_MODE_NONE;
+    config.oitAccumulation  = true;
+    config.enableDepthWrite = false;
+    config.useVertexInput   = false;
+    config.subpass          = SwapChainManager::SUBPASS_TRANSPARENT;
+
+    renderPipeline = PipelineFactory::createPipeline(device, config, renderPass, pipelineCache);
+
+    setRainIntensity(rainIntensity);
+    gpuBufferClear = true;
 }
 
-void WeatherSystem::cleanupInactiveDrops() {
-    raindrops.erase(
-        std::remove_if(raindrops.begin(), raindrops.end(), [](const Raindrop& drop) { return !drop.active; }),
-        raindrops.end());
+void WeatherSystem::cleanupGPU(VkDevice device) {
+    if (renderPipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, renderPipeline, nullptr);
+    if (renderLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, renderLayout, nullptr);
+    if (computePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, computePipeline, nullptr);
+    if (computeLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, computeLayout, nullptr);
+    if (dropPool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, dropPool, nullptr);  // Frees the slots' sets
+    if (dropSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, dropSetLayout, nullptr);
+    ResourceManager::destroyBuffer(device, stateBuffer, stateBufferMemory);
+    for (DropSlot& dropSlot : dropSlots)
+        ResourceManager::destroyBuffer(device, dropSlot.buffer, dropSlot.memory);
+    dropSlots.clear();
+
+    renderPipeline  = VK_NULL_HANDLE;
+    renderLayout    = VK_NULL_HANDLE;
+    computePipeline = VK_NULL_HANDLE;
+    computeLayout   = VK_NULL_HANDLE;
+    dropPool        = VK_NULL_HANDLE;
+    dropSetLayout   = VK_NULL_HANDLE;
 }
 
-void WeatherSystem::update(float deltaTime) {
-    if (currentState != WeatherState::Rainy) {
-        raindrops.clear();
+void WeatherSystem::recordCompute(VkCommandBuffer cmd, uint32_t slot, const glm::vec3& cameraPosition,
+                                  const glm::vec4& occlusionArea, float occlusionDepthRange) {
+    if (!isRaining() || computePipeline == VK_NULL_HANDLE || gpuDropCount == 0)
         return;
-    }
 
-    // Spawn new drops
-    spawnTimer += deltaTime;
-    while (spawnTimer > spawnRate) {
-        spawnRaindrop();
-        spawnTimer -= spawnRate;
+    // The render graph orders the dispatch after the previous step and the draw that last read the slot
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer              = stateBuffer;
+    barrier.offset              = 0;
+    barrier.size                = VK_WHOLE_SIZE;
+
+    if (gpuBufferClear) {
+        // Zeroed slots are respawned through the whole column by the shader. The fill overwrites what the
+        // previous step wrote, which the graph only ordered against compute work
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                             1, &barrier, 0, nullptr);
+        vkCmdFillBuffer(cmd, stateBuffer, 0, VK_WHOLE_SIZE, 0);
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                             1, &barrier, 0, nullptr);
+        gpuBufferClear = false;
     }
 
-    updateRaindrops(deltaTime);
-    cleanupInactiveDrops();
+    RainComputeParams params{};
+    params.cameraPositionDelta = glm::vec4(cameraPosition, std::min(pendingDelta, MAX_COMPUTE_STEP));
+    params.wind                = glm::vec4(wind, 0.0f);
+    params.dropCount           = gpuDropCount;
+    params.frameSeed           = frameSeed++;
+    params.spawnRadius         = SPAWN_RADIUS;
+    params.spawnHeight         = SPAWN_HEIGHT;
+    params.occlusionArea       = occlusionArea;
+    params.occlusionDepthRange = occlusionDepthRange;
+    pendingDelta               = 0.0f;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeLayout, 0, 1, &dropSlots[slot].set, 0,
+                            nullptr);
+    vkCmdPushConstants(cmd, computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(cmd, (gpuDropCount + RAIN_WORKGROUP_SIZE - 1) / RAIN_WORKGROUP_SIZE, 1, 1);
 }
 
-void WeatherSystem::render(VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t frameIndex) {
-    // TODO: Implement rain particle rendering
-    // This will be implemented when we have the rain particle pipeline
-    (void)cmd;
-    (void)layout;
-    (void)frameIndex;
+void WeatherSystem::render(VkCommandBuffer cmd, uint32_t slot, VkDescriptorSet cameraSet,
+                           uint32_t dynamicOffsetCount, const uint32_t* dynamicOffsets,
+                           const glm::vec4& occlusionArea, float occlusionDepthRange) {
+    if (!isRaining() || renderPipeline == VK_NULL_HANDLE || gpuDropCount == 0)
+        return;
+
+    RainRenderParams params{};
+    params.occlusionArea       = occlusionArea;
+    params.occlusionDepthRange = occlusionDepthRange;
+
+    VkDescriptorSet sets[] = {cameraSet, dropSlots[slot].set};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, renderLayout, 0, 2, sets, dynamicOffsetCount,
+                            dynamicOffsets);
+    vkCmdPushConstants(cmd, renderLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(params), &params);
+
+    // Six vertices per drop, expanded to a streak in rain_particles.vert
+    vkCmdDraw(cmd, 6, gpuDropCount, 0, 0);
 }
 
 }  // namespace Simulation
@@ -1,8 +1,12 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "core/MemoryAllocator.h"
+#include "simulation/RaindropField.h"
+
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -10,22 +14,27 @@ namespace DownPour {
 namespace Simulation {
 
 /**
- * @brief Raindrop particle structure
+ * @brief GPU raindrop, matches RainDrop in rain_update.comp and rain_particles.vert
  */
-struct Raindrop {
-    glm::vec3 position;  // Current position
-    glm::vec3 velocity;  // Fall velocity
-    float     lifetime;  // Time alive
-    float     size;      // Droplet size
-    bool      active;    // Is this drop alive?
+struct GPURaindrop {
+    glm::vec4 positionLife;  // xyz = world position, w = remaining lifetime (s)
+    glm::vec4 velocitySize;  // xyz = velocity (m/s), w = streak width (m)
 };
 
 /**
  * @brief Weather system managing rain simulation and atmospheric conditions
  *
- * This class provides the foundation for weather state management and rain effects.
- * Current implementation supports toggling between Sunny and Rainy states.
- * Future enhancements will include rain particle systems and windshield effects.
+ * Supports toggling between Sunny and Rainy states. Visible rain is simulated
+ * on the GPU: a compute shader advances a fixed ring of drops around the camera
+ * and one instanced draw expands them into streaks. Drops stop at the first
+ * surface in a top-down occlusion depth map. The CPU RaindropField is the
+ * fallback simulation and feeds the windshield.
+ *
+ * The step keeps the simulation in one state buffer and copies the drops into
+ * the frame slot's drop buffer, which only that frame draws, so it can run on
+ * the async compute queue while earlier frames still draw theirs. It recycles
+ * drops against the slot's occlusion map, drawn framesInFlight frames earlier;
+ * the draw hides the few that have since fallen below the current map.
  */
 class WeatherSystem {
 public:
@@ -63,6 +72,14 @@ public:
      */
     bool isRaining() const { return currentState == WeatherState::Rainy; }
 
+    /**
+     * @brief How wet the road is: 0 (dry) to 1 (soaked)
+     *
+     * Builds up over WETTING_SECONDS of rain; always 0 when Sunny, so everything
+     * driven by it (the road's reflections) turns off with the rain.
+     */
+    float getWetness() const { return isRaining() ? wetness : 0.0f; }
+
     /**
      * @brief Update weather system state
      * @param deltaTime Time since last update in seconds
@@ -70,43 +87,140 @@ public:
     void update(float deltaTime);
 
     /**
-     * @brief Render rain particles
-     * @param cmd Command buffer for recording render commands
-     * @param layout Pipeline layout
-     * @param frameIndex Current frame index
+     * @brief Restart CPU and GPU rain from @p seed, so runs from the same seed see the same drops
+     *
+     * Clears all live drops. GPU drops advance once per recordCompute(), so
+     * they repeat only when frames and steps are paced the same (the benchmark).
+     */
+    void reseed(uint32_t seed);
+
+    /**
+     * @brief Create the GPU rain buffers and their compute/graphics pipelines
+     * @param cameraLayout Descriptor set layout whose binding 0 is the camera UBO
+     * @param occlusionViews, occlusionSampler Each frame slot's top-down depth map, which the compute step
+     *        kills drops against and the draw hides them behind (shader-read-only whenever either runs)
+     * @param queueFamilies Families using the drop buffers concurrently (VulkanContext::getComputeSharingFamilies())
+     */
+    void initGPU(VkDevice device, VkPhysicalDevice physicalDevice, VkRenderPass renderPass,
+                 VkDescriptorSetLayout cameraLayout, VkPipelineCache pipelineCache,
+                 const std::vector<VkImageView>& occlusionViews, VkSampler occlusionSampler,
+                 const std::vector<uint32_t>& queueFamilies);
+
+    /**
+     * @brief Destroy GPU rain resources
+     */
+    void cleanupGPU(VkDevice device);
+
+    /**
+     * @brief Record the compute step; must be outside a render pass, on the graphics or a compute queue
+     *
+     * The caller orders it against the draws that read getDropBuffer() and the passes that write the
+     * occlusion maps (the render graph).
+     * @param cmd Command buffer
+     * @param slot Frame slot whose drop buffer is written and whose occlusion map is read
+     * @param cameraPosition World-space camera position drops respawn around
+     * @param occlusionArea Placement of @p slot's map: xy = min corner (world xz), z = size (0: none), w = height
+     *        of depth 0
+     * @param occlusionDepthRange Metres from the map's depth 0 to depth 1
+     */
+    void recordCompute(VkCommandBuffer cmd, uint32_t slot, const glm::vec3& cameraPosition,
+                       const glm::vec4& occlusionArea, float occlusionDepthRange);
+
+    /** @brief Storage buffer of frame slot @p slot's drops, written by recordCompute() and read by render() */
+    VkBuffer getDropBuffer(uint32_t slot) const { return dropSlots[slot].buffer; }
+
+    /** @brief Storage buffer the compute step advances in place; only recordCompute() touches it */
+    VkBuffer getStateBuffer() const { return stateBuffer; }
+
+    /**
+     * @brief Render rain particles (one instanced draw)
+     * @param cmd Command buffer inside the main render pass
+     * @param slot Frame slot whose drops are drawn
+     * @param cameraSet Descriptor set providing the camera UBO at binding 0
+     * @param dynamicOffsetCount, dynamicOffsets Dynamic offsets for @p cameraSet's bindings
+     * @param occlusionArea, occlusionDepthRange Placement of @p slot's map this frame, as for recordCompute()
      */
-    void render(VkCommandBuffer cmd, VkPipelineLayout layout, uint32_t frameIndex);
+    void render(VkCommandBuffer cmd, uint32_t slot, VkDescriptorSet cameraSet, uint32_t dynamicOffsetCount,
+                const uint32_t* dynamicOffsets, const glm::vec4& occlusionArea, float occlusionDepthRange);
+
+    /**
+     * @brief Fraction of MAX_GPU_RAINDROPS simulated while raining (0-1)
+     */
+    void setRainIntensity(float intensity);
+
+    void setWind(const glm::vec3& windVelocity) { wind = windVelocity; }
+
+    static constexpr uint32_t MAX_GPU_RAINDROPS = 256 * 1024;
 
     /**
      * @brief Get active raindrops
-     * @return Vector of active raindrops
+     * @return View over the live CPU drops (valid until the next update)
+     */
+    RaindropView getActiveDrops() const { return raindrops.view(); }
+
+    /**
+     * @brief Drops drawn by render() this frame (0 when not raining)
      */
-    const std::vector<Raindrop>& getActiveDrops() const { return raindrops; }
+    uint32_t getRenderedDropCount() const {
+        return isRaining() && renderPipeline != VK_NULL_HANDLE ? gpuDropCount : 0;
+    }
 
 private:
     WeatherState currentState;
 
-    // Rain particle system
-    std::vector<Raindrop>   raindrops;
-    static constexpr size_t MAX_RAINDROPS = 5000;
-    float                   spawnTimer    = 0.0f;
-    float                   spawnRate     = 0.01f;  // Seconds between spawns
+    static constexpr float WETTING_SECONDS = 20.0f;  // Rain until the road is soaked
+    float                  wetness         = 0.0f;
 
-    /**
-     * @brief Spawn a new raindrop
-     */
-    void spawnRaindrop();
+    // CPU rain particle system (fixed-capacity ring)
+    static constexpr size_t MAX_RAINDROPS = 5000;
+    RaindropField           raindrops;
+    float                   spawnTimer = 0.0f;
+    float                   spawnRate  = 0.01f;  // Seconds between spawns
 
     /**
-     * @brief Update all raindrops
-     * @param deltaTime Time since last update
+     * @brief Push constants for rain_update.comp
      */
-    void updateRaindrops(float deltaTime);
+    struct RainComputeParams {
+        glm::vec4 cameraPositionDelta;  // xyz = camera position, w = delta time
+        glm::vec4 wind;
+        uint32_t  dropCount;
+        uint32_t  frameSeed;
+        float     spawnRadius;
+        float     spawnHeight;
+        glm::vec4 occlusionArea;
+        float     occlusionDepthRange;
+    };
 
     /**
-     * @brief Remove inactive raindrops
+     * @brief Push constants for rain_particles.vert
      */
-    void cleanupInactiveDrops();
+    struct RainRenderParams {
+        glm::vec4 occlusionArea;
+        float     occlusionDepthRange;
+    };
+
+    struct DropSlot {
+        VkBuffer        buffer = VK_NULL_HANDLE;
+        Allocation      memory;
+        VkDescriptorSet set = VK_NULL_HANDLE;  // State, the slot's occlusion map and this buffer
+    };
+
+    // GPU rain
+    glm::vec3             wind            = glm::vec3(1.5f, 0.0f, 0.5f);
+    float                 rainIntensity   = 0.5f;
+    float                 pendingDelta    = 0.0f;  // Time accumulated since the last compute step
+    uint32_t              frameSeed       = 0;
+    uint32_t              gpuDropCount    = 0;
+    bool                  gpuBufferClear  = true;  // Zero the state buffer before the next step
+    VkBuffer              stateBuffer     = VK_NULL_HANDLE;
+    Allocation            stateBufferMemory;
+    std::vector<DropSlot> dropSlots;
+    VkDescriptorSetLayout dropSetLayout   = VK_NULL_HANDLE;
+    VkDescriptorPool      dropPool        = VK_NULL_HANDLE;
+    VkPipelineLayout      computeLayout   = VK_NULL_HANDLE;
+    VkPipeline            computePipeline = VK_NULL_HANDLE;
+    VkPipelineLayout      renderLayout    = VK_NULL_HANDLE;
+    VkPipeline            renderPipeline  = VK_NULL_HANDLE;
 };
 
 }  // namespace Simulation
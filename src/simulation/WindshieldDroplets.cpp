@@ -0,0 +1,383 @@
+// SPDX-License-Identifier: MIT
+#include "WindshieldDroplets.h"
+
+#include "WindshieldSurface.h"
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace DownPour {
+namespace Simulation {
+
+namespace {
+
+// Droplet behaviour; must match windshield_droplets.comp
+constexpr float SPAWN_RADIUS_SCALE = 0.3f;      // Droplet radius per impact splat radius
+constexpr float MIN_RADIUS         = 0.0005f;   // Smaller droplets have evaporated
+constexpr float SLIDE_RADIUS_MIN   = 0.004f;    // Range of the per-droplet radius where it starts to run
+constexpr float SLIDE_RADIUS_MAX   = 0.0065f;
+constexpr float EVAPORATION        = 0.00005f;  // Radius lost per second
+constexpr float STREAK_LOSS        = 0.01f;     // Radius left behind per UV travelled
+constexpr float DAMPING            = 4.0f;
+constexpr float MAX_SPEED          = 0.4f;  // UV/s
+
+// Wiper blade; must match windshield_update.comp
+constexpr float WIPER_PIVOT_U    = 0.5f;
+constexpr float WIPER_PIVOT_V    = 1.05f;
+constexpr float WIPER_MIN_RADIUS = 0.15f;
+constexpr float WIPER_MAX_RADIUS = 1.0f;
+constexpr float WIPER_HALF_WIDTH = 1.5f;
+
+constexpr uint32_t CELL_COUNT = WindshieldDroplets::GRID_SIZE * WindshieldDroplets::GRID_SIZE;
+
+// PCG hash, as pcgHash() in the shaders
+uint32_t pcgHash(uint32_t v) {
+    uint32_t state = v * 747796405u + 2891336453u;
+    uint32_t word  = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+uint32_t cellOf(glm::vec2 uv) {
+    int x = std::clamp(static_cast<int>(uv.x * WindshieldDroplets::GRID_SIZE), 0,
+                       static_cast<int>(WindshieldDroplets::GRID_SIZE) - 1);
+    int y = std::clamp(static_cast<int>(uv.y * WindshieldDroplets::GRID_SIZE), 0,
+                       static_cast<int>(WindshieldDroplets::GRID_SIZE) - 1);
+    return static_cast<uint32_t>(y) * WindshieldDroplets::GRID_SIZE + static_cast<uint32_t>(x);
+}
+
+bool wiped(glm::vec2 uv, float sweepMin, float sweepMax) {
+    if (sweepMin == sweepMax)
+        return false;
+    glm::vec2 arm    = uv - glm::vec2(WIPER_PIVOT_U, WIPER_PIVOT_V);
+    float     radius = glm::length(arm);
+    float     angle  = glm::degrees(std::atan2(arm.x, -arm.y));  // 0 = straight up, positive to the right
+    return radius > WIPER_MIN_RADIUS && radius < WIPER_MAX_RADIUS && angle >= sweepMin - WIPER_HALF_WIDTH &&
+           angle <= sweepMax + WIPER_HALF_WIDTH;
+}
+
+/**
+ * @brief Call fn(j) for every bucketed droplet in the 3x3 cells around @p uv
+ */
+template <typename Fn>
+void forEachNeighbour(const WindshieldDroplets::State& state, glm::vec2 uv, Fn&& fn) {
+    constexpr int grid = static_cast<int>(WindshieldDroplets::GRID_SIZE);
+    uint32_t      home = cellOf(uv);
+    int           cx   = static_cast<int>(home % WindshieldDroplets::GRID_SIZE);
+    int           cy   = static_cast<int>(home / WindshieldDroplets::GRID_SIZE);
+    for (int y = std::max(cy - 1, 0); y <= std::min(cy + 1, grid - 1); y++) {
+        for (int x = std::max(cx - 1, 0); x <= std::min(cx + 1, grid - 1); x++) {
+            uint32_t cell  = static_cast<uint32_t>(y * grid + x);
+            uint32_t count = std::min(state.cellCounts[cell], WindshieldDroplets::CELL_CAPACITY);
+            for (uint32_t k = 0; k < count; k++)
+                fn(state.cellEntries[cell * WindshieldDroplets::CELL_CAPACITY + k]);
+        }
+    }
+}
+
+}  // namespace
+
+bool WindshieldDroplets::selectGpuSimulation(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    return properties.deviceType != VK_PHYSICAL_DEVICE_TYPE_CPU;
+}
+
+void WindshieldDroplets::initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t framesInFlight,
+                                    VkPipelineCache pipelineCache, bool useGpu, VkBuffer impactBuffer,
+                                    VkDeviceSize impactRange) {
+    this->useGpu = useGpu;
+    spawnCursor  = 0;
+    bufferClear  = true;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 1);
+    stateStride            = (sizeof(State) + alignment - 1) / alignment * alignment;
+
+    if (useGpu) {
+        // One region, stepped in place on the GPU
+        ResourceManager::createBuffer(device, physicalDevice, sizeof(State),
+                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, stateBuffer, stateMemory,
+                                      MemoryTag::Windshield);
+        createComputeResources(device, impactBuffer, impactRange, pipelineCache);
+    } else {
+        // One region per frame in flight, written by the CPU step
+        ResourceManager::createBuffer(device, physicalDevice, stateStride * framesInFlight,
+                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      stateBuffer, stateMemory, MemoryTag::Windshield);
+        cpuState = std::make_unique<State>();
+        std::memset(cpuState.get(), 0, sizeof(State));
+    }
+}
+
+void WindshieldDroplets::cleanup(VkDevice device) {
+    if (computePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, computePipeline, nullptr);
+    if (computeLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, computeLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees set
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    ResourceManager::destroyBuffer(device, stateBuffer, stateMemory);
+
+    computePipeline = VK_NULL_HANDLE;
+    computeLayout   = VK_NULL_HANDLE;
+    pool            = VK_NULL_HANDLE;
+    set             = VK_NULL_HANDLE;
+    setLayout       = VK_NULL_HANDLE;
+    cpuState.reset();
+}
+
+void WindshieldDroplets::step(VkCommandBuffer cmd, uint32_t frameIndex, const WindshieldDropletStep& params,
+                              uint32_t impactOffset) {
+    if (stateBuffer == VK_NULL_HANDLE)
+        return;
+
+    if (useGpu) {
+        recordGpuStep(cmd, params, impactOffset);
+    } else {
+        runCpuStep(params);
+        // The frame's region is free because its previous frame's fence has been waited on
+        std::memcpy(static_cast<char*>(stateMemory.mapped) + stateStride * frameIndex, cpuState.get(),
+                    offsetof(State, mergeTargets));
+    }
+
+    spawnCursor = (spawnCursor + params.impactCount) % MAX_DROPLETS;
+    seed++;
+}
+
+void WindshieldDroplets::recordGpuStep(VkCommandBuffer cmd, const WindshieldDropletStep& params,
+                                       uint32_t impactOffset) {
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer              = stateBuffer;
+    barrier.offset              = 0;
+    barrier.size                = VK_WHOLE_SIZE;
+
+    if (bufferClear) {
+        // Zero radius marks every slot free
+        vkCmdFillBuffer(cmd, stateBuffer, 0, VK_WHOLE_SIZE, 0);
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                             1, &barrier, 0, nullptr);
+        bufferClear = false;
+    } else {
+        // The previous frame's surface step may still be rasterizing the droplets (write-after-read)
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                             nullptr, 0, nullptr, 0, nullptr);
+    }
+
+    DropletParams gpuParams{};
+    gpuParams.acceleration  = params.acceleration;
+    gpuParams.deltaTime     = params.deltaTime;
+    gpuParams.wiperSweepMin = params.wiperSweepMin;
+    gpuParams.wiperSweepMax = params.wiperSweepMax;
+    gpuParams.spawnBase     = spawnCursor;
+    gpuParams.spawnCount    = params.impactCount;
+    gpuParams.seed          = seed;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeLayout, 0, 1, &set, 1, &impactOffset);
+
+    // Each stage reads what the previous one wrote
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    const std::array<uint32_t, 5> invocations = {CELL_COUNT, MAX_DROPLETS, MAX_DROPLETS, MAX_DROPLETS, MAX_DROPLETS};
+    for (uint32_t stage = STAGE_CLEAR_GRID; stage <= STAGE_REMOVE; stage++) {
+        gpuParams.stage = stage;
+        vkCmdPushConstants(cmd, computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(gpuParams), &gpuParams);
+        vkCmdDispatch(cmd, (invocations[stage] + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                             nullptr, 1, &barrier, 0, nullptr);
+    }
+}
+
+void WindshieldDroplets::runCpuStep(const WindshieldDropletStep& params) {
+    State& state = *cpuState;
+    float  dt    = params.deltaTime;
+
+    std::fill(std::begin(state.cellCounts), std::end(state.cellCounts), 0u);
+
+    // Spawn, move, evaporate and wipe, then bucket the survivors
+    for (uint32_t i = 0; i < MAX_DROPLETS; i++) {
+        WindshieldDroplet& droplet = state.droplets[i];
+        uint32_t           spawn   = (i + MAX_DROPLETS - spawnCursor) % MAX_DROPLETS;
+
+        if (spawn < params.impactCount) {
+            const WindshieldImpact& impact = params.impacts[spawn];
+            uint32_t                random = pcgHash(i ^ pcgHash(seed));
+
+            droplet.uv          = impact.uv;
+            droplet.velocity    = glm::vec2(0.0f);
+            droplet.radius      = std::clamp(impact.radius * SPAWN_RADIUS_SCALE, MIN_RADIUS, MAX_RADIUS);
+            droplet.slideRadius = SLIDE_RADIUS_MIN + (SLIDE_RADIUS_MAX - SLIDE_RADIUS_MIN) *
+                                                         static_cast<float>(random) * (1.0f / 4294967296.0f);
+        } else if (droplet.radius > 0.0f) {
+            droplet.radius -= EVAPORATION * dt;
+            if (droplet.radius > droplet.slideRadius) {
+                float drive = std::min((droplet.radius - droplet.slideRadius) / droplet.slideRadius, 1.0f);
+                droplet.velocity += params.acceleration * drive * dt;
+                droplet.velocity *= 1.0f / (1.0f + DAMPING * dt);
+                float speed = glm::length(droplet.velocity);
+                if (speed > MAX_SPEED) {
+                    droplet.velocity *= MAX_SPEED / speed;
+                    speed = MAX_SPEED;
+                }
+                droplet.uv += droplet.velocity * dt;
+                droplet.radius -= STREAK_LOSS * speed * dt;
+            } else {
+                droplet.velocity = glm::vec2(0.0f);
+            }
+        }
+
+        if (droplet.radius < MIN_RADIUS || droplet.uv.x < 0.0f || droplet.uv.x > 1.0f || droplet.uv.y < 0.0f ||
+            droplet.uv.y > 1.0f || wiped(droplet.uv, params.wiperSweepMin, params.wiperSweepMax)) {
+            droplet.radius = 0.0f;
+            continue;
+        }
+
+        uint32_t cell = cellOf(droplet.uv);
+        uint32_t slot = state.cellCounts[cell]++;
+        if (slot < CELL_CAPACITY)
+            state.cellEntries[cell * CELL_CAPACITY + slot] = i;
+    }
+
+    // Each droplet picks the largest overlapping droplet bigger than itself
+    for (uint32_t i = 0; i < MAX_DROPLETS; i++) {
+        const WindshieldDroplet& droplet = state.droplets[i];
+        uint32_t                 target   = i;
+        bool                     bucketed = false;  // Droplets that overflowed their cell cannot be gathered
+        if (droplet.radius > 0.0f) {
+            float best = droplet.radius;
+            forEachNeighbour(state, droplet.uv, [&](uint32_t j) {
+                const WindshieldDroplet& other = state.droplets[j];
+                float                    reach = droplet.radius + other.radius;
+                glm::vec2                d     = other.uv - droplet.uv;
+                bucketed                       = bucketed || j == i;
+                if (j == i || other.radius <= 0.0f || glm::dot(d, d) >= reach * reach)
+                    return;
+                if (other.radius > best || (other.radius == best && j < target)) {
+                    target = j;
+                    best   = other.radius;
+                }
+            });
+        }
+        state.mergeTargets[i] = bucketed ? target : i;
+    }
+
+    // Survivors absorb every droplet that picked them
+    for (uint32_t i = 0; i < MAX_DROPLETS; i++) {
+        WindshieldDroplet& droplet = state.droplets[i];
+        if (droplet.radius <= 0.0f || state.mergeTargets[i] != i)
+            continue;
+
+        float     area     = droplet.radius * droplet.radius;
+        glm::vec2 uv       = droplet.uv * area;
+        glm::vec2 momentum = droplet.velocity * area;
+        forEachNeighbour(state, droplet.uv, [&](uint32_t j) {
+            const WindshieldDroplet& other = state.droplets[j];
+            if (j == i || other.radius <= 0.0f || state.mergeTargets[j] != i)
+                return;
+            float otherArea = other.radius * other.radius;
+            area += otherArea;
+            uv += other.uv * otherArea;
+            momentum += other.velocity * otherArea;
+        });
+        droplet.uv       = uv / area;
+        droplet.velocity = momentum / area;
+        droplet.radius   = std::min(std::sqrt(area), MAX_RADIUS);
+    }
+
+    // Remove the absorbed droplets; ones whose target was itself merging wait for the next step
+    for (uint32_t i = 0; i < MAX_DROPLETS; i++) {
+        uint32_t target = state.mergeTargets[i];
+        if (target != i && state.mergeTargets[target] == target)
+            state.droplets[i].radius = 0.0f;
+    }
+}
+
+void WindshieldDroplets::createComputeResources(VkDevice device, VkBuffer impactBuffer, VkDeviceSize impactRange,
+                                                VkPipelineCache pipelineCache) {
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding         = 0;  // Droplets and grid
+    bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding         = 1;  // Impacts (one region per frame in flight)
+    bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create windshield droplet descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = 1;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create windshield droplet descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts        = &setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &set) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate windshield droplet descriptor set");
+
+    VkDescriptorBufferInfo stateInfo{stateBuffer, 0, sizeof(State)};
+    VkDescriptorBufferInfo impactInfo{impactBuffer, 0, impactRange};
+
+    std::array<VkWriteDescriptorSet, 2> writes{};
+    for (uint32_t b = 0; b < writes.size(); b++) {
+        writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[b].dstSet          = set;
+        writes[b].dstBinding      = b;
+        writes[b].descriptorType  = bindings[b].descriptorType;
+        writes[b].descriptorCount = 1;
+    }
+    writes[0].pBufferInfo = &stateInfo;
+    writes[1].pBufferInfo = &impactInfo;
+
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset     = 0;
+    pushRange.size       = sizeof(DropletParams);
+
+    computeLayout   = PipelineFactory::createPipelineLayout(device, {setLayout}, {pushRange});
+    computePipeline = PipelineFactory::createComputePipeline(device, "windshield_droplets.comp.spv", computeLayout,
+                                                             pipelineCache);
+}
+
+}  // namespace Simulation
+}  // namespace DownPour
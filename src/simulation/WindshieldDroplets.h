@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include "core/MemoryAllocator.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace DownPour {
+namespace Simulation {
+
+struct WindshieldImpact;
+
+/**
+ * @brief One bead of water on the glass, in windshield UV space
+ *
+ * Matches `Droplet` in windshield_droplets.comp and windshield_update.comp (std430).
+ */
+struct WindshieldDroplet {
+    glm::vec2 uv;
+    glm::vec2 velocity;     // UV/s; zero while pinned
+    float     radius;       // UV units; 0 marks a free slot
+    float     slideRadius;  // Pinned below this radius, runs down the glass above it
+};
+
+/**
+ * @brief Inputs to one droplet step, shared with the film step of WindshieldSurface
+ */
+struct WindshieldDropletStep {
+    glm::vec2               acceleration;  // Gravity plus airstream, UV/s^2
+    float                   deltaTime;
+    float                   wiperSweepMin;  // Degrees swept since the last step (min == max: no sweep)
+    float                   wiperSweepMax;
+    const WindshieldImpact* impacts     = nullptr;  // New droplets this step
+    uint32_t                impactCount = 0;
+};
+
+/**
+ * @brief Discrete droplets beading, merging and streaking on the windshield
+ *
+ * Every impact becomes a droplet in a fixed ring of MAX_DROPLETS slots (the
+ * oldest is overwritten once full). Each step pins small droplets, slides the
+ * ones above their slide radius down the glass (shedding water as they go),
+ * and merges overlapping ones. Overlap queries go through a uniform grid:
+ * droplets are bucketed into GRID_SIZE^2 cells of at least two maximum radii,
+ * so each droplet only tests the 3x3 cells around it and the whole step is
+ * O(n) instead of pairwise O(n^2).
+ *
+ * A droplet merges into its largest overlapping neighbour when that one is
+ * bigger (ties go to the lower index) and the neighbour is not itself merging
+ * this step; the survivor takes the combined area (up to MAX_RADIUS), and
+ * area-weighted position and velocity. Chains resolve over successive steps.
+ *
+ * The step runs in windshield_droplets.comp, or on the CPU with the same grid
+ * when the device is a software rasterizer. Either way the droplets and the
+ * grid end up in one storage buffer region, which windshield_update.comp
+ * rasterizes into the surface state's droplet height channel.
+ */
+class WindshieldDroplets {
+public:
+    static constexpr uint32_t MAX_DROPLETS  = 4096;
+    static constexpr uint32_t GRID_SIZE     = 64;  // Cells per side; must match both shaders
+    static constexpr uint32_t CELL_CAPACITY = 32;  // Per cell; later droplets skip this step's merges and drawing
+    static constexpr float    MAX_RADIUS    = 0.5f / GRID_SIZE;  // Keeps overlaps within the 3x3 cells
+
+    /**
+     * @brief Storage buffer layout; matches `DropletState` in both shaders
+     */
+    struct State {
+        WindshieldDroplet droplets[MAX_DROPLETS];
+        uint32_t          cellCounts[GRID_SIZE * GRID_SIZE];
+        uint32_t          cellEntries[GRID_SIZE * GRID_SIZE * CELL_CAPACITY];
+        uint32_t          mergeTargets[MAX_DROPLETS];  // GPU step only
+    };
+
+    WindshieldDroplets()  = default;
+    ~WindshieldDroplets() = default;
+
+    WindshieldDroplets(const WindshieldDroplets&)            = delete;
+    WindshieldDroplets& operator=(const WindshieldDroplets&) = delete;
+
+    /**
+     * @brief Whether to step droplets on the GPU (false for CPU-type devices, where compute is emulated)
+     */
+    static bool selectGpuSimulation(VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Create the state buffer and, for the GPU step, its compute pipeline
+     * @param framesInFlight Number of frames that may record concurrently (CPU step: one region each)
+     * @param useGpu Step on the GPU; otherwise the CPU steps and uploads each frame's region
+     * @param impactBuffer, impactRange Buffer of per-frame WindshieldImpact regions the GPU step spawns from
+     */
+    void initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t framesInFlight,
+                    VkPipelineCache pipelineCache, bool useGpu, VkBuffer impactBuffer, VkDeviceSize impactRange);
+
+    void cleanup(VkDevice device);
+
+    /**
+     * @brief Record (GPU) or run and upload (CPU) one step; must be outside a render pass
+     *
+     * Afterwards getStateBuffer() at getStateOffset(frameIndex) holds this
+     * step's droplets and grid, visible to compute shaders.
+     * @param impactOffset Offset of this frame's impacts in the impact buffer (GPU step)
+     */
+    void step(VkCommandBuffer cmd, uint32_t frameIndex, const WindshieldDropletStep& params,
+              uint32_t impactOffset);
+
+    VkBuffer     getStateBuffer() const { return stateBuffer; }
+    VkDeviceSize getStateSize() const { return sizeof(State); }
+    uint32_t     getStateOffset(uint32_t frameIndex) const {
+        return useGpu ? 0 : static_cast<uint32_t>(stateStride * frameIndex);
+    }
+
+    bool isGpuSimulation() const { return useGpu; }
+
+private:
+    struct DropletParams {
+        glm::vec2 acceleration;
+        float     deltaTime;
+        float     wiperSweepMin;
+        float     wiperSweepMax;
+        uint32_t  stage;
+        uint32_t  spawnBase;
+        uint32_t  spawnCount;
+        uint32_t  seed;
+    };
+
+    // Dispatches of one GPU step, in order; matches STAGE_* in windshield_droplets.comp
+    enum Stage : uint32_t { STAGE_CLEAR_GRID, STAGE_INTEGRATE, STAGE_FIND_TARGETS, STAGE_GATHER, STAGE_REMOVE };
+
+    static constexpr uint32_t WORKGROUP_SIZE = 256;  // Matches local_size_x in windshield_droplets.comp
+
+    bool         useGpu       = true;
+    uint32_t     spawnCursor  = 0;  // Ring slot the next impact spawns into
+    uint32_t     seed         = 0;
+    bool         bufferClear  = true;  // Zero the GPU state before the next step
+    VkBuffer     stateBuffer  = VK_NULL_HANDLE;
+    Allocation   stateMemory;
+    VkDeviceSize stateStride  = 0;
+
+    // GPU step
+    VkDescriptorSetLayout setLayout       = VK_NULL_HANDLE;
+    VkDescriptorPool      pool            = VK_NULL_HANDLE;
+    VkDescriptorSet       set             = VK_NULL_HANDLE;
+    VkPipelineLayout      computeLayout   = VK_NULL_HANDLE;
+    VkPipeline            computePipeline = VK_NULL_HANDLE;
+
+    // CPU step: the same state, uploaded (without merge targets) into the frame's region
+    std::unique_ptr<State> cpuState;  // Too large for the stack
+
+    void recordGpuStep(VkCommandBuffer cmd, const WindshieldDropletStep& params, uint32_t impactOffset);
+    void runCpuStep(const WindshieldDropletStep& params);
+    void createComputeResources(VkDevice device, VkBuffer impactBuffer, VkDeviceSize impactRange,
+                                VkPipelineCache pipelineCache);
+};
+
+}  // namespace Simulation
+}  // namespace DownPour
@@ -1,54 +1,90 @@
 // SPDX-License-Identifier: MIT
 #include "WindshieldSurface.h"
 
+#include "core/PipelineFactory.h"
+#include "core/ResourceManager.h"
+#include "logger/Logger.h"
+
+#include <algorithm>
+#include <cmath>
 #include <cstring>
-#include <iostream>
 #include <stdexcept>
 
 namespace DownPour {
 namespace Simulation {
 
-void WindshieldSurface::initialize(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                                   VkQueue graphicsQueue) {
-    std::cout << "Initializing windshield surface..." << std::endl;
+namespace {
+
+// Texel: r = wetness, gb = flow. RGBA16F is a required storage-image format, unlike R8/RG8.
+constexpr VkFormat STATE_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
 
-    createWetnessMap(device, physicalDevice, commandPool, graphicsQueue);
-    createFlowMap(device, physicalDevice, commandPool, graphicsQueue);
+constexpr float GRAVITY             = 0.6f;   // UV/s^2 down the glass
+constexpr float AIRFLOW_PER_SPEED   = 0.03f;  // UV/s^2 up the glass per m/s of vehicle speed
+constexpr float EVAPORATION_RATE    = 0.05f;  // Wetness per second
+constexpr float IMPACTS_PER_DROP    = 0.05f;  // Impacts per second per live drop, when parked
+constexpr float IMPACT_SPEED_SCALE  = 0.1f;   // Extra impact rate per m/s (driving into the rain)
+constexpr float IMPACT_TILE_SIZE    = 2.0f;   // Metres of rain field mapped onto the glass
+constexpr float IMPACT_RADIUS_SCALE = 0.05f;  // UV radius per metre of drop size
+constexpr float IMPACT_AMOUNT       = 0.6f;
 
-    std::cout << "Windshield surface initialized" << std::endl;
+}  // namespace
+
+uint32_t WindshieldSurface::selectResolution(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    return properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU ? MAX_RESOLUTION : DEFAULT_RESOLUTION;
 }
 
-void WindshieldSurface::cleanup(VkDevice device) {
-    if (wetnessMapView != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, wetnessMapView, nullptr);
-        wetnessMapView = VK_NULL_HANDLE;
-    }
-    if (wetnessMap != VK_NULL_HANDLE) {
-        vkDestroyImage(device, wetnessMap, nullptr);
-        wetnessMap = VK_NULL_HANDLE;
-    }
-    if (wetnessMapMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, wetnessMapMemory, nullptr);
-        wetnessMapMemory = VK_NULL_HANDLE;
-    }
+void WindshieldSurface::initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t framesInFlight,
+                                   VkPipelineCache pipelineCache, uint32_t resolution, bool gpuDroplets) {
+    DP_LOG(Info, "Initializing windshield surface...");
 
-    if (flowMapView != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, flowMapView, nullptr);
-        flowMapView = VK_NULL_HANDLE;
-    }
-    if (flowMap != VK_NULL_HANDLE) {
-        vkDestroyImage(device, flowMap, nullptr);
-        flowMap = VK_NULL_HANDLE;
+    this->resolution = std::clamp(resolution, 1u, MAX_RESOLUTION);
+    pendingImpacts.reserve(MAX_IMPACTS);
+
+    createStateImages(device, physicalDevice);
+    createComputeResources(device, physicalDevice, framesInFlight, pipelineCache, gpuDroplets);
+
+    DP_LOG(Info, "Windshield surface initialized (%ux%u, droplets on %s)", this->resolution, this->resolution,
+           droplets.isGpuSimulation() ? "GPU" : "CPU");
+}
+
+void WindshieldSurface::cleanup(VkDevice device) {
+    if (computePipeline != VK_NULL_HANDLE)
+        vkDestroyPipeline(device, computePipeline, nullptr);
+    if (computeLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(device, computeLayout, nullptr);
+    if (pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(device, pool, nullptr);  // Frees sets
+    if (setLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    ResourceManager::destroyBuffer(device, impactBuffer, impactMemory);
+    droplets.cleanup(device);
+
+    computePipeline = VK_NULL_HANDLE;
+    computeLayout   = VK_NULL_HANDLE;
+    pool            = VK_NULL_HANDLE;
+    setLayout       = VK_NULL_HANDLE;
+    sets            = {};
+
+    if (stateSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, stateSampler, nullptr);
+        stateSampler = VK_NULL_HANDLE;
     }
-    if (flowMapMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(device, flowMapMemory, nullptr);
-        flowMapMemory = VK_NULL_HANDLE;
+    for (size_t i = 0; i < stateImages.size(); i++) {
+        if (stateViews[i] != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, stateViews[i], nullptr);
+            stateViews[i] = VK_NULL_HANDLE;
+        }
+        ResourceManager::destroyImage(device, stateImages[i], stateMemory[i]);
     }
+    stateCleared = false;
 }
 
-void WindshieldSurface::update(float deltaTime, const std::vector<Raindrop>& raindrops) {
+void WindshieldSurface::update(float deltaTime, const RaindropView& raindrops) {
+    pendingDelta += deltaTime;
     updateWiper(deltaTime);
-    updateWetness(raindrops);
+    updateWetness(deltaTime, raindrops);
 }
 
 void WindshieldSurface::updateWiper(float deltaTime) {
@@ -69,155 +105,285 @@ void WindshieldSurface::updateWiper(float deltaTime) {
             wiperDirection = true;
         }
     }
-}
 
-void WindshieldSurface::updateWetness(const std::vector<Raindrop>& raindrops) {
-    // TODO: Update wetness map based on raindrop impacts
-    // This would involve CPU-side updates or compute shader updates
-    // For now, this is a placeholder
-    (void)raindrops;
+    // The blade may reverse within one step, so track the whole range it covered
+    sweepMinAngle = std::min(sweepMinAngle, wiperAngle);
+    sweepMaxAngle = std::max(sweepMaxAngle, wiperAngle);
 }
 
-void WindshieldSurface::createWetnessMap(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                                         VkQueue graphicsQueue) {
-    // Create a simple 256x256 R8 texture for wetness
-    const uint32_t width  = 256;
-    const uint32_t height = 256;
-
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width  = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth  = 1;
-    imageInfo.mipLevels     = 1;
-    imageInfo.arrayLayers   = 1;
-    imageInfo.format        = VK_FORMAT_R8_UNORM;
-    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateImage(device, &imageInfo, nullptr, &wetnessMap) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create wetness map image");
-    }
+void WindshieldSurface::updateWetness(float deltaTime, const RaindropView& raindrops) {
+    if (raindrops.empty())
+        return;
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, wetnessMap, &memRequirements);
+    // Impact rate follows the live drop count; driving into the rain catches more of it
+    float rate = static_cast<float>(raindrops.size()) * IMPACTS_PER_DROP *
+                 (1.0f + std::max(vehicleSpeed, 0.0f) * IMPACT_SPEED_SCALE);
+    impactBacklog += rate * deltaTime;
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex =
-        findMemoryType(physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // Sample drops round-robin so impacts inherit the field's spatial distribution and sizes
+    while (impactBacklog >= 1.0f && pendingImpacts.size() < MAX_IMPACTS) {
+        size_t i     = impactCursor++ % raindrops.size();
+        float  tileU = raindrops.positionX[i] / IMPACT_TILE_SIZE;
+        float  tileV = raindrops.positionZ[i] / IMPACT_TILE_SIZE;
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &wetnessMapMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate wetness map memory");
-    }
+        WindshieldImpact impact;
+        impact.uv     = glm::vec2(tileU - std::floor(tileU), tileV - std::floor(tileV));
+        impact.radius = raindrops.dropSize[i] * IMPACT_RADIUS_SCALE;
+        impact.amount = IMPACT_AMOUNT;
+        pendingImpacts.push_back(impact);
 
-    vkBindImageMemory(device, wetnessMap, wetnessMapMemory, 0);
-
-    // Create image view
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image                           = wetnessMap;
-    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format                          = VK_FORMAT_R8_UNORM;
-    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel   = 0;
-    viewInfo.subresourceRange.levelCount     = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount     = 1;
-
-    if (vkCreateImageView(device, &viewInfo, nullptr, &wetnessMapView) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create wetness map image view");
+        impactBacklog -= 1.0f;
     }
-
-    // TODO: Initialize with zero wetness (dry windshield)
-    // This requires transitioning the image layout from UNDEFINED to TRANSFER_DST_OPTIMAL,
-    // clearing the image, then transitioning to SHADER_READ_ONLY_OPTIMAL.
-    // Implementation deferred until build environment is available for testing.
-    (void)commandPool;
-    (void)graphicsQueue;
+    impactBacklog = std::min(impactBacklog, 1.0f);  // Drop what did not fit this frame
 }
 
-void WindshieldSurface::createFlowMap(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                                      VkQueue graphicsQueue) {
-    // Create a simple 256x256 RG8 texture for flow directions
-    const uint32_t width  = 256;
-    const uint32_t height = 256;
-
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType     = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width  = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth  = 1;
-    imageInfo.mipLevels     = 1;
-    imageInfo.arrayLayers   = 1;
-    imageInfo.format        = VK_FORMAT_R8G8_UNORM;
-    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
-    imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
-
-    if (vkCreateImage(device, &imageInfo, nullptr, &flowMap) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create flow map image");
+void WindshieldSurface::recordCompute(VkCommandBuffer cmd, uint32_t frameIndex) {
+    if (computePipeline == VK_NULL_HANDLE)
+        return;
+
+    uint32_t next = 1 - currentState;
+
+    if (!stateCleared) {
+        // First use: start both images dry. The render graph has already moved them to GENERAL
+        std::array<VkImageMemoryBarrier, 2> barriers{};
+        for (size_t i = 0; i < barriers.size(); i++) {
+            barriers[i].sType                       = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barriers[i].srcAccessMask               = 0;
+            barriers[i].dstAccessMask               = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barriers[i].oldLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+            barriers[i].newLayout                   = VK_IMAGE_LAYOUT_GENERAL;
+            barriers[i].srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+            barriers[i].dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+            barriers[i].image                       = stateImages[i];
+            barriers[i].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barriers[i].subresourceRange.levelCount = 1;
+            barriers[i].subresourceRange.layerCount = 1;
+        }
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr,
+                             0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+        VkClearColorValue       dry{};
+        VkImageSubresourceRange range = barriers[0].subresourceRange;
+        for (VkImage image : stateImages)
+            vkCmdClearColorImage(cmd, image, VK_IMAGE_LAYOUT_GENERAL, &dry, 1, &range);
+
+        for (VkImageMemoryBarrier& barrier : barriers) {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
+        }
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+                             0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+        stateCleared = true;
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(device, flowMap, &memRequirements);
+    // This frame's impacts; the region is free because its previous frame's fence has been waited on
+    VkDeviceSize impactOffset = impactStride * frameIndex;
+    if (!pendingImpacts.empty()) {
+        std::memcpy(static_cast<char*>(impactMemory.mapped) + impactOffset, pendingImpacts.data(),
+                    pendingImpacts.size() * sizeof(WindshieldImpact));
+    }
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType          = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex =
-        findMemoryType(physicalDevice, memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    WindshieldParams params{};
+    params.gravity       = glm::vec2(0.0f, GRAVITY);
+    params.airflow       = glm::vec2(0.0f, -std::max(vehicleSpeed, 0.0f) * AIRFLOW_PER_SPEED);
+    params.deltaTime     = std::min(pendingDelta, MAX_STEP);
+    params.evaporation   = EVAPORATION_RATE;
+    params.wiperSweepMin = sweepMinAngle;
+    params.wiperSweepMax = sweepMaxAngle;
+    params.impactCount   = static_cast<uint32_t>(pendingImpacts.size());
+    params.resolution    = resolution;
+
+    // Every impact also becomes a droplet; the step leaves them and their grid for the rasterization below
+    WindshieldDropletStep dropletStep{};
+    dropletStep.acceleration  = params.gravity + params.airflow;
+    dropletStep.deltaTime     = params.deltaTime;
+    dropletStep.wiperSweepMin = params.wiperSweepMin;
+    dropletStep.wiperSweepMax = params.wiperSweepMax;
+    dropletStep.impacts       = pendingImpacts.data();
+    dropletStep.impactCount   = params.impactCount;
+    droplets.step(cmd, frameIndex, dropletStep, static_cast<uint32_t>(impactOffset));
+
+    pendingDelta  = 0.0f;
+    sweepMinAngle = wiperAngle;
+    sweepMaxAngle = wiperAngle;
+    pendingImpacts.clear();
+
+    std::array<uint32_t, 2> dynamicOffsets = {static_cast<uint32_t>(impactOffset),
+                                              droplets.getStateOffset(frameIndex)};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, computeLayout, 0, 1, &sets[currentState],
+                            static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+    vkCmdPushConstants(cmd, computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+
+    uint32_t groups = (resolution + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    vkCmdDispatch(cmd, groups, groups, 1);
+
+    currentState = next;
+}
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &flowMapMemory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate flow map memory");
+void WindshieldSurface::createStateImages(VkDevice device, VkPhysicalDevice physicalDevice) {
+    for (size_t i = 0; i < stateImages.size(); i++) {
+        // Storage for the compute step, sampled for advection and by the windshield shader,
+        // transfer destination for the initial clear
+        ResourceManager::createImage(device, physicalDevice, resolution, resolution, STATE_FORMAT,
+                                     VK_IMAGE_TILING_OPTIMAL,
+                                     VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, stateImages[i], stateMemory[i],
+                                     MemoryTag::Windshield);
+
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image                           = stateImages[i];
+        viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format                          = STATE_FORMAT;
+        viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel   = 0;
+        viewInfo.subresourceRange.levelCount     = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount     = 1;
+
+        if (vkCreateImageView(device, &viewInfo, nullptr, &stateViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create windshield state image view");
+        }
     }
 
-    vkBindImageMemory(device, flowMap, flowMapMemory, 0);
-
-    // Create image view
-    VkImageViewCreateInfo viewInfo{};
-    viewInfo.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image                           = flowMap;
-    viewInfo.viewType                        = VK_IMAGE_VIEW_TYPE_2D;
-    viewInfo.format                          = VK_FORMAT_R8G8_UNORM;
-    viewInfo.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-    viewInfo.subresourceRange.baseMipLevel   = 0;
-    viewInfo.subresourceRange.levelCount     = 1;
-    viewInfo.subresourceRange.baseArrayLayer = 0;
-    viewInfo.subresourceRange.layerCount     = 1;
-
-    if (vkCreateImageView(device, &viewInfo, nullptr, &flowMapView) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create flow map image view");
+    // Clamp so water advected from outside the glass reads the edge, not the opposite side
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter               = VK_FILTER_LINEAR;
+    samplerInfo.minFilter               = VK_FILTER_LINEAR;
+    samplerInfo.addressModeU            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW            = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable        = VK_FALSE;
+    samplerInfo.maxAnisotropy           = 1.0f;
+    samplerInfo.borderColor             = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    samplerInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerInfo.compareEnable           = VK_FALSE;
+    samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
+    samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &stateSampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create windshield state sampler");
     }
-
-    // TODO: Initialize with downward flow (gravity)
-    // This requires transitioning the image layout from UNDEFINED to TRANSFER_DST_OPTIMAL,
-    // filling with flow data, then transitioning to SHADER_READ_ONLY_OPTIMAL.
-    // Implementation deferred until build environment is available for testing.
-    (void)commandPool;
-    (void)graphicsQueue;
 }
 
-uint32_t WindshieldSurface::findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter,
-                                           VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
+void WindshieldSurface::createComputeResources(VkDevice device, VkPhysicalDevice physicalDevice,
+                                               uint32_t framesInFlight, VkPipelineCache pipelineCache,
+                                               bool gpuDroplets) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    VkDeviceSize alignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 1);
+
+    impactStride = (sizeof(WindshieldImpact) * MAX_IMPACTS + alignment - 1) / alignment * alignment;
+    ResourceManager::createBuffer(device, physicalDevice, impactStride * framesInFlight,
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  impactBuffer, impactMemory, MemoryTag::Windshield);
+
+    droplets.initialize(device, physicalDevice, framesInFlight, pipelineCache, gpuDroplets, impactBuffer,
+                        sizeof(WindshieldImpact) * MAX_IMPACTS);
+
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    bindings[0].binding         = 0;  // Previous state (sampled, for bilinear advection)
+    bindings[0].descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding         = 1;  // Next state
+    bindings[1].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[2].binding         = 2;  // Impacts (one region per frame in flight)
+    bindings[2].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[2].descriptorCount = 1;
+    bindings[2].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[3].binding         = 3;  // Droplets and their grid (CPU step: one region per frame in flight)
+    bindings[3].descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    bindings[3].descriptorCount = 1;
+    bindings[3].stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings    = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create windshield descriptor set layout");
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = static_cast<uint32_t>(sets.size());
+    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = static_cast<uint32_t>(sets.size());
+    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[2].descriptorCount = static_cast<uint32_t>(sets.size()) * 2;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes    = poolSizes.data();
+    poolInfo.maxSets       = static_cast<uint32_t>(sets.size());
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create windshield descriptor pool");
+
+    std::array<VkDescriptorSetLayout, 2> layouts = {setLayout, setLayout};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool     = pool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts        = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+        throw std::runtime_error("Failed to allocate windshield descriptor sets");
+
+    VkDescriptorBufferInfo impactInfo{};
+    impactInfo.buffer = impactBuffer;
+    impactInfo.offset = 0;
+    impactInfo.range  = sizeof(WindshieldImpact) * MAX_IMPACTS;
+
+    VkDescriptorBufferInfo dropletInfo{};
+    dropletInfo.buffer = droplets.getStateBuffer();
+    dropletInfo.offset = 0;
+    dropletInfo.range  = droplets.getStateSize();
+
+    for (size_t i = 0; i < sets.size(); i++) {
+        VkDescriptorImageInfo readInfo{};
+        readInfo.sampler     = stateSampler;
+        readInfo.imageView   = stateViews[i];
+        readInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkDescriptorImageInfo writeInfo{};
+        writeInfo.imageView   = stateViews[1 - i];
+        writeInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        std::array<VkWriteDescriptorSet, 4> writes{};
+        for (uint32_t b = 0; b < writes.size(); b++) {
+            writes[b].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet          = sets[i];
+            writes[b].dstBinding      = b;
+            writes[b].descriptorType  = bindings[b].descriptorType;
+            writes[b].descriptorCount = 1;
         }
+        writes[0].pImageInfo  = &readInfo;
+        writes[1].pImageInfo  = &writeInfo;
+        writes[2].pBufferInfo = &impactInfo;
+        writes[3].pBufferInfo = &dropletInfo;
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
     }
 
-    throw std::runtime_error("Failed to find suitable memory type");
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset     = 0;
+    pushRange.size       = sizeof(WindshieldParams);
+
+    computeLayout   = PipelineFactory::createPipelineLayout(device, {setLayout}, {pushRange});
+    computePipeline = PipelineFactory::createComputePipeline(device, "windshield_update.comp.spv", computeLayout,
+                                                             pipelineCache);
 }
 
 }  // namespace Simulation
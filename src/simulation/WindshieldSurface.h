@@ -2,34 +2,68 @@
 #pragma once
 
 #include "WeatherSystem.h"
+#include "WindshieldDroplets.h"
+#include "core/MemoryAllocator.h"
 
+#include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <vector>
 
 namespace DownPour {
 namespace Simulation {
 
+/**
+ * @brief One raindrop hitting the glass, in windshield UV space
+ *
+ * Matches `Impact` in windshield_update.comp (std430).
+ */
+struct WindshieldImpact {
+    glm::vec2 uv;
+    float     radius;  // UV units
+    float     amount;  // Wetness added at the centre
+};
+
 /**
  * @brief Windshield surface managing water droplets and wiper effects
  *
- * This class simulates water accumulation on a car windshield and
- * handles wiper clearing animations. It manages wetness and flow maps
- * used by the windshield shader for realistic water effects.
+ * Water on the glass lives entirely on the GPU: a compute pass splats this
+ * frame's drop impacts, advects water along its own flow field under gravity
+ * and the airstream, evaporates it and clears whatever the wiper blade swept
+ * through. The state (r = wetness, gb = flow) ping-pongs between two storage
+ * images, so the CPU only uploads a small list of impacts each frame.
+ *
+ * Each impact also leaves a discrete droplet (WindshieldDroplets) that beads,
+ * merges and runs down the glass; the same pass draws them into the state's
+ * alpha channel as a height map the windshield shader takes normals from.
  */
 class WindshieldSurface {
 public:
     WindshieldSurface()  = default;
     ~WindshieldSurface() = default;
 
+    static constexpr uint32_t DEFAULT_RESOLUTION = 256;
+    static constexpr uint32_t MAX_RESOLUTION     = 1024;
+    static constexpr uint32_t MAX_IMPACTS        = 256;  // Per frame
+
+    /**
+     * @brief Pick a state resolution for the device (discrete GPUs get MAX_RESOLUTION)
+     */
+    static uint32_t selectResolution(VkPhysicalDevice physicalDevice);
+
     /**
      * @brief Initialize windshield resources
      * @param device Vulkan logical device
      * @param physicalDevice Vulkan physical device
-     * @param commandPool Command pool for operations
-     * @param graphicsQueue Graphics queue
+     * @param framesInFlight Number of frames that may record concurrently (one impact region each)
+     * @param pipelineCache Cache used to build the compute pipeline
+     * @param resolution Width and height of the state images, clamped to MAX_RESOLUTION
+     * @param gpuDroplets Step the droplets in a compute shader rather than on the CPU
      */
-    void initialize(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool, VkQueue graphicsQueue);
+    void initialize(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t framesInFlight,
+                    VkPipelineCache pipelineCache, uint32_t resolution = DEFAULT_RESOLUTION,
+                    bool gpuDroplets = true);
 
     /**
      * @brief Clean up Vulkan resources
@@ -42,7 +76,18 @@ public:
      * @param deltaTime Time since last update
      * @param raindrops Active rain particles
      */
-    void update(float deltaTime, const std::vector<Raindrop>& raindrops);
+    void update(float deltaTime, const RaindropView& raindrops);
+
+    /**
+     * @brief Record the surface simulation step; must be outside a render pass
+     *
+     * Uses compute and transfer stages only, so it may record for a compute queue. The caller orders it
+     * against other users of getStateImage() and getDropletBuffer(), and moves the state images to
+     * VK_IMAGE_LAYOUT_GENERAL before the first step (the render graph).
+     * @param cmd Primary command buffer
+     * @param frameIndex Frame-in-flight slot whose impact region is written
+     */
+    void recordCompute(VkCommandBuffer cmd, uint32_t frameIndex);
 
     /**
      * @brief Set wiper active state
@@ -50,6 +95,12 @@ public:
      */
     void setWiperActive(bool active) { wiperActive = active; }
 
+    /**
+     * @brief Set forward vehicle speed; faster driving means more impacts and water pushed up the glass
+     * @param speed Speed in m/s
+     */
+    void setVehicleSpeed(float speed) { vehicleSpeed = speed; }
+
     /**
      * @brief Get current wiper angle
      * @return Wiper angle in degrees (-45 to +45)
@@ -57,32 +108,71 @@ public:
     float getWiperAngle() const { return wiperAngle; }
 
     /**
-     * @brief Get wetness map image view
-     * @return Vulkan image view for wetness map
+     * @brief Get the current surface state view (r = wetness, gb = flow, a = droplet height)
+     *
+     * Changes every recordCompute(); fetch it after the compute step when
+     * writing descriptors. Kept in VK_IMAGE_LAYOUT_GENERAL.
      */
-    VkImageView getWetnessMapView() const { return wetnessMapView; }
+    VkImageView getSurfaceView() const { return stateViews[currentState]; }
 
-    /**
-     * @brief Get flow map image view
-     * @return Vulkan image view for flow map
-     */
-    VkImageView getFlowMapView() const { return flowMapView; }
+    uint32_t getResolution() const { return resolution; }
+
+    /** @brief One of the two state images the step ping-pongs between */
+    VkImage getStateImage(uint32_t index) const { return stateImages[index]; }
+
+    /** @brief Droplet storage buffer the step rasterizes into the state */
+    VkBuffer getDropletBuffer() const { return droplets.getStateBuffer(); }
 
 private:
+    struct WindshieldParams {
+        glm::vec2 gravity;
+        glm::vec2 airflow;
+        float     deltaTime;
+        float     evaporation;
+        float     wiperSweepMin;
+        float     wiperSweepMax;
+        uint32_t  impactCount;
+        uint32_t  resolution;
+    };
+
+    static constexpr uint32_t WORKGROUP_SIZE = 8;      // Matches local_size_x/y in windshield_update.comp
+    static constexpr float    MAX_STEP       = 0.05f;  // Longest step simulated in one dispatch (s)
+
     // Wiper state
     bool  wiperActive    = false;
     float wiperAngle     = 0.0f;   // -45 to +45 degrees
     float wiperSpeed     = 90.0f;  // Degrees per second
     bool  wiperDirection = true;   // true = right, false = left
-
-    // Texture maps for shader
-    VkImage        wetnessMap       = VK_NULL_HANDLE;
-    VkDeviceMemory wetnessMapMemory = VK_NULL_HANDLE;
-    VkImageView    wetnessMapView   = VK_NULL_HANDLE;
-
-    VkImage        flowMap       = VK_NULL_HANDLE;
-    VkDeviceMemory flowMapMemory = VK_NULL_HANDLE;
-    VkImageView    flowMapView   = VK_NULL_HANDLE;
+    float sweepMinAngle  = 0.0f;   // Range the blade covered since the last dispatch
+    float sweepMaxAngle  = 0.0f;
+
+    float                         vehicleSpeed   = 0.0f;
+    float                         pendingDelta   = 0.0f;  // Time accumulated since the last dispatch
+    float                         impactBacklog  = 0.0f;  // Fractional impacts carried between frames
+    size_t                        impactCursor   = 0;     // Next drop sampled for an impact
+    std::vector<WindshieldImpact> pendingImpacts;
+
+    // Ping-pong surface state
+    uint32_t                   resolution   = DEFAULT_RESOLUTION;
+    uint32_t                   currentState = 0;  // Index of the most recently written image
+    bool                       stateCleared = false;
+    std::array<VkImage, 2>     stateImages{};
+    std::array<Allocation, 2>  stateMemory{};
+    std::array<VkImageView, 2> stateViews{};
+    VkSampler                  stateSampler = VK_NULL_HANDLE;
+
+    WindshieldDroplets droplets;
+
+    // Per-frame impact regions in one host-visible buffer (dynamic offset)
+    VkBuffer     impactBuffer = VK_NULL_HANDLE;
+    Allocation   impactMemory;
+    VkDeviceSize impactStride = 0;
+
+    VkDescriptorSetLayout          setLayout       = VK_NULL_HANDLE;
+    VkDescriptorPool               pool            = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, 2> sets{};  // sets[i] reads state i, writes state 1 - i
+    VkPipelineLayout               computeLayout   = VK_NULL_HANDLE;
+    VkPipeline                     computePipeline = VK_NULL_HANDLE;
 
     /**
      * @brief Update wiper animation
@@ -91,27 +181,22 @@ private:
     void updateWiper(float deltaTime);
 
     /**
-     * @brief Update wetness based on rain
+     * @brief Turn this frame's share of raindrops into impacts on the glass
+     * @param deltaTime Time since last update
      * @param raindrops Active rain particles
      */
-    void updateWetness(const std::vector<Raindrop>& raindrops);
-
-    /**
-     * @brief Create wetness map texture
-     */
-    void createWetnessMap(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                          VkQueue graphicsQueue);
+    void updateWetness(float deltaTime, const RaindropView& raindrops);
 
     /**
-     * @brief Create flow map texture
+     * @brief Create the two state images, their views and the sampler
      */
-    void createFlowMap(VkDevice device, VkPhysicalDevice physicalDevice, VkCommandPool commandPool,
-                       VkQueue graphicsQueue);
+    void createStateImages(VkDevice device, VkPhysicalDevice physicalDevice);
 
     /**
-     * @brief Helper to find memory type
+     * @brief Create the impact buffer, the droplets, descriptor sets and compute pipeline
      */
-    uint32_t findMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+    void createComputeResources(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t framesInFlight,
+                                VkPipelineCache pipelineCache, bool gpuDroplets);
 };
 
 }  // namespace Simulation
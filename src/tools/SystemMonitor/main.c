@@ -1,9 +1,37 @@
 #include "monitor.h"
+#include "telemetry_reader.h"
 
 #include <stdio.h>
 #include <unistd.h>
 
+// Refresh interval while attached to a running DownPour
+#define TELEMETRY_REFRESH_US 500000
+
+static void print_live(TelemetryReader* reader, VulkanBackend backend) {
+    DpTelemetryFrame frame;
+    int              refreshes = 0;
+
+    printf("Attached to DownPour telemetry (pid %llu)\n\n", (unsigned long long)reader->region->header.processId);
+    while (telemetry_is_alive(reader)) {
+        if (telemetry_read_latest(reader, &frame)) {
+            printf("\033[2J\033[H");  // Clear and home: a live view rather than a scrolling log
+            print_telemetry(&reader->region->header, &frame);
+
+            // System metrics sample over their own interval; refresh them less often
+            if (refreshes++ % 4 == 0) {
+                SystemMetrics metrics = get_system_metrics();
+                print_colored_metrics(&metrics, backend);
+            }
+        }
+        usleep(TELEMETRY_REFRESH_US);
+    }
+    printf("DownPour exited.\n");
+}
+
 int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
     printf("SystemMonitor - Hardware Detection Tool\n");
     printf("Press Ctrl+C to exit\n\n");
 
@@ -11,6 +39,15 @@ int main(int argc, char** argv) {
     printf("Detecting Vulkan backend...\n");
     VulkanBackend backend = detect_vulkan_backend();
 
+    // A running DownPour publishes its own frame data; show that live instead of sampling from outside
+    TelemetryReader reader;
+    if (telemetry_attach(&reader)) {
+        print_live(&reader, backend);
+        telemetry_detach(&reader);
+        return 0;
+    }
+    printf("DownPour is not running; showing system metrics only.\n");
+
     // Run monitoring loop
     for (int i = 0; i < 5; i++) {
         SystemMetrics metrics = get_system_metrics();
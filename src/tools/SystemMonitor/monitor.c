@@ -164,3 +164,41 @@ void print_colored_metrics(const SystemMetrics* metrics, VulkanBackend backend)
     printf("  %s█ Red%s     = High usage (>80%%)\n", get_color_code(USAGE_HIGH), reset);
     printf("==============================================\n\n");
 }
+
+void print_telemetry(const DpTelemetryHeader* header, const DpTelemetryFrame* frame) {
+    const char* reset = "\033[0m";
+
+    // Frame time against a 60 Hz budget
+    UsageLevel frame_level = classify_usage(frame->frameMs / (1000.0f / 60.0f) * 100.0f);
+
+    printf("==============================================\n");
+    printf("  DOWNPOUR TELEMETRY - pid %llu, frame %llu\n", (unsigned long long)header->processId,
+           (unsigned long long)frame->frameNumber);
+    printf("==============================================\n\n");
+
+    printf("Frame:          %s%6.2f ms%s (%.0f fps)\n", get_color_code(frame_level), frame->frameMs, reset,
+           frame->frameMs > 0.0f ? 1000.0f / frame->frameMs : 0.0f);
+    printf("Render Scale:   %.2f\n", frame->renderScale);
+    printf("\n");
+
+    printf("CPU Zones:\n");
+    for (uint32_t i = 0; i < header->zoneCount && i < DP_TELEMETRY_MAX_ZONES; i++) {
+        printf("  %-16s %6.2f ms\n", header->zoneNames[i], frame->cpuZoneMs[i]);
+    }
+    printf("\n");
+
+    printf("GPU Passes:     %6.2f ms\n", frame->gpuMs);
+    for (uint32_t i = 0; i < header->sectionCount && i < DP_TELEMETRY_MAX_SECTIONS; i++) {
+        if (frame->gpuSectionMs[i] > 0.0f) {
+            printf("  %-16s %6.2f ms\n", header->sectionNames[i], frame->gpuSectionMs[i]);
+        }
+    }
+    printf("\n");
+
+    printf("Draw Calls:     %u\n", frame->drawCalls);
+    printf("Triangles:      %llu\n", (unsigned long long)frame->triangles);
+    printf("Rain Drops:     %u GPU, %u CPU\n", frame->rainDrops, frame->cpuRaindrops);
+    printf("Device Memory:  %.1f / %.1f MB in %u allocations\n", frame->deviceUsedBytes / (1024.0 * 1024.0),
+           frame->deviceReservedBytes / (1024.0 * 1024.0), frame->deviceAllocations);
+    printf("\n");
+}
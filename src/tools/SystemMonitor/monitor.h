@@ -1,5 +1,7 @@
 #pragma once
 
+#include "TelemetryFormat.h"
+
 #include <stdint.h>
 
 // Enum for simulated system resource states (legacy)
@@ -53,6 +55,9 @@ UsageLevel    classify_usage(float percent);
 const char*   get_color_code(UsageLevel level);
 void          print_colored_metrics(const SystemMetrics* metrics, VulkanBackend backend);
 
+// In-process telemetry published by a running DownPour (telemetry_reader.h)
+void print_telemetry(const DpTelemetryHeader* header, const DpTelemetryFrame* frame);
+
 // Utility functions
 void        log_system_status(void);
 void        log_vulkan_stage(VulkanStage stage);
@@ -0,0 +1,93 @@
+#include "telemetry_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define READ_ATTEMPTS 4
+
+int telemetry_attach(TelemetryReader* reader) {
+    reader->region     = NULL;
+    reader->last_count = 0;
+
+    int fd = shm_open(DP_TELEMETRY_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(DpTelemetryRegion)) {
+        close(fd);
+        return 0;
+    }
+
+    void* mapped = mmap(NULL, sizeof(DpTelemetryRegion), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return 0;
+    }
+
+    // The publisher stores the magic last, after the rest of the header
+    const DpTelemetryRegion* region = (const DpTelemetryRegion*)mapped;
+    if (__atomic_load_n(&region->header.magic, __ATOMIC_ACQUIRE) != DP_TELEMETRY_MAGIC ||
+        region->header.version != DP_TELEMETRY_VERSION || region->header.ringSize != DP_TELEMETRY_RING_SIZE ||
+        region->header.frameSize != sizeof(DpTelemetryFrame)) {
+        munmap(mapped, sizeof(DpTelemetryRegion));
+        return 0;
+    }
+
+    reader->region = region;
+    if (!telemetry_is_alive(reader)) {
+        telemetry_detach(reader);
+        return 0;
+    }
+    return 1;
+}
+
+int telemetry_read_latest(TelemetryReader* reader, DpTelemetryFrame* out) {
+    if (reader->region == NULL) {
+        return 0;
+    }
+
+    uint64_t written = __atomic_load_n(&reader->region->header.writeCount, __ATOMIC_ACQUIRE);
+    if (written == reader->last_count) {
+        return 0;
+    }
+
+    // Fall back to older slots if the writer has lapped the ring onto the newest one meanwhile
+    for (uint64_t attempt = 0; attempt < READ_ATTEMPTS && attempt < written; attempt++) {
+        const DpTelemetryFrame* slot = &reader->region->frames[(written - 1 - attempt) % DP_TELEMETRY_RING_SIZE];
+
+        uint64_t before = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (before == 0 || (before & 1u) != 0) {
+            continue;
+        }
+        memcpy(out, (const void*)slot, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == before) {
+            reader->last_count = written;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int telemetry_is_alive(const TelemetryReader* reader) {
+    if (reader->region == NULL ||
+        __atomic_load_n(&reader->region->header.magic, __ATOMIC_ACQUIRE) != DP_TELEMETRY_MAGIC) {
+        return 0;
+    }
+    pid_t pid = (pid_t)reader->region->header.processId;
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+void telemetry_detach(TelemetryReader* reader) {
+    if (reader->region != NULL) {
+        munmap((void*)reader->region, sizeof(DpTelemetryRegion));
+        reader->region = NULL;
+    }
+}
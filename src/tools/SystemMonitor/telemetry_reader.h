@@ -0,0 +1,35 @@
+#pragma once
+
+#include "TelemetryFormat.h"
+
+#include <stdint.h>
+
+// Read side of DownPour's shared-memory telemetry ring (src/core/TelemetryFormat.h)
+typedef struct {
+    const DpTelemetryRegion* region;
+    uint64_t                 last_count;  // writeCount when a record was last returned
+} TelemetryReader;
+
+/**
+ * @brief Map the region a running DownPour publishes
+ *
+ * @return 1 on success, 0 if no compatible publisher is running
+ */
+int telemetry_attach(TelemetryReader* reader);
+
+/**
+ * @brief Copy the newest complete frame record
+ *
+ * Never blocks the publisher: a record it is rewriting is retried a few
+ * times, then skipped.
+ *
+ * @return 1 if a record newer than the last one returned was copied, 0 otherwise
+ */
+int telemetry_read_latest(TelemetryReader* reader, DpTelemetryFrame* out);
+
+/**
+ * @brief Whether the publishing process is still running and the region is live
+ */
+int telemetry_is_alive(const TelemetryReader* reader);
+
+void telemetry_detach(TelemetryReader* reader);
@@ -3,9 +3,15 @@
 #include <vulkan/vulkan.h>
 
 #include <any>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace DownPour {
 namespace Vulkan {
@@ -50,21 +56,47 @@ struct VulkanCoreContext {
     }
 };
 
+/**
+ * @brief Compile-time key for a typed slot in VulkanDispatch
+ *
+ * Declare one tag type per resource, each with its own index below
+ * VulkanDispatch::MAX_RESOURCE_SLOTS. The name is only used for debug listings
+ * and messages; tags that leave it out are listed as "slot_<index>".
+ * set_slot() throws when two tag types share an index.
+ *
+ *   struct CarPipelineSlot : ResourceSlot<VkPipeline, 0> {
+ *       static constexpr const char* name = "car_pipeline";
+ *   };
+ *
+ * @tparam T Stored type; trivially copyable and at most 16 bytes (Vulkan handles, extents, small PODs)
+ * @tparam Index Position in the flat slot array
+ */
+template <typename T, uint32_t Index>
+struct ResourceSlot {
+    using Type                         = T;
+    static constexpr uint32_t    index = Index;
+    static constexpr const char* name  = nullptr;  // Hidden by the tag's own name
+};
+
 /**
  * @brief Centralized Vulkan resource dispatcher with hybrid access
  *
- * Provides both direct struct access for core resources and a flexible
- * map-based system for dynamic or optional resources. This design allows:
+ * Provides direct struct access for core resources, typed slots for
+ * resources looked up from hot paths, and a string map for tools and
+ * debugging. This design allows:
  *
  * - Fast, type-safe access to common resources via the `core` struct
- * - Dynamic registration of pipeline-specific or optional resources
+ * - Per-draw lookups of registered resources as a constant array index (`get_slot<Slot>()`),
+ *   with no string compares, map walks or RTTI
+ * - Dynamic registration by name for tools and debug code, where lookup cost does not matter
  * - Easy passing of Vulkan context between subsystems
  *
  * Usage:
  *   VulkanDispatch dispatch;
  *   dispatch.core.device = myDevice;
- *   dispatch.set_resource("car_pipeline", myCarPipeline);
- *   auto pipeline = dispatch.get_resource<VkPipeline>("car_pipeline");
+ *   dispatch.set_slot<CarPipelineSlot>(myCarPipeline);
+ *   VkPipeline pipeline = dispatch.get_slot<CarPipelineSlot>();
+ *   dispatch.set_resource("debug_vertex_buffer", myDebugBuffer);  // Tools and debug only
  */
 class VulkanDispatch {
 public:
@@ -75,9 +107,77 @@ public:
      */
     VulkanCoreContext core;
 
+    static constexpr uint32_t MAX_RESOURCE_SLOTS = 64;
+
+    /**
+     * @brief Store a resource in its typed slot
+     *
+     * @tparam Slot ResourceSlot tag type
+     * @param resource The resource to store
+     */
+    template <typename Slot>
+    void set_slot(typename Slot::Type resource) {
+        checkSlot<Slot>();
+        checkOwner<Slot>();
+        std::memcpy(slots[Slot::index].bytes, &resource, sizeof(resource));
+        slot_names[Slot::index] = Slot::name;
+        occupied_slots.set(Slot::index);
+    }
+
+    /**
+     * @brief Read a resource from its typed slot
+     *
+     * Hot-path lookup: a fixed array index, unchecked. Reading a slot that
+     * was never set returns a zeroed value (VK_NULL_HANDLE for handles).
+     *
+     * @tparam Slot ResourceSlot tag type
+     * @return The stored resource
+     */
+    template <typename Slot>
+    typename Slot::Type get_slot() const {
+        checkSlot<Slot>();
+        typename Slot::Type resource;
+        std::memcpy(&resource, slots[Slot::index].bytes, sizeof(resource));
+        return resource;
+    }
+
+    /**
+     * @brief Check if a typed slot has been set
+     */
+    template <typename Slot>
+    bool has_slot() const {
+        checkSlot<Slot>();
+        return occupied_slots.test(Slot::index);
+    }
+
+    /**
+     * @brief Zero a typed slot
+     *
+     * Note: This does NOT destroy the Vulkan handle it held.
+     */
+    template <typename Slot>
+    void clear_slot() {
+        checkSlot<Slot>();
+        slots[Slot::index]      = {};
+        slot_names[Slot::index] = nullptr;
+        occupied_slots.reset(Slot::index);
+    }
+
+    /**
+     * @brief Zero all typed slots
+     *
+     * Note: This does NOT destroy Vulkan handles, only forgets them.
+     */
+    void clear_slots() {
+        slots = {};
+        slot_names.fill(nullptr);
+        occupied_slots.reset();
+    }
+
     /**
      * @brief Register a dynamic resource in the dispatch map
      *
+     * For tools and debug code; hot paths register a ResourceSlot instead.
      * Use snake_case for resource keys (e.g., "car_pipeline", "debug_vertex_buffer")
      *
      * @tparam T Resource type (automatically deduced)
@@ -128,15 +228,21 @@ public:
     bool remove_resource(const std::string& key) { return dynamic_resources.erase(key) > 0; }
 
     /**
-     * @brief Get all registered dynamic resource keys
+     * @brief Get all registered resource keys
      *
-     * Useful for debugging or inspecting what resources are currently registered
+     * Useful for debugging or inspecting what resources are currently registered.
+     * Lists the names of occupied typed slots followed by the dynamic map keys.
      *
      * @return Vector of all resource keys
      */
     std::vector<std::string> get_all_keys() const {
         std::vector<std::string> keys;
-        keys.reserve(dynamic_resources.size());
+        keys.reserve(occupied_slots.count() + dynamic_resources.size());
+        for (uint32_t i = 0; i < MAX_RESOURCE_SLOTS; i++) {
+            if (occupied_slots.test(i)) {
+                keys.push_back(slot_names[i] != nullptr ? slot_names[i] : "slot_" + std::to_string(i));
+            }
+        }
         for (const auto& pair : dynamic_resources) {
             keys.push_back(pair.first);
         }
@@ -152,10 +258,51 @@ public:
     void clear_dynamic_resources() { dynamic_resources.clear(); }
 
 private:
+    // Raw storage for one typed slot; the Slot tag supplies the type at compile time
+    struct SlotStorage {
+        alignas(8) unsigned char bytes[16];
+    };
+
+    template <typename Slot>
+    static constexpr void checkSlot() {
+        static_assert(Slot::index < MAX_RESOURCE_SLOTS, "VulkanDispatch: slot index out of range");
+        static_assert(std::is_trivially_copyable_v<typename Slot::Type>, "VulkanDispatch: slot type must be POD");
+        static_assert(sizeof(typename Slot::Type) <= sizeof(SlotStorage), "VulkanDispatch: slot type too large");
+        static_assert(alignof(typename Slot::Type) <= alignof(SlotStorage), "VulkanDispatch: slot type over-aligned");
+    }
+
+    // The first tag type to set an index claims it; another tag on the same index would alias its storage.
+    // Checked on set only, so lookups stay read-only and safe to run concurrently
+    template <typename Slot>
+    void checkOwner() {
+        const void*& owner = slot_owners[Slot::index];
+        if (owner == nullptr) {
+            owner                         = &slot_tag<Slot>;
+            slot_owner_names[Slot::index] = Slot::name;
+        } else if (owner != &slot_tag<Slot>) {
+            auto describe = [](const char* name) { return name != nullptr ? std::string(name) : "unnamed slot"; };
+            throw std::runtime_error("VulkanDispatch: slot " + std::to_string(Slot::index) + " is claimed by both '" +
+                                     describe(slot_owner_names[Slot::index]) + "' and '" + describe(Slot::name) +
+                                     "'");
+        }
+    }
+
+    std::array<SlotStorage, MAX_RESOURCE_SLOTS> slots{};
+    std::array<const char*, MAX_RESOURCE_SLOTS> slot_names{};  // Slot::name, for get_all_keys()
+    std::bitset<MAX_RESOURCE_SLOTS>             occupied_slots;
+
+    // One address per tag type identifies it without RTTI
+    template <typename Slot>
+    static constexpr char slot_tag = 0;
+
+    std::array<const void*, MAX_RESOURCE_SLOTS> slot_owners{};       // Kept across clears
+    std::array<const char*, MAX_RESOURCE_SLOTS> slot_owner_names{};  // Slot::name of each owner
+
     /**
      * @brief Map of dynamic resources using std::any for type flexibility
      *
-     * Supports any Vulkan handle type (VkPipeline, VkBuffer, VkDescriptorSetLayout, etc.)
+     * Supports any Vulkan handle type (VkPipeline, VkBuffer, VkDescriptorSetLayout, etc.).
+     * Tool and debug access only: each lookup is string compares plus an any_cast.
      * Keys should use snake_case for consistency (e.g., "car_pipeline", "world_descriptor_layout")
      */
     std::map<std::string, std::any> dynamic_resources;
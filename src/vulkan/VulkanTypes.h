@@ -17,10 +17,15 @@ using namespace DownPour::Types;
  *
  * Stores indices for graphics and present queue families.
  * A complete set of indices is required for Vulkan device creation.
+ * transferFamily is only set when the device has a dedicated transfer
+ * (DMA) family without graphics or compute support, computeFamily only when
+ * it has a compute family without graphics support (async compute).
  */
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily;
+    std::optional<uint32_t> computeFamily;
 
     /**
      * @brief Check if all required queue families are found